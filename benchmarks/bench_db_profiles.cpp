@@ -0,0 +1,174 @@
+// SQLite tuning-profile comparison.
+//
+// For each profile, rebuilds a scratch store with F folders holding N files
+// (record by record inside a transaction, then through the bulk-load path),
+// then reopens it and times folder listing: one ListFolders + ListFiles per
+// folder, first on the fresh connection ("cold") and again on the warm one.
+//
+// Usage: bench_db_profiles [files] [folders] [profile...]
+//        defaults: 50000 1000, every profile
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "db/db_manager.h"
+#include "db/db_tuning.h"
+#include "db/sqlite_metadata_store.h"
+
+using namespace vxcore;
+using namespace vxcore::db;
+
+namespace {
+
+int ParseArg(int argc, char **argv, int index, int fallback) {
+  if (index >= argc) return fallback;
+  int value = std::atoi(argv[index]);
+  return value > 0 ? value : fallback;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RemoveDb(const std::string &db_path) {
+  for (const char *suffix : {"", "-wal", "-shm"}) {
+    std::filesystem::remove(db_path + suffix);
+  }
+}
+
+StoreFolderRecord MakeFolder(int f) {
+  StoreFolderRecord folder;
+  folder.id = "folder-" + std::to_string(f);
+  // Every tenth folder is top-level; the rest nest under the previous one.
+  folder.parent_id = f % 10 == 0 ? "" : "folder-" + std::to_string(f - 1);
+  folder.name = "dir" + std::to_string(f);
+  folder.created_utc = 0;
+  folder.modified_utc = 0;
+  folder.metadata = "{}";
+  return folder;
+}
+
+StoreFileRecord MakeFile(int n, int folders) {
+  static const std::vector<std::string> tag_pool = {"work", "home", "todo",
+                                                    "idea", "draft", "ref"};
+  StoreFileRecord file;
+  file.id = "file-" + std::to_string(n);
+  file.folder_id = "folder-" + std::to_string(n % folders);
+  file.name = "note" + std::to_string(n) + ".md";
+  file.created_utc = 0;
+  file.modified_utc = 0;
+  file.metadata = "{}";
+  file.tags = {tag_pool[n % tag_pool.size()], tag_pool[(n / 7) % tag_pool.size()]};
+  return file;
+}
+
+// One ListFolders + ListFiles per folder; returns the number of files seen.
+size_t ListEveryFolder(SqliteMetadataStore &store, int folders) {
+  store.ListFolders("");
+  size_t seen = 0;
+  for (int f = 0; f < folders; ++f) {
+    const std::string id = "folder-" + std::to_string(f);
+    store.ListFolders(id);
+    seen += store.ListFiles(id).size();
+  }
+  return seen;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int files = ParseArg(argc, argv, 1, 50000);
+  const int folders = ParseArg(argc, argv, 2, 1000);
+
+  std::vector<std::string> profiles;
+  for (int i = 3; i < argc; ++i) {
+    profiles.push_back(argv[i]);
+  }
+  if (profiles.empty()) {
+    profiles = DbTuning::ProfileNames();
+  }
+
+  const std::string db_path =
+      (std::filesystem::temp_directory_path() / "vxcore_bench_db_profiles.sqlite").string();
+
+  std::printf("bench_db_profiles: files=%d folders=%d\n", files, folders);
+  std::printf("  %-12s %10s %10s %10s %10s\n", "profile", "rebuild", "bulk", "list cold",
+              "list warm");
+
+  for (const auto &profile : profiles) {
+    DbTuning tuning;
+    if (!DbTuning::ForProfile(profile, tuning)) {
+      std::fprintf(stderr, "bench_db_profiles: unknown profile '%s'\n", profile.c_str());
+      return 1;
+    }
+    // SqliteMetadataStore opens through DbManager::Open(path), which uses
+    // the default tuning.
+    DbManager::SetDefaultTuning(tuning);
+    RemoveDb(db_path);
+
+    SqliteMetadataStore store;
+    if (!store.Open(db_path)) {
+      std::fprintf(stderr, "bench_db_profiles: failed to open %s\n", db_path.c_str());
+      return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    store.BeginTransaction();
+    for (int f = 0; f < folders; ++f) {
+      store.CreateFolder(MakeFolder(f));
+    }
+    for (int n = 0; n < files; ++n) {
+      store.CreateFile(MakeFile(n, folders));
+    }
+    store.CommitTransaction();
+    const double rebuild_s = SecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    if (!store.BeginBulkLoad()) {
+      std::fprintf(stderr, "bench_db_profiles: %s\n", store.GetLastError().c_str());
+      return 1;
+    }
+    for (int f = 0; f < folders; ++f) {
+      store.BulkAddFolder(MakeFolder(f));
+    }
+    for (int n = 0; n < files; ++n) {
+      store.BulkAddFile(MakeFile(n, folders));
+    }
+    if (!store.EndBulkLoad()) {
+      std::fprintf(stderr, "bench_db_profiles: %s\n", store.GetLastError().c_str());
+      return 1;
+    }
+    const double bulk_s = SecondsSince(start);
+
+    // Reopen so the first listing pass starts with an empty page cache.
+    store.Close();
+    if (!store.Open(db_path)) {
+      std::fprintf(stderr, "bench_db_profiles: failed to reopen %s\n", db_path.c_str());
+      return 1;
+    }
+
+    start = std::chrono::steady_clock::now();
+    size_t seen = ListEveryFolder(store, folders);
+    const double cold_s = SecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    seen += ListEveryFolder(store, folders);
+    const double warm_s = SecondsSince(start);
+
+    if (seen != 2 * static_cast<size_t>(files)) {
+      std::fprintf(stderr, "bench_db_profiles: listed %zu files, expected %d\n", seen / 2,
+                   files);
+      return 1;
+    }
+    std::printf("  %-12s %9.3fs %9.3fs %9.3fs %9.3fs\n", profile.c_str(), rebuild_s, bulk_s,
+                cold_s, warm_s);
+    store.Close();
+  }
+
+  RemoveDb(db_path);
+  return 0;
+}
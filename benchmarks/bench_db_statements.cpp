@@ -0,0 +1,116 @@
+// FileDb point-lookup microbenchmark: shared statement cache vs. per-call
+// preparation.
+//
+// Fills a scratch database with F folders of N files each, then times
+// GetFileByName and ListFiles through a FileDb wired to the DbManager's
+// statement cache, and through one whose cache is saturated with borrowed
+// handles to unrelated SQL so every call prepares and finalizes its
+// statement (the pre-cache behavior). Prints per-call cost and both caches'
+// hit/miss counters; the saturated one must show no hits.
+//
+// Usage: bench_db_statements [folders] [files_per_folder] [iterations]
+//        defaults: 20 500 200000
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "db/db_manager.h"
+#include "db/file_db.h"
+#include "db/statement_cache.h"
+
+using namespace vxcore::db;
+
+namespace {
+
+int ParseArg(int argc, char **argv, int index, int fallback) {
+  if (index >= argc) return fallback;
+  int value = std::atoi(argv[index]);
+  return value > 0 ? value : fallback;
+}
+
+template <typename Fn>
+double TimeUs(int iterations, Fn &&fn) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    fn(i);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+void RunLookups(const char *label, FileDb &file_db, const std::vector<int64_t> &folder_ids,
+                int files_per_folder, int iterations) {
+  size_t found = 0;
+  const double by_name_us = TimeUs(iterations, [&](int i) {
+    const int64_t folder_id = folder_ids[static_cast<size_t>(i) % folder_ids.size()];
+    const std::string name = "file_" + std::to_string(i % files_per_folder) + ".md";
+    if (file_db.GetFileByName(folder_id, name)) ++found;
+  });
+  size_t listed = 0;
+  const int list_iterations = iterations / 100 > 0 ? iterations / 100 : 1;
+  const double list_us = TimeUs(list_iterations, [&](int i) {
+    listed += file_db.ListFiles(folder_ids[static_cast<size_t>(i) % folder_ids.size()]).size();
+  });
+  std::printf("  %-10s GetFileByName %.2fus/call (%zu found)  ListFiles %.1fus/call (%zu rows)\n",
+              label, by_name_us, found, list_us, listed);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int folders = ParseArg(argc, argv, 1, 20);
+  const int files_per_folder = ParseArg(argc, argv, 2, 500);
+  const int iterations = ParseArg(argc, argv, 3, 200000);
+
+  const std::string db_path =
+      (std::filesystem::temp_directory_path() / "vxcore_bench_db_statements.sqlite").string();
+  std::filesystem::remove(db_path);
+
+  DbManager db_manager;
+  if (!db_manager.Open(db_path) || !db_manager.InitializeSchema()) {
+    std::fprintf(stderr, "bench_db_statements: failed to open %s\n", db_path.c_str());
+    return 1;
+  }
+
+  FileDb cached(db_manager.GetHandle(), db_manager.GetStatementCache());
+  std::vector<int64_t> folder_ids;
+  db_manager.BeginTransaction();
+  for (int f = 0; f < folders; ++f) {
+    const int64_t folder_id = cached.CreateFolder(-1, "folder_" + std::to_string(f), 0, 0);
+    folder_ids.push_back(folder_id);
+    for (int n = 0; n < files_per_folder; ++n) {
+      cached.CreateFile(folder_id, "file_" + std::to_string(n) + ".md", 0, 0, {});
+    }
+  }
+  db_manager.CommitTransaction();
+
+  // Saturate a private cache so FileDb's own SQL never gets a slot. The
+  // handles stay borrowed for the whole run: idle slots would be evicted.
+  StatementCache saturated(db_manager.GetHandle());
+  std::vector<ScopedStatement> pinned;
+  for (size_t i = 0; i < StatementCache::kMaxEntries; ++i) {
+    pinned.push_back(saturated.Acquire("SELECT " + std::to_string(i) + ";"));
+  }
+  FileDb uncached(db_manager.GetHandle(), &saturated);
+
+  std::printf("bench_db_statements: folders=%d files/folder=%d iterations=%d\n", folders,
+              files_per_folder, iterations);
+  RunLookups("uncached", uncached, folder_ids, files_per_folder, iterations);
+  RunLookups("cached", cached, folder_ids, files_per_folder, iterations);
+  std::printf("  saturated    hits=%llu misses=%llu\n",
+              static_cast<unsigned long long>(saturated.GetHitCount()),
+              static_cast<unsigned long long>(saturated.GetMissCount()));
+
+  const StatementCache *cache = db_manager.GetStatementCache();
+  std::printf("  cache        hits=%llu misses=%llu entries=%zu\n",
+              static_cast<unsigned long long>(cache->GetHitCount()),
+              static_cast<unsigned long long>(cache->GetMissCount()), cache->GetEntryCount());
+
+  db_manager.Close();
+  std::filesystem::remove(db_path);
+  return 0;
+}
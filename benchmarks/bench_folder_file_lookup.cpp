@@ -0,0 +1,135 @@
+// FolderConfig file lookup benchmark: hash index vs linear scan.
+//
+// Builds one folder config with N files (a large daily journal) and times
+//   scan:   the linear name comparison lookups used to do
+//   index:  FolderConfig::FindFileIndex / FindFileIndexById
+// for hits spread over the folder and for misses, plus the one-off index
+// build and an add/rename/lookup churn loop shaped like file operations
+// (create, rename, tag) on a cached config. Checks that scan and index agree.
+//
+// Usage: bench_folder_file_lookup [files] [lookups]
+//        defaults: 20000 200000
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "core/folder.h"
+
+using namespace vxcore;
+
+namespace {
+
+int ParseArg(int argc, char **argv, int index, int fallback) {
+  if (index >= argc) return fallback;
+  int value = std::atoi(argv[index]);
+  return value > 0 ? value : fallback;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string Name(int n) { return "2024-01-01-journal-" + std::to_string(n) + ".md"; }
+
+int ScanByName(const FolderConfig &config, const std::string &name) {
+  for (size_t i = 0; i < config.files.size(); ++i) {
+    if (config.files[i].name == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int files = ParseArg(argc, argv, 1, 20000);
+  const int lookups = ParseArg(argc, argv, 2, 200000);
+  // The scan is O(files) per lookup; keep its total work comparable.
+  const int scan_lookups = lookups / 100 > 0 ? lookups / 100 : 1;
+
+  FolderConfig config("journal");
+  for (int n = 0; n < files; ++n) {
+    config.files.emplace_back(Name(n));
+  }
+
+  // Hits in a scattered order, and names that are not there.
+  std::vector<std::string> hits;
+  std::vector<std::string> misses;
+  std::vector<std::string> ids;
+  for (int i = 0; i < 1024; ++i) {
+    const int n = static_cast<int>((static_cast<uint32_t>(i) * 2654435761u) % files);
+    hits.push_back(Name(n));
+    ids.push_back(config.files[n].id);
+    misses.push_back("missing-" + std::to_string(i) + ".md");
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  config.FindFileIndex(hits[0]);
+  const double build_ms = SecondsSince(start) * 1e3;
+
+  std::printf("bench_folder_file_lookup: files=%d lookups=%d\n", files, lookups);
+  std::printf("  index build %.3fms\n", build_ms);
+  std::printf("  %-12s %12s %12s\n", "lookup", "scan", "index");
+
+  struct Case {
+    const char *label;
+    const std::vector<std::string> &keys;
+  };
+  for (const Case &lookup : {Case{"name hit", hits}, Case{"name miss", misses}}) {
+    int64_t scan_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < scan_lookups; ++i) {
+      scan_sum += ScanByName(config, lookup.keys[i % lookup.keys.size()]);
+    }
+    const double scan_ns = SecondsSince(start) * 1e9 / scan_lookups;
+
+    int64_t index_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; ++i) {
+      index_sum += config.FindFileIndex(lookup.keys[i % lookup.keys.size()]);
+    }
+    const double index_ns = SecondsSince(start) * 1e9 / lookups;
+
+    // Same keys cycle in both loops; compare the first scan_lookups rounds.
+    int64_t check_sum = 0;
+    for (int i = 0; i < scan_lookups; ++i) {
+      check_sum += config.FindFileIndex(lookup.keys[i % lookup.keys.size()]);
+    }
+    if (check_sum != scan_sum) {
+      std::fprintf(stderr, "bench_folder_file_lookup: '%s' disagrees\n", lookup.label);
+      return 1;
+    }
+    (void)index_sum;
+    std::printf("  %-12s %10.0fns %10.0fns\n", lookup.label, scan_ns, index_ns);
+  }
+
+  int64_t id_sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i) {
+    id_sum += config.FindFileIndexById(ids[i % ids.size()]);
+  }
+  std::printf("  %-12s %12s %10.0fns\n", "id hit", "-", SecondsSince(start) * 1e9 / lookups);
+  (void)id_sum;
+
+  // Create, rename and look up, as file operations on a cached config do.
+  const int churn = lookups / 10 > 0 ? lookups / 10 : 1;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < churn; ++i) {
+    const std::string name = "new-" + std::to_string(i) + ".md";
+    config.AddFile(FileRecord(name));
+    const int index = config.FindFileIndex(name);
+    config.RenameFile(static_cast<size_t>(index), "renamed-" + std::to_string(i) + ".md");
+    if (!config.FindFile("renamed-" + std::to_string(i) + ".md")) {
+      std::fprintf(stderr, "bench_folder_file_lookup: churn lost a file\n");
+      return 1;
+    }
+  }
+  std::printf("  churn (add + rename + 2 lookups) %.0fns/op\n",
+              SecondsSince(start) * 1e9 / churn);
+  return 0;
+}
@@ -0,0 +1,159 @@
+// Metadata query benchmark: JSON scan vs expression index.
+//
+// Bulk-loads a scratch store with N files whose metadata carries a "status"
+// (one of five values, "draft" on roughly one file in 50) and a numeric
+// "priority", then times SqliteMetadataStore::FindNodesByMetadata for a few
+// predicates twice:
+//   scan:   no metadata indexes (json_extract on every row)
+//   index:  after CreateMetadataIndex("status") and ("priority")
+// and checks both runs agree on the match count.
+//
+// Usage: bench_metadata_query [files] [iterations]
+//        defaults: 100000 50
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "db/sqlite_metadata_store.h"
+
+using namespace vxcore;
+using namespace vxcore::db;
+
+namespace {
+
+int ParseArg(int argc, char **argv, int index, int fallback) {
+  if (index >= argc) return fallback;
+  int value = std::atoi(argv[index]);
+  return value > 0 ? value : fallback;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RemoveDb(const std::string &db_path) {
+  for (const char *suffix : {"", "-wal", "-shm"}) {
+    std::filesystem::remove(db_path + suffix);
+  }
+}
+
+StoreFileRecord MakeFile(int n) {
+  static const char *kStatuses[] = {"done", "review", "archived", "open"};
+  StoreFileRecord file;
+  file.id = "file-" + std::to_string(n);
+  file.folder_id = "folder-" + std::to_string(n % 100);
+  file.name = "note" + std::to_string(n) + ".md";
+  file.created_utc = 0;
+  file.modified_utc = 0;
+  const uint32_t hash = static_cast<uint32_t>(n) * 2654435761u;
+  const char *status = (hash >> 8) % 50 == 0 ? "draft" : kStatuses[(hash >> 4) % 4];
+  file.metadata = std::string(R"({"status": ")") + status +
+                  R"(", "priority": )" + std::to_string((hash >> 12) % 1000) +
+                  R"(, "title": "Note )" + std::to_string(n) + R"("})";
+  return file;
+}
+
+struct Predicate {
+  const char *label;
+  StoreMetadataQuery query;
+};
+
+Predicate MakePredicate(const char *label, const char *key, MetadataOp op, nlohmann::json value) {
+  Predicate predicate{label, {}};
+  predicate.query.filter.conditions.push_back({key, op, std::move(value)});
+  return predicate;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int files = ParseArg(argc, argv, 1, 100000);
+  const int iterations = ParseArg(argc, argv, 2, 50);
+
+  const std::string db_path =
+      (std::filesystem::temp_directory_path() / "vxcore_bench_metadata_query.sqlite").string();
+  RemoveDb(db_path);
+
+  SqliteMetadataStore store;
+  if (!store.Open(db_path) || !store.BeginBulkLoad()) {
+    std::fprintf(stderr, "bench_metadata_query: failed to set up %s\n", db_path.c_str());
+    return 1;
+  }
+  for (int f = 0; f < 100; ++f) {
+    StoreFolderRecord folder;
+    folder.id = "folder-" + std::to_string(f);
+    folder.name = "dir" + std::to_string(f);
+    folder.created_utc = 0;
+    folder.modified_utc = 0;
+    folder.metadata = "{}";
+    store.BulkAddFolder(folder);
+  }
+  for (int n = 0; n < files; ++n) {
+    store.BulkAddFile(MakeFile(n));
+  }
+  if (!store.EndBulkLoad()) {
+    std::fprintf(stderr, "bench_metadata_query: %s\n", store.GetLastError().c_str());
+    return 1;
+  }
+
+  std::vector<Predicate> predicates;
+  predicates.push_back(MakePredicate("status = draft", "status", MetadataOp::kEq, "draft"));
+  predicates.push_back(MakePredicate("priority < 10", "priority", MetadataOp::kLt, 10));
+  predicates.push_back(MakePredicate("priority >= 995", "priority", MetadataOp::kGe, 995));
+  {
+    Predicate both = MakePredicate("draft AND priority < 500", "status", MetadataOp::kEq, "draft");
+    both.query.filter.conditions.push_back({"priority", MetadataOp::kLt, 500});
+    predicates.push_back(std::move(both));
+  }
+
+  // Scans run inside a transaction: the store only indexes hot keys between
+  // transactions, so none of these queries gets an index behind our back.
+  std::vector<size_t> scan_counts;
+  std::vector<double> scan_us;
+  store.BeginTransaction();
+  for (const auto &predicate : predicates) {
+    size_t count = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      count = store.FindNodesByMetadata(predicate.query).size();
+    }
+    scan_us.push_back(SecondsSince(start) * 1e6 / iterations);
+    scan_counts.push_back(count);
+  }
+  store.RollbackTransaction();
+
+  auto start = std::chrono::steady_clock::now();
+  if (!store.CreateMetadataIndex("status") || !store.CreateMetadataIndex("priority")) {
+    std::fprintf(stderr, "bench_metadata_query: %s\n", store.GetLastError().c_str());
+    return 1;
+  }
+  const double index_build_s = SecondsSince(start);
+
+  std::printf("bench_metadata_query: files=%d iterations=%d\n", files, iterations);
+  std::printf("  index build %.3fs (status + priority, files and folders)\n", index_build_s);
+  std::printf("  %-26s %8s %12s %12s\n", "predicate", "matches", "scan", "index");
+  for (size_t p = 0; p < predicates.size(); ++p) {
+    size_t count = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      count = store.FindNodesByMetadata(predicates[p].query).size();
+    }
+    const double index_us = SecondsSince(start) * 1e6 / iterations;
+    if (count != scan_counts[p]) {
+      std::fprintf(stderr, "bench_metadata_query: '%s' disagrees: scan=%zu index=%zu\n",
+                   predicates[p].label, scan_counts[p], count);
+      return 1;
+    }
+    std::printf("  %-26s %8zu %10.1fus %10.1fus\n", predicates[p].label, count, scan_us[p],
+                index_us);
+  }
+
+  store.Close();
+  RemoveDb(db_path);
+  return 0;
+}
@@ -0,0 +1,122 @@
+// SqliteMetadataStore bulk-read microbenchmark.
+//
+// Populates a scratch store with F folders (nested two levels deep) holding
+// N files in total, a few tags each, once record by record inside a
+// transaction and once through the bulk-load path, then times a full
+// IterateAllFiles pass.
+//
+// Usage: bench_metadata_store [files] [folders]
+//        defaults: 100000 1000
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "db/sqlite_metadata_store.h"
+
+using namespace vxcore;
+using namespace vxcore::db;
+
+namespace {
+
+int ParseArg(int argc, char **argv, int index, int fallback) {
+  if (index >= argc) return fallback;
+  int value = std::atoi(argv[index]);
+  return value > 0 ? value : fallback;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int files = ParseArg(argc, argv, 1, 100000);
+  const int folders = ParseArg(argc, argv, 2, 1000);
+
+  const std::string db_path =
+      (std::filesystem::temp_directory_path() / "vxcore_bench_metadata_store.sqlite").string();
+  std::filesystem::remove(db_path);
+
+  SqliteMetadataStore store;
+  if (!store.Open(db_path)) {
+    std::fprintf(stderr, "bench_metadata_store: failed to open %s\n", db_path.c_str());
+    return 1;
+  }
+
+  const std::vector<std::string> tag_pool = {"work", "home", "todo", "idea", "draft", "ref"};
+
+  auto make_folder = [&](int f) {
+    StoreFolderRecord folder;
+    folder.id = "folder-" + std::to_string(f);
+    // Every tenth folder is top-level; the rest nest under the previous one.
+    folder.parent_id = f % 10 == 0 ? "" : "folder-" + std::to_string(f - 1);
+    folder.name = "dir" + std::to_string(f);
+    folder.created_utc = 0;
+    folder.modified_utc = 0;
+    folder.metadata = "{}";
+    return folder;
+  };
+  auto make_file = [&](int n) {
+    StoreFileRecord file;
+    file.id = "file-" + std::to_string(n);
+    file.folder_id = "folder-" + std::to_string(n % folders);
+    file.name = "note" + std::to_string(n) + ".md";
+    file.created_utc = 0;
+    file.modified_utc = 0;
+    file.metadata = "{}";
+    file.tags = {tag_pool[n % tag_pool.size()], tag_pool[(n / 7) % tag_pool.size()]};
+    return file;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  store.BeginTransaction();
+  for (int f = 0; f < folders; ++f) {
+    store.CreateFolder(make_folder(f));
+  }
+  for (int n = 0; n < files; ++n) {
+    store.CreateFile(make_file(n));
+  }
+  store.CommitTransaction();
+  const double load_s = SecondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  if (!store.BeginBulkLoad()) {
+    std::fprintf(stderr, "bench_metadata_store: %s\n", store.GetLastError().c_str());
+    return 1;
+  }
+  for (int f = 0; f < folders; ++f) {
+    store.BulkAddFolder(make_folder(f));
+  }
+  for (int n = 0; n < files; ++n) {
+    store.BulkAddFile(make_file(n));
+  }
+  if (!store.EndBulkLoad()) {
+    std::fprintf(stderr, "bench_metadata_store: %s\n", store.GetLastError().c_str());
+    return 1;
+  }
+  const double bulk_load_s = SecondsSince(start);
+
+  size_t visited = 0;
+  size_t tag_count = 0;
+  start = std::chrono::steady_clock::now();
+  store.IterateAllFiles([&](const std::string &, const StoreFileRecord &record) {
+    ++visited;
+    tag_count += record.tags.size();
+    return true;
+  });
+  const double iterate_s = SecondsSince(start);
+
+  std::printf("bench_metadata_store: files=%d folders=%d\n", files, folders);
+  std::printf("  load           %.3fs\n", load_s);
+  std::printf("  bulk load      %.3fs\n", bulk_load_s);
+  std::printf("  iterate        %.3fs (%zu files, %zu tags)\n", iterate_s, visited, tag_count);
+
+  store.Close();
+  std::filesystem::remove(db_path);
+  return 0;
+}
@@ -0,0 +1,138 @@
+// Node batch benchmark: per-node C API calls vs vxcore_node_batch.
+//
+// Creates a bundled notebook with two folders, fills the first with N notes
+// and times
+//   single: one vxcore_node_move / vxcore_file_tag call per note
+//   batch:  one vxcore_node_batch call for the whole selection
+// for moving every note to the other folder and back, and for tagging them.
+// Checks that every note ends up where it should.
+//
+// Usage: bench_node_batch [notes]
+//        defaults: 1000
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "vxcore/vxcore.h"
+
+namespace {
+
+int ParseArg(int argc, char **argv, int index, int fallback) {
+  if (index >= argc) return fallback;
+  int value = std::atoi(argv[index]);
+  return value > 0 ? value : fallback;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string Name(int n) { return "note-" + std::to_string(n) + ".md"; }
+
+bool Batch(VxCoreContextHandle ctx, const char *notebook_id, const nlohmann::json &ops) {
+  char *results_json = nullptr;
+  if (vxcore_node_batch(ctx, notebook_id, ops.dump().c_str(), &results_json) != VXCORE_OK) {
+    return false;
+  }
+  bool ok = true;
+  for (const auto &result : nlohmann::json::parse(results_json)) {
+    ok = ok && result.get<int>() == VXCORE_OK;
+  }
+  vxcore_string_free(results_json);
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int notes = ParseArg(argc, argv, 1, 1000);
+
+  vxcore_set_test_mode(1);
+  vxcore_clear_test_directory();
+  VxCoreContextHandle ctx = nullptr;
+  if (vxcore_context_create(nullptr, &ctx) != VXCORE_OK) {
+    std::fprintf(stderr, "bench_node_batch: cannot create context\n");
+    return 1;
+  }
+
+  const std::filesystem::path root =
+      std::filesystem::temp_directory_path() / "vxcore_bench_node_batch";
+  std::filesystem::remove_all(root);
+
+  char *notebook_id = nullptr;
+  char *id = nullptr;
+  if (vxcore_notebook_create(ctx, root.string().c_str(), "{\"name\":\"Bench\"}",
+                             VXCORE_NOTEBOOK_BUNDLED, &notebook_id) != VXCORE_OK ||
+      vxcore_folder_create(ctx, notebook_id, ".", "a", &id) != VXCORE_OK) {
+    std::fprintf(stderr, "bench_node_batch: cannot create notebook\n");
+    return 1;
+  }
+  vxcore_string_free(id);
+  vxcore_folder_create(ctx, notebook_id, ".", "b", &id);
+  vxcore_string_free(id);
+  vxcore_tag_create(ctx, notebook_id, "single");
+  vxcore_tag_create(ctx, notebook_id, "batch");
+  for (int n = 0; n < notes; ++n) {
+    vxcore_file_create(ctx, notebook_id, "a", Name(n).c_str(), &id);
+    vxcore_string_free(id);
+  }
+
+  std::printf("bench_node_batch: notes=%d\n", notes);
+  std::printf("  %-12s %12s %12s\n", "op", "single", "batch");
+
+  // a -> b one call at a time, then b -> a as one batch.
+  bool ok = true;
+  auto start = std::chrono::steady_clock::now();
+  for (int n = 0; n < notes; ++n) {
+    ok = ok && vxcore_node_move(ctx, notebook_id, ("a/" + Name(n)).c_str(), "b") == VXCORE_OK;
+  }
+  const double move_single = SecondsSince(start);
+
+  nlohmann::json ops = nlohmann::json::array();
+  for (int n = 0; n < notes; ++n) {
+    ops.push_back({{"op", "move"}, {"path", "b/" + Name(n)}, {"dest", "a"}});
+  }
+  start = std::chrono::steady_clock::now();
+  ok = ok && Batch(ctx, notebook_id, ops);
+  const double move_batch = SecondsSince(start);
+  std::printf("  %-12s %10.1fms %10.1fms\n", "move", move_single * 1e3, move_batch * 1e3);
+
+  start = std::chrono::steady_clock::now();
+  for (int n = 0; n < notes; ++n) {
+    ok = ok &&
+         vxcore_file_tag(ctx, notebook_id, ("a/" + Name(n)).c_str(), "single") == VXCORE_OK;
+  }
+  const double tag_single = SecondsSince(start);
+
+  ops = nlohmann::json::array();
+  for (int n = 0; n < notes; ++n) {
+    ops.push_back({{"op", "tag"}, {"path", "a/" + Name(n)}, {"tag", "batch"}});
+  }
+  start = std::chrono::steady_clock::now();
+  ok = ok && Batch(ctx, notebook_id, ops);
+  const double tag_batch = SecondsSince(start);
+  std::printf("  %-12s %10.1fms %10.1fms\n", "tag", tag_single * 1e3, tag_batch * 1e3);
+
+  char *config_json = nullptr;
+  for (int n = 0; ok && n < notes; ++n) {
+    ok = vxcore_node_get_config(ctx, notebook_id, ("a/" + Name(n)).c_str(), &config_json) ==
+             VXCORE_OK &&
+         nlohmann::json::parse(config_json)["tags"].size() == 2;
+    vxcore_string_free(config_json);
+  }
+
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+  vxcore_clear_test_directory();
+  std::filesystem::remove_all(root);
+  if (!ok) {
+    std::fprintf(stderr, "bench_node_batch: a note was lost or left untagged\n");
+    return 1;
+  }
+  return 0;
+}
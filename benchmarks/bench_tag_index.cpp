@@ -0,0 +1,175 @@
+// Tag expression benchmark: in-memory bitmap index vs SQL.
+//
+// Bulk-loads a scratch store with N files carrying a skewed mix of T tags
+// (tag k lands on roughly one file in k + 2), then for a handful of AND/OR/NOT
+// expressions times
+//   index:  TagBitmapIndex::Match alone (file UUIDs only)
+//   store:  SqliteMetadataStore::FindFilesByTagFilter (index + row loading)
+//   sql:    TagDb::FindFilesByTagExpression (compound SELECT, no index)
+// and checks that all three agree on the match count.
+//
+// Usage: bench_tag_index [files] [tags] [iterations]
+//        defaults: 100000 12 200
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "db/db_manager.h"
+#include "db/sqlite_metadata_store.h"
+#include "db/tag_bitmap_index.h"
+#include "db/tag_db.h"
+
+using namespace vxcore;
+using namespace vxcore::db;
+
+namespace {
+
+int ParseArg(int argc, char **argv, int index, int fallback) {
+  if (index >= argc) return fallback;
+  int value = std::atoi(argv[index]);
+  return value > 0 ? value : fallback;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RemoveDb(const std::string &db_path) {
+  for (const char *suffix : {"", "-wal", "-shm"}) {
+    std::filesystem::remove(db_path + suffix);
+  }
+}
+
+std::string Tag(int k) { return "tag" + std::to_string(k); }
+
+StoreFileRecord MakeFile(int n, int tags) {
+  StoreFileRecord file;
+  file.id = "file-" + std::to_string(n);
+  file.folder_id = "folder-" + std::to_string(n % 100);
+  file.name = "note" + std::to_string(n) + ".md";
+  file.created_utc = 0;
+  file.modified_utc = 0;
+  file.metadata = "{}";
+  const uint32_t hash = static_cast<uint32_t>(n) * 2654435761u;
+  for (int k = 0; k < tags; ++k) {
+    if (((hash >> 8) + static_cast<uint32_t>(k) * 40503u) % static_cast<uint32_t>(k + 2) == 0) {
+      file.tags.push_back(Tag(k));
+    }
+  }
+  return file;
+}
+
+struct Expression {
+  const char *label;
+  StoreTagFilter filter;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int files = ParseArg(argc, argv, 1, 100000);
+  // The expressions below use tag0..tag7.
+  const int tags = std::max(8, ParseArg(argc, argv, 2, 12));
+  const int iterations = ParseArg(argc, argv, 3, 200);
+
+  const std::string db_path =
+      (std::filesystem::temp_directory_path() / "vxcore_bench_tag_index.sqlite").string();
+  RemoveDb(db_path);
+
+  SqliteMetadataStore store;
+  if (!store.Open(db_path) || !store.BeginBulkLoad()) {
+    std::fprintf(stderr, "bench_tag_index: failed to set up %s\n", db_path.c_str());
+    return 1;
+  }
+  for (int f = 0; f < 100; ++f) {
+    StoreFolderRecord folder;
+    folder.id = "folder-" + std::to_string(f);
+    folder.name = "dir" + std::to_string(f);
+    folder.created_utc = 0;
+    folder.modified_utc = 0;
+    folder.metadata = "{}";
+    store.BulkAddFolder(folder);
+  }
+  for (int n = 0; n < files; ++n) {
+    store.BulkAddFile(MakeFile(n, tags));
+  }
+  if (!store.EndBulkLoad()) {
+    std::fprintf(stderr, "bench_tag_index: %s\n", store.GetLastError().c_str());
+    return 1;
+  }
+
+  // A second connection for the SQL baseline and a standalone index.
+  DbManager db;
+  if (!db.Open(db_path)) {
+    std::fprintf(stderr, "bench_tag_index: failed to reopen %s\n", db_path.c_str());
+    return 1;
+  }
+  TagDb tag_db(db.GetHandle(), db.GetStatementCache());
+  TagBitmapIndex index;
+  auto start = std::chrono::steady_clock::now();
+  if (!index.Load(tag_db)) {
+    std::fprintf(stderr, "bench_tag_index: failed to load the index\n");
+    return 1;
+  }
+  const double load_s = SecondsSince(start);
+
+  std::printf("bench_tag_index: files=%d tags=%d iterations=%d\n", files, tags, iterations);
+  std::printf("  index load %.3fs, %zu bytes of bitmaps\n", load_s, index.GetMemoryBytes());
+  std::printf("  %-28s %8s %12s %12s %12s\n", "expression", "matches", "index", "store", "sql");
+
+  const std::vector<Expression> expressions = {
+      {"tag0 AND tag1", {{Tag(0), Tag(1)}, {}, {}}},
+      {"tag2 OR tag3 OR tag4", {{}, {Tag(2), Tag(3), Tag(4)}, {}}},
+      {"tag0 AND NOT tag1", {{Tag(0)}, {}, {Tag(1)}}},
+      {"tag0 AND (tag5|tag6) NOT tag7", {{Tag(0)}, {Tag(5), Tag(6)}, {Tag(7)}}},
+      {"NOT tag0", {{}, {}, {Tag(0)}}},
+      {"tag3 AND tag4 AND tag5", {{Tag(3), Tag(4), Tag(5)}, {}, {}}},
+  };
+
+  for (const auto &expression : expressions) {
+    const StoreTagFilter &filter = expression.filter;
+
+    size_t index_count = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      index_count = index.Match(filter.all_of, filter.any_of, filter.none_of)->size();
+    }
+    const double index_us = SecondsSince(start) * 1e6 / iterations;
+
+    // Loading every matched row dominates these, so fewer rounds suffice.
+    const int slow_iterations = iterations / 20 > 0 ? iterations / 20 : 1;
+    size_t store_count = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < slow_iterations; ++i) {
+      store_count = store.FindFilesByTagFilter(filter).size();
+    }
+    const double store_us = SecondsSince(start) * 1e6 / slow_iterations;
+
+    size_t sql_count = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < slow_iterations; ++i) {
+      sql_count =
+          tag_db.FindFilesByTagExpression(filter.all_of, filter.any_of, filter.none_of).size();
+    }
+    const double sql_us = SecondsSince(start) * 1e6 / slow_iterations;
+
+    if (index_count != store_count || index_count != sql_count) {
+      std::fprintf(stderr, "bench_tag_index: '%s' disagrees: index=%zu store=%zu sql=%zu\n",
+                   expression.label, index_count, store_count, sql_count);
+      return 1;
+    }
+    std::printf("  %-28s %8zu %10.1fus %10.1fus %10.1fus\n", expression.label, index_count,
+                index_us, store_us, sql_us);
+  }
+
+  db.Close();
+  store.Close();
+  RemoveDb(db_path);
+  return 0;
+}
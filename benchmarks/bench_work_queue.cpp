@@ -0,0 +1,98 @@
+// WorkQueue producer/consumer microbenchmark.
+//
+// Runs P producer threads each enqueueing N trivial items into one WorkQueue
+// while C consumer threads drain it with ProcessNext, then prints throughput
+// together with the queue's own stats (queue latency, lock wait, per-thread
+// distribution). Use it to judge whether mutex contention on the queue is a
+// real bottleneck before reaching for a different queue design.
+//
+// Usage: bench_work_queue [producers] [consumers] [items_per_producer]
+//        defaults: 4 4 200000
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "core/work_queue.h"
+
+namespace {
+
+int ParseArg(int argc, char **argv, int index, int fallback) {
+  if (index >= argc) return fallback;
+  int value = std::atoi(argv[index]);
+  return value > 0 ? value : fallback;
+}
+
+void PrintHistogram(const char *label, const vxcore::LatencyHistogram::Snapshot &snapshot) {
+  const double avg =
+      snapshot.count ? static_cast<double>(snapshot.total_us) / snapshot.count : 0.0;
+  // p50/p99 are reported as the upper bound of the bucket they fall into.
+  auto percentile_bound = [&](double p) -> unsigned long long {
+    const uint64_t target = static_cast<uint64_t>(snapshot.count * p);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < snapshot.buckets.size(); ++i) {
+      seen += snapshot.buckets[i];
+      if (seen > target) {
+        auto bound = vxcore::LatencyHistogram::BucketUpperBoundUs(i);
+        return bound ? bound : snapshot.max_us;
+      }
+    }
+    return snapshot.max_us;
+  };
+  std::printf("  %-14s count=%llu avg=%.2fus p50<%lluus p99<%lluus max=%lluus\n", label,
+              static_cast<unsigned long long>(snapshot.count), avg, percentile_bound(0.50),
+              percentile_bound(0.99), static_cast<unsigned long long>(snapshot.max_us));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int producers = ParseArg(argc, argv, 1, 4);
+  const int consumers = ParseArg(argc, argv, 2, 4);
+  const int items_per_producer = ParseArg(argc, argv, 3, 200000);
+  const long long total = static_cast<long long>(producers) * items_per_producer;
+
+  vxcore::WorkQueue queue;
+  std::atomic<long long> done{0};
+
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> threads;
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      while (done.load(std::memory_order_relaxed) < total) {
+        queue.ProcessNext(10);
+      }
+    });
+  }
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < items_per_producer; ++i) {
+        queue.Enqueue([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  const auto stats = queue.GetStats();
+
+  std::printf("bench_work_queue: producers=%d consumers=%d items=%lld\n", producers, consumers,
+              total);
+  std::printf("  elapsed        %.3fs (%.0f items/s)\n", seconds,
+              seconds > 0 ? total / seconds : 0.0);
+  std::printf("  peak size      %zu\n", stats.peak_size);
+  PrintHistogram("queue latency", stats.queue_latency);
+  PrintHistogram("run time", stats.run_time);
+  PrintHistogram("lock wait", stats.lock_wait);
+  for (const auto &entry : stats.processed_per_thread) {
+    std::printf("  consumer       %llu items\n", static_cast<unsigned long long>(entry.second));
+  }
+  return 0;
+}
@@ -66,7 +66,9 @@ VXCORE_API VxCoreError vxcore_context_get_config(VxCoreContextHandle context, ch
 // (via JSON merge_patch over the current serialized form), then persists the
 // full config to disk. Fields the caller does not include are preserved.
 // Recognized top-level keys: "version" (string), "search" (object),
-// "fileTypes" (object), "recoverLastSession" (boolean), "autoSyncDebounceSeconds" (integer).
+// "fileTypes" (object), "recoverLastSession" (boolean), "autoSyncDebounceSeconds" (integer),
+// "database" (object; tuning takes effect for databases opened afterwards),
+// "folderConfigWrites" (object; see vxcore_db_flush_pending_writes).
 // Unknown keys are silently ignored.
 // The argument must parse to a JSON object; returns VXCORE_ERR_INVALID_PARAM
 // otherwise.
@@ -140,9 +142,39 @@ VXCORE_API VxCoreError vxcore_notebook_update_config(VxCoreContextHandle context
 // Rebuilds the metadata cache for the notebook from ground truth (vx.json files).
 // Use this when the cache seems out of sync or corrupted.
 // The cache uses lazy sync by default - this forces a full rebuild.
+// Blocks on the invoking thread, which writes the cache; vx.json files are parsed on the
+// "vxcore.rebuild" work queue, so draining that queue from other threads speeds it up.
 VXCORE_API VxCoreError vxcore_notebook_rebuild_cache(VxCoreContextHandle context,
                                                      const char *notebook_id);
 
+// Incrementally brings the metadata cache in line with the vx.json files: only folders whose
+// vx.json changed since it was last synced (by mtime/size, then content hash) are re-read and
+// diff-applied; folders no longer on disk are dropped. Much cheaper than a rebuild after a few
+// configs changed (e.g. after a sync pull). Also run automatically on open and after a
+// successful sync.
+VXCORE_API VxCoreError vxcore_notebook_reconcile_cache(VxCoreContextHandle context,
+                                                       const char *notebook_id);
+
+// Statistics of the notebook's folder config cache, the parsed vx.json files kept in memory.
+// The cache is bounded by an estimated byte budget and evicts least recently used folders first:
+//   {"entries": n, "bytes": n, "peakBytes": n, "budgetBytes": n, "pinned": n,
+//    "hits": n, "misses": n, "evictions": n}
+// bytes are estimates of the heap held; budgetBytes 0 means unbounded. pinned counts folders an
+// operation in progress is using, which are never evicted.
+// Caller must free *out_json with vxcore_string_free.
+// Returns VXCORE_ERR_UNSUPPORTED for raw notebooks, which keep no such cache.
+VXCORE_API VxCoreError vxcore_notebook_get_config_cache_stats(VxCoreContextHandle context,
+                                                              const char *notebook_id,
+                                                              char **out_json);
+
+// Bound the notebook's folder config cache to about |budget_bytes| (0 = unbounded; the default
+// is 32 MiB) and evict down to it. Evicted folders are re-read from vx.json on next access.
+// Returns VXCORE_ERR_INVALID_PARAM for a negative budget, VXCORE_ERR_UNSUPPORTED for raw
+// notebooks.
+VXCORE_API VxCoreError vxcore_notebook_set_config_cache_budget(VxCoreContextHandle context,
+                                                               const char *notebook_id,
+                                                               int64_t budget_bytes);
+
 // ============ Read-Only Flag Operations ============
 // Set the notebook's read-only flag. This is a per-device runtime flag,
 // persisted in NotebookRecord (session state). Read-only notebooks cannot
@@ -173,8 +205,8 @@ VXCORE_API VxCoreError vxcore_notebook_empty_recycle_bin(VxCoreContextHandle con
 // ============ Notebook History Operations ============
 
 // Get the file opening history for a notebook.
-// Returns a JSON array of history entries, ordered most-recent first.
-// Each entry: {"fileId": "<uuid>", "openedUtc": <millis>}
+// Returns a JSON array of the 50 most recently opened files, most-recent first.
+// Each entry: {"fileId": "<uuid>", "openedUtc": <millis>, "openCount": <n>}
 // Returns empty array "[]" if no history exists.
 // Caller must free the result with vxcore_string_free().
 VXCORE_API VxCoreError vxcore_notebook_history_get(VxCoreContextHandle context,
@@ -187,7 +219,8 @@ VXCORE_API VxCoreError vxcore_notebook_history_clear(VxCoreContextHandle context
 
 // Get file opening history with resolved paths for a notebook.
 // Returns a JSON array of history entries with resolved relative paths, most-recent first.
-// Each entry: {"fileId": "<uuid>", "openedUtc": <millis>, "relativePath": "<path>", "name": "<filename>"}
+// Each entry: {"fileId": "<uuid>", "openedUtc": <millis>, "openCount": <n>,
+//              "relativePath": "<path>", "name": "<filename>"}
 // Entries whose fileId no longer resolves (deleted files) are silently filtered out.
 // Caller must free the result with vxcore_string_free().
 VXCORE_API VxCoreError vxcore_notebook_history_get_resolved(VxCoreContextHandle context,
@@ -535,6 +568,14 @@ VXCORE_API VxCoreError vxcore_file_peek(VxCoreContextHandle context, const char
 VXCORE_API VxCoreError vxcore_node_get_config(VxCoreContextHandle context, const char *notebook_id,
                                               const char *node_path, char **out_config_json);
 
+// Batch form of vxcore_node_get_config for hosts resolving many nodes at once.
+// paths_json: JSON array of paths relative to notebook root
+// out_configs_json: receives a JSON array aligned with paths_json holding each
+// node's config (with "type") or null where vxcore_node_get_config would fail
+// (caller must free with vxcore_string_free)
+VXCORE_API VxCoreError vxcore_node_get_configs(VxCoreContextHandle context, const char *notebook_id,
+                                               const char *paths_json, char **out_configs_json);
+
 // Delete node (file or folder)
 VXCORE_API VxCoreError vxcore_node_delete(VxCoreContextHandle context, const char *notebook_id,
                                           const char *node_path);
@@ -547,6 +588,22 @@ VXCORE_API VxCoreError vxcore_node_rename(VxCoreContextHandle context, const cha
 VXCORE_API VxCoreError vxcore_node_move(VxCoreContextHandle context, const char *notebook_id,
                                         const char *src_path, const char *dest_parent_path);
 
+// Apply many node changes at once, e.g. to a selection of notes. Each
+// folder config touched is loaded and written once, the metadata store is
+// updated in one transaction and events are delivered after the batch.
+// ops_json: JSON array applied in order, each entry one of
+//   {"op":"move","path":"<node>","dest":"<parent folder, \"\" for root>"}
+//   {"op":"delete","path":"<node>"}
+//   {"op":"tag","path":"<file>","tag":"<tag>"}
+//   {"op":"untag","path":"<file>","tag":"<tag>"}
+// out_results_json: receives a JSON array aligned with ops_json holding the
+// VxCoreError of each op; a failed op does not stop the rest (caller must
+// free with vxcore_string_free)
+// Returns an error only if ops_json is malformed or the batch could not be
+// written.
+VXCORE_API VxCoreError vxcore_node_batch(VxCoreContextHandle context, const char *notebook_id,
+                                         const char *ops_json, char **out_results_json);
+
 // Copy node to a different parent folder with optional new name
 VXCORE_API VxCoreError vxcore_node_copy(VxCoreContextHandle context, const char *notebook_id,
                                         const char *src_path, const char *dest_parent_path,
@@ -605,6 +662,61 @@ VXCORE_API VxCoreError vxcore_node_get_path_by_id(VxCoreContextHandle context,
 VXCORE_API VxCoreError vxcore_node_resolve_by_id(VxCoreContextHandle context, const char *node_id,
                                                  char **out_notebook_id, char **out_relative_path);
 
+// Batch forms of vxcore_node_get_path_by_id and vxcore_node_resolve_by_id:
+// every id is looked up with a few metadata queries per notebook instead of
+// a few per id, e.g. for restoring a workspace or rendering history.
+// ids_json: JSON array of node UUIDs
+// out_paths_json: receives a JSON array aligned with ids_json holding each
+// node's relative path, or null if the node is not found
+// out_nodes_json: receives a JSON array aligned with ids_json holding
+// {"notebookId": ..., "relativePath": ...} per node, or null if no open
+// notebook contains it
+// Both outputs must be freed with vxcore_string_free.
+VXCORE_API VxCoreError vxcore_node_get_paths_by_ids(VxCoreContextHandle context,
+                                                    const char *notebook_id, const char *ids_json,
+                                                    char **out_paths_json);
+VXCORE_API VxCoreError vxcore_node_resolve_by_ids(VxCoreContextHandle context, const char *ids_json,
+                                                  char **out_nodes_json);
+
+// Find files and folders by their metadata, evaluated in the metadata store.
+// query_json: {"filter": <filter>, "includeFiles": bool, "includeFolders": bool,
+//   "limit": N}; only "filter" is required. Files are included and folders
+//   are not by default; "limit" caps each kind (0 or absent: no limit).
+//   <filter> is either a list of conditions, ANDed:
+//     [{"key": "status", "op": "eq", "value": "draft"},
+//      {"key": "review.round", "op": "ge", "value": 2}, {"key": "due", "op": "exists"}]
+//   or an object of equality tests: {"status": "draft", "pinned": true}.
+//   Keys are dotted paths into the metadata object. Ops: eq (default), ne,
+//   lt, le, gt, ge (strings or numbers), exists, missing. Values compare
+//   only with values of the same JSON type; "ne" also matches nodes without
+//   the key.
+// out_results_json: receives
+//   {"matchCount": N, "matches": [{"id": "...", "path": "...", "isFolder": false,
+//   "metadata": {...}}, ...]}, files then folders, each ordered by name.
+// Keys that are queried repeatedly get an expression index automatically;
+// see also vxcore_node_metadata_index_create.
+// Caller must free out_results_json with vxcore_string_free().
+VXCORE_API VxCoreError vxcore_node_query_by_metadata(VxCoreContextHandle context,
+                                                     const char *notebook_id,
+                                                     const char *query_json,
+                                                     char **out_results_json);
+
+// Expression indexes over a metadata key ("status", "review.state") so that
+// vxcore_node_query_by_metadata comparisons on it are answered from the index
+// instead of scanning every node. Indexes live in the notebook's metadata
+// cache and survive reopening and cache rebuilds; each one slightly slows
+// node writes. Creating an existing index or dropping a missing one is OK.
+// out_keys_json: receives a sorted JSON array of indexed keys; free it with
+// vxcore_string_free().
+VXCORE_API VxCoreError vxcore_node_metadata_index_create(VxCoreContextHandle context,
+                                                         const char *notebook_id,
+                                                         const char *key);
+VXCORE_API VxCoreError vxcore_node_metadata_index_drop(VxCoreContextHandle context,
+                                                       const char *notebook_id, const char *key);
+VXCORE_API VxCoreError vxcore_node_metadata_index_list(VxCoreContextHandle context,
+                                                       const char *notebook_id,
+                                                       char **out_keys_json);
+
 // ============ File Type Operations ============
 
 // Returns JSON array of all file types.
@@ -663,6 +775,18 @@ VXCORE_API VxCoreError vxcore_tag_find_files(VxCoreContextHandle context, const
                                              const char *tags_json, const char *op,
                                              char **out_results_json);
 
+// Find files matching a tag expression, answered from the in-memory tag index.
+// query_json: {"allOf": [...], "anyOf": [...], "noneOf": [...],
+//   "includeDescendants": bool}, every key optional: files with all "allOf"
+//   tags, at least one "anyOf" tag (if given) and no "noneOf" tag. An empty
+//   query matches nothing. With "includeDescendants": true, a tag also
+//   matches files carrying any tag below it in the hierarchy.
+// out_results_json: same shape as vxcore_tag_find_files.
+// Caller must free out_results_json with vxcore_string_free().
+VXCORE_API VxCoreError vxcore_tag_query_files(VxCoreContextHandle context,
+                                              const char *notebook_id, const char *query_json,
+                                              char **out_results_json);
+
 // Count files per tag using efficient database lookup.
 // out_results_json: receives JSON array of {tag, count} objects:
 //   [{"tag": "important", "count": 5}, {"tag": "todo", "count": 3}, ...]
@@ -671,6 +795,16 @@ VXCORE_API VxCoreError vxcore_tag_count_files_by_tag(VxCoreContextHandle context
                                                      const char *notebook_id,
                                                      char **out_results_json);
 
+// Count files per tag, both directly and rolled up over the tag's subtree.
+// out_results_json: receives JSON array ordered by tag name:
+//   [{"tag": "project", "parent": "", "count": 2, "subtreeCount": 7}, ...]
+//   "count" is files tagged with the tag itself; "subtreeCount" is distinct
+//   files tagged with it or any descendant.
+// Caller must free out_results_json with vxcore_string_free().
+VXCORE_API VxCoreError vxcore_tag_count_files_by_tag_subtree(VxCoreContextHandle context,
+                                                             const char *notebook_id,
+                                                             char **out_results_json);
+
 VXCORE_API VxCoreError vxcore_search_files(VxCoreContextHandle context, const char *notebook_id,
                                            const char *query_json, const char *input_files_json,
                                            char **out_results_json);
@@ -1557,6 +1691,27 @@ VXCORE_API VxCoreError vxcore_on_event(VxCoreContextHandle context, const char *
 VXCORE_API VxCoreError vxcore_off_event(VxCoreContextHandle context, const char *event_name,
                                         VxCoreEventCallback callback);
 
+// Subscribe ONE coalescing callback to several events.
+// event_names_json: JSON array of event names, e.g. ["file.created","folder.created"].
+// Outside a batch the callback fires per event like vxcore_on_event. While a
+// batch is open on the emitting thread (bulk copy/move/import, or
+// vxcore_event_batch_begin), matching events are coalesced and the callback
+// fires ONCE with event_name "events.batched" when the batch closes; see
+// event_names.h for the payload. Remove with vxcore_off_event (any name).
+// Returns VXCORE_ERR_JSON_PARSE if event_names_json is not an array of strings.
+VXCORE_API VxCoreError vxcore_on_events_coalesced(VxCoreContextHandle context,
+                                                  const char *event_names_json,
+                                                  VxCoreEventCallback callback, void *userdata);
+
+// Open a batch scope on the calling thread so a scripted bulk edit produces
+// one "events.batched" notification for coalescing listeners. Scopes nest;
+// every begin must be paired with vxcore_event_batch_end on the same thread.
+VXCORE_API VxCoreError vxcore_event_batch_begin(VxCoreContextHandle context);
+
+// Close the innermost batch scope on the calling thread. The outermost close
+// delivers the coalesced notification synchronously. No-op without a scope.
+VXCORE_API VxCoreError vxcore_event_batch_end(VxCoreContextHandle context);
+
 // ============ Work Queue Operations ============
 // Named work queues allow callers to dedicate different worker threads to
 // different categories of work (e.g., "sync", "events", "indexing").
@@ -1586,6 +1741,68 @@ VXCORE_API void vxcore_work_queue_shutdown(VxCoreContextHandle context, const ch
 // Shut down all work queues. Idempotent.
 VXCORE_API void vxcore_work_queue_shutdown_all(VxCoreContextHandle context);
 
+// Bound the named queue to |capacity| pending items (0 = unbounded, the
+// default) and choose what enqueueing into a full queue does. Creates the
+// queue if it does not exist yet, so it can be configured before first use.
+// Internal producers that also drain (content search) never block on a full
+// queue; they help drain instead. The content-search queue starts bounded.
+// Returns VXCORE_ERR_INVALID_PARAM for a negative capacity or unknown policy.
+VXCORE_API VxCoreError vxcore_work_queue_set_capacity(VxCoreContextHandle context,
+                                                      const char *queue_name, int capacity,
+                                                      VxCoreQueueFullPolicy policy);
+
+// Get contention and latency statistics for the named queue as JSON:
+//   {"enqueued": n, "processed": n, "rejected": n, "callerRuns": n,
+//    "fullWaits": n, "size": n, "peakSize": n, "capacity": n,
+//    "bucketUpperBoundsUs": [1, 2, 4, ..., 0],
+//    "queueLatencyUs": H, "runTimeUs": H, "lockWaitUs": H,
+//    "threads": [{"thread": "<id>", "processed": n}, ...]}
+// where each H is {"count": n, "totalUs": n, "maxUs": n, "buckets": [...]}.
+// buckets[i] counts samples below bucketUpperBoundsUs[i] (and at or above
+// the previous bound); the final bound is 0 meaning "open-ended".
+// queueLatencyUs: enqueue until a consumer starts the item. runTimeUs: time
+// inside the item. lockWaitUs: time acquiring the queue mutex.
+// Caller must free *out_json with vxcore_string_free.
+// Returns VXCORE_ERR_NOT_FOUND if the queue does not exist.
+VXCORE_API VxCoreError vxcore_work_queue_stats(VxCoreContextHandle context,
+                                               const char *queue_name, char **out_json);
+
+// Zero the named queue's statistics (peakSize restarts at the current size).
+// No-op if queue does not exist.
+VXCORE_API void vxcore_work_queue_reset_stats(VxCoreContextHandle context, const char *queue_name);
+
+// ============ Database Maintenance ============
+// vxcore never starts threads of its own, so idle-time database upkeep is
+// driven by the host: call vxcore_db_schedule_maintenance when the app goes
+// idle (or from a periodic timer) and drain the "vxcore.maintenance" queue
+// from a background thread with vxcore_work_queue_process_next.
+//
+// Each open notebook database and activity.db gets a passive WAL checkpoint
+// at most once per "database.idleCheckpointSeconds", and PRAGMA optimize at
+// most once per "database.optimizeIntervalMinutes" (0 disables it). Jobs use
+// a connection of their own and never wait on readers or writers.
+//
+// |out_scheduled| (optional) receives the number of jobs queued. Databases
+// that are not due are skipped; when the queue is full the remaining jobs
+// are left for the next call. Write-behind batches that are due (see below)
+// are committed first, on the calling thread.
+VXCORE_API VxCoreError vxcore_db_schedule_maintenance(VxCoreContextHandle context,
+                                                      int *out_scheduled);
+
+// With "database.writeBehind" enabled, notebook metadata updates are grouped
+// into one transaction that commits after "writeBehindMaxPending" updates or
+// "writeBehindDelayMs", checked on the next update or by
+// vxcore_db_schedule_maintenance. Queries through vxcore always see pending
+// updates.
+// With "folderConfigWrites.writeBehind" enabled, changes to a folder's
+// vx.json are likewise held and written once (through a temporary file
+// renamed into place) after "writeBehindMaxPending" changes or
+// "writeBehindDelayMs", checked the same way, and always before a sync
+// stages the notebook and when it closes.
+// Writes and commits all pending updates now, e.g. before copying a
+// notebook or database. Must be called on the thread that owns the context.
+VXCORE_API VxCoreError vxcore_db_flush_pending_writes(VxCoreContextHandle context);
+
 // ============ Activity Tracking Operations ============
 //
 // Activity data is collected into a standalone per-device SQLite database
@@ -1641,6 +1858,16 @@ VXCORE_API VxCoreError vxcore_activity_get_file_history(VxCoreContextHandle cont
                                                         const char *notebook_id,
                                                         const char *file_id, char **out_json);
 
+// Files of a notebook ranked by frecency: reads and edits, an edit counting
+// double, each decaying with a 14-day half-life. Deleted files are skipped;
+// limit <= 0 means 20. Flushes pending activity first. Answered from memory.
+// Output JSON (caller frees with vxcore_string_free):
+//   {"files":[{"fileId","path","score"}]}
+// score is the decayed count as of now (a read today ~1.0, two weeks ago ~0.5).
+VXCORE_API VxCoreError vxcore_activity_get_frecent_files(VxCoreContextHandle context,
+                                                         const char *notebook_id, int limit,
+                                                         char **out_json);
+
 VXCORE_API void vxcore_string_free(char *str);
 
 #ifdef __cplusplus
@@ -73,6 +73,13 @@ typedef enum {
 
 typedef enum { VXCORE_DATA_APP = 0, VXCORE_DATA_LOCAL = 1 } VxCoreDataLocation;
 
+// What enqueueing into a full bounded work queue does.
+typedef enum {
+  VXCORE_QUEUE_FULL_BLOCK = 0,       // Wait for a free slot.
+  VXCORE_QUEUE_FULL_REJECT = 1,      // Drop the item.
+  VXCORE_QUEUE_FULL_CALLER_RUNS = 2  // Run the item on the producing thread.
+} VxCoreQueueFullPolicy;
+
 typedef struct VxCoreContext *VxCoreContextHandle;
 
 typedef struct {
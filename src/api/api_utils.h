@@ -7,6 +7,10 @@
 #define vxcore_strdup strdup
 #endif
 
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
 #include "core/buffer_manager.h"
 #include "core/config_manager.h"
 #include "core/context.h"
@@ -31,6 +35,35 @@ inline void PersistSession(VxCoreContext *ctx) {
   }
 }
 
+// Parses |json| as a JSON array of strings (the batch APIs' input). On
+// failure sets ctx->last_error, naming the parameter |param|, and returns the
+// error for the caller to return.
+inline VxCoreError ParseStringArray(VxCoreContext *ctx, const char *json, const char *param,
+                                    std::vector<std::string> &out) {
+  nlohmann::json array;
+  try {
+    array = nlohmann::json::parse(json);
+  } catch (...) {
+    ctx->last_error = std::string("Invalid ") + param + " JSON";
+    return VXCORE_ERR_JSON_PARSE;
+  }
+  if (!array.is_array()) {
+    ctx->last_error = std::string(param) + " must be a JSON array";
+    return VXCORE_ERR_INVALID_PARAM;
+  }
+
+  out.clear();
+  out.reserve(array.size());
+  for (const auto &item : array) {
+    if (!item.is_string()) {
+      ctx->last_error = std::string("Each entry of ") + param + " must be a string";
+      return VXCORE_ERR_INVALID_PARAM;
+    }
+    out.push_back(item.get<std::string>());
+  }
+  return VXCORE_OK;
+}
+
 }  // namespace vxcore
 
 #endif
@@ -153,3 +153,26 @@ VXCORE_API VxCoreError vxcore_activity_get_file_history(VxCoreContextHandle cont
     return VXCORE_ERR_UNKNOWN;
   }
 }
+
+VXCORE_API VxCoreError vxcore_activity_get_frecent_files(VxCoreContextHandle context,
+                                                         const char *notebook_id, int limit,
+                                                         char **out_json) {
+  if (!context || !notebook_id || !out_json) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  try {
+    if (!ctx->activity_manager) {
+      return VXCORE_ERR_NOT_INITIALIZED;
+    }
+    std::string json;
+    VxCoreError err = ctx->activity_manager->GetFrecentFiles(notebook_id, limit, json);
+    if (err != VXCORE_OK) {
+      return err;
+    }
+    return EmitJson(json, out_json);
+  } catch (...) {
+    ctx->last_error = "Unknown error querying frecent files";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
@@ -1,5 +1,7 @@
 #include <stdlib.h>
 
+#include <chrono>
+
 #include "api_utils.h"
 #include "core/activity_manager.h"
 #include "core/buffer_manager.h"
@@ -8,11 +10,14 @@
 #include "core/datetime_names.h"
 #include "core/event_manager.h"
 #include "core/notebook_manager.h"
+#include "core/rebuild_queue_name.h"
 #include "core/snippet_manager.h"
 #include "core/template_manager.h"
 #include "core/vxcore_config.h"
 #include "core/work_queue.h"
 #include "core/workspace_manager.h"
+#include "db/db_maintenance.h"
+#include "db/db_manager.h"
 #include "platform/path_provider.h"
 #include "search/search_queue_name.h"
 #include "sync/sync_backend_registry.h"
@@ -154,6 +159,14 @@ VXCORE_API VxCoreError vxcore_context_create(const char *config_json,
       return err;
     }
 
+    // Every database opened from here on (notebook stores, activity.db)
+    // picks up the configured tuning profile.
+    const auto &db_config = ctx->config_manager->GetConfig().database;
+    vxcore::db::DbManager::SetDefaultTuning(db_config.ToTuning());
+    ctx->maintenance_scheduler = std::make_unique<vxcore::db::DbMaintenanceScheduler>(
+        std::chrono::seconds(db_config.idle_checkpoint_seconds),
+        std::chrono::minutes(db_config.optimize_interval_minutes));
+
     ctx->notebook_manager = std::make_unique<vxcore::NotebookManager>(ctx->config_manager.get());
     ctx->buffer_manager = std::make_unique<vxcore::BufferManager>(ctx->config_manager.get(),
                                                                   ctx->notebook_manager.get());
@@ -164,8 +177,13 @@ VXCORE_API VxCoreError vxcore_context_create(const char *config_json,
     ctx->sync_manager = std::make_unique<vxcore::SyncManager>(ctx->notebook_manager.get());
     ctx->work_queue_manager = std::make_unique<vxcore::WorkQueueManager>();
     // Pre-create the content-search queue so caller-helps-drain threads never
-    // spin on an absent queue.
-    ctx->work_queue_manager->GetOrCreate(vxcore::kSearchQueueName);
+    // spin on an absent queue, and bound it so large scans stay flat in memory.
+    ctx->work_queue_manager->GetOrCreate(vxcore::kSearchQueueName)
+        ->SetCapacity(vxcore::kSearchQueueCapacity);
+    ctx->work_queue_manager->GetOrCreate(vxcore::kRebuildQueueName)
+        ->SetCapacity(vxcore::kRebuildQueueCapacity);
+    ctx->work_queue_manager->GetOrCreate(vxcore::db::kMaintenanceQueueName)
+        ->SetCapacity(vxcore::db::kMaintenanceQueueCapacity);
     ctx->event_manager = std::make_unique<vxcore::EventManager>();
     ctx->notebook_manager->SetEventManager(ctx->event_manager.get());
     ctx->buffer_manager->SetEventManager(ctx->event_manager.get());
@@ -428,6 +446,17 @@ VXCORE_API VxCoreError vxcore_context_update_config(VxCoreContextHandle context,
     merged.merge_patch(incoming);
     config = vxcore::VxCoreConfig::FromJson(merged);
 
+    // New tuning applies to databases opened after this call.
+    vxcore::db::DbManager::SetDefaultTuning(config.database.ToTuning());
+    if (ctx->maintenance_scheduler) {
+      ctx->maintenance_scheduler->SetIntervals(
+          std::chrono::seconds(config.database.idle_checkpoint_seconds),
+          std::chrono::minutes(config.database.optimize_interval_minutes));
+    }
+    if (ctx->notebook_manager) {
+      ctx->notebook_manager->ApplyStoreOptions();
+    }
+
     return ctx->config_manager->SaveConfig();
   } catch (const nlohmann::json::parse_error &e) {
     ctx->last_error = std::string("JSON parse error: ") + e.what();
@@ -42,6 +42,41 @@ VXCORE_API VxCoreError vxcore_on_event(VxCoreContextHandle context, const char *
   return VXCORE_OK;
 }
 
+VXCORE_API VxCoreError vxcore_on_events_coalesced(VxCoreContextHandle context,
+                                                  const char *event_names_json,
+                                                  VxCoreEventCallback callback, void *userdata) {
+  if (!context || !event_names_json || !callback) return VXCORE_ERR_INVALID_PARAM;
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  if (!ctx->event_manager) return VXCORE_ERR_INVALID_STATE;
+
+  std::vector<std::string> event_names;
+  try {
+    auto names = nlohmann::json::parse(event_names_json);
+    if (!names.is_array()) return VXCORE_ERR_JSON_PARSE;
+    for (const auto &name : names) {
+      if (!name.is_string()) return VXCORE_ERR_JSON_PARSE;
+      event_names.push_back(name.get<std::string>());
+    }
+  } catch (const nlohmann::json::exception &) {
+    return VXCORE_ERR_JSON_PARSE;
+  }
+  if (event_names.empty()) return VXCORE_ERR_INVALID_PARAM;
+
+  auto c_cb = callback;
+  auto c_ud = userdata;
+  auto id = ctx->event_manager->SubscribeCoalesced(
+      event_names, [c_cb, c_ud](const std::string &name, const nlohmann::json &data) {
+        std::string json_str = data.dump();
+        c_cb(name.c_str(), json_str.c_str(), c_ud);
+      });
+
+  {
+    std::lock_guard<std::mutex> lock(g_c_callbacks_mutex);
+    g_c_callbacks[context].push_back({callback, userdata, id});
+  }
+  return VXCORE_OK;
+}
+
 VXCORE_API VxCoreError vxcore_off_event(VxCoreContextHandle context, const char *event_name,
                                         VxCoreEventCallback callback) {
   if (!context || !event_name || !callback) return VXCORE_ERR_INVALID_PARAM;
@@ -63,4 +98,21 @@ VXCORE_API VxCoreError vxcore_off_event(VxCoreContextHandle context, const char
   return VXCORE_ERR_NOT_FOUND;
 }
 
+
+VXCORE_API VxCoreError vxcore_event_batch_begin(VxCoreContextHandle context) {
+  if (!context) return VXCORE_ERR_INVALID_PARAM;
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  if (!ctx->event_manager) return VXCORE_ERR_INVALID_STATE;
+  ctx->event_manager->BeginBatch();
+  return VXCORE_OK;
+}
+
+VXCORE_API VxCoreError vxcore_event_batch_end(VxCoreContextHandle context) {
+  if (!context) return VXCORE_ERR_INVALID_PARAM;
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  if (!ctx->event_manager) return VXCORE_ERR_INVALID_STATE;
+  ctx->event_manager->EndBatch();
+  return VXCORE_OK;
+}
+
 }  // extern "C"
@@ -582,6 +582,273 @@ VXCORE_API VxCoreError vxcore_node_resolve_by_id(VxCoreContextHandle context, co
   }
 }
 
+VXCORE_API VxCoreError vxcore_node_get_paths_by_ids(VxCoreContextHandle context,
+                                                    const char *notebook_id, const char *ids_json,
+                                                    char **out_paths_json) {
+  if (!context || !notebook_id || !ids_json || !out_paths_json) {
+    return VXCORE_ERR_INVALID_PARAM;
+  }
+
+  *out_paths_json = nullptr;
+
+  vxcore::VxCoreContext *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    std::vector<std::string> node_ids;
+    VxCoreError err = vxcore::ParseStringArray(ctx, ids_json, "ids_json", node_ids);
+    if (err != VXCORE_OK) {
+      return err;
+    }
+
+    vxcore::Notebook *notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+    if (!notebook) {
+      ctx->last_error = "Notebook not found";
+      return VXCORE_ERR_NOT_FOUND;
+    }
+
+    vxcore::MetadataStore *store = notebook->GetMetadataStore();
+    if (!store) {
+      ctx->last_error = "MetadataStore not available";
+      return VXCORE_ERR_INVALID_STATE;
+    }
+
+    nlohmann::json result = nlohmann::json::array();
+    for (const auto &path : store->GetNodePathsByIds(node_ids)) {
+      result.push_back(path.empty() ? nlohmann::json(nullptr) : nlohmann::json(path));
+    }
+
+    *out_paths_json = vxcore_strdup(result.dump().c_str());
+    return *out_paths_json ? VXCORE_OK : VXCORE_ERR_OUT_OF_MEMORY;
+  } catch (const std::exception &e) {
+    ctx->last_error = std::string("Exception: ") + e.what();
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+VXCORE_API VxCoreError vxcore_node_resolve_by_ids(VxCoreContextHandle context, const char *ids_json,
+                                                  char **out_nodes_json) {
+  if (!context || !ids_json || !out_nodes_json) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  *out_nodes_json = nullptr;
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    std::vector<std::string> node_ids;
+    VxCoreError err = vxcore::ParseStringArray(ctx, ids_json, "ids_json", node_ids);
+    if (err != VXCORE_OK) {
+      return err;
+    }
+
+    nlohmann::json result = nlohmann::json::array();
+    for (const auto &[notebook_id, relative_path] :
+         ctx->notebook_manager->ResolveNodesByIds(node_ids)) {
+      if (notebook_id.empty()) {
+        result.push_back(nullptr);
+        continue;
+      }
+      result.push_back({{"notebookId", notebook_id}, {"relativePath", relative_path}});
+    }
+
+    *out_nodes_json = vxcore_strdup(result.dump().c_str());
+    return *out_nodes_json ? VXCORE_OK : VXCORE_ERR_OUT_OF_MEMORY;
+  } catch (...) {
+    ctx->last_error = "Unknown error resolving nodes by ID";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+namespace {
+
+// The notebook's metadata store, or null with ctx->last_error set.
+vxcore::MetadataStore *GetOpenMetadataStore(vxcore::VxCoreContext *ctx, const char *notebook_id,
+                                            VxCoreError &out_err) {
+  vxcore::Notebook *notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+  if (!notebook) {
+    ctx->last_error = "Notebook not found";
+    out_err = VXCORE_ERR_NOT_FOUND;
+    return nullptr;
+  }
+  vxcore::MetadataStore *store = notebook->GetMetadataStore();
+  if (!store || !store->IsOpen()) {
+    ctx->last_error = "MetadataStore not available";
+    out_err = VXCORE_ERR_INVALID_STATE;
+    return nullptr;
+  }
+  return store;
+}
+
+}  // namespace
+
+VXCORE_API VxCoreError vxcore_node_query_by_metadata(VxCoreContextHandle context,
+                                                     const char *notebook_id,
+                                                     const char *query_json,
+                                                     char **out_results_json) {
+  if (!context || !notebook_id || !query_json || !out_results_json) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  *out_results_json = nullptr;
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    nlohmann::json json;
+    try {
+      json = nlohmann::json::parse(query_json);
+    } catch (...) {
+      ctx->last_error = "Invalid query JSON";
+      return VXCORE_ERR_JSON_PARSE;
+    }
+    if (!json.is_object() || !json.contains("filter")) {
+      ctx->last_error = "query_json must be a JSON object with a \"filter\"";
+      return VXCORE_ERR_INVALID_PARAM;
+    }
+
+    vxcore::StoreMetadataQuery query;
+    std::string error;
+    if (!vxcore::MetadataFilter::FromJson(json["filter"], query.filter, error)) {
+      ctx->last_error = error;
+      return VXCORE_ERR_INVALID_PARAM;
+    }
+    const std::pair<const char *, bool *> flags[] = {{"includeFiles", &query.include_files},
+                                                     {"includeFolders", &query.include_folders}};
+    for (const auto &flag : flags) {
+      auto it = json.find(flag.first);
+      if (it == json.end()) {
+        continue;
+      }
+      if (!it->is_boolean()) {
+        ctx->last_error = std::string(flag.first) + " must be a boolean";
+        return VXCORE_ERR_INVALID_PARAM;
+      }
+      *flag.second = it->get<bool>();
+    }
+    auto limit_it = json.find("limit");
+    if (limit_it != json.end()) {
+      if (!limit_it->is_number_integer() || limit_it->get<int64_t>() < 0) {
+        ctx->last_error = "limit must be a non-negative integer";
+        return VXCORE_ERR_INVALID_PARAM;
+      }
+      query.limit = limit_it->get<size_t>();
+    }
+
+    VxCoreError err = VXCORE_OK;
+    vxcore::MetadataStore *store = GetOpenMetadataStore(ctx, notebook_id, err);
+    if (!store) {
+      return err;
+    }
+
+    // On the store itself rather than a pooled reader: it tracks which keys
+    // are queried to index the hot ones.
+    nlohmann::json matches = nlohmann::json::array();
+    for (const auto &match : store->FindNodesByMetadata(query)) {
+      nlohmann::json entry = nlohmann::json::object();
+      entry["id"] = match.node_id;
+      entry["path"] = match.path;
+      entry["isFolder"] = match.is_folder;
+      entry["metadata"] = nlohmann::json::parse(match.metadata, nullptr, false);
+      if (entry["metadata"].is_discarded()) {
+        entry["metadata"] = nlohmann::json::object();
+      }
+      matches.push_back(std::move(entry));
+    }
+
+    nlohmann::json output = nlohmann::json::object();
+    output["matchCount"] = static_cast<int>(matches.size());
+    output["matches"] = std::move(matches);
+    *out_results_json = vxcore_strdup(output.dump().c_str());
+    return *out_results_json ? VXCORE_OK : VXCORE_ERR_OUT_OF_MEMORY;
+  } catch (...) {
+    ctx->last_error = "Unknown error querying nodes by metadata";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+VXCORE_API VxCoreError vxcore_node_metadata_index_create(VxCoreContextHandle context,
+                                                         const char *notebook_id,
+                                                         const char *key) {
+  if (!context || !notebook_id || !key) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    if (!vxcore::IsValidMetadataKey(key)) {
+      ctx->last_error = std::string("Invalid metadata key: ") + key;
+      return VXCORE_ERR_INVALID_PARAM;
+    }
+
+    VxCoreError err = VXCORE_OK;
+    vxcore::MetadataStore *store = GetOpenMetadataStore(ctx, notebook_id, err);
+    if (!store) {
+      return err;
+    }
+    if (!store->CreateMetadataIndex(key)) {
+      ctx->last_error = store->GetLastError();
+      return VXCORE_ERR_DATABASE;
+    }
+    return VXCORE_OK;
+  } catch (...) {
+    ctx->last_error = "Unknown error creating metadata index";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+VXCORE_API VxCoreError vxcore_node_metadata_index_drop(VxCoreContextHandle context,
+                                                       const char *notebook_id, const char *key) {
+  if (!context || !notebook_id || !key) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    VxCoreError err = VXCORE_OK;
+    vxcore::MetadataStore *store = GetOpenMetadataStore(ctx, notebook_id, err);
+    if (!store) {
+      return err;
+    }
+    if (!store->DropMetadataIndex(key)) {
+      ctx->last_error = store->GetLastError();
+      return VXCORE_ERR_DATABASE;
+    }
+    return VXCORE_OK;
+  } catch (...) {
+    ctx->last_error = "Unknown error dropping metadata index";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+VXCORE_API VxCoreError vxcore_node_metadata_index_list(VxCoreContextHandle context,
+                                                       const char *notebook_id,
+                                                       char **out_keys_json) {
+  if (!context || !notebook_id || !out_keys_json) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  *out_keys_json = nullptr;
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    VxCoreError err = VXCORE_OK;
+    vxcore::MetadataStore *store = GetOpenMetadataStore(ctx, notebook_id, err);
+    if (!store) {
+      return err;
+    }
+    const nlohmann::json keys = store->ListMetadataIndexes();
+    *out_keys_json = vxcore_strdup(keys.dump().c_str());
+    return *out_keys_json ? VXCORE_OK : VXCORE_ERR_OUT_OF_MEMORY;
+  } catch (...) {
+    ctx->last_error = "Unknown error listing metadata indexes";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
 VXCORE_API VxCoreError vxcore_node_get_attachments_folder(VxCoreContextHandle context,
                                                           const char *notebook_id,
                                                           const char *file_path, char **out_path) {
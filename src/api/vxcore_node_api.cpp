@@ -104,6 +104,67 @@ VXCORE_API VxCoreError vxcore_node_get_config(VxCoreContextHandle context, const
   }
 }
 
+VXCORE_API VxCoreError vxcore_node_get_configs(VxCoreContextHandle context, const char *notebook_id,
+                                               const char *paths_json, char **out_configs_json) {
+  if (!context || !notebook_id || !paths_json || !out_configs_json) {
+    return VXCORE_ERR_INVALID_PARAM;
+  }
+
+  *out_configs_json = nullptr;
+
+  vxcore::VxCoreContext *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    std::vector<std::string> node_paths;
+    VxCoreError err = vxcore::ParseStringArray(ctx, paths_json, "paths_json", node_paths);
+    if (err != VXCORE_OK) {
+      return err;
+    }
+
+    vxcore::Notebook *notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+    if (!notebook) {
+      ctx->last_error = "Notebook not found";
+      return VXCORE_ERR_NOT_FOUND;
+    }
+
+    vxcore::FolderManager *folder_manager = notebook->GetFolderManager();
+    if (!folder_manager) {
+      ctx->last_error = "FolderManager not available";
+      return VXCORE_ERR_INVALID_STATE;
+    }
+
+    // Same lookups as vxcore_node_get_config, but the file/folder probe
+    // doubles as the fetch, and a node that fails any step becomes null.
+    nlohmann::json result = nlohmann::json::array();
+    for (const auto &node_path : node_paths) {
+      std::string config_json;
+      bool is_folder = false;
+      if (folder_manager->GetFileInfo(node_path, config_json) != VXCORE_OK) {
+        if (folder_manager->GetFolderConfig(node_path, config_json) != VXCORE_OK) {
+          result.push_back(nullptr);
+          continue;
+        }
+        is_folder = true;
+      }
+      if (!folder_manager->NodeContentExistsOnDisk(node_path, is_folder)) {
+        result.push_back(nullptr);
+        continue;
+      }
+
+      nlohmann::json j = nlohmann::json::parse(config_json);
+      j["type"] = is_folder ? "folder" : "file";
+      result.push_back(std::move(j));
+    }
+
+    *out_configs_json = vxcore_strdup(result.dump().c_str());
+    return *out_configs_json ? VXCORE_OK : VXCORE_ERR_OUT_OF_MEMORY;
+  } catch (const std::exception &e) {
+    ctx->last_error = std::string("Exception: ") + e.what();
+    VXCORE_LOG_ERROR("Node API exception: %s", e.what());
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
 VXCORE_API VxCoreError vxcore_node_delete(VxCoreContextHandle context, const char *notebook_id,
                                           const char *node_path) {
   if (!context || !notebook_id || !node_path) {
@@ -256,6 +317,102 @@ VXCORE_API VxCoreError vxcore_node_move(VxCoreContextHandle context, const char
   }
 }
 
+VXCORE_API VxCoreError vxcore_node_batch(VxCoreContextHandle context, const char *notebook_id,
+                                         const char *ops_json, char **out_results_json) {
+  if (!context || !notebook_id || !ops_json || !out_results_json) {
+    return VXCORE_ERR_INVALID_PARAM;
+  }
+
+  *out_results_json = nullptr;
+
+  vxcore::VxCoreContext *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    nlohmann::json ops_array;
+    try {
+      ops_array = nlohmann::json::parse(ops_json);
+    } catch (...) {
+      ctx->last_error = "Invalid ops_json JSON";
+      return VXCORE_ERR_JSON_PARSE;
+    }
+    if (!ops_array.is_array()) {
+      ctx->last_error = "ops_json must be a JSON array";
+      return VXCORE_ERR_INVALID_PARAM;
+    }
+
+    using NodeOp = vxcore::FolderManager::NodeOp;
+    std::vector<NodeOp> ops;
+    ops.reserve(ops_array.size());
+    for (const auto &item : ops_array) {
+      const std::string kind = item.is_object() ? item.value("op", "") : "";
+      NodeOp op;
+      const char *arg_key = nullptr;
+      if (kind == "move") {
+        op.kind = NodeOp::Kind::Move;
+        arg_key = "dest";
+      } else if (kind == "delete") {
+        op.kind = NodeOp::Kind::Delete;
+      } else if (kind == "tag" || kind == "untag") {
+        op.kind = kind == "tag" ? NodeOp::Kind::Tag : NodeOp::Kind::Untag;
+        arg_key = "tag";
+      } else {
+        ctx->last_error = "Each entry of ops_json needs an op of move, delete, tag or untag";
+        return VXCORE_ERR_INVALID_PARAM;
+      }
+      if (!item.contains("path") || !item["path"].is_string() ||
+          (arg_key && (!item.contains(arg_key) || !item[arg_key].is_string()))) {
+        ctx->last_error = "Invalid path, dest or tag in ops_json";
+        return VXCORE_ERR_INVALID_PARAM;
+      }
+      op.path = item["path"].get<std::string>();
+      if (arg_key) {
+        op.arg = item[arg_key].get<std::string>();
+      }
+      // Empty dest is the root folder, as in vxcore_node_move.
+      if (op.kind == NodeOp::Kind::Move && op.arg.empty()) {
+        op.arg = ".";
+      }
+      ops.push_back(std::move(op));
+    }
+
+    vxcore::Notebook *notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+    if (!notebook) {
+      ctx->last_error = "Notebook not found";
+      return VXCORE_ERR_NOT_FOUND;
+    }
+
+    vxcore::FolderManager *folder_manager = notebook->GetFolderManager();
+    if (!folder_manager) {
+      ctx->last_error = "FolderManager not available";
+      return VXCORE_ERR_INVALID_STATE;
+    }
+
+    std::vector<VxCoreError> results;
+    VxCoreError err = folder_manager->ApplyNodeOps(ops, results);
+
+    // Refresh open buffer paths from metadata store.
+    if (ctx->buffer_manager) {
+      ctx->buffer_manager->UpdatePaths(notebook_id);
+    }
+
+    if (err != VXCORE_OK) {
+      ctx->last_error = "Failed to apply node batch";
+      return err;
+    }
+
+    nlohmann::json result = nlohmann::json::array();
+    for (VxCoreError op_err : results) {
+      result.push_back(static_cast<int>(op_err));
+    }
+    *out_results_json = vxcore_strdup(result.dump().c_str());
+    return *out_results_json ? VXCORE_OK : VXCORE_ERR_OUT_OF_MEMORY;
+  } catch (const std::exception &e) {
+    ctx->last_error = std::string("Exception: ") + e.what();
+    VXCORE_LOG_ERROR("Node API exception: %s", e.what());
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
 VXCORE_API VxCoreError vxcore_node_copy(VxCoreContextHandle context, const char *notebook_id,
                                         const char *src_path, const char *dest_parent_path,
                                         const char *new_name, char **out_node_id) {
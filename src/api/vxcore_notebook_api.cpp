@@ -7,10 +7,14 @@
 #include "api/api_utils.h"
 #include "core/buffer_manager.h"
 #include "core/context.h"
+#include "core/folder_config_cache.h"
+#include "core/folder_manager.h"
 #include "core/history_manager.h"
 #include "core/metadata_store.h"
 #include "core/notebook.h"
 #include "core/notebook_manager.h"
+#include "core/rebuild_queue_name.h"
+#include "core/work_queue.h"
 #include "utils/logger.h"
 #include "vxcore/vxcore.h"
 
@@ -276,7 +280,8 @@ VXCORE_API VxCoreError vxcore_notebook_rebuild_cache(VxCoreContextHandle context
       return VXCORE_ERR_NOT_FOUND;
     }
 
-    VxCoreError err = notebook->RebuildCache();
+    VxCoreError err =
+        notebook->RebuildCache(ctx->work_queue_manager->GetOrCreate(vxcore::kRebuildQueueName));
     if (err != VXCORE_OK) {
       ctx->last_error = "Failed to rebuild notebook cache";
     }
@@ -287,6 +292,113 @@ VXCORE_API VxCoreError vxcore_notebook_rebuild_cache(VxCoreContextHandle context
   }
 }
 
+VXCORE_API VxCoreError vxcore_notebook_reconcile_cache(VxCoreContextHandle context,
+                                                       const char *notebook_id) {
+  if (!context || !notebook_id) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    auto *notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+    if (!notebook) {
+      ctx->last_error = "Notebook not found";
+      return VXCORE_ERR_NOT_FOUND;
+    }
+
+    VxCoreError err = notebook->ReconcileCache();
+    if (err != VXCORE_OK) {
+      ctx->last_error = "Failed to reconcile notebook cache";
+    }
+    return err;
+  } catch (...) {
+    ctx->last_error = "Unknown error reconciling notebook cache";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+VXCORE_API VxCoreError vxcore_notebook_get_config_cache_stats(VxCoreContextHandle context,
+                                                              const char *notebook_id,
+                                                              char **out_json) {
+  if (!context || !notebook_id || !out_json) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    auto *notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+    if (!notebook) {
+      ctx->last_error = "Notebook not found";
+      return VXCORE_ERR_NOT_FOUND;
+    }
+
+    vxcore::FolderManager *folder_manager = notebook->GetFolderManager();
+    if (!folder_manager) {
+      ctx->last_error = "FolderManager not available";
+      return VXCORE_ERR_INVALID_STATE;
+    }
+
+    vxcore::FolderConfigCacheStats stats;
+    VxCoreError err = folder_manager->GetConfigCacheStats(stats);
+    if (err != VXCORE_OK) {
+      ctx->last_error = "Notebook has no folder config cache";
+      return err;
+    }
+
+    nlohmann::json json = {{"entries", stats.entries},   {"bytes", stats.bytes},
+                           {"peakBytes", stats.peak_bytes}, {"budgetBytes", stats.budget_bytes},
+                           {"pinned", stats.pinned},     {"hits", stats.hits},
+                           {"misses", stats.misses},     {"evictions", stats.evictions}};
+    char *copy = vxcore_strdup(json.dump().c_str());
+    if (!copy) {
+      return VXCORE_ERR_OUT_OF_MEMORY;
+    }
+    *out_json = copy;
+    return VXCORE_OK;
+  } catch (...) {
+    ctx->last_error = "Unknown error collecting folder config cache stats";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+VXCORE_API VxCoreError vxcore_notebook_set_config_cache_budget(VxCoreContextHandle context,
+                                                               const char *notebook_id,
+                                                               int64_t budget_bytes) {
+  if (!context || !notebook_id) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+  if (budget_bytes < 0) {
+    return VXCORE_ERR_INVALID_PARAM;
+  }
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    auto *notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+    if (!notebook) {
+      ctx->last_error = "Notebook not found";
+      return VXCORE_ERR_NOT_FOUND;
+    }
+
+    vxcore::FolderManager *folder_manager = notebook->GetFolderManager();
+    if (!folder_manager) {
+      ctx->last_error = "FolderManager not available";
+      return VXCORE_ERR_INVALID_STATE;
+    }
+
+    VxCoreError err = folder_manager->SetConfigCacheBudget(static_cast<size_t>(budget_bytes));
+    if (err != VXCORE_OK) {
+      ctx->last_error = "Notebook has no folder config cache";
+    }
+    return err;
+  } catch (...) {
+    ctx->last_error = "Unknown error setting folder config cache budget";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
 VXCORE_API VxCoreError vxcore_notebook_get_recycle_bin_path(VxCoreContextHandle context,
                                                             const char *notebook_id,
                                                             char **out_path) {
@@ -512,9 +624,17 @@ VXCORE_API VxCoreError vxcore_notebook_history_get_resolved(VxCoreContextHandle
     auto history = vxcore::GetHistory(store);
     VXCORE_LOG_DEBUG("history_get_resolved: %zu entries from store for notebook %s",
                     history.size(), notebook_id);
-    nlohmann::json arr = nlohmann::json::array();
+    std::vector<std::string> file_ids;
+    file_ids.reserve(history.size());
     for (const auto &entry : history) {
-      auto path = store->GetNodePathById(entry.file_id);
+      file_ids.push_back(entry.file_id);
+    }
+    const auto paths = store->GetNodePathsByIds(file_ids);
+
+    nlohmann::json arr = nlohmann::json::array();
+    for (size_t i = 0; i < history.size(); ++i) {
+      const auto &entry = history[i];
+      const auto &path = paths[i];
       VXCORE_LOG_DEBUG("history_get_resolved: file_id=%s -> path=%s", entry.file_id.c_str(),
                       path.empty() ? "DROPPED" : path.c_str());
       if (path.empty()) {
@@ -525,6 +645,7 @@ VXCORE_API VxCoreError vxcore_notebook_history_get_resolved(VxCoreContextHandle
       nlohmann::json obj;
       obj["fileId"] = entry.file_id;
       obj["openedUtc"] = entry.opened_utc;
+      obj["openCount"] = entry.open_count;
       obj["relativePath"] = path;
       obj["name"] = name;
       arr.push_back(obj);
@@ -1,4 +1,5 @@
 #include "api/api_utils.h"
+#include "core/activity_manager.h"
 #include "core/config_manager.h"
 #include "core/context.h"
 #include "core/notebook_manager.h"
@@ -28,6 +29,9 @@ std::unique_ptr<vxcore::SearchManager> CreateSearchManager(vxcore::VxCoreContext
   auto manager = std::make_unique<vxcore::SearchManager>(notebook, backend);
   manager->SetWorkQueue(queue);
   manager->SetCancelFlag(cancel_flag);
+  if (ctx) {
+    manager->SetActivityManager(ctx->activity_manager.get());
+  }
   return manager;
 }
 
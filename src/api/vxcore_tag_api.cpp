@@ -2,6 +2,7 @@
 
 #include "api/api_utils.h"
 #include "core/context.h"
+#include "core/metadata_store.h"
 #include "core/notebook_manager.h"
 #include "vxcore/vxcore.h"
 
@@ -223,6 +224,85 @@ VXCORE_API VxCoreError vxcore_tag_find_files(VxCoreContextHandle context, const
   }
 }
 
+VXCORE_API VxCoreError vxcore_tag_query_files(VxCoreContextHandle context,
+                                              const char *notebook_id, const char *query_json,
+                                              char **out_results_json) {
+  if (!context || !notebook_id || !query_json || !out_results_json) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    auto notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+    if (!notebook) {
+      ctx->last_error = "Notebook not found";
+      return VXCORE_ERR_NOT_FOUND;
+    }
+
+    nlohmann::json query;
+    try {
+      query = nlohmann::json::parse(query_json);
+    } catch (...) {
+      ctx->last_error = "Invalid query JSON";
+      return VXCORE_ERR_JSON_PARSE;
+    }
+
+    if (!query.is_object()) {
+      ctx->last_error = "query_json must be a JSON object";
+      return VXCORE_ERR_INVALID_PARAM;
+    }
+
+    vxcore::StoreTagFilter filter;
+    const std::pair<const char *, std::vector<std::string> *> terms[] = {
+        {"allOf", &filter.all_of}, {"anyOf", &filter.any_of}, {"noneOf", &filter.none_of}};
+    for (const auto &term : terms) {
+      auto it = query.find(term.first);
+      if (it == query.end()) {
+        continue;
+      }
+      if (!it->is_array()) {
+        ctx->last_error = std::string(term.first) + " must be a JSON array";
+        return VXCORE_ERR_INVALID_PARAM;
+      }
+      for (const auto &tag : *it) {
+        if (!tag.is_string()) {
+          ctx->last_error = "Each tag must be a string";
+          return VXCORE_ERR_INVALID_PARAM;
+        }
+        term.second->push_back(tag.get<std::string>());
+      }
+    }
+
+    auto descendants_it = query.find("includeDescendants");
+    if (descendants_it != query.end()) {
+      if (!descendants_it->is_boolean()) {
+        ctx->last_error = "includeDescendants must be a boolean";
+        return VXCORE_ERR_INVALID_PARAM;
+      }
+      filter.include_descendants = descendants_it->get<bool>();
+    }
+
+    std::string results_json;
+    VxCoreError err = notebook->QueryFilesByTags(filter, results_json);
+    if (err != VXCORE_OK) {
+      ctx->last_error = "Failed to query files by tags";
+      return err;
+    }
+
+    char *json_copy = vxcore_strdup(results_json.c_str());
+    if (!json_copy) {
+      return VXCORE_ERR_OUT_OF_MEMORY;
+    }
+
+    *out_results_json = json_copy;
+    return VXCORE_OK;
+  } catch (...) {
+    ctx->last_error = "Unknown error querying files by tags";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
 VXCORE_API VxCoreError vxcore_tag_count_files_by_tag(VxCoreContextHandle context,
                                                      const char *notebook_id,
                                                      char **out_results_json) {
@@ -258,3 +338,39 @@ VXCORE_API VxCoreError vxcore_tag_count_files_by_tag(VxCoreContextHandle context
     return VXCORE_ERR_UNKNOWN;
   }
 }
+
+VXCORE_API VxCoreError vxcore_tag_count_files_by_tag_subtree(VxCoreContextHandle context,
+                                                             const char *notebook_id,
+                                                             char **out_results_json) {
+  if (!context || !notebook_id || !out_results_json) {
+    return VXCORE_ERR_NULL_POINTER;
+  }
+
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+
+  try {
+    auto notebook = ctx->notebook_manager->GetNotebook(notebook_id);
+    if (!notebook) {
+      ctx->last_error = "Notebook not found";
+      return VXCORE_ERR_NOT_FOUND;
+    }
+
+    std::string results_json;
+    VxCoreError err = notebook->CountFilesByTagSubtree(results_json);
+    if (err != VXCORE_OK) {
+      ctx->last_error = "Failed to count files by tag subtree";
+      return err;
+    }
+
+    char *json_copy = vxcore_strdup(results_json.c_str());
+    if (!json_copy) {
+      return VXCORE_ERR_OUT_OF_MEMORY;
+    }
+
+    *out_results_json = json_copy;
+    return VXCORE_OK;
+  } catch (...) {
+    ctx->last_error = "Unknown error counting files by tag subtree";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
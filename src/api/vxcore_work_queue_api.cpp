@@ -1,7 +1,55 @@
+#include <sstream>
+
+#include <nlohmann/json.hpp>
+
+#include "api/api_utils.h"
+#include "core/activity_manager.h"
 #include "core/context.h"
+#include "core/notebook_manager.h"
 #include "core/work_queue.h"
+#include "db/db_maintenance.h"
+#include "db/db_manager.h"
 #include "vxcore/vxcore.h"
 
+namespace {
+
+nlohmann::json HistogramToJson(const vxcore::LatencyHistogram::Snapshot &snapshot) {
+  return {{"count", snapshot.count},
+          {"totalUs", snapshot.total_us},
+          {"maxUs", snapshot.max_us},
+          {"buckets", snapshot.buckets}};
+}
+
+nlohmann::json StatsToJson(const vxcore::WorkQueueStats &stats) {
+  nlohmann::json bounds = nlohmann::json::array();
+  for (size_t i = 0; i < vxcore::LatencyHistogram::kBucketCount; ++i) {
+    bounds.push_back(vxcore::LatencyHistogram::BucketUpperBoundUs(i));
+  }
+
+  nlohmann::json threads = nlohmann::json::array();
+  for (const auto &entry : stats.processed_per_thread) {
+    std::ostringstream id;
+    id << entry.first;
+    threads.push_back({{"thread", id.str()}, {"processed", entry.second}});
+  }
+
+  return {{"enqueued", stats.enqueued},
+          {"processed", stats.processed},
+          {"rejected", stats.rejected},
+          {"callerRuns", stats.caller_runs},
+          {"fullWaits", stats.full_waits},
+          {"size", stats.size},
+          {"peakSize", stats.peak_size},
+          {"capacity", stats.capacity},
+          {"bucketUpperBoundsUs", std::move(bounds)},
+          {"queueLatencyUs", HistogramToJson(stats.queue_latency)},
+          {"runTimeUs", HistogramToJson(stats.run_time)},
+          {"lockWaitUs", HistogramToJson(stats.lock_wait)},
+          {"threads", std::move(threads)}};
+}
+
+}  // namespace
+
 extern "C" {
 
 VXCORE_API int vxcore_work_queue_process_next(VxCoreContextHandle context, const char *queue_name,
@@ -47,4 +95,113 @@ VXCORE_API void vxcore_work_queue_shutdown_all(VxCoreContextHandle context) {
   ctx->work_queue_manager->ShutdownAll();
 }
 
+VXCORE_API VxCoreError vxcore_work_queue_set_capacity(VxCoreContextHandle context,
+                                                      const char *queue_name, int capacity,
+                                                      VxCoreQueueFullPolicy policy) {
+  if (!context || !queue_name) return VXCORE_ERR_NULL_POINTER;
+  if (capacity < 0) return VXCORE_ERR_INVALID_PARAM;
+  vxcore::QueueFullPolicy full_policy;
+  switch (policy) {
+    case VXCORE_QUEUE_FULL_BLOCK:
+      full_policy = vxcore::QueueFullPolicy::kBlock;
+      break;
+    case VXCORE_QUEUE_FULL_REJECT:
+      full_policy = vxcore::QueueFullPolicy::kReject;
+      break;
+    case VXCORE_QUEUE_FULL_CALLER_RUNS:
+      full_policy = vxcore::QueueFullPolicy::kCallerRuns;
+      break;
+    default:
+      return VXCORE_ERR_INVALID_PARAM;
+  }
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  if (!ctx->work_queue_manager) return VXCORE_ERR_NOT_INITIALIZED;
+  ctx->work_queue_manager->GetOrCreate(queue_name)
+      ->SetCapacity(static_cast<size_t>(capacity), full_policy);
+  return VXCORE_OK;
+}
+
+VXCORE_API VxCoreError vxcore_work_queue_stats(VxCoreContextHandle context,
+                                               const char *queue_name, char **out_json) {
+  if (!context || !queue_name || !out_json) return VXCORE_ERR_NULL_POINTER;
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  if (!ctx->work_queue_manager) return VXCORE_ERR_NOT_INITIALIZED;
+  auto *q = ctx->work_queue_manager->Get(queue_name);
+  if (!q) return VXCORE_ERR_NOT_FOUND;
+
+  try {
+    char *copy = vxcore_strdup(StatsToJson(q->GetStats()).dump().c_str());
+    if (!copy) return VXCORE_ERR_OUT_OF_MEMORY;
+    *out_json = copy;
+    return VXCORE_OK;
+  } catch (...) {
+    ctx->last_error = "Unknown error collecting work queue stats";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+VXCORE_API void vxcore_work_queue_reset_stats(VxCoreContextHandle context, const char *queue_name) {
+  if (!context || !queue_name) return;
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  if (!ctx->work_queue_manager) return;
+  auto *q = ctx->work_queue_manager->Get(queue_name);
+  if (q) q->ResetStats();
+}
+
+VXCORE_API VxCoreError vxcore_db_schedule_maintenance(VxCoreContextHandle context,
+                                                      int *out_scheduled) {
+  if (!context) return VXCORE_ERR_NULL_POINTER;
+  if (out_scheduled) *out_scheduled = 0;
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  if (!ctx->work_queue_manager || !ctx->notebook_manager || !ctx->maintenance_scheduler) {
+    return VXCORE_ERR_NOT_INITIALIZED;
+  }
+
+  try {
+    // Idle time is also when a quiet store's write-behind batch comes due.
+    ctx->notebook_manager->FlushPendingWrites(/*only_if_due=*/true);
+
+    std::vector<std::string> db_paths = ctx->notebook_manager->GetOpenDatabasePaths();
+    if (ctx->activity_manager) {
+      std::string activity_db = ctx->activity_manager->GetDbPath();
+      if (!activity_db.empty()) {
+        db_paths.push_back(std::move(activity_db));
+      }
+    }
+
+    auto *queue = ctx->work_queue_manager->GetOrCreate(vxcore::db::kMaintenanceQueueName);
+    const int busy_timeout_ms = vxcore::db::DbManager::GetDefaultTuning().busy_timeout_ms;
+    const auto now = vxcore::db::DbMaintenanceScheduler::Clock::now();
+    int scheduled = 0;
+    for (const auto &task : ctx->maintenance_scheduler->CollectDue(db_paths, now)) {
+      vxcore::WorkItem item = [task, busy_timeout_ms]() {
+        vxcore::db::RunDbMaintenance(task.db_path, task.optimize, busy_timeout_ms);
+      };
+      if (queue->TryEnqueue(item) != vxcore::EnqueueResult::kQueued) {
+        break;
+      }
+      ctx->maintenance_scheduler->MarkScheduled(task, now);
+      ++scheduled;
+    }
+
+    if (out_scheduled) *out_scheduled = scheduled;
+    return VXCORE_OK;
+  } catch (...) {
+    ctx->last_error = "Unknown error scheduling database maintenance";
+    return VXCORE_ERR_UNKNOWN;
+  }
+}
+
+VXCORE_API VxCoreError vxcore_db_flush_pending_writes(VxCoreContextHandle context) {
+  if (!context) return VXCORE_ERR_NULL_POINTER;
+  auto *ctx = reinterpret_cast<vxcore::VxCoreContext *>(context);
+  if (!ctx->notebook_manager) return VXCORE_ERR_NOT_INITIALIZED;
+
+  if (!ctx->notebook_manager->FlushPendingWrites(/*only_if_due=*/false)) {
+    ctx->last_error = "Failed to write pending folder configs or metadata";
+    return VXCORE_ERR_DATABASE;
+  }
+  return VXCORE_OK;
+}
+
 }  // extern "C"
@@ -1,5 +1,7 @@
 #include "core/activity_manager.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <ctime>
 
 #include <nlohmann/json.hpp>
@@ -14,18 +16,51 @@
 #include "db/db_manager.h"
 #include "utils/file_utils.h"
 #include "utils/logger.h"
+#include "utils/utils.h"
 #include "vxcore/notebook_json_keys.h"
 
 namespace vxcore {
 
 namespace {
-// Event payload keys for file paths. These literals match the ones emitted by
-// BundledFolderManager/BufferManager; they are not part of the shared
-// notebook_json_keys.h SSOT set. file.created/file.saved carry "path";
-// file.moved carries "oldPath"/"newPath".
-constexpr const char* kPayloadKeyPath = "path";
-constexpr const char* kPayloadKeyOldPath = "oldPath";
-constexpr const char* kPayloadKeyNewPath = "newPath";
+
+// Rows older than ten half-lives add under 0.1% of their weight; seeding
+// skips them.
+constexpr int kFrecencySeedDays = static_cast<int>(10 * FrecencyIndex::kHalfLifeMs / 86400000LL);
+
+// Local 'YYYY-MM-DD' of |t|.
+std::string FormatLocalDate(std::time_t t) {
+  std::tm tm_buf{};
+#if defined(_WIN32)
+  localtime_s(&tm_buf, &t);
+#else
+  localtime_r(&t, &tm_buf);
+#endif
+  char buf[16];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%d", &tm_buf);
+  return std::string(buf);
+}
+
+// Epoch millis of local noon on |date| ('YYYY-MM-DD'), the time a seeded
+// daily row is scored at; -1 if |date| does not parse.
+int64_t LocalNoonMillis(const std::string& date) {
+  std::tm tm_buf{};
+  if (std::sscanf(date.c_str(), "%d-%d-%d", &tm_buf.tm_year, &tm_buf.tm_mon, &tm_buf.tm_mday) !=
+      3) {
+    return -1;
+  }
+  tm_buf.tm_year -= 1900;
+  tm_buf.tm_mon -= 1;
+  tm_buf.tm_hour = 12;
+  tm_buf.tm_isdst = -1;
+  const std::time_t t = std::mktime(&tm_buf);
+  return t == static_cast<std::time_t>(-1) ? -1 : static_cast<int64_t>(t) * 1000;
+}
+
+double FrecencyWeight(int64_t reads, int64_t edits) {
+  return static_cast<double>(reads) * FrecencyIndex::kReadWeight +
+         static_cast<double>(edits) * FrecencyIndex::kEditWeight;
+}
+
 }  // namespace
 
 ActivityManager::ActivityManager(ConfigManager* config_manager, NotebookManager* notebook_manager)
@@ -58,7 +93,8 @@ VxCoreError ActivityManager::Initialize() {
     return VXCORE_ERR_DATABASE;
   }
 
-  activity_db_ = std::make_unique<db::ActivityDb>(db_manager_->GetHandle());
+  activity_db_ = std::make_unique<db::ActivityDb>(db_manager_->GetHandle(),
+                                                  db_manager_->GetStatementCache());
   if (!activity_db_->InitializeSchema()) {
     VXCORE_LOG_ERROR("activity: failed to initialize schema");
     activity_db_.reset();
@@ -66,39 +102,41 @@ VxCoreError ActivityManager::Initialize() {
     return VXCORE_ERR_DATABASE;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SeedFrecencyLocked();
+  }
+
   initialized_ = true;
   owner_thread_ = std::this_thread::get_id();
   VXCORE_LOG_INFO("activity: initialized at %s", db_path.c_str());
   return VXCORE_OK;
 }
 
+std::string ActivityManager::GetDbPath() const {
+  return db_manager_ ? db_manager_->GetPath() : std::string();
+}
+
 void ActivityManager::SetEventManager(EventManager* event_manager) {
   event_manager_ = event_manager;
   if (!event_manager_) return;
 
-  auto handler = [this](const std::string& event_name, const nlohmann::json& data) {
-    std::string nb_id;
-    std::string old_path;
-    std::string new_path;
-    if (data.contains(kJsonKeyNotebookId) && data[kJsonKeyNotebookId].is_string()) {
-      nb_id = data[kJsonKeyNotebookId].get<std::string>();
-    }
-    // file.moved carries oldPath/newPath; file.created/file.saved carry path.
-    if (data.contains(kPayloadKeyNewPath) && data[kPayloadKeyNewPath].is_string()) {
-      new_path = data[kPayloadKeyNewPath].get<std::string>();
-    }
-    if (data.contains(kPayloadKeyOldPath) && data[kPayloadKeyOldPath].is_string()) {
-      old_path = data[kPayloadKeyOldPath].get<std::string>();
-    }
-    if (data.contains(kPayloadKeyPath) && data[kPayloadKeyPath].is_string()) {
-      new_path = data[kPayloadKeyPath].get<std::string>();
-    }
-    OnFileEvent(event_name, nb_id, old_path, new_path);
+  // Typed subscriptions: payload fields arrive as views, no JSON parsing.
+  // file.created/file.saved carry a path; file.moved carries old/new paths.
+  TypedEventCallback<events::NodeEvent> on_node = [this](std::string_view event_name,
+                                                         const events::NodeEvent& e) {
+    OnFileEvent(std::string(event_name), std::string(e.notebook_id), std::string(),
+                std::string(e.path));
+  };
+  TypedEventCallback<events::NodeMovedEvent> on_moved = [this](std::string_view event_name,
+                                                               const events::NodeMovedEvent& e) {
+    OnFileEvent(std::string(event_name), std::string(e.notebook_id), std::string(e.old_path),
+                std::string(e.new_path));
   };
 
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFileCreated, handler));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFileSaved, handler));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFileMoved, handler));
+  event_listener_ids_.push_back(event_manager_->SubscribeTyped(events::kFileCreated, on_node));
+  event_listener_ids_.push_back(event_manager_->SubscribeTyped(events::kFileSaved, on_node));
+  event_listener_ids_.push_back(event_manager_->SubscribeTyped(events::kFileMoved, on_moved));
 }
 
 void ActivityManager::OnFileEvent(const std::string& event_name, const std::string& notebook_id,
@@ -118,7 +156,9 @@ void ActivityManager::OnFileEvent(const std::string& event_name, const std::stri
   } else if (event_name == events::kFileSaved) {
     pending_daily_[date].notes_edited += 1;
     if (!notebook_id.empty() && !new_path.empty()) {
-      pending_file_[FileKey(date, notebook_id, new_path)].edits += 1;
+      auto& delta = pending_file_[FileKey(date, notebook_id, new_path)];
+      delta.edits += 1;
+      delta.last_ms = GetCurrentTimestampMillis();
     }
   } else if (event_name == events::kFileMoved) {
     if (!notebook_id.empty() && !new_path.empty()) {
@@ -142,7 +182,9 @@ VxCoreError ActivityManager::RecordRead(const std::string& notebook_id,
   const std::string date = TodayLocalDate();
   pending_daily_[date].notes_read += 1;
   if (!notebook_id.empty() && !rel_path.empty()) {
-    pending_file_[FileKey(date, notebook_id, rel_path)].reads += 1;
+    auto& delta = pending_file_[FileKey(date, notebook_id, rel_path)];
+    delta.reads += 1;
+    delta.last_ms = GetCurrentTimestampMillis();
   }
   return VXCORE_OK;
 }
@@ -154,7 +196,9 @@ VxCoreError ActivityManager::RecordEdit(const std::string& notebook_id,
   const std::string date = TodayLocalDate();
   pending_daily_[date].notes_edited += 1;
   if (!notebook_id.empty() && !rel_path.empty()) {
-    pending_file_[FileKey(date, notebook_id, rel_path)].edits += 1;
+    auto& delta = pending_file_[FileKey(date, notebook_id, rel_path)];
+    delta.edits += 1;
+    delta.last_ms = GetCurrentTimestampMillis();
   }
   return VXCORE_OK;
 }
@@ -191,8 +235,11 @@ void ActivityManager::FlushLocked() {
     const std::string file_id = ResolveFileId(nb, path, &clean);
     if (file_id.empty()) continue;  // best-effort: skip unresolved per-file row
     const std::string& display = clean.empty() ? path : clean;
-    activity_db_->UpsertFileActivity(date, nb, file_id, display, entry.second.reads,
-                                     entry.second.edits);
+    const FileDelta& delta = entry.second;
+    if (activity_db_->UpsertFileActivity(date, nb, file_id, display, delta.reads, delta.edits) &&
+        (delta.reads || delta.edits)) {
+      frecency_.Add(nb, file_id, FrecencyWeight(delta.reads, delta.edits), delta.last_ms);
+    }
   }
 
   for (const auto& rename : pending_renames_) {
@@ -244,19 +291,83 @@ VxCoreError ActivityManager::GetFileHistory(const std::string& notebook_id,
   return VXCORE_OK;
 }
 
-std::string ActivityManager::TodayLocalDate() {
-  std::time_t t = std::time(nullptr);
-  std::tm tm_buf{};
-#if defined(_WIN32)
-  localtime_s(&tm_buf, &t);
-#else
-  localtime_r(&t, &tm_buf);
-#endif
-  char buf[16];
-  std::strftime(buf, sizeof(buf), "%Y-%m-%d", &tm_buf);
-  return std::string(buf);
+VxCoreError ActivityManager::GetFrecentFiles(const std::string& notebook_id, int limit,
+                                             std::string& out_json) {
+  if (!initialized_ || !activity_db_) return VXCORE_ERR_INVALID_STATE;
+  if (limit <= 0) limit = 20;
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushLocked();
+
+  nlohmann::json out;
+  out["files"] = nlohmann::json::array();
+  Notebook* notebook = notebook_manager_ ? notebook_manager_->GetNotebook(notebook_id) : nullptr;
+  MetadataStore* store = notebook ? notebook->GetMetadataStore() : nullptr;
+  if (!store || !store->IsOpen()) {
+    out_json = out.dump();
+    return VXCORE_OK;
+  }
+
+  // Walk the ranking in batches of |limit|, resolving each batch in one
+  // lookup; deleted files keep their scores and are skipped here.
+  const size_t wanted = static_cast<size_t>(limit);
+  std::vector<std::string> ids;
+  std::vector<double> scores;
+  auto resolve = [&]() {
+    const auto paths = store->GetNodePathsByIds(ids);
+    for (size_t i = 0; i < ids.size() && out["files"].size() < wanted; ++i) {
+      if (paths[i].empty()) continue;
+      out["files"].push_back({{"fileId", ids[i]}, {"path", paths[i]}, {"score", scores[i]}});
+    }
+    ids.clear();
+    scores.clear();
+    return out["files"].size() < wanted;
+  };
+  bool more = true;
+  frecency_.ForEachRanked(notebook_id, GetCurrentTimestampMillis(),
+                          [&](const std::string& file_id, double score) {
+                            ids.push_back(file_id);
+                            scores.push_back(score);
+                            if (ids.size() < wanted) return true;
+                            more = resolve();
+                            return more;
+                          });
+  if (more && !ids.empty()) {
+    resolve();
+  }
+  out_json = out.dump();
+  return VXCORE_OK;
 }
 
+std::vector<double> ActivityManager::GetFrecencyScores(const std::string& notebook_id,
+                                                       const std::vector<std::string>& file_ids) {
+  std::vector<double> scores(file_ids.size(), 0.0);
+  if (!initialized_) return scores;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int64_t now_ms = GetCurrentTimestampMillis();
+  for (size_t i = 0; i < file_ids.size(); ++i) {
+    scores[i] = frecency_.GetScore(notebook_id, file_ids[i], now_ms);
+  }
+  return scores;
+}
+
+void ActivityManager::SeedFrecencyLocked() {
+  frecency_.Clear();
+  const std::time_t now = std::time(nullptr);
+  const int64_t now_ms = static_cast<int64_t>(now) * 1000;
+  const std::string from_date = FormatLocalDate(now - kFrecencySeedDays * 86400);
+  activity_db_->ForEachFileActivity(
+      from_date, [&](const std::string& date, const std::string& notebook_id,
+                     const std::string& file_id, int64_t reads, int64_t edits) {
+        const int64_t at_ms = LocalNoonMillis(date);
+        if (at_ms < 0 || (reads == 0 && edits == 0)) return;
+        frecency_.Add(notebook_id, file_id, FrecencyWeight(reads, edits), std::min(at_ms, now_ms));
+      });
+  VXCORE_LOG_DEBUG("activity: frecency seeded with %zu files since %s", frecency_.Size(),
+                   from_date.c_str());
+}
+
+std::string ActivityManager::TodayLocalDate() { return FormatLocalDate(std::time(nullptr)); }
+
 std::string ActivityManager::ResolveFileId(const std::string& notebook_id,
                                            const std::string& rel_path, std::string* out_clean) {
   if (out_clean) out_clean->clear();
@@ -10,6 +10,7 @@
 #include <tuple>
 #include <vector>
 
+#include "core/frecency_index.h"
 #include "vxcore/vxcore_types.h"
 
 namespace vxcore {
@@ -39,6 +40,10 @@ class ActivityDb;
 // runs on the owner thread where NotebookManager/MetadataStore are safe to use.
 // A crash loses at most one flush interval of activity.
 //
+// Frecency: a FrecencyIndex ranks each notebook's files by decayed reads and
+// edits. It is seeded from file_activity_daily on Initialize() and updated
+// as Flush() persists per-file deltas, so it is current as of the last flush.
+//
 // Thread-safety: recording may be called from any thread (e.g. VNote's
 // BufferSaveQueue worker emits file.saved). All state is guarded by mutex_.
 // Flush() and the query methods resolve file ids via NotebookManager and MUST
@@ -75,6 +80,9 @@ class ActivityManager {
   // nothing is pending.
   VxCoreError Flush();
 
+  // Path of activity.db; empty before a successful Initialize().
+  std::string GetDbPath() const;
+
   // --- Queries (return JSON via out param; flush pending first) ---
   VxCoreError GetRange(const std::string& from_date, const std::string& to_date,
                        std::string& out_json);
@@ -83,6 +91,18 @@ class ActivityManager {
   VxCoreError GetFileHistory(const std::string& notebook_id, const std::string& file_id,
                              std::string& out_json);
 
+  // --- Frecency (owner thread) ---
+
+  // Up to |limit| existing files of the notebook, highest frecency first.
+  // Flushes pending deltas first.
+  // {"files":[{"fileId","path","score"}]}
+  VxCoreError GetFrecentFiles(const std::string& notebook_id, int limit, std::string& out_json);
+
+  // Frecency of each of |file_ids| (0 without usage) as of the last flush.
+  // Does NOT flush: meant for ranking on every keystroke.
+  std::vector<double> GetFrecencyScores(const std::string& notebook_id,
+                                        const std::vector<std::string>& file_ids);
+
  private:
   // Local calendar date 'YYYY-MM-DD' for "now" (device timezone).
   static std::string TodayLocalDate();
@@ -103,6 +123,10 @@ class ActivityManager {
   // Persists pending deltas. Caller MUST hold mutex_. Owner-thread only.
   void FlushLocked();
 
+  // Loads the frecency index from the per-file rows recent enough to matter.
+  // Caller MUST hold mutex_.
+  void SeedFrecencyLocked();
+
   // Aggregated per-day global counters.
   struct DailyDelta {
     int64_t active_ms = 0;
@@ -114,6 +138,7 @@ class ActivityManager {
   struct FileDelta {
     int64_t reads = 0;
     int64_t edits = 0;
+    int64_t last_ms = 0;  // Time of the latest read/edit, for frecency
   };
   using FileKey = std::tuple<std::string, std::string, std::string>;  // date, notebook_id, path
 
@@ -126,7 +151,7 @@ class ActivityManager {
   std::vector<uint64_t> event_listener_ids_;
   bool initialized_ = false;
 
-  // Guards all pending maps AND activity.db access.
+  // Guards all pending maps, frecency_ AND activity.db access.
   std::mutex mutex_;
 
   std::map<std::string, DailyDelta> pending_daily_;
@@ -134,6 +159,8 @@ class ActivityManager {
   // Pending path renames: (notebook_id, old_path, new_path). Applied at flush.
   std::vector<std::tuple<std::string, std::string, std::string>> pending_renames_;
 
+  FrecencyIndex frecency_;
+
   // Thread that called Initialize(); the only thread on which NotebookManager /
   // MetadataStore may be safely accessed. Captured once, read-only thereafter.
   std::thread::id owner_thread_;
@@ -163,8 +163,10 @@ std::string BufferManager::FindBufferByPath(const std::string &notebook_id,
 }
 
 void BufferManager::UpdatePaths(const std::string &notebook_id) {
-  bool updated = false;
-
+  // Resolve every buffer of the notebook in one batch lookup.
+  MetadataStore *store = nullptr;
+  std::vector<Buffer *> buffers;
+  std::vector<std::string> file_ids;
   for (auto &pair : buffers_) {
     auto *buffer = pair.second.get();
     if (buffer->GetNotebookId() != notebook_id) {
@@ -186,12 +188,26 @@ void BufferManager::UpdatePaths(const std::string &notebook_id) {
       continue;
     }
 
-    auto *store = notebook->GetMetadataStore();
     if (!store) {
-      continue;
+      store = notebook->GetMetadataStore();
+      if (!store) {
+        return;
+      }
     }
 
-    std::string current_path = store->GetNodePathById(file_id);
+    buffers.push_back(buffer);
+    file_ids.push_back(std::move(file_id));
+  }
+  if (buffers.empty()) {
+    return;
+  }
+
+  const std::vector<std::string> current_paths = store->GetNodePathsByIds(file_ids);
+
+  bool updated = false;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    auto *buffer = buffers[i];
+    const std::string &current_path = current_paths[i];
     if (current_path.empty() || current_path == buffer->GetFilePath()) {
       continue;
     }
@@ -200,7 +216,7 @@ void BufferManager::UpdatePaths(const std::string &notebook_id) {
     buffer->SetFilePath(current_path);
     buffer->ClearBackupPathCache();
     buffer->DiscardBackup();
-    provider->SetFilePath(current_path);
+    buffer->GetProvider()->SetFilePath(current_path);
 
     VXCORE_LOG_INFO("UpdatePaths: buffer id=%s, old=%s, new=%s", buffer->GetId().c_str(),
                     old_path.c_str(), current_path.c_str());
@@ -406,9 +422,9 @@ VxCoreError BufferManager::SaveBuffer(const std::string &id) {
 
   // Emit file.saved for sync + plugin subscribers (skip external/non-notebook buffers).
   const std::string nb_id = buffer->GetNotebookId();
-  if (!nb_id.empty()) {
-    EmitEvent(events::kFileSaved,
-              {{kJsonKeyNotebookId, nb_id}, {"path", buffer->GetFilePath()}});
+  if (!nb_id.empty() && event_manager_) {
+    event_manager_->EmitTyped(events::kFileSaved,
+                              events::NodeEvent{nb_id, buffer->GetFilePath()});
   }
 
   return VXCORE_OK;
@@ -1,10 +1,13 @@
 #include "bundled_folder_manager.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <set>
 #include <sstream>
 #include <thread>
@@ -22,7 +25,9 @@
 #include "bundled_notebook.h"
 #include "core/content_processor/asset_utils.h"
 #include "core/content_processor/content_processor.h"
+#include "core/event_manager.h"
 #include "core/event_names.h"
+#include "core/work_queue.h"
 #include "metadata_store.h"
 #include "utils/file_utils.h"
 #include "utils/logger.h"
@@ -35,6 +40,11 @@ namespace fs = std::filesystem;
 
 namespace {
 
+// Folder config snapshot records are keyed by folder path, the root as ".".
+std::string SnapshotKey(const std::string &folder_path) {
+  return folder_path.empty() ? std::string(".") : folder_path;
+}
+
 // Helper to convert FolderConfig to StoreFolderRecord
 StoreFolderRecord ToStoreFolderRecord(const FolderConfig &config, const std::string &parent_id) {
   StoreFolderRecord record;
@@ -64,24 +74,17 @@ StoreFileRecord ToStoreFileRecord(const FileRecord &file, const std::string &fol
 // - Deletes files in store that no longer exist in config
 // - Creates new files that exist in config but not in store
 // - Updates existing files if they differ
-void SyncFilesToStore(MetadataStore *store, const std::string &folder_id,
-                      const std::vector<FileRecord> &config_files) {
+void SyncFilesToStore(MetadataStore *store, const FolderConfig &config) {
   if (!store) {
     return;
   }
 
   // Get existing files from store
-  std::vector<StoreFileRecord> store_files = store->ListFiles(folder_id);
-
-  // Build set of config file IDs for quick lookup
-  std::unordered_set<std::string> config_file_ids;
-  for (const auto &file : config_files) {
-    config_file_ids.insert(file.id);
-  }
+  std::vector<StoreFileRecord> store_files = store->ListFiles(config.id);
 
   // Delete orphaned files (in store but not in config)
   for (const auto &store_file : store_files) {
-    if (config_file_ids.find(store_file.id) == config_file_ids.end()) {
+    if (config.FindFileIndexById(store_file.id) < 0) {
       VXCORE_LOG_DEBUG("SyncFilesToStore: Deleting orphaned file: id=%s, name=%s",
                        store_file.id.c_str(), store_file.name.c_str());
       if (!store->DeleteFile(store_file.id)) {
@@ -98,7 +101,7 @@ void SyncFilesToStore(MetadataStore *store, const std::string &folder_id,
   }
 
   // Add or update files from config
-  for (const auto &file : config_files) {
+  for (const auto &file : config.files) {
     auto it = store_file_map.find(file.id);
     if (it != store_file_map.end()) {
       // File exists in store - update it
@@ -111,7 +114,7 @@ void SyncFilesToStore(MetadataStore *store, const std::string &folder_id,
       }
     } else {
       // File doesn't exist in store - create it
-      StoreFileRecord file_record = ToStoreFileRecord(file, folder_id);
+      StoreFileRecord file_record = ToStoreFileRecord(file, config.id);
       if (!store->CreateFile(file_record)) {
         VXCORE_LOG_WARN("SyncFilesToStore: Failed to create file: id=%s", file.id.c_str());
       }
@@ -121,6 +124,17 @@ void SyncFilesToStore(MetadataStore *store, const std::string &folder_id,
 
 }  // namespace
 
+BundledFolderManager::ConfigWriteScope::ConfigWriteScope(BundledFolderManager &manager)
+    : manager_(manager) {
+  ++manager_.config_write_scopes_;
+}
+
+BundledFolderManager::ConfigWriteScope::~ConfigWriteScope() {
+  if (--manager_.config_write_scopes_ == 0) {
+    manager_.FlushConfigWrites(/*only_if_due=*/manager_.config_write_behind_.enabled);
+  }
+}
+
 BundledFolderManager::BundledFolderManager(Notebook *notebook) : FolderManager(notebook) {
   assert(notebook && notebook->GetType() == NotebookType::Bundled);
   // @notebook is not fully initialized yet.
@@ -128,7 +142,13 @@ BundledFolderManager::BundledFolderManager(Notebook *notebook) : FolderManager(n
 
 BundledFolderManager::~BundledFolderManager() {}
 
+void BundledFolderManager::Close() {
+  FlushConfigWrites();
+  SaveConfigSnapshot();
+}
+
 VxCoreError BundledFolderManager::InitOnCreation() {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   const std::string folder_path(".");
   std::unique_ptr<FolderConfig> root_config;
   VxCoreError err = LoadFolderConfig(folder_path, root_config);
@@ -192,94 +212,233 @@ std::string BundledFolderManager::GetContentPath(const std::string &folder_path)
 }
 
 FolderConfig *BundledFolderManager::GetCachedConfig(const std::string &folder_path) {
-  auto it = config_cache_.find(folder_path);
-  if (it != config_cache_.end()) {
-    return it->second.get();
-  }
-  return nullptr;
+  return config_cache_.Get(folder_path);
 }
 
 void BundledFolderManager::CacheConfig(const std::string &folder_path,
                                        std::unique_ptr<FolderConfig> config) {
-  config_cache_[folder_path] = std::move(config);
+  // The config being replaced must not take its changes with it.
+  FlushConfigWrite(folder_path);
+  config_cache_.Put(folder_path, std::move(config));
 }
 
 void BundledFolderManager::InvalidateCache(const std::string &folder_path) {
-  config_cache_.erase(folder_path);
+  // Callers invalidate configs that no longer match the disk (folder moved
+  // or deleted); writing them back would resurrect the old location.
+  DropPendingConfigWrite(folder_path);
+  config_cache_.Erase(folder_path);
 }
 
 FileRecord *BundledFolderManager::FindFileRecord(FolderConfig &config,
                                                  const std::string &file_name) {
-  for (auto &file : config.files) {
-    if (file.name == file_name) {
-      return &file;
-    }
-  }
-  return nullptr;
+  return config.FindFile(file_name);
 }
 
 VxCoreError BundledFolderManager::LoadFolderConfig(const std::string &folder_path,
-                                                   std::unique_ptr<FolderConfig> &out_config) {
+                                                   std::unique_ptr<FolderConfig> &out_config,
+                                                   ConfigFileStamp *out_stamp) {
   out_config.reset();
 
-  std::string config_path = GetConfigPath(folder_path);
-  fs::path config_file_path = PathFromUtf8(config_path);
+  // A pending write must land before the file is read. Rebuilds flush first,
+  // so parse workers only ever see an empty set here.
+  if (pending_config_writes_.count(folder_path) > 0) {
+    FlushConfigWrite(folder_path);
+  }
 
-  if (!fs::exists(config_file_path)) {
-    return VXCORE_ERR_NOT_FOUND;
+  // Stat before reading, so a write racing with the read leaves a stale
+  // stamp behind (re-read next time) rather than a fresh one.
+  ConfigFileStamp stamp;
+  VxCoreError error = StatFolderConfig(folder_path, stamp);
+  if (error != VXCORE_OK) {
+    return error;
+  }
+
+  const std::string snapshot_key = SnapshotKey(folder_path);
+  if (config_snapshot_.Load(snapshot_key, stamp.mtime_utc, stamp.size, out_config,
+                            &stamp.hash) &&
+      (!out_stamp || !stamp.hash.empty())) {
+    if (out_stamp) {
+      *out_stamp = std::move(stamp);
+    }
+    return VXCORE_OK;
   }
 
-  std::ifstream file(config_file_path);
+  std::ifstream file(PathFromUtf8(GetConfigPath(folder_path)), std::ios::binary);
   if (!file.is_open()) {
+    out_config.reset();
     return VXCORE_ERR_IO;
   }
+  std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
-  try {
-    nlohmann::json json;
-    file >> json;
-    out_config = std::make_unique<FolderConfig>(FolderConfig::FromJson(json));
-    return VXCORE_OK;
-  } catch (const std::exception &) {
-    return VXCORE_ERR_JSON_PARSE;
+  // A snapshot hit without a hash still spares the parse.
+  if (!out_config) {
+    try {
+      out_config =
+          std::make_unique<FolderConfig>(FolderConfig::FromJson(nlohmann::json::parse(content)));
+    } catch (const std::exception &) {
+      return VXCORE_ERR_JSON_PARSE;
+    }
+  }
+
+  stamp.hash = HashContent(content);
+  StashSnapshotRecord(snapshot_key, stamp, *out_config);
+  if (out_stamp) {
+    *out_stamp = std::move(stamp);
   }
+  return VXCORE_OK;
+}
+
+VxCoreError BundledFolderManager::StatFolderConfig(const std::string &folder_path,
+                                                   ConfigFileStamp &out_stamp) const {
+  fs::path config_file_path = PathFromUtf8(GetConfigPath(folder_path));
+
+  std::error_code ec;
+  const auto size = fs::file_size(config_file_path, ec);
+  if (ec) {
+    return ec == std::errc::no_such_file_or_directory ? VXCORE_ERR_NOT_FOUND : VXCORE_ERR_IO;
+  }
+  const auto mtime = fs::last_write_time(config_file_path, ec);
+  if (ec) {
+    return VXCORE_ERR_IO;
+  }
+
+  out_stamp.mtime_utc = static_cast<int64_t>(mtime.time_since_epoch().count());
+  out_stamp.size = static_cast<int64_t>(size);
+  out_stamp.hash.clear();
+  return VXCORE_OK;
 }
 
 VxCoreError BundledFolderManager::SaveFolderConfig(const std::string &folder_path,
                                                    const FolderConfig &config) {
-  std::string config_path = GetConfigPath(folder_path);
+  // Saved configs are usually the cached ones, modified in place. A pending
+  // one is held, so its size is re-estimated once, when it is written,
+  // rather than on every save.
+  if ((config_write_scopes_ > 0 || config_write_behind_.enabled) &&
+      config_cache_.Peek(folder_path) == &config) {
+    if (pending_config_writes_.empty()) {
+      pending_config_since_ = std::chrono::steady_clock::now();
+      pending_config_saves_ = 0;
+    }
+    if (pending_config_writes_.insert(folder_path).second) {
+      config_cache_.Hold(folder_path);
+    }
+    ++pending_config_saves_;
+    return config_write_scopes_ > 0 ? VXCORE_OK : FlushConfigWrites(/*only_if_due=*/true);
+  }
 
-  fs::path config_file_path = PathFromUtf8(config_path);
-  fs::path config_dir = config_file_path.parent_path();
+  config_cache_.Refresh(folder_path);
+  DropPendingConfigWrite(folder_path);
+  return SaveFolderConfigAtomic(folder_path, config);
+}
 
-  try {
-    if (!fs::exists(config_dir)) {
-      fs::create_directories(config_dir);
-    }
+void BundledFolderManager::SetConfigWriteBehind(const WriteBehindOptions &options) {
+  config_write_behind_ = options;
+  if (!config_write_behind_.enabled && config_write_scopes_ == 0) {
+    FlushConfigWrites();
+  }
+}
 
-    std::ofstream file(config_file_path);
-    if (!file.is_open()) {
-      VXCORE_LOG_ERROR("SaveFolderConfig: cannot open %s for writing", config_path.c_str());
-      return VXCORE_ERR_IO;
-    }
+bool BundledFolderManager::HasPendingConfigWrites() const {
+  return !pending_config_writes_.empty();
+}
 
-    nlohmann::json json = config.ToJson();
-    file << json.dump(2);
-    file.close();
-    if (file.fail()) {
-      VXCORE_LOG_ERROR("SaveFolderConfig: write failed for %s", config_path.c_str());
-      return VXCORE_ERR_IO;
+bool BundledFolderManager::IsConfigWriteDue() const {
+  return !pending_config_writes_.empty() &&
+         (pending_config_saves_ >= config_write_behind_.max_pending_writes ||
+          std::chrono::steady_clock::now() - pending_config_since_ >=
+              config_write_behind_.max_delay);
+}
+
+VxCoreError BundledFolderManager::FlushConfigWrites(bool only_if_due) {
+  if (only_if_due && !IsConfigWriteDue()) {
+    return VXCORE_OK;
+  }
+  VxCoreError result = VXCORE_OK;
+  size_t written = 0;
+  // Written from a copy: writing emits events whose handlers may save again.
+  // Configs that fail to write stay pending for the next flush.
+  while (result == VXCORE_OK && !pending_config_writes_.empty()) {
+    const std::vector<std::string> folder_paths(pending_config_writes_.begin(),
+                                                pending_config_writes_.end());
+    for (const auto &folder_path : folder_paths) {
+      const VxCoreError error = FlushConfigWrite(folder_path);
+      if (error == VXCORE_OK) {
+        ++written;
+      } else {
+        result = error;
+      }
     }
-    EmitEvent(events::kFolderConfigChanged,
-              {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", folder_path}});
+  }
+  if (written > 0) {
+    VXCORE_LOG_DEBUG("FlushConfigWrites: wrote %zu folder configs", written);
+  }
+  return result;
+}
+
+VxCoreError BundledFolderManager::ApplyNodeOps(const std::vector<NodeOp> &ops,
+                                               std::vector<VxCoreError> &out_results) {
+  if (notebook_ && notebook_->IsReadOnly()) {
+    out_results.assign(ops.size(), VXCORE_ERR_READ_ONLY);
+    return VXCORE_ERR_READ_ONLY;
+  }
+  // Declared first so listeners see the batch only once it is written.
+  EventBatchScope event_batch(event_manager_);
+  FolderConfigCache::Scope cache_scope(config_cache_);
+
+  MetadataStore *store = notebook_->GetMetadataStore();
+  const bool in_txn = store && store->BeginTransaction();
+
+  VxCoreError error = VXCORE_OK;
+  {
+    ConfigWriteScope write_scope(*this);
+    FolderManager::ApplyNodeOps(ops, out_results);
+    error = FlushConfigWrites(/*only_if_due=*/config_write_behind_.enabled);
+  }
+
+  // Like the per-op write-through, a store failure leaves vx.json, the
+  // source of truth, as it is; the next reconcile catches the store up.
+  if (in_txn && !store->CommitTransaction()) {
+    VXCORE_LOG_ERROR("ApplyNodeOps: Failed to commit: %s", store->GetLastError().c_str());
+    store->RollbackTransaction();
+  }
+
+  if (error != VXCORE_OK) {
+    VXCORE_LOG_ERROR("ApplyNodeOps: failed to write folder configs (error=%d)", error);
+  }
+  return error;
+}
+
+VxCoreError BundledFolderManager::FlushConfigWrite(const std::string &folder_path) {
+  if (pending_config_writes_.erase(folder_path) == 0) {
     return VXCORE_OK;
-  } catch (const std::exception &e) {
-    VXCORE_LOG_ERROR("SaveFolderConfig: failed to write %s: %s", config_path.c_str(), e.what());
-    return VXCORE_ERR_IO;
+  }
+
+  FolderConfig *config = config_cache_.Peek(folder_path);
+  VxCoreError error = VXCORE_ERR_INVALID_STATE;
+  if (config) {
+    config_cache_.Refresh(folder_path);
+    error = SaveFolderConfigAtomic(folder_path, *config);
+  } else {
+    VXCORE_LOG_ERROR("FlushConfigWrite: %s is no longer cached; its changes are lost",
+                     folder_path.c_str());
+  }
+  if (error != VXCORE_OK && config && pending_config_writes_.insert(folder_path).second) {
+    // Keeps its hold.
+    return error;
+  }
+  config_cache_.Release(folder_path);
+  return error;
+}
+
+void BundledFolderManager::DropPendingConfigWrite(const std::string &folder_path) {
+  if (pending_config_writes_.erase(folder_path) > 0) {
+    config_cache_.Release(folder_path);
   }
 }
 
 VxCoreError BundledFolderManager::GetFolderConfig(const std::string &folder_path,
                                                   std::string &out_config_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   out_config_json.clear();
   const auto clean_folder_path = GetCleanRelativePath(folder_path);
   FolderConfig *config = nullptr;
@@ -314,12 +473,15 @@ VxCoreError BundledFolderManager::GetFolderConfig(const std::string &folder_path
 
   SyncFolderToStore(folder_path, **out_config,
                     parent_id ? *parent_id : GetParentFolderId(folder_path));
+  // Syncing may have loaded other folders; the one handed out comes last.
+  config_cache_.Touch(folder_path);
   return VXCORE_OK;
 }
 
 VxCoreError BundledFolderManager::CreateFolder(const std::string &parent_path,
                                                const std::string &folder_name,
                                                std::string &out_folder_id) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -394,15 +556,19 @@ VxCoreError BundledFolderManager::CreateFolder(const std::string &parent_path,
   VXCORE_LOG_INFO("Folder created successfully: id=%s", out_folder_id.c_str());
   VXCORE_LOG_DEBUG("CreateFolder: emitting folder.created notebook_id=%s path=%s",
                    notebook_->GetId().c_str(), folder_relative_path.c_str());
-  EmitEvent(events::kFolderCreated,
-            {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", folder_relative_path}});
+  EmitEvent(events::kFolderCreated, events::NodeEvent{notebook_->GetId(), folder_relative_path});
   return VXCORE_OK;
 }
 
 VxCoreError BundledFolderManager::DeleteFolder(const std::string &folder_path) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
+  // Config files are removed from disk below; pending writes go first.
+  if (FlushConfigWrites() != VXCORE_OK) {
+    return VXCORE_ERR_IO;
+  }
   VXCORE_LOG_INFO("Deleting folder: path=%s", folder_path.c_str());
 
   const auto clean_folder_path = GetCleanRelativePath(folder_path);
@@ -477,8 +643,7 @@ VxCoreError BundledFolderManager::DeleteFolder(const std::string &folder_path) {
     }
 
     VXCORE_LOG_INFO("Folder deleted successfully: path=%s", clean_folder_path.c_str());
-    EmitEvent(events::kFolderDeleted,
-              {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", clean_folder_path}});
+    EmitEvent(events::kFolderDeleted, events::NodeEvent{notebook_->GetId(), clean_folder_path});
     return VXCORE_OK;
   } catch (const std::exception &) {
     return VXCORE_ERR_IO;
@@ -487,6 +652,7 @@ VxCoreError BundledFolderManager::DeleteFolder(const std::string &folder_path) {
 
 VxCoreError BundledFolderManager::UpdateFolderMetadata(const std::string &folder_path,
                                                        const std::string &metadata_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -521,7 +687,7 @@ VxCoreError BundledFolderManager::UpdateFolderMetadata(const std::string &folder
     }
 
     EmitEvent(events::kFolderMetadataUpdated,
-              {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", clean_folder_path}});
+              events::NodeEvent{notebook_->GetId(), clean_folder_path});
     return VXCORE_OK;
   } catch (const std::exception &) {
     return VXCORE_ERR_JSON_PARSE;
@@ -530,6 +696,7 @@ VxCoreError BundledFolderManager::UpdateFolderMetadata(const std::string &folder
 
 VxCoreError BundledFolderManager::UpdateNodeTimestamps(const std::string &node_path,
                                                        int64_t created_utc, int64_t modified_utc) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -606,6 +773,7 @@ VxCoreError BundledFolderManager::UpdateNodeTimestamps(const std::string &node_p
 
 VxCoreError BundledFolderManager::GetFolderMetadata(const std::string &folder_path,
                                                     std::string &out_metadata_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   const auto clean_folder_path = GetCleanRelativePath(folder_path);
 
   FolderConfig *config = nullptr;
@@ -620,9 +788,14 @@ VxCoreError BundledFolderManager::GetFolderMetadata(const std::string &folder_pa
 
 VxCoreError BundledFolderManager::RenameFolder(const std::string &folder_path,
                                                const std::string &new_name) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
+  // Config files are moved on disk below; pending writes go first.
+  if (FlushConfigWrites() != VXCORE_OK) {
+    return VXCORE_ERR_IO;
+  }
   VXCORE_LOG_INFO("RenameFolder: folder_path=%s, new_name=%s", folder_path.c_str(),
                   new_name.c_str());
   VXCORE_LOG_DEBUG("RenameFolder: new_name bytes=[%s] len=%zu", new_name.c_str(), new_name.size());
@@ -718,9 +891,16 @@ VxCoreError BundledFolderManager::RenameFolder(const std::string &folder_path,
 
 VxCoreError BundledFolderManager::MoveFolder(const std::string &src_path,
                                              const std::string &dest_parent_path) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
+  // Config files are moved on disk below; pending writes go first.
+  if (FlushConfigWrites() != VXCORE_OK) {
+    return VXCORE_ERR_IO;
+  }
+  // Coalesce the parent vx.json writes into one batched notification.
+  EventBatchScope event_batch(event_manager_);
   VXCORE_LOG_INFO("MoveFolder: src_path=%s, dest_parent_path=%s", src_path.c_str(),
                   dest_parent_path.c_str());
 
@@ -891,6 +1071,7 @@ VxCoreError BundledFolderManager::ProcessCopiedFolderTree(const std::string &des
       config->folders.end());
 
   // Process each file: regenerate UUID, rename assets dir, rewrite content
+  config->InvalidateFileIndex();
   for (auto &file : config->files) {
     std::string old_uuid = file.id;
     file.id = GenerateUUID();
@@ -978,9 +1159,18 @@ VxCoreError BundledFolderManager::CopyFolder(const std::string &src_path,
                                              const std::string &dest_parent_path,
                                              const std::string &new_name,
                                              std::string &out_folder_id) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
+  // Config files are copied from disk below; pending writes go first.
+  if (FlushConfigWrites() != VXCORE_OK) {
+    return VXCORE_ERR_IO;
+  }
+  // ProcessCopiedFolderTree rewrites every vx.json in the copied subtree;
+  // coalescing listeners get one notification for the whole copy.
+  EventBatchScope event_batch(event_manager_);
+
   const auto clean_src_path = GetCleanRelativePath(src_path);
   const auto clean_dest_parent_path = GetCleanRelativePath(dest_parent_path);
 
@@ -1079,6 +1269,7 @@ VxCoreError BundledFolderManager::CopyFolder(const std::string &src_path,
 VxCoreError BundledFolderManager::CreateFile(const std::string &folder_path,
                                              const std::string &file_name,
                                              std::string &out_file_id) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1117,7 +1308,7 @@ VxCoreError BundledFolderManager::CreateFile(const std::string &folder_path,
   }
 
   const auto ts = GetCurrentTimestampMillis();
-  config->files.emplace_back(file_name);
+  config->AddFile(FileRecord(file_name));
   config->files.back().created_utc = ts;
   config->files.back().modified_utc = ts;
   config->modified_utc = ts;
@@ -1138,12 +1329,12 @@ VxCoreError BundledFolderManager::CreateFile(const std::string &folder_path,
   }
 
   auto file_rel_path = ConcatenatePaths(clean_folder_path, file_name);
-  EmitEvent(events::kFileCreated,
-            {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", file_rel_path}});
+  EmitEvent(events::kFileCreated, events::NodeEvent{notebook_->GetId(), file_rel_path});
   return VXCORE_OK;
 }
 
 VxCoreError BundledFolderManager::DeleteFile(const std::string &file_path) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1158,17 +1349,15 @@ VxCoreError BundledFolderManager::DeleteFile(const std::string &file_path) {
     return error;
   }
 
-  auto it = std::find_if(config->files.begin(), config->files.end(),
-                         [&file_name](const FileRecord &file) { return file.name == file_name; });
-
-  if (it == config->files.end()) {
+  const int file_index = config->FindFileIndex(file_name);
+  if (file_index < 0) {
     return VXCORE_ERR_NOT_FOUND;
   }
 
   // Save the file ID before erasing
-  std::string file_id = it->id;
+  std::string file_id = config->files[file_index].id;
 
-  config->files.erase(it);
+  config->RemoveFile(file_index);
   config->modified_utc = GetCurrentTimestampMillis();
   error = SaveFolderConfig(folder_path, *config);
   if (error != VXCORE_OK) {
@@ -1195,8 +1384,7 @@ VxCoreError BundledFolderManager::DeleteFile(const std::string &file_path) {
     }
 
     VXCORE_LOG_INFO("DeleteFile successful: file %s deleted", clean_file_path.c_str());
-    EmitEvent(events::kFileDeleted,
-              {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", clean_file_path}});
+    EmitEvent(events::kFileDeleted, events::NodeEvent{notebook_->GetId(), clean_file_path});
     return VXCORE_OK;
   } catch (const std::exception &) {
     return VXCORE_ERR_IO;
@@ -1205,6 +1393,7 @@ VxCoreError BundledFolderManager::DeleteFile(const std::string &file_path) {
 
 VxCoreError BundledFolderManager::UpdateFileMetadata(const std::string &file_path,
                                                      const std::string &metadata_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1246,7 +1435,7 @@ VxCoreError BundledFolderManager::UpdateFileMetadata(const std::string &file_pat
     }
 
     EmitEvent(events::kFileMetadataUpdated,
-              {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", clean_file_path}});
+              events::NodeEvent{notebook_->GetId(), clean_file_path});
     return VXCORE_OK;
   } catch (const std::exception &) {
     return VXCORE_ERR_JSON_PARSE;
@@ -1255,6 +1444,7 @@ VxCoreError BundledFolderManager::UpdateFileMetadata(const std::string &file_pat
 
 VxCoreError BundledFolderManager::UpdateFileTags(const std::string &file_path,
                                                  const std::string &tags_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1303,10 +1493,12 @@ VxCoreError BundledFolderManager::UpdateFileTags(const std::string &file_path,
       }
     }
 
-    EmitEvent(events::kFileTagsReplaced,
-              {{kJsonKeyNotebookId, notebook_->GetId()},
-               {"path", clean_file_path},
-               {"tags", new_tags}});
+    if (WantsEvent(events::kFileTagsReplaced)) {
+      EmitEvent(events::kFileTagsReplaced,
+                {{kJsonKeyNotebookId, notebook_->GetId()},
+                 {"path", clean_file_path},
+                 {"tags", new_tags}});
+    }
     return VXCORE_OK;
   } catch (const std::exception &) {
     return VXCORE_ERR_JSON_PARSE;
@@ -1315,6 +1507,7 @@ VxCoreError BundledFolderManager::UpdateFileTags(const std::string &file_path,
 
 VxCoreError BundledFolderManager::TagFile(const std::string &file_path,
                                           const std::string &tag_name) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1359,12 +1552,13 @@ VxCoreError BundledFolderManager::TagFile(const std::string &file_path,
   }
 
   EmitEvent(events::kFileTagged,
-            {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", clean_file_path}, {"tag", tag_name}});
+            events::FileTagEvent{notebook_->GetId(), clean_file_path, tag_name});
   return VXCORE_OK;
 }
 
 VxCoreError BundledFolderManager::UntagFile(const std::string &file_path,
                                             const std::string &tag_name) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1405,12 +1599,13 @@ VxCoreError BundledFolderManager::UntagFile(const std::string &file_path,
   }
 
   EmitEvent(events::kFileUntagged,
-            {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", clean_file_path}, {"tag", tag_name}});
+            events::FileTagEvent{notebook_->GetId(), clean_file_path, tag_name});
   return VXCORE_OK;
 }
 
 VxCoreError BundledFolderManager::GetFileInfo(const std::string &file_path,
                                               std::string &out_file_info_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   const FileRecord *record = nullptr;
   VxCoreError error = GetFileInfo(file_path, &record);
   if (error != VXCORE_OK) {
@@ -1422,6 +1617,7 @@ VxCoreError BundledFolderManager::GetFileInfo(const std::string &file_path,
 
 VxCoreError BundledFolderManager::GetFileInfo(const std::string &file_path,
                                               const FileRecord **out_record) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   *out_record = nullptr;
 
   const auto clean_file_path = GetCleanRelativePath(file_path);
@@ -1444,6 +1640,7 @@ VxCoreError BundledFolderManager::GetFileInfo(const std::string &file_path,
 
 VxCoreError BundledFolderManager::GetFileMetadata(const std::string &file_path,
                                                   std::string &out_metadata_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   const auto clean_file_path = GetCleanRelativePath(file_path);
 
   const auto [folder_path, file_name] = SplitPath(clean_file_path);
@@ -1464,6 +1661,7 @@ VxCoreError BundledFolderManager::GetFileMetadata(const std::string &file_path,
 
 VxCoreError BundledFolderManager::RenameFile(const std::string &file_path,
                                              const std::string &new_name) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1508,7 +1706,7 @@ VxCoreError BundledFolderManager::RenameFile(const std::string &file_path,
     return VXCORE_ERR_IO;
   }
 
-  file->name = new_name;
+  config->RenameFile(static_cast<size_t>(file - config->files.data()), new_name);
   file->modified_utc = GetCurrentTimestampMillis();
   config->modified_utc = file->modified_utc;
 
@@ -1527,14 +1725,14 @@ VxCoreError BundledFolderManager::RenameFile(const std::string &file_path,
   VXCORE_LOG_INFO("RenameFile successful: file renamed from %s to %s", clean_file_path.c_str(),
                   ConcatenatePaths(folder_path, new_name).c_str());
   EmitEvent(events::kFileMoved,
-            {{kJsonKeyNotebookId, notebook_->GetId()},
-             {"oldPath", clean_file_path},
-             {"newPath", ConcatenatePaths(folder_path, new_name)}});
+            events::NodeMovedEvent{notebook_->GetId(), clean_file_path,
+                                   ConcatenatePaths(folder_path, new_name)});
   return VXCORE_OK;
 }
 
 VxCoreError BundledFolderManager::MoveFile(const std::string &src_file_path,
                                            const std::string &dest_folder_path) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1668,9 +1866,8 @@ VxCoreError BundledFolderManager::MoveFile(const std::string &src_file_path,
   FileRecord file_copy = *file;
   file_copy.modified_utc = GetCurrentTimestampMillis();
 
-  auto it = std::find_if(src_config->files.begin(), src_config->files.end(),
-                         [&file_name](const FileRecord &f) { return f.name == file_name; });
-  if (it == src_config->files.end()) {
+  const int file_index = src_config->FindFileIndex(file_name);
+  if (file_index < 0) {
     // Defensive: FindFileRecord matched above, so this should be unreachable.
     // erase(end()) would be undefined behaviour, so bail loudly instead.
     VXCORE_LOG_ERROR("MoveFile: record for '%s' vanished from source config after the file was "
@@ -1678,7 +1875,7 @@ VxCoreError BundledFolderManager::MoveFile(const std::string &src_file_path,
                      file_name.c_str(), PathToUtf8(dest_fs_path).c_str());
     return VXCORE_ERR_INVALID_STATE;
   }
-  src_config->files.erase(it);
+  src_config->RemoveFile(file_index);
   src_config->modified_utc = file_copy.modified_utc;
   error = SaveFolderConfig(src_folder_path, *src_config);
   if (error != VXCORE_OK) {
@@ -1690,7 +1887,7 @@ VxCoreError BundledFolderManager::MoveFile(const std::string &src_file_path,
     return error;
   }
 
-  dest_config->files.push_back(file_copy);
+  dest_config->AddFile(file_copy);
   dest_config->modified_utc = file_copy.modified_utc;
   error = SaveFolderConfig(clean_dest_folder_path, *dest_config);
   if (error != VXCORE_OK) {
@@ -1710,15 +1907,15 @@ VxCoreError BundledFolderManager::MoveFile(const std::string &src_file_path,
   VXCORE_LOG_INFO("MoveFile successful: file moved from %s to %s", clean_src_file_path.c_str(),
                   ConcatenatePaths(clean_dest_folder_path, file_name).c_str());
   EmitEvent(events::kFileMoved,
-            {{kJsonKeyNotebookId, notebook_->GetId()},
-             {"oldPath", clean_src_file_path},
-             {"newPath", ConcatenatePaths(clean_dest_folder_path, file_name)}});
+            events::NodeMovedEvent{notebook_->GetId(), clean_src_file_path,
+                                   ConcatenatePaths(clean_dest_folder_path, file_name)});
   return VXCORE_OK;
 }
 
 VxCoreError BundledFolderManager::CopyFile(const std::string &src_file_path,
                                            const std::string &dest_folder_path,
                                            const std::string &new_name, std::string &out_file_id) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -1840,7 +2037,7 @@ VxCoreError BundledFolderManager::CopyFile(const std::string &src_file_path,
     }
   }
 
-  dest_config->files.push_back(new_file);
+  dest_config->AddFile(new_file);
   dest_config->modified_utc = new_file.created_utc;
   error = SaveFolderConfig(clean_dest_folder_path, *dest_config);
   if (error != VXCORE_OK) {
@@ -1862,6 +2059,8 @@ VxCoreError BundledFolderManager::CopyFile(const std::string &src_file_path,
 void BundledFolderManager::IterateAllFiles(
     std::function<bool(const std::string &, const FileRecord &)> callback) {
   std::function<bool(const std::string &)> iterate_folder = [&](const std::string &fp) {
+    // Keeps only the configs of the folders being walked pinned.
+    FolderConfigCache::Scope cache_scope(config_cache_);
     FolderConfig *config = nullptr;
     VxCoreError error = GetFolderConfig(fp, &config);
     if (error != VXCORE_OK) {
@@ -1907,6 +2106,7 @@ VxCoreError BundledFolderManager::FindFilesByTag(const std::string &tag_name,
 VxCoreError BundledFolderManager::ListFolderContents(const std::string &folder_path,
                                                      bool include_folders_info,
                                                      FolderContents &out_contents) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   FolderConfig *config = nullptr;
   VxCoreError error = GetFolderConfig(folder_path, &config);
   if (error != VXCORE_OK) {
@@ -1934,9 +2134,101 @@ VxCoreError BundledFolderManager::ListFolderContents(const std::string &folder_p
   return VXCORE_OK;
 }
 
-void BundledFolderManager::ClearCache() { config_cache_.clear(); }
+void BundledFolderManager::ClearCache() {
+  FlushConfigWrites();
+  if (!pending_config_writes_.empty()) {
+    VXCORE_LOG_WARN("ClearCache: dropping %zu folder configs that failed to write",
+                    pending_config_writes_.size());
+    for (const auto &folder_path : pending_config_writes_) {
+      config_cache_.Release(folder_path);
+    }
+    pending_config_writes_.clear();
+  }
+  config_cache_.Clear();
+}
+
+VxCoreError BundledFolderManager::GetConfigCacheStats(FolderConfigCacheStats &out_stats) {
+  out_stats = config_cache_.GetStats();
+  return VXCORE_OK;
+}
+
+VxCoreError BundledFolderManager::SetConfigCacheBudget(size_t budget_bytes) {
+  config_cache_.SetBudget(budget_bytes);
+  return VXCORE_OK;
+}
+
+std::string BundledFolderManager::GetConfigSnapshotPath() const {
+  return ConcatenatePaths(notebook_->GetLocalDataFolder(), kConfigSnapshotFileName);
+}
+
+void BundledFolderManager::LoadConfigSnapshot() {
+  if (config_snapshot_.Open(GetConfigSnapshotPath())) {
+    VXCORE_LOG_DEBUG("LoadConfigSnapshot: %zu folder configs", config_snapshot_.Size());
+  }
+}
+
+void BundledFolderManager::StashSnapshotRecord(const std::string &folder_path,
+                                               const ConfigFileStamp &stamp,
+                                               const FolderConfig &config) {
+  FolderConfigSnapshot::Record record;
+  record.folder_path = SnapshotKey(folder_path);
+  record.stamp = stamp;
+  record.bytes = FolderConfigSnapshot::Encode(config);
+
+  std::lock_guard<std::mutex> lock(snapshot_records_mutex_);
+  auto key = record.folder_path;
+  snapshot_records_[std::move(key)] = std::move(record);
+}
+
+void BundledFolderManager::SaveConfigSnapshot() {
+  std::unordered_map<std::string, FolderConfigSnapshot::Record> updates;
+  {
+    std::lock_guard<std::mutex> lock(snapshot_records_mutex_);
+    updates.swap(snapshot_records_);
+  }
+  if (updates.empty()) {
+    // Records of the current snapshot validate themselves on load.
+    return;
+  }
+
+  auto is_current = [this](const std::string &folder_path, const ConfigFileStamp &stamp) {
+    ConfigFileStamp disk;
+    return StatFolderConfig(folder_path, disk) == VXCORE_OK &&
+           disk.mtime_utc == stamp.mtime_utc && disk.size == stamp.size;
+  };
+
+  std::vector<FolderConfigSnapshot::Record> records;
+  records.reserve(updates.size() + config_snapshot_.Size());
+  for (auto &update : updates) {
+    if (is_current(update.first, update.second.stamp)) {
+      records.push_back(std::move(update.second));
+    }
+  }
+
+  std::vector<std::string> kept_paths;
+  config_snapshot_.ForEachEntry(
+      [&](const std::string &folder_path, const FolderConfigSnapshot::Stamp &stamp) {
+        if (updates.count(folder_path) == 0 && is_current(folder_path, stamp)) {
+          kept_paths.push_back(folder_path);
+        }
+      });
+  for (const auto &folder_path : kept_paths) {
+    FolderConfigSnapshot::Record record;
+    if (config_snapshot_.ReadRecord(folder_path, record)) {
+      records.push_back(std::move(record));
+    }
+  }
+
+  // Released first: Windows cannot rename over an open file.
+  config_snapshot_.Close();
+  const std::string snapshot_path = GetConfigSnapshotPath();
+  if (FolderConfigSnapshot::Write(snapshot_path, records)) {
+    VXCORE_LOG_DEBUG("SaveConfigSnapshot: %zu folder configs", records.size());
+  }
+  config_snapshot_.Open(snapshot_path);
+}
 
-VxCoreError BundledFolderManager::SyncMetadataStoreFromConfigs() {
+VxCoreError BundledFolderManager::SyncMetadataStoreFromConfigs(WorkQueue *parse_queue) {
   auto *store = notebook_->GetMetadataStore();
   if (!store) {
     VXCORE_LOG_ERROR("SyncMetadataStoreFromConfigs: MetadataStore not available");
@@ -1945,68 +2237,170 @@ VxCoreError BundledFolderManager::SyncMetadataStoreFromConfigs() {
 
   VXCORE_LOG_INFO("SyncMetadataStoreFromConfigs: Starting sync from config files");
 
-  // Rebuild the store (clears all data and re-initializes schema)
-  if (!store->RebuildAll()) {
-    VXCORE_LOG_ERROR("SyncMetadataStoreFromConfigs: Failed to rebuild store");
+  // Config files are read from disk below; pending writes go first.
+  if (FlushConfigWrites() != VXCORE_OK) {
     return VXCORE_ERR_IO;
   }
 
-  // Begin transaction for bulk inserts
-  if (!store->BeginTransaction()) {
-    VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to begin transaction");
+  // Clear the store and load every folder and file through the bulk path:
+  // one transaction, batched inserts, indexes rebuilt once at the end.
+  if (!store->BeginBulkLoad()) {
+    VXCORE_LOG_ERROR("SyncMetadataStoreFromConfigs: Failed to rebuild store: %s",
+                     store->GetLastError().c_str());
+    return VXCORE_ERR_IO;
   }
 
-  // Helper to recursively sync folders
-  // Returns true on success, false on failure
-  std::function<bool(const std::string &, const std::string &)> sync_folder =
-      [&](const std::string &folder_path, const std::string &parent_folder_id) -> bool {
-    FolderConfig *config = nullptr;
-    VxCoreError error = GetFolderConfig(folder_path, &config);
-    if (error != VXCORE_OK) {
-      VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to load config for folder: %s",
-                      folder_path.c_str());
-      return false;
+  // One folder to visit. Jobs are consumed in breadth-first order, so a
+  // folder's record is always written after its parent's.
+  struct ParseJob {
+    std::string folder_path;
+    std::string parent_id;
+    // Set by whoever parsed the config; null when it was already cached.
+    std::unique_ptr<FolderConfig> config;
+    ConfigFileStamp stamp;
+    VxCoreError error = VXCORE_OK;
+    // Writer-thread only. A job that was never queued is parsed inline.
+    bool queued = false;
+    // Set by the queued parse once |config| and |error| are final.
+    std::atomic<bool> done{false};
+  };
+
+  // Parsing only reads the config file; it must not touch the config cache
+  // or the store, which belong to the writer (this thread). Not
+  // GetFolderConfig: its lazy SyncFolderToStore would also write to the
+  // store behind the bulk load's back.
+  auto parse = [this](ParseJob &job) {
+    try {
+      job.error = LoadFolderConfig(job.folder_path, job.config, &job.stamp);
+    } catch (const std::exception &) {
+      job.error = VXCORE_ERR_IO;
     }
+    job.done.store(true, std::memory_order_release);
+  };
 
-    // Create folder record in store
-    StoreFolderRecord folder_record = ToStoreFolderRecord(*config, parent_folder_id);
-    if (!store->CreateFolder(folder_record)) {
-      VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to create folder in store: %s",
-                      config->id.c_str());
-      // Continue anyway - best effort
+  std::deque<std::shared_ptr<ParseJob>> jobs;
+  // jobs[0, submitted) have been handed to the queue or are already done.
+  size_t submitted = 0;
+
+  auto submit_ahead = [&]() {
+    while (submitted < jobs.size() && submitted < kRebuildParseWindow) {
+      auto job = jobs[submitted];
+      if (parse_queue && !config_cache_.Contains(job->folder_path)) {
+        WorkItem item([job, &parse]() { parse(*job); });
+        EnqueueResult result = parse_queue->TryEnqueue(item);
+        if (result == EnqueueResult::kFull) {
+          // Retried after the writer has drained some of it.
+          break;
+        }
+        // On shutdown the job stays un-queued and is parsed inline.
+        job->queued = result == EnqueueResult::kQueued;
+      }
+      ++submitted;
     }
+  };
+
+  auto push_job = [&](std::string folder_path, std::string parent_id) {
+    auto job = std::make_shared<ParseJob>();
+    job->folder_path = std::move(folder_path);
+    job->parent_id = std::move(parent_id);
+    jobs.push_back(std::move(job));
+  };
+
+  // Stamps of the configs parsed here (cached ones have none), written once
+  // the load has committed.
+  std::vector<std::pair<std::string, ConfigFileStamp>> stamps;
+
+  // Start from root folder with empty parent_id
+  push_job(".", "");
+  bool success = true;
+  constexpr int kHelpDrainPollMs = 5;
 
-    // Create file records in store
+  while (!jobs.empty()) {
+    submit_ahead();
+
+    auto job = jobs.front();
+    jobs.pop_front();
+    if (submitted > 0) {
+      --submitted;
+    }
+
+    if (job->queued) {
+      // Help drain until our job has run; other threads may be running it.
+      while (!job->done.load(std::memory_order_acquire)) {
+        parse_queue->ProcessNext(kHelpDrainPollMs);
+      }
+    }
+
+    // Trims between folders, so a rebuild leaves at most the budget cached.
+    FolderConfigCache::Scope cache_scope(config_cache_);
+    FolderConfig *config = GetCachedConfig(job->folder_path);
+    if (!config) {
+      if (!job->queued) {
+        parse(*job);
+      }
+      if (job->error != VXCORE_OK || !job->config) {
+        VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to load config for folder: %s",
+                        job->folder_path.c_str());
+        success = false;
+        continue;
+      }
+      config = job->config.get();
+      CacheConfig(job->folder_path, std::move(job->config));
+    }
+
+    // Queue folder record
+    StoreFolderRecord folder_record = ToStoreFolderRecord(*config, job->parent_id);
+    if (!store->BulkAddFolder(folder_record)) {
+      VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to create folder in store: %s (%s)",
+                      config->id.c_str(), store->GetLastError().c_str());
+      // Its files and subfolders have no parent to attach to.
+      success = false;
+      continue;
+    }
+    if (!job->stamp.hash.empty()) {
+      stamps.emplace_back(config->id, std::move(job->stamp));
+    }
+
+    // Queue file records
     for (const auto &file : config->files) {
       StoreFileRecord file_record = ToStoreFileRecord(file, config->id);
-      if (!store->CreateFile(file_record)) {
-        VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to create file in store: %s",
-                        file.id.c_str());
+      if (!store->BulkAddFile(file_record)) {
+        VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to create file in store: %s (%s)",
+                        file.id.c_str(), store->GetLastError().c_str());
         // Continue anyway - best effort
       }
     }
 
-    // Recursively sync subfolders
+    // Subfolders go to the back of the line
     for (const auto &subfolder_name : config->folders) {
-      std::string subfolder_path = ConcatenatePaths(folder_path, subfolder_name);
-      if (!sync_folder(subfolder_path, config->id)) {
-        // Log but continue with other subfolders
-        VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to sync subfolder: %s",
-                        subfolder_path.c_str());
-      }
+      push_job(ConcatenatePaths(job->folder_path, subfolder_name), config->id);
     }
+  }
 
-    return true;
-  };
-
-  // Start from root folder with empty parent_id
-  bool success = sync_folder(".", "");
+  if (!store->EndBulkLoad()) {
+    VXCORE_LOG_ERROR("SyncMetadataStoreFromConfigs: Failed to write store: %s",
+                     store->GetLastError().c_str());
+    // Cached configs are assumed to be in the store; drop them so the next
+    // access syncs lazily again.
+    ClearCache();
+    return VXCORE_ERR_IO;
+  }
 
-  // Commit transaction
-  if (!store->CommitTransaction()) {
-    VXCORE_LOG_WARN("SyncMetadataStoreFromConfigs: Failed to commit transaction");
+  // Best effort: a folder left unstamped is simply re-read by the next
+  // ReconcileMetadataStore().
+  const bool stamp_txn = store->BeginTransaction();
+  for (const auto &entry : stamps) {
+    store->SetFolderConfigStamp(entry.first, entry.second.mtime_utc, entry.second.size,
+                                entry.second.hash);
+  }
+  if (stamp_txn) {
+    store->CommitTransaction();
   }
 
+  // Every folder was just read, so this is the cheapest time to snapshot
+  // them all.
+  SaveConfigSnapshot();
+
   if (success) {
     VXCORE_LOG_INFO("SyncMetadataStoreFromConfigs: Sync completed successfully");
     return VXCORE_OK;
@@ -2016,6 +2410,191 @@ VxCoreError BundledFolderManager::SyncMetadataStoreFromConfigs() {
   }
 }
 
+bool BundledFolderManager::ApplyFolderConfigToStore(MetadataStore *store,
+                                                    const FolderConfig &config,
+                                                    const std::string &parent_folder_id) {
+  auto existing = store->GetFolder(config.id);
+  if (existing.has_value()) {
+    // The folder was moved (its vx.json now lives under another parent).
+    if (existing->parent_id != parent_folder_id && !parent_folder_id.empty() &&
+        !store->MoveFolder(config.id, parent_folder_id)) {
+      VXCORE_LOG_WARN("ApplyFolderConfigToStore: Failed to move folder: id=%s (%s)",
+                      config.id.c_str(), store->GetLastError().c_str());
+      return false;
+    }
+    if (!store->UpdateFolder(config.id, config.name, config.modified_utc,
+                             config.metadata.dump())) {
+      VXCORE_LOG_WARN("ApplyFolderConfigToStore: Failed to update folder: id=%s (%s)",
+                      config.id.c_str(), store->GetLastError().c_str());
+      return false;
+    }
+  } else if (!store->CreateFolder(ToStoreFolderRecord(config, parent_folder_id))) {
+    VXCORE_LOG_WARN("ApplyFolderConfigToStore: Failed to create folder: id=%s (%s)",
+                    config.id.c_str(), store->GetLastError().c_str());
+    return false;
+  }
+
+  SyncFilesToStore(store, config);
+  return true;
+}
+
+VxCoreError BundledFolderManager::ReconcileMetadataStore(bool skip_if_unstamped,
+                                                         int *out_changed_folders,
+                                                         int *out_removed_folders) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
+  if (out_changed_folders) {
+    *out_changed_folders = 0;
+  }
+  if (out_removed_folders) {
+    *out_removed_folders = 0;
+  }
+
+  auto *store = notebook_->GetMetadataStore();
+  if (!store) {
+    VXCORE_LOG_ERROR("ReconcileMetadataStore: MetadataStore not available");
+    return VXCORE_ERR_INVALID_STATE;
+  }
+
+  // Config files are read from disk below; pending writes go first.
+  if (FlushConfigWrites() != VXCORE_OK) {
+    return VXCORE_ERR_IO;
+  }
+
+  // What the store currently holds, keyed by relative path ("" is the root).
+  std::vector<StoreFolderConfigStamp> known_list = store->ListFolderConfigStamps();
+  std::unordered_map<std::string, const StoreFolderConfigStamp *> known_by_path;
+  bool any_stamped = false;
+  for (const auto &known : known_list) {
+    known_by_path[known.folder_path] = &known;
+    any_stamped = any_stamped || !known.hash.empty();
+  }
+  if (skip_if_unstamped && !any_stamped) {
+    VXCORE_LOG_DEBUG("ReconcileMetadataStore: No stamps recorded, skipping");
+    return VXCORE_OK;
+  }
+
+  VXCORE_LOG_INFO("ReconcileMetadataStore: Reconciling %zu known folders", known_list.size());
+
+  struct Visit {
+    std::string folder_path;
+    std::string parent_id;
+  };
+  // Breadth-first, so a folder's parent row is in place before the folder.
+  std::deque<Visit> visits;
+  visits.push_back({".", ""});
+  std::unordered_set<std::string> reachable_ids;
+  int changed = 0;
+  int rehashed = 0;
+
+  const bool in_txn = store->BeginTransaction();
+
+  // Children of a folder whose config is unchanged are read from the store.
+  auto visit_store_children = [&](const std::string &folder_path, const std::string &folder_id) {
+    for (const auto &child : store->ListFolders(folder_id)) {
+      visits.push_back({ConcatenatePaths(folder_path, child.name), folder_id});
+    }
+  };
+
+  while (!visits.empty()) {
+    Visit visit = std::move(visits.front());
+    visits.pop_front();
+
+    const std::string key = visit.folder_path == "." ? std::string() : visit.folder_path;
+    auto known_it = known_by_path.find(key);
+    const StoreFolderConfigStamp *known =
+        known_it != known_by_path.end() ? known_it->second : nullptr;
+
+    ConfigFileStamp disk;
+    if (StatFolderConfig(visit.folder_path, disk) != VXCORE_OK) {
+      // Gone from disk; its row, if any, is removed as unreachable below.
+      VXCORE_LOG_WARN("ReconcileMetadataStore: Missing config for folder: %s",
+                      visit.folder_path.c_str());
+      continue;
+    }
+
+    if (known && !known->hash.empty() && known->mtime_utc == disk.mtime_utc &&
+        known->size == disk.size) {
+      reachable_ids.insert(known->folder_id);
+      visit_store_children(visit.folder_path, known->folder_id);
+      continue;
+    }
+
+    std::unique_ptr<FolderConfig> config;
+    if (LoadFolderConfig(visit.folder_path, config, &disk) != VXCORE_OK || !config) {
+      VXCORE_LOG_WARN("ReconcileMetadataStore: Failed to load config for folder: %s",
+                      visit.folder_path.c_str());
+      continue;
+    }
+
+    if (known && known->folder_id == config->id && known->hash == disk.hash) {
+      // Touched but not modified (e.g. rewritten by a checkout): restamp only.
+      ++rehashed;
+      store->SetFolderConfigStamp(config->id, disk.mtime_utc, disk.size, disk.hash);
+      reachable_ids.insert(config->id);
+      visit_store_children(visit.folder_path, config->id);
+      continue;
+    }
+
+    if (known && known->folder_id != config->id) {
+      // A different folder now lives at this path. Forget the stamps at and
+      // below it so those get re-applied, but keep the old row: it may have
+      // been renamed and still be reached elsewhere (a -> b, then a new "a").
+      // If not, the unreachable sweep below removes it.
+      const std::string prefix = key.empty() ? std::string() : key + "/";
+      for (auto it = known_by_path.begin(); it != known_by_path.end();) {
+        if (it->first.compare(0, prefix.size(), prefix) == 0) {
+          it = known_by_path.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    if (!ApplyFolderConfigToStore(store, *config, visit.parent_id)) {
+      // Its subfolders have no parent row to attach to.
+      continue;
+    }
+    store->SetFolderConfigStamp(config->id, disk.mtime_utc, disk.size, disk.hash);
+    ++changed;
+    reachable_ids.insert(config->id);
+
+    for (const auto &subfolder_name : config->folders) {
+      visits.push_back({ConcatenatePaths(visit.folder_path, subfolder_name), config->id});
+    }
+    CacheConfig(visit.folder_path, std::move(config));
+  }
+
+  // Rows no longer reachable from the root config. Deleting a parent takes
+  // its subtree along, so later deletes in it may fail harmlessly.
+  int removed = 0;
+  for (const auto &known : known_list) {
+    if (reachable_ids.count(known.folder_id) == 0) {
+      if (store->DeleteFolder(known.folder_id)) {
+        ++removed;
+      }
+      InvalidateCache(known.folder_path.empty() ? "." : known.folder_path);
+    }
+  }
+
+  if (in_txn && !store->CommitTransaction()) {
+    VXCORE_LOG_ERROR("ReconcileMetadataStore: Failed to commit: %s",
+                     store->GetLastError().c_str());
+    store->RollbackTransaction();
+    ClearCache();
+    return VXCORE_ERR_IO;
+  }
+
+  VXCORE_LOG_INFO("ReconcileMetadataStore: %d folders applied, %d restamped, %d removed", changed,
+                  rehashed, removed);
+  if (out_changed_folders) {
+    *out_changed_folders = changed;
+  }
+  if (out_removed_folders) {
+    *out_removed_folders = removed;
+  }
+  return VXCORE_OK;
+}
+
 // ---------------------------------------------------------------------------
 // Folder-bundle import: authoritative id oracle + journaled attach + recovery.
 // ---------------------------------------------------------------------------
@@ -2149,8 +2728,13 @@ VxCoreError BundledFolderManager::SaveFolderConfigAtomic(const std::string &fold
       return VXCORE_ERR_IO;
     }
 
-    EmitEvent(events::kFolderConfigChanged,
-              {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", folder_path}});
+    ConfigFileStamp stamp;
+    if (StatFolderConfig(folder_path, stamp) == VXCORE_OK) {
+      stamp.hash = HashContent(payload);
+      StashSnapshotRecord(folder_path, stamp, config);
+    }
+
+    EmitEvent(events::kFolderConfigChanged, events::NodeEvent{notebook_->GetId(), folder_path});
     return VXCORE_OK;
   } catch (const std::exception &e) {
     VXCORE_LOG_ERROR("SaveFolderConfigAtomic: failed for %s: %s", config_path.c_str(), e.what());
@@ -2161,6 +2745,11 @@ VxCoreError BundledFolderManager::SaveFolderConfigAtomic(const std::string &fold
 VxCoreError BundledFolderManager::CollectAllNodeIds(std::vector<std::string> &out_ids) {
   out_ids.clear();
 
+  // Config files are read from disk below; pending writes go first.
+  if (FlushConfigWrites() != VXCORE_OK) {
+    return VXCORE_ERR_IO;
+  }
+
   // Ground truth is the on-disk metadata tree, NOT the store: bundled
   // notebooks index lazily, so a store miss proves nothing.
   const fs::path contents_root = PathFromUtf8(notebook_->GetMetadataFolder()) / "contents";
@@ -2215,11 +2804,16 @@ VxCoreError BundledFolderManager::AttachImportedFolder(const std::string &dest_f
                                                        const std::string &name,
                                                        const std::string &staging_dir,
                                                        std::string &out_folder_id) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   out_folder_id.clear();
 
   if (notebook_ && notebook_->IsReadOnly()) {
     return VXCORE_ERR_READ_ONLY;
   }
+  // The destination's config file is read and replaced on disk below.
+  if (FlushConfigWrites() != VXCORE_OK) {
+    return VXCORE_ERR_IO;
+  }
   if (name.empty() || name == "." || name == ".." || !IsSingleName(name)) {
     VXCORE_LOG_ERROR("AttachImportedFolder: unsafe name: %s", name.c_str());
     return VXCORE_ERR_INVALID_PARAM;
@@ -2493,8 +3087,7 @@ VxCoreError BundledFolderManager::AttachImportedFolder(const std::string &dest_f
 
   // ONE structural event for the imported root. Descendant creations are NOT
   // replayed: consumers reload the subtree from the parent.
-  EmitEvent(events::kFolderCreated,
-            {{kJsonKeyNotebookId, notebook_->GetId()}, {"path", child_relative_path}});
+  EmitEvent(events::kFolderCreated, events::NodeEvent{notebook_->GetId(), child_relative_path});
 
   RemoveTreeQuietly(staging);
   VXCORE_LOG_INFO("AttachImportedFolder: attached %s as %s", name.c_str(),
@@ -2503,6 +3096,7 @@ VxCoreError BundledFolderManager::AttachImportedFolder(const std::string &dest_f
 }
 
 VxCoreError BundledFolderManager::RecoverImports(int *out_recovered_count) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (out_recovered_count) {
     *out_recovered_count = 0;
   }
@@ -2655,7 +3249,7 @@ void BundledFolderManager::SyncFolderToStore(const std::string &folder_path,
   }
 
   // Sync files (add/update/delete orphans)
-  SyncFilesToStore(store, config.id, config.files);
+  SyncFilesToStore(store, config);
 
   // Recursively sync subfolders
   // NOTE: Use LoadFolderConfig (not GetFolderConfig) to avoid infinite recursion.
@@ -2798,6 +3392,7 @@ std::string BundledFolderManager::GenerateUniqueFileName(const std::string &fold
 VxCoreError BundledFolderManager::ImportFile(const std::string &folder_path,
                                              const std::string &external_file_path,
                                              std::string &out_file_id) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -2851,7 +3446,7 @@ VxCoreError BundledFolderManager::ImportFile(const std::string &folder_path,
 
   // Add file to folder config
   const auto ts = GetCurrentTimestampMillis();
-  config->files.emplace_back(target_name);
+  config->AddFile(FileRecord(target_name));
   config->files.back().created_utc = ts;
   config->files.back().modified_utc = ts;
   config->modified_utc = ts;
@@ -2887,9 +3482,13 @@ VxCoreError BundledFolderManager::ImportFolder(const std::string &dest_folder_pa
                                                const std::string &external_folder_path,
                                                const std::string &suffix_allowlist,
                                                std::string &out_folder_id) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
+  // Per-node vx.json writes for the imported tree coalesce into one batch.
+  EventBatchScope event_batch(event_manager_);
+
   VXCORE_LOG_INFO("ImportFolder: dest=%s, external=%s, suffix_allowlist=%s",
                   dest_folder_path.c_str(), external_folder_path.c_str(), suffix_allowlist.c_str());
 
@@ -3151,7 +3750,7 @@ VxCoreError BundledFolderManager::ImportFolder(const std::string &dest_folder_pa
 
           // Add file to config
           const auto ts = GetCurrentTimestampMillis();
-          config.files.emplace_back(entry_name);
+          config.AddFile(FileRecord(entry_name));
           config.files.back().created_utc = ts;
           config.files.back().modified_utc = ts;
         }
@@ -3207,6 +3806,7 @@ VxCoreError BundledFolderManager::ImportFolder(const std::string &dest_folder_pa
 }
 
 VxCoreError BundledFolderManager::IndexNode(const std::string &node_path) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   const auto clean_path = GetCleanRelativePath(node_path);
   VXCORE_LOG_INFO("IndexNode: path=%s", clean_path.c_str());
 
@@ -3281,7 +3881,7 @@ VxCoreError BundledFolderManager::IndexNode(const std::string &node_path) {
 
     // Add file to parent folder's file list
     const auto ts = GetCurrentTimestampMillis();
-    parent_config->files.emplace_back(node_name);
+    parent_config->AddFile(FileRecord(node_name));
     parent_config->files.back().created_utc = ts;
     parent_config->files.back().modified_utc = ts;
     parent_config->modified_utc = ts;
@@ -3309,9 +3909,15 @@ VxCoreError BundledFolderManager::IndexNode(const std::string &node_path) {
 }
 
 VxCoreError BundledFolderManager::UnindexNode(const std::string &node_path) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   const auto clean_path = GetCleanRelativePath(node_path);
   VXCORE_LOG_INFO("UnindexNode: path=%s", clean_path.c_str());
 
+  // Config files may be removed from disk below; pending writes go first.
+  if (FlushConfigWrites() != VXCORE_OK) {
+    return VXCORE_ERR_IO;
+  }
+
   // Get parent folder path and node name
   const auto [parent_path, node_name] = SplitPath(clean_path);
 
@@ -3370,15 +3976,13 @@ VxCoreError BundledFolderManager::UnindexNode(const std::string &node_path) {
   }
 
   // Check if it's a file
-  auto file_it =
-      std::find_if(parent_config->files.begin(), parent_config->files.end(),
-                   [&node_name](const FileRecord &file) { return file.name == node_name; });
-  if (file_it != parent_config->files.end()) {
+  const int file_index = parent_config->FindFileIndex(node_name);
+  if (file_index >= 0) {
     // Save the file ID before erasing
-    std::string file_id = file_it->id;
+    std::string file_id = parent_config->files[file_index].id;
 
     // Remove file from parent folder's file list
-    parent_config->files.erase(file_it);
+    parent_config->RemoveFile(file_index);
     parent_config->modified_utc = GetCurrentTimestampMillis();
     error = SaveFolderConfig(parent_path, *parent_config);
     if (error != VXCORE_OK) {
@@ -3405,6 +4009,7 @@ VxCoreError BundledFolderManager::UnindexNode(const std::string &node_path) {
 
 VxCoreError BundledFolderManager::ListExternalNodes(const std::string &folder_path,
                                                     FolderContents &out_contents) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   const auto clean_path = GetCleanRelativePath(folder_path);
 
   // Clear output
@@ -3506,6 +4111,7 @@ VxCoreError BundledFolderManager::ListExternalNodes(const std::string &folder_pa
 
 VxCoreError BundledFolderManager::GetFileAttachments(const std::string &file_path,
                                                      std::string &out_attachments_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   const auto clean_file_path = GetCleanRelativePath(file_path);
 
   const auto [folder_path, file_name] = SplitPath(clean_file_path);
@@ -3528,6 +4134,7 @@ VxCoreError BundledFolderManager::GetFileAttachments(const std::string &file_pat
 
 VxCoreError BundledFolderManager::UpdateFileAttachments(const std::string &file_path,
                                                         const std::string &attachments_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -3582,6 +4189,7 @@ VxCoreError BundledFolderManager::UpdateFileAttachments(const std::string &file_
 
 VxCoreError BundledFolderManager::AddFileAttachment(const std::string &file_path,
                                                     const std::string &attachment) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -3631,6 +4239,7 @@ VxCoreError BundledFolderManager::AddFileAttachment(const std::string &file_path
 
 VxCoreError BundledFolderManager::DeleteFileAttachment(const std::string &file_path,
                                                        const std::string &attachment) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
       return VXCORE_ERR_READ_ONLY;
     }
@@ -3680,6 +4289,7 @@ VxCoreError BundledFolderManager::DeleteFileAttachment(const std::string &file_p
 
 VxCoreError BundledFolderManager::SetChildrenOrder(const std::string &folder_path,
                                                    const std::string &ordered_json) {
+  FolderConfigCache::Scope cache_scope(config_cache_);
   if (notebook_ && notebook_->IsReadOnly()) {
     return VXCORE_ERR_READ_ONLY;
   }
@@ -3810,6 +4420,7 @@ VxCoreError BundledFolderManager::SetChildrenOrder(const std::string &folder_pat
       reordered.push_back(*rec);
     }
     config->files = std::move(reordered);
+    config->InvalidateFileIndex();
   }
   config->modified_utc = GetCurrentTimestampMillis();
 
@@ -1,21 +1,43 @@
 #ifndef VXCORE_BUNDLED_FOLDER_MANAGER_H
 #define VXCORE_BUNDLED_FOLDER_MANAGER_H
 
+#include <chrono>
 #include <filesystem>
-#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <unordered_map>
 
 #include "folder.h"
+#include "folder_config_cache.h"
+#include "folder_config_snapshot.h"
 #include "folder_manager.h"
+#include "metadata_store.h"
 #include "vxcore/vxcore_types.h"
 
 namespace vxcore {
 
 class Notebook;
+class WorkQueue;
 
 class BundledFolderManager : public FolderManager {
  public:
+  // Coalesces the config saves made while alive: a folder saved several
+  // times is written once, when the outermost scope ends (with write-behind
+  // enabled, once its pending writes are due). Scopes nest.
+  class ConfigWriteScope {
+   public:
+    explicit ConfigWriteScope(BundledFolderManager &manager);
+    ~ConfigWriteScope();
+
+    ConfigWriteScope(const ConfigWriteScope &) = delete;
+    ConfigWriteScope &operator=(const ConfigWriteScope &) = delete;
+
+   private:
+    BundledFolderManager &manager_;
+  };
+
   explicit BundledFolderManager(Notebook *notebook);
   ~BundledFolderManager() override;
 
@@ -107,6 +129,24 @@ class BundledFolderManager : public FolderManager {
 
   void ClearCache() override;
 
+  VxCoreError GetConfigCacheStats(FolderConfigCacheStats &out_stats) override;
+
+  VxCoreError SetConfigCacheBudget(size_t budget_bytes) override;
+
+  void SetConfigWriteBehind(const WriteBehindOptions &options) override;
+
+  bool HasPendingConfigWrites() const override;
+
+  VxCoreError FlushConfigWrites(bool only_if_due = false) override;
+
+  // Keeps every config the batch touches loaded, writes each changed config
+  // once and applies the store writes in one transaction.
+  VxCoreError ApplyNodeOps(const std::vector<NodeOp> &ops,
+                           std::vector<VxCoreError> &out_results) override;
+
+  // Writes pending configs and saves the folder config snapshot.
+  void Close() override;
+
   VxCoreError IndexNode(const std::string &node_path) override;
 
   VxCoreError UnindexNode(const std::string &node_path) override;
@@ -116,8 +156,29 @@ class BundledFolderManager : public FolderManager {
 
   // Syncs the MetadataStore from config files (vx.json)
   // Called on notebook open to rebuild cache from ground truth
+  // Folders are visited breadth-first. With |parse_queue|, config files are
+  // parsed on it (at most kRebuildParseWindow ahead of the writer) while the
+  // calling thread help-drains and streams records into the store; without
+  // it, everything runs on the calling thread.
   // Returns VXCORE_OK on success
-  VxCoreError SyncMetadataStoreFromConfigs();
+  VxCoreError SyncMetadataStoreFromConfigs(WorkQueue *parse_queue = nullptr);
+
+  // Max configs parsed ahead of the store writer during a rebuild.
+  static constexpr size_t kRebuildParseWindow = 64;
+
+  // Brings the MetadataStore in line with the config files without dropping
+  // it. Folders whose vx.json stat values (mtime, size) match their stamp
+  // are skipped unread; the rest are re-read, and those whose content hash
+  // differs are re-parsed and diff-applied (folder row, files, tags). Store
+  // folders no longer reachable from the root config are deleted. Cached
+  // configs of changed folders are replaced.
+  // With |skip_if_unstamped|, does nothing when no folder has ever been
+  // stamped (a lazily-synced store would otherwise be re-read in full).
+  // |out_changed_folders| and |out_removed_folders| (optional) receive the
+  // number of folders applied and deleted.
+  VxCoreError ReconcileMetadataStore(bool skip_if_unstamped = false,
+                                     int *out_changed_folders = nullptr,
+                                     int *out_removed_folders = nullptr);
 
   // Collects EVERY node id (folder AND file, root folder included) by walking
   // the on-disk vx.json tree. NEVER consults the MetadataStore: bundled
@@ -131,6 +192,19 @@ class BundledFolderManager : public FolderManager {
   VxCoreError AttachImportedFolder(const std::string &dest_folder_path, const std::string &name,
                                    const std::string &staging_dir, std::string &out_folder_id);
 
+  // Opens the folder config snapshot left in the local data folder by the
+  // last session: from then on, folders whose vx.json is unchanged since are
+  // loaded from it instead of being parsed. Called on notebook open.
+  void LoadConfigSnapshot();
+
+  // Writes the folder config snapshot: the configs loaded from JSON or saved
+  // in this session, plus the records of the previous snapshot that are
+  // still valid. Configs whose vx.json changed behind our back are left out.
+  // Called after a rebuild and on close.
+  void SaveConfigSnapshot();
+
+  static constexpr const char *kConfigSnapshotFileName = "folder_configs.snapshot";
+
   // Replays or rolls back incomplete import journals left by a crash.
   // Called on notebook open BEFORE SyncMetadataStoreFromConfigs().
   VxCoreError RecoverImports(int *out_recovered_count);
@@ -145,20 +219,44 @@ class BundledFolderManager : public FolderManager {
   bool NodeContentExistsOnDisk(const std::string &relative_path, bool is_folder) const override;
 
  private:
+  // A vx.json file's identity for change detection (see
+  // MetadataStore::SetFolderConfigStamp).
+  using ConfigFileStamp = FolderConfigSnapshot::Stamp;
+
   VxCoreError GetFolderConfig(const std::string &folder_path, FolderConfig **out_config,
                               const std::string *parent_id = nullptr);
+  // |out_stamp|, if given, receives the stamp of the bytes that were parsed.
+  // Served from the config snapshot when the vx.json stat values match it.
+  // Thread-safe as long as the snapshot is not reopened meanwhile.
   VxCoreError LoadFolderConfig(const std::string &folder_path,
-                               std::unique_ptr<FolderConfig> &out_config);
+                               std::unique_ptr<FolderConfig> &out_config,
+                               ConfigFileStamp *out_stamp = nullptr);
+  // Fills mtime_utc and size only; the hash needs the content.
+  VxCoreError StatFolderConfig(const std::string &folder_path, ConfigFileStamp &out_stamp) const;
+  // Saving the config cached for |folder_path| inside a ConfigWriteScope, or
+  // with write-behind enabled, only marks it pending (see FlushConfigWrites);
+  // any other config is written right away, superseding a pending write.
   VxCoreError SaveFolderConfig(const std::string &folder_path, const FolderConfig &config);
 
-  // Crash-safe variant of SaveFolderConfig: writes <vx.json>.tmp, flushes it to
-  // stable storage, then renames it over the live file. Used by the import
-  // commit point, where a truncated-then-interrupted in-place rewrite (what
-  // SaveFolderConfig does) would destroy the destination parent's index.
+  // Writes <vx.json>.tmp, flushes it to stable storage, then renames it over
+  // the live file, so a crash never leaves a truncated vx.json behind. Every
+  // config write goes through here.
   VxCoreError SaveFolderConfigAtomic(const std::string &folder_path, const FolderConfig &config);
 
+  bool IsConfigWriteDue() const;
+  // Writes the pending config of |folder_path| now, if any.
+  VxCoreError FlushConfigWrite(const std::string &folder_path);
+  // Forgets the pending write of |folder_path|, if any.
+  void DropPendingConfigWrite(const std::string &folder_path);
+
 
   std::string GetConfigPath(const std::string &folder_path) const;
+
+  std::string GetConfigSnapshotPath() const;
+  // Queues |config|, as read from or written to a vx.json with |stamp|, for
+  // the next SaveConfigSnapshot(). Thread-safe.
+  void StashSnapshotRecord(const std::string &folder_path, const ConfigFileStamp &stamp,
+                           const FolderConfig &config);
   std::string GetContentPath(const std::string &folder_path) const;
 
   void CacheConfig(const std::string &folder_path, std::unique_ptr<FolderConfig> config);
@@ -172,6 +270,11 @@ class BundledFolderManager : public FolderManager {
   void SyncFolderToStore(const std::string &folder_path, const FolderConfig &config,
                          const std::string &parent_folder_id);
 
+  // Upserts |config|'s folder row under |parent_folder_id| (moving it there
+  // if needed) and diff-applies its files. Used by reconciliation.
+  bool ApplyFolderConfigToStore(MetadataStore *store, const FolderConfig &config,
+                                const std::string &parent_folder_id);
+
   // Get the parent folder's ID (UUID) for a given folder path
   std::string GetParentFolderId(const std::string &folder_path);
 
@@ -193,7 +296,27 @@ class BundledFolderManager : public FolderManager {
   std::string GenerateUniqueFileName(const std::string &folder_abs_path,
                                      const std::string &desired_name) const;
   VxCoreError MoveToRecycleBin(const std::filesystem::path &source_path);
-  std::map<std::string, std::unique_ptr<FolderConfig>> config_cache_;
+
+  // Parsed vx.json files by folder path. Public entry points open a
+  // FolderConfigCache::Scope, so the configs they work on stay put until
+  // they return; the cache is trimmed to its budget as scopes end.
+  FolderConfigCache config_cache_;
+
+  // Snapshot of the last session's configs, see LoadConfigSnapshot().
+  FolderConfigSnapshot config_snapshot_;
+  // Encoded configs loaded from JSON or saved since the snapshot was last
+  // written, by folder path. Guarded by snapshot_records_mutex_.
+  std::unordered_map<std::string, FolderConfigSnapshot::Record> snapshot_records_;
+  std::mutex snapshot_records_mutex_;
+
+  // Folders whose cached config was saved but not written yet; each is held
+  // in config_cache_ until written.
+  std::set<std::string> pending_config_writes_;
+  // Saves since the pending writes began, and when they began.
+  size_t pending_config_saves_ = 0;
+  std::chrono::steady_clock::time_point pending_config_since_;
+  WriteBehindOptions config_write_behind_;
+  int config_write_scopes_ = 0;
 };
 
 }  // namespace vxcore
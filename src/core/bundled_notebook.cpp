@@ -127,6 +127,13 @@ VxCoreError BundledNotebook::Open(const std::string &local_data_folder,
     // Continue anyway - tags will be synced on next open or RebuildCache
   }
 
+  // Folders whose vx.json is unchanged since the last session load from the
+  // snapshot it left behind instead of being parsed again.
+  if (auto *bundled_folder_manager =
+          dynamic_cast<BundledFolderManager *>(notebook->GetFolderManager())) {
+    bundled_folder_manager->LoadConfigSnapshot();
+  }
+
   // Repair any folder-import journal left behind by a crash BEFORE anything
   // reads or rebuilds the metadata store: a rolled-back import must not leave
   // rows (or an orphan tree) that a later rebuild would resurrect.
@@ -144,9 +151,22 @@ VxCoreError BundledNotebook::Open(const std::string &local_data_folder,
     }
   }
 
-  // Note: We do NOT sync folder/file MetadataStore from config files here.
+  // Note: We do NOT fully sync folder/file MetadataStore from config files here.
   // The cache uses lazy sync - data is loaded on demand when accessed.
   // Users can call RebuildCache() if they need a full refresh.
+  // A store that was rebuilt or reconciled before carries config stamps, so
+  // catching up with edits made while closed (e.g. a pull) only costs a stat
+  // per folder; an unstamped store is left to lazy sync.
+  if (auto *bundled_folder_manager =
+          dynamic_cast<BundledFolderManager *>(notebook->GetFolderManager())) {
+    const VxCoreError reconcile_err =
+        bundled_folder_manager->ReconcileMetadataStore(/*skip_if_unstamped=*/true);
+    if (reconcile_err != VXCORE_OK) {
+      VXCORE_LOG_WARN("Cache reconcile failed on open: root=%s, error=%d", root_folder.c_str(),
+                      reconcile_err);
+      // Continue anyway - lazy sync still serves reads.
+    }
+  }
 
   out_notebook = std::move(notebook);
   return VXCORE_OK;
@@ -214,8 +234,8 @@ VxCoreError BundledNotebook::UpdateConfig(const NotebookConfig &config) {
     // NotebookManager wires it via SetEventManager), so calling Emit
     // unconditionally would crash on notebook creation.
     if (event_manager_ != nullptr) {
-      event_manager_->Emit(events::kNotebookConfigChanged,
-                           {{kJsonKeyNotebookId, config_.id}});
+      event_manager_->EmitTyped(events::kNotebookConfigChanged,
+                                events::NotebookEvent{config_.id});
     }
     return VXCORE_OK;
   } catch (const nlohmann::json::exception &) {
@@ -225,13 +245,22 @@ VxCoreError BundledNotebook::UpdateConfig(const NotebookConfig &config) {
   }
 }
 
-VxCoreError BundledNotebook::RebuildCache() {
+VxCoreError BundledNotebook::RebuildCache(WorkQueue *parse_queue) {
   auto *bundled_folder_manager = dynamic_cast<BundledFolderManager *>(folder_manager_.get());
   if (!bundled_folder_manager) {
     VXCORE_LOG_ERROR("RebuildCache: folder_manager is not BundledFolderManager");
     return VXCORE_ERR_INVALID_STATE;
   }
-  return bundled_folder_manager->SyncMetadataStoreFromConfigs();
+  return bundled_folder_manager->SyncMetadataStoreFromConfigs(parse_queue);
+}
+
+VxCoreError BundledNotebook::ReconcileCache() {
+  auto *bundled_folder_manager = dynamic_cast<BundledFolderManager *>(folder_manager_.get());
+  if (!bundled_folder_manager) {
+    VXCORE_LOG_ERROR("ReconcileCache: folder_manager is not BundledFolderManager");
+    return VXCORE_ERR_INVALID_STATE;
+  }
+  return bundled_folder_manager->ReconcileMetadataStore();
 }
 
 std::string BundledNotebook::GetRecycleBinPath() const {
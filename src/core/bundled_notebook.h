@@ -17,7 +17,8 @@ class BundledNotebook : public Notebook {
                           std::unique_ptr<Notebook> &out_notebook);
 
   VxCoreError UpdateConfig(const NotebookConfig &config) override;
-  VxCoreError RebuildCache() override;
+  VxCoreError RebuildCache(WorkQueue *parse_queue = nullptr) override;
+  VxCoreError ReconcileCache() override;
 
   std::string GetRecycleBinPath() const override;
   VxCoreError EmptyRecycleBin() override;
@@ -17,6 +17,10 @@ class WorkQueueManager;
 class EventManager;
 class ActivityManager;
 
+namespace db {
+class DbMaintenanceScheduler;
+}  // namespace db
+
 struct VxCoreContext {
   // IMPORTANT: Member order determines destruction order (reverse of declaration).
   // event_manager must outlive sync_manager and notebook_manager (they subscribe to events).
@@ -36,6 +40,9 @@ struct VxCoreContext {
   // destruction): its dtor unsubscribes from event_manager, which must still
   // be alive at that point.
   std::unique_ptr<ActivityManager> activity_manager;
+  // Tracks when each open database was last checkpointed/optimized; see
+  // vxcore_db_schedule_maintenance.
+  std::unique_ptr<db::DbMaintenanceScheduler> maintenance_scheduler;
   std::string last_error;
   // App-wide locale used for locale-aware, UTF-8 output (see
   // vxcore_context_set_locale). Runtime-only: never persisted to vxcore.json.
@@ -1,46 +1,212 @@
 #include "core/event_manager.h"
 
+#include <unordered_set>
+
+#include <vxcore/notebook_json_keys.h>
+
+#include "core/event_names.h"
 #include "core/work_queue.h"
 
 namespace vxcore {
 
-EventManager::EventManager() = default;
+namespace {
+
+const std::string *StringField(const nlohmann::json &data, const char *field) {
+  auto it = data.find(field);
+  if (it == data.end() || !it->is_string()) return nullptr;
+  return &it->get_ref<const std::string &>();
+}
+
+// Identifies "the same change" for coalescing: notebook plus the path(s) the
+// event is about.
+std::string CoalesceKey(const nlohmann::json &data) {
+  if (!data.is_object()) return std::string();
+  std::string key;
+  for (const char *field : {kJsonKeyNotebookId, "path", "oldPath", "newPath"}) {
+    if (const auto *value = StringField(data, field)) key += *value;
+    key.push_back('\n');
+  }
+  return key;
+}
+
+void CollectPaths(const nlohmann::json &data, nlohmann::json &paths,
+                  std::unordered_set<std::string> &seen) {
+  if (!data.is_object()) return;
+  for (const char *field : {"path", "oldPath", "newPath"}) {
+    const auto *path = StringField(data, field);
+    if (path && seen.insert(*path).second) paths.push_back(*path);
+  }
+}
+
+}  // namespace
+
+EventManager::EventManager() : listeners_(std::make_shared<const ListenerMap>()) {}
 
 EventManager::~EventManager() = default;
 
+void EventManager::AddToMap(ListenerMap &map, const std::string &event_name,
+                            const Listener &listener) {
+  auto it = map.find(event_name);
+  auto list = it != map.end() ? std::make_shared<ListenerList>(*it->second)
+                              : std::make_shared<ListenerList>();
+  list->push_back(listener);
+  map[event_name] = std::move(list);
+}
+
+EventManager::ListenerId EventManager::AddListener(const std::string &event_name,
+                                                    Listener listener) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  listener.id = next_id_++;
+
+  auto map = std::make_shared<ListenerMap>(*std::atomic_load(&listeners_));
+  AddToMap(*map, event_name, listener);
+
+  std::atomic_store(&listeners_, std::shared_ptr<const ListenerMap>(std::move(map)));
+  return listener.id;
+}
+
 EventManager::ListenerId EventManager::Subscribe(const std::string &event_name,
                                                   EventCallback callback) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  Listener listener;
+  listener.callback = std::move(callback);
+  return AddListener(event_name, std::move(listener));
+}
+
+EventManager::ListenerId EventManager::SubscribeCoalesced(
+    const std::vector<std::string> &event_names, EventCallback callback) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
   ListenerId id = next_id_++;
-  listeners_[event_name].push_back({id, std::move(callback)});
+
+  auto map = std::make_shared<ListenerMap>(*std::atomic_load(&listeners_));
+  Listener listener;
+  listener.id = id;
+  listener.callback = std::move(callback);
+  listener.coalesce = true;
+  for (const auto &event_name : event_names) {
+    AddToMap(*map, event_name, listener);
+  }
+
+  std::atomic_store(&listeners_, std::shared_ptr<const ListenerMap>(std::move(map)));
   return id;
 }
 
 void EventManager::Unsubscribe(ListenerId id) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  for (auto &pair : listeners_) {
-    auto &vec = pair.second;
-    for (auto it = vec.begin(); it != vec.end(); ++it) {
-      if (it->id == id) {
-        vec.erase(it);
-        return;
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  auto current = std::atomic_load(&listeners_);
+  std::shared_ptr<ListenerMap> map;
+  // A coalescing listener may sit in several lists, so scan them all.
+  for (const auto &pair : *current) {
+    const auto &vec = *pair.second;
+    for (size_t i = 0; i < vec.size(); ++i) {
+      if (vec[i].id != id) continue;
+
+      if (!map) map = std::make_shared<ListenerMap>(*current);
+      if (vec.size() == 1) {
+        map->erase(pair.first);
+      } else {
+        auto list = std::make_shared<ListenerList>(vec);
+        list->erase(list->begin() + static_cast<std::ptrdiff_t>(i));
+        (*map)[pair.first] = std::move(list);
       }
+      break;
     }
   }
+  if (map) {
+    std::atomic_store(&listeners_, std::shared_ptr<const ListenerMap>(std::move(map)));
+  }
+}
+
+std::shared_ptr<const EventManager::ListenerList> EventManager::FindListeners(
+    std::string_view event_name) const {
+  auto snapshot = std::atomic_load(&listeners_);
+  auto it = snapshot->find(event_name);
+  if (it == snapshot->end()) return nullptr;
+  return it->second;
+}
+
+bool EventManager::HasListeners(std::string_view event_name) const {
+  auto list = FindListeners(event_name);
+  return list && !list->empty();
+}
+
+bool EventManager::CaptureInBatch(const std::string &event_name, const nlohmann::json &data,
+                                  const ListenerList &list) {
+  bool has_coalescing = false;
+  for (const auto &listener : list) {
+    if (listener.coalesce) {
+      has_coalescing = true;
+      break;
+    }
+  }
+  if (!has_coalescing) return false;
+
+  std::lock_guard<std::mutex> lock(batch_mutex_);
+  auto batch_it = batches_.find(std::this_thread::get_id());
+  if (batch_it == batches_.end()) return false;
+
+  Batch &batch = batch_it->second;
+  std::string index_key = event_name;
+  index_key.push_back('\n');
+  index_key += CoalesceKey(data);
+  auto [index_it, inserted] = batch.index.emplace(std::move(index_key), batch.events.size());
+  if (inserted) {
+    batch.events.push_back({event_name, data, 1});
+  } else {
+    // Last payload wins; count tells how many were folded together.
+    auto &entry = batch.events[index_it->second];
+    entry.data = data;
+    entry.count += 1;
+  }
+  return true;
 }
 
 void EventManager::Emit(const std::string &event_name, const nlohmann::json &data) {
-  std::vector<EventCallback> callbacks;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = listeners_.find(event_name);
-    if (it == listeners_.end()) return;
-    for (const auto &listener : it->second) {
-      callbacks.push_back(listener.callback);
+  // The snapshot keeps the list alive even if a callback unsubscribes.
+  auto list = FindListeners(event_name);
+  if (!list) return;
+  const bool captured =
+      open_batches_.load(std::memory_order_acquire) > 0 && CaptureInBatch(event_name, data, *list);
+  for (const auto &listener : *list) {
+    if (captured && listener.coalesce) continue;
+    listener.callback(event_name, data);
+  }
+}
+
+void EventManager::DispatchTyped(std::string_view event_name, int payload_kind,
+                                 const void *payload, PayloadToJsonFn to_json) {
+  auto list = FindListeners(event_name);
+  if (!list) return;
+
+  // JSON listeners and batches need an owning name and a JSON object; build
+  // each at most once, and only on demand.
+  std::string name_storage;
+  nlohmann::json json_storage;
+  bool materialized = false;
+  auto materialize = [&] {
+    if (materialized) return;
+    name_storage.assign(event_name.data(), event_name.size());
+    json_storage = to_json(payload);
+    materialized = true;
+  };
+
+  bool captured = false;
+  if (open_batches_.load(std::memory_order_acquire) > 0) {
+    for (const auto &listener : *list) {
+      if (!listener.coalesce) continue;
+      materialize();
+      captured = CaptureInBatch(name_storage, json_storage, *list);
+      break;
     }
   }
-  for (const auto &cb : callbacks) {
-    cb(event_name, data);
+
+  for (const auto &listener : *list) {
+    if (captured && listener.coalesce) continue;
+    if (listener.payload_kind == payload_kind && listener.typed_callback) {
+      listener.typed_callback(event_name, payload);
+    } else {
+      materialize();
+      listener.callback(name_storage, json_storage);
+    }
   }
 }
 
@@ -50,21 +216,74 @@ void EventManager::EmitAsync(const std::string &event_name, const nlohmann::json
     Emit(event_name, data);
     return;
   }
-  std::vector<EventCallback> callbacks;
+  auto list = FindListeners(event_name);
+  if (!list) return;
+  // Capture the snapshot by value so the lambda is self-contained
+  queue->Enqueue([list = std::move(list), event_name, data] {
+    for (const auto &listener : *list) {
+      listener.callback(event_name, data);
+    }
+  });
+}
+
+void EventManager::BeginBatch() {
+  std::lock_guard<std::mutex> lock(batch_mutex_);
+  Batch &batch = batches_[std::this_thread::get_id()];
+  if (batch.depth++ == 0) {
+    open_batches_.fetch_add(1, std::memory_order_acq_rel);
+  }
+}
+
+void EventManager::EndBatch() {
+  Batch finished;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = listeners_.find(event_name);
-    if (it == listeners_.end()) return;
-    for (const auto &listener : it->second) {
-      callbacks.push_back(listener.callback);
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    auto it = batches_.find(std::this_thread::get_id());
+    if (it == batches_.end()) return;
+    if (--it->second.depth > 0) return;
+    finished = std::move(it->second);
+    batches_.erase(it);
+    open_batches_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+  // Deliver outside batch_mutex_: listeners may emit or open new batches.
+  if (!finished.events.empty()) {
+    DeliverBatch(finished);
+  }
+}
+
+void EventManager::DeliverBatch(const Batch &batch) {
+  auto snapshot = std::atomic_load(&listeners_);
+
+  // Group captured events per coalescing listener, preserving first-seen order.
+  struct Delivery {
+    const Listener *listener;
+    std::vector<const BatchedEvent *> events;
+  };
+  std::vector<Delivery> deliveries;
+  std::unordered_map<ListenerId, size_t> delivery_index;
+  for (const auto &event : batch.events) {
+    auto it = snapshot->find(event.event_name);
+    if (it == snapshot->end()) continue;
+    for (const auto &listener : *it->second) {
+      if (!listener.coalesce) continue;
+      auto [idx_it, inserted] = delivery_index.emplace(listener.id, deliveries.size());
+      if (inserted) deliveries.push_back({&listener, {}});
+      deliveries[idx_it->second].events.push_back(&event);
     }
   }
-  // Capture by value so the lambda is self-contained
-  queue->Enqueue([callbacks = std::move(callbacks), event_name, data] {
-    for (const auto &cb : callbacks) {
-      cb(event_name, data);
+
+  for (const auto &delivery : deliveries) {
+    nlohmann::json events_json = nlohmann::json::array();
+    nlohmann::json paths = nlohmann::json::array();
+    std::unordered_set<std::string> seen_paths;
+    for (const auto *event : delivery.events) {
+      events_json.push_back(
+          {{"event", event->event_name}, {"data", event->data}, {"count", event->count}});
+      CollectPaths(event->data, paths, seen_paths);
     }
-  });
+    delivery.listener->callback(events::kEventsBatched,
+                                {{"events", std::move(events_json)}, {"paths", std::move(paths)}});
+  }
 }
 
 }  // namespace vxcore
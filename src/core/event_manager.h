@@ -1,9 +1,14 @@
 #ifndef VXCORE_EVENT_MANAGER_H
 #define VXCORE_EVENT_MANAGER_H
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <map>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -17,6 +22,32 @@ class WorkQueue;
 
 using EventCallback = std::function<void(const std::string &event_name, const nlohmann::json &data)>;
 
+// Callback for the typed channel; Payload is one of the structs in
+// event_names.h. Both arguments are valid only for the duration of the call.
+template <typename Payload>
+using TypedEventCallback = std::function<void(std::string_view event_name, const Payload &payload)>;
+
+// Listener lists are published as immutable snapshots (read-copy-update).
+// Subscribe/Unsubscribe serialize on write_mutex_, copy the affected list,
+// and atomically swap in a new map; Emit/HasListeners only atomically load
+// the current snapshot, so dispatch takes no lock and copies no callbacks.
+// A listener unsubscribed during an in-flight Emit may still be invoked
+// once by that Emit (it holds the older snapshot).
+//
+// Batching: BeginBatch/EndBatch bracket a bulk operation on the calling
+// thread. Plain listeners keep receiving every event immediately (sync
+// dirty-tracking and activity counters depend on that). Coalescing
+// listeners, registered via SubscribeCoalesced, are held back instead:
+// captured events are coalesced by (event name, notebook id, path) and the
+// listener gets ONE events.batched notification when the outermost scope on
+// that thread closes. Outside a batch, coalescing listeners behave like
+// plain ones.
+//
+// Typed channel: SubscribeTyped/EmitTyped carry the payload structs from
+// event_names.h. EmitTyped builds the JSON object (and the std::string event
+// name) only if a JSON listener or an open coalescing batch needs it, so an
+// emit whose listeners are all typed performs no heap allocation. Typed and
+// JSON emits reach both kinds of listener.
 class EventManager {
  public:
   VXCORE_API EventManager();
@@ -29,22 +60,123 @@ class EventManager {
 
   VXCORE_API ListenerId Subscribe(const std::string &event_name, EventCallback callback);
 
+  // Register ONE coalescing listener for several event names. Returns a
+  // single id; Unsubscribe(id) removes it from every name.
+  VXCORE_API ListenerId SubscribeCoalesced(const std::vector<std::string> &event_names,
+                                           EventCallback callback);
+
+  template <typename Payload>
+  ListenerId SubscribeTyped(const std::string &event_name, TypedEventCallback<Payload> callback) {
+    auto shared = std::make_shared<TypedEventCallback<Payload>>(std::move(callback));
+    Listener listener;
+    listener.payload_kind = static_cast<int>(Payload::kKind);
+    listener.typed_callback = [shared](std::string_view name, const void *payload) {
+      (*shared)(name, *static_cast<const Payload *>(payload));
+    };
+    listener.callback = [shared](const std::string &name, const nlohmann::json &data) {
+      (*shared)(name, Payload::FromJson(data));
+    };
+    return AddListener(event_name, std::move(listener));
+  }
+
   VXCORE_API void Unsubscribe(ListenerId id);
 
+  // Cheap check emitters use to skip payload construction when nobody listens.
+  VXCORE_API bool HasListeners(std::string_view event_name) const;
+
   VXCORE_API void Emit(const std::string &event_name, const nlohmann::json &data);
 
+  template <typename Payload>
+  void EmitTyped(std::string_view event_name, const Payload &payload) {
+    DispatchTyped(event_name, static_cast<int>(Payload::kKind), &payload,
+                  [](const void *p) { return static_cast<const Payload *>(p)->ToJson(); });
+  }
+
   VXCORE_API void EmitAsync(const std::string &event_name, const nlohmann::json &data,
                             WorkQueue *queue);
 
+  // Scopes nest per thread; only the outermost EndBatch delivers.
+  VXCORE_API void BeginBatch();
+
+  VXCORE_API void EndBatch();
+
  private:
   struct Listener {
-    ListenerId id;
+    ListenerId id = 0;
+    // JSON entry point. For typed listeners this adapts via Payload::FromJson.
     EventCallback callback;
+    // Set for typed listeners only; receives a const Payload * of payload_kind.
+    std::function<void(std::string_view, const void *)> typed_callback;
+    int payload_kind = -1;
+    bool coalesce = false;
   };
 
-  mutable std::mutex mutex_;
-  std::unordered_map<std::string, std::vector<Listener>> listeners_;
+  using PayloadToJsonFn = nlohmann::json (*)(const void *payload);
+
+  struct BatchedEvent {
+    std::string event_name;
+    nlohmann::json data;
+    int count = 0;
+  };
+
+  struct Batch {
+    int depth = 0;
+    std::vector<BatchedEvent> events;
+    // (event name + coalesce key) -> index into events.
+    std::unordered_map<std::string, size_t> index;
+  };
+
+  using ListenerList = std::vector<Listener>;
+  // Transparent comparator so lookups by string_view need no std::string.
+  using ListenerMap = std::map<std::string, std::shared_ptr<const ListenerList>, std::less<>>;
+
+  // Exported because the inline templates above call them from client TUs.
+  VXCORE_API ListenerId AddListener(const std::string &event_name, Listener listener);
+
+  VXCORE_API void DispatchTyped(std::string_view event_name, int payload_kind, const void *payload,
+                                PayloadToJsonFn to_json);
+
+  std::shared_ptr<const ListenerList> FindListeners(std::string_view event_name) const;
+
+  // Copy-on-write append into a map that is about to be published.
+  static void AddToMap(ListenerMap &map, const std::string &event_name, const Listener &listener);
+
+  // Returns true when the event was captured by a batch open on this thread;
+  // coalescing listeners must then be skipped by the caller.
+  bool CaptureInBatch(const std::string &event_name, const nlohmann::json &data,
+                      const ListenerList &list);
+
+  void DeliverBatch(const Batch &batch);
+
+  // Serializes writers only; readers never take it.
+  std::mutex write_mutex_;
+  // Accessed through std::atomic_load/std::atomic_store only.
+  std::shared_ptr<const ListenerMap> listeners_;
   ListenerId next_id_ = 1;
+
+  // Fast-path gate so Emit only touches batch_mutex_ while a batch is open.
+  std::atomic<int> open_batches_{0};
+  std::mutex batch_mutex_;
+  std::unordered_map<std::thread::id, Batch> batches_;
+};
+
+// RAII helper for EventManager::BeginBatch/EndBatch. Null-safe so callers
+// with an optional EventManager need no extra branch.
+class EventBatchScope {
+ public:
+  explicit EventBatchScope(EventManager *event_manager) : event_manager_(event_manager) {
+    if (event_manager_) event_manager_->BeginBatch();
+  }
+
+  ~EventBatchScope() {
+    if (event_manager_) event_manager_->EndBatch();
+  }
+
+  EventBatchScope(const EventBatchScope &) = delete;
+  EventBatchScope &operator=(const EventBatchScope &) = delete;
+
+ private:
+  EventManager *event_manager_ = nullptr;
 };
 
 }  // namespace vxcore
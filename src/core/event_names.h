@@ -1,6 +1,12 @@
 #ifndef VXCORE_EVENT_NAMES_H
 #define VXCORE_EVENT_NAMES_H
 
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include "vxcore/notebook_json_keys.h"
+
 namespace vxcore {
 namespace events {
 
@@ -130,6 +136,108 @@ constexpr const char *kFileAttachmentsReplaced = "file.attachments_replaced";
 //   sub-array was reordered in this call.
 constexpr const char *kFolderChildrenReordered = "folder.children_reordered";
 
+// events.batched: delivered by EventManager::EndBatch to listeners registered
+//   through SubscribeCoalesced (C API: vxcore_on_events_coalesced) when the
+//   outermost batch scope on the emitting thread closes. Bulk operations
+//   (CopyFolder, MoveFolder, ImportFolder, vxcore_event_batch_begin/end)
+//   open such a scope. Events are coalesced by (event, notebookId, path,
+//   oldPath, newPath); the last payload wins and count records how many were
+//   folded together. Plain listeners still see every underlying event
+//   immediately; only coalescing listeners are held back.
+//   Payload: {"events": [{"event": "<name>", "data": {...}, "count": <n>}, ...],
+//             "paths": ["<rel-path>", ...]}
+//   paths is the de-duplicated union of path/oldPath/newPath across events.
+constexpr const char *kEventsBatched = "events.batched";
+
+// ============ Typed payloads ============
+//
+// Internal C++ subscribers use EventManager::SubscribeTyped/EmitTyped with
+// the structs below instead of parsing fields back out of JSON. Fields are
+// views borrowed from the emitter and are valid ONLY for the synchronous
+// dispatch; copy whatever a listener keeps. JSON is materialized (ToJson)
+// only when a JSON listener (C API, tests) or an open coalescing batch needs
+// it. FromJson lets typed listeners still receive events emitted as JSON;
+// its views point into the JSON object.
+
+enum class PayloadKind { kNode, kNodeMoved, kFileTag, kNotebook };
+
+namespace detail {
+inline std::string_view JsonStringView(const nlohmann::json &data, const char *key) {
+  if (!data.is_object()) return {};
+  auto it = data.find(key);
+  if (it == data.end() || !it->is_string()) return {};
+  return it->get_ref<const std::string &>();
+}
+}  // namespace detail
+
+// file.created, file.saved, file.deleted, file.metadata_updated,
+// folder.created, folder.deleted, folder.config_changed,
+// folder.metadata_updated.
+struct NodeEvent {
+  static constexpr PayloadKind kKind = PayloadKind::kNode;
+  std::string_view notebook_id;
+  std::string_view path;
+
+  nlohmann::json ToJson() const {
+    return {{kJsonKeyNotebookId, std::string(notebook_id)}, {"path", std::string(path)}};
+  }
+
+  static NodeEvent FromJson(const nlohmann::json &data) {
+    return {detail::JsonStringView(data, kJsonKeyNotebookId), detail::JsonStringView(data, "path")};
+  }
+};
+
+// file.moved (rename and move).
+struct NodeMovedEvent {
+  static constexpr PayloadKind kKind = PayloadKind::kNodeMoved;
+  std::string_view notebook_id;
+  std::string_view old_path;
+  std::string_view new_path;
+
+  nlohmann::json ToJson() const {
+    return {{kJsonKeyNotebookId, std::string(notebook_id)},
+            {"oldPath", std::string(old_path)},
+            {"newPath", std::string(new_path)}};
+  }
+
+  static NodeMovedEvent FromJson(const nlohmann::json &data) {
+    return {detail::JsonStringView(data, kJsonKeyNotebookId),
+            detail::JsonStringView(data, "oldPath"), detail::JsonStringView(data, "newPath")};
+  }
+};
+
+// file.tagged, file.untagged.
+struct FileTagEvent {
+  static constexpr PayloadKind kKind = PayloadKind::kFileTag;
+  std::string_view notebook_id;
+  std::string_view path;
+  std::string_view tag;
+
+  nlohmann::json ToJson() const {
+    return {{kJsonKeyNotebookId, std::string(notebook_id)},
+            {"path", std::string(path)},
+            {"tag", std::string(tag)}};
+  }
+
+  static FileTagEvent FromJson(const nlohmann::json &data) {
+    return {detail::JsonStringView(data, kJsonKeyNotebookId), detail::JsonStringView(data, "path"),
+            detail::JsonStringView(data, "tag")};
+  }
+};
+
+// notebook.opened, notebook.closed, notebook.config_changed, sync.started,
+// sync.should_run.
+struct NotebookEvent {
+  static constexpr PayloadKind kKind = PayloadKind::kNotebook;
+  std::string_view notebook_id;
+
+  nlohmann::json ToJson() const { return {{kJsonKeyNotebookId, std::string(notebook_id)}}; }
+
+  static NotebookEvent FromJson(const nlohmann::json &data) {
+    return {detail::JsonStringView(data, kJsonKeyNotebookId)};
+  }
+};
+
 }  // namespace events
 }  // namespace vxcore
 
@@ -152,4 +152,127 @@ nlohmann::json FolderConfig::ToJsonWithType() const {
   return json;
 }
 
+int FolderConfig::FindFileIndex(const std::string &name) const {
+  return FindIndexed(false, name);
+}
+
+int FolderConfig::FindFileIndexById(const std::string &id) const { return FindIndexed(true, id); }
+
+FileRecord *FolderConfig::FindFile(const std::string &name) {
+  const int index = FindFileIndex(name);
+  return index < 0 ? nullptr : &files[index];
+}
+
+const FileRecord *FolderConfig::FindFile(const std::string &name) const {
+  const int index = FindFileIndex(name);
+  return index < 0 ? nullptr : &files[index];
+}
+
+FileRecord &FolderConfig::AddFile(FileRecord file) {
+  const bool in_step = file_index_size_ == files.size();
+  files.push_back(std::move(file));
+  if (in_step) {
+    const size_t index = files.size() - 1;
+    file_name_index_.emplace(files[index].name, index);
+    file_id_index_.emplace(files[index].id, index);
+    file_index_size_ = files.size();
+  }
+  return files.back();
+}
+
+void FolderConfig::RemoveFile(size_t index) {
+  bool in_step = file_index_size_ == files.size();
+  if (in_step) {
+    // Duplicate names or ids map to their first file; let a rebuild sort
+    // those out.
+    auto name_it = file_name_index_.find(files[index].name);
+    auto id_it = file_id_index_.find(files[index].id);
+    in_step = name_it != file_name_index_.end() && name_it->second == index &&
+              id_it != file_id_index_.end() && id_it->second == index;
+    if (in_step) {
+      file_name_index_.erase(name_it);
+      file_id_index_.erase(id_it);
+    }
+  }
+  files.erase(files.begin() + static_cast<std::ptrdiff_t>(index));
+  if (!in_step) {
+    InvalidateFileIndex();
+    return;
+  }
+  // Shifting the later positions in place is far cheaper than rehashing
+  // every name on the next lookup, which matters when a selection is moved
+  // or deleted one file after another.
+  for (auto *file_index : {&file_name_index_, &file_id_index_}) {
+    for (auto &entry : *file_index) {
+      if (entry.second > index) {
+        --entry.second;
+      }
+    }
+  }
+  file_index_size_ = files.size();
+}
+
+void FolderConfig::RenameFile(size_t index, const std::string &new_name) {
+  FileRecord &file = files[index];
+  if (file_index_size_ == files.size()) {
+    file_name_index_.erase(file.name);
+    file_name_index_.emplace(new_name, index);
+  }
+  file.name = new_name;
+}
+
+void FolderConfig::InvalidateFileIndex() { file_index_size_ = kNoFileIndex; }
+
+bool FolderConfig::EnsureFileIndex() const {
+  if (files.size() < kFileIndexMinFiles) {
+    if (!file_name_index_.empty()) {
+      file_name_index_.clear();
+      file_id_index_.clear();
+      file_index_size_ = kNoFileIndex;
+    }
+    return false;
+  }
+  if (file_index_size_ == files.size()) {
+    return true;
+  }
+  file_name_index_.clear();
+  file_id_index_.clear();
+  file_name_index_.reserve(files.size());
+  file_id_index_.reserve(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    file_name_index_.emplace(files[i].name, i);
+    file_id_index_.emplace(files[i].id, i);
+  }
+  file_index_size_ = files.size();
+  return true;
+}
+
+int FolderConfig::FindIndexed(bool by_id, const std::string &key) const {
+  auto key_of = [by_id](const FileRecord &file) -> const std::string & {
+    return by_id ? file.id : file.name;
+  };
+
+  // A hit is checked against |files| and a stale one triggers a rebuild. A
+  // miss is trusted: a file renamed or re-id'd behind the maps' back is not
+  // found under its new key until InvalidateFileIndex() (see folder.h).
+  for (int attempt = 0; attempt < 2 && EnsureFileIndex(); ++attempt) {
+    const auto &index = by_id ? file_id_index_ : file_name_index_;
+    auto it = index.find(key);
+    if (it == index.end()) {
+      return -1;
+    }
+    if (it->second < files.size() && key_of(files[it->second]) == key) {
+      return static_cast<int>(it->second);
+    }
+    file_index_size_ = kNoFileIndex;
+  }
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (key_of(files[i]) == key) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
 }  // namespace vxcore
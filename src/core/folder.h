@@ -1,8 +1,10 @@
 #ifndef VXCORE_FOLDER_H
 #define VXCORE_FOLDER_H
 
+#include <cstddef>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace vxcore {
@@ -54,6 +56,40 @@ struct FolderConfig {
   static FolderConfig FromJson(const nlohmann::json &json);
   nlohmann::json ToJson() const;
   nlohmann::json ToJsonWithType() const;
+
+  // File lookups. Folders with at least kFileIndexMinFiles files answer them
+  // from name and id hash maps, built on first use and kept in step by the
+  // mutators below. Code that renames, re-ids or reorders |files| directly
+  // must call InvalidateFileIndex() afterwards; appends and removals made
+  // directly are caught by a size check.
+  // NOT thread-safe, not even for concurrent lookups.
+  static constexpr size_t kFileIndexMinFiles = 32;
+
+  // Position in |files| of the file named |name| (or with id |id|), or -1.
+  int FindFileIndex(const std::string &name) const;
+  int FindFileIndexById(const std::string &id) const;
+
+  FileRecord *FindFile(const std::string &name);
+  const FileRecord *FindFile(const std::string &name) const;
+
+  FileRecord &AddFile(FileRecord file);
+  void RemoveFile(size_t index);
+  void RenameFile(size_t index, const std::string &new_name);
+
+  void InvalidateFileIndex();
+
+ private:
+  static constexpr size_t kNoFileIndex = static_cast<size_t>(-1);
+
+  // Builds the maps unless they cover |files| already. Returns false for
+  // folders too small to index.
+  bool EnsureFileIndex() const;
+  int FindIndexed(bool by_id, const std::string &key) const;
+
+  mutable std::unordered_map<std::string, size_t> file_name_index_;
+  mutable std::unordered_map<std::string, size_t> file_id_index_;
+  // files.size() when the maps were last in step, or kNoFileIndex.
+  mutable size_t file_index_size_ = kNoFileIndex;
 };
 
 }  // namespace vxcore
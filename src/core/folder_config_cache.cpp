@@ -0,0 +1,238 @@
+#include "folder_config_cache.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace vxcore {
+
+namespace {
+
+// Per-element bookkeeping of node-based containers (map/list nodes).
+constexpr size_t kNodeOverhead = 4 * sizeof(void *);
+
+size_t StringBytes(const std::string &str) { return sizeof(std::string) + str.capacity(); }
+
+size_t StringsBytes(const std::vector<std::string> &strs) {
+  size_t bytes = sizeof(strs);
+  for (const auto &str : strs) {
+    bytes += StringBytes(str);
+  }
+  return bytes;
+}
+
+size_t JsonBytes(const nlohmann::json &json) {
+  size_t bytes = sizeof(nlohmann::json);
+  switch (json.type()) {
+    case nlohmann::json::value_t::object:
+      bytes += sizeof(nlohmann::json::object_t);
+      for (auto it = json.begin(); it != json.end(); ++it) {
+        bytes += kNodeOverhead + StringBytes(it.key()) + JsonBytes(it.value());
+      }
+      break;
+    case nlohmann::json::value_t::array:
+      bytes += sizeof(nlohmann::json::array_t);
+      for (const auto &element : json) {
+        bytes += JsonBytes(element);
+      }
+      break;
+    case nlohmann::json::value_t::string:
+      bytes += StringBytes(json.get_ref<const std::string &>());
+      break;
+    default:
+      break;
+  }
+  return bytes;
+}
+
+}  // namespace
+
+FolderConfigCache::Scope::Scope(FolderConfigCache &cache)
+    : cache_(cache), mark_(cache.scope_pins_.size()) {
+  cache_.scope_ids_.push_back(cache_.next_scope_id_++);
+}
+
+FolderConfigCache::Scope::~Scope() { cache_.EndScope(mark_); }
+
+FolderConfigCache::FolderConfigCache(size_t budget_bytes) : budget_bytes_(budget_bytes) {}
+
+size_t FolderConfigCache::EstimateBytes(const FolderConfig &config) {
+  size_t bytes = sizeof(FolderConfig) + StringBytes(config.id) + StringBytes(config.name) +
+                 JsonBytes(config.metadata) + StringsBytes(config.folders);
+  bytes += config.files.capacity() * sizeof(FileRecord);
+  for (const auto &file : config.files) {
+    bytes += StringBytes(file.id) + StringBytes(file.name) + JsonBytes(file.metadata) +
+             StringsBytes(file.tags) + StringsBytes(file.attachments);
+  }
+  // The name and id maps lookups build on a folder this large: a node with a
+  // copy of the key and a bucket slot per file, in each map. Counted whether
+  // or not they are built yet, so a lookup does not outgrow the estimate.
+  if (config.files.size() >= FolderConfig::kFileIndexMinFiles) {
+    constexpr size_t kIndexEntryOverhead = kNodeOverhead + sizeof(size_t) + sizeof(void *);
+    for (const auto &file : config.files) {
+      bytes += 2 * kIndexEntryOverhead + StringBytes(file.id) + StringBytes(file.name);
+    }
+  }
+  return bytes;
+}
+
+FolderConfig *FolderConfigCache::Get(const std::string &folder_path) {
+  auto it = entries_.find(folder_path);
+  if (it == entries_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  Touch(it->second);
+  PinInScope(folder_path);
+  return it->second.config.get();
+}
+
+bool FolderConfigCache::Contains(const std::string &folder_path) const {
+  return entries_.count(folder_path) > 0;
+}
+
+void FolderConfigCache::Touch(const std::string &folder_path) {
+  auto it = entries_.find(folder_path);
+  if (it != entries_.end()) {
+    Touch(it->second);
+  }
+}
+
+FolderConfig *FolderConfigCache::Put(const std::string &folder_path,
+                                     std::unique_ptr<FolderConfig> config) {
+  auto it = entries_.find(folder_path);
+  if (it == entries_.end()) {
+    lru_.push_front(folder_path);
+    it = entries_.emplace(folder_path, Entry{}).first;
+    it->second.lru_it = lru_.begin();
+  } else {
+    bytes_ -= it->second.bytes;
+    Touch(it->second);
+  }
+  Entry &entry = it->second;
+  entry.config = std::move(config);
+  entry.bytes = EstimateBytes(*entry.config);
+  bytes_ += entry.bytes;
+  peak_bytes_ = std::max(peak_bytes_, bytes_);
+  PinInScope(folder_path);
+  return entry.config.get();
+}
+
+void FolderConfigCache::Refresh(const std::string &folder_path) {
+  auto it = entries_.find(folder_path);
+  if (it == entries_.end()) {
+    return;
+  }
+  bytes_ -= it->second.bytes;
+  it->second.bytes = EstimateBytes(*it->second.config);
+  bytes_ += it->second.bytes;
+  peak_bytes_ = std::max(peak_bytes_, bytes_);
+}
+
+FolderConfig *FolderConfigCache::Peek(const std::string &folder_path) const {
+  auto it = entries_.find(folder_path);
+  return it == entries_.end() ? nullptr : it->second.config.get();
+}
+
+void FolderConfigCache::Hold(const std::string &folder_path) { ++pins_[folder_path].count; }
+
+void FolderConfigCache::Release(const std::string &folder_path) {
+  auto it = pins_.find(folder_path);
+  if (it != pins_.end() && --it->second.count <= 0) {
+    pins_.erase(it);
+  }
+}
+
+void FolderConfigCache::Erase(const std::string &folder_path) {
+  auto it = entries_.find(folder_path);
+  if (it != entries_.end()) {
+    RemoveEntry(it);
+  }
+}
+
+void FolderConfigCache::Clear() {
+  entries_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+void FolderConfigCache::SetBudget(size_t budget_bytes) {
+  budget_bytes_ = budget_bytes;
+  if (scope_ids_.empty()) {
+    Trim();
+  }
+}
+
+void FolderConfigCache::Trim() {
+  if (budget_bytes_ == 0 || bytes_ <= budget_bytes_ || lru_.size() < 2) {
+    return;
+  }
+  // Oldest first, never the most recently used.
+  auto it = std::prev(lru_.end());
+  while (bytes_ > budget_bytes_ && it != lru_.begin()) {
+    auto victim = it--;
+    if (IsPinned(*victim)) {
+      continue;
+    }
+    RemoveEntry(entries_.find(*victim));
+    ++evictions_;
+  }
+}
+
+FolderConfigCacheStats FolderConfigCache::GetStats() const {
+  FolderConfigCacheStats stats;
+  stats.entries = entries_.size();
+  stats.bytes = bytes_;
+  stats.peak_bytes = peak_bytes_;
+  stats.budget_bytes = budget_bytes_;
+  for (const auto &pin : pins_) {
+    if (entries_.count(pin.first) > 0) {
+      ++stats.pinned;
+    }
+  }
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  return stats;
+}
+
+void FolderConfigCache::Touch(Entry &entry) {
+  lru_.splice(lru_.begin(), lru_, entry.lru_it);
+}
+
+void FolderConfigCache::PinInScope(const std::string &folder_path) {
+  if (scope_ids_.empty()) {
+    return;
+  }
+  Pin &pin = pins_[folder_path];
+  if (pin.count > 0 && pin.scope_id == scope_ids_.back()) {
+    return;
+  }
+  ++pin.count;
+  pin.scope_id = scope_ids_.back();
+  scope_pins_.push_back(folder_path);
+}
+
+void FolderConfigCache::EndScope(size_t mark) {
+  for (size_t i = mark; i < scope_pins_.size(); ++i) {
+    auto it = pins_.find(scope_pins_[i]);
+    if (it != pins_.end() && --it->second.count <= 0) {
+      pins_.erase(it);
+    }
+  }
+  scope_pins_.resize(mark);
+  scope_ids_.pop_back();
+  Trim();
+}
+
+bool FolderConfigCache::IsPinned(const std::string &folder_path) const {
+  return pins_.count(folder_path) > 0;
+}
+
+void FolderConfigCache::RemoveEntry(std::unordered_map<std::string, Entry>::iterator it) {
+  bytes_ -= it->second.bytes;
+  lru_.erase(it->second.lru_it);
+  entries_.erase(it);
+}
+
+}  // namespace vxcore
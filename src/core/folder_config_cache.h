@@ -0,0 +1,150 @@
+#ifndef VXCORE_FOLDER_CONFIG_CACHE_H
+#define VXCORE_FOLDER_CONFIG_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "folder.h"
+
+namespace vxcore {
+
+struct FolderConfigCacheStats {
+  size_t entries = 0;
+  // Estimated heap footprint of the cached configs.
+  size_t bytes = 0;
+  size_t peak_bytes = 0;
+  // 0 when unbounded.
+  size_t budget_bytes = 0;
+  // Entries that cannot be evicted right now.
+  size_t pinned = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+};
+
+// Parsed folder configs (vx.json) keyed by folder path, bounded by the
+// estimated bytes they occupy and evicted least recently used first.
+//
+// Callers hold raw FolderConfig pointers across further lookups, so nothing
+// is evicted behind their back: eviction only happens when a Scope ends, and
+// every config looked up or added while a Scope is alive stays pinned until
+// that Scope ends. The most recently used config is never evicted, so a
+// pointer into the last config handed out survives until the next lookup.
+//
+// NOT thread-safe: owned by one folder manager.
+class FolderConfigCache {
+ public:
+  static constexpr size_t kDefaultBudgetBytes = 32 * 1024 * 1024;
+
+  // Pins what the cache hands out while alive; on destruction, unpins it
+  // and trims the cache to its budget. Scopes nest.
+  class Scope {
+   public:
+    explicit Scope(FolderConfigCache &cache);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    FolderConfigCache &cache_;
+    size_t mark_;
+  };
+
+  explicit FolderConfigCache(size_t budget_bytes = kDefaultBudgetBytes);
+
+  FolderConfigCache(const FolderConfigCache &) = delete;
+  FolderConfigCache &operator=(const FolderConfigCache &) = delete;
+
+  // Returns the cached config and marks it most recently used, or null
+  // (counted as a miss).
+  FolderConfig *Get(const std::string &folder_path);
+
+  // Whether |folder_path| is cached; does not touch recency or stats.
+  bool Contains(const std::string &folder_path) const;
+
+  // The config cached for |folder_path| or null, without touching recency,
+  // pins or stats.
+  FolderConfig *Peek(const std::string &folder_path) const;
+
+  // Marks the config cached for |folder_path| most recently used.
+  void Touch(const std::string &folder_path);
+
+  // Caches |config|, replacing any config cached for |folder_path|.
+  FolderConfig *Put(const std::string &folder_path, std::unique_ptr<FolderConfig> config);
+
+  // Re-estimates the size of the config cached for |folder_path| after it
+  // was modified in place. No-op if it is not cached.
+  void Refresh(const std::string &folder_path);
+
+  void Erase(const std::string &folder_path);
+
+  // Keeps |folder_path| from being evicted until the matching Release(),
+  // whether or not a Scope is alive. Erase() and Clear() still drop it.
+  void Hold(const std::string &folder_path);
+  void Release(const std::string &folder_path);
+
+  // Drops every entry, pinned or not; pins taken by live Scopes stay and
+  // apply to configs cached again under the same path.
+  void Clear();
+
+  // 0 for unbounded. Trims right away when no Scope is alive.
+  void SetBudget(size_t budget_bytes);
+
+  // Evicts least recently used, unpinned configs until the cache fits its
+  // budget, keeping the most recently used one.
+  void Trim();
+
+  FolderConfigCacheStats GetStats() const;
+
+  // Estimated heap footprint of |config|.
+  static size_t EstimateBytes(const FolderConfig &config);
+
+ private:
+  struct Entry {
+    std::unique_ptr<FolderConfig> config;
+    size_t bytes = 0;
+    // Position in lru_.
+    std::list<std::string>::iterator lru_it;
+  };
+
+  struct Pin {
+    // Scope pins plus holds.
+    int count = 0;
+    // Innermost Scope that took the latest pin, so repeated lookups in one
+    // Scope pin once.
+    uint64_t scope_id = 0;
+  };
+
+  void Touch(Entry &entry);
+  void PinInScope(const std::string &folder_path);
+  void EndScope(size_t mark);
+  bool IsPinned(const std::string &folder_path) const;
+  void RemoveEntry(std::unordered_map<std::string, Entry>::iterator it);
+
+  std::unordered_map<std::string, Entry> entries_;
+  // Folder paths, most recently used first.
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, Pin> pins_;
+  // Paths pinned by live Scopes, innermost last.
+  std::vector<std::string> scope_pins_;
+  // Ids of live Scopes, innermost last.
+  std::vector<uint64_t> scope_ids_;
+  uint64_t next_scope_id_ = 1;
+
+  size_t budget_bytes_;
+  size_t bytes_ = 0;
+  size_t peak_bytes_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+}  // namespace vxcore
+
+#endif  // VXCORE_FOLDER_CONFIG_CACHE_H
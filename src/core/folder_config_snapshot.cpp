@@ -0,0 +1,416 @@
+#include "folder_config_snapshot.h"
+
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#include "utils/file_utils.h"
+#include "utils/logger.h"
+
+namespace vxcore {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'V', 'X', 'F', 'C', 'S', 'N', 'A', 'P'};
+constexpr size_t kHeaderSize = sizeof(kMagic) + 4 + 4 + 8 + 8;
+// Path and hash lengths, mtime, size, offset and length.
+constexpr size_t kMinIndexEntrySize = 4 + 8 + 8 + 4 + 8 + 8;
+
+class ByteWriter {
+ public:
+  explicit ByteWriter(std::string &out) : out_(out) {}
+
+  void PutU32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      out_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+  }
+
+  void PutU64(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      out_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+  }
+
+  void PutI64(int64_t value) { PutU64(static_cast<uint64_t>(value)); }
+
+  void PutString(const std::string &value) {
+    PutU32(static_cast<uint32_t>(value.size()));
+    out_.append(value);
+  }
+
+  void PutStrings(const std::vector<std::string> &values) {
+    PutU32(static_cast<uint32_t>(values.size()));
+    for (const auto &value : values) {
+      PutString(value);
+    }
+  }
+
+  // Empty objects (the common case) take 4 bytes; anything else is MessagePack.
+  void PutJson(const nlohmann::json &value) {
+    if (value.is_null() || (value.is_object() && value.empty())) {
+      PutU32(0);
+      return;
+    }
+    const auto packed = nlohmann::json::to_msgpack(value);
+    PutU32(static_cast<uint32_t>(packed.size()));
+    out_.append(reinterpret_cast<const char *>(packed.data()), packed.size());
+  }
+
+ private:
+  std::string &out_;
+};
+
+// Bounds-checked; once a read runs past the end, every later read fails too.
+class ByteReader {
+ public:
+  ByteReader(const char *data, size_t size) : data_(data), size_(size) {}
+
+  bool ok() const { return ok_; }
+  bool AtEnd() const { return pos_ == size_; }
+
+  uint32_t GetU32() {
+    uint32_t value = 0;
+    if (!Require(4)) {
+      return 0;
+    }
+    for (int i = 0; i < 4; ++i) {
+      value |= static_cast<uint32_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+    }
+    pos_ += 4;
+    return value;
+  }
+
+  uint64_t GetU64() {
+    uint64_t value = 0;
+    if (!Require(8)) {
+      return 0;
+    }
+    for (int i = 0; i < 8; ++i) {
+      value |= static_cast<uint64_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+    }
+    pos_ += 8;
+    return value;
+  }
+
+  int64_t GetI64() { return static_cast<int64_t>(GetU64()); }
+
+  std::string GetString() {
+    const uint32_t length = GetU32();
+    if (!Require(length)) {
+      return std::string();
+    }
+    std::string value(data_ + pos_, length);
+    pos_ += length;
+    return value;
+  }
+
+  std::vector<std::string> GetStrings() {
+    std::vector<std::string> values;
+    const uint32_t count = GetU32();
+    // Every string takes at least its 4-byte length.
+    if (!Require(static_cast<uint64_t>(count) * 4)) {
+      return values;
+    }
+    values.reserve(count);
+    for (uint32_t i = 0; i < count && ok_; ++i) {
+      values.push_back(GetString());
+    }
+    return values;
+  }
+
+  nlohmann::json GetJson() {
+    const uint32_t length = GetU32();
+    if (length == 0 || !Require(length)) {
+      return nlohmann::json::object();
+    }
+    const auto *begin = reinterpret_cast<const uint8_t *>(data_ + pos_);
+    pos_ += length;
+    auto value = nlohmann::json::from_msgpack(begin, begin + length, /*strict=*/true,
+                                              /*allow_exceptions=*/false);
+    if (value.is_discarded()) {
+      ok_ = false;
+      return nlohmann::json::object();
+    }
+    // Same as FolderConfig::FromJson(): metadata is always an object.
+    return value.is_object() ? value : nlohmann::json::object();
+  }
+
+ private:
+  // Whether |bytes| more bytes are left to read.
+  bool Require(uint64_t bytes) {
+    if (!ok_ || bytes > size_ - pos_) {
+      ok_ = false;
+    }
+    return ok_;
+  }
+
+  const char *data_;
+  size_t size_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+}  // namespace
+
+bool FolderConfigSnapshot::Open(const std::string &file_path) {
+  Close();
+
+  std::lock_guard<std::mutex> lock(file_mutex_);
+  file_.open(PathFromUtf8(file_path), std::ios::binary);
+  if (!file_.is_open()) {
+    return false;
+  }
+
+  auto reject = [this, &file_path](const char *reason) {
+    VXCORE_LOG_WARN("Ignoring folder config snapshot %s: %s", file_path.c_str(), reason);
+    file_.close();
+    index_.clear();
+    return false;
+  };
+
+  file_.seekg(0, std::ios::end);
+  const auto end = file_.tellg();
+  if (end < 0) {
+    return reject("unreadable");
+  }
+  const auto file_size = static_cast<uint64_t>(end);
+  if (file_size < kHeaderSize) {
+    return reject("truncated header");
+  }
+
+  std::string header(kHeaderSize, '\0');
+  file_.seekg(0);
+  if (!file_.read(&header[0], kHeaderSize)) {
+    return reject("unreadable header");
+  }
+  if (std::memcmp(header.data(), kMagic, sizeof(kMagic)) != 0) {
+    return reject("bad magic");
+  }
+  ByteReader header_reader(header.data() + sizeof(kMagic), kHeaderSize - sizeof(kMagic));
+  const uint32_t version = header_reader.GetU32();
+  const uint32_t count = header_reader.GetU32();
+  const uint64_t index_offset = header_reader.GetU64();
+  const uint64_t index_size = header_reader.GetU64();
+  if (version != kVersion) {
+    return reject("version mismatch");
+  }
+  if (index_offset < kHeaderSize || index_offset > file_size ||
+      index_size != file_size - index_offset || count > index_size / kMinIndexEntrySize) {
+    return reject("bad index bounds");
+  }
+
+  std::string index_bytes(static_cast<size_t>(index_size), '\0');
+  file_.seekg(static_cast<std::streamoff>(index_offset));
+  if (index_size > 0 && !file_.read(&index_bytes[0], static_cast<std::streamsize>(index_size))) {
+    return reject("unreadable index");
+  }
+
+  ByteReader reader(index_bytes.data(), index_bytes.size());
+  index_.reserve(count);
+  for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+    std::string folder_path = reader.GetString();
+    IndexEntry entry;
+    entry.stamp.mtime_utc = reader.GetI64();
+    entry.stamp.size = reader.GetI64();
+    entry.stamp.hash = reader.GetString();
+    entry.offset = reader.GetU64();
+    entry.length = reader.GetU64();
+    if (entry.offset < kHeaderSize || entry.offset > index_offset ||
+        entry.length > index_offset - entry.offset) {
+      return reject("record out of bounds");
+    }
+    index_[std::move(folder_path)] = std::move(entry);
+  }
+  if (!reader.ok() || !reader.AtEnd()) {
+    return reject("malformed index");
+  }
+  return true;
+}
+
+void FolderConfigSnapshot::Close() {
+  std::lock_guard<std::mutex> lock(file_mutex_);
+  if (file_.is_open()) {
+    file_.close();
+  }
+  file_.clear();
+  index_.clear();
+}
+
+size_t FolderConfigSnapshot::Size() const { return index_.size(); }
+
+bool FolderConfigSnapshot::Load(const std::string &folder_path, int64_t mtime_utc, int64_t size,
+                                std::unique_ptr<FolderConfig> &out_config,
+                                std::string *out_hash) const {
+  auto it = index_.find(folder_path);
+  if (it == index_.end() || it->second.stamp.mtime_utc != mtime_utc ||
+      it->second.stamp.size != size) {
+    return false;
+  }
+
+  std::string bytes;
+  if (!ReadBytes(it->second, bytes)) {
+    return false;
+  }
+  auto config = std::make_unique<FolderConfig>();
+  if (!Decode(bytes, *config)) {
+    VXCORE_LOG_WARN("Corrupt folder config snapshot record: %s", folder_path.c_str());
+    return false;
+  }
+  out_config = std::move(config);
+  if (out_hash) {
+    *out_hash = it->second.stamp.hash;
+  }
+  return true;
+}
+
+bool FolderConfigSnapshot::ReadRecord(const std::string &folder_path, Record &out_record) const {
+  auto it = index_.find(folder_path);
+  if (it == index_.end()) {
+    return false;
+  }
+  out_record.folder_path = folder_path;
+  out_record.stamp = it->second.stamp;
+  return ReadBytes(it->second, out_record.bytes);
+}
+
+void FolderConfigSnapshot::ForEachEntry(
+    const std::function<void(const std::string &folder_path, const Stamp &stamp)> &callback)
+    const {
+  for (const auto &entry : index_) {
+    callback(entry.first, entry.second.stamp);
+  }
+}
+
+bool FolderConfigSnapshot::ReadBytes(const IndexEntry &entry, std::string &out_bytes) const {
+  out_bytes.assign(static_cast<size_t>(entry.length), '\0');
+  if (entry.length == 0) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(file_mutex_);
+  if (!file_.is_open()) {
+    return false;
+  }
+  file_.clear();
+  file_.seekg(static_cast<std::streamoff>(entry.offset));
+  return static_cast<bool>(
+      file_.read(&out_bytes[0], static_cast<std::streamsize>(entry.length)));
+}
+
+std::string FolderConfigSnapshot::Encode(const FolderConfig &config) {
+  std::string bytes;
+  ByteWriter writer(bytes);
+  writer.PutString(config.id);
+  writer.PutString(config.name);
+  writer.PutI64(config.created_utc);
+  writer.PutI64(config.modified_utc);
+  writer.PutJson(config.metadata);
+  writer.PutStrings(config.folders);
+  writer.PutU32(static_cast<uint32_t>(config.files.size()));
+  for (const auto &file : config.files) {
+    writer.PutString(file.id);
+    writer.PutString(file.name);
+    writer.PutI64(file.created_utc);
+    writer.PutI64(file.modified_utc);
+    writer.PutJson(file.metadata);
+    writer.PutStrings(file.tags);
+    writer.PutStrings(file.attachments);
+  }
+  return bytes;
+}
+
+bool FolderConfigSnapshot::Decode(const std::string &bytes, FolderConfig &out_config) {
+  ByteReader reader(bytes.data(), bytes.size());
+  FolderConfig config;
+  config.id = reader.GetString();
+  config.name = reader.GetString();
+  config.created_utc = reader.GetI64();
+  config.modified_utc = reader.GetI64();
+  config.metadata = reader.GetJson();
+  config.folders = reader.GetStrings();
+  const uint32_t file_count = reader.GetU32();
+  // Every file record takes well over 4 bytes; bounds the reserve below.
+  if (!reader.ok() || file_count > bytes.size() / 4) {
+    return false;
+  }
+  config.files.resize(file_count);
+  for (auto &file : config.files) {
+    file.id = reader.GetString();
+    file.name = reader.GetString();
+    file.created_utc = reader.GetI64();
+    file.modified_utc = reader.GetI64();
+    file.metadata = reader.GetJson();
+    file.tags = reader.GetStrings();
+    file.attachments = reader.GetStrings();
+    if (!reader.ok()) {
+      return false;
+    }
+  }
+  if (!reader.ok() || !reader.AtEnd()) {
+    return false;
+  }
+  out_config = std::move(config);
+  return true;
+}
+
+bool FolderConfigSnapshot::Write(const std::string &file_path,
+                                 const std::vector<Record> &records) {
+  const fs::path path = PathFromUtf8(file_path);
+  fs::path tmp_path = path;
+  tmp_path += PathFromUtf8(".tmp");
+
+  std::string index;
+  ByteWriter index_writer(index);
+  uint64_t offset = kHeaderSize;
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      VXCORE_LOG_WARN("Cannot write folder config snapshot %s", PathToUtf8(tmp_path).c_str());
+      return false;
+    }
+
+    file.write(std::string(kHeaderSize, '\0').data(), kHeaderSize);
+    for (const auto &record : records) {
+      file.write(record.bytes.data(), static_cast<std::streamsize>(record.bytes.size()));
+      index_writer.PutString(record.folder_path);
+      index_writer.PutI64(record.stamp.mtime_utc);
+      index_writer.PutI64(record.stamp.size);
+      index_writer.PutString(record.stamp.hash);
+      index_writer.PutU64(offset);
+      index_writer.PutU64(record.bytes.size());
+      offset += record.bytes.size();
+    }
+    file.write(index.data(), static_cast<std::streamsize>(index.size()));
+
+    std::string header(kMagic, sizeof(kMagic));
+    ByteWriter header_writer(header);
+    header_writer.PutU32(kVersion);
+    header_writer.PutU32(static_cast<uint32_t>(records.size()));
+    header_writer.PutU64(offset);
+    header_writer.PutU64(index.size());
+    file.seekp(0);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    file.close();
+    if (file.fail()) {
+      VXCORE_LOG_WARN("Failed to write folder config snapshot %s", PathToUtf8(tmp_path).c_str());
+      std::error_code ec;
+      fs::remove(tmp_path, ec);
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  fs::rename(tmp_path, path, ec);
+  if (ec) {
+    VXCORE_LOG_WARN("Failed to publish folder config snapshot %s: %s", file_path.c_str(),
+                    ec.message().c_str());
+    fs::remove(tmp_path, ec);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace vxcore
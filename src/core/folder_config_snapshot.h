@@ -0,0 +1,103 @@
+#ifndef VXCORE_FOLDER_CONFIG_SNAPSHOT_H
+#define VXCORE_FOLDER_CONFIG_SNAPSHOT_H
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "folder.h"
+
+namespace vxcore {
+
+// Versioned binary image of a notebook's folder configs (vx.json), kept in
+// the notebook's local data folder so a warm open can skip JSON parsing for
+// folders whose vx.json has not changed since.
+//
+// Layout (integers little-endian, strings as u32 length + bytes):
+//   header  magic "VXFCSNAP", u32 version, u32 record count,
+//           u64 index offset, u64 index size
+//   records one flat encoded FolderConfig each (see Encode())
+//   index   per record: folder path, vx.json mtime and size, content hash,
+//           u64 offset, u64 length
+// Only the header and index are read on Open(); records are read by offset
+// when first asked for. A record is only handed out if the vx.json stat
+// values still match the ones it was taken at.
+class FolderConfigSnapshot {
+ public:
+  static constexpr uint32_t kVersion = 1;
+
+  // The vx.json a record was taken from. |hash| is the content hash (see
+  // HashContent()), or empty if unknown.
+  struct Stamp {
+    int64_t mtime_utc = -1;
+    int64_t size = -1;
+    std::string hash;
+  };
+
+  struct Record {
+    std::string folder_path;
+    Stamp stamp;
+    // Encoded config, see Encode().
+    std::string bytes;
+  };
+
+  FolderConfigSnapshot() = default;
+
+  FolderConfigSnapshot(const FolderConfigSnapshot &) = delete;
+  FolderConfigSnapshot &operator=(const FolderConfigSnapshot &) = delete;
+
+  // Reads the index of the snapshot at |file_path|. Returns false, leaving
+  // the snapshot empty, if it is missing, of another version or malformed.
+  bool Open(const std::string &file_path);
+
+  void Close();
+
+  // Number of indexed records.
+  size_t Size() const;
+
+  // Decodes the record of |folder_path| if it was taken from a vx.json with
+  // the given stat values; |out_hash| (optional) receives its stamp hash.
+  // Thread-safe.
+  bool Load(const std::string &folder_path, int64_t mtime_utc, int64_t size,
+            std::unique_ptr<FolderConfig> &out_config, std::string *out_hash = nullptr) const;
+
+  // Reads the record of |folder_path| without decoding it. Thread-safe.
+  bool ReadRecord(const std::string &folder_path, Record &out_record) const;
+
+  // Calls |callback| with the folder path and stamp of every indexed record.
+  void ForEachEntry(
+      const std::function<void(const std::string &folder_path, const Stamp &stamp)> &callback)
+      const;
+
+  static std::string Encode(const FolderConfig &config);
+  static bool Decode(const std::string &bytes, FolderConfig &out_config);
+
+  // Writes |records| as a snapshot to |file_path| through a temporary file
+  // renamed into place. An open snapshot of the same file must be closed
+  // first on Windows.
+  static bool Write(const std::string &file_path, const std::vector<Record> &records);
+
+ private:
+  struct IndexEntry {
+    Stamp stamp;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+  };
+
+  bool ReadBytes(const IndexEntry &entry, std::string &out_bytes) const;
+
+  std::unordered_map<std::string, IndexEntry> index_;
+
+  // Guards file_ seeks and reads.
+  mutable std::mutex file_mutex_;
+  mutable std::ifstream file_;
+};
+
+}  // namespace vxcore
+
+#endif  // VXCORE_FOLDER_CONFIG_SNAPSHOT_H
@@ -12,13 +12,21 @@ void FolderManager::EmitEvent(const char *event_name, const nlohmann::json &data
   if (event_manager_) {
     event_manager_->Emit(event_name, data);
   } else {
-    VXCORE_LOG_WARN(
-        "FolderManager::EmitEvent: event_manager_ is NULL, dropping event=%s "
-        "(notebook_id will not be marked dirty for auto-sync)",
-        event_name);
+    LogDroppedEvent(event_name);
   }
 }
 
+void FolderManager::LogDroppedEvent(const char *event_name) const {
+  VXCORE_LOG_WARN(
+      "FolderManager::EmitEvent: event_manager_ is NULL, dropping event=%s "
+      "(notebook_id will not be marked dirty for auto-sync)",
+      event_name);
+}
+
+bool FolderManager::WantsEvent(const char *event_name) const {
+  return !event_manager_ || event_manager_->HasListeners(event_name);
+}
+
 VxCoreError FolderManager::MoveToRecycleBin(const std::filesystem::path &source_path) {
   try {
     if (!std::filesystem::exists(source_path)) {
@@ -37,6 +45,34 @@ VxCoreError FolderManager::MoveToRecycleBin(const std::filesystem::path &source_
   }
 }
 
+VxCoreError FolderManager::ApplyNodeOps(const std::vector<NodeOp> &ops,
+                                        std::vector<VxCoreError> &out_results) {
+  EventBatchScope event_batch(event_manager_);
+  out_results.assign(ops.size(), VXCORE_OK);
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const NodeOp &op = ops[i];
+    if (op.kind == NodeOp::Kind::Tag) {
+      out_results[i] = TagFile(op.path, op.arg);
+      continue;
+    }
+    if (op.kind == NodeOp::Kind::Untag) {
+      out_results[i] = UntagFile(op.path, op.arg);
+      continue;
+    }
+
+    // Anything that is not a file is tried as a folder, which reports a
+    // missing node.
+    const FileRecord *record = nullptr;
+    const bool is_file = GetFileInfo(op.path, &record) == VXCORE_OK;
+    if (op.kind == NodeOp::Kind::Move) {
+      out_results[i] = is_file ? MoveFile(op.path, op.arg) : MoveFolder(op.path, op.arg);
+    } else {
+      out_results[i] = is_file ? DeleteFile(op.path) : DeleteFolder(op.path);
+    }
+  }
+  return VXCORE_OK;
+}
+
 VxCoreError FolderManager::CreateFolderPath(const std::string &folder_path,
                                             std::string &out_folder_id) {
   if (folder_path.empty()) {
@@ -4,9 +4,11 @@
 #include <filesystem>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "core/event_manager.h"
 #include "folder.h"
 #include "notebook.h"
 #include "utils/file_utils.h"
@@ -14,8 +16,9 @@
 
 namespace vxcore {
 
-class EventManager;
 class Notebook;
+struct FolderConfigCacheStats;
+struct WriteBehindOptions;
 
 class FolderManager {
  public:
@@ -168,6 +171,59 @@ class FolderManager {
 
   virtual void ClearCache() = 0;
 
+  // Called by Notebook::Close() before the manager is released, to write
+  // pending changes and persist whatever speeds up the next open.
+  virtual void Close() {}
+
+  // Statistics and byte budget of the parsed folder config cache. Managers
+  // without one return VXCORE_ERR_UNSUPPORTED.
+  virtual VxCoreError GetConfigCacheStats(FolderConfigCacheStats &out_stats) {
+    (void)out_stats;
+    return VXCORE_ERR_UNSUPPORTED;
+  }
+
+  // 0 for unbounded.
+  virtual VxCoreError SetConfigCacheBudget(size_t budget_bytes) {
+    (void)budget_bytes;
+    return VXCORE_ERR_UNSUPPORTED;
+  }
+
+  // Write-behind of folder config files. With it enabled, saved configs are
+  // written once max_pending_writes saves are pending or the oldest one is
+  // max_delay old (checked on the next save and by FlushConfigWrites(true)),
+  // before operations that read or move config files on disk, on
+  // FlushConfigWrites() and on Close(). Managers without config files
+  // ignore it.
+  virtual void SetConfigWriteBehind(const WriteBehindOptions &options) { (void)options; }
+
+  virtual bool HasPendingConfigWrites() const { return false; }
+
+  // Writes the pending configs; with |only_if_due|, only if they are due.
+  // Configs that fail to write stay pending.
+  virtual VxCoreError FlushConfigWrites(bool only_if_due = false) {
+    (void)only_if_due;
+    return VXCORE_OK;
+  }
+
+  // One step of a batch of node changes, see ApplyNodeOps().
+  struct NodeOp {
+    enum class Kind { Move, Delete, Tag, Untag };
+
+    Kind kind = Kind::Move;
+    // File or folder for Move and Delete; file for Tag and Untag.
+    std::string path;
+    // Destination parent folder for Move, tag name for Tag and Untag.
+    std::string arg;
+  };
+
+  // Applies |ops| in order through MoveFile/MoveFolder, DeleteFile/
+  // DeleteFolder, TagFile and UntagFile. out_results[i] receives the result
+  // of ops[i]; a failed op does not stop the rest. Events are delivered once
+  // the whole batch is applied. Managers override this to also share config
+  // loads and writes and one store transaction across the batch.
+  virtual VxCoreError ApplyNodeOps(const std::vector<NodeOp> &ops,
+                                   std::vector<VxCoreError> &out_results);
+
   // Get the public assets folder path for a file.
   // The path is resolved based on notebook's assetsFolder config and file's parent folder.
   // Config can be: simple folder name, relative path, or absolute path.
@@ -205,6 +261,24 @@ class FolderManager {
 
   void EmitEvent(const char *event_name, const nlohmann::json &data);
 
+  // Typed variant (payload structs from event_names.h): JSON is built only if
+  // a JSON listener is subscribed.
+  template <typename Payload>
+  void EmitEvent(const char *event_name, const Payload &payload) {
+    if (event_manager_) {
+      event_manager_->EmitTyped(event_name, payload);
+    } else {
+      LogDroppedEvent(event_name);
+    }
+  }
+
+  // False only when an EventManager is wired and nobody listens to
+  // event_name, so callers can skip building the payload. Stays true without
+  // an EventManager so EmitEvent still logs the dropped event.
+  bool WantsEvent(const char *event_name) const;
+
+  void LogDroppedEvent(const char *event_name) const;
+
   Notebook *notebook_ = nullptr;
   EventManager *event_manager_ = nullptr;
 };
@@ -0,0 +1,82 @@
+#include "core/frecency_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vxcore {
+
+namespace {
+
+// Reference point of the stored log scores; any fixed instant works.
+constexpr int64_t kEpochMs = 1577836800000LL;  // 2020-01-01T00:00:00Z
+
+// Log of the decay factor 2^(ms / kHalfLifeMs)
+double LogGrowth(int64_t ms) {
+  return static_cast<double>(ms) / static_cast<double>(FrecencyIndex::kHalfLifeMs) * std::log(2.0);
+}
+
+// log(e^a + e^b) without overflowing
+double LogAddExp(double a, double b) {
+  const double hi = std::max(a, b);
+  return hi + std::log1p(std::exp(std::min(a, b) - hi));
+}
+
+double ToScore(double log_score, int64_t now_ms) {
+  return std::exp(log_score - LogGrowth(now_ms - kEpochMs));
+}
+
+}  // namespace
+
+void FrecencyIndex::Add(const std::string &notebook_id, const std::string &file_id, double weight,
+                        int64_t at_ms) {
+  if (weight <= 0 || notebook_id.empty() || file_id.empty()) {
+    return;
+  }
+  const double event = std::log(weight) + LogGrowth(at_ms - kEpochMs);
+  auto &ranking = notebooks_[notebook_id];
+  auto it = ranking.log_scores.find(file_id);
+  if (it == ranking.log_scores.end()) {
+    ranking.log_scores.emplace(file_id, event);
+    ranking.ranked.emplace(event, file_id);
+    return;
+  }
+  ranking.ranked.erase({it->second, file_id});
+  it->second = LogAddExp(it->second, event);
+  ranking.ranked.emplace(it->second, file_id);
+}
+
+void FrecencyIndex::ForEachRanked(
+    const std::string &notebook_id, int64_t now_ms,
+    const std::function<bool(const std::string &, double)> &callback) const {
+  auto it = notebooks_.find(notebook_id);
+  if (it == notebooks_.end()) {
+    return;
+  }
+  for (const auto &entry : it->second.ranked) {
+    if (!callback(entry.second, ToScore(entry.first, now_ms))) {
+      break;
+    }
+  }
+}
+
+double FrecencyIndex::GetScore(const std::string &notebook_id, const std::string &file_id,
+                               int64_t now_ms) const {
+  auto it = notebooks_.find(notebook_id);
+  if (it == notebooks_.end()) {
+    return 0.0;
+  }
+  auto score_it = it->second.log_scores.find(file_id);
+  return score_it == it->second.log_scores.end() ? 0.0 : ToScore(score_it->second, now_ms);
+}
+
+size_t FrecencyIndex::Size() const {
+  size_t size = 0;
+  for (const auto &entry : notebooks_) {
+    size += entry.second.log_scores.size();
+  }
+  return size;
+}
+
+void FrecencyIndex::Clear() { notebooks_.clear(); }
+
+}  // namespace vxcore
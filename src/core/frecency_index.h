@@ -0,0 +1,72 @@
+#ifndef VXCORE_FRECENCY_INDEX_H
+#define VXCORE_FRECENCY_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vxcore {
+
+// In-memory frecency scores of files, per notebook.
+//
+// A file's score is the sum of its usage events, each weighted by kind and
+// decaying exponentially with age:
+//   score(now) = sum_i w_i * 2^(-(now - t_i) / kHalfLifeMs)
+// Time scales every score by the same factor, so the ranking only changes
+// when events arrive. A file therefore keeps just
+//   log(sum_i w_i * 2^((t_i - kEpochMs) / kHalfLifeMs))
+// which an event updates in O(1), and a per-notebook ordered set keeps files
+// ranked by it: top-k walks k set nodes, a single score is a hash lookup, and
+// nothing needs recomputing as the clock moves.
+//
+// NOT thread-safe: ActivityManager serializes access under its mutex.
+class FrecencyIndex {
+ public:
+  static constexpr int64_t kHalfLifeMs = 14LL * 24 * 60 * 60 * 1000;
+  // Weights of one read and one edit
+  static constexpr double kReadWeight = 1.0;
+  static constexpr double kEditWeight = 2.0;
+
+  // Adds |weight| (> 0) of usage to |file_id| at |at_ms| (epoch millis).
+  void Add(const std::string &notebook_id, const std::string &file_id, double weight,
+           int64_t at_ms);
+
+  // Calls |callback| with the files of |notebook_id|, highest score first
+  // (ties by file id), scored as of |now_ms|, until it returns false.
+  void ForEachRanked(const std::string &notebook_id, int64_t now_ms,
+                     const std::function<bool(const std::string &, double)> &callback) const;
+
+  // Score of |file_id| as of |now_ms|; 0 for a file without usage.
+  double GetScore(const std::string &notebook_id, const std::string &file_id,
+                  int64_t now_ms) const;
+
+  // Number of files with a score, over all notebooks
+  size_t Size() const;
+
+  void Clear();
+
+ private:
+  // Higher log score first, then file id
+  struct ByRank {
+    bool operator()(const std::pair<double, std::string> &a,
+                    const std::pair<double, std::string> &b) const {
+      return a.first != b.first ? a.first > b.first : a.second < b.second;
+    }
+  };
+
+  struct Ranking {
+    std::unordered_map<std::string, double> log_scores;
+    std::set<std::pair<double, std::string>, ByRank> ranked;
+  };
+
+  std::unordered_map<std::string, Ranking> notebooks_;
+};
+
+}  // namespace vxcore
+
+#endif  // VXCORE_FRECENCY_INDEX_H
@@ -9,12 +9,15 @@
 
 namespace vxcore {
 
-constexpr int kMaxHistoryItems = 50;
-constexpr const char *kMetaKeyHistory = "history";
+// Files kept in a notebook's history; the least recently opened go first.
+constexpr int kMaxHistoryItems = 5000;
+// Entries returned by GetHistory() unless asked otherwise.
+constexpr int kHistoryPageSize = 50;
 
 struct HistoryEntry {
   std::string file_id;
   int64_t opened_utc;
+  int64_t open_count = 1;
 
   static HistoryEntry FromJson(const nlohmann::json &j);
   nlohmann::json ToJson() const;
@@ -22,7 +25,8 @@ struct HistoryEntry {
 
 class MetadataStore;
 
-std::vector<HistoryEntry> GetHistory(MetadataStore *store);
+// Most recent first; |limit| 0 returns the whole history.
+std::vector<HistoryEntry> GetHistory(MetadataStore *store, int limit = kHistoryPageSize);
 bool RecordFileOpen(MetadataStore *store, const std::string &file_id);
 bool ClearHistory(MetadataStore *store);
 
@@ -0,0 +1,225 @@
+#include "core/metadata_filter.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace vxcore {
+
+namespace {
+
+struct OpName {
+  const char *name;
+  MetadataOp op;
+};
+
+const OpName kOpNames[] = {
+    {"eq", MetadataOp::kEq},         {"ne", MetadataOp::kNe},
+    {"lt", MetadataOp::kLt},         {"le", MetadataOp::kLe},
+    {"gt", MetadataOp::kGt},         {"ge", MetadataOp::kGe},
+    {"exists", MetadataOp::kExists}, {"missing", MetadataOp::kMissing},
+};
+
+bool IsOrdering(MetadataOp op) {
+  return op == MetadataOp::kLt || op == MetadataOp::kLe || op == MetadataOp::kGt ||
+         op == MetadataOp::kGe;
+}
+
+// The field at |key|, or null if any segment is missing.
+const nlohmann::json *Lookup(const nlohmann::json &metadata, const std::string &key) {
+  const nlohmann::json *node = &metadata;
+  for (const auto &segment : SplitMetadataKey(key)) {
+    if (!node->is_object()) {
+      return nullptr;
+    }
+    auto it = node->find(segment);
+    if (it == node->end()) {
+      return nullptr;
+    }
+    node = &*it;
+  }
+  return node;
+}
+
+// <0, 0, >0 like strcmp, or nullopt when the two are of different kinds (or
+// not scalars) and so never compare.
+std::optional<int> Compare(const nlohmann::json &field, const nlohmann::json &value) {
+  if (field.is_string() && value.is_string()) {
+    const int c =
+        field.get_ref<const std::string &>().compare(value.get_ref<const std::string &>());
+    return c < 0 ? -1 : (c > 0 ? 1 : 0);
+  }
+  if (field.is_number() && value.is_number()) {
+    if (field.is_number_integer() && value.is_number_integer() && !field.is_number_unsigned() &&
+        !value.is_number_unsigned()) {
+      const int64_t a = field.get<int64_t>();
+      const int64_t b = value.get<int64_t>();
+      return a < b ? -1 : (a > b ? 1 : 0);
+    }
+    const double a = field.get<double>();
+    const double b = value.get<double>();
+    return a < b ? -1 : (a > b ? 1 : 0);
+  }
+  if (field.is_boolean() && value.is_boolean()) {
+    return field.get<bool>() == value.get<bool>() ? 0 : 1;
+  }
+  if (field.is_null() && value.is_null()) {
+    return 0;
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+bool IsValidMetadataKey(const std::string &key) {
+  if (key.empty() || key.front() == '.' || key.back() == '.') {
+    return false;
+  }
+  char prev = '\0';
+  for (char c : key) {
+    const auto uc = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\'' || c == '\\' || uc < 0x20 || uc == 0x7f) {
+      return false;
+    }
+    if (c == '.' && prev == '.') {
+      return false;
+    }
+    prev = c;
+  }
+  return true;
+}
+
+std::vector<std::string> SplitMetadataKey(const std::string &key) {
+  std::vector<std::string> segments;
+  size_t start = 0;
+  while (true) {
+    const size_t dot = key.find('.', start);
+    segments.push_back(
+        key.substr(start, dot == std::string::npos ? std::string::npos : dot - start));
+    if (dot == std::string::npos) {
+      break;
+    }
+    start = dot + 1;
+  }
+  return segments;
+}
+
+bool MetadataCondition::Matches(const nlohmann::json &metadata) const {
+  const nlohmann::json *field = Lookup(metadata, key);
+  switch (op) {
+    case MetadataOp::kExists:
+      return field != nullptr;
+    case MetadataOp::kMissing:
+      return field == nullptr;
+    case MetadataOp::kEq:
+    case MetadataOp::kNe: {
+      const bool equal = field && Compare(*field, value) == 0;
+      return op == MetadataOp::kEq ? equal : !equal;
+    }
+    default:
+      break;
+  }
+
+  if (!field || !(value.is_string() || value.is_number())) {
+    return false;
+  }
+  const auto c = Compare(*field, value);
+  if (!c) {
+    return false;
+  }
+  switch (op) {
+    case MetadataOp::kLt:
+      return *c < 0;
+    case MetadataOp::kLe:
+      return *c <= 0;
+    case MetadataOp::kGt:
+      return *c > 0;
+    case MetadataOp::kGe:
+      return *c >= 0;
+    default:
+      return false;
+  }
+}
+
+bool MetadataFilter::Matches(const nlohmann::json &metadata) const {
+  for (const auto &condition : conditions) {
+    if (!condition.Matches(metadata)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MetadataFilter::FromJson(const nlohmann::json &json, MetadataFilter &out,
+                              std::string &error) {
+  MetadataFilter filter;
+  if (json.is_object()) {
+    for (auto it = json.begin(); it != json.end(); ++it) {
+      if (!IsValidMetadataKey(it.key())) {
+        error = "Invalid metadata key: " + it.key();
+        return false;
+      }
+      if (it->is_structured()) {
+        error = "Metadata value for '" + it.key() + "' must be a scalar";
+        return false;
+      }
+      filter.conditions.push_back({it.key(), MetadataOp::kEq, *it});
+    }
+    out = std::move(filter);
+    return true;
+  }
+
+  if (!json.is_array()) {
+    error = "Metadata filter must be an array of conditions or an object";
+    return false;
+  }
+  for (const auto &item : json) {
+    if (!item.is_object() || !item.contains("key") || !item["key"].is_string()) {
+      error = "Metadata condition needs a string \"key\"";
+      return false;
+    }
+    MetadataCondition condition;
+    condition.key = item["key"].get<std::string>();
+    if (!IsValidMetadataKey(condition.key)) {
+      error = "Invalid metadata key: " + condition.key;
+      return false;
+    }
+
+    if (item.contains("op")) {
+      if (!item["op"].is_string()) {
+        error = "Metadata condition \"op\" must be a string";
+        return false;
+      }
+      const auto &name = item["op"].get_ref<const std::string &>();
+      bool known = false;
+      for (const auto &entry : kOpNames) {
+        if (name == entry.name) {
+          condition.op = entry.op;
+          known = true;
+          break;
+        }
+      }
+      if (!known) {
+        error = "Unknown metadata operator: " + name;
+        return false;
+      }
+    }
+
+    if (condition.op != MetadataOp::kExists && condition.op != MetadataOp::kMissing) {
+      if (!item.contains("value") || item["value"].is_structured()) {
+        error = "Metadata condition on '" + condition.key + "' needs a scalar \"value\"";
+        return false;
+      }
+      condition.value = item["value"];
+      if (IsOrdering(condition.op) &&
+          !(condition.value.is_string() || condition.value.is_number())) {
+        error = "Metadata ordering on '" + condition.key + "' needs a string or number";
+        return false;
+      }
+    }
+    filter.conditions.push_back(std::move(condition));
+  }
+  out = std::move(filter);
+  return true;
+}
+
+}  // namespace vxcore
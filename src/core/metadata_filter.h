@@ -0,0 +1,58 @@
+#ifndef VXCORE_METADATA_FILTER_H
+#define VXCORE_METADATA_FILTER_H
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace vxcore {
+
+enum class MetadataOp { kEq, kNe, kLt, kLe, kGt, kGe, kExists, kMissing };
+
+// One predicate on a file or folder metadata field.
+//
+// |key| is a dotted path into the metadata object ("status", "review.state").
+// |value| is a JSON scalar; kExists/kMissing ignore it. Values only compare
+// with values of the same kind (string, number, boolean, null), so
+// {"status": "1"} is not equal to 1. kNe is the negation of kEq and therefore
+// matches nodes without the key; the ordering operators take strings
+// (byte-wise) or numbers only and never match a missing key.
+struct MetadataCondition {
+  std::string key;
+  MetadataOp op = MetadataOp::kEq;
+  nlohmann::json value;
+
+  // Evaluates the condition against one node's metadata object.
+  bool Matches(const nlohmann::json &metadata) const;
+};
+
+// Conditions ANDed together. An empty filter matches everything.
+//
+// Evaluated in memory by Matches(), and in SQL by the metadata store (see
+// FileDb::FindFilesByMetadata); both give the same answers.
+struct MetadataFilter {
+  std::vector<MetadataCondition> conditions;
+
+  bool IsEmpty() const { return conditions.empty(); }
+
+  bool Matches(const nlohmann::json &metadata) const;
+
+  // Accepts either a list of conditions
+  //   [{"key": "status", "op": "eq", "value": "draft"}, {"key": "due", "op": "exists"}]
+  // ("op" defaults to "eq"; the others are ne, lt, le, gt, ge, exists, missing)
+  // or an object of key/value equality tests
+  //   {"status": "draft", "priority": 2}
+  // Returns false with |error| set on anything else.
+  static bool FromJson(const nlohmann::json &json, MetadataFilter &out, std::string &error);
+};
+
+// A key is one or more non-empty segments joined by '.'; segments may not
+// contain quotes, backslashes or control characters.
+bool IsValidMetadataKey(const std::string &key);
+
+// Splits a valid key into its path segments.
+std::vector<std::string> SplitMetadataKey(const std::string &key);
+
+}  // namespace vxcore
+
+#endif  // VXCORE_METADATA_FILTER_H
@@ -1,14 +1,20 @@
 #ifndef VXCORE_METADATA_STORE_H
 #define VXCORE_METADATA_STORE_H
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include <vxcore/vxcore_types.h>
 
+#include "core/metadata_filter.h"
+
 namespace vxcore {
 // Metadata store record structures (storage-agnostic)
 // These mirror the core types but are used for store operations
@@ -48,6 +54,86 @@ struct StoreTagQueryResult {
   std::vector<std::string> tags;
 };
 
+// Tag expression: a file matches if it has every tag in |all_of|, at least
+// one tag in |any_of| (when non-empty), and no tag in |none_of|. A filter
+// with no tags at all matches nothing.
+//
+// With |include_descendants|, each named tag stands for its whole subtree in
+// the tag hierarchy: "project" is satisfied by "project" or any tag below it.
+struct StoreTagFilter {
+  std::vector<std::string> all_of;
+  std::vector<std::string> any_of;
+  std::vector<std::string> none_of;
+  bool include_descendants = false;
+
+  bool IsEmpty() const { return all_of.empty() && any_of.empty() && none_of.empty(); }
+
+  // Evaluates the filter against one file's tags, for callers holding
+  // records rather than querying a store. Matches exact names only; the
+  // hierarchy behind |include_descendants| is known to the store alone.
+  bool Matches(const std::vector<std::string>& tags) const {
+    if (IsEmpty()) {
+      return false;
+    }
+    auto has = [&tags](const std::string& tag) {
+      return std::find(tags.begin(), tags.end(), tag) != tags.end();
+    };
+    return std::all_of(all_of.begin(), all_of.end(), has) &&
+           (any_of.empty() || std::any_of(any_of.begin(), any_of.end(), has)) &&
+           std::none_of(none_of.begin(), none_of.end(), has);
+  }
+};
+
+// File counts for one tag and for the subtree rooted at it
+struct StoreTagCount {
+  std::string name;
+  std::string parent_name;  // Empty for root tags
+  int file_count;           // Files tagged with this tag itself
+  int subtree_file_count;   // Distinct files tagged with it or any descendant
+};
+
+// Metadata query: files and/or folders whose metadata satisfies |filter|
+struct StoreMetadataQuery {
+  MetadataFilter filter;
+  bool include_files = true;
+  bool include_folders = false;
+  size_t limit = 0;  // Per kind; 0 for no limit
+};
+
+// A file or folder matched by a metadata query
+struct StoreMetadataMatch {
+  std::string node_id;  // UUID
+  std::string path;     // Relative to the notebook root; empty for the root folder
+  bool is_folder = false;
+  std::string metadata;  // JSON string
+};
+
+// One file in the open history
+struct StoreHistoryEntry {
+  std::string file_id;  // UUID
+  int64_t opened_utc = 0;
+  int64_t open_count = 0;
+};
+
+// What a folder was last synced from: its vx.json stat values and content
+// hash. mtime_utc/size are -1 and hash is empty when never recorded.
+struct StoreFolderConfigStamp {
+  std::string folder_id;    // UUID
+  std::string folder_path;  // Relative path, empty for the root folder
+  int64_t mtime_utc = -1;
+  int64_t size = -1;
+  std::string hash;
+};
+
+// Write-behind batching for a store; see MetadataStore::SetWriteBehind.
+struct WriteBehindOptions {
+  bool enabled = false;
+  // Commit once the open batch holds this many writes.
+  size_t max_pending_writes = 256;
+  // Commit once the open batch is this old.
+  std::chrono::milliseconds max_delay{500};
+};
+
 // Sync result codes
 enum class SyncResultCode {
   kSuccess,
@@ -58,12 +144,53 @@ enum class SyncResultCode {
   kFileSystemError
 };
 
+// Read-only query interface over a store's committed data.
+// Returned by MetadataStore::AcquireReader() for use off the owning thread;
+// each reader must be used by one thread at a time. MetadataStore itself is a
+// reader too, so query code can take either; see MetadataStore for semantics.
+class MetadataStoreReader {
+ public:
+  virtual ~MetadataStoreReader() = default;
+
+  virtual std::optional<StoreFolderRecord> GetFolder(const std::string& folder_id) = 0;
+  virtual std::optional<StoreFolderRecord> GetFolderByPath(const std::string& path) = 0;
+  virtual std::vector<StoreFolderRecord> ListFolders(const std::string& parent_id) = 0;
+  virtual std::string GetNodePathById(const std::string& node_id) = 0;
+
+  virtual std::optional<StoreFileRecord> GetFile(const std::string& file_id) = 0;
+  virtual std::optional<StoreFileRecord> GetFileByPath(const std::string& path) = 0;
+  virtual std::vector<StoreFileRecord> ListFiles(const std::string& folder_id) = 0;
+  virtual std::vector<std::string> GetFileTags(const std::string& file_id) = 0;
+
+  virtual std::vector<StoreTagQueryResult> FindFilesByTagsOr(
+      const std::vector<std::string>& tags) = 0;
+  virtual std::vector<StoreTagQueryResult> FindFilesByTagsAnd(
+      const std::vector<std::string>& tags) = 0;
+  virtual std::vector<StoreTagQueryResult> FindFilesByTagFilter(const StoreTagFilter& filter) = 0;
+  virtual std::vector<std::pair<std::string, int>> CountFilesByTag() = 0;
+  virtual std::vector<StoreTagCount> CountFilesByTagSubtree() = 0;
+  virtual std::vector<StoreMetadataMatch> FindNodesByMetadata(const StoreMetadataQuery& query) = 0;
+
+  // --- Batch Lookups ---
+  // For resolving many nodes at once (restoring a workspace, listing
+  // results): a few queries per batch rather than a few per node. Results are
+  // aligned with the input; unknown ids/paths yield nullopt or "".
+
+  virtual std::vector<std::optional<StoreFileRecord>> GetFilesByIds(
+      const std::vector<std::string>& file_ids) = 0;
+  // Paths are relative to the notebook root, as from GetNodePathById.
+  virtual std::vector<std::string> GetNodePathsByIds(const std::vector<std::string>& node_ids) = 0;
+  virtual std::vector<std::optional<StoreFileRecord>> GetFilesByPaths(
+      const std::vector<std::string>& paths) = 0;
+};
+
 // Abstract interface for metadata storage
 // This is a write-through cache layer - config files remain ground truth
 // Storage implementations (SQLite, etc.) provide fast queries
 //
-// Thread safety: NOT thread-safe. Caller must ensure synchronization.
-class MetadataStore {
+// Thread safety: NOT thread-safe. Caller must ensure synchronization. The
+// exception is AcquireReader(), which may be called from any thread.
+class MetadataStore : public MetadataStoreReader {
  public:
   virtual ~MetadataStore() = default;
 
@@ -207,9 +334,32 @@ class MetadataStore {
   virtual std::vector<StoreTagQueryResult> FindFilesByTagsAnd(
       const std::vector<std::string>& tags) = 0;
 
+  // Finds files matching a tag expression (see StoreTagFilter). Results are
+  // ordered like FindFilesByTagsAnd/Or: by file name, then insertion order.
+  virtual std::vector<StoreTagQueryResult> FindFilesByTagFilter(const StoreTagFilter& filter) = 0;
+
   // Counts files for each tag
   virtual std::vector<std::pair<std::string, int>> CountFilesByTag() = 0;
 
+  // Counts files for each tag and, rolled up, for its subtree, in one query.
+  // Ordered by tag name.
+  virtual std::vector<StoreTagCount> CountFilesByTagSubtree() = 0;
+
+  // --- Metadata Queries ---
+
+  // Finds files (then folders, if asked) whose metadata satisfies the query's
+  // filter; each kind is ordered by name, then insertion order. Predicates on
+  // a key with a metadata index (see below) are answered from the index.
+  virtual std::vector<StoreMetadataMatch> FindNodesByMetadata(const StoreMetadataQuery& query) = 0;
+
+  // Expression indexes over single metadata keys ("status", "review.state"),
+  // kept with the database across reopen, rebuild and bulk load. The store
+  // may also index keys it sees queried repeatedly. Each index costs a little
+  // on every file/folder write.
+  virtual bool CreateMetadataIndex(const std::string& key) = 0;
+  virtual bool DropMetadataIndex(const std::string& key) = 0;
+  virtual std::vector<std::string> ListMetadataIndexes() = 0;
+
   // --- Sync/Recovery Operations ---
   // These methods support rebuilding the store from config files
 
@@ -217,6 +367,60 @@ class MetadataStore {
   // WARNING: This deletes all cached data!
   virtual bool RebuildAll() = 0;
 
+  // Bulk reload: BeginBulkLoad() clears the store like RebuildAll(), then
+  // BulkAddFolder()/BulkAddFile() queue records (parents before children and
+  // files) and EndBulkLoad() writes everything in one transaction. A rejected
+  // record (unknown parent, duplicate id) returns false without ending the
+  // load. Other store calls must not be made while a load is active.
+  virtual bool BeginBulkLoad() = 0;
+  virtual bool BulkAddFolder(const StoreFolderRecord& folder) = 0;
+  virtual bool BulkAddFile(const StoreFileRecord& file) = 0;
+  virtual bool EndBulkLoad() = 0;
+
+  // Records the vx.json |folder_id| was synced from, for incremental
+  // reconciliation. Stamps are dropped with their folder.
+  virtual bool SetFolderConfigStamp(const std::string& folder_id, int64_t mtime_utc,
+                                    int64_t size, const std::string& hash) = 0;
+
+  // Lists every folder (with a resolvable path) and its stamp, if any.
+  virtual std::vector<StoreFolderConfigStamp> ListFolderConfigStamps() = 0;
+
+  // --- Concurrent Reads ---
+
+  // Returns a reader on a separate read-only connection, so queries can run
+  // on worker threads in parallel with each other and with writes on the
+  // store. Readers see committed data only (no pending write-behind writes).
+  // Blocks while the implementation's reader limit is reached; release
+  // readers promptly. Returns nullptr if the store is closed or cannot serve
+  // concurrent reads (e.g. in-memory stores); callers then fall back to the
+  // store itself on the owning thread.
+  virtual std::unique_ptr<MetadataStoreReader> AcquireReader() = 0;
+
+  // --- Write-Behind ---
+  // Config files are the ground truth, so the store may trade durability for
+  // throughput. With write-behind enabled, mutations made outside an explicit
+  // transaction are grouped into one open transaction instead of committing
+  // one by one. The batch commits when a mutation finds it full or older than
+  // max_delay, when FlushPendingWrites*() is called, before an explicit
+  // transaction, bulk load or rebuild begins, and on Close(). A crash loses
+  // at most the open batch; reconciling from config files repairs it.
+  //
+  // Queries on the store itself see pending writes; AcquireReader() readers
+  // do not until the batch commits (see HasPendingWrites()).
+
+  // Applies |options|; disabling write-behind commits the open batch.
+  virtual void SetWriteBehind(const WriteBehindOptions& options) = 0;
+
+  // True while a write-behind batch holds uncommitted writes.
+  virtual bool HasPendingWrites() const = 0;
+
+  // Commits the open batch. Returns false if the commit failed.
+  virtual bool FlushPendingWrites() = 0;
+
+  // Commits the open batch only if it is full or older than max_delay; for
+  // hosts to call when idle so a quiet store does not keep writes pending.
+  virtual bool FlushPendingWritesIfDue() = 0;
+
   // --- Iteration ---
 
   // Iterates all files in the store
@@ -229,6 +433,21 @@ class MetadataStore {
   virtual std::optional<std::string> GetNotebookMetadata(const std::string& key) = 0;
   virtual bool SetNotebookMetadata(const std::string& key, const std::string& value) = 0;
 
+  // --- File History ---
+  // Files opened in the notebook, one entry each. Unlike the rest of the
+  // store it is not derived from the config files, so RebuildAll keeps it.
+
+  // Makes |file_id| the most recent entry, opened at |opened_utc|, and bumps
+  // its open count. A new entry evicts the least recent ones beyond
+  // |max_entries| (0 keeps everything).
+  virtual bool RecordFileOpen(const std::string& file_id, int64_t opened_utc,
+                              size_t max_entries) = 0;
+
+  // Returns up to |limit| entries, most recent first (0 returns all).
+  virtual std::vector<StoreHistoryEntry> GetFileHistory(size_t limit) = 0;
+
+  virtual bool ClearFileHistory() = 0;
+
   // --- Error Handling ---
 
   // Returns the last error message
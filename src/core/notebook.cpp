@@ -322,6 +322,29 @@ VxCoreError Notebook::SyncTagsToMetadataStore() {
   return VXCORE_OK;
 }
 
+void Notebook::SyncTagDefinitionToMetadataStore(const std::string &tag_name) {
+  if (!metadata_store_ || !metadata_store_->IsOpen()) {
+    return;
+  }
+
+  const TagNode *tag = FindTag(tag_name);
+  bool ok = true;
+  if (tag) {
+    StoreTagRecord store_tag;
+    store_tag.name = tag->name;
+    store_tag.parent_name = tag->parent;
+    store_tag.metadata = tag->metadata.dump();
+    ok = metadata_store_->CreateOrUpdateTag(store_tag);
+  } else if (metadata_store_->GetTag(tag_name)) {
+    ok = metadata_store_->DeleteTag(tag_name);
+  }
+
+  if (!ok) {
+    VXCORE_LOG_WARN("Failed to sync tag definition to metadata store: tag=%s, error=%s",
+                    tag_name.c_str(), metadata_store_->GetLastError().c_str());
+  }
+}
+
 void Notebook::SetLastSyncUtc(int64_t ts_millis) {
   if (!metadata_store_) {
     VXCORE_LOG_WARN("Notebook::SetLastSyncUtc: metadata_store_ is null, "
@@ -363,6 +386,10 @@ bool Notebook::IsReadOnly() const noexcept {
 void Notebook::Close() {
   VXCORE_LOG_INFO("Closing notebook: id=%s", config_.id.c_str());
 
+  if (folder_manager_) {
+    folder_manager_->Close();
+  }
+
   // Close MetadataStore first to release DB file lock
   if (metadata_store_) {
     metadata_store_->Close();
@@ -411,6 +438,7 @@ VxCoreError Notebook::CreateTag(const std::string &tag_name, const std::string &
     return err;
   }
 
+  SyncTagDefinitionToMetadataStore(tag_name);
   return VXCORE_OK;
 }
 
@@ -516,6 +544,10 @@ VxCoreError Notebook::DeleteTag(const std::string &tag_name) {
     return err;
   }
 
+  // Deepest first, so no row depends on the store's cascade.
+  for (auto it = tags_to_delete.rbegin(); it != tags_to_delete.rend(); ++it) {
+    SyncTagDefinitionToMetadataStore(*it);
+  }
   return VXCORE_OK;
 }
 
@@ -565,6 +597,7 @@ VxCoreError Notebook::MoveTag(const std::string &tag_name, const std::string &pa
     return err;
   }
 
+  SyncTagDefinitionToMetadataStore(tag_name);
   return VXCORE_OK;
 }
 
@@ -591,12 +624,23 @@ std::string Notebook::GetAbsolutePath(const std::string &relative_path) const {
 
 VxCoreError Notebook::FindFilesByTags(const std::vector<std::string> &tags, bool use_and,
                                       std::string &out_results_json) {
+  StoreTagFilter filter;
+  (use_and ? filter.all_of : filter.any_of) = tags;
+  return QueryFilesByTags(filter, out_results_json);
+}
+
+VxCoreError Notebook::QueryFilesByTags(const StoreTagFilter &filter,
+                                       std::string &out_results_json) {
   if (!metadata_store_ || !metadata_store_->IsOpen()) {
     return VXCORE_ERR_INVALID_STATE;
   }
 
-  auto results = use_and ? metadata_store_->FindFilesByTagsAnd(tags)
-                         : metadata_store_->FindFilesByTagsOr(tags);
+  // Query on a pooled read connection when available so concurrent callers
+  // don't serialize on the store's own connection. Pending write-behind
+  // writes are only visible on the store's own connection.
+  auto reader = metadata_store_->HasPendingWrites() ? nullptr : metadata_store_->AcquireReader();
+  MetadataStoreReader *source = reader ? reader.get() : metadata_store_.get();
+  auto results = source->FindFilesByTagFilter(filter);
 
   nlohmann::json matches = nlohmann::json::array();
   for (const auto &result : results) {
@@ -619,7 +663,9 @@ VxCoreError Notebook::CountFilesByTag(std::string &out_results_json) {
     return VXCORE_ERR_INVALID_STATE;
   }
 
-  auto counts = metadata_store_->CountFilesByTag();
+  auto reader = metadata_store_->HasPendingWrites() ? nullptr : metadata_store_->AcquireReader();
+  MetadataStoreReader *source = reader ? reader.get() : metadata_store_.get();
+  auto counts = source->CountFilesByTag();
 
   nlohmann::json results = nlohmann::json::array();
   for (const auto &pair : counts) {
@@ -633,4 +679,27 @@ VxCoreError Notebook::CountFilesByTag(std::string &out_results_json) {
   return VXCORE_OK;
 }
 
+VxCoreError Notebook::CountFilesByTagSubtree(std::string &out_results_json) {
+  if (!metadata_store_ || !metadata_store_->IsOpen()) {
+    return VXCORE_ERR_INVALID_STATE;
+  }
+
+  auto reader = metadata_store_->HasPendingWrites() ? nullptr : metadata_store_->AcquireReader();
+  MetadataStoreReader *source = reader ? reader.get() : metadata_store_.get();
+  auto counts = source->CountFilesByTagSubtree();
+
+  nlohmann::json results = nlohmann::json::array();
+  for (const auto &count : counts) {
+    nlohmann::json entry = nlohmann::json::object();
+    entry["tag"] = count.name;
+    entry["parent"] = count.parent_name;
+    entry["count"] = count.file_count;
+    entry["subtreeCount"] = count.subtree_file_count;
+    results.push_back(std::move(entry));
+  }
+
+  out_results_json = results.dump();
+  return VXCORE_OK;
+}
+
 }  // namespace vxcore
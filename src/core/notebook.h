@@ -13,6 +13,8 @@ namespace vxcore {
 class EventManager;
 class FolderManager;
 class MetadataStore;
+class WorkQueue;
+struct StoreTagFilter;
 
 enum class NotebookType { Bundled, Raw };
 
@@ -89,6 +91,9 @@ class Notebook {
   FolderManager *GetFolderManager() { return folder_manager_.get(); }
   MetadataStore *GetMetadataStore() { return metadata_store_.get(); }
 
+  // Path of the notebook's metadata database under its local data folder.
+  std::string GetDbPath() const;
+
   void SetEventManager(EventManager *event_manager) { event_manager_ = event_manager; }
 
   // Per-device "last successful git sync" timestamp, persisted in metadata DB
@@ -120,11 +125,23 @@ class Notebook {
   // Direct DB-backed tag queries (bypasses SearchManager for efficiency)
   virtual VxCoreError FindFilesByTags(const std::vector<std::string> &tags, bool use_and,
                               std::string &out_results_json);
+  // Same output as FindFilesByTags, for a full AND/OR/NOT tag expression.
+  virtual VxCoreError QueryFilesByTags(const StoreTagFilter &filter,
+                                       std::string &out_results_json);
   virtual VxCoreError CountFilesByTag(std::string &out_results_json);
+  // Per-tag counts rolled up over each tag's subtree.
+  virtual VxCoreError CountFilesByTagSubtree(std::string &out_results_json);
 
   // Rebuild the metadata cache from ground truth (config files).
+  // |parse_queue|, if given, is used to parse config files concurrently; the
+  // calling thread help-drains it and stays the only store writer.
+  // Returns VXCORE_OK on success.
+  virtual VxCoreError RebuildCache(WorkQueue *parse_queue = nullptr) = 0;
+
+  // Cheaper alternative to RebuildCache(): re-reads only the config files
+  // that changed since they were last synced and applies the differences.
   // Returns VXCORE_OK on success.
-  virtual VxCoreError RebuildCache() = 0;
+  virtual VxCoreError ReconcileCache() = 0;
 
   // Clean and get path related to notebook root folder.
   // Returns null string if |path| is not under notebook root folder.
@@ -145,7 +162,12 @@ class Notebook {
   // Returns VXCORE_OK on success or if no sync needed
   VxCoreError SyncTagsToMetadataStore();
 
-  std::string GetDbPath() const;
+  // Mirrors the current definition of |tag_name| from NotebookConfig into the
+  // MetadataStore (or drops it there if the config no longer has it), so tag
+  // hierarchy queries see tag edits right away. Best-effort: a failure is
+  // logged and left to the next SyncTagsToMetadataStore().
+  void SyncTagDefinitionToMetadataStore(const std::string &tag_name);
+
   virtual std::string GetConfigPath() const = 0;
 
   const std::string local_data_folder_;
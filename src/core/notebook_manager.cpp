@@ -23,7 +23,13 @@ NotebookManager::NotebookManager(ConfigManager *config_manager) : config_manager
   LoadOpenNotebooks();
 }
 
-NotebookManager::~NotebookManager() {}
+NotebookManager::~NotebookManager() {
+  // Notebooks stay open across sessions; closing them here is what lets each
+  // one persist state for its next open (e.g. the folder config snapshot).
+  for (auto &entry : notebooks_) {
+    entry.second->Close();
+  }
+}
 
 void NotebookManager::LoadOpenNotebooks() {
   auto &session_config = config_manager_->GetSessionConfig();
@@ -109,6 +115,7 @@ void NotebookManager::LoadOpenNotebooks() {
         }
       }
 
+      ApplyStoreOptions(*notebook);
       notebooks_[notebook->GetId()] = std::move(notebook);
     } else {
       // Phantom: KEEP the record (a load failure is often transient) but dedupe
@@ -209,11 +216,12 @@ VxCoreError NotebookManager::CreateNotebook(const std::string &root_folder, Note
       notebook->GetFolderManager()->SetEventManager(event_manager_);
       notebook->SetEventManager(event_manager_);
     }
+    ApplyStoreOptions(*notebook);
     notebooks_[out_notebook_id] = std::move(notebook);
 
     VXCORE_LOG_INFO("Notebook created successfully: id=%s", out_notebook_id.c_str());
     if (event_manager_) {
-      event_manager_->Emit(events::kNotebookOpened, {{kJsonKeyNotebookId, out_notebook_id}});
+      event_manager_->EmitTyped(events::kNotebookOpened, events::NotebookEvent{out_notebook_id});
     }
     return VXCORE_OK;
   } catch (const nlohmann::json::exception &e) {
@@ -265,11 +273,12 @@ VxCoreError NotebookManager::OpenNotebook(const std::string &root_folder,
     notebook->GetFolderManager()->SetEventManager(event_manager_);
     notebook->SetEventManager(event_manager_);
   }
+  ApplyStoreOptions(*notebook);
   notebooks_[out_notebook_id] = std::move(notebook);
 
   VXCORE_LOG_INFO("Notebook open successfully: id=%s", out_notebook_id.c_str());
   if (event_manager_) {
-    event_manager_->Emit(events::kNotebookOpened, {{kJsonKeyNotebookId, out_notebook_id}});
+    event_manager_->EmitTyped(events::kNotebookOpened, events::NotebookEvent{out_notebook_id});
   }
   return VXCORE_OK;
 }
@@ -308,7 +317,7 @@ VxCoreError NotebookManager::CloseNotebook(const std::string &notebook_id) {
 
   VXCORE_LOG_INFO("Notebook closed successfully: id=%s", notebook_id.c_str());
   if (event_manager_) {
-    event_manager_->Emit(events::kNotebookClosed, {{kJsonKeyNotebookId, notebook_id}});
+    event_manager_->EmitTyped(events::kNotebookClosed, events::NotebookEvent{notebook_id});
   }
   return VXCORE_OK;
 }
@@ -416,6 +425,51 @@ Notebook *NotebookManager::GetNotebook(const std::string &notebook_id) {
   return it->second.get();
 }
 
+std::vector<std::string> NotebookManager::GetOpenDatabasePaths() const {
+  std::vector<std::string> paths;
+  for (const auto &entry : notebooks_) {
+    auto *store = entry.second->GetMetadataStore();
+    if (store && store->IsOpen()) {
+      paths.push_back(entry.second->GetDbPath());
+    }
+  }
+  return paths;
+}
+
+void NotebookManager::ApplyStoreOptions() {
+  for (auto &entry : notebooks_) {
+    ApplyStoreOptions(*entry.second);
+  }
+}
+
+void NotebookManager::ApplyStoreOptions(Notebook &notebook) {
+  const auto &config = config_manager_->GetConfig();
+  if (auto *store = notebook.GetMetadataStore()) {
+    store->SetWriteBehind(config.database.ToWriteBehindOptions());
+  }
+  if (auto *folder_manager = notebook.GetFolderManager()) {
+    folder_manager->SetConfigWriteBehind(config.folder_config_writes.ToWriteBehindOptions());
+  }
+}
+
+bool NotebookManager::FlushPendingWrites(bool only_if_due) {
+  bool ok = true;
+  for (auto &entry : notebooks_) {
+    // Config files first: they are the ground truth the store follows.
+    auto *folder_manager = entry.second->GetFolderManager();
+    if (folder_manager && folder_manager->FlushConfigWrites(only_if_due) != VXCORE_OK) {
+      ok = false;
+    }
+    auto *store = entry.second->GetMetadataStore();
+    if (store && store->IsOpen()) {
+      if (!(only_if_due ? store->FlushPendingWritesIfDue() : store->FlushPendingWrites())) {
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
 VxCoreError NotebookManager::UpdateNotebookRecord(const Notebook &notebook) {
   auto &session_config = config_manager_->GetSessionConfig();
   const std::string id = notebook.GetId();
@@ -552,6 +606,49 @@ VxCoreError NotebookManager::ResolveNodeById(const std::string &node_id,
   return VXCORE_ERR_NOT_FOUND;
 }
 
+std::vector<std::pair<std::string, std::string>> NotebookManager::ResolveNodesByIds(
+    const std::vector<std::string> &node_ids) {
+  std::vector<std::pair<std::string, std::string>> results(node_ids.size());
+
+  // Indices into |node_ids| not resolved yet; each notebook is asked only for
+  // what the previous ones did not contain.
+  std::vector<size_t> pending(node_ids.size());
+  for (size_t i = 0; i < pending.size(); ++i) {
+    pending[i] = i;
+  }
+
+  for (const auto &pair : notebooks_) {
+    if (pending.empty()) {
+      break;
+    }
+    auto *store = pair.second->GetMetadataStore();
+    if (!store) {
+      continue;
+    }
+
+    std::vector<std::string> ids;
+    ids.reserve(pending.size());
+    for (size_t index : pending) {
+      ids.push_back(node_ids[index]);
+    }
+    const std::vector<std::string> paths = store->GetNodePathsByIds(ids);
+
+    std::vector<size_t> still_pending;
+    for (size_t i = 0; i < pending.size(); ++i) {
+      if (paths[i].empty()) {
+        still_pending.push_back(pending[i]);
+      } else {
+        results[pending[i]] = {pair.first, paths[i]};
+      }
+    }
+    pending.swap(still_pending);
+  }
+
+  VXCORE_LOG_DEBUG("Resolved %zu of %zu nodes across open notebooks",
+                   node_ids.size() - pending.size(), node_ids.size());
+  return results;
+}
+
 void NotebookManager::SetEventManager(EventManager *event_manager) {
   event_manager_ = event_manager;
   // Propagate to existing notebooks and their folder managers
@@ -5,6 +5,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "notebook.h"
 #include "vxcore/vxcore_types.h"
@@ -36,6 +38,18 @@ class NotebookManager {
 
   Notebook *GetNotebook(const std::string &notebook_id);
 
+  // Metadata database paths of the open notebooks whose store is open.
+  std::vector<std::string> GetOpenDatabasePaths() const;
+
+  // Re-applies the "database" and "folderConfigWrites" configs (write-behind)
+  // to every open notebook's metadata store and folder manager.
+  void ApplyStoreOptions();
+
+  // Writes pending folder configs and commits pending write-behind batches
+  // of all open notebooks; with |only_if_due|, only those that are full or
+  // past their delay. Returns false if any write or commit failed.
+  bool FlushPendingWrites(bool only_if_due);
+
   // Resolve an absolute path to its containing notebook.
   // Returns the notebook ID and relative path within that notebook.
   // Returns VXCORE_ERR_NOT_FOUND if path is not within any open notebook.
@@ -48,6 +62,12 @@ class NotebookManager {
   VxCoreError ResolveNodeById(const std::string &node_id, std::string &out_notebook_id,
                               std::string &out_relative_path);
 
+  // Batch form of ResolveNodeById: one lookup per open notebook for all of
+  // |node_ids|. Returns (notebook ID, relative path) pairs aligned with
+  // |node_ids|; both are empty for ids no open notebook contains.
+  std::vector<std::pair<std::string, std::string>> ResolveNodesByIds(
+      const std::vector<std::string> &node_ids);
+
   // T14 of open-notebook-remote-readonly: persist the per-device read-only
   // flag for a notebook into session.json. Updates the matching
   // NotebookRecord.read_only and rewrites session config. No-op if the
@@ -60,6 +80,7 @@ class NotebookManager {
 
  private:
   void LoadOpenNotebooks();
+  void ApplyStoreOptions(Notebook &notebook);
   Notebook *FindNotebookByRootFolder(const std::string &root_folder);
 
   NotebookRecord *FindNotebookRecord(const std::string &id);
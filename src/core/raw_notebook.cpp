@@ -184,12 +184,18 @@ VxCoreError RawNotebook::UpdateConfig(const NotebookConfig &config) {
   return SaveConfigToDb();
 }
 
-VxCoreError RawNotebook::RebuildCache() {
+VxCoreError RawNotebook::RebuildCache(WorkQueue *parse_queue) {
+  (void)parse_queue;
   // Raw notebooks don't have vx.json config files to sync from.
   // Metadata is stored only in the database.
   return VXCORE_OK;
 }
 
+VxCoreError RawNotebook::ReconcileCache() {
+  // Nothing to reconcile against; the database is the only copy.
+  return VXCORE_OK;
+}
+
 std::string RawNotebook::GetRecycleBinPath() const {
   // Raw notebooks do not support recycle bin
   return "";
@@ -255,9 +261,21 @@ VxCoreError RawNotebook::FindFilesByTags(const std::vector<std::string> &tags, b
   return VXCORE_ERR_UNSUPPORTED;
 }
 
+VxCoreError RawNotebook::QueryFilesByTags(const StoreTagFilter &filter,
+                                          std::string &out_results_json) {
+  (void)filter;
+  (void)out_results_json;
+  return VXCORE_ERR_UNSUPPORTED;
+}
+
 VxCoreError RawNotebook::CountFilesByTag(std::string &out_results_json) {
   (void)out_results_json;
   return VXCORE_ERR_UNSUPPORTED;
 }
 
+VxCoreError RawNotebook::CountFilesByTagSubtree(std::string &out_results_json) {
+  (void)out_results_json;
+  return VXCORE_ERR_UNSUPPORTED;
+}
+
 }  // namespace vxcore
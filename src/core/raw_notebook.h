@@ -15,7 +15,8 @@ class RawNotebook : public Notebook {
                           const std::string &id, std::unique_ptr<Notebook> &out_notebook);
 
   VxCoreError UpdateConfig(const NotebookConfig &config) override;
-  VxCoreError RebuildCache() override;
+  VxCoreError RebuildCache(WorkQueue *parse_queue = nullptr) override;
+  VxCoreError ReconcileCache() override;
 
   std::string GetRecycleBinPath() const override;
   VxCoreError EmptyRecycleBin() override;
@@ -29,7 +30,10 @@ class RawNotebook : public Notebook {
   VxCoreError GetTags(std::string &out_tags_json) const override;
   VxCoreError FindFilesByTags(const std::vector<std::string> &tags, bool use_and,
                               std::string &out_results_json) override;
+  VxCoreError QueryFilesByTags(const StoreTagFilter &filter,
+                               std::string &out_results_json) override;
   VxCoreError CountFilesByTag(std::string &out_results_json) override;
+  VxCoreError CountFilesByTagSubtree(std::string &out_results_json) override;
 
  private:
   RawNotebook(const std::string &local_data_folder, const std::string &root_folder);
@@ -0,0 +1,19 @@
+#ifndef VXCORE_REBUILD_QUEUE_NAME_H
+#define VXCORE_REBUILD_QUEUE_NAME_H
+
+#include <cstddef>
+
+namespace vxcore {
+
+// Work queue that vxcore_notebook_rebuild_cache fans vx.json parsing out
+// onto. Pre-created by vxcore_context_create; hosts add parallelism by
+// draining it (vxcore_work_queue_process_next) from worker threads.
+constexpr char kRebuildQueueName[] = "vxcore.rebuild";
+
+// Pending-parse bound for that queue; the rebuild keeps at most this many
+// configs parsed ahead of the store writer.
+constexpr size_t kRebuildQueueCapacity = 64;
+
+}  // namespace vxcore
+
+#endif  // VXCORE_REBUILD_QUEUE_NAME_H
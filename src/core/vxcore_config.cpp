@@ -1,5 +1,7 @@
 #include "vxcore_config.h"
 
+#include "utils/logger.h"
+
 namespace vxcore {
 
 SearchConfig SearchConfig::FromJson(const nlohmann::json &json) {
@@ -21,6 +23,140 @@ nlohmann::json SearchConfig::ToJson() const {
   return json;
 }
 
+db::DbTuning DatabaseConfig::ToTuning() const {
+  db::DbTuning tuning;
+  if (!db::DbTuning::ForProfile(profile, tuning)) {
+    VXCORE_LOG_WARN("Unknown database profile '%s', using '%s'", profile.c_str(),
+                    db::DbTuning::ProfileNames().front().c_str());
+    db::DbTuning::ForProfile(db::DbTuning::ProfileNames().front(), tuning);
+  }
+  if (cache_size_kib && *cache_size_kib >= 0) {
+    tuning.cache_size_kib = *cache_size_kib;
+  }
+  if (mmap_size_mib && *mmap_size_mib >= 0) {
+    tuning.mmap_size_bytes = *mmap_size_mib * 1024 * 1024;
+  }
+  if (synchronous) {
+    if (*synchronous == "off") {
+      tuning.synchronous = 0;
+    } else if (*synchronous == "normal") {
+      tuning.synchronous = 1;
+    } else if (*synchronous == "full") {
+      tuning.synchronous = 2;
+    }
+  }
+  if (wal_autocheckpoint_pages && *wal_autocheckpoint_pages >= 0) {
+    tuning.wal_autocheckpoint_pages = *wal_autocheckpoint_pages;
+  }
+  return tuning;
+}
+
+WriteBehindOptions DatabaseConfig::ToWriteBehindOptions() const {
+  WriteBehindOptions options;
+  options.enabled = write_behind;
+  if (write_behind_max_pending > 0) {
+    options.max_pending_writes = static_cast<size_t>(write_behind_max_pending);
+  }
+  if (write_behind_delay_ms >= 0) {
+    options.max_delay = std::chrono::milliseconds(write_behind_delay_ms);
+  }
+  return options;
+}
+
+DatabaseConfig DatabaseConfig::FromJson(const nlohmann::json &json) {
+  DatabaseConfig config;
+  if (json.contains("profile") && json["profile"].is_string()) {
+    config.profile = json["profile"].get<std::string>();
+  }
+  if (json.contains("cacheSizeKiB") && json["cacheSizeKiB"].is_number_integer()) {
+    config.cache_size_kib = json["cacheSizeKiB"].get<int64_t>();
+  }
+  if (json.contains("mmapSizeMiB") && json["mmapSizeMiB"].is_number_integer()) {
+    config.mmap_size_mib = json["mmapSizeMiB"].get<int64_t>();
+  }
+  if (json.contains("synchronous") && json["synchronous"].is_string()) {
+    config.synchronous = json["synchronous"].get<std::string>();
+  }
+  if (json.contains("walAutoCheckpointPages") &&
+      json["walAutoCheckpointPages"].is_number_integer()) {
+    config.wal_autocheckpoint_pages = json["walAutoCheckpointPages"].get<int>();
+  }
+  if (json.contains("idleCheckpointSeconds") && json["idleCheckpointSeconds"].is_number_integer()) {
+    config.idle_checkpoint_seconds = json["idleCheckpointSeconds"].get<int>();
+  }
+  if (json.contains("optimizeIntervalMinutes") &&
+      json["optimizeIntervalMinutes"].is_number_integer()) {
+    config.optimize_interval_minutes = json["optimizeIntervalMinutes"].get<int>();
+  }
+  if (json.contains("writeBehind") && json["writeBehind"].is_boolean()) {
+    config.write_behind = json["writeBehind"].get<bool>();
+  }
+  if (json.contains("writeBehindMaxPending") && json["writeBehindMaxPending"].is_number_integer()) {
+    config.write_behind_max_pending = json["writeBehindMaxPending"].get<int>();
+  }
+  if (json.contains("writeBehindDelayMs") && json["writeBehindDelayMs"].is_number_integer()) {
+    config.write_behind_delay_ms = json["writeBehindDelayMs"].get<int>();
+  }
+  return config;
+}
+
+nlohmann::json DatabaseConfig::ToJson() const {
+  nlohmann::json json = nlohmann::json::object();
+  json["profile"] = profile;
+  if (cache_size_kib) {
+    json["cacheSizeKiB"] = *cache_size_kib;
+  }
+  if (mmap_size_mib) {
+    json["mmapSizeMiB"] = *mmap_size_mib;
+  }
+  if (synchronous) {
+    json["synchronous"] = *synchronous;
+  }
+  if (wal_autocheckpoint_pages) {
+    json["walAutoCheckpointPages"] = *wal_autocheckpoint_pages;
+  }
+  json["idleCheckpointSeconds"] = idle_checkpoint_seconds;
+  json["optimizeIntervalMinutes"] = optimize_interval_minutes;
+  json["writeBehind"] = write_behind;
+  json["writeBehindMaxPending"] = write_behind_max_pending;
+  json["writeBehindDelayMs"] = write_behind_delay_ms;
+  return json;
+}
+
+WriteBehindOptions FolderConfigWritesConfig::ToWriteBehindOptions() const {
+  WriteBehindOptions options;
+  options.enabled = write_behind;
+  if (write_behind_max_pending > 0) {
+    options.max_pending_writes = static_cast<size_t>(write_behind_max_pending);
+  }
+  if (write_behind_delay_ms >= 0) {
+    options.max_delay = std::chrono::milliseconds(write_behind_delay_ms);
+  }
+  return options;
+}
+
+FolderConfigWritesConfig FolderConfigWritesConfig::FromJson(const nlohmann::json &json) {
+  FolderConfigWritesConfig config;
+  if (json.contains("writeBehind") && json["writeBehind"].is_boolean()) {
+    config.write_behind = json["writeBehind"].get<bool>();
+  }
+  if (json.contains("writeBehindMaxPending") && json["writeBehindMaxPending"].is_number_integer()) {
+    config.write_behind_max_pending = json["writeBehindMaxPending"].get<int>();
+  }
+  if (json.contains("writeBehindDelayMs") && json["writeBehindDelayMs"].is_number_integer()) {
+    config.write_behind_delay_ms = json["writeBehindDelayMs"].get<int>();
+  }
+  return config;
+}
+
+nlohmann::json FolderConfigWritesConfig::ToJson() const {
+  nlohmann::json json = nlohmann::json::object();
+  json["writeBehind"] = write_behind;
+  json["writeBehindMaxPending"] = write_behind_max_pending;
+  json["writeBehindDelayMs"] = write_behind_delay_ms;
+  return json;
+}
+
 VxCoreConfig VxCoreConfig::FromJson(const nlohmann::json &json) {
   VxCoreConfig config;
   if (json.contains("version") && json["version"].is_string()) {
@@ -38,6 +174,12 @@ VxCoreConfig VxCoreConfig::FromJson(const nlohmann::json &json) {
   if (json.contains("autoSyncDebounceSeconds") && json["autoSyncDebounceSeconds"].is_number_integer()) {
     config.auto_sync_debounce_seconds = json["autoSyncDebounceSeconds"].get<int>();
   }
+  if (json.contains("database") && json["database"].is_object()) {
+    config.database = DatabaseConfig::FromJson(json["database"]);
+  }
+  if (json.contains("folderConfigWrites") && json["folderConfigWrites"].is_object()) {
+    config.folder_config_writes = FolderConfigWritesConfig::FromJson(json["folderConfigWrites"]);
+  }
   return config;
 }
 
@@ -48,6 +190,8 @@ nlohmann::json VxCoreConfig::ToJson() const {
   json["fileTypes"] = file_types.ToJson();
   json["recoverLastSession"] = recover_last_session;
   json["autoSyncDebounceSeconds"] = auto_sync_debounce_seconds;
+  json["database"] = database.ToJson();
+  json["folderConfigWrites"] = folder_config_writes.ToJson();
   return json;
 }
 
@@ -2,10 +2,13 @@
 #define VXCORE_VXCORE_CONFIG_H
 
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "db/db_tuning.h"
 #include "filetype_config.h"
+#include "metadata_store.h"
 
 namespace vxcore {
 
@@ -18,14 +21,67 @@ struct SearchConfig {
   nlohmann::json ToJson() const;
 };
 
+// SQLite tuning for every vxcore database ("database" in vxcore.json).
+// |profile| picks a db::DbTuning preset; the optional fields override single
+// settings of it. The two intervals drive vxcore_db_schedule_maintenance.
+// The write-behind fields configure notebook metadata stores (see
+// MetadataStore::SetWriteBehind).
+struct DatabaseConfig {
+  std::string profile;
+  std::optional<int64_t> cache_size_kib;
+  std::optional<int64_t> mmap_size_mib;
+  std::optional<std::string> synchronous;  // "off", "normal" or "full"
+  std::optional<int> wal_autocheckpoint_pages;
+  int idle_checkpoint_seconds;
+  int optimize_interval_minutes;
+  bool write_behind;
+  int write_behind_max_pending;
+  int write_behind_delay_ms;
+
+  DatabaseConfig()
+      : profile("balanced"),
+        idle_checkpoint_seconds(60),
+        optimize_interval_minutes(120),
+        write_behind(false),
+        write_behind_max_pending(256),
+        write_behind_delay_ms(500) {}
+
+  // Resolves the profile plus overrides; an unknown profile falls back to
+  // the default one.
+  db::DbTuning ToTuning() const;
+
+  WriteBehindOptions ToWriteBehindOptions() const;
+
+  static DatabaseConfig FromJson(const nlohmann::json &json);
+  nlohmann::json ToJson() const;
+};
+
+// Write-behind of notebook folder config files (vx.json),
+// "folderConfigWrites" in vxcore.json (see FolderManager::SetConfigWriteBehind).
+struct FolderConfigWritesConfig {
+  bool write_behind;
+  int write_behind_max_pending;
+  int write_behind_delay_ms;
+
+  FolderConfigWritesConfig()
+      : write_behind(false), write_behind_max_pending(256), write_behind_delay_ms(1000) {}
+
+  WriteBehindOptions ToWriteBehindOptions() const;
+
+  static FolderConfigWritesConfig FromJson(const nlohmann::json &json);
+  nlohmann::json ToJson() const;
+};
+
 struct VxCoreConfig {
   std::string version;
   SearchConfig search;
   FileTypesConfig file_types;
   bool recover_last_session;
   int auto_sync_debounce_seconds;
+  DatabaseConfig database;
+  FolderConfigWritesConfig folder_config_writes;
 
-  VxCoreConfig() : version("0.1.0"), search(), file_types(), recover_last_session(true), auto_sync_debounce_seconds(120) {}
+  VxCoreConfig() : version("0.1.0"), search(), file_types(), recover_last_session(true), auto_sync_debounce_seconds(120), database(), folder_config_writes() {}
 
   static VxCoreConfig FromJson(const nlohmann::json &json);
   nlohmann::json ToJson() const;
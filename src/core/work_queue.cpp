@@ -2,24 +2,149 @@
 
 namespace vxcore {
 
+uint64_t LatencyHistogram::BucketUpperBoundUs(size_t index) {
+  if (index + 1 >= kBucketCount) return 0;
+  return uint64_t{1} << index;
+}
+
+void LatencyHistogram::Record(std::chrono::steady_clock::duration elapsed) {
+  const auto us_signed = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  const uint64_t us = us_signed > 0 ? static_cast<uint64_t>(us_signed) : 0;
+
+  size_t index = 0;
+  for (uint64_t v = us; v != 0 && index + 1 < kBucketCount; v >>= 1) {
+    ++index;
+  }
+
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_us_.fetch_add(us, std::memory_order_relaxed);
+  buckets_[index].fetch_add(1, std::memory_order_relaxed);
+  uint64_t prev_max = max_us_.load(std::memory_order_relaxed);
+  while (us > prev_max &&
+         !max_us_.compare_exchange_weak(prev_max, us, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.total_us = total_us_.load(std::memory_order_relaxed);
+  snapshot.max_us = max_us_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+  count_.store(0, std::memory_order_relaxed);
+  total_us_.store(0, std::memory_order_relaxed);
+  max_us_.store(0, std::memory_order_relaxed);
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
 WorkQueue::WorkQueue() = default;
 
 WorkQueue::~WorkQueue() { Shutdown(); }
 
+std::unique_lock<std::mutex> WorkQueue::LockTimed() const {
+  const auto start = Clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  lock_wait_.Record(Clock::now() - start);
+  return lock;
+}
+
+void WorkQueue::RunEntry(Entry &entry) {
+  const auto start = Clock::now();
+  queue_latency_.Record(start - entry.enqueued_at);
+  entry.item();
+  run_time_.Record(Clock::now() - start);
+}
+
+void WorkQueue::PushLocked(WorkItem item) {
+  queue_.push_back({std::move(item), Clock::now()});
+  ++enqueued_;
+  if (queue_.size() > peak_size_) peak_size_ = queue_.size();
+}
+
+void WorkQueue::NotifyNotFull(size_t count) {
+  // Unconditional: notifying a condition variable nobody waits on is cheap,
+  // and waiters re-check IsFullLocked() under the lock anyway.
+  if (count == 0) return;
+  if (count == 1) {
+    not_full_cv_.notify_one();
+  } else {
+    not_full_cv_.notify_all();
+  }
+}
+
 bool WorkQueue::Enqueue(WorkItem item) {
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (shutdown_) return false;
-    queue_.push_back(std::move(item));
+    auto lock = LockTimed();
+    if (!shutdown_ && IsFullLocked()) {
+      switch (full_policy_) {
+        case QueueFullPolicy::kReject:
+          ++rejected_;
+          return false;
+        case QueueFullPolicy::kCallerRuns: {
+          ++caller_runs_;
+          lock.unlock();
+          const auto start = Clock::now();
+          item();
+          run_time_.Record(Clock::now() - start);
+          return true;
+        }
+        case QueueFullPolicy::kBlock:
+          ++full_waits_;
+          not_full_cv_.wait(lock, [this] { return shutdown_ || !IsFullLocked(); });
+          break;
+      }
+    }
+    if (shutdown_) {
+      ++rejected_;
+      return false;
+    }
+    PushLocked(std::move(item));
   }
   cv_.notify_one();
   return true;
 }
 
+EnqueueResult WorkQueue::TryEnqueue(WorkItem &item) {
+  {
+    auto lock = LockTimed();
+    if (shutdown_) {
+      ++rejected_;
+      return EnqueueResult::kShutdown;
+    }
+    if (IsFullLocked()) return EnqueueResult::kFull;
+    PushLocked(std::move(item));
+  }
+  cv_.notify_one();
+  return EnqueueResult::kQueued;
+}
+
+void WorkQueue::SetCapacity(size_t capacity, QueueFullPolicy policy) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    full_policy_ = policy;
+  }
+  // A raised (or removed) bound may unblock waiting producers.
+  not_full_cv_.notify_all();
+}
+
+size_t WorkQueue::Capacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
 bool WorkQueue::ProcessNext(int timeout_ms) {
-  WorkItem item;
+  Entry entry;
   {
-    std::unique_lock<std::mutex> lock(mutex_);
+    auto lock = LockTimed();
     if (timeout_ms <= 0) {
       cv_.wait(lock, [this] { return !queue_.empty() || shutdown_; });
     } else {
@@ -27,21 +152,29 @@ bool WorkQueue::ProcessNext(int timeout_ms) {
                    [this] { return !queue_.empty() || shutdown_; });
     }
     if (queue_.empty()) return false;
-    item = std::move(queue_.front());
+    entry = std::move(queue_.front());
     queue_.pop_front();
+    ++processed_;
+    ++processed_per_thread_[std::this_thread::get_id()];
   }
-  item();
+  NotifyNotFull(1);
+  RunEntry(entry);
   return true;
 }
 
 int WorkQueue::ProcessAll() {
-  std::deque<WorkItem> batch;
+  std::deque<Entry> batch;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockTimed();
     batch.swap(queue_);
+    processed_ += batch.size();
+    if (!batch.empty()) {
+      processed_per_thread_[std::this_thread::get_id()] += batch.size();
+    }
   }
-  for (auto &item : batch) {
-    item();
+  NotifyNotFull(batch.size());
+  for (auto &entry : batch) {
+    RunEntry(entry);
   }
   return static_cast<int>(batch.size());
 }
@@ -57,6 +190,7 @@ void WorkQueue::Shutdown() {
     shutdown_ = true;
   }
   cv_.notify_all();
+  not_full_cv_.notify_all();
 }
 
 bool WorkQueue::IsShutdown() const {
@@ -64,6 +198,43 @@ bool WorkQueue::IsShutdown() const {
   return shutdown_;
 }
 
+WorkQueueStats WorkQueue::GetStats() const {
+  WorkQueueStats stats;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.enqueued = enqueued_;
+    stats.processed = processed_;
+    stats.rejected = rejected_;
+    stats.caller_runs = caller_runs_;
+    stats.full_waits = full_waits_;
+    stats.size = queue_.size();
+    stats.peak_size = peak_size_;
+    stats.capacity = capacity_;
+    stats.processed_per_thread.assign(processed_per_thread_.begin(),
+                                      processed_per_thread_.end());
+  }
+  stats.queue_latency = queue_latency_.GetSnapshot();
+  stats.run_time = run_time_.GetSnapshot();
+  stats.lock_wait = lock_wait_.GetSnapshot();
+  return stats;
+}
+
+void WorkQueue::ResetStats() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enqueued_ = 0;
+    processed_ = 0;
+    rejected_ = 0;
+    caller_runs_ = 0;
+    full_waits_ = 0;
+    peak_size_ = queue_.size();
+    processed_per_thread_.clear();
+  }
+  queue_latency_.Reset();
+  run_time_.Reset();
+  lock_wait_.Reset();
+}
+
 WorkQueueManager::WorkQueueManager() = default;
 
 WorkQueueManager::~WorkQueueManager() { ShutdownAll(); }
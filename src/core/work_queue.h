@@ -1,14 +1,20 @@
 #ifndef VXCORE_WORK_QUEUE_H
 #define VXCORE_WORK_QUEUE_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "vxcore/vxcore_types.h"
 
@@ -16,6 +22,71 @@ namespace vxcore {
 
 using WorkItem = std::function<void()>;
 
+// Lock-free log2 latency histogram in microseconds. Bucket 0 counts samples
+// below 1us; bucket i (i >= 1) counts [2^(i-1), 2^i) us; the last bucket also
+// absorbs everything above its lower bound.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBucketCount = 24;
+
+  struct Snapshot {
+    uint64_t count = 0;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+    std::array<uint64_t, kBucketCount> buckets{};
+  };
+
+  // Exclusive upper bound of bucket i in microseconds (0 for the open-ended
+  // last bucket).
+  VXCORE_API static uint64_t BucketUpperBoundUs(size_t index);
+
+  VXCORE_API void Record(std::chrono::steady_clock::duration elapsed);
+
+  VXCORE_API Snapshot GetSnapshot() const;
+
+  VXCORE_API void Reset();
+
+ private:
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> total_us_{0};
+  std::atomic<uint64_t> max_us_{0};
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+};
+
+// What Enqueue does when a bounded queue is full.
+enum class QueueFullPolicy {
+  // Wait until a consumer frees a slot (or the queue shuts down). Never use
+  // from a thread that is the queue's only consumer.
+  kBlock = 0,
+  // Refuse the item; Enqueue returns false.
+  kReject = 1,
+  // Run the item synchronously on the producing thread.
+  kCallerRuns = 2,
+};
+
+enum class EnqueueResult { kQueued, kFull, kShutdown };
+
+struct WorkQueueStats {
+  uint64_t enqueued = 0;
+  uint64_t processed = 0;
+  uint64_t rejected = 0;
+  // Items a full queue ran on the producer thread (kCallerRuns).
+  uint64_t caller_runs = 0;
+  // Enqueue calls that had to wait for a free slot (kBlock).
+  uint64_t full_waits = 0;
+  size_t size = 0;
+  size_t peak_size = 0;
+  // 0 when unbounded.
+  size_t capacity = 0;
+  // Enqueue until a consumer starts running the item.
+  LatencyHistogram::Snapshot queue_latency;
+  // Time spent inside the work item.
+  LatencyHistogram::Snapshot run_time;
+  // Time spent acquiring the queue mutex (Enqueue/ProcessNext/ProcessAll).
+  LatencyHistogram::Snapshot lock_wait;
+  std::vector<std::pair<std::thread::id, uint64_t>> processed_per_thread;
+};
+
 class WorkQueue {
  public:
   VXCORE_API WorkQueue();
@@ -24,8 +95,21 @@ class WorkQueue {
   WorkQueue(const WorkQueue &) = delete;
   WorkQueue &operator=(const WorkQueue &) = delete;
 
+  // Returns false if the item was not accepted: after shutdown, or when a
+  // bounded queue is full under QueueFullPolicy::kReject. Under kBlock it may
+  // wait; under kCallerRuns it may run |item| before returning true.
   VXCORE_API bool Enqueue(WorkItem item);
 
+  // Never blocks and never runs the item. |item| is moved from only on
+  // kQueued, so a producer that gets kFull can help drain and retry.
+  VXCORE_API EnqueueResult TryEnqueue(WorkItem &item);
+
+  // Bound the number of pending items; 0 (the default) means unbounded.
+  // Items already queued beyond a lowered capacity are kept.
+  VXCORE_API void SetCapacity(size_t capacity, QueueFullPolicy policy = QueueFullPolicy::kBlock);
+
+  VXCORE_API size_t Capacity() const;
+
   VXCORE_API bool ProcessNext(int timeout_ms);
 
   VXCORE_API int ProcessAll();
@@ -36,11 +120,57 @@ class WorkQueue {
 
   VXCORE_API bool IsShutdown() const;
 
+  // Contention and latency counters, recorded for every item. Cheap enough
+  // to leave on: two steady_clock reads per lock and per item.
+  VXCORE_API WorkQueueStats GetStats() const;
+
+  VXCORE_API void ResetStats();
+
  private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    WorkItem item;
+    Clock::time_point enqueued_at;
+  };
+
+  // Acquires mutex_ and records how long the acquisition took.
+  std::unique_lock<std::mutex> LockTimed() const;
+
+  void RunEntry(Entry &entry);
+
+  // Requires mutex_.
+  bool IsFullLocked() const { return capacity_ > 0 && queue_.size() >= capacity_; }
+
+  // Requires mutex_; shutdown_ must be false.
+  void PushLocked(WorkItem item);
+
+  // Wakes producers blocked on a full queue after consumers took |count| items.
+  void NotifyNotFull(size_t count);
+
   mutable std::mutex mutex_;
+  // Signalled when an item is queued (consumers wait on it).
   std::condition_variable cv_;
-  std::deque<WorkItem> queue_;
+  // Signalled when a slot frees up (kBlock producers wait on it).
+  std::condition_variable not_full_cv_;
+  std::deque<Entry> queue_;
   bool shutdown_ = false;
+  size_t capacity_ = 0;
+  QueueFullPolicy full_policy_ = QueueFullPolicy::kBlock;
+
+  // Guarded by mutex_.
+  uint64_t enqueued_ = 0;
+  uint64_t processed_ = 0;
+  uint64_t rejected_ = 0;
+  uint64_t caller_runs_ = 0;
+  uint64_t full_waits_ = 0;
+  size_t peak_size_ = 0;
+  std::unordered_map<std::thread::id, uint64_t> processed_per_thread_;
+
+  // Lock-free; updated outside mutex_ where possible.
+  LatencyHistogram queue_latency_;
+  LatencyHistogram run_time_;
+  mutable LatencyHistogram lock_wait_;
 };
 
 class WorkQueueManager {
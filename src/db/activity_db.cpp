@@ -48,7 +48,10 @@ bool IsValidDailyColumn(const std::string& column) {
 
 }  // namespace
 
-ActivityDb::ActivityDb(sqlite3* db) : db_(db) {}
+ActivityDb::ActivityDb(sqlite3* db, StatementCache* cache)
+    : db_(db),
+      owned_cache_(cache ? nullptr : std::make_unique<StatementCache>(db)),
+      cache_(cache ? cache : owned_cache_.get()) {}
 
 std::string ActivityDb::GetLastError() const {
   if (db_ != nullptr) {
@@ -62,21 +65,13 @@ bool ActivityDb::InitializeSchema() {
     return false;
   }
 
-  // activity.db is a best-effort, per-device cache. Under WAL, synchronous=
-  // NORMAL is safe (no corruption on app crash, only a small window of the last
-  // transactions may be lost on OS/power failure) and avoids an fsync per
-  // commit -- important since flushes run on the UI thread.
+  // synchronous (NORMAL under the default "balanced" profile, which keeps
+  // flushes on the UI thread free of per-commit fsyncs) comes from the tuning
+  // DbManager applied when it opened activity.db.
   char* err_msg = nullptr;
-  int rc = sqlite3_exec(db_, "PRAGMA synchronous = NORMAL;", nullptr, nullptr, &err_msg);
-  if (rc != SQLITE_OK) {
-    VXCORE_LOG_WARN("activity: failed to set synchronous=NORMAL: %s",
-                    err_msg ? err_msg : GetLastError().c_str());
-    if (err_msg) sqlite3_free(err_msg);
-    err_msg = nullptr;
-  }
 
   // Create the version table first so we can read/branch on it.
-  rc = sqlite3_exec(db_, kCreateSchemaVersionTable, nullptr, nullptr, &err_msg);
+  int rc = sqlite3_exec(db_, kCreateSchemaVersionTable, nullptr, nullptr, &err_msg);
   if (rc != SQLITE_OK) {
     VXCORE_LOG_ERROR("activity: failed to create schema_version: %s",
                      err_msg ? err_msg : GetLastError().c_str());
@@ -127,15 +122,14 @@ bool ActivityDb::InitializeSchema() {
 int ActivityDb::GetSchemaVersion() {
   if (!db_) return 0;
   const char* sql = "SELECT version FROM schema_version LIMIT 1;";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return 0;
   }
   int version = 0;
   if (sqlite3_step(stmt) == SQLITE_ROW) {
     version = sqlite3_column_int(stmt, 0);
   }
-  sqlite3_finalize(stmt);
   return version;
 }
 
@@ -148,13 +142,12 @@ bool ActivityDb::SetSchemaVersion(int version) {
     return false;
   }
   const char* sql = "INSERT INTO schema_version (version) VALUES (?);";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
   sqlite3_bind_int(stmt, 1, version);
   int rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
   return rc == SQLITE_DONE;
 }
 
@@ -163,14 +156,13 @@ bool ActivityDb::AddFocusTime(const std::string& date, int64_t delta_ms) {
   const char* sql =
       "INSERT INTO activity_daily (date, active_ms) VALUES (?, ?) "
       "ON CONFLICT(date) DO UPDATE SET active_ms = active_ms + excluded.active_ms;";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
   sqlite3_bind_text(stmt, 1, date.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_int64(stmt, 2, delta_ms);
   int rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
   return rc == SQLITE_DONE;
 }
 
@@ -180,14 +172,13 @@ bool ActivityDb::IncrementDaily(const std::string& date, const std::string& colu
   std::string sql = "INSERT INTO activity_daily (date, " + column + ") VALUES (?, ?) " +
                     "ON CONFLICT(date) DO UPDATE SET " + column + " = " + column +
                     " + excluded." + column + ";";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
   sqlite3_bind_text(stmt, 1, date.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_int64(stmt, 2, delta);
   int rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
   return rc == SQLITE_DONE;
 }
 
@@ -202,8 +193,8 @@ bool ActivityDb::UpsertFileActivity(const std::string& date, const std::string&
       "reads = reads + excluded.reads, "
       "edits = edits + excluded.edits, "
       "path = excluded.path;";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
   sqlite3_bind_text(stmt, 1, date.c_str(), -1, SQLITE_TRANSIENT);
@@ -213,7 +204,6 @@ bool ActivityDb::UpsertFileActivity(const std::string& date, const std::string&
   sqlite3_bind_int64(stmt, 5, reads);
   sqlite3_bind_int64(stmt, 6, edits);
   int rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
   return rc == SQLITE_DONE;
 }
 
@@ -222,15 +212,14 @@ bool ActivityDb::UpdateFilePath(const std::string& notebook_id, const std::strin
   if (!db_ || notebook_id.empty() || file_id.empty()) return false;
   const char* sql =
       "UPDATE file_activity_daily SET path = ? WHERE notebook_id = ? AND file_id = ?;";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
   sqlite3_bind_text(stmt, 1, path.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_text(stmt, 2, notebook_id.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_text(stmt, 3, file_id.c_str(), -1, SQLITE_TRANSIENT);
   int rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
   return rc == SQLITE_DONE;
 }
 
@@ -248,8 +237,8 @@ std::string ActivityDb::GetRange(const std::string& from_date, const std::string
   const char* sql =
       "SELECT date, active_ms, notes_created, notes_read, notes_edited "
       "FROM activity_daily WHERE date >= ? AND date <= ? ORDER BY date ASC;";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return out.dump();
   }
   sqlite3_bind_text(stmt, 1, from_date.c_str(), -1, SQLITE_TRANSIENT);
@@ -273,7 +262,6 @@ std::string ActivityDb::GetRange(const std::string& from_date, const std::string
     sum_read += read;
     sum_edited += edited;
   }
-  sqlite3_finalize(stmt);
 
   out["activeMs"] = sum_active;
   out["notesCreated"] = sum_created;
@@ -302,8 +290,8 @@ std::string ActivityDb::GetHotFiles(const std::string& from_date, const std::str
       "GROUP BY notebook_id, file_id "
       "ORDER BY (SUM(reads) + SUM(edits)) DESC, last_path ASC "
       "LIMIT ?;";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return out.dump();
   }
   sqlite3_bind_text(stmt, 1, from_date.c_str(), -1, SQLITE_TRANSIENT);
@@ -323,7 +311,6 @@ std::string ActivityDb::GetHotFiles(const std::string& from_date, const std::str
     f["score"] = reads + edits;
     out["files"].push_back(f);
   }
-  sqlite3_finalize(stmt);
   return out.dump();
 }
 
@@ -340,8 +327,8 @@ std::string ActivityDb::GetFileHistory(const std::string& notebook_id,
   const char* sql =
       "SELECT date, reads, edits, path FROM file_activity_daily "
       "WHERE notebook_id = ? AND file_id = ? ORDER BY date ASC;";
-  sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return out.dump();
   }
   sqlite3_bind_text(stmt, 1, notebook_id.c_str(), -1, SQLITE_TRANSIENT);
@@ -361,12 +348,34 @@ std::string ActivityDb::GetFileHistory(const std::string& notebook_id,
     total_reads += reads;
     total_edits += edits;
   }
-  sqlite3_finalize(stmt);
 
   out["totalReads"] = total_reads;
   out["totalEdits"] = total_edits;
   return out.dump();
 }
 
+bool ActivityDb::ForEachFileActivity(const std::string& from_date,
+                                     const FileActivityFn& callback) {
+  if (!db_) return false;
+  // Range scan on the primary key (date leads it).
+  const char* sql =
+      "SELECT date, notebook_id, file_id, reads, edits FROM file_activity_daily "
+      "WHERE date >= ?;";
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return false;
+  }
+  sqlite3_bind_text(stmt, 1, from_date.c_str(), -1, SQLITE_TRANSIENT);
+
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    callback(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+             reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+             reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),
+             sqlite3_column_int64(stmt, 3), sqlite3_column_int64(stmt, 4));
+  }
+  return rc == SQLITE_DONE;
+}
+
 }  // namespace db
 }  // namespace vxcore
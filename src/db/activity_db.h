@@ -2,8 +2,12 @@
 #define VXCORE_ACTIVITY_DB_H
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 
+#include "statement_cache.h"
+
 // Forward declare sqlite3 to avoid exposing SQLite types in header
 struct sqlite3;
 
@@ -25,7 +29,8 @@ namespace db {
 // NOT thread-safe: caller must ensure single-threaded access.
 class ActivityDb {
  public:
-  explicit ActivityDb(sqlite3* db);
+  // |cache| should be the owning DbManager's statement cache (null: private).
+  explicit ActivityDb(sqlite3* db, StatementCache* cache = nullptr);
   ~ActivityDb() = default;
 
   // Disable copy/move
@@ -79,6 +84,16 @@ class ActivityDb {
   //  "daily":[{"date","reads","edits","path"}]}
   std::string GetFileHistory(const std::string& notebook_id, const std::string& file_id);
 
+  // --- Scans ---
+
+  // Calls |callback| with every per-file row dated |from_date| or later:
+  // (date, notebook_id, file_id, reads, edits). Used to seed in-memory
+  // rankings on startup.
+  using FileActivityFn =
+      std::function<void(const std::string& date, const std::string& notebook_id,
+                         const std::string& file_id, int64_t reads, int64_t edits)>;
+  bool ForEachFileActivity(const std::string& from_date, const FileActivityFn& callback);
+
   // Returns the last SQLite error message.
   std::string GetLastError() const;
 
@@ -87,6 +102,8 @@ class ActivityDb {
   bool SetSchemaVersion(int version);
 
   sqlite3* db_;
+  std::unique_ptr<StatementCache> owned_cache_;
+  StatementCache* cache_;
 };
 
 }  // namespace db
@@ -0,0 +1,475 @@
+#include "bulk_loader.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+#include "db_schema.h"
+#include "statement_cache.h"
+#include "utils/logger.h"
+
+namespace vxcore {
+namespace db {
+
+namespace {
+
+// "<head> VALUES (?, ...), (?, ...), ..." with |rows| tuples of |columns|.
+std::string MultiRowInsertSql(const char* head, size_t columns, size_t rows) {
+  std::string tuple = "(";
+  for (size_t c = 0; c < columns; ++c) {
+    tuple += c == 0 ? "?" : ", ?";
+  }
+  tuple += ")";
+
+  std::string sql = head;
+  sql += " VALUES ";
+  for (size_t r = 0; r < rows; ++r) {
+    if (r > 0) {
+      sql += ", ";
+    }
+    sql += tuple;
+  }
+  sql += ";";
+  return sql;
+}
+
+// The full-batch insert is reused for every batch, so it is cached; the
+// shorter tail is prepared once per flush and not cached, so the varying
+// remainders of successive loads do not pile up in the shared cache.
+ScopedStatement PrepareBatchInsert(StatementCache* cache, const char* head, size_t columns,
+                                   size_t rows) {
+  const std::string sql = MultiRowInsertSql(head, columns, rows);
+  return rows == BulkLoader::kBatchRows ? cache->Acquire(sql) : cache->PrepareUncached(sql);
+}
+
+void BindOptionalId(sqlite3_stmt* stmt, int index, int64_t id) {
+  if (id == -1) {
+    sqlite3_bind_null(stmt, index);
+  } else {
+    sqlite3_bind_int64(stmt, index, id);
+  }
+}
+
+}  // namespace
+
+BulkLoader::BulkLoader(sqlite3* db, StatementCache* cache) : db_(db), cache_(cache) {}
+
+BulkLoader::~BulkLoader() {
+  if (active_) {
+    Abort();
+  }
+}
+
+bool BulkLoader::Exec(const char* sql) {
+  char* err_msg = nullptr;
+  int rc = sqlite3_exec(db_, sql, nullptr, nullptr, &err_msg);
+  if (rc != SQLITE_OK) {
+    last_error_ = err_msg ? err_msg : sqlite3_errmsg(db_);
+    if (err_msg) {
+      sqlite3_free(err_msg);
+    }
+    return false;
+  }
+  return true;
+}
+
+int64_t BulkLoader::QueryMaxId(const char* table) {
+  std::string sql = std::string("SELECT COALESCE(MAX(id), 0) FROM ") + table + ";";
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt || sqlite3_step(stmt) != SQLITE_ROW) {
+    last_error_ = sqlite3_errmsg(db_);
+    return -1;
+  }
+  return sqlite3_column_int64(stmt, 0);
+}
+
+bool BulkLoader::Begin() {
+  if (active_) {
+    last_error_ = "Bulk load already active";
+    return false;
+  }
+  if (!db_) {
+    last_error_ = "Database not open";
+    return false;
+  }
+  // PRAGMA foreign_keys is a no-op inside a transaction, and the load relies
+  // on it being off.
+  if (!sqlite3_get_autocommit(db_)) {
+    last_error_ = "Bulk load cannot run inside an open transaction";
+    return false;
+  }
+
+  const int64_t max_folder_id = QueryMaxId("folders");
+  const int64_t max_file_id = QueryMaxId("files");
+  const int64_t max_tag_id = QueryMaxId("tags");
+  if (max_folder_id < 0 || max_file_id < 0 || max_tag_id < 0) {
+    return false;
+  }
+  if (max_folder_id > 0 || max_file_id > 0) {
+    last_error_ = "Bulk load requires empty folders and files tables";
+    return false;
+  }
+
+  {
+    ScopedStatement stmt = cache_->Acquire("PRAGMA foreign_keys;");
+    restore_foreign_keys_ = stmt && sqlite3_step(stmt) == SQLITE_ROW &&
+                            sqlite3_column_int(stmt, 0) != 0;
+  }
+  if (restore_foreign_keys_ && !Exec("PRAGMA foreign_keys = OFF;")) {
+    restore_foreign_keys_ = false;
+    return false;
+  }
+
+  if (!Exec("BEGIN TRANSACTION;")) {
+    if (restore_foreign_keys_) {
+      Exec("PRAGMA foreign_keys = ON;");
+      restore_foreign_keys_ = false;
+    }
+    return false;
+  }
+  active_ = true;
+
+  for (const char* index : schema::kSecondaryIndexNames) {
+    std::string sql = std::string("DROP INDEX IF EXISTS ") + index + ";";
+    if (!Exec(sql.c_str())) {
+      Abort();
+      return false;
+    }
+  }
+
+  // Metadata key indexes are not in the schema scripts; keep their
+  // definitions to recreate them in Finish().
+  metadata_index_sql_.clear();
+  std::vector<std::string> metadata_index_names;
+  {
+    ScopedStatement stmt = cache_->Acquire(
+        "SELECT name, sql FROM sqlite_master WHERE type = 'index' AND sql IS NOT NULL "
+        "AND (substr(name, 1, ?1) = ?2 OR substr(name, 1, ?3) = ?4);");
+    if (!stmt) {
+      last_error_ = sqlite3_errmsg(db_);
+      Abort();
+      return false;
+    }
+    const std::string files_prefix = schema::kFilesMetadataIndexPrefix;
+    const std::string folders_prefix = schema::kFoldersMetadataIndexPrefix;
+    sqlite3_bind_int(stmt, 1, static_cast<int>(files_prefix.size()));
+    sqlite3_bind_text(stmt, 2, files_prefix.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 3, static_cast<int>(folders_prefix.size()));
+    sqlite3_bind_text(stmt, 4, folders_prefix.c_str(), -1, SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      metadata_index_names.emplace_back(
+          reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+      metadata_index_sql_.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+    }
+  }
+  for (const auto& name : metadata_index_names) {
+    const std::string sql = "DROP INDEX IF EXISTS " + name + ";";
+    if (!Exec(sql.c_str())) {
+      Abort();
+      return false;
+    }
+  }
+
+  folder_ids_.clear();
+  file_uuids_.clear();
+  tag_ids_.clear();
+  {
+    ScopedStatement stmt = cache_->Acquire("SELECT id, name FROM tags;");
+    if (!stmt) {
+      last_error_ = sqlite3_errmsg(db_);
+      Abort();
+      return false;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      tag_ids_.emplace(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                       sqlite3_column_int64(stmt, 0));
+    }
+  }
+  next_folder_id_ = 1;
+  next_file_id_ = 1;
+  next_tag_id_ = max_tag_id + 1;
+  return true;
+}
+
+bool BulkLoader::AddFolder(const std::string& uuid, const std::string& parent_uuid,
+                           const std::string& name, int64_t created_utc, int64_t modified_utc,
+                           const std::string& metadata) {
+  if (!active_) {
+    last_error_ = "Bulk load not active";
+    return false;
+  }
+
+  int64_t parent_id = -1;
+  if (!parent_uuid.empty()) {
+    auto it = folder_ids_.find(parent_uuid);
+    if (it == folder_ids_.end()) {
+      last_error_ = "Parent folder not found: " + parent_uuid;
+      return false;
+    }
+    parent_id = it->second;
+  }
+
+  auto [it, inserted] = folder_ids_.emplace(uuid, next_folder_id_);
+  if (!inserted) {
+    last_error_ = "Duplicate folder id: " + uuid;
+    return false;
+  }
+
+  pending_folders_.push_back(
+      {next_folder_id_++, parent_id, uuid, name, created_utc, modified_utc, metadata});
+  if (pending_folders_.size() >= kBatchRows) {
+    return FlushFolders();
+  }
+  return true;
+}
+
+int64_t BulkLoader::ResolveTag(const std::string& name) {
+  auto [it, inserted] = tag_ids_.emplace(name, next_tag_id_);
+  if (inserted) {
+    pending_tags_.push_back({next_tag_id_++, name});
+  }
+  return it->second;
+}
+
+bool BulkLoader::AddFile(const std::string& uuid, const std::string& folder_uuid,
+                         const std::string& name, int64_t created_utc, int64_t modified_utc,
+                         const std::string& metadata, const std::vector<std::string>& tags,
+                         const std::vector<std::string>& attachments) {
+  if (!active_) {
+    last_error_ = "Bulk load not active";
+    return false;
+  }
+
+  auto folder_it = folder_ids_.find(folder_uuid);
+  if (folder_it == folder_ids_.end()) {
+    last_error_ = "Parent folder not found: " + folder_uuid;
+    return false;
+  }
+  const int64_t folder_id = folder_it->second;
+
+  if (!file_uuids_.insert(uuid).second) {
+    last_error_ = "Duplicate file id: " + uuid;
+    return false;
+  }
+
+  FileRow row{next_file_id_++, folder_id, uuid, name, created_utc, modified_utc, metadata, {}};
+  if (!attachments.empty()) {
+    row.attachments = nlohmann::json(attachments).dump();
+  }
+  for (const auto& tag : tags) {
+    pending_file_tags_.emplace_back(row.id, ResolveTag(tag));
+  }
+  pending_files_.push_back(std::move(row));
+
+  if (pending_tags_.size() >= kBatchRows && !FlushTags()) {
+    return false;
+  }
+  if (pending_files_.size() >= kBatchRows && !FlushFiles()) {
+    return false;
+  }
+  if (pending_file_tags_.size() >= kBatchRows && !FlushFileTags()) {
+    return false;
+  }
+  return true;
+}
+
+bool BulkLoader::FlushAll() {
+  return FlushFolders() && FlushTags() && FlushFiles() && FlushFileTags();
+}
+
+bool BulkLoader::FlushFolders() {
+  // Rows keep insertion order, so a parent row always precedes its children
+  // and the path trigger can read the parent's path.
+  const char* head =
+      "INSERT INTO folders (id, parent_id, uuid, name, created_utc, modified_utc, metadata)";
+  size_t begin = 0;
+  while (begin < pending_folders_.size()) {
+    const size_t rows = std::min(kBatchRows, pending_folders_.size() - begin);
+    ScopedStatement stmt = PrepareBatchInsert(cache_, head, 7, rows);
+    if (!stmt) {
+      last_error_ = sqlite3_errmsg(db_);
+      return false;
+    }
+    int index = 1;
+    for (size_t i = begin; i < begin + rows; ++i) {
+      const FolderRow& row = pending_folders_[i];
+      sqlite3_bind_int64(stmt, index++, row.id);
+      BindOptionalId(stmt, index++, row.parent_id);
+      sqlite3_bind_text(stmt, index++, row.uuid.c_str(), -1, SQLITE_STATIC);
+      sqlite3_bind_text(stmt, index++, row.name.c_str(), -1, SQLITE_STATIC);
+      sqlite3_bind_int64(stmt, index++, row.created_utc);
+      sqlite3_bind_int64(stmt, index++, row.modified_utc);
+      sqlite3_bind_text(stmt, index++, row.metadata.c_str(), -1, SQLITE_STATIC);
+    }
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      last_error_ = sqlite3_errmsg(db_);
+      return false;
+    }
+    begin += rows;
+  }
+  pending_folders_.clear();
+  return true;
+}
+
+bool BulkLoader::FlushTags() {
+  const char* head = "INSERT INTO tags (id, name, parent_id, metadata)";
+  size_t begin = 0;
+  while (begin < pending_tags_.size()) {
+    const size_t rows = std::min(kBatchRows, pending_tags_.size() - begin);
+    ScopedStatement stmt = PrepareBatchInsert(cache_, head, 4, rows);
+    if (!stmt) {
+      last_error_ = sqlite3_errmsg(db_);
+      return false;
+    }
+    int index = 1;
+    for (size_t i = begin; i < begin + rows; ++i) {
+      const TagRow& row = pending_tags_[i];
+      sqlite3_bind_int64(stmt, index++, row.id);
+      sqlite3_bind_text(stmt, index++, row.name.c_str(), -1, SQLITE_STATIC);
+      sqlite3_bind_null(stmt, index++);
+      sqlite3_bind_text(stmt, index++, "", -1, SQLITE_STATIC);
+    }
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      last_error_ = sqlite3_errmsg(db_);
+      return false;
+    }
+    begin += rows;
+  }
+  pending_tags_.clear();
+  return true;
+}
+
+bool BulkLoader::FlushFiles() {
+  const char* head =
+      "INSERT INTO files (id, folder_id, uuid, name, created_utc, modified_utc, metadata, "
+      "attachments)";
+  size_t begin = 0;
+  while (begin < pending_files_.size()) {
+    const size_t rows = std::min(kBatchRows, pending_files_.size() - begin);
+    ScopedStatement stmt = PrepareBatchInsert(cache_, head, 8, rows);
+    if (!stmt) {
+      last_error_ = sqlite3_errmsg(db_);
+      return false;
+    }
+    int index = 1;
+    for (size_t i = begin; i < begin + rows; ++i) {
+      const FileRow& row = pending_files_[i];
+      sqlite3_bind_int64(stmt, index++, row.id);
+      sqlite3_bind_int64(stmt, index++, row.folder_id);
+      sqlite3_bind_text(stmt, index++, row.uuid.c_str(), -1, SQLITE_STATIC);
+      sqlite3_bind_text(stmt, index++, row.name.c_str(), -1, SQLITE_STATIC);
+      sqlite3_bind_int64(stmt, index++, row.created_utc);
+      sqlite3_bind_int64(stmt, index++, row.modified_utc);
+      sqlite3_bind_text(stmt, index++, row.metadata.c_str(), -1, SQLITE_STATIC);
+      if (row.attachments.empty()) {
+        sqlite3_bind_null(stmt, index++);
+      } else {
+        sqlite3_bind_text(stmt, index++, row.attachments.c_str(), -1, SQLITE_STATIC);
+      }
+    }
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      last_error_ = sqlite3_errmsg(db_);
+      return false;
+    }
+    begin += rows;
+  }
+  pending_files_.clear();
+  return true;
+}
+
+bool BulkLoader::FlushFileTags() {
+  // OR IGNORE: a file listing the same tag twice gets one link.
+  const char* head = "INSERT OR IGNORE INTO file_tags (file_id, tag_id)";
+  size_t begin = 0;
+  while (begin < pending_file_tags_.size()) {
+    const size_t rows = std::min(kBatchRows, pending_file_tags_.size() - begin);
+    ScopedStatement stmt = PrepareBatchInsert(cache_, head, 2, rows);
+    if (!stmt) {
+      last_error_ = sqlite3_errmsg(db_);
+      return false;
+    }
+    int index = 1;
+    for (size_t i = begin; i < begin + rows; ++i) {
+      sqlite3_bind_int64(stmt, index++, pending_file_tags_[i].first);
+      sqlite3_bind_int64(stmt, index++, pending_file_tags_[i].second);
+    }
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      last_error_ = sqlite3_errmsg(db_);
+      return false;
+    }
+    begin += rows;
+  }
+  pending_file_tags_.clear();
+  return true;
+}
+
+bool BulkLoader::Finish() {
+  if (!active_) {
+    last_error_ = "Bulk load not active";
+    return false;
+  }
+
+  if (!FlushAll()) {
+    VXCORE_LOG_ERROR("BulkLoader: flush failed: %s", last_error_.c_str());
+    Abort();
+    return false;
+  }
+
+  // Recreates the dropped indexes; everything else in it already exists.
+  const std::string init_script = schema::GetInitializationScript();
+  if (!Exec(init_script.c_str())) {
+    VXCORE_LOG_ERROR("BulkLoader: index rebuild failed: %s", last_error_.c_str());
+    Abort();
+    return false;
+  }
+  for (const auto& sql : metadata_index_sql_) {
+    if (!Exec(sql.c_str())) {
+      VXCORE_LOG_ERROR("BulkLoader: metadata index rebuild failed: %s", last_error_.c_str());
+      Abort();
+      return false;
+    }
+  }
+  metadata_index_sql_.clear();
+
+  if (!Exec("COMMIT;")) {
+    VXCORE_LOG_ERROR("BulkLoader: commit failed: %s", last_error_.c_str());
+    Abort();
+    return false;
+  }
+  active_ = false;
+
+  if (restore_foreign_keys_) {
+    Exec("PRAGMA foreign_keys = ON;");
+    restore_foreign_keys_ = false;
+  }
+
+  VXCORE_LOG_DEBUG("BulkLoader: loaded %zu folders, %zu files", folder_ids_.size(),
+                   file_uuids_.size());
+  return true;
+}
+
+void BulkLoader::Abort() {
+  pending_folders_.clear();
+  pending_tags_.clear();
+  pending_files_.clear();
+  pending_file_tags_.clear();
+
+  if (active_) {
+    const std::string error = last_error_;
+    Exec("ROLLBACK;");
+    last_error_ = error;
+    active_ = false;
+  }
+  if (restore_foreign_keys_) {
+    Exec("PRAGMA foreign_keys = ON;");
+    restore_foreign_keys_ = false;
+  }
+  folder_ids_.clear();
+  file_uuids_.clear();
+  tag_ids_.clear();
+  metadata_index_sql_.clear();
+}
+
+}  // namespace db
+}  // namespace vxcore
@@ -0,0 +1,138 @@
+#ifndef VXCORE_BULK_LOADER_H
+#define VXCORE_BULK_LOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Forward declare sqlite3
+struct sqlite3;
+
+namespace vxcore {
+namespace db {
+
+class StatementCache;
+
+// Fast path for filling empty folders/files tables in one go (cache rebuild).
+//
+// Compared with CreateOrUpdateFolder/CreateOrUpdateFile + SetFileTags per
+// record, the loader:
+//   - assigns row ids itself and resolves parent folders and tags through
+//     in-memory maps, so nothing is read back from the database;
+//   - buffers rows and writes them with cached multi-row INSERTs;
+//   - drops the secondary indexes (metadata key indexes included) for the
+//     duration of the load and rebuilds them once at the end, and disables
+//     per-row foreign key checks.
+//
+// Usage: Begin(), AddFolder()/AddFile() in parent-before-child order, then
+// Finish() (or Abort()). Everything happens in one transaction. A record that
+// references an unknown parent or repeats a UUID is rejected (returns false)
+// and the load continues.
+//
+// NOT thread-safe.
+class BulkLoader {
+ public:
+  // Rows per multi-row INSERT; keeps bound parameters well below SQLite's
+  // default limit for every table.
+  static constexpr size_t kBatchRows = 256;
+
+  BulkLoader(sqlite3* db, StatementCache* cache);
+  ~BulkLoader();
+
+  BulkLoader(const BulkLoader&) = delete;
+  BulkLoader& operator=(const BulkLoader&) = delete;
+
+  // Starts the load. Fails unless the folders and files tables are empty.
+  // Existing tags are kept and reused by name.
+  bool Begin();
+
+  // |parent_uuid| empty means a top-level folder.
+  bool AddFolder(const std::string& uuid, const std::string& parent_uuid, const std::string& name,
+                 int64_t created_utc, int64_t modified_utc, const std::string& metadata);
+
+  // |folder_uuid| must name a folder added earlier. Unknown tags are created.
+  bool AddFile(const std::string& uuid, const std::string& folder_uuid, const std::string& name,
+               int64_t created_utc, int64_t modified_utc, const std::string& metadata,
+               const std::vector<std::string>& tags,
+               const std::vector<std::string>& attachments);
+
+  // Flushes pending rows, rebuilds indexes, and commits.
+  bool Finish();
+
+  // Rolls back everything since Begin(). Called by the destructor if the load
+  // is still active.
+  void Abort();
+
+  bool IsActive() const { return active_; }
+  size_t GetFolderCount() const { return folder_ids_.size(); }
+  size_t GetFileCount() const { return file_uuids_.size(); }
+
+  std::string GetLastError() const { return last_error_; }
+
+ private:
+  struct FolderRow {
+    int64_t id;
+    int64_t parent_id;  // -1 for NULL
+    std::string uuid;
+    std::string name;
+    int64_t created_utc;
+    int64_t modified_utc;
+    std::string metadata;
+  };
+
+  struct FileRow {
+    int64_t id;
+    int64_t folder_id;
+    std::string uuid;
+    std::string name;
+    int64_t created_utc;
+    int64_t modified_utc;
+    std::string metadata;
+    std::string attachments;  // JSON array
+  };
+
+  struct TagRow {
+    int64_t id;
+    std::string name;
+  };
+
+  bool Exec(const char* sql);
+  int64_t QueryMaxId(const char* table);
+  int64_t ResolveTag(const std::string& name);
+
+  // Each table flushes on its own once kBatchRows rows are pending (foreign
+  // keys are off during the load); Finish() flushes the remainders.
+  bool FlushAll();
+  bool FlushFolders();
+  bool FlushTags();
+  bool FlushFiles();
+  bool FlushFileTags();
+
+  sqlite3* db_;
+  StatementCache* cache_;
+  bool active_ = false;
+  bool restore_foreign_keys_ = false;
+  std::string last_error_;
+
+  std::unordered_map<std::string, int64_t> folder_ids_;
+  std::unordered_map<std::string, int64_t> tag_ids_;
+  std::unordered_set<std::string> file_uuids_;
+  // CREATE INDEX statements of the metadata key indexes dropped by Begin()
+  std::vector<std::string> metadata_index_sql_;
+  int64_t next_folder_id_ = 1;
+  int64_t next_file_id_ = 1;
+  int64_t next_tag_id_ = 1;
+
+  std::vector<FolderRow> pending_folders_;
+  std::vector<TagRow> pending_tags_;
+  std::vector<FileRow> pending_files_;
+  std::vector<std::pair<int64_t, int64_t>> pending_file_tags_;  // (file_id, tag_id)
+};
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_BULK_LOADER_H
@@ -0,0 +1,367 @@
+#include "compressed_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+namespace vxcore {
+namespace db {
+
+namespace {
+
+constexpr size_t kBitmapWords = 65536 / 64;
+
+size_t PopCount(uint64_t word) { return std::bitset<64>(word).count(); }
+
+// Index of the lowest set bit of a non-zero |word|.
+unsigned LowestBit(uint64_t word) {
+  return static_cast<unsigned>(PopCount((word & (~word + 1)) - 1));
+}
+
+size_t CountWords(const std::vector<uint64_t>& words) {
+  size_t count = 0;
+  for (uint64_t word : words) {
+    count += PopCount(word);
+  }
+  return count;
+}
+
+}  // namespace
+
+// --- Container ---
+
+bool CompressedBitmap::Container::Contains(uint16_t low) const {
+  if (IsBitmap()) {
+    return (words[low >> 6] >> (low & 63)) & 1;
+  }
+  return std::binary_search(array.begin(), array.end(), low);
+}
+
+void CompressedBitmap::Container::ToBitmap() {
+  if (IsBitmap()) {
+    return;
+  }
+  words.assign(kBitmapWords, 0);
+  for (uint16_t low : array) {
+    words[low >> 6] |= uint64_t(1) << (low & 63);
+  }
+  std::vector<uint16_t>().swap(array);
+}
+
+void CompressedBitmap::Container::Shrink() {
+  if (!IsBitmap() || cardinality > kArrayMax) {
+    return;
+  }
+  array.clear();
+  array.reserve(cardinality);
+  for (size_t i = 0; i < kBitmapWords; ++i) {
+    for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+      array.push_back(static_cast<uint16_t>(i * 64 + LowestBit(word)));
+    }
+  }
+  std::vector<uint64_t>().swap(words);
+}
+
+void CompressedBitmap::Container::AppendTo(std::vector<uint32_t>& out) const {
+  const uint32_t high = uint32_t(key) << 16;
+  if (!IsBitmap()) {
+    for (uint16_t low : array) {
+      out.push_back(high | low);
+    }
+    return;
+  }
+  for (size_t i = 0; i < kBitmapWords; ++i) {
+    for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+      out.push_back(high | static_cast<uint32_t>(i * 64 + LowestBit(word)));
+    }
+  }
+}
+
+CompressedBitmap::Container CompressedBitmap::And(const Container& a, const Container& b) {
+  Container result;
+  result.key = a.key;
+  if (a.IsBitmap() && b.IsBitmap()) {
+    result.words.resize(kBitmapWords);
+    for (size_t i = 0; i < kBitmapWords; ++i) {
+      result.words[i] = a.words[i] & b.words[i];
+    }
+    result.cardinality = static_cast<uint32_t>(CountWords(result.words));
+    result.Shrink();
+    return result;
+  }
+  if (!a.IsBitmap() && !b.IsBitmap()) {
+    std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                          std::back_inserter(result.array));
+  } else {
+    const Container& small = a.IsBitmap() ? b : a;
+    const Container& big = a.IsBitmap() ? a : b;
+    for (uint16_t low : small.array) {
+      if (big.Contains(low)) {
+        result.array.push_back(low);
+      }
+    }
+  }
+  result.cardinality = static_cast<uint32_t>(result.array.size());
+  return result;
+}
+
+void CompressedBitmap::OrInto(Container& a, const Container& b) {
+  if (!a.IsBitmap() && !b.IsBitmap()) {
+    std::vector<uint16_t> merged;
+    merged.reserve(a.array.size() + b.array.size());
+    std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                   std::back_inserter(merged));
+    a.array.swap(merged);
+    a.cardinality = static_cast<uint32_t>(a.array.size());
+    if (a.cardinality > kArrayMax) {
+      a.ToBitmap();
+    }
+    return;
+  }
+
+  a.ToBitmap();
+  if (b.IsBitmap()) {
+    for (size_t i = 0; i < kBitmapWords; ++i) {
+      a.words[i] |= b.words[i];
+    }
+  } else {
+    for (uint16_t low : b.array) {
+      a.words[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+  }
+  // One side already held more than kArrayMax values, so the union stays a
+  // bitmap.
+  a.cardinality = static_cast<uint32_t>(CountWords(a.words));
+}
+
+void CompressedBitmap::AndNotInto(Container& a, const Container& b) {
+  if (!a.IsBitmap()) {
+    a.array.erase(std::remove_if(a.array.begin(), a.array.end(),
+                                 [&b](uint16_t low) { return b.Contains(low); }),
+                  a.array.end());
+    a.cardinality = static_cast<uint32_t>(a.array.size());
+    return;
+  }
+
+  if (b.IsBitmap()) {
+    for (size_t i = 0; i < kBitmapWords; ++i) {
+      a.words[i] &= ~b.words[i];
+    }
+  } else {
+    for (uint16_t low : b.array) {
+      a.words[low >> 6] &= ~(uint64_t(1) << (low & 63));
+    }
+  }
+  a.cardinality = static_cast<uint32_t>(CountWords(a.words));
+  a.Shrink();
+}
+
+// --- CompressedBitmap ---
+
+std::vector<CompressedBitmap::Container>::iterator CompressedBitmap::LowerBound(uint16_t key) {
+  return std::lower_bound(containers_.begin(), containers_.end(), key,
+                          [](const Container& c, uint16_t k) { return c.key < k; });
+}
+
+std::vector<CompressedBitmap::Container>::const_iterator CompressedBitmap::LowerBound(
+    uint16_t key) const {
+  return std::lower_bound(containers_.begin(), containers_.end(), key,
+                          [](const Container& c, uint16_t k) { return c.key < k; });
+}
+
+bool CompressedBitmap::Add(uint32_t value) {
+  const auto key = static_cast<uint16_t>(value >> 16);
+  const auto low = static_cast<uint16_t>(value & 0xFFFF);
+
+  auto it = LowerBound(key);
+  if (it == containers_.end() || it->key != key) {
+    Container container;
+    container.key = key;
+    container.array.push_back(low);
+    container.cardinality = 1;
+    containers_.insert(it, std::move(container));
+    return true;
+  }
+
+  Container& container = *it;
+  if (container.IsBitmap()) {
+    uint64_t& word = container.words[low >> 6];
+    const uint64_t bit = uint64_t(1) << (low & 63);
+    if (word & bit) {
+      return false;
+    }
+    word |= bit;
+    ++container.cardinality;
+    return true;
+  }
+
+  auto pos = std::lower_bound(container.array.begin(), container.array.end(), low);
+  if (pos != container.array.end() && *pos == low) {
+    return false;
+  }
+  container.array.insert(pos, low);
+  ++container.cardinality;
+  if (container.cardinality > kArrayMax) {
+    container.ToBitmap();
+  }
+  return true;
+}
+
+bool CompressedBitmap::Remove(uint32_t value) {
+  const auto key = static_cast<uint16_t>(value >> 16);
+  const auto low = static_cast<uint16_t>(value & 0xFFFF);
+
+  auto it = LowerBound(key);
+  if (it == containers_.end() || it->key != key) {
+    return false;
+  }
+
+  Container& container = *it;
+  if (container.IsBitmap()) {
+    uint64_t& word = container.words[low >> 6];
+    const uint64_t bit = uint64_t(1) << (low & 63);
+    if (!(word & bit)) {
+      return false;
+    }
+    word &= ~bit;
+    --container.cardinality;
+    container.Shrink();
+  } else {
+    auto pos = std::lower_bound(container.array.begin(), container.array.end(), low);
+    if (pos == container.array.end() || *pos != low) {
+      return false;
+    }
+    container.array.erase(pos);
+    --container.cardinality;
+  }
+
+  if (container.cardinality == 0) {
+    containers_.erase(it);
+  }
+  return true;
+}
+
+bool CompressedBitmap::Contains(uint32_t value) const {
+  const auto key = static_cast<uint16_t>(value >> 16);
+  auto it = LowerBound(key);
+  return it != containers_.end() && it->key == key &&
+         it->Contains(static_cast<uint16_t>(value & 0xFFFF));
+}
+
+size_t CompressedBitmap::Cardinality() const {
+  size_t count = 0;
+  for (const auto& container : containers_) {
+    count += container.cardinality;
+  }
+  return count;
+}
+
+CompressedBitmap& CompressedBitmap::operator&=(const CompressedBitmap& other) {
+  std::vector<Container> result;
+  auto a = containers_.begin();
+  auto b = other.containers_.begin();
+  while (a != containers_.end() && b != other.containers_.end()) {
+    if (a->key < b->key) {
+      ++a;
+    } else if (b->key < a->key) {
+      ++b;
+    } else {
+      Container merged = And(*a, *b);
+      if (merged.cardinality > 0) {
+        result.push_back(std::move(merged));
+      }
+      ++a;
+      ++b;
+    }
+  }
+  containers_.swap(result);
+  return *this;
+}
+
+CompressedBitmap& CompressedBitmap::operator|=(const CompressedBitmap& other) {
+  if (this == &other) {
+    return *this;
+  }
+  std::vector<Container> result;
+  result.reserve(containers_.size() + other.containers_.size());
+  auto a = containers_.begin();
+  auto b = other.containers_.begin();
+  while (a != containers_.end() || b != other.containers_.end()) {
+    if (b == other.containers_.end() || (a != containers_.end() && a->key < b->key)) {
+      result.push_back(std::move(*a++));
+    } else if (a == containers_.end() || b->key < a->key) {
+      result.push_back(*b++);
+    } else {
+      OrInto(*a, *b);
+      result.push_back(std::move(*a));
+      ++a;
+      ++b;
+    }
+  }
+  containers_.swap(result);
+  return *this;
+}
+
+CompressedBitmap& CompressedBitmap::operator-=(const CompressedBitmap& other) {
+  if (this == &other) {
+    containers_.clear();
+    return *this;
+  }
+  auto b = other.containers_.begin();
+  auto out = containers_.begin();
+  for (auto a = containers_.begin(); a != containers_.end(); ++a) {
+    while (b != other.containers_.end() && b->key < a->key) {
+      ++b;
+    }
+    if (b != other.containers_.end() && b->key == a->key) {
+      AndNotInto(*a, *b);
+      if (a->cardinality == 0) {
+        continue;
+      }
+    }
+    if (out != a) {
+      *out = std::move(*a);
+    }
+    ++out;
+  }
+  containers_.erase(out, containers_.end());
+  return *this;
+}
+
+std::vector<uint32_t> CompressedBitmap::ToVector() const {
+  std::vector<uint32_t> values;
+  values.reserve(Cardinality());
+  for (const auto& container : containers_) {
+    container.AppendTo(values);
+  }
+  return values;
+}
+
+size_t CompressedBitmap::MemoryBytes() const {
+  size_t bytes = containers_.capacity() * sizeof(Container);
+  for (const auto& container : containers_) {
+    bytes += container.array.capacity() * sizeof(uint16_t) +
+             container.words.capacity() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+bool CompressedBitmap::operator==(const CompressedBitmap& other) const {
+  // Containers are kept in canonical form (array iff cardinality <= kArrayMax),
+  // so equal sets have identical containers.
+  if (containers_.size() != other.containers_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < containers_.size(); ++i) {
+    const Container& a = containers_[i];
+    const Container& b = other.containers_[i];
+    if (a.key != b.key || a.cardinality != b.cardinality || a.array != b.array ||
+        a.words != b.words) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace db
+}  // namespace vxcore
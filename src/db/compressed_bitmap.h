@@ -0,0 +1,75 @@
+#ifndef VXCORE_COMPRESSED_BITMAP_H
+#define VXCORE_COMPRESSED_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vxcore {
+namespace db {
+
+// Compressed set of 32-bit integers in the style of Roaring bitmaps.
+//
+// Values are grouped by their high 16 bits into containers kept sorted by
+// that key. A container holds its low 16 bits either as a sorted array
+// (up to kArrayMax values, 2 bytes each) or as a 65536-bit bitmap (8 KB),
+// whichever is smaller, so sparse and dense sets both stay compact and set
+// operations run container by container over contiguous memory.
+//
+// NOT thread-safe.
+class CompressedBitmap {
+ public:
+  // Containers switch to bitmap form above this many values.
+  static constexpr size_t kArrayMax = 4096;
+
+  bool Add(uint32_t value);     // Returns true if |value| was not present
+  bool Remove(uint32_t value);  // Returns true if |value| was present
+  bool Contains(uint32_t value) const;
+
+  size_t Cardinality() const;
+  bool IsEmpty() const { return containers_.empty(); }
+  void Clear() { containers_.clear(); }
+
+  // In-place set operations.
+  CompressedBitmap& operator&=(const CompressedBitmap& other);
+  CompressedBitmap& operator|=(const CompressedBitmap& other);
+  CompressedBitmap& operator-=(const CompressedBitmap& other);  // AND NOT
+
+  // Values in ascending order.
+  std::vector<uint32_t> ToVector() const;
+
+  // Approximate heap footprint, for stats and benchmarks.
+  size_t MemoryBytes() const;
+
+  bool operator==(const CompressedBitmap& other) const;
+
+ private:
+  struct Container {
+    uint16_t key = 0;
+    uint32_t cardinality = 0;
+    std::vector<uint16_t> array;  // Sorted low bits; used while |words| is empty
+    std::vector<uint64_t> words;  // 1024 words in bitmap form, else empty
+
+    bool IsBitmap() const { return !words.empty(); }
+    bool Contains(uint16_t low) const;
+    void ToBitmap();
+    // Converts a bitmap container back to array form once it is small enough.
+    void Shrink();
+    void AppendTo(std::vector<uint32_t>& out) const;
+  };
+
+  static Container And(const Container& a, const Container& b);
+  static void OrInto(Container& a, const Container& b);
+  static void AndNotInto(Container& a, const Container& b);
+
+  // First container whose key is >= |key|.
+  std::vector<Container>::iterator LowerBound(uint16_t key);
+  std::vector<Container>::const_iterator LowerBound(uint16_t key) const;
+
+  std::vector<Container> containers_;
+};
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_COMPRESSED_BITMAP_H
@@ -0,0 +1,136 @@
+#include "db_maintenance.h"
+
+#include <sqlite3.h>
+
+#include <iterator>
+#include <unordered_set>
+
+#include "utils/logger.h"
+
+namespace vxcore {
+namespace db {
+
+namespace {
+
+// Rows ANALYZE samples per index during optimize; bounds the pass to a few
+// milliseconds on large tables while keeping the statistics useful.
+constexpr int kOptimizeAnalysisLimit = 400;
+
+}  // namespace
+
+bool RunDbMaintenance(const std::string &db_path, bool optimize, int busy_timeout_ms,
+                      DbMaintenanceResult *out_result) {
+  DbMaintenanceResult result;
+
+  sqlite3 *db = nullptr;
+  int rc = sqlite3_open_v2(db_path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX,
+                           nullptr);
+  if (rc != SQLITE_OK) {
+    VXCORE_LOG_WARN("Maintenance: failed to open %s: %s", db_path.c_str(),
+                    db ? sqlite3_errmsg(db) : sqlite3_errstr(rc));
+    sqlite3_close_v2(db);
+    return false;
+  }
+  sqlite3_busy_timeout(db, busy_timeout_ms);
+
+  bool ok = false;
+  sqlite3_stmt *stmt = nullptr;
+  rc = sqlite3_prepare_v2(db, "PRAGMA wal_checkpoint(PASSIVE);", -1, &stmt, nullptr);
+  if (rc == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+    // Columns: busy flag, frames in the WAL, frames checkpointed.
+    result.wal_frames = sqlite3_column_int(stmt, 1);
+    result.checkpointed_frames = sqlite3_column_int(stmt, 2);
+    ok = true;
+  } else {
+    VXCORE_LOG_WARN("Maintenance: checkpoint of %s failed: %s", db_path.c_str(),
+                    sqlite3_errmsg(db));
+  }
+  sqlite3_finalize(stmt);
+
+  if (ok && optimize) {
+    // A fresh connection has no query history, so ask optimize to look at
+    // every table (0x10000) and run the ANALYZE it finds worthwhile (0x02).
+    const std::string sql = "PRAGMA analysis_limit = " + std::to_string(kOptimizeAnalysisLimit) +
+                            "; PRAGMA optimize = 0x10002;";
+    char *err_msg = nullptr;
+    rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &err_msg);
+    if (rc == SQLITE_OK) {
+      result.optimized = true;
+    } else {
+      VXCORE_LOG_WARN("Maintenance: optimize of %s failed: %s", db_path.c_str(),
+                      err_msg ? err_msg : sqlite3_errmsg(db));
+    }
+    if (err_msg) {
+      sqlite3_free(err_msg);
+    }
+  }
+
+  sqlite3_close_v2(db);
+
+  VXCORE_LOG_DEBUG("Maintenance: %s wal_frames=%d checkpointed=%d optimized=%d",
+                   db_path.c_str(), result.wal_frames, result.checkpointed_frames,
+                   result.optimized ? 1 : 0);
+  if (out_result) {
+    *out_result = result;
+  }
+  return ok;
+}
+
+DbMaintenanceScheduler::DbMaintenanceScheduler(std::chrono::seconds checkpoint_interval,
+                                               std::chrono::seconds optimize_interval)
+    : checkpoint_interval_(checkpoint_interval), optimize_interval_(optimize_interval) {}
+
+void DbMaintenanceScheduler::SetIntervals(std::chrono::seconds checkpoint_interval,
+                                          std::chrono::seconds optimize_interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  checkpoint_interval_ = checkpoint_interval;
+  optimize_interval_ = optimize_interval;
+}
+
+std::vector<DbMaintenanceScheduler::Task> DbMaintenanceScheduler::CollectDue(
+    const std::vector<std::string> &db_paths, Clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::unordered_set<std::string> present(db_paths.begin(), db_paths.end());
+  for (auto it = states_.begin(); it != states_.end();) {
+    it = present.count(it->first) ? std::next(it) : states_.erase(it);
+  }
+
+  std::vector<Task> tasks;
+  for (const auto &path : db_paths) {
+    if (present.erase(path) == 0) {
+      continue;  // Duplicate
+    }
+    auto [it, inserted] = states_.try_emplace(path);
+    State &state = it->second;
+    if (inserted) {
+      // Statistics of a freshly opened database are as current as they get.
+      state.last_optimize = now;
+    }
+
+    const bool checkpoint_due =
+        !state.checkpointed || now - state.last_checkpoint >= checkpoint_interval_;
+    const bool optimize_due =
+        optimize_interval_.count() > 0 && now - state.last_optimize >= optimize_interval_;
+    if (checkpoint_due || optimize_due) {
+      tasks.push_back(Task{path, optimize_due});
+    }
+  }
+  return tasks;
+}
+
+void DbMaintenanceScheduler::MarkScheduled(const Task &task, Clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = states_.find(task.db_path);
+  if (it == states_.end()) {
+    return;
+  }
+  it->second.last_checkpoint = now;
+  it->second.checkpointed = true;
+  if (task.optimize) {
+    it->second.last_optimize = now;
+  }
+}
+
+}  // namespace db
+}  // namespace vxcore
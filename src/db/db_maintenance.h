@@ -0,0 +1,81 @@
+#ifndef VXCORE_DB_MAINTENANCE_H
+#define VXCORE_DB_MAINTENANCE_H
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vxcore {
+namespace db {
+
+// Work queue that vxcore_db_schedule_maintenance posts to. Hosts drain it
+// from a background thread like the other vxcore queues.
+constexpr char kMaintenanceQueueName[] = "vxcore.maintenance";
+
+// Pending-task bound for that queue; with nobody draining it, scheduling
+// stops queueing instead of piling up work.
+constexpr size_t kMaintenanceQueueCapacity = 16;
+
+struct DbMaintenanceResult {
+  // PRAGMA wal_checkpoint(PASSIVE) output: frames in the WAL and frames
+  // copied back into the database; -1 when the checkpoint did not run.
+  int wal_frames = -1;
+  int checkpointed_frames = -1;
+  bool optimized = false;
+};
+
+// Runs a passive WAL checkpoint (and PRAGMA optimize when |optimize|) on a
+// short-lived connection of its own, so it may run on any thread without
+// touching the connections that own |db_path|. A passive checkpoint never
+// waits for readers or writers; it copies what it can and stops.
+// Does not create |db_path|. Returns false if the database cannot be opened
+// or the checkpoint fails.
+bool RunDbMaintenance(const std::string &db_path, bool optimize, int busy_timeout_ms,
+                      DbMaintenanceResult *out_result = nullptr);
+
+// Decides which databases are due for idle maintenance: a checkpoint at most
+// once per |checkpoint_interval|, and an optimize pass at most once per
+// |optimize_interval| (never on the first sighting of a database). Thread-safe.
+class DbMaintenanceScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Task {
+    std::string db_path;
+    bool optimize = false;
+  };
+
+  DbMaintenanceScheduler(std::chrono::seconds checkpoint_interval,
+                         std::chrono::seconds optimize_interval);
+
+  void SetIntervals(std::chrono::seconds checkpoint_interval,
+                    std::chrono::seconds optimize_interval);
+
+  // Returns the tasks due among |db_paths| at |now|. Databases missing from
+  // |db_paths| are forgotten.
+  std::vector<Task> CollectDue(const std::vector<std::string> &db_paths, Clock::time_point now);
+
+  // Records that |task| was queued at |now|, so it is not due again until
+  // its interval has passed.
+  void MarkScheduled(const Task &task, Clock::time_point now);
+
+ private:
+  struct State {
+    Clock::time_point last_checkpoint;
+    Clock::time_point last_optimize;
+    bool checkpointed = false;
+  };
+
+  std::mutex mutex_;
+  std::chrono::seconds checkpoint_interval_;
+  std::chrono::seconds optimize_interval_;
+  std::unordered_map<std::string, State> states_;
+};
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_DB_MAINTENANCE_H
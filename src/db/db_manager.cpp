@@ -2,19 +2,49 @@
 
 #include <sqlite3.h>
 
+#include <mutex>
 #include <optional>
 
 #include "db_schema.h"
+#include "statement_cache.h"
 #include "utils/logger.h"
 
 namespace vxcore {
 namespace db {
 
-DbManager::DbManager() : db_(nullptr), db_path_() {}
+namespace {
+
+std::mutex g_default_tuning_mutex;
+
+DbTuning &DefaultTuningLocked() {
+  static DbTuning tuning = [] {
+    DbTuning balanced;
+    DbTuning::ForProfile(DbTuning::ProfileNames().front(), balanced);
+    return balanced;
+  }();
+  return tuning;
+}
+
+}  // namespace
+
+void DbManager::SetDefaultTuning(const DbTuning& tuning) {
+  std::lock_guard<std::mutex> lock(g_default_tuning_mutex);
+  DefaultTuningLocked() = tuning;
+}
+
+DbTuning DbManager::GetDefaultTuning() {
+  std::lock_guard<std::mutex> lock(g_default_tuning_mutex);
+  return DefaultTuningLocked();
+}
+
+DbManager::DbManager()
+    : db_(nullptr), db_path_(), statement_cache_(std::make_unique<StatementCache>()) {}
 
 DbManager::~DbManager() { Close(); }
 
-bool DbManager::Open(const std::string& db_path) {
+bool DbManager::Open(const std::string& db_path) { return Open(db_path, GetDefaultTuning()); }
+
+bool DbManager::Open(const std::string& db_path, const DbTuning& tuning) {
   if (db_ != nullptr) {
     VXCORE_LOG_WARN("Database already open, closing previous connection");
     Close();
@@ -57,6 +87,9 @@ bool DbManager::Open(const std::string& db_path) {
     return false;
   }
 
+  ApplyTuning(tuning);
+  statement_cache_->SetHandle(db_);
+
   VXCORE_LOG_DEBUG("Database opened successfully: %s", db_path.c_str());
   return true;
 }
@@ -64,6 +97,8 @@ bool DbManager::Open(const std::string& db_path) {
 void DbManager::Close() {
   if (db_ != nullptr) {
     VXCORE_LOG_DEBUG("Closing database: %s", db_path_.c_str());
+    // Finalize cached statements first so the close is not deferred.
+    statement_cache_->SetHandle(nullptr);
     int rc = sqlite3_close_v2(db_);
     if (rc != SQLITE_OK) {
       VXCORE_LOG_WARN("Error closing database: %s", GetLastError().c_str());
@@ -73,6 +108,29 @@ void DbManager::Close() {
   }
 }
 
+bool DbManager::ApplyTuning(const DbTuning& tuning) {
+  if (!IsOpen()) {
+    VXCORE_LOG_ERROR("Cannot apply tuning: database not open");
+    return false;
+  }
+
+  // Tuning is an optimization: a PRAGMA this build or platform rejects must
+  // not keep the database from opening.
+  for (const auto& pragma : tuning.BuildPragmas(/*read_only=*/false)) {
+    char* err_msg = nullptr;
+    if (sqlite3_exec(db_, pragma.c_str(), nullptr, nullptr, &err_msg) != SQLITE_OK) {
+      VXCORE_LOG_WARN("Failed to apply '%s': %s", pragma.c_str(),
+                      err_msg ? err_msg : GetLastError().c_str());
+    }
+    if (err_msg) {
+      sqlite3_free(err_msg);
+    }
+  }
+  sqlite3_busy_timeout(db_, tuning.busy_timeout_ms);
+  tuning_ = tuning;
+  return true;
+}
+
 bool DbManager::IsOpen() const { return db_ != nullptr; }
 
 std::string DbManager::GetPath() const { return db_path_; }
@@ -85,23 +143,19 @@ bool DbManager::InitializeSchema() {
 
   VXCORE_LOG_DEBUG("Initializing database schema");
 
-  std::string init_script = schema::GetInitializationScript();
+  if (!MigrateSchema()) {
+    return false;
+  }
 
-  char* err_msg = nullptr;
-  int rc = sqlite3_exec(db_, init_script.c_str(), nullptr, nullptr, &err_msg);
-  if (rc != SQLITE_OK) {
-    std::string error = err_msg ? err_msg : GetLastError();
-    VXCORE_LOG_ERROR("Failed to execute schema initialization: %s", error.c_str());
-    if (err_msg) {
-      sqlite3_free(err_msg);
-    }
+  std::string init_script = schema::GetInitializationScript();
+  if (!ExecScript(init_script.c_str(), "schema initialization")) {
     return false;
   }
 
   // Insert or update schema version
   const char* version_sql = "INSERT OR REPLACE INTO schema_version (version) VALUES (?);";
   sqlite3_stmt* stmt = nullptr;
-  rc = sqlite3_prepare_v2(db_, version_sql, -1, &stmt, nullptr);
+  int rc = sqlite3_prepare_v2(db_, version_sql, -1, &stmt, nullptr);
   if (rc != SQLITE_OK) {
     VXCORE_LOG_ERROR("Failed to prepare schema version statement: %s", GetLastError().c_str());
     return false;
@@ -120,6 +174,56 @@ bool DbManager::InitializeSchema() {
   return true;
 }
 
+bool DbManager::ExecScript(const char* script, const char* what) {
+  char* err_msg = nullptr;
+  int rc = sqlite3_exec(db_, script, nullptr, nullptr, &err_msg);
+  if (rc != SQLITE_OK) {
+    std::string error = err_msg ? err_msg : GetLastError();
+    VXCORE_LOG_ERROR("Failed to execute %s: %s", what, error.c_str());
+    if (err_msg) {
+      sqlite3_free(err_msg);
+    }
+    return false;
+  }
+  return true;
+}
+
+bool DbManager::MigrateSchema() {
+  // An empty result means the table does not exist yet; the initialization
+  // script creates it with every column.
+  sqlite3_stmt* stmt = nullptr;
+  int rc = sqlite3_prepare_v2(db_, "PRAGMA table_info(folders);", -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) {
+    VXCORE_LOG_ERROR("Failed to inspect folders table: %s", GetLastError().c_str());
+    return false;
+  }
+  bool has_table = false;
+  bool has_path = false;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    has_table = true;
+    const char* column = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    if (column && std::string(column) == "path") {
+      has_path = true;
+    }
+  }
+  sqlite3_finalize(stmt);
+
+  if (has_table && !has_path) {
+    VXCORE_LOG_INFO("Migrating database schema: adding folders.path");
+    // Column and backfill land together, so a failed backfill is retried on
+    // the next open instead of leaving the column half-populated.
+    const std::string script = std::string("SAVEPOINT migrate_folder_path;\n") +
+                               schema::kAddFolderPathColumn + schema::kBackfillFolderPaths +
+                               "RELEASE migrate_folder_path;";
+    if (!ExecScript(script.c_str(), "folders.path migration")) {
+      sqlite3_exec(db_, "ROLLBACK TO migrate_folder_path; RELEASE migrate_folder_path;", nullptr,
+                   nullptr, nullptr);
+      return false;
+    }
+  }
+  return true;
+}
+
 bool DbManager::RebuildDatabase() {
   if (!IsOpen()) {
     VXCORE_LOG_ERROR("Cannot rebuild database: database not open");
@@ -128,6 +232,9 @@ bool DbManager::RebuildDatabase() {
 
   VXCORE_LOG_DEBUG("Rebuilding database: %s", db_path_.c_str());
 
+  // Cached statements reference the tables about to be dropped.
+  statement_cache_->Clear();
+
   // Drop all tables using centralized schema definition
   std::string drop_script = schema::GetDropAllTablesScript();
 
@@ -4,12 +4,16 @@
 #include <memory>
 #include <string>
 
+#include "db_tuning.h"
+
 // Forward declare sqlite3 to avoid exposing SQLite types in header
 struct sqlite3;
 
 namespace vxcore {
 namespace db {
 
+class StatementCache;
+
 // Database manager handles SQLite database lifecycle and schema management
 class DbManager {
  public:
@@ -22,10 +26,27 @@ class DbManager {
   DbManager(DbManager&&) = delete;
   DbManager& operator=(DbManager&&) = delete;
 
-  // Opens or creates database at given path
+  // Opens or creates database at given path, applying the process-wide
+  // default tuning (see SetDefaultTuning)
   // Returns true on success, false on failure
   bool Open(const std::string& db_path);
 
+  // Same, with explicit tuning
+  bool Open(const std::string& db_path, const DbTuning& tuning);
+
+  // Re-applies |tuning| to the open connection. Settings that fail to apply
+  // are logged and skipped. Returns false only if the database is not open.
+  bool ApplyTuning(const DbTuning& tuning);
+
+  // Tuning last applied to this connection
+  const DbTuning& GetTuning() const { return tuning_; }
+
+  // Tuning applied by Open(db_path) to every vxcore database (notebook
+  // metadata, activity). Set from vxcore.json before databases are opened;
+  // connections opened earlier keep their settings. Thread-safe.
+  static void SetDefaultTuning(const DbTuning& tuning);
+  static DbTuning GetDefaultTuning();
+
   // Closes the database connection
   void Close();
 
@@ -36,6 +57,7 @@ class DbManager {
   std::string GetPath() const;
 
   // Initializes database schema (creates tables if they don't exist)
+  // Upgrades tables left by an older schema version in place.
   // Returns true on success, false on failure
   bool InitializeSchema();
 
@@ -53,12 +75,25 @@ class DbManager {
   // Returns nullptr if database is not open
   sqlite3* GetHandle() const { return db_; }
 
+  // Prepared-statement cache for this connection (for FileDb, TagDb, etc.).
+  // Lives as long as the DbManager; emptied on Close and RebuildDatabase.
+  StatementCache* GetStatementCache() const { return statement_cache_.get(); }
+
   // Returns the last SQLite error message
   std::string GetLastError() const;
 
  private:
+  // Executes a multi-statement script, logging failures under |what|.
+  bool ExecScript(const char* script, const char* what);
+
+  // Upgrades tables created by an older schema version (adds and fills in
+  // folders.path) before the initialization script runs.
+  bool MigrateSchema();
+
   sqlite3* db_;
   std::string db_path_;
+  DbTuning tuning_;
+  std::unique_ptr<StatementCache> statement_cache_;
 };
 
 }  // namespace db
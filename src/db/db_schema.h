@@ -10,11 +10,14 @@ namespace db {
 namespace schema {
 
 // Schema version for migration tracking
-constexpr int kCurrentSchemaVersion = 4;
+constexpr int kCurrentSchemaVersion = 7;
 
 // Folders table: stores folder hierarchy
 // parent_id references folders(id) - NULL for root folders
 // uuid is the string ID from JSON files (from FolderConfig.id)
+// path is the materialized "/"-joined chain of names from the top-level folder
+// down (e.g. "./notes/sub"), maintained by the triggers below; NULL when the
+// parent chain is broken
 inline constexpr const char* kCreateFoldersTable = R"(
 CREATE TABLE IF NOT EXISTS folders (
   id INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -24,10 +27,63 @@ CREATE TABLE IF NOT EXISTS folders (
   created_utc INTEGER NOT NULL,
   modified_utc INTEGER NOT NULL,
   metadata TEXT,
+  path TEXT,
   FOREIGN KEY (parent_id) REFERENCES folders(id) ON DELETE CASCADE
 );
 CREATE INDEX IF NOT EXISTS idx_folders_parent ON folders(parent_id);
 CREATE INDEX IF NOT EXISTS idx_folders_uuid ON folders(uuid);
+CREATE INDEX IF NOT EXISTS idx_folders_path ON folders(path);
+)";
+
+// Triggers keeping folders.path in sync within the writing statement itself.
+// On rename/move the subtree is re-prefixed with a range scan on
+// idx_folders_path: every descendant path lies in [old || '/', old || '0'),
+// since '0' is the byte after '/'.
+inline constexpr const char* kCreateFolderPathTriggers = R"(
+CREATE TRIGGER IF NOT EXISTS trg_folders_path_insert AFTER INSERT ON folders
+BEGIN
+  UPDATE folders SET path = CASE
+      WHEN NEW.parent_id IS NULL THEN NEW.name
+      ELSE (SELECT path FROM folders WHERE id = NEW.parent_id) || '/' || NEW.name
+    END
+  WHERE id = NEW.id;
+END;
+CREATE TRIGGER IF NOT EXISTS trg_folders_path_update AFTER UPDATE OF name, parent_id ON folders
+WHEN NEW.name IS NOT OLD.name OR NEW.parent_id IS NOT OLD.parent_id
+BEGIN
+  UPDATE folders SET path = CASE
+      WHEN NEW.parent_id IS NULL THEN NEW.name
+      ELSE (SELECT path FROM folders WHERE id = NEW.parent_id) || '/' || NEW.name
+    END
+  WHERE id = NEW.id;
+  UPDATE folders SET path = (SELECT path FROM folders WHERE id = NEW.id) ||
+                            substr(path, length(OLD.path) + 1)
+  WHERE OLD.path IS NOT NULL AND path >= OLD.path || '/' AND path < OLD.path || '0' AND
+        id <> NEW.id;
+END;
+)";
+
+// Migration from schema version 4: adds folders.path to an existing table.
+// Run (followed by kBackfillFolderPaths) before the initialization script,
+// which indexes the column.
+inline constexpr const char* kAddFolderPathColumn = R"(
+ALTER TABLE folders ADD COLUMN path TEXT;
+)";
+
+// Recomputes folders.path for every row from the parent chain in one pass;
+// rows with a broken chain end up NULL.
+inline constexpr const char* kBackfillFolderPaths = R"(
+CREATE TEMP TABLE IF NOT EXISTS folder_paths (id INTEGER PRIMARY KEY, path TEXT);
+DELETE FROM temp.folder_paths;
+INSERT INTO temp.folder_paths (id, path)
+  WITH RECURSIVE walk(id, path) AS (
+    SELECT id, name FROM folders WHERE parent_id IS NULL
+    UNION ALL
+    SELECT f.id, walk.path || '/' || f.name FROM folders f JOIN walk ON f.parent_id = walk.id
+  )
+  SELECT id, path FROM walk;
+UPDATE folders SET path = (SELECT path FROM temp.folder_paths WHERE id = folders.id);
+DROP TABLE temp.folder_paths;
 )";
 
 // Files table: stores file metadata
@@ -79,6 +135,20 @@ CREATE TABLE IF NOT EXISTS file_tags (
 CREATE INDEX IF NOT EXISTS idx_file_tags_tag ON file_tags(tag_id);
 )";
 
+// Folder config stamps: the vx.json a folder row was last synced from.
+// mtime_utc and size are the file's stat values (mtime in the filesystem
+// clock's ticks; only compared for equality), hash is HashContent() of its
+// bytes. A folder without a row has never been stamped.
+inline constexpr const char* kCreateFolderConfigStampsTable = R"(
+CREATE TABLE IF NOT EXISTS folder_config_stamps (
+  folder_id INTEGER PRIMARY KEY,
+  mtime_utc INTEGER NOT NULL,
+  size INTEGER NOT NULL,
+  hash TEXT NOT NULL,
+  FOREIGN KEY (folder_id) REFERENCES folders(id) ON DELETE CASCADE
+);
+)";
+
 // Notebook metadata: key-value store for notebook-level metadata
 inline constexpr const char* kCreateNotebookMetadataTable = R"(
 CREATE TABLE IF NOT EXISTS notebook_metadata (
@@ -87,6 +157,37 @@ CREATE TABLE IF NOT EXISTS notebook_metadata (
 );
 )";
 
+// File open history: one row per file, most recent open first by
+// (opened_utc, id). Recording an open re-inserts the row (INSERT OR REPLACE),
+// so id grows with every open and breaks ties within one millisecond; the
+// index entries carry the rowid, so "ORDER BY opened_utc DESC, id DESC LIMIT n"
+// reads idx_file_history_opened without sorting.
+// file_uuid is a FileRecord.id; rows are not tied to files(id), since history
+// is not derived from the config files and outlives a rebuild.
+inline constexpr const char* kCreateFileHistoryTable = R"(
+CREATE TABLE IF NOT EXISTS file_history (
+  id INTEGER PRIMARY KEY,
+  file_uuid TEXT NOT NULL UNIQUE,
+  opened_utc INTEGER NOT NULL,
+  open_count INTEGER NOT NULL
+);
+CREATE INDEX IF NOT EXISTS idx_file_history_opened ON file_history(opened_utc);
+)";
+
+// Migration from schema version 6: history used to be a JSON array
+// (most recent first) under notebook_metadata key "history". Imports it
+// oldest first, so ids keep the order, and drops the blob. A keyed lookup
+// that finds nothing once the blob is gone.
+inline constexpr const char* kImportHistoryBlob = R"(
+INSERT OR IGNORE INTO file_history (file_uuid, opened_utc, open_count)
+  SELECT json_extract(h.value, '$.fileId'), ifnull(json_extract(h.value, '$.openedUtc'), 0), 1
+  FROM notebook_metadata m, json_each(CASE WHEN json_valid(m.value) THEN m.value END) h
+  WHERE m.key = 'history' AND h.type = 'object' AND
+        json_type(h.value, '$.fileId') = 'text' AND json_extract(h.value, '$.fileId') <> ''
+  ORDER BY h.key DESC;
+DELETE FROM notebook_metadata WHERE key = 'history';
+)";
+
 // Schema version table for migrations
 inline constexpr const char* kCreateSchemaVersionTable = R"(
 CREATE TABLE IF NOT EXISTS schema_version (
@@ -95,21 +196,42 @@ CREATE TABLE IF NOT EXISTS schema_version (
 )";
 
 // Table names in reverse dependency order (safe for dropping)
-// When adding a new table, add it to this array in the appropriate position
+// When adding a new table, add it to this array in the appropriate position,
+// unless a rebuild must keep its rows (file_history).
 inline constexpr const char* kTableNames[] = {
-    "file_tags",          // Many-to-many relationship (depends on files, tags)
-    "files",              // Depends on folders
-    "tags",               // Independent
-    "folders",            // Independent (now includes sync state)
-    "notebook_metadata",  // Independent (key-value store)
-    "schema_version",     // Independent
+    "file_tags",             // Many-to-many relationship (depends on files, tags)
+    "folder_config_stamps",  // Depends on folders
+    "files",                 // Depends on folders
+    "tags",                  // Independent
+    "folders",               // Independent (now includes sync state)
+    "notebook_metadata",     // Independent (key-value store)
+    "schema_version",        // Independent
+};
+
+// Secondary indexes created by the scripts above. BulkLoader drops these for
+// the duration of a load; the initialization script recreates them.
+inline constexpr const char* kSecondaryIndexNames[] = {
+    "idx_folders_parent", "idx_folders_uuid", "idx_folders_path", "idx_files_folder",
+    "idx_files_name",     "idx_files_uuid",   "idx_tags_name",    "idx_tags_parent",
+    "idx_file_tags_tag",
 };
 
+// Name prefixes of the on-demand expression indexes over metadata keys (see
+// FileDb::CreateMetadataKeyIndex); the rest of the name is the key in hex.
+// They are not part of the scripts: BulkLoader carries them across a load
+// by their stored definitions.
+inline constexpr const char* kFilesMetadataIndexPrefix = "idx_files_meta_";
+inline constexpr const char* kFoldersMetadataIndexPrefix = "idx_folders_meta_";
+
 // Combined initialization script
 inline const std::string GetInitializationScript() {
-  return std::string(kCreateFoldersTable) + "\n" + std::string(kCreateFilesTable) + "\n" +
+  return std::string(kCreateFoldersTable) + "\n" + std::string(kCreateFolderPathTriggers) +
+         "\n" + std::string(kCreateFilesTable) + "\n" +
          std::string(kCreateTagsTable) + "\n" + std::string(kCreateFileTagsTable) + "\n" +
-         std::string(kCreateNotebookMetadataTable) + "\n" + std::string(kCreateSchemaVersionTable);
+         std::string(kCreateFolderConfigStampsTable) + "\n" +
+         std::string(kCreateNotebookMetadataTable) + "\n" +
+         std::string(kCreateFileHistoryTable) + "\n" + std::string(kImportHistoryBlob) + "\n" +
+         std::string(kCreateSchemaVersionTable);
 }
 
 // Generate DROP TABLE statements for all tables
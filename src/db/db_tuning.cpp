@@ -0,0 +1,84 @@
+#include "db_tuning.h"
+
+namespace vxcore {
+namespace db {
+
+namespace {
+
+DbTuning BalancedProfile() {
+  DbTuning tuning;
+  tuning.synchronous = 1;
+  tuning.cache_size_kib = 8 * 1024;
+  tuning.mmap_size_bytes = 64LL * 1024 * 1024;
+  tuning.temp_store_memory = true;
+  tuning.journal_size_limit_bytes = 16LL * 1024 * 1024;
+  tuning.busy_timeout_ms = 2000;
+  return tuning;
+}
+
+}  // namespace
+
+const std::vector<std::string> &DbTuning::ProfileNames() {
+  static const std::vector<std::string> names = {"balanced", "sqlite", "performance",
+                                                 "low-memory", "durable"};
+  return names;
+}
+
+bool DbTuning::ForProfile(const std::string &profile, DbTuning &out) {
+  if (profile == "balanced") {
+    out = BalancedProfile();
+  } else if (profile == "sqlite") {
+    out = DbTuning();
+  } else if (profile == "performance") {
+    out = BalancedProfile();
+    out.cache_size_kib = 64 * 1024;
+    out.mmap_size_bytes = 256LL * 1024 * 1024;
+    out.wal_autocheckpoint_pages = 4000;
+    out.journal_size_limit_bytes = 64LL * 1024 * 1024;
+  } else if (profile == "low-memory") {
+    out = BalancedProfile();
+    out.cache_size_kib = 1024;
+    out.mmap_size_bytes = 0;
+    out.temp_store_memory = false;
+    out.wal_autocheckpoint_pages = 500;
+    out.journal_size_limit_bytes = 4LL * 1024 * 1024;
+  } else if (profile == "durable") {
+    out = BalancedProfile();
+    out.synchronous = 2;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::string> DbTuning::BuildPragmas(bool read_only) const {
+  std::vector<std::string> pragmas;
+  if (cache_size_kib > 0) {
+    // A negative cache_size is in KiB rather than pages.
+    pragmas.push_back("PRAGMA cache_size = -" + std::to_string(cache_size_kib) + ";");
+  }
+  if (mmap_size_bytes > 0) {
+    pragmas.push_back("PRAGMA mmap_size = " + std::to_string(mmap_size_bytes) + ";");
+  }
+  if (temp_store_memory) {
+    pragmas.push_back("PRAGMA temp_store = MEMORY;");
+  }
+  if (read_only) {
+    return pragmas;
+  }
+  if (synchronous >= 0 && synchronous <= 2) {
+    pragmas.push_back("PRAGMA synchronous = " + std::to_string(synchronous) + ";");
+  }
+  if (wal_autocheckpoint_pages >= 0) {
+    pragmas.push_back("PRAGMA wal_autocheckpoint = " + std::to_string(wal_autocheckpoint_pages) +
+                      ";");
+  }
+  if (journal_size_limit_bytes >= 0) {
+    pragmas.push_back("PRAGMA journal_size_limit = " + std::to_string(journal_size_limit_bytes) +
+                      ";");
+  }
+  return pragmas;
+}
+
+}  // namespace db
+}  // namespace vxcore
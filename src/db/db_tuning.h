@@ -0,0 +1,57 @@
+#ifndef VXCORE_DB_TUNING_H
+#define VXCORE_DB_TUNING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vxcore {
+namespace db {
+
+// Per-connection SQLite settings applied by DbManager::Open (and by read-only
+// pool connections, minus the write-side settings). Every field has a "leave
+// SQLite's default" value, so an all-default DbTuning reproduces plain
+// sqlite3_open behaviour.
+//
+// Named profiles (see ForProfile):
+//   "sqlite"      - SQLite defaults for everything (synchronous=FULL).
+//   "balanced"    - default. synchronous=NORMAL (safe under WAL: an app crash
+//                   loses nothing, power loss at most the last commits), an
+//                   8 MiB page cache, 64 MiB mmap, in-memory temp tables.
+//   "performance" - balanced with a 64 MiB cache, 256 MiB mmap and a larger
+//                   WAL before auto-checkpoint, for big notebooks.
+//   "low-memory"  - NORMAL, 1 MiB cache, no mmap, file-backed temp tables.
+//   "durable"     - balanced but synchronous=FULL (fsync on every commit).
+struct DbTuning {
+  // PRAGMA synchronous: 0=OFF, 1=NORMAL, 2=FULL; -1 leaves the default.
+  int synchronous = -1;
+  // PRAGMA cache_size in KiB; 0 leaves the default (2 MiB).
+  int64_t cache_size_kib = 0;
+  // PRAGMA mmap_size in bytes; 0 disables memory-mapped I/O (the default).
+  int64_t mmap_size_bytes = 0;
+  // PRAGMA temp_store = MEMORY when true.
+  bool temp_store_memory = false;
+  // PRAGMA wal_autocheckpoint in pages; -1 leaves the default (1000).
+  int wal_autocheckpoint_pages = -1;
+  // PRAGMA journal_size_limit in bytes (WAL is truncated to this after a
+  // checkpoint); -1 leaves it unlimited.
+  int64_t journal_size_limit_bytes = -1;
+  // sqlite3_busy_timeout; 0 fails immediately on a locked database.
+  int busy_timeout_ms = 0;
+
+  // Fills |out| with the named profile. Returns false (leaving |out|
+  // untouched) for an unknown name.
+  static bool ForProfile(const std::string &profile, DbTuning &out);
+
+  // Names accepted by ForProfile, default first.
+  static const std::vector<std::string> &ProfileNames();
+
+  // PRAGMA statements for this tuning, one per setting. Read-only
+  // connections skip the settings that only matter to writers.
+  std::vector<std::string> BuildPragmas(bool read_only) const;
+};
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_DB_TUNING_H
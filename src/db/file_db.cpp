@@ -2,9 +2,13 @@
 
 #include <sqlite3.h>
 
+#include <algorithm>
 #include <chrono>
 #include <nlohmann/json.hpp>
+#include <set>
 
+#include "core/metadata_filter.h"
+#include "db_schema.h"
 #include "tag_db.h"
 
 namespace vxcore {
@@ -31,9 +35,262 @@ std::vector<std::string> SplitPath(const std::string& path) {
   return components;
 }
 
+// Parses the files.attachments JSON array; malformed or empty input yields none
+std::vector<std::string> ParseAttachments(const unsigned char* text) {
+  const char* json_str = reinterpret_cast<const char*>(text);
+  if (!json_str || json_str[0] == '\0') {
+    return {};
+  }
+  try {
+    nlohmann::json j = nlohmann::json::parse(json_str);
+    if (j.is_array()) {
+      return j.get<std::vector<std::string>>();
+    }
+  } catch (...) {
+    // Ignore parse errors, return empty vector
+  }
+  return {};
+}
+
+// Columns VisitFileRows expects, one row per (file, tag). Callers append the
+// WHERE and ORDER BY clauses; rows of one file must be adjacent.
+constexpr const char* kFileRowsSelect =
+    "SELECT f.id, f.uuid, f.folder_id, f.name, f.created_utc, f.modified_utc, f.metadata, "
+    "f.attachments, d.uuid, d.path, t.name "
+    "FROM files f "
+    "LEFT JOIN folders d ON d.id = f.folder_id "
+    "LEFT JOIN file_tags ft ON ft.file_id = f.id "
+    "LEFT JOIN tags t ON t.id = ft.tag_id ";
+
+// Assembles the records of a kFileRowsSelect query and hands them to
+// |callback|. Returns false if the callback stopped the iteration.
+bool VisitFileRows(sqlite3_stmt* stmt, const FileDb::FileVisitor& callback) {
+  auto column_string = [stmt](int col) -> std::string {
+    const unsigned char* text = sqlite3_column_text(stmt, col);
+    return text ? reinterpret_cast<const char*>(text) : "";
+  };
+
+  // Folder columns only change between folder groups; re-read them then.
+  int64_t folder_id = -1;
+  bool have_folder = false;
+  std::string folder_uuid;
+  std::string folder_path;
+
+  std::optional<DbFileRecord> pending;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int64_t file_id = sqlite3_column_int64(stmt, 0);
+    if (!pending || pending->id != file_id) {
+      if (pending && !callback(*pending, folder_uuid, folder_path)) {
+        return false;
+      }
+      pending.emplace();
+      pending->id = file_id;
+      pending->uuid = column_string(1);
+      pending->folder_id = sqlite3_column_int64(stmt, 2);
+      pending->name = column_string(3);
+      pending->created_utc = sqlite3_column_int64(stmt, 4);
+      pending->modified_utc = sqlite3_column_int64(stmt, 5);
+      pending->metadata = column_string(6);
+      pending->attachments = ParseAttachments(sqlite3_column_text(stmt, 7));
+      if (!have_folder || pending->folder_id != folder_id) {
+        folder_id = pending->folder_id;
+        have_folder = true;
+        folder_uuid = column_string(8);
+        folder_path = column_string(9);
+      }
+    }
+    if (sqlite3_column_type(stmt, 10) != SQLITE_NULL) {
+      pending->tags.push_back(column_string(10));
+    }
+  }
+  return !pending || callback(*pending, folder_uuid, folder_path);
+}
+
+// |column| (a metadata column), or NULL when it is not valid JSON: the JSON
+// functions raise an error on malformed input, which would fail the whole
+// query and, inside an index expression, every write of such a row.
+std::string MetadataDocument(const char* column) {
+  return std::string("CASE WHEN json_valid(") + column + ") THEN " + column + " END";
+}
+
+// '$."a"."b"' for "a.b". Valid keys hold no quotes, so nothing needs escaping.
+std::string MetadataPath(const std::string& key) {
+  std::string path = "$";
+  for (const auto& segment : SplitMetadataKey(key)) {
+    path += ".\"" + segment + "\"";
+  }
+  return path;
+}
+
+// The expression the key indexes are built on; a query must spell it the same
+// way (up to the table qualifier of |column|) for an index to apply.
+std::string MetadataIndexExpr(const char* column, const std::string& key) {
+  return "json_extract(" + MetadataDocument(column) + ", '" + MetadataPath(key) + "')";
+}
+
+// json_type() names of the values that compare with |value|
+const char* MetadataTypeSet(const nlohmann::json& value) {
+  if (value.is_string()) {
+    return "('text')";
+  }
+  if (value.is_number()) {
+    return "('integer', 'real')";
+  }
+  return "('true', 'false')";
+}
+
+// WHERE clause of a metadata query and the values of its placeholders, in
+// order. Only keys in |indexed_keys| get their path as a literal, which the
+// planner needs to match the expression index; every other path is bound, so
+// the statement text does not grow with the set of keys ever queried.
+class MetadataWhere {
+ public:
+  MetadataWhere(const char* column, const std::set<std::string>& indexed_keys)
+      : column_(column), indexed_keys_(indexed_keys) {}
+
+  // Returns false for an invalid key.
+  bool Build(const MetadataFilter& filter) {
+    for (const auto& condition : filter.conditions) {
+      if (!IsValidMetadataKey(condition.key)) {
+        return false;
+      }
+      if (!sql_.empty()) {
+        sql_ += " AND ";
+      }
+      const char* comparison = nullptr;
+      switch (condition.op) {
+        case MetadataOp::kEq:
+          sql_ += "(";
+          AppendEquals(condition);
+          sql_ += ")";
+          continue;
+        case MetadataOp::kNe:
+          sql_ += "NOT ifnull(";
+          AppendEquals(condition);
+          sql_ += ", 0)";
+          continue;
+        case MetadataOp::kExists:
+          AppendType(condition.key);
+          sql_ += " IS NOT NULL";
+          continue;
+        case MetadataOp::kMissing:
+          AppendType(condition.key);
+          sql_ += " IS NULL";
+          continue;
+        case MetadataOp::kLt:
+          comparison = " < ?";
+          break;
+        case MetadataOp::kLe:
+          comparison = " <= ?";
+          break;
+        case MetadataOp::kGt:
+          comparison = " > ?";
+          break;
+        case MetadataOp::kGe:
+          comparison = " >= ?";
+          break;
+      }
+      if (!condition.value.is_string() && !condition.value.is_number()) {
+        sql_ += "0";
+        continue;
+      }
+      sql_ += "(";
+      AppendCompare(condition, comparison);
+      sql_ += ")";
+    }
+    if (sql_.empty()) {
+      sql_ = "1";
+    }
+    return true;
+  }
+
+  const std::string& sql() const { return sql_; }
+  const std::vector<nlohmann::json>& params() const { return params_; }
+
+ private:
+  // "<extract> = ? AND <type> IN (...)", or the null test, for |condition|.
+  void AppendEquals(const MetadataCondition& condition) {
+    if (condition.value.is_null()) {
+      AppendType(condition.key);
+      sql_ += " = 'null'";
+      return;
+    }
+    AppendCompare(condition, " = ?");
+  }
+
+  void AppendCompare(const MetadataCondition& condition, const char* comparison) {
+    AppendExtract(condition.key);
+    sql_ += comparison;
+    params_.push_back(condition.value);
+    sql_ += " AND ";
+    AppendType(condition.key);
+    sql_ += " IN ";
+    sql_ += MetadataTypeSet(condition.value);
+  }
+
+  void AppendExtract(const std::string& key) {
+    if (indexed_keys_.count(key)) {
+      sql_ += MetadataIndexExpr(column_, key);
+      return;
+    }
+    sql_ += "json_extract(" + MetadataDocument(column_) + ", ?)";
+    params_.push_back(MetadataPath(key));
+  }
+
+  // No index covers json_type(), so its path is always bound.
+  void AppendType(const std::string& key) {
+    sql_ += "json_type(" + MetadataDocument(column_) + ", ?)";
+    params_.push_back(MetadataPath(key));
+  }
+
+  const char* column_;
+  const std::set<std::string>& indexed_keys_;
+  std::string sql_;
+  std::vector<nlohmann::json> params_;
+};
+
+// Binds |params| from placeholder 1 on, then |limit| after them when non-zero.
+void BindMetadataParams(sqlite3_stmt* stmt, const std::vector<nlohmann::json>& params,
+                        size_t limit) {
+  int index = 1;
+  for (const auto& value : params) {
+    if (value.is_string()) {
+      sqlite3_bind_text(stmt, index, value.get_ref<const std::string&>().c_str(), -1,
+                        SQLITE_TRANSIENT);
+    } else if (value.is_boolean()) {
+      // json_extract() reads true/false as 1/0
+      sqlite3_bind_int(stmt, index, value.get<bool>() ? 1 : 0);
+    } else if (value.is_number_integer() && !value.is_number_unsigned()) {
+      sqlite3_bind_int64(stmt, index, value.get<int64_t>());
+    } else if (value.is_number_unsigned() &&
+               value.get<uint64_t>() <= static_cast<uint64_t>(INT64_MAX)) {
+      sqlite3_bind_int64(stmt, index, static_cast<int64_t>(value.get<uint64_t>()));
+    } else {
+      sqlite3_bind_double(stmt, index, value.get<double>());
+    }
+    ++index;
+  }
+  if (limit > 0) {
+    sqlite3_bind_int64(stmt, index, static_cast<int64_t>(limit));
+  }
+}
+
+std::string MetadataIndexName(const char* prefix, const std::string& key) {
+  static const char kHex[] = "0123456789abcdef";
+  std::string name = prefix;
+  for (unsigned char c : key) {
+    name += kHex[c >> 4];
+    name += kHex[c & 0x0f];
+  }
+  return name;
+}
+
 }  // namespace
 
-FileDb::FileDb(sqlite3* db) : db_(db) {}
+FileDb::FileDb(sqlite3* db, StatementCache* cache)
+    : db_(db),
+      owned_cache_(cache ? nullptr : std::make_unique<StatementCache>(db)),
+      cache_(cache ? cache : owned_cache_.get()) {}
 
 std::string FileDb::GetLastError() const { return sqlite3_errmsg(db_); }
 
@@ -46,9 +303,8 @@ int64_t FileDb::CreateFolder(int64_t parent_id, const std::string& name, int64_t
       "INSERT INTO folders (parent_id, name, created_utc, modified_utc, uuid, metadata) "
       "VALUES (?, ?, ?, ?, 'temp', '');";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return -1;
   }
 
@@ -62,12 +318,11 @@ int64_t FileDb::CreateFolder(int64_t parent_id, const std::string& name, int64_t
   sqlite3_bind_int64(stmt, 3, created_utc);
   sqlite3_bind_int64(stmt, 4, modified_utc);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   int64_t folder_id = -1;
   if (rc == SQLITE_DONE) {
     folder_id = sqlite3_last_insert_rowid(db_);
   }
-  sqlite3_finalize(stmt);
 
   if (folder_id == -1) {
     return -1;
@@ -75,17 +330,16 @@ int64_t FileDb::CreateFolder(int64_t parent_id, const std::string& name, int64_t
 
   // Update with ID-based unique values
   const char* update_sql = "UPDATE folders SET uuid = ? WHERE id = ?;";
-  rc = sqlite3_prepare_v2(db_, update_sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement update_stmt = cache_->Acquire(update_sql);
+  if (!update_stmt) {
     return -1;
   }
 
   std::string uuid = "_folder_" + std::to_string(folder_id);
-  sqlite3_bind_text(stmt, 1, uuid.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_int64(stmt, 2, folder_id);
+  sqlite3_bind_text(update_stmt, 1, uuid.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(update_stmt, 2, folder_id);
 
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  rc = sqlite3_step(update_stmt);
 
   return (rc == SQLITE_DONE) ? folder_id : -1;
 }
@@ -98,9 +352,8 @@ int64_t FileDb::CreateOrUpdateFolder(const std::string& uuid, int64_t parent_id,
       "metadata) "
       "VALUES (?, ?, ?, ?, ?, ?);";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return -1;
   }
 
@@ -116,13 +369,12 @@ int64_t FileDb::CreateOrUpdateFolder(const std::string& uuid, int64_t parent_id,
   sqlite3_bind_text(stmt, 6, metadata.c_str(), -1, SQLITE_TRANSIENT);
   // 6 parameters: uuid, parent_id, name, created_utc, modified_utc, metadata
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   int64_t folder_id = -1;
   if (rc == SQLITE_DONE) {
     folder_id = sqlite3_last_insert_rowid(db_);
   }
 
-  sqlite3_finalize(stmt);
   return folder_id;
 }
 
@@ -138,9 +390,8 @@ int64_t FileDb::InsertFolder(const std::string& uuid, int64_t parent_id, const s
       "INSERT INTO folders (uuid, parent_id, name, created_utc, modified_utc, metadata) "
       "VALUES (?, ?, ?, ?, ?, ?);";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return -1;
   }
 
@@ -155,7 +406,7 @@ int64_t FileDb::InsertFolder(const std::string& uuid, int64_t parent_id, const s
   sqlite3_bind_int64(stmt, 5, modified_utc);
   sqlite3_bind_text(stmt, 6, metadata.c_str(), -1, SQLITE_TRANSIENT);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   int64_t folder_id = -1;
   if (rc == SQLITE_DONE) {
     folder_id = sqlite3_last_insert_rowid(db_);
@@ -164,7 +415,6 @@ int64_t FileDb::InsertFolder(const std::string& uuid, int64_t parent_id, const s
     *out_conflict = true;
   }
 
-  sqlite3_finalize(stmt);
   return folder_id;
 }
 
@@ -172,17 +422,15 @@ std::optional<DbFolderRecord> FileDb::GetFolder(int64_t folder_id) {  const char
       "SELECT id, uuid, parent_id, name, created_utc, modified_utc, metadata FROM folders "
       "WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return std::nullopt;
   }
 
   sqlite3_bind_int64(stmt, 1, folder_id);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
@@ -196,7 +444,6 @@ std::optional<DbFolderRecord> FileDb::GetFolder(int64_t folder_id) {  const char
   folder.modified_utc = sqlite3_column_int64(stmt, 5);
   folder.metadata = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
 
-  sqlite3_finalize(stmt);
   return folder;
 }
 
@@ -205,17 +452,15 @@ std::optional<DbFolderRecord> FileDb::GetFolderByUuid(const std::string& uuid) {
       "SELECT id, uuid, parent_id, name, created_utc, modified_utc, metadata FROM folders "
       "WHERE uuid = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return std::nullopt;
   }
 
   sqlite3_bind_text(stmt, 1, uuid.c_str(), -1, SQLITE_TRANSIENT);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
@@ -229,7 +474,6 @@ std::optional<DbFolderRecord> FileDb::GetFolderByUuid(const std::string& uuid) {
   folder.modified_utc = sqlite3_column_int64(stmt, 5);
   folder.metadata = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
 
-  sqlite3_finalize(stmt);
   return folder;
 }
 
@@ -245,9 +489,8 @@ std::optional<DbFolderRecord> FileDb::GetFolderByName(int64_t parent_id, const s
         "WHERE parent_id = ? AND name = ?;";
   }
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return std::nullopt;
   }
 
@@ -258,9 +501,8 @@ std::optional<DbFolderRecord> FileDb::GetFolderByName(int64_t parent_id, const s
     sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
   }
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
@@ -274,7 +516,6 @@ std::optional<DbFolderRecord> FileDb::GetFolderByName(int64_t parent_id, const s
   folder.modified_utc = sqlite3_column_int64(stmt, 5);
   folder.metadata = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
 
-  sqlite3_finalize(stmt);
   return folder;
 }
 
@@ -290,26 +531,45 @@ std::optional<DbFolderRecord> FileDb::GetFolderByPath(const std::string& path) {
     return std::nullopt;
   }
 
-  // Check for "." root folder (production DBs have one as the root container)
-  int64_t parent_id = -1;  // Default: start from NULL (backward compat)
-  auto root_folders = ListFolders(-1);
-  for (const auto& rf : root_folders) {
-    if (rf.name == ".") {
-      parent_id = rf.id;
-      break;
+  std::string joined;
+  for (const auto& part : parts) {
+    if (!joined.empty()) {
+      joined += '/';
     }
+    joined += part;
   }
 
-  std::optional<DbFolderRecord> folder;
+  // Single indexed lookup on the materialized path. When a "." root folder
+  // exists (production DBs have one as the root container) paths are stored
+  // under it as "./<path>"; otherwise they start at a NULL-parent folder.
+  const char* sql =
+      "SELECT id, uuid, parent_id, name, created_utc, modified_utc, metadata FROM folders "
+      "WHERE path = CASE WHEN EXISTS (SELECT 1 FROM folders WHERE parent_id IS NULL AND "
+      "name = '.') THEN './' || ?1 ELSE ?1 END "
+      "LIMIT 1;";
 
-  for (const auto& part : parts) {
-    folder = GetFolderByName(parent_id, part);
-    if (!folder.has_value()) {
-      return std::nullopt;  // Path component not found
-    }
-    parent_id = folder->id;
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return std::nullopt;
   }
 
+  sqlite3_bind_text(stmt, 1, joined.c_str(), -1, SQLITE_TRANSIENT);
+
+  int rc = sqlite3_step(stmt);
+  if (rc != SQLITE_ROW) {
+    return std::nullopt;
+  }
+
+  DbFolderRecord folder;
+  folder.id = sqlite3_column_int64(stmt, 0);
+  folder.uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+  folder.parent_id =
+      sqlite3_column_type(stmt, 2) == SQLITE_NULL ? -1 : sqlite3_column_int64(stmt, 2);
+  folder.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+  folder.created_utc = sqlite3_column_int64(stmt, 4);
+  folder.modified_utc = sqlite3_column_int64(stmt, 5);
+  folder.metadata = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
+
   return folder;
 }
 
@@ -317,9 +577,8 @@ bool FileDb::UpdateFolder(int64_t folder_id, const std::string& name, int64_t mo
                           const std::string& metadata) {
   const char* sql = "UPDATE folders SET name = ?, modified_utc = ?, metadata = ? WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
@@ -328,8 +587,7 @@ bool FileDb::UpdateFolder(int64_t folder_id, const std::string& name, int64_t mo
   sqlite3_bind_text(stmt, 3, metadata.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_int64(stmt, 4, folder_id);
 
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   return rc == SQLITE_DONE;
 }
@@ -338,19 +596,38 @@ bool FileDb::DeleteFolder(int64_t folder_id) {
   // Foreign key cascade will handle deletion of children
   const char* sql = "DELETE FROM folders WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
   sqlite3_bind_int64(stmt, 1, folder_id);
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   return rc == SQLITE_DONE;
 }
 
+std::vector<std::string> FileDb::ListFileUuidsInTree(int64_t folder_id) {
+  const char* sql =
+      "WITH RECURSIVE tree(id) AS ("
+      "  SELECT ?"
+      "  UNION ALL SELECT d.id FROM folders d JOIN tree ON d.parent_id = tree.id"
+      ") "
+      "SELECT f.uuid FROM files f JOIN tree ON f.folder_id = tree.id;";
+
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return {};
+  }
+
+  sqlite3_bind_int64(stmt, 1, folder_id);
+  std::vector<std::string> uuids;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    uuids.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+  }
+  return uuids;
+}
+
 std::vector<DbFolderRecord> FileDb::ListFolders(int64_t parent_id) {
   const char* sql;
   if (parent_id == -1) {
@@ -363,9 +640,8 @@ std::vector<DbFolderRecord> FileDb::ListFolders(int64_t parent_id) {
         "WHERE parent_id = ? ORDER BY name;";
   }
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return {};
   }
 
@@ -374,7 +650,7 @@ std::vector<DbFolderRecord> FileDb::ListFolders(int64_t parent_id) {
   }
 
   std::vector<DbFolderRecord> folders;
-  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
     DbFolderRecord folder;
     folder.id = sqlite3_column_int64(stmt, 0);
     folder.uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
@@ -387,11 +663,27 @@ std::vector<DbFolderRecord> FileDb::ListFolders(int64_t parent_id) {
     folders.push_back(folder);
   }
 
-  sqlite3_finalize(stmt);
   return folders;
 }
 
 std::string FileDb::GetFolderPath(int64_t folder_id) {
+  {
+    const char* sql = "SELECT path FROM folders WHERE id = ?;";
+    ScopedStatement stmt = cache_->Acquire(sql);
+    if (!stmt) {
+      return "";
+    }
+    sqlite3_bind_int64(stmt, 1, folder_id);
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_ROW) {
+      return "";
+    }
+    if (sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+      return reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    }
+  }
+
+  // No materialized path: the parent chain is broken. Walk what is left.
   std::vector<std::string> path_parts;
 
   int64_t current_id = folder_id;
@@ -416,6 +708,50 @@ std::string FileDb::GetFolderPath(int64_t folder_id) {
   return result;
 }
 
+bool FileDb::SetFolderConfigStamp(int64_t folder_id, int64_t mtime_utc, int64_t size,
+                                  const std::string& hash) {
+  const char* sql =
+      "INSERT OR REPLACE INTO folder_config_stamps (folder_id, mtime_utc, size, hash) "
+      "VALUES (?, ?, ?, ?);";
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return false;
+  }
+
+  sqlite3_bind_int64(stmt, 1, folder_id);
+  sqlite3_bind_int64(stmt, 2, mtime_utc);
+  sqlite3_bind_int64(stmt, 3, size);
+  sqlite3_bind_text(stmt, 4, hash.c_str(), -1, SQLITE_TRANSIENT);
+
+  return sqlite3_step(stmt) == SQLITE_DONE;
+}
+
+std::vector<DbFolderConfigStamp> FileDb::ListFolderConfigStamps() {
+  const char* sql =
+      "SELECT d.uuid, d.path, s.mtime_utc, s.size, s.hash FROM folders d "
+      "LEFT JOIN folder_config_stamps s ON s.folder_id = d.id "
+      "WHERE d.path IS NOT NULL ORDER BY d.path;";
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return {};
+  }
+
+  std::vector<DbFolderConfigStamp> stamps;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    DbFolderConfigStamp stamp;
+    stamp.folder_uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    stamp.folder_path = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    if (sqlite3_column_type(stmt, 4) != SQLITE_NULL) {
+      stamp.mtime_utc = sqlite3_column_int64(stmt, 2);
+      stamp.size = sqlite3_column_int64(stmt, 3);
+      stamp.hash = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+    }
+    stamps.push_back(std::move(stamp));
+  }
+
+  return stamps;
+}
+
 bool FileDb::MoveFolder(int64_t folder_id, int64_t new_parent_id) {
   // Check for cycle: new_parent_id cannot be folder_id or any descendant of folder_id
   if (new_parent_id == folder_id) {
@@ -437,9 +773,8 @@ bool FileDb::MoveFolder(int64_t folder_id, int64_t new_parent_id) {
 
   const char* sql = "UPDATE folders SET parent_id = ?, modified_utc = ? WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
@@ -455,8 +790,7 @@ bool FileDb::MoveFolder(int64_t folder_id, int64_t new_parent_id) {
   sqlite3_bind_int64(stmt, 2, millis.count());
   sqlite3_bind_int64(stmt, 3, folder_id);
 
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   return rc == SQLITE_DONE;
 }
@@ -464,9 +798,8 @@ bool FileDb::MoveFolder(int64_t folder_id, int64_t new_parent_id) {
 bool FileDb::MoveFile(int64_t file_id, int64_t new_folder_id) {
   const char* sql = "UPDATE files SET folder_id = ?, modified_utc = ? WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
@@ -478,8 +811,7 @@ bool FileDb::MoveFile(int64_t file_id, int64_t new_folder_id) {
   sqlite3_bind_int64(stmt, 2, millis.count());
   sqlite3_bind_int64(stmt, 3, file_id);
 
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   return rc == SQLITE_DONE;
 }
@@ -493,9 +825,8 @@ int64_t FileDb::CreateFile(int64_t folder_id, const std::string& name, int64_t c
       "INSERT INTO files (folder_id, name, created_utc, modified_utc, uuid, metadata) "
       "VALUES (?, ?, ?, ?, 'temp', '');";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return -1;
   }
 
@@ -504,12 +835,11 @@ int64_t FileDb::CreateFile(int64_t folder_id, const std::string& name, int64_t c
   sqlite3_bind_int64(stmt, 3, created_utc);
   sqlite3_bind_int64(stmt, 4, modified_utc);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   int64_t file_id = -1;
   if (rc == SQLITE_DONE) {
     file_id = sqlite3_last_insert_rowid(db_);
   }
-  sqlite3_finalize(stmt);
 
   if (file_id == -1) {
     return -1;
@@ -517,17 +847,16 @@ int64_t FileDb::CreateFile(int64_t folder_id, const std::string& name, int64_t c
 
   // Update with ID-based unique UUID
   const char* update_sql = "UPDATE files SET uuid = ? WHERE id = ?;";
-  rc = sqlite3_prepare_v2(db_, update_sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement update_stmt = cache_->Acquire(update_sql);
+  if (!update_stmt) {
     return -1;
   }
 
   std::string uuid = "_file_" + std::to_string(file_id);
-  sqlite3_bind_text(stmt, 1, uuid.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_int64(stmt, 2, file_id);
+  sqlite3_bind_text(update_stmt, 1, uuid.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(update_stmt, 2, file_id);
 
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  rc = sqlite3_step(update_stmt);
 
   if (rc != SQLITE_DONE) {
     return -1;
@@ -549,9 +878,8 @@ int64_t FileDb::CreateOrUpdateFile(const std::string& uuid, int64_t folder_id,
       "attachments) "
       "VALUES (?, ?, ?, ?, ?, ?, ?);";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return -1;
   }
 
@@ -563,13 +891,12 @@ int64_t FileDb::CreateOrUpdateFile(const std::string& uuid, int64_t folder_id,
   sqlite3_bind_text(stmt, 6, metadata.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_text(stmt, 7, "[]", -1, SQLITE_TRANSIENT);  // Empty attachments array
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   int64_t file_id = -1;
   if (rc == SQLITE_DONE) {
     file_id = sqlite3_last_insert_rowid(db_);
   }
 
-  sqlite3_finalize(stmt);
   return file_id;
 }
 
@@ -587,9 +914,8 @@ int64_t FileDb::InsertFile(const std::string& uuid, int64_t folder_id, const std
       "attachments) "
       "VALUES (?, ?, ?, ?, ?, ?, ?);";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return -1;
   }
 
@@ -601,7 +927,7 @@ int64_t FileDb::InsertFile(const std::string& uuid, int64_t folder_id, const std
   sqlite3_bind_text(stmt, 6, metadata.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_text(stmt, 7, "[]", -1, SQLITE_TRANSIENT);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   int64_t file_id = -1;
   if (rc == SQLITE_DONE) {
     file_id = sqlite3_last_insert_rowid(db_);
@@ -610,7 +936,6 @@ int64_t FileDb::InsertFile(const std::string& uuid, int64_t folder_id, const std
     *out_conflict = true;
   }
 
-  sqlite3_finalize(stmt);
   return file_id;
 }
 
@@ -620,17 +945,15 @@ std::optional<DbFileRecord> FileDb::GetFile(int64_t file_id) {
       "files "
       "WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return std::nullopt;
   }
 
   sqlite3_bind_int64(stmt, 1, file_id);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
@@ -645,7 +968,6 @@ std::optional<DbFileRecord> FileDb::GetFile(int64_t file_id) {
   file.tags = GetFileTags(file_id);
   file.attachments = GetFileAttachments(file_id);
 
-  sqlite3_finalize(stmt);
   return file;
 }
 
@@ -655,17 +977,15 @@ std::optional<DbFileRecord> FileDb::GetFileByUuid(const std::string& uuid) {
       "files "
       "WHERE uuid = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return std::nullopt;
   }
 
   sqlite3_bind_text(stmt, 1, uuid.c_str(), -1, SQLITE_TRANSIENT);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
@@ -680,7 +1000,6 @@ std::optional<DbFileRecord> FileDb::GetFileByUuid(const std::string& uuid) {
   file.tags = GetFileTags(file.id);
   file.attachments = GetFileAttachments(file.id);
 
-  sqlite3_finalize(stmt);
   return file;
 }
 
@@ -690,18 +1009,16 @@ std::optional<DbFileRecord> FileDb::GetFileByName(int64_t folder_id, const std::
       "files "
       "WHERE folder_id = ? AND name = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return std::nullopt;
   }
 
   sqlite3_bind_int64(stmt, 1, folder_id);
   sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
@@ -716,7 +1033,6 @@ std::optional<DbFileRecord> FileDb::GetFileByName(int64_t folder_id, const std::
   file.tags = GetFileTags(file.id);
   file.attachments = GetFileAttachments(file.id);
 
-  sqlite3_finalize(stmt);
   return file;
 }
 
@@ -724,9 +1040,8 @@ bool FileDb::UpdateFile(int64_t file_id, const std::string& name, int64_t modifi
                         const std::vector<std::string>& tags) {
   const char* sql = "UPDATE files SET name = ?, modified_utc = ? WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
@@ -734,8 +1049,7 @@ bool FileDb::UpdateFile(int64_t file_id, const std::string& name, int64_t modifi
   sqlite3_bind_int64(stmt, 2, modified_utc);
   sqlite3_bind_int64(stmt, 3, file_id);
 
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   if (rc != SQLITE_DONE) {
     return false;
@@ -749,15 +1063,13 @@ bool FileDb::DeleteFile(int64_t file_id) {
   // Delete file (cascade will handle file_tags)
   const char* sql = "DELETE FROM files WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
   sqlite3_bind_int64(stmt, 1, file_id);
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   return rc == SQLITE_DONE;
 }
@@ -768,16 +1080,15 @@ std::vector<DbFileRecord> FileDb::ListFiles(int64_t folder_id) {
       "files "
       "WHERE folder_id = ? ORDER BY name;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return {};
   }
 
   sqlite3_bind_int64(stmt, 1, folder_id);
 
   std::vector<DbFileRecord> files;
-  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
     DbFileRecord file;
     file.id = sqlite3_column_int64(stmt, 0);
     file.uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
@@ -787,35 +1098,344 @@ std::vector<DbFileRecord> FileDb::ListFiles(int64_t folder_id) {
     file.modified_utc = sqlite3_column_int64(stmt, 5);
     file.metadata = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
     file.tags = GetFileTags(file.id);
-    file.attachments = GetFileAttachments(file.id);
+    file.attachments = ParseAttachments(sqlite3_column_text(stmt, 7));
     files.push_back(file);
   }
 
-  sqlite3_finalize(stmt);
   return files;
 }
 
+void FileDb::ForEachFile(const FileVisitor& callback) {
+  // One row per (file, tag); a file's rows are adjacent, so records are
+  // assembled in a single pass. Swapping '/' for char(1) in the sort key makes
+  // the path order match a depth-first walk by name ("a/b" before "a-c").
+  const std::string sql = std::string(kFileRowsSelect) +
+                          "WHERE d.path IS NOT NULL OR d.id IS NULL "
+                          "ORDER BY replace(d.path, '/', char(1)), f.name, f.id, t.name;";
+
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return;
+  }
+  VisitFileRows(stmt, callback);
+}
+
+// --- Batch Lookups ---
+
+void FileDb::ForEachFileByUuids(const std::vector<std::string>& uuids,
+                                const FileVisitor& callback) {
+  for (size_t begin = 0; begin < uuids.size(); begin += kBatchLookupSize) {
+    const size_t count = std::min(kBatchLookupSize, uuids.size() - begin);
+    const size_t slots = PaddedInListSize(count);
+    const std::string sql = std::string(kFileRowsSelect) + "WHERE f.uuid IN (" +
+                            InListPlaceholders(slots) + ") ORDER BY f.id, t.name;";
+
+    ScopedStatement stmt = cache_->Acquire(sql);
+    if (!stmt) {
+      return;
+    }
+    for (size_t i = 0; i < slots; ++i) {
+      if (i < count) {
+        sqlite3_bind_text(stmt, static_cast<int>(i + 1), uuids[begin + i].c_str(), -1,
+                          SQLITE_TRANSIENT);
+      } else {
+        sqlite3_bind_null(stmt, static_cast<int>(i + 1));
+      }
+    }
+    if (!VisitFileRows(stmt, callback)) {
+      return;
+    }
+  }
+}
+
+void FileDb::ForEachFileAt(const std::vector<std::pair<std::string, std::string>>& locations,
+                           const FileVisitor& callback) {
+  for (size_t begin = 0; begin < locations.size(); begin += kBatchLookupSize) {
+    const size_t end = std::min(locations.size(), begin + kBatchLookupSize);
+
+    // Match every (folder, name) combination of the chunk in SQL, then keep
+    // only the pairs actually asked for.
+    std::set<std::pair<std::string, std::string>> wanted(locations.begin() + begin,
+                                                         locations.begin() + end);
+    std::vector<std::string> folder_paths;
+    std::vector<std::string> names;
+    {
+      std::set<std::string> seen_folders;
+      std::set<std::string> seen_names;
+      for (const auto& [folder_path, name] : wanted) {
+        if (seen_folders.insert(folder_path).second) {
+          folder_paths.push_back(folder_path);
+        }
+        if (seen_names.insert(name).second) {
+          names.push_back(name);
+        }
+      }
+    }
+
+    const size_t folder_slots = PaddedInListSize(folder_paths.size());
+    const size_t name_slots = PaddedInListSize(names.size());
+    const std::string sql = std::string(kFileRowsSelect) + "WHERE d.path IN (" +
+                            InListPlaceholders(folder_slots) + ") AND f.name IN (" +
+                            InListPlaceholders(name_slots) + ") ORDER BY f.id, t.name;";
+
+    ScopedStatement stmt = cache_->Acquire(sql);
+    if (!stmt) {
+      return;
+    }
+    int index = 1;
+    for (const auto* values : {&folder_paths, &names}) {
+      const size_t slots = values == &folder_paths ? folder_slots : name_slots;
+      for (size_t i = 0; i < slots; ++i, ++index) {
+        if (i < values->size()) {
+          sqlite3_bind_text(stmt, index, (*values)[i].c_str(), -1, SQLITE_TRANSIENT);
+        } else {
+          sqlite3_bind_null(stmt, index);
+        }
+      }
+    }
+
+    bool stopped = !VisitFileRows(
+        stmt, [&](const DbFileRecord& file, const std::string& folder_uuid,
+                  const std::string& folder_path) {
+          if (!wanted.count({folder_path, file.name})) {
+            return true;
+          }
+          return callback(file, folder_uuid, folder_path);
+        });
+    if (stopped) {
+      return;
+    }
+  }
+}
+
+std::vector<std::pair<std::string, std::string>> FileDb::GetFolderPathsByUuids(
+    const std::vector<std::string>& uuids) {
+  std::vector<std::pair<std::string, std::string>> results;
+  std::vector<std::pair<size_t, int64_t>> unmaterialized;  // (result index, folder id)
+
+  for (size_t begin = 0; begin < uuids.size(); begin += kBatchLookupSize) {
+    const size_t count = std::min(kBatchLookupSize, uuids.size() - begin);
+    const size_t slots = PaddedInListSize(count);
+    const std::string sql =
+        "SELECT id, uuid, path FROM folders WHERE uuid IN (" + InListPlaceholders(slots) + ");";
+
+    ScopedStatement stmt = cache_->Acquire(sql);
+    if (!stmt) {
+      break;
+    }
+    for (size_t i = 0; i < slots; ++i) {
+      if (i < count) {
+        sqlite3_bind_text(stmt, static_cast<int>(i + 1), uuids[begin + i].c_str(), -1,
+                          SQLITE_TRANSIENT);
+      } else {
+        sqlite3_bind_null(stmt, static_cast<int>(i + 1));
+      }
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      const unsigned char* path = sqlite3_column_text(stmt, 2);
+      if (!path) {
+        unmaterialized.emplace_back(results.size(), sqlite3_column_int64(stmt, 0));
+      }
+      results.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                           path ? reinterpret_cast<const char*>(path) : "");
+    }
+  }
+
+  // Same fallback as GetFolderPath, once the batch statements are done.
+  for (const auto& [index, folder_id] : unmaterialized) {
+    results[index].second = GetFolderPath(folder_id);
+  }
+  return results;
+}
+
+// --- Metadata Queries ---
+
+std::vector<DbMetadataMatch> FileDb::FindFilesByMetadata(const MetadataFilter& filter,
+                                                         size_t limit) {
+  std::vector<DbMetadataMatch> results;
+  MetadataWhere where("f.metadata", IndexedMetadataKeys());
+  if (!where.Build(filter)) {
+    return results;
+  }
+  // "+f.name" keeps idx_files_name from satisfying the ORDER BY; otherwise the
+  // planner walks every file in name order instead of range-scanning a
+  // metadata key index and sorting the few matches.
+  std::string sql =
+      "SELECT f.uuid, f.folder_id, d.path, f.name, f.metadata FROM files f "
+      "LEFT JOIN folders d ON d.id = f.folder_id WHERE " +
+      where.sql() + " ORDER BY +f.name, f.id";
+  if (limit > 0) {
+    sql += " LIMIT ?";
+  }
+  sql += ";";
+
+  std::vector<std::pair<size_t, int64_t>> unmaterialized;  // (result index, folder id)
+  {
+    ScopedStatement stmt = cache_->Acquire(sql);
+    if (!stmt) {
+      return results;
+    }
+    BindMetadataParams(stmt, where.params(), limit);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      DbMetadataMatch match;
+      match.uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+      const unsigned char* folder_path = sqlite3_column_text(stmt, 2);
+      if (folder_path) {
+        match.path = reinterpret_cast<const char*>(folder_path);
+      } else {
+        unmaterialized.emplace_back(results.size(), sqlite3_column_int64(stmt, 1));
+      }
+      const unsigned char* name = sqlite3_column_text(stmt, 3);
+      match.path += std::string("/") + (name ? reinterpret_cast<const char*>(name) : "");
+      const unsigned char* metadata = sqlite3_column_text(stmt, 4);
+      match.metadata = metadata ? reinterpret_cast<const char*>(metadata) : "";
+      results.push_back(std::move(match));
+    }
+  }
+
+  // Same fallback as GetFolderPathsByUuids
+  for (const auto& [index, folder_id] : unmaterialized) {
+    results[index].path = GetFolderPath(folder_id) + results[index].path;
+  }
+  return results;
+}
+
+std::vector<DbMetadataMatch> FileDb::FindFoldersByMetadata(const MetadataFilter& filter,
+                                                           size_t limit) {
+  std::vector<DbMetadataMatch> results;
+  MetadataWhere where("metadata", IndexedMetadataKeys());
+  if (!where.Build(filter)) {
+    return results;
+  }
+  std::string sql =
+      "SELECT uuid, id, path, metadata FROM folders WHERE " + where.sql() + " ORDER BY name, id";
+  if (limit > 0) {
+    sql += " LIMIT ?";
+  }
+  sql += ";";
+
+  std::vector<std::pair<size_t, int64_t>> unmaterialized;
+  {
+    ScopedStatement stmt = cache_->Acquire(sql);
+    if (!stmt) {
+      return results;
+    }
+    BindMetadataParams(stmt, where.params(), limit);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      DbMetadataMatch match;
+      match.uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+      const unsigned char* path = sqlite3_column_text(stmt, 2);
+      if (path) {
+        match.path = reinterpret_cast<const char*>(path);
+      } else {
+        unmaterialized.emplace_back(results.size(), sqlite3_column_int64(stmt, 1));
+      }
+      const unsigned char* metadata = sqlite3_column_text(stmt, 3);
+      match.metadata = metadata ? reinterpret_cast<const char*>(metadata) : "";
+      results.push_back(std::move(match));
+    }
+  }
+
+  for (const auto& [index, folder_id] : unmaterialized) {
+    results[index].path = GetFolderPath(folder_id);
+  }
+  return results;
+}
+
+bool FileDb::CreateMetadataKeyIndex(const std::string& key) {
+  if (!IsValidMetadataKey(key)) {
+    return false;
+  }
+  const std::string expr = MetadataIndexExpr("metadata", key);
+  const std::string sql = "CREATE INDEX IF NOT EXISTS " +
+                          MetadataIndexName(schema::kFilesMetadataIndexPrefix, key) +
+                          " ON files(" + expr + ");\nCREATE INDEX IF NOT EXISTS " +
+                          MetadataIndexName(schema::kFoldersMetadataIndexPrefix, key) +
+                          " ON folders(" + expr + ");";
+  // Failures are left for GetLastError().
+  return sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+bool FileDb::DropMetadataKeyIndex(const std::string& key) {
+  const std::string sql = "DROP INDEX IF EXISTS " +
+                          MetadataIndexName(schema::kFilesMetadataIndexPrefix, key) +
+                          ";\nDROP INDEX IF EXISTS " +
+                          MetadataIndexName(schema::kFoldersMetadataIndexPrefix, key) + ";";
+  // Failures are left for GetLastError().
+  return sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+std::vector<std::string> FileDb::ListMetadataKeyIndexes() {
+  std::vector<std::string> keys;
+  const std::string prefix = schema::kFilesMetadataIndexPrefix;
+  ScopedStatement stmt = cache_->Acquire(
+      "SELECT name FROM sqlite_master WHERE type = 'index' AND tbl_name = 'files' "
+      "AND substr(name, 1, ?1) = ?2 ORDER BY name;");
+  if (!stmt) {
+    return keys;
+  }
+  sqlite3_bind_int(stmt, 1, static_cast<int>(prefix.size()));
+  sqlite3_bind_text(stmt, 2, prefix.c_str(), -1, SQLITE_TRANSIENT);
+  auto nibble = [](char c) -> int {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+  };
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    const std::string hex =
+        reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)) + prefix.size();
+    std::string key;
+    bool valid = hex.size() % 2 == 0;
+    for (size_t i = 0; valid && i < hex.size(); i += 2) {
+      const int hi = nibble(hex[i]);
+      const int lo = nibble(hex[i + 1]);
+      valid = hi >= 0 && lo >= 0;
+      key += static_cast<char>(hi * 16 + lo);
+    }
+    if (valid && IsValidMetadataKey(key)) {
+      keys.push_back(key);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+const std::set<std::string>& FileDb::IndexedMetadataKeys() {
+  // The schema cookie moves on every CREATE / DROP INDEX, from any connection.
+  int64_t schema_version = -1;
+  {
+    ScopedStatement stmt = cache_->Acquire("PRAGMA schema_version;");
+    if (stmt && sqlite3_step(stmt) == SQLITE_ROW) {
+      schema_version = sqlite3_column_int64(stmt, 0);
+    }
+  }
+  if (schema_version == -1 || schema_version != indexed_keys_schema_version_) {
+    const auto keys = ListMetadataKeyIndexes();
+    indexed_keys_ = std::set<std::string>(keys.begin(), keys.end());
+    indexed_keys_schema_version_ = schema_version;
+  }
+  return indexed_keys_;
+}
+
 // --- File-Tag Relationship Operations ---
 
 bool FileDb::AddTagToFile(int64_t file_id, const std::string& tag_name) {
-  TagDb tag_db(db_);
+  TagDb tag_db(db_, cache_);
   int64_t tag_id = tag_db.GetOrCreateTag(tag_name);
   if (tag_id == -1) {
     return false;
   }
 
   const char* sql = "INSERT OR IGNORE INTO file_tags (file_id, tag_id) VALUES (?, ?);";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
   sqlite3_bind_int64(stmt, 1, file_id);
   sqlite3_bind_int64(stmt, 2, tag_id);
 
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   return rc == SQLITE_DONE;
 }
@@ -823,23 +1443,25 @@ bool FileDb::AddTagToFile(int64_t file_id, const std::string& tag_name) {
 bool FileDb::SetFileTags(int64_t file_id, const std::vector<std::string>& tags) {
   // Delete existing tags
   const char* delete_sql = "DELETE FROM file_tags WHERE file_id = ?;";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, delete_sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(delete_sql);
+  if (!stmt) {
     return false;
   }
 
   sqlite3_bind_int64(stmt, 1, file_id);
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   if (rc != SQLITE_DONE) {
     return false;
   }
 
-  // Insert new tags
+  // Insert new tags, reusing one statement for every row
   const char* insert_sql = "INSERT INTO file_tags (file_id, tag_id) VALUES (?, ?);";
-  TagDb tag_db(db_);
+  TagDb tag_db(db_, cache_);
+  ScopedStatement insert_stmt = cache_->Acquire(insert_sql);
+  if (!insert_stmt) {
+    return false;
+  }
 
   for (const auto& tag_name : tags) {
     int64_t tag_id = tag_db.GetOrCreateTag(tag_name);
@@ -847,16 +1469,11 @@ bool FileDb::SetFileTags(int64_t file_id, const std::vector<std::string>& tags)
       return false;
     }
 
-    rc = sqlite3_prepare_v2(db_, insert_sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-      return false;
-    }
+    sqlite3_reset(insert_stmt);
+    sqlite3_bind_int64(insert_stmt, 1, file_id);
+    sqlite3_bind_int64(insert_stmt, 2, tag_id);
 
-    sqlite3_bind_int64(stmt, 1, file_id);
-    sqlite3_bind_int64(stmt, 2, tag_id);
-
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    rc = sqlite3_step(insert_stmt);
 
     if (rc != SQLITE_DONE) {
       return false;
@@ -872,63 +1489,44 @@ std::vector<std::string> FileDb::GetFileTags(int64_t file_id) {
       "JOIN file_tags ft ON t.id = ft.tag_id "
       "WHERE ft.file_id = ? ORDER BY t.name;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return {};
   }
 
   sqlite3_bind_int64(stmt, 1, file_id);
 
   std::vector<std::string> tags;
-  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
     tags.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
   }
 
-  sqlite3_finalize(stmt);
   return tags;
 }
 
 std::vector<std::string> FileDb::GetFileAttachments(int64_t file_id) {
   const char* sql = "SELECT attachments FROM files WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return {};
   }
 
   sqlite3_bind_int64(stmt, 1, file_id);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return {};
   }
 
-  std::vector<std::string> attachments;
-  const char* json_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-  if (json_str && json_str[0] != '\0') {
-    try {
-      nlohmann::json j = nlohmann::json::parse(json_str);
-      if (j.is_array()) {
-        attachments = j.get<std::vector<std::string>>();
-      }
-    } catch (...) {
-      // Ignore parse errors, return empty vector
-    }
-  }
-
-  sqlite3_finalize(stmt);
-  return attachments;
+  return ParseAttachments(sqlite3_column_text(stmt, 0));
 }
 
 bool FileDb::SetFileAttachments(int64_t file_id, const std::vector<std::string>& attachments) {
   const char* sql = "UPDATE files SET attachments = ? WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
@@ -939,8 +1537,7 @@ bool FileDb::SetFileAttachments(int64_t file_id, const std::vector<std::string>&
   sqlite3_bind_text(stmt, 1, json_str.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_int64(stmt, 2, file_id);
 
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   return rc == SQLITE_DONE;
 }
@@ -2,14 +2,23 @@
 #define VXCORE_FILE_DB_H
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "statement_cache.h"
+
 // Forward declare sqlite3
 struct sqlite3;
 
 namespace vxcore {
+
+struct MetadataFilter;
+
 namespace db {
 
 // File metadata structure (database layer)
@@ -36,11 +45,30 @@ struct DbFolderRecord {
   std::string metadata;
 };
 
+// What a folder row was last synced from (see schema folder_config_stamps).
+// mtime_utc/size are -1 and hash is empty when the folder was never stamped.
+struct DbFolderConfigStamp {
+  std::string folder_uuid;
+  std::string folder_path;  // Materialized path, e.g. "./notes/sub"
+  int64_t mtime_utc = -1;
+  int64_t size = -1;
+  std::string hash;
+};
+
+// A file or folder matched by a metadata query
+struct DbMetadataMatch {
+  std::string uuid;
+  std::string path;  // Materialized, e.g. "./notes/a.md" for a file, "./notes" for a folder
+  std::string metadata;
+};
+
 // File database operations (CRUD for files, folders, and file-tag relationships)
 // NOT thread-safe: caller must ensure synchronization
 class FileDb {
  public:
-  explicit FileDb(sqlite3* db);
+  // |cache| is normally the owning DbManager's statement cache; when null the
+  // instance prepares through a private cache of its own.
+  explicit FileDb(sqlite3* db, StatementCache* cache = nullptr);
   ~FileDb() = default;
 
   // Disable copy/move
@@ -76,7 +104,8 @@ class FileDb {
   // Gets folder by parent_id and name, returns nullopt if not found
   std::optional<DbFolderRecord> GetFolderByName(int64_t parent_id, const std::string& name);
 
-  // Gets folder by traversing path from root (e.g., "notes/subfolder/deep")
+  // Gets folder by its path from root (e.g., "notes/subfolder/deep"), using the
+  // materialized folders.path column
   // Path should be cleaned (use CleanPath) with "/" separator
   // Empty path or "." returns nullopt (represents root, which has no folder record)
   // Returns nullopt if any path component is not found
@@ -89,14 +118,27 @@ class FileDb {
   // Deletes folder and all its contents recursively, returns true on success
   bool DeleteFolder(int64_t folder_id);
 
+  // Returns the UUIDs of the files in |folder_id| and all its descendants,
+  // i.e. what DeleteFolder() would cascade to.
+  std::vector<std::string> ListFileUuidsInTree(int64_t folder_id);
+
   // Lists all child folders of a parent folder
   // parent_id = -1 for root folders
   std::vector<DbFolderRecord> ListFolders(int64_t parent_id);
 
-  // Computes relative path by walking parent chain
-  // Returns empty string for root folders (parent_id = -1)
+  // Returns the folder's materialized path (names from the top-level folder
+  // down, e.g. "./notes/sub"); walks the parent chain only if it is missing
+  // Returns empty string if the folder does not exist
   std::string GetFolderPath(int64_t folder_id);
 
+  // Records the config file |folder_id| was synced from (replaces any
+  // previous stamp). Returns true on success.
+  bool SetFolderConfigStamp(int64_t folder_id, int64_t mtime_utc, int64_t size,
+                            const std::string& hash);
+
+  // Lists every folder with a materialized path, stamped or not.
+  std::vector<DbFolderConfigStamp> ListFolderConfigStamps();
+
   // Moves folder to new parent. Returns true on success.
   // Fails if would create cycle (folder moved to itself or its descendants)
   bool MoveFolder(int64_t folder_id, int64_t new_parent_id);
@@ -146,6 +188,61 @@ class FileDb {
   // Lists all files in a folder
   std::vector<DbFileRecord> ListFiles(int64_t folder_id);
 
+  // Streams every file in one ordered query: depth-first by folder name, then
+  // by file name, with tags and attachments filled in. |callback| receives the
+  // record plus its folder's UUID and materialized path (both empty for files
+  // outside any folder); returning false stops the iteration. Files under a
+  // folder with a broken parent chain are skipped. The callback must not
+  // write to the database.
+  using FileVisitor = std::function<bool(const DbFileRecord& file, const std::string& folder_uuid,
+                                         const std::string& folder_path)>;
+  void ForEachFile(const FileVisitor& callback);
+
+  // --- Batch Lookups ---
+  // One query per kBatchLookupSize keys instead of one per key. Keys that
+  // match nothing are skipped; visitors follow the ForEachFile contract, but
+  // in no particular order and with an empty folder_path for files under a
+  // folder with a broken parent chain.
+
+  static constexpr size_t kBatchLookupSize = 256;
+
+  // Visits the files whose UUID is in |uuids|.
+  void ForEachFileByUuids(const std::vector<std::string>& uuids, const FileVisitor& callback);
+
+  // Visits the files at |locations|, given as (materialized folder path, file
+  // name) pairs, e.g. ("./notes", "a.md").
+  void ForEachFileAt(const std::vector<std::pair<std::string, std::string>>& locations,
+                     const FileVisitor& callback);
+
+  // Returns (UUID, path) for each folder whose UUID is in |uuids|, the path
+  // as GetFolderPath() would return it.
+  std::vector<std::pair<std::string, std::string>> GetFolderPathsByUuids(
+      const std::vector<std::string>& uuids);
+
+  // --- Metadata Queries ---
+  // Conditions compile to json_extract(<metadata>, <path>) comparisons. For a
+  // key with an index from CreateMetadataKeyIndex() the path is spelled out as
+  // a literal so the index serves lookups on it (SQLite matches index
+  // expressions structurally, not through bound parameters); for any other
+  // key it is bound, keeping the number of statement texts bounded.
+  // Metadata that is not valid JSON reads as having no keys. Invalid keys
+  // (see IsValidMetadataKey) match nothing.
+
+  // Files / folders whose metadata satisfies |filter|, ordered by name, then
+  // insertion order. |limit| 0 means no limit.
+  std::vector<DbMetadataMatch> FindFilesByMetadata(const MetadataFilter& filter, size_t limit = 0);
+  std::vector<DbMetadataMatch> FindFoldersByMetadata(const MetadataFilter& filter,
+                                                     size_t limit = 0);
+
+  // Creates the expression indexes for |key| on files and folders; a no-op
+  // for a key that already has them. Each one costs a JSON extraction per
+  // written row, so index only keys that are queried.
+  bool CreateMetadataKeyIndex(const std::string& key);
+  bool DropMetadataKeyIndex(const std::string& key);
+
+  // Keys with an index on files, sorted
+  std::vector<std::string> ListMetadataKeyIndexes();
+
   // --- File-Tag Relationship Operations ---
 
   // Adds a tag to a file by tag name (gets or creates tag via TagDb)
@@ -162,7 +259,14 @@ class FileDb {
   std::string GetLastError() const;
 
  private:
+  // ListMetadataKeyIndexes(), re-read only when the schema has changed
+  const std::set<std::string>& IndexedMetadataKeys();
+
   sqlite3* db_;
+  std::unique_ptr<StatementCache> owned_cache_;
+  StatementCache* cache_;
+  std::set<std::string> indexed_keys_;
+  int64_t indexed_keys_schema_version_ = -1;
 };
 
 }  // namespace db
@@ -0,0 +1,125 @@
+#include "history_db.h"
+
+#include <sqlite3.h>
+
+#include "utils/logger.h"
+
+namespace vxcore {
+namespace db {
+
+HistoryDb::HistoryDb(sqlite3* db, StatementCache* cache)
+    : db_(db),
+      owned_cache_(cache ? nullptr : std::make_unique<StatementCache>(db)),
+      cache_(cache ? cache : owned_cache_.get()) {}
+
+bool HistoryDb::RecordOpen(const std::string& file_uuid, int64_t opened_utc,
+                           size_t max_entries) {
+  if (!db_) {
+    VXCORE_LOG_ERROR("Cannot record file open: database not open");
+    return false;
+  }
+
+  int64_t open_count = 0;
+  {
+    ScopedStatement stmt =
+        cache_->Acquire("SELECT open_count FROM file_history WHERE file_uuid = ?;");
+    if (!stmt) {
+      VXCORE_LOG_ERROR("Failed to prepare history lookup statement: %s", GetLastError().c_str());
+      return false;
+    }
+    sqlite3_bind_text(stmt, 1, file_uuid.c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+      open_count = sqlite3_column_int64(stmt, 0);
+    }
+  }
+
+  {
+    // REPLACE re-inserts the row under a fresh id; see kCreateFileHistoryTable.
+    ScopedStatement stmt = cache_->Acquire(
+        "INSERT OR REPLACE INTO file_history (file_uuid, opened_utc, open_count) "
+        "VALUES (?, ?, ?);");
+    if (!stmt) {
+      VXCORE_LOG_ERROR("Failed to prepare record open statement: %s", GetLastError().c_str());
+      return false;
+    }
+    sqlite3_bind_text(stmt, 1, file_uuid.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 2, opened_utc);
+    sqlite3_bind_int64(stmt, 3, open_count + 1);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      VXCORE_LOG_ERROR("Failed to record file open: %s", GetLastError().c_str());
+      return false;
+    }
+  }
+
+  // Only a new entry can push the table past the cap.
+  if (open_count > 0 || max_entries == 0) {
+    return true;
+  }
+  ScopedStatement stmt = cache_->Acquire(
+      "DELETE FROM file_history WHERE id IN (SELECT id FROM file_history "
+      "ORDER BY opened_utc DESC, id DESC LIMIT -1 OFFSET ?);");
+  if (!stmt) {
+    VXCORE_LOG_ERROR("Failed to prepare history trim statement: %s", GetLastError().c_str());
+    return false;
+  }
+  sqlite3_bind_int64(stmt, 1, static_cast<int64_t>(max_entries));
+  if (sqlite3_step(stmt) != SQLITE_DONE) {
+    VXCORE_LOG_ERROR("Failed to trim file history: %s", GetLastError().c_str());
+    return false;
+  }
+  return true;
+}
+
+std::vector<DbHistoryEntry> HistoryDb::GetRecent(size_t limit) {
+  std::vector<DbHistoryEntry> results;
+  if (!db_) {
+    VXCORE_LOG_ERROR("Cannot get file history: database not open");
+    return results;
+  }
+
+  ScopedStatement stmt = cache_->Acquire(
+      "SELECT file_uuid, opened_utc, open_count FROM file_history "
+      "ORDER BY opened_utc DESC, id DESC LIMIT ?;");
+  if (!stmt) {
+    VXCORE_LOG_ERROR("Failed to prepare get history statement: %s", GetLastError().c_str());
+    return results;
+  }
+
+  sqlite3_bind_int64(stmt, 1, limit > 0 ? static_cast<int64_t>(limit) : -1);
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    DbHistoryEntry entry;
+    entry.file_uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    entry.opened_utc = sqlite3_column_int64(stmt, 1);
+    entry.open_count = sqlite3_column_int64(stmt, 2);
+    results.push_back(std::move(entry));
+  }
+  return results;
+}
+
+bool HistoryDb::Clear() {
+  if (!db_) {
+    VXCORE_LOG_ERROR("Cannot clear file history: database not open");
+    return false;
+  }
+
+  ScopedStatement stmt = cache_->Acquire("DELETE FROM file_history;");
+  if (!stmt) {
+    VXCORE_LOG_ERROR("Failed to prepare clear history statement: %s", GetLastError().c_str());
+    return false;
+  }
+  if (sqlite3_step(stmt) != SQLITE_DONE) {
+    VXCORE_LOG_ERROR("Failed to clear file history: %s", GetLastError().c_str());
+    return false;
+  }
+  return true;
+}
+
+std::string HistoryDb::GetLastError() const {
+  if (db_ != nullptr) {
+    return sqlite3_errmsg(db_);
+  }
+  return "Database not open";
+}
+
+}  // namespace db
+}  // namespace vxcore
@@ -0,0 +1,61 @@
+#ifndef VXCORE_HISTORY_DB_H
+#define VXCORE_HISTORY_DB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "statement_cache.h"
+
+// Forward declare sqlite3
+struct sqlite3;
+
+namespace vxcore {
+namespace db {
+
+// One row of the file_history table
+struct DbHistoryEntry {
+  std::string file_uuid;
+  int64_t opened_utc;
+  int64_t open_count;
+};
+
+// File open history operations (see schema::kCreateFileHistoryTable)
+// NOT thread-safe: caller must ensure synchronization
+class HistoryDb {
+ public:
+  // |cache| defaults to a private StatementCache when null.
+  explicit HistoryDb(sqlite3* db, StatementCache* cache = nullptr);
+  ~HistoryDb() = default;
+
+  // Disable copy/move
+  HistoryDb(const HistoryDb&) = delete;
+  HistoryDb& operator=(const HistoryDb&) = delete;
+
+  // Records an open of |file_uuid| at |opened_utc|: makes it the most recent
+  // entry and bumps its open count. When that adds a new entry, drops the
+  // least recent ones beyond |max_entries| (0 keeps everything).
+  // Returns true on success
+  bool RecordOpen(const std::string& file_uuid, int64_t opened_utc, size_t max_entries);
+
+  // Returns up to |limit| entries, most recent first (0 returns all)
+  std::vector<DbHistoryEntry> GetRecent(size_t limit);
+
+  // Deletes all entries, returns true on success
+  bool Clear();
+
+  // Returns the last error message
+  std::string GetLastError() const;
+
+ private:
+  sqlite3* db_;
+  std::unique_ptr<StatementCache> owned_cache_;
+  StatementCache* cache_;
+};
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_HISTORY_DB_H
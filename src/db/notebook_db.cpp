@@ -7,7 +7,10 @@
 namespace vxcore {
 namespace db {
 
-NotebookDb::NotebookDb(sqlite3* db) : db_(db) {}
+NotebookDb::NotebookDb(sqlite3* db, StatementCache* cache)
+    : db_(db),
+      owned_cache_(cache ? nullptr : std::make_unique<StatementCache>(db)),
+      cache_(cache ? cache : owned_cache_.get()) {}
 
 std::optional<std::string> NotebookDb::GetMetadata(const std::string& key) {
   if (!db_) {
@@ -16,23 +19,20 @@ std::optional<std::string> NotebookDb::GetMetadata(const std::string& key) {
   }
 
   const char* sql = "SELECT value FROM notebook_metadata WHERE key = ?;";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     VXCORE_LOG_ERROR("Failed to prepare get metadata statement: %s", GetLastError().c_str());
     return std::nullopt;
   }
 
   sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
 
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
   std::string value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-  sqlite3_finalize(stmt);
   return value;
 }
 
@@ -43,17 +43,15 @@ bool NotebookDb::SetMetadata(const std::string& key, const std::string& value) {
   }
 
   const char* sql = "INSERT OR REPLACE INTO notebook_metadata (key, value) VALUES (?, ?);";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     VXCORE_LOG_ERROR("Failed to prepare set metadata statement: %s", GetLastError().c_str());
     return false;
   }
 
   sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_text(stmt, 2, value.c_str(), -1, SQLITE_TRANSIENT);
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   if (rc != SQLITE_DONE) {
     VXCORE_LOG_ERROR("Failed to set notebook metadata: %s", GetLastError().c_str());
@@ -70,16 +68,14 @@ bool NotebookDb::DeleteMetadata(const std::string& key) {
   }
 
   const char* sql = "DELETE FROM notebook_metadata WHERE key = ?;";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     VXCORE_LOG_ERROR("Failed to prepare delete metadata statement: %s", GetLastError().c_str());
     return false;
   }
 
   sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   if (rc != SQLITE_DONE) {
     VXCORE_LOG_ERROR("Failed to delete notebook metadata: %s", GetLastError().c_str());
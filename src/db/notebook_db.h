@@ -1,9 +1,12 @@
 #ifndef VXCORE_NOTEBOOK_DB_H
 #define VXCORE_NOTEBOOK_DB_H
 
+#include <memory>
 #include <optional>
 #include <string>
 
+#include "statement_cache.h"
+
 // Forward declare sqlite3
 struct sqlite3;
 
@@ -14,7 +17,8 @@ namespace db {
 // NOT thread-safe: caller must ensure synchronization
 class NotebookDb {
  public:
-  explicit NotebookDb(sqlite3* db);
+  // |cache| defaults to a private StatementCache when null.
+  explicit NotebookDb(sqlite3* db, StatementCache* cache = nullptr);
   ~NotebookDb() = default;
 
   // Disable copy/move
@@ -38,6 +42,8 @@ class NotebookDb {
 
  private:
   sqlite3* db_;
+  std::unique_ptr<StatementCache> owned_cache_;
+  StatementCache* cache_;
 };
 
 }  // namespace db
@@ -0,0 +1,162 @@
+#include "read_connection_pool.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "statement_cache.h"
+#include "utils/logger.h"
+
+namespace vxcore {
+namespace db {
+
+namespace {
+
+// A WAL reader only waits on the rare occasions the owner holds an exclusive
+// lock (WAL recovery, journal mode changes); give it a moment instead of
+// failing the query outright.
+constexpr int kReadBusyTimeoutMs = 2000;
+
+}  // namespace
+
+// --- ReadConnection ---
+
+ReadConnection::ReadConnection() : statement_cache_(std::make_unique<StatementCache>()) {}
+
+ReadConnection::~ReadConnection() { Close(); }
+
+bool ReadConnection::Open(const std::string& db_path, const DbTuning& tuning) {
+  Close();
+
+  int rc = sqlite3_open_v2(db_path.c_str(), &db_, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                           nullptr);
+  if (rc != SQLITE_OK) {
+    VXCORE_LOG_ERROR("Failed to open read connection '%s': %s", db_path.c_str(),
+                     GetLastError().c_str());
+    Close();
+    return false;
+  }
+
+  for (const auto& pragma : tuning.BuildPragmas(/*read_only=*/true)) {
+    if (sqlite3_exec(db_, pragma.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+      VXCORE_LOG_WARN("Failed to apply '%s' to read connection: %s", pragma.c_str(),
+                      GetLastError().c_str());
+    }
+  }
+  sqlite3_busy_timeout(db_, std::max(tuning.busy_timeout_ms, kReadBusyTimeoutMs));
+  statement_cache_->SetHandle(db_);
+  return true;
+}
+
+void ReadConnection::Close() {
+  if (db_ != nullptr) {
+    statement_cache_->SetHandle(nullptr);
+    int rc = sqlite3_close_v2(db_);
+    if (rc != SQLITE_OK) {
+      VXCORE_LOG_WARN("Error closing read connection: %s", sqlite3_errmsg(db_));
+    }
+    db_ = nullptr;
+  }
+}
+
+std::string ReadConnection::GetLastError() const {
+  if (db_ != nullptr) {
+    return sqlite3_errmsg(db_);
+  }
+  return "Database not open";
+}
+
+// --- ReadConnectionLease ---
+
+ReadConnectionLease::~ReadConnectionLease() { Release(); }
+
+ReadConnectionLease::ReadConnectionLease(ReadConnectionLease&& other) noexcept
+    : pool_(std::move(other.pool_)), connection_(std::move(other.connection_)) {}
+
+ReadConnectionLease& ReadConnectionLease::operator=(ReadConnectionLease&& other) noexcept {
+  if (this != &other) {
+    Release();
+    pool_ = std::move(other.pool_);
+    connection_ = std::move(other.connection_);
+  }
+  return *this;
+}
+
+void ReadConnectionLease::Release() {
+  if (connection_ && pool_) {
+    pool_->Return(std::move(connection_));
+  }
+  connection_.reset();
+  pool_.reset();
+}
+
+// --- ReadConnectionPool ---
+
+ReadConnectionPool::ReadConnectionPool(std::string db_path, DbTuning tuning,
+                                       size_t max_connections)
+    : db_path_(std::move(db_path)),
+      tuning_(std::move(tuning)),
+      max_connections_(max_connections > 0 ? max_connections : 1) {}
+
+ReadConnectionPool::~ReadConnectionPool() { Close(); }
+
+ReadConnectionLease ReadConnectionPool::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  available_.wait(lock, [this] {
+    return closed_ || !idle_.empty() || open_count_ < max_connections_;
+  });
+  if (closed_) {
+    return ReadConnectionLease();
+  }
+
+  if (!idle_.empty()) {
+    auto connection = std::move(idle_.back());
+    idle_.pop_back();
+    return ReadConnectionLease(shared_from_this(), std::move(connection));
+  }
+
+  // Reserve the slot, then open outside the lock.
+  ++open_count_;
+  lock.unlock();
+
+  auto connection = std::make_unique<ReadConnection>();
+  if (!connection->Open(db_path_, tuning_)) {
+    lock.lock();
+    --open_count_;
+    available_.notify_one();
+    return ReadConnectionLease();
+  }
+  VXCORE_LOG_DEBUG("Opened read connection for %s", db_path_.c_str());
+  return ReadConnectionLease(shared_from_this(), std::move(connection));
+}
+
+void ReadConnectionPool::Return(std::unique_ptr<ReadConnection> connection) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (closed_) {
+    connection.reset();
+    --open_count_;
+    return;
+  }
+  idle_.push_back(std::move(connection));
+  available_.notify_one();
+}
+
+void ReadConnectionPool::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  open_count_ -= idle_.size();
+  idle_.clear();
+  available_.notify_all();
+}
+
+size_t ReadConnectionPool::GetOpenCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return open_count_;
+}
+
+}  // namespace db
+}  // namespace vxcore
@@ -0,0 +1,127 @@
+#ifndef VXCORE_READ_CONNECTION_POOL_H
+#define VXCORE_READ_CONNECTION_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "db_tuning.h"
+
+// Forward declare sqlite3 to avoid exposing SQLite types in header
+struct sqlite3;
+
+namespace vxcore {
+namespace db {
+
+class StatementCache;
+
+// A read-only connection to a store database with its own statement cache.
+// Opened with SQLITE_OPEN_READONLY; in WAL mode it reads the last committed
+// snapshot without blocking (or being blocked by) the owner connection.
+class ReadConnection {
+ public:
+  ReadConnection();
+  ~ReadConnection();
+
+  ReadConnection(const ReadConnection&) = delete;
+  ReadConnection& operator=(const ReadConnection&) = delete;
+
+  // Applies the read-side settings of |tuning| (cache, mmap, temp store).
+  bool Open(const std::string& db_path, const DbTuning& tuning);
+  void Close();
+
+  sqlite3* GetHandle() const { return db_; }
+  StatementCache* GetStatementCache() const { return statement_cache_.get(); }
+
+  std::string GetLastError() const;
+
+ private:
+  sqlite3* db_ = nullptr;
+  std::unique_ptr<StatementCache> statement_cache_;
+};
+
+class ReadConnectionPool;
+
+// RAII handle to a connection borrowed from a ReadConnectionPool; returns it
+// to the pool on destruction. Empty when the pool is closed or opening a
+// connection failed. Keeps the pool alive, so it may outlive the store.
+class ReadConnectionLease {
+ public:
+  ReadConnectionLease() = default;
+  ~ReadConnectionLease();
+
+  ReadConnectionLease(ReadConnectionLease&& other) noexcept;
+  ReadConnectionLease& operator=(ReadConnectionLease&& other) noexcept;
+  ReadConnectionLease(const ReadConnectionLease&) = delete;
+  ReadConnectionLease& operator=(const ReadConnectionLease&) = delete;
+
+  ReadConnection* get() const { return connection_.get(); }
+  ReadConnection* operator->() const { return connection_.get(); }
+  explicit operator bool() const { return connection_ != nullptr; }
+
+ private:
+  friend class ReadConnectionPool;
+
+  ReadConnectionLease(std::shared_ptr<ReadConnectionPool> pool,
+                      std::unique_ptr<ReadConnection> connection)
+      : pool_(std::move(pool)), connection_(std::move(connection)) {}
+
+  void Release();
+
+  std::shared_ptr<ReadConnectionPool> pool_;
+  std::unique_ptr<ReadConnection> connection_;
+};
+
+// Pool of read-only connections for querying a store from worker threads
+// while writes stay on the owner connection (DbManager).
+//
+// Connections are opened lazily, up to |max_connections|; Acquire blocks
+// while all of them are borrowed. Each lease must be used by one thread at a
+// time, like any SQLite connection; the pool itself is thread-safe.
+//
+// Readers see committed data only: rows written inside an open transaction
+// on the owner connection become visible once it commits.
+class ReadConnectionPool : public std::enable_shared_from_this<ReadConnectionPool> {
+ public:
+  static constexpr size_t kDefaultMaxConnections = 4;
+
+  ReadConnectionPool(std::string db_path, DbTuning tuning,
+                     size_t max_connections = kDefaultMaxConnections);
+  ~ReadConnectionPool();
+
+  ReadConnectionPool(const ReadConnectionPool&) = delete;
+  ReadConnectionPool& operator=(const ReadConnectionPool&) = delete;
+
+  // Borrows an idle connection, opening one if the pool is below its limit.
+  ReadConnectionLease Acquire();
+
+  // Closes idle connections and makes further Acquire calls fail. Borrowed
+  // connections are closed when their leases are released.
+  void Close();
+
+  // Number of connections currently open (idle + borrowed).
+  size_t GetOpenCount() const;
+
+ private:
+  friend class ReadConnectionLease;
+
+  void Return(std::unique_ptr<ReadConnection> connection);
+
+  const std::string db_path_;
+  const DbTuning tuning_;
+  const size_t max_connections_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable available_;
+  std::vector<std::unique_ptr<ReadConnection>> idle_;
+  size_t open_count_ = 0;
+  bool closed_ = false;
+};
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_READ_CONNECTION_POOL_H
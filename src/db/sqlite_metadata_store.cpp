@@ -2,9 +2,14 @@
 
 #include <sqlite3.h>
 
+#include "bulk_loader.h"
 #include "db_manager.h"
 #include "file_db.h"
+#include "history_db.h"
 #include "notebook_db.h"
+#include "read_connection_pool.h"
+#include "sqlite_store_reader.h"
+#include "tag_bitmap_index.h"
 #include "tag_db.h"
 #include "utils/file_utils.h"
 #include "utils/logger.h"
@@ -12,24 +17,12 @@
 namespace vxcore {
 namespace db {
 
-// Strips the root folder prefix ("." or "./") from paths returned by FileDb::GetFolderPath().
-// The root folder is stored with name "." in the database, so paths for root-level items
-// start with "." or "./" which must be removed to produce clean relative paths.
-static std::string StripRootPrefix(const std::string &path) {
-  if (path.size() >= 2 && path[0] == '.' && path[1] == '/') {
-    return path.substr(2);
-  }
-  if (path == ".") {
-    return "";  // Root folder itself
-  }
-  return path;
-}
-
 SqliteMetadataStore::SqliteMetadataStore()
     : db_manager_(std::make_unique<DbManager>()),
       file_db_(nullptr),
       tag_db_(nullptr),
-      notebook_db_(nullptr) {}
+      notebook_db_(nullptr),
+      history_db_(nullptr) {}
 
 SqliteMetadataStore::~SqliteMetadataStore() { Close(); }
 
@@ -53,19 +46,50 @@ bool SqliteMetadataStore::Open(const std::string &db_path) {
     return false;
   }
 
-  // Create FileDb and TagDb with the open database handle
-  file_db_ = std::make_unique<FileDb>(db_manager_->GetHandle());
-  tag_db_ = std::make_unique<TagDb>(db_manager_->GetHandle());
-  notebook_db_ = std::make_unique<NotebookDb>(db_manager_->GetHandle());
+  // Create FileDb and TagDb with the open database handle; all of them share
+  // the connection's prepared-statement cache.
+  StatementCache *cache = db_manager_->GetStatementCache();
+  file_db_ = std::make_unique<FileDb>(db_manager_->GetHandle(), cache);
+  tag_db_ = std::make_unique<TagDb>(db_manager_->GetHandle(), cache);
+  notebook_db_ = std::make_unique<NotebookDb>(db_manager_->GetHandle(), cache);
+  history_db_ = std::make_unique<HistoryDb>(db_manager_->GetHandle(), cache);
+  tag_index_ = std::make_shared<TagBitmapIndex>();
+  tag_index_->Load(*tag_db_);
+  reader_ = std::make_unique<SqliteStoreReader>(db_manager_->GetHandle(), cache, tag_index_);
+  const auto indexed_keys = file_db_->ListMetadataKeyIndexes();
+  metadata_indexes_ = std::set<std::string>(indexed_keys.begin(), indexed_keys.end());
+
+  // A private in-memory database cannot be shared with other connections.
+  if (db_path != ":memory:") {
+    read_pool_ = std::make_shared<ReadConnectionPool>(db_path, db_manager_->GetTuning());
+  }
 
   VXCORE_LOG_DEBUG("SqliteMetadataStore opened: %s", db_path.c_str());
   return true;
 }
 
 void SqliteMetadataStore::Close() {
+  if (IsOpen()) {
+    FlushPendingWrites();
+  }
+  // Outstanding readers keep their connection until released.
+  if (read_pool_) {
+    read_pool_->Close();
+    read_pool_.reset();
+  }
+  bulk_loader_.reset();
+  reader_.reset();
+  if (tag_index_) {
+    // Outstanding readers may still hold it; make them fall back to SQL.
+    tag_index_->Invalidate();
+    tag_index_.reset();
+  }
   file_db_.reset();
   tag_db_.reset();
   notebook_db_.reset();
+  history_db_.reset();
+  metadata_indexes_.clear();
+  metadata_key_queries_.clear();
   db_manager_->Close();
   VXCORE_LOG_DEBUG("SqliteMetadataStore closed");
 }
@@ -79,6 +103,8 @@ bool SqliteMetadataStore::BeginTransaction() {
     last_error_ = "Store not open";
     return false;
   }
+  // The caller's transaction must not swallow (or roll back) the batch.
+  FlushPendingWrites();
   return db_manager_->BeginTransaction();
 }
 
@@ -87,7 +113,11 @@ bool SqliteMetadataStore::CommitTransaction() {
     last_error_ = "Store not open";
     return false;
   }
-  return db_manager_->CommitTransaction();
+  bool committed = db_manager_->CommitTransaction();
+  if (committed) {
+    OnTransactionEnd(true);
+  }
+  return committed;
 }
 
 bool SqliteMetadataStore::RollbackTransaction() {
@@ -95,30 +125,148 @@ bool SqliteMetadataStore::RollbackTransaction() {
     last_error_ = "Store not open";
     return false;
   }
-  return db_manager_->RollbackTransaction();
+  bool rolled_back = db_manager_->RollbackTransaction();
+  OnTransactionEnd(false);
+  return rolled_back;
+}
+
+// --- Write-Behind ---
+
+void SqliteMetadataStore::SetWriteBehind(const WriteBehindOptions &options) {
+  write_behind_ = options;
+  if (!write_behind_.enabled && IsOpen()) {
+    FlushPendingWrites();
+  }
+}
+
+bool SqliteMetadataStore::HasPendingWrites() const { return batch_open_; }
+
+bool SqliteMetadataStore::FlushPendingWrites() {
+  if (!batch_open_) {
+    return true;
+  }
+  batch_open_ = false;
+  const size_t writes = batch_writes_;
+  batch_writes_ = 0;
+
+  if (sqlite3_get_autocommit(db_manager_->GetHandle())) {
+    // SQLite rolls a transaction back by itself on I/O errors or OOM.
+    last_error_ = "Write-behind batch was rolled back";
+    VXCORE_LOG_WARN("%s; %zu writes lost until the cache is reconciled", last_error_.c_str(),
+                    writes);
+    OnTransactionEnd(false);
+    return false;
+  }
+  if (!db_manager_->CommitTransaction()) {
+    last_error_ = "Failed to commit write-behind batch: " + db_manager_->GetLastError();
+    VXCORE_LOG_ERROR("%s", last_error_.c_str());
+    db_manager_->RollbackTransaction();
+    OnTransactionEnd(false);
+    return false;
+  }
+  OnTransactionEnd(true);
+  VXCORE_LOG_DEBUG("Committed write-behind batch of %zu writes", writes);
+  return true;
+}
+
+bool SqliteMetadataStore::FlushPendingWritesIfDue() {
+  return IsBatchDue() ? FlushPendingWrites() : true;
+}
+
+bool SqliteMetadataStore::IsBatchDue() const {
+  return batch_open_ &&
+         (batch_writes_ >= write_behind_.max_pending_writes ||
+          std::chrono::steady_clock::now() - batch_started_ >= write_behind_.max_delay);
+}
+
+void SqliteMetadataStore::PrepareWrite() {
+  if (!write_behind_.enabled || bulk_loader_) {
+    return;
+  }
+  if (IsBatchDue()) {
+    FlushPendingWrites();
+  }
+  if (!batch_open_) {
+    // Inside the caller's own transaction the write simply joins it.
+    if (!sqlite3_get_autocommit(db_manager_->GetHandle()) || !db_manager_->BeginTransaction()) {
+      return;
+    }
+    batch_open_ = true;
+    batch_started_ = std::chrono::steady_clock::now();
+  }
+  ++batch_writes_;
+}
+
+// --- Tag Index Upkeep ---
+
+void SqliteMetadataStore::NoteTagIndexWrite() {
+  if (!sqlite3_get_autocommit(db_manager_->GetHandle())) {
+    tag_index_->SetPendingWrites(true);
+  }
+}
+
+void SqliteMetadataStore::OnTransactionEnd(bool committed) {
+  if (!tag_index_ || !tag_index_->HasPendingWrites()) {
+    return;
+  }
+  if (!committed) {
+    ReloadTagIndex();
+  }
+  tag_index_->SetPendingWrites(false);
+}
+
+void SqliteMetadataStore::ReloadTagIndex() {
+  // Inside a transaction the reload picks up uncommitted rows.
+  NoteTagIndexWrite();
+  tag_index_->Load(*tag_db_);
+}
+
+void SqliteMetadataStore::NoteMetadataQuery(const MetadataFilter &filter) {
+  for (const auto &condition : filter.conditions) {
+    // Presence tests go through json_type(), which the index does not cover.
+    if (condition.op == MetadataOp::kExists || condition.op == MetadataOp::kMissing ||
+        metadata_indexes_.count(condition.key) > 0) {
+      continue;
+    }
+    int &count = metadata_key_queries_[condition.key];
+    ++count;
+    // Only outside transactions, so a rollback cannot take the index back.
+    if (count < kHotMetadataKeyQueries || metadata_indexes_.size() >= kMaxAutoMetadataIndexes ||
+        batch_open_ || !sqlite3_get_autocommit(db_manager_->GetHandle())) {
+      continue;
+    }
+    if (file_db_->CreateMetadataKeyIndex(condition.key)) {
+      VXCORE_LOG_INFO("MetadataStore: indexed hot metadata key '%s'", condition.key.c_str());
+      metadata_indexes_.insert(condition.key);
+      metadata_key_queries_.erase(condition.key);
+    } else {
+      VXCORE_LOG_WARN("MetadataStore: failed to index metadata key '%s': %s",
+                      condition.key.c_str(), file_db_->GetLastError().c_str());
+    }
+  }
+}
+
+void SqliteMetadataStore::RestoreMetadataIndexes() {
+  for (const auto &key : metadata_indexes_) {
+    if (!file_db_->CreateMetadataKeyIndex(key)) {
+      VXCORE_LOG_WARN("MetadataStore: failed to restore metadata index '%s': %s", key.c_str(),
+                      file_db_->GetLastError().c_str());
+    }
+  }
 }
 
 // --- Internal Helpers ---
 
 int64_t SqliteMetadataStore::GetFolderDbId(const std::string &folder_uuid) {
-  if (folder_uuid.empty()) {
-    return -1;  // Root folder
-  }
-  auto folder = file_db_->GetFolderByUuid(folder_uuid);
-  return folder ? folder->id : -1;
+  return reader_->GetFolderDbId(folder_uuid);
 }
 
 int64_t SqliteMetadataStore::GetFileDbId(const std::string &file_uuid) {
-  auto file = file_db_->GetFileByUuid(file_uuid);
-  return file ? file->id : -1;
+  return reader_->GetFileDbId(file_uuid);
 }
 
 std::string SqliteMetadataStore::GetFolderUuid(int64_t folder_db_id) {
-  if (folder_db_id == -1) {
-    return "";  // Root folder
-  }
-  auto folder = file_db_->GetFolder(folder_db_id);
-  return folder ? folder->uuid : "";
+  return reader_->GetFolderUuid(folder_db_id);
 }
 
 std::string SqliteMetadataStore::GetFileUuid(int64_t file_db_id) {
@@ -127,27 +275,11 @@ std::string SqliteMetadataStore::GetFileUuid(int64_t file_db_id) {
 }
 
 StoreFolderRecord SqliteMetadataStore::ToStoreFolderRecord(const DbFolderRecord &db_record) {
-  StoreFolderRecord record;
-  record.id = db_record.uuid;
-  record.parent_id = GetFolderUuid(db_record.parent_id);
-  record.name = db_record.name;
-  record.created_utc = db_record.created_utc;
-  record.modified_utc = db_record.modified_utc;
-  record.metadata = db_record.metadata;
-  return record;
+  return reader_->ToStoreFolderRecord(db_record);
 }
 
 StoreFileRecord SqliteMetadataStore::ToStoreFileRecord(const DbFileRecord &db_record) {
-  StoreFileRecord record;
-  record.id = db_record.uuid;
-  record.folder_id = GetFolderUuid(db_record.folder_id);
-  record.name = db_record.name;
-  record.created_utc = db_record.created_utc;
-  record.modified_utc = db_record.modified_utc;
-  record.metadata = db_record.metadata;
-  record.tags = db_record.tags;
-  record.attachments = db_record.attachments;
-  return record;
+  return reader_->ToStoreFileRecord(db_record);
 }
 
 // --- Folder Operations ---
@@ -157,6 +289,7 @@ bool SqliteMetadataStore::CreateFolder(const StoreFolderRecord &folder) {
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t parent_db_id = GetFolderDbId(folder.parent_id);
 
@@ -176,6 +309,7 @@ VxCoreError SqliteMetadataStore::InsertFolder(const StoreFolderRecord &folder) {
     last_error_ = "Store not open";
     return VXCORE_ERR_INVALID_STATE;
   }
+  PrepareWrite();
 
   int64_t parent_db_id = GetFolderDbId(folder.parent_id);
   if (parent_db_id == -1 && !folder.parent_id.empty()) {
@@ -200,6 +334,7 @@ bool SqliteMetadataStore::UpdateFolder(const std::string &folder_id, const std::
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   // Single query to get folder by UUID (instead of GetFolderDbId + GetFolder)
   auto existing = file_db_->GetFolderByUuid(folder_id);
@@ -228,6 +363,7 @@ bool SqliteMetadataStore::DeleteFolder(const std::string &folder_id) {
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t db_id = GetFolderDbId(folder_id);
   if (db_id == -1) {
@@ -235,11 +371,17 @@ bool SqliteMetadataStore::DeleteFolder(const std::string &folder_id) {
     return false;
   }
 
+  // The cascade takes the subtree's files with it.
+  const auto file_uuids = file_db_->ListFileUuidsInTree(db_id);
   if (!file_db_->DeleteFolder(db_id)) {
     last_error_ = "Failed to delete folder: " + file_db_->GetLastError();
     return false;
   }
 
+  NoteTagIndexWrite();
+  for (const auto &uuid : file_uuids) {
+    tag_index_->RemoveFile(uuid);
+  }
   return true;
 }
 
@@ -248,13 +390,7 @@ std::optional<StoreFolderRecord> SqliteMetadataStore::GetFolder(const std::strin
     last_error_ = "Store not open";
     return std::nullopt;
   }
-
-  auto db_folder = file_db_->GetFolderByUuid(folder_id);
-  if (!db_folder) {
-    return std::nullopt;
-  }
-
-  return ToStoreFolderRecord(*db_folder);
+  return reader_->GetFolder(folder_id);
 }
 
 std::optional<StoreFolderRecord> SqliteMetadataStore::GetFolderByPath(const std::string &path) {
@@ -262,13 +398,7 @@ std::optional<StoreFolderRecord> SqliteMetadataStore::GetFolderByPath(const std:
     last_error_ = "Store not open";
     return std::nullopt;
   }
-
-  auto db_folder = file_db_->GetFolderByPath(path);
-  if (!db_folder) {
-    return std::nullopt;
-  }
-
-  return ToStoreFolderRecord(*db_folder);
+  return reader_->GetFolderByPath(path);
 }
 
 std::vector<StoreFolderRecord> SqliteMetadataStore::ListFolders(const std::string &parent_id) {
@@ -276,16 +406,7 @@ std::vector<StoreFolderRecord> SqliteMetadataStore::ListFolders(const std::strin
     last_error_ = "Store not open";
     return {};
   }
-
-  int64_t parent_db_id = GetFolderDbId(parent_id);
-  auto db_folders = file_db_->ListFolders(parent_db_id);
-
-  std::vector<StoreFolderRecord> result;
-  result.reserve(db_folders.size());
-  for (const auto &db_folder : db_folders) {
-    result.push_back(ToStoreFolderRecord(db_folder));
-  }
-  return result;
+  return reader_->ListFolders(parent_id);
 }
 
 std::string SqliteMetadataStore::GetFolderPath(const std::string &folder_id) {
@@ -307,24 +428,7 @@ std::string SqliteMetadataStore::GetNodePathById(const std::string &node_id) {
     last_error_ = "Store not open";
     return "";
   }
-
-  // Try folder first
-  auto folder = file_db_->GetFolderByUuid(node_id);
-  if (folder) {
-    return StripRootPrefix(file_db_->GetFolderPath(folder->id));
-  }
-
-  // Try file
-  auto file = file_db_->GetFileByUuid(node_id);
-  if (file) {
-    std::string folder_path = StripRootPrefix(file_db_->GetFolderPath(file->folder_id));
-    if (folder_path.empty()) {
-      return file->name;  // File in root
-    }
-    return folder_path + "/" + file->name;
-  }
-
-  return "";  // Not found
+  return reader_->GetNodePathById(node_id);
 }
 
 bool SqliteMetadataStore::MoveFolder(const std::string &folder_id,
@@ -333,6 +437,7 @@ bool SqliteMetadataStore::MoveFolder(const std::string &folder_id,
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t db_id = GetFolderDbId(folder_id);
   if (db_id == -1) {
@@ -357,6 +462,7 @@ bool SqliteMetadataStore::CreateFile(const StoreFileRecord &file) {
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t folder_db_id = GetFolderDbId(file.folder_id);
   if (folder_db_id == -1 && !file.folder_id.empty()) {
@@ -375,10 +481,14 @@ bool SqliteMetadataStore::CreateFile(const StoreFileRecord &file) {
   if (!file.tags.empty()) {
     if (!file_db_->SetFileTags(file_id, file.tags)) {
       last_error_ = "Failed to set file tags: " + file_db_->GetLastError();
+      ReloadTagIndex();
       return false;
     }
   }
 
+  // Replacing an existing row drops its old tags, so this is exact either way.
+  NoteTagIndexWrite();
+  tag_index_->SetFileTags(file.id, file.tags);
   return true;
 }
 
@@ -387,6 +497,7 @@ VxCoreError SqliteMetadataStore::InsertFile(const StoreFileRecord &file) {
     last_error_ = "Store not open";
     return VXCORE_ERR_INVALID_STATE;
   }
+  PrepareWrite();
 
   int64_t folder_db_id = GetFolderDbId(file.folder_id);
   if (folder_db_id == -1 && !file.folder_id.empty()) {
@@ -405,10 +516,13 @@ VxCoreError SqliteMetadataStore::InsertFile(const StoreFileRecord &file) {
   if (!file.tags.empty()) {
     if (!file_db_->SetFileTags(file_db_id, file.tags)) {
       last_error_ = "Failed to set file tags: " + file_db_->GetLastError();
+      ReloadTagIndex();
       return VXCORE_ERR_DATABASE;
     }
   }
 
+  NoteTagIndexWrite();
+  tag_index_->SetFileTags(file.id, file.tags);
   return VXCORE_OK;
 }
 
@@ -418,6 +532,7 @@ bool SqliteMetadataStore::UpdateFile(const std::string &file_id, const std::stri
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   // Single query to get file by UUID (instead of GetFileDbId + GetFile)
   auto existing = file_db_->GetFileByUuid(file_id);
@@ -440,6 +555,9 @@ bool SqliteMetadataStore::UpdateFile(const std::string &file_id, const std::stri
     return false;
   }
 
+  // The rewrite replaces the row, and the old row's tags go with it.
+  NoteTagIndexWrite();
+  tag_index_->SetFileTags(existing->uuid, file_db_->GetFileTags(result));
   return true;
 }
 
@@ -448,6 +566,7 @@ bool SqliteMetadataStore::DeleteFile(const std::string &file_id) {
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t db_id = GetFileDbId(file_id);
   if (db_id == -1) {
@@ -460,6 +579,8 @@ bool SqliteMetadataStore::DeleteFile(const std::string &file_id) {
     return false;
   }
 
+  NoteTagIndexWrite();
+  tag_index_->RemoveFile(file_id);
   return true;
 }
 
@@ -468,13 +589,7 @@ std::optional<StoreFileRecord> SqliteMetadataStore::GetFile(const std::string &f
     last_error_ = "Store not open";
     return std::nullopt;
   }
-
-  auto db_file = file_db_->GetFileByUuid(file_id);
-  if (!db_file) {
-    return std::nullopt;
-  }
-
-  return ToStoreFileRecord(*db_file);
+  return reader_->GetFile(file_id);
 }
 
 std::optional<StoreFileRecord> SqliteMetadataStore::GetFileByPath(const std::string &path) {
@@ -482,34 +597,7 @@ std::optional<StoreFileRecord> SqliteMetadataStore::GetFileByPath(const std::str
     last_error_ = "Store not open";
     return std::nullopt;
   }
-
-  // Split path into folder path and file name
-  std::string clean_path = CleanPath(path);
-  auto [folder_path, file_name] = SplitPath(clean_path);
-
-  // Get folder DB ID
-  int64_t folder_db_id = -1;
-  if (!folder_path.empty() && folder_path != ".") {
-    auto folder = file_db_->GetFolderByPath(folder_path);
-    if (!folder) {
-      return std::nullopt;  // Folder not found
-    }
-    folder_db_id = folder->id;
-  } else {
-    // Root folder: find the folder with parent_id IS NULL
-    auto root_folders = file_db_->ListFolders(-1);
-    if (!root_folders.empty()) {
-      folder_db_id = root_folders[0].id;
-    }
-  }
-
-  // Get file by name in folder
-  auto db_file = file_db_->GetFileByName(folder_db_id, file_name);
-  if (!db_file) {
-    return std::nullopt;
-  }
-
-  return ToStoreFileRecord(*db_file);
+  return reader_->GetFileByPath(path);
 }
 
 std::vector<StoreFileRecord> SqliteMetadataStore::ListFiles(const std::string &folder_id) {
@@ -517,16 +605,7 @@ std::vector<StoreFileRecord> SqliteMetadataStore::ListFiles(const std::string &f
     last_error_ = "Store not open";
     return {};
   }
-
-  int64_t folder_db_id = GetFolderDbId(folder_id);
-  auto db_files = file_db_->ListFiles(folder_db_id);
-
-  std::vector<StoreFileRecord> result;
-  result.reserve(db_files.size());
-  for (const auto &db_file : db_files) {
-    result.push_back(ToStoreFileRecord(db_file));
-  }
-  return result;
+  return reader_->ListFiles(folder_id);
 }
 
 bool SqliteMetadataStore::MoveFile(const std::string &file_id, const std::string &new_folder_id) {
@@ -534,6 +613,7 @@ bool SqliteMetadataStore::MoveFile(const std::string &file_id, const std::string
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t db_id = GetFileDbId(file_id);
   if (db_id == -1) {
@@ -558,6 +638,7 @@ bool SqliteMetadataStore::CreateOrUpdateTag(const StoreTagRecord &tag) {
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   // Get parent_id from parent_name
   int64_t parent_id = -1;
@@ -582,6 +663,7 @@ bool SqliteMetadataStore::DeleteTag(const std::string &tag_name) {
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   auto tag = tag_db_->GetTag(tag_name);
   if (!tag) {
@@ -594,6 +676,8 @@ bool SqliteMetadataStore::DeleteTag(const std::string &tag_name) {
     return false;
   }
 
+  // The cascade also takes child tags; rare enough to simply reload.
+  ReloadTagIndex();
   return true;
 }
 
@@ -662,6 +746,7 @@ bool SqliteMetadataStore::SetFileTags(const std::string &file_id,
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t db_id = GetFileDbId(file_id);
   if (db_id == -1) {
@@ -671,9 +756,12 @@ bool SqliteMetadataStore::SetFileTags(const std::string &file_id,
 
   if (!file_db_->SetFileTags(db_id, tags)) {
     last_error_ = "Failed to set file tags: " + file_db_->GetLastError();
+    ReloadTagIndex();
     return false;
   }
 
+  NoteTagIndexWrite();
+  tag_index_->SetFileTags(file_id, tags);
   return true;
 }
 
@@ -682,6 +770,7 @@ bool SqliteMetadataStore::AddTagToFile(const std::string &file_id, const std::st
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t db_id = GetFileDbId(file_id);
   if (db_id == -1) {
@@ -694,6 +783,8 @@ bool SqliteMetadataStore::AddTagToFile(const std::string &file_id, const std::st
     return false;
   }
 
+  NoteTagIndexWrite();
+  tag_index_->AddFileTag(file_id, tag_name);
   return true;
 }
 
@@ -703,6 +794,7 @@ bool SqliteMetadataStore::RemoveTagFromFile(const std::string &file_id,
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t db_id = GetFileDbId(file_id);
   if (db_id == -1) {
@@ -724,9 +816,12 @@ bool SqliteMetadataStore::RemoveTagFromFile(const std::string &file_id,
   // Set updated tags
   if (!file_db_->SetFileTags(db_id, new_tags)) {
     last_error_ = "Failed to remove tag from file: " + file_db_->GetLastError();
+    ReloadTagIndex();
     return false;
   }
 
+  NoteTagIndexWrite();
+  tag_index_->RemoveFileTag(file_id, tag_name);
   return true;
 }
 
@@ -735,13 +830,7 @@ std::vector<std::string> SqliteMetadataStore::GetFileTags(const std::string &fil
     last_error_ = "Store not open";
     return {};
   }
-
-  int64_t db_id = GetFileDbId(file_id);
-  if (db_id == -1) {
-    return {};
-  }
-
-  return file_db_->GetFileTags(db_id);
+  return reader_->GetFileTags(file_id);
 }
 
 // --- File-Attachment Operations ---
@@ -752,6 +841,7 @@ bool SqliteMetadataStore::SetFileAttachments(const std::string &file_id,
     last_error_ = "Store not open";
     return false;
   }
+  PrepareWrite();
 
   int64_t db_id = GetFileDbId(file_id);
   if (db_id == -1) {
@@ -789,69 +879,138 @@ std::vector<StoreTagQueryResult> SqliteMetadataStore::FindFilesByTagsOr(
     last_error_ = "Store not open";
     return {};
   }
+  return reader_->FindFilesByTagsOr(tags);
+}
 
-  auto db_results = tag_db_->FindFilesByTagsOr(tags);
+std::vector<StoreTagQueryResult> SqliteMetadataStore::FindFilesByTagsAnd(
+    const std::vector<std::string> &tags) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return {};
+  }
+  return reader_->FindFilesByTagsAnd(tags);
+}
 
-  std::vector<StoreTagQueryResult> results;
-  results.reserve(db_results.size());
-  for (const auto &db_result : db_results) {
-    StoreTagQueryResult result;
-    result.file_id = GetFileUuid(db_result.file_id);
-    result.folder_id = GetFolderUuid(db_result.folder_id);
-    result.file_name = db_result.file_name;
-    result.tags = db_result.tags;
+std::vector<StoreTagQueryResult> SqliteMetadataStore::FindFilesByTagFilter(
+    const StoreTagFilter &filter) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return {};
+  }
+  return reader_->FindFilesByTagFilter(filter);
+}
 
-    // Compute file_path
-    std::string folder_path = StripRootPrefix(file_db_->GetFolderPath(db_result.folder_id));
-    if (folder_path.empty()) {
-      result.file_path = result.file_name;
-    } else {
-      result.file_path = folder_path + "/" + result.file_name;
-    }
+std::vector<std::pair<std::string, int>> SqliteMetadataStore::CountFilesByTag() {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return {};
+  }
+
+  return reader_->CountFilesByTag();
+}
 
-    results.push_back(result);
+std::vector<StoreTagCount> SqliteMetadataStore::CountFilesByTagSubtree() {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return {};
   }
-  return results;
+
+  return reader_->CountFilesByTagSubtree();
 }
 
-std::vector<StoreTagQueryResult> SqliteMetadataStore::FindFilesByTagsAnd(
-    const std::vector<std::string> &tags) {
+// --- Metadata Queries ---
+
+std::vector<StoreMetadataMatch> SqliteMetadataStore::FindNodesByMetadata(
+    const StoreMetadataQuery &query) {
   if (!IsOpen()) {
     last_error_ = "Store not open";
     return {};
   }
 
-  auto db_results = tag_db_->FindFilesByTagsAnd(tags);
+  NoteMetadataQuery(query.filter);
+  return reader_->FindNodesByMetadata(query);
+}
+
+bool SqliteMetadataStore::CreateMetadataIndex(const std::string &key) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return false;
+  }
+  if (!IsValidMetadataKey(key)) {
+    last_error_ = "Invalid metadata key: " + key;
+    return false;
+  }
+  FlushPendingWrites();
+  if (!sqlite3_get_autocommit(db_manager_->GetHandle())) {
+    last_error_ = "Cannot change metadata indexes inside a transaction";
+    return false;
+  }
 
-  std::vector<StoreTagQueryResult> results;
-  results.reserve(db_results.size());
-  for (const auto &db_result : db_results) {
-    StoreTagQueryResult result;
-    result.file_id = GetFileUuid(db_result.file_id);
-    result.folder_id = GetFolderUuid(db_result.folder_id);
-    result.file_name = db_result.file_name;
-    result.tags = db_result.tags;
+  if (!file_db_->CreateMetadataKeyIndex(key)) {
+    last_error_ = "Failed to create metadata index: " + file_db_->GetLastError();
+    return false;
+  }
+  metadata_indexes_.insert(key);
+  metadata_key_queries_.erase(key);
+  return true;
+}
 
-    // Compute file_path
-    std::string folder_path = StripRootPrefix(file_db_->GetFolderPath(db_result.folder_id));
-    if (folder_path.empty()) {
-      result.file_path = result.file_name;
-    } else {
-      result.file_path = folder_path + "/" + result.file_name;
-    }
+bool SqliteMetadataStore::DropMetadataIndex(const std::string &key) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return false;
+  }
+  FlushPendingWrites();
+  if (!sqlite3_get_autocommit(db_manager_->GetHandle())) {
+    last_error_ = "Cannot change metadata indexes inside a transaction";
+    return false;
+  }
 
-    results.push_back(result);
+  if (!file_db_->DropMetadataKeyIndex(key)) {
+    last_error_ = "Failed to drop metadata index: " + file_db_->GetLastError();
+    return false;
   }
-  return results;
+  metadata_indexes_.erase(key);
+  return true;
 }
 
-std::vector<std::pair<std::string, int>> SqliteMetadataStore::CountFilesByTag() {
+std::vector<std::string> SqliteMetadataStore::ListMetadataIndexes() {
   if (!IsOpen()) {
     last_error_ = "Store not open";
     return {};
   }
 
-  return tag_db_->CountFilesByTag();
+  return file_db_->ListMetadataKeyIndexes();
+}
+
+std::vector<std::optional<StoreFileRecord>> SqliteMetadataStore::GetFilesByIds(
+    const std::vector<std::string> &file_ids) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return std::vector<std::optional<StoreFileRecord>>(file_ids.size());
+  }
+
+  return reader_->GetFilesByIds(file_ids);
+}
+
+std::vector<std::string> SqliteMetadataStore::GetNodePathsByIds(
+    const std::vector<std::string> &node_ids) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return std::vector<std::string>(node_ids.size());
+  }
+
+  return reader_->GetNodePathsByIds(node_ids);
+}
+
+std::vector<std::optional<StoreFileRecord>> SqliteMetadataStore::GetFilesByPaths(
+    const std::vector<std::string> &paths) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return std::vector<std::optional<StoreFileRecord>>(paths.size());
+  }
+
+  return reader_->GetFilesByPaths(paths);
 }
 
 // --- Sync/Recovery Operations ---
@@ -861,50 +1020,168 @@ bool SqliteMetadataStore::RebuildAll() {
     last_error_ = "Store not open";
     return false;
   }
+  FlushPendingWrites();
 
   if (!db_manager_->RebuildDatabase()) {
     last_error_ = "Failed to rebuild database: " + db_manager_->GetLastError();
     return false;
   }
 
+  ReloadTagIndex();
+  // Cheap on the empty tables; a bulk load carries them across itself.
+  RestoreMetadataIndexes();
   VXCORE_LOG_DEBUG("MetadataStore rebuilt (all data cleared)");
   return true;
 }
 
-// --- Iteration ---
+bool SqliteMetadataStore::BeginBulkLoad() {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return false;
+  }
+  if (bulk_loader_) {
+    last_error_ = "Bulk load already active";
+    return false;
+  }
 
-void SqliteMetadataStore::IterateAllFiles(
-    std::function<bool(const std::string &, const StoreFileRecord &)> callback) {
+  if (!RebuildAll()) {
+    return false;
+  }
+
+  auto loader =
+      std::make_unique<BulkLoader>(db_manager_->GetHandle(), db_manager_->GetStatementCache());
+  if (!loader->Begin()) {
+    last_error_ = "Failed to begin bulk load: " + loader->GetLastError();
+    return false;
+  }
+  // The loader writes behind the store's back; reload once it finishes.
+  tag_index_->Invalidate();
+  bulk_loader_ = std::move(loader);
+  return true;
+}
+
+bool SqliteMetadataStore::BulkAddFolder(const StoreFolderRecord &folder) {
+  if (!bulk_loader_) {
+    last_error_ = "Bulk load not active";
+    return false;
+  }
+  if (!bulk_loader_->AddFolder(folder.id, folder.parent_id, folder.name, folder.created_utc,
+                               folder.modified_utc, folder.metadata)) {
+    last_error_ = bulk_loader_->GetLastError();
+    return false;
+  }
+  return true;
+}
+
+bool SqliteMetadataStore::BulkAddFile(const StoreFileRecord &file) {
+  if (!bulk_loader_) {
+    last_error_ = "Bulk load not active";
+    return false;
+  }
+  if (!bulk_loader_->AddFile(file.id, file.folder_id, file.name, file.created_utc,
+                             file.modified_utc, file.metadata, file.tags, file.attachments)) {
+    last_error_ = bulk_loader_->GetLastError();
+    return false;
+  }
+  return true;
+}
+
+bool SqliteMetadataStore::EndBulkLoad() {
+  if (!bulk_loader_) {
+    last_error_ = "Bulk load not active";
+    return false;
+  }
+  auto loader = std::move(bulk_loader_);
+  bool finished = loader->Finish();
+  ReloadTagIndex();
+  if (!finished) {
+    last_error_ = "Failed to finish bulk load: " + loader->GetLastError();
+    return false;
+  }
+  VXCORE_LOG_DEBUG("MetadataStore bulk load: %zu folders, %zu files", loader->GetFolderCount(),
+                   loader->GetFileCount());
+  return true;
+}
+
+bool SqliteMetadataStore::SetFolderConfigStamp(const std::string &folder_id, int64_t mtime_utc,
+                                               int64_t size, const std::string &hash) {
   if (!IsOpen()) {
     last_error_ = "Store not open";
-    return;
+    return false;
   }
+  PrepareWrite();
 
-  // Get all files by iterating all folders
-  std::function<void(int64_t)> iterate_folder = [&](int64_t folder_db_id) {
-    // Get folder path
-    std::string folder_path = file_db_->GetFolderPath(folder_db_id);
+  int64_t db_id = GetFolderDbId(folder_id);
+  if (db_id == -1) {
+    last_error_ = "Folder not found: " + folder_id;
+    return false;
+  }
 
-    // Iterate files in this folder
-    auto files = file_db_->ListFiles(folder_db_id);
-    for (const auto &db_file : files) {
-      StoreFileRecord record = ToStoreFileRecord(db_file);
-      std::string file_path = folder_path.empty() ? record.name : folder_path + "/" + record.name;
+  if (!file_db_->SetFolderConfigStamp(db_id, mtime_utc, size, hash)) {
+    last_error_ = "Failed to set folder config stamp: " + file_db_->GetLastError();
+    return false;
+  }
+  return true;
+}
 
-      if (!callback(file_path, record)) {
-        return;  // Stop iteration
-      }
-    }
+std::vector<StoreFolderConfigStamp> SqliteMetadataStore::ListFolderConfigStamps() {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return {};
+  }
 
-    // Recurse into subfolders
-    auto subfolders = file_db_->ListFolders(folder_db_id);
-    for (const auto &subfolder : subfolders) {
-      iterate_folder(subfolder.id);
-    }
-  };
+  std::vector<StoreFolderConfigStamp> result;
+  for (auto &db_stamp : file_db_->ListFolderConfigStamps()) {
+    StoreFolderConfigStamp stamp;
+    stamp.folder_id = std::move(db_stamp.folder_uuid);
+    stamp.folder_path = StripRootPrefix(db_stamp.folder_path);
+    stamp.mtime_utc = db_stamp.mtime_utc;
+    stamp.size = db_stamp.size;
+    stamp.hash = std::move(db_stamp.hash);
+    result.push_back(std::move(stamp));
+  }
+  return result;
+}
+
+// --- Concurrent Reads ---
+
+std::unique_ptr<MetadataStoreReader> SqliteMetadataStore::AcquireReader() {
+  if (!IsOpen() || !read_pool_) {
+    return nullptr;
+  }
+
+  ReadConnectionLease lease = read_pool_->Acquire();
+  if (!lease) {
+    return nullptr;
+  }
+  return std::make_unique<SqliteStoreReader>(std::move(lease), tag_index_);
+}
 
-  // Start from root (-1)
-  iterate_folder(-1);
+// --- Iteration ---
+
+void SqliteMetadataStore::IterateAllFiles(
+    std::function<bool(const std::string &, const StoreFileRecord &)> callback) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return;
+  }
+
+  // One ordered cursor over files, folders and tags (see FileDb::ForEachFile)
+  file_db_->ForEachFile([&](const DbFileRecord &db_file, const std::string &folder_uuid,
+                            const std::string &folder_path) {
+    StoreFileRecord record;
+    record.id = db_file.uuid;
+    record.folder_id = folder_uuid;
+    record.name = db_file.name;
+    record.created_utc = db_file.created_utc;
+    record.modified_utc = db_file.modified_utc;
+    record.metadata = db_file.metadata;
+    record.tags = db_file.tags;
+    record.attachments = db_file.attachments;
+
+    std::string file_path = folder_path.empty() ? record.name : folder_path + "/" + record.name;
+    return callback(file_path, record);
+  });
 }
 
 std::optional<std::string> SqliteMetadataStore::GetNotebookMetadata(const std::string &key) {
@@ -912,9 +1189,55 @@ std::optional<std::string> SqliteMetadataStore::GetNotebookMetadata(const std::s
 }
 
 bool SqliteMetadataStore::SetNotebookMetadata(const std::string &key, const std::string &value) {
+  PrepareWrite();
   return notebook_db_->SetMetadata(key, value);
 }
 
+// --- File History ---
+
+bool SqliteMetadataStore::RecordFileOpen(const std::string &file_id, int64_t opened_utc,
+                                         size_t max_entries) {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return false;
+  }
+  PrepareWrite();
+  if (!history_db_->RecordOpen(file_id, opened_utc, max_entries)) {
+    last_error_ = "Failed to record file open: " + history_db_->GetLastError();
+    return false;
+  }
+  return true;
+}
+
+std::vector<StoreHistoryEntry> SqliteMetadataStore::GetFileHistory(size_t limit) {
+  std::vector<StoreHistoryEntry> results;
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return results;
+  }
+  for (auto &db_entry : history_db_->GetRecent(limit)) {
+    StoreHistoryEntry entry;
+    entry.file_id = std::move(db_entry.file_uuid);
+    entry.opened_utc = db_entry.opened_utc;
+    entry.open_count = db_entry.open_count;
+    results.push_back(std::move(entry));
+  }
+  return results;
+}
+
+bool SqliteMetadataStore::ClearFileHistory() {
+  if (!IsOpen()) {
+    last_error_ = "Store not open";
+    return false;
+  }
+  PrepareWrite();
+  if (!history_db_->Clear()) {
+    last_error_ = "Failed to clear file history: " + history_db_->GetLastError();
+    return false;
+  }
+  return true;
+}
+
 // --- Error Handling ---
 
 std::string SqliteMetadataStore::GetLastError() const { return last_error_; }
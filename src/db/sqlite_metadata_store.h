@@ -1,7 +1,10 @@
 #ifndef VXCORE_SQLITE_METADATA_STORE_H
 #define VXCORE_SQLITE_METADATA_STORE_H
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
 
@@ -14,10 +17,15 @@ namespace vxcore {
 namespace db {
 
 // Forward declarations
+class BulkLoader;
 class DbManager;
 class FileDb;
 class TagDb;
 class NotebookDb;
+class HistoryDb;
+class ReadConnectionPool;
+class SqliteStoreReader;
+class TagBitmapIndex;
 
 // SQLite-based implementation of MetadataStore
 // Wraps DbManager, FileDb, TagDb to provide the MetadataStore interface
@@ -25,9 +33,25 @@ class NotebookDb;
 // Key design: Uses UUID strings for all public identifiers, but internally
 // maps to int64_t database IDs for efficient SQLite operations.
 //
+// Write-behind (off by default) keeps one transaction open on the owner
+// connection across mutations, so reads through the store see pending
+// writes for free; pooled readers only see them once the batch commits.
+//
+// Tag queries go through an in-memory TagBitmapIndex, loaded on Open() and
+// kept in step with every tag mutation made through the store.
+//
+// Metadata queries run in SQL. A key that metadata queries have compared on
+// kHotMetadataKeyQueries times gets an expression index, created between
+// transactions, unless kMaxAutoMetadataIndexes keys are indexed already.
+//
 // Thread safety: NOT thread-safe. Caller must ensure synchronization.
+// AcquireReader() is the exception: it hands out readers on pooled read-only
+// connections (WAL lets them run alongside writes on the owner connection).
 class SqliteMetadataStore : public MetadataStore {
  public:
+  static constexpr int kHotMetadataKeyQueries = 3;
+  static constexpr size_t kMaxAutoMetadataIndexes = 16;
+
   SqliteMetadataStore();
   ~SqliteMetadataStore() override;
 
@@ -92,9 +116,39 @@ class SqliteMetadataStore : public MetadataStore {
   std::vector<StoreTagQueryResult> FindFilesByTagsOr(const std::vector<std::string>& tags) override;
   std::vector<StoreTagQueryResult> FindFilesByTagsAnd(
       const std::vector<std::string>& tags) override;
+  std::vector<StoreTagQueryResult> FindFilesByTagFilter(const StoreTagFilter& filter) override;
   std::vector<std::pair<std::string, int>> CountFilesByTag() override;
+  std::vector<StoreTagCount> CountFilesByTagSubtree() override;
+
+  // --- Metadata Queries ---
+  std::vector<StoreMetadataMatch> FindNodesByMetadata(const StoreMetadataQuery& query) override;
+  bool CreateMetadataIndex(const std::string& key) override;
+  bool DropMetadataIndex(const std::string& key) override;
+  std::vector<std::string> ListMetadataIndexes() override;
+
+  std::vector<std::optional<StoreFileRecord>> GetFilesByIds(
+      const std::vector<std::string>& file_ids) override;
+  std::vector<std::string> GetNodePathsByIds(const std::vector<std::string>& node_ids) override;
+  std::vector<std::optional<StoreFileRecord>> GetFilesByPaths(
+      const std::vector<std::string>& paths) override;
 
   bool RebuildAll() override;
+  bool BeginBulkLoad() override;
+  bool BulkAddFolder(const StoreFolderRecord& folder) override;
+  bool BulkAddFile(const StoreFileRecord& file) override;
+  bool EndBulkLoad() override;
+  bool SetFolderConfigStamp(const std::string& folder_id, int64_t mtime_utc, int64_t size,
+                            const std::string& hash) override;
+  std::vector<StoreFolderConfigStamp> ListFolderConfigStamps() override;
+
+  // --- Concurrent Reads ---
+  std::unique_ptr<MetadataStoreReader> AcquireReader() override;
+
+  // --- Write-Behind ---
+  void SetWriteBehind(const WriteBehindOptions& options) override;
+  bool HasPendingWrites() const override;
+  bool FlushPendingWrites() override;
+  bool FlushPendingWritesIfDue() override;
 
   // --- Iteration ---
   void IterateAllFiles(
@@ -104,10 +158,34 @@ class SqliteMetadataStore : public MetadataStore {
   std::optional<std::string> GetNotebookMetadata(const std::string& key) override;
   bool SetNotebookMetadata(const std::string& key, const std::string& value) override;
 
+  // --- File History ---
+  bool RecordFileOpen(const std::string& file_id, int64_t opened_utc,
+                      size_t max_entries) override;
+  std::vector<StoreHistoryEntry> GetFileHistory(size_t limit) override;
+  bool ClearFileHistory() override;
+
   // --- Error Handling ---
   std::string GetLastError() const override;
 
  private:
+  // Called by every mutation before it writes: commits the write-behind
+  // batch if it is due and opens a new one when write-behind applies.
+  void PrepareWrite();
+  bool IsBatchDue() const;
+
+  // Tag index upkeep: a mutation inside an open transaction marks the index
+  // ahead of what pooled readers can see; committing clears the mark and a
+  // rollback reloads the index. Called before the index takes the change, so
+  // a reader never sees an unmarked uncommitted change.
+  void NoteTagIndexWrite();
+  void OnTransactionEnd(bool committed);
+  void ReloadTagIndex();
+
+  // Counts the keys |filter| compares on and indexes those that turn hot.
+  void NoteMetadataQuery(const MetadataFilter& filter);
+  // Recreates the indexes of |metadata_indexes_| after the tables were dropped.
+  void RestoreMetadataIndexes();
+
   // Internal helpers for UUID <-> int64_t ID mapping
   int64_t GetFolderDbId(const std::string& folder_uuid);
   int64_t GetFileDbId(const std::string& file_uuid);
@@ -122,7 +200,27 @@ class SqliteMetadataStore : public MetadataStore {
   std::unique_ptr<FileDb> file_db_;
   std::unique_ptr<TagDb> tag_db_;
   std::unique_ptr<NotebookDb> notebook_db_;
+  std::unique_ptr<HistoryDb> history_db_;
+  // Shared with every reader; see TagBitmapIndex
+  std::shared_ptr<TagBitmapIndex> tag_index_;
+  // Serves the read methods on the owner connection
+  std::unique_ptr<SqliteStoreReader> reader_;
+  // Read-only connections for AcquireReader(); null for in-memory databases.
+  // Shared with outstanding leases.
+  std::shared_ptr<ReadConnectionPool> read_pool_;
+  // Non-null only between BeginBulkLoad and EndBulkLoad
+  std::unique_ptr<BulkLoader> bulk_loader_;
   mutable std::string last_error_;
+
+  // Keys with a metadata index, and per-key query counts of the others
+  std::set<std::string> metadata_indexes_;
+  std::unordered_map<std::string, int> metadata_key_queries_;
+
+  WriteBehindOptions write_behind_;
+  // True while the store's own write-behind transaction is open
+  bool batch_open_ = false;
+  size_t batch_writes_ = 0;
+  std::chrono::steady_clock::time_point batch_started_;
 };
 
 }  // namespace db
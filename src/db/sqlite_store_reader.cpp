@@ -0,0 +1,484 @@
+#include "sqlite_store_reader.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+
+#include "file_db.h"
+#include "tag_bitmap_index.h"
+#include "tag_db.h"
+#include "utils/file_utils.h"
+
+namespace vxcore {
+namespace db {
+
+std::string StripRootPrefix(const std::string &path) {
+  if (path.size() >= 2 && path[0] == '.' && path[1] == '/') {
+    return path.substr(2);
+  }
+  if (path == ".") {
+    return "";  // Root folder itself
+  }
+  return path;
+}
+
+SqliteStoreReader::SqliteStoreReader(sqlite3 *db, StatementCache *cache,
+                                     std::shared_ptr<const TagBitmapIndex> tag_index)
+    : file_db_(std::make_unique<FileDb>(db, cache)),
+      tag_db_(std::make_unique<TagDb>(db, cache)),
+      tag_index_(std::move(tag_index)) {}
+
+SqliteStoreReader::SqliteStoreReader(ReadConnectionLease lease,
+                                     std::shared_ptr<const TagBitmapIndex> tag_index)
+    : lease_(std::move(lease)), tag_index_(std::move(tag_index)) {
+  file_db_ = std::make_unique<FileDb>(lease_->GetHandle(), lease_->GetStatementCache());
+  tag_db_ = std::make_unique<TagDb>(lease_->GetHandle(), lease_->GetStatementCache());
+}
+
+// The Db helpers borrow statements from the lease's cache, so they must go
+// before the lease returns the connection.
+SqliteStoreReader::~SqliteStoreReader() {
+  tag_db_.reset();
+  file_db_.reset();
+}
+
+// --- Internal Helpers ---
+
+int64_t SqliteStoreReader::GetFolderDbId(const std::string &folder_uuid) {
+  if (folder_uuid.empty()) {
+    return -1;  // Root folder
+  }
+  auto folder = file_db_->GetFolderByUuid(folder_uuid);
+  return folder ? folder->id : -1;
+}
+
+int64_t SqliteStoreReader::GetFileDbId(const std::string &file_uuid) {
+  auto file = file_db_->GetFileByUuid(file_uuid);
+  return file ? file->id : -1;
+}
+
+std::string SqliteStoreReader::GetFolderUuid(int64_t folder_db_id) {
+  if (folder_db_id == -1) {
+    return "";  // Root folder
+  }
+  auto folder = file_db_->GetFolder(folder_db_id);
+  return folder ? folder->uuid : "";
+}
+
+StoreFolderRecord SqliteStoreReader::ToStoreFolderRecord(const DbFolderRecord &db_record) {
+  StoreFolderRecord record;
+  record.id = db_record.uuid;
+  record.parent_id = GetFolderUuid(db_record.parent_id);
+  record.name = db_record.name;
+  record.created_utc = db_record.created_utc;
+  record.modified_utc = db_record.modified_utc;
+  record.metadata = db_record.metadata;
+  return record;
+}
+
+StoreFileRecord SqliteStoreReader::ToStoreFileRecord(const DbFileRecord &db_record) {
+  StoreFileRecord record;
+  record.id = db_record.uuid;
+  record.folder_id = GetFolderUuid(db_record.folder_id);
+  record.name = db_record.name;
+  record.created_utc = db_record.created_utc;
+  record.modified_utc = db_record.modified_utc;
+  record.metadata = db_record.metadata;
+  record.tags = db_record.tags;
+  record.attachments = db_record.attachments;
+  return record;
+}
+
+std::vector<StoreTagQueryResult> SqliteStoreReader::ToTagQueryResults(
+    const std::vector<TagQueryResult> &db_results) {
+  std::vector<StoreTagQueryResult> results;
+  results.reserve(db_results.size());
+  for (const auto &db_result : db_results) {
+    StoreTagQueryResult result;
+    result.file_id = db_result.file_uuid;
+    result.folder_id = db_result.folder_uuid;
+    result.file_name = db_result.file_name;
+    result.tags = db_result.tags;
+
+    // Compute file_path from the materialized folder path of the same row
+    std::string folder_path = StripRootPrefix(db_result.folder_path.empty()
+                                                  ? file_db_->GetFolderPath(db_result.folder_id)
+                                                  : db_result.folder_path);
+    if (folder_path.empty()) {
+      result.file_path = result.file_name;
+    } else {
+      result.file_path = folder_path + "/" + result.file_name;
+    }
+
+    results.push_back(result);
+  }
+  return results;
+}
+
+// --- Folder Queries ---
+
+std::optional<StoreFolderRecord> SqliteStoreReader::GetFolder(const std::string &folder_id) {
+  auto db_folder = file_db_->GetFolderByUuid(folder_id);
+  if (!db_folder) {
+    return std::nullopt;
+  }
+
+  return ToStoreFolderRecord(*db_folder);
+}
+
+std::optional<StoreFolderRecord> SqliteStoreReader::GetFolderByPath(const std::string &path) {
+  auto db_folder = file_db_->GetFolderByPath(path);
+  if (!db_folder) {
+    return std::nullopt;
+  }
+
+  return ToStoreFolderRecord(*db_folder);
+}
+
+std::vector<StoreFolderRecord> SqliteStoreReader::ListFolders(const std::string &parent_id) {
+  int64_t parent_db_id = GetFolderDbId(parent_id);
+  auto db_folders = file_db_->ListFolders(parent_db_id);
+
+  std::vector<StoreFolderRecord> result;
+  result.reserve(db_folders.size());
+  for (const auto &db_folder : db_folders) {
+    result.push_back(ToStoreFolderRecord(db_folder));
+  }
+  return result;
+}
+
+std::string SqliteStoreReader::GetNodePathById(const std::string &node_id) {
+  // Try folder first
+  auto folder = file_db_->GetFolderByUuid(node_id);
+  if (folder) {
+    return StripRootPrefix(file_db_->GetFolderPath(folder->id));
+  }
+
+  // Try file
+  auto file = file_db_->GetFileByUuid(node_id);
+  if (file) {
+    std::string folder_path = StripRootPrefix(file_db_->GetFolderPath(file->folder_id));
+    if (folder_path.empty()) {
+      return file->name;  // File in root
+    }
+    return folder_path + "/" + file->name;
+  }
+
+  return "";  // Not found
+}
+
+// --- File Queries ---
+
+std::optional<StoreFileRecord> SqliteStoreReader::GetFile(const std::string &file_id) {
+  auto db_file = file_db_->GetFileByUuid(file_id);
+  if (!db_file) {
+    return std::nullopt;
+  }
+
+  return ToStoreFileRecord(*db_file);
+}
+
+std::optional<StoreFileRecord> SqliteStoreReader::GetFileByPath(const std::string &path) {
+  // Split path into folder path and file name
+  std::string clean_path = CleanPath(path);
+  auto [folder_path, file_name] = SplitPath(clean_path);
+
+  // Get folder DB ID
+  int64_t folder_db_id = -1;
+  if (!folder_path.empty() && folder_path != ".") {
+    auto folder = file_db_->GetFolderByPath(folder_path);
+    if (!folder) {
+      return std::nullopt;  // Folder not found
+    }
+    folder_db_id = folder->id;
+  } else {
+    // Root folder: find the folder with parent_id IS NULL
+    auto root_folders = file_db_->ListFolders(-1);
+    if (!root_folders.empty()) {
+      folder_db_id = root_folders[0].id;
+    }
+  }
+
+  // Get file by name in folder
+  auto db_file = file_db_->GetFileByName(folder_db_id, file_name);
+  if (!db_file) {
+    return std::nullopt;
+  }
+
+  return ToStoreFileRecord(*db_file);
+}
+
+std::vector<StoreFileRecord> SqliteStoreReader::ListFiles(const std::string &folder_id) {
+  int64_t folder_db_id = GetFolderDbId(folder_id);
+  auto db_files = file_db_->ListFiles(folder_db_id);
+
+  std::vector<StoreFileRecord> result;
+  result.reserve(db_files.size());
+  for (const auto &db_file : db_files) {
+    result.push_back(ToStoreFileRecord(db_file));
+  }
+  return result;
+}
+
+std::vector<std::string> SqliteStoreReader::GetFileTags(const std::string &file_id) {
+  int64_t db_id = GetFileDbId(file_id);
+  if (db_id == -1) {
+    return {};
+  }
+
+  return file_db_->GetFileTags(db_id);
+}
+
+// --- Tag Queries ---
+
+std::optional<std::vector<std::string>> SqliteStoreReader::MatchTagIndex(
+    const StoreTagFilter &filter) const {
+  if (!tag_index_) {
+    return std::nullopt;
+  }
+  // A pooled reader's snapshot must not see the owner's uncommitted changes.
+  const bool committed_only = static_cast<bool>(lease_);
+  if (!filter.include_descendants) {
+    return tag_index_->Match(filter.all_of, filter.any_of, filter.none_of, committed_only);
+  }
+
+  // The index knows no hierarchy: widen every tag to its subtree first.
+  auto flatten = [](std::vector<std::vector<std::string>> subtrees) {
+    std::vector<std::string> names;
+    for (auto &subtree : subtrees) {
+      names.insert(names.end(), std::make_move_iterator(subtree.begin()),
+                   std::make_move_iterator(subtree.end()));
+    }
+    return names;
+  };
+  return tag_index_->MatchGroups(tag_db_->ExpandTagSubtrees(filter.all_of),
+                                 flatten(tag_db_->ExpandTagSubtrees(filter.any_of)),
+                                 flatten(tag_db_->ExpandTagSubtrees(filter.none_of)),
+                                 committed_only);
+}
+
+std::vector<StoreTagQueryResult> SqliteStoreReader::FindFilesByTagsOr(
+    const std::vector<std::string> &tags) {
+  StoreTagFilter filter;
+  filter.any_of = tags;
+  if (auto uuids = MatchTagIndex(filter)) {
+    return ToTagQueryResults(tag_db_->GetFilesWithTagsByUuids(*uuids));
+  }
+  return ToTagQueryResults(tag_db_->FindFilesByTagsOr(tags));
+}
+
+std::vector<StoreTagQueryResult> SqliteStoreReader::FindFilesByTagsAnd(
+    const std::vector<std::string> &tags) {
+  StoreTagFilter filter;
+  filter.all_of = tags;
+  if (auto uuids = MatchTagIndex(filter)) {
+    return ToTagQueryResults(tag_db_->GetFilesWithTagsByUuids(*uuids));
+  }
+  return ToTagQueryResults(tag_db_->FindFilesByTagsAnd(tags));
+}
+
+std::vector<StoreTagQueryResult> SqliteStoreReader::FindFilesByTagFilter(
+    const StoreTagFilter &filter) {
+  if (auto uuids = MatchTagIndex(filter)) {
+    return ToTagQueryResults(tag_db_->GetFilesWithTagsByUuids(*uuids));
+  }
+  return ToTagQueryResults(tag_db_->FindFilesByTagExpression(
+      filter.all_of, filter.any_of, filter.none_of, filter.include_descendants));
+}
+
+std::vector<std::pair<std::string, int>> SqliteStoreReader::CountFilesByTag() {
+  return tag_db_->CountFilesByTag();
+}
+
+std::vector<StoreTagCount> SqliteStoreReader::CountFilesByTagSubtree() {
+  auto db_counts = tag_db_->CountFilesByTagSubtree();
+
+  std::vector<StoreTagCount> counts;
+  counts.reserve(db_counts.size());
+  for (auto &db_count : db_counts) {
+    StoreTagCount count;
+    count.name = std::move(db_count.name);
+    count.parent_name = std::move(db_count.parent_name);
+    count.file_count = db_count.file_count;
+    count.subtree_file_count = db_count.subtree_file_count;
+    counts.push_back(std::move(count));
+  }
+  return counts;
+}
+
+std::vector<StoreMetadataMatch> SqliteStoreReader::FindNodesByMetadata(
+    const StoreMetadataQuery &query) {
+  std::vector<StoreMetadataMatch> matches;
+  auto append = [&matches](std::vector<DbMetadataMatch> db_matches, bool is_folder) {
+    matches.reserve(matches.size() + db_matches.size());
+    for (auto &db_match : db_matches) {
+      StoreMetadataMatch match;
+      match.node_id = std::move(db_match.uuid);
+      match.path = StripRootPrefix(db_match.path);
+      match.is_folder = is_folder;
+      match.metadata = std::move(db_match.metadata);
+      matches.push_back(std::move(match));
+    }
+  };
+  if (query.include_files) {
+    append(file_db_->FindFilesByMetadata(query.filter, query.limit), false);
+  }
+  if (query.include_folders) {
+    append(file_db_->FindFoldersByMetadata(query.filter, query.limit), true);
+  }
+  return matches;
+}
+
+// --- Batch Lookups ---
+
+namespace {
+
+// Joins a folder path returned by FileDb (already stripped of the root
+// prefix) with a file name.
+std::string JoinNodePath(const std::string &folder_path, const std::string &name) {
+  return folder_path.empty() ? name : folder_path + "/" + name;
+}
+
+}  // namespace
+
+StoreFileRecord SqliteStoreReader::ToStoreFileRecord(const DbFileRecord &db_record,
+                                                     const std::string &folder_uuid) {
+  StoreFileRecord record;
+  record.id = db_record.uuid;
+  record.folder_id = folder_uuid;
+  record.name = db_record.name;
+  record.created_utc = db_record.created_utc;
+  record.modified_utc = db_record.modified_utc;
+  record.metadata = db_record.metadata;
+  record.tags = db_record.tags;
+  record.attachments = db_record.attachments;
+  return record;
+}
+
+std::vector<std::optional<StoreFileRecord>> SqliteStoreReader::GetFilesByIds(
+    const std::vector<std::string> &file_ids) {
+  std::unordered_map<std::string, std::vector<size_t>> slots;
+  for (size_t i = 0; i < file_ids.size(); ++i) {
+    slots[file_ids[i]].push_back(i);
+  }
+  std::vector<std::string> unique_ids;
+  unique_ids.reserve(slots.size());
+  for (const auto &[id, indices] : slots) {
+    unique_ids.push_back(id);
+  }
+
+  std::vector<std::optional<StoreFileRecord>> results(file_ids.size());
+  file_db_->ForEachFileByUuids(unique_ids, [&](const DbFileRecord &file,
+                                               const std::string &folder_uuid,
+                                               const std::string &) {
+    auto it = slots.find(file.uuid);
+    if (it != slots.end()) {
+      StoreFileRecord record = ToStoreFileRecord(file, folder_uuid);
+      for (size_t index : it->second) {
+        results[index] = record;
+      }
+    }
+    return true;
+  });
+  return results;
+}
+
+std::vector<std::string> SqliteStoreReader::GetNodePathsByIds(
+    const std::vector<std::string> &node_ids) {
+  std::unordered_map<std::string, std::string> paths;
+
+  // Folders first, like GetNodePathById; files only for the ids left over.
+  for (auto &[uuid, path] : file_db_->GetFolderPathsByUuids(node_ids)) {
+    paths.emplace(uuid, StripRootPrefix(path));
+  }
+
+  std::vector<std::string> file_ids;
+  for (const auto &id : node_ids) {
+    if (!paths.count(id)) {
+      file_ids.push_back(id);
+    }
+  }
+  std::vector<std::pair<std::string, int64_t>> unmaterialized;  // (file uuid, folder id)
+  file_db_->ForEachFileByUuids(file_ids, [&](const DbFileRecord &file, const std::string &,
+                                             const std::string &folder_path) {
+    if (folder_path.empty() && file.folder_id > 0) {
+      unmaterialized.emplace_back(file.uuid, file.folder_id);
+      paths.emplace(file.uuid, file.name);
+    } else {
+      paths.emplace(file.uuid, JoinNodePath(StripRootPrefix(folder_path), file.name));
+    }
+    return true;
+  });
+  for (const auto &[uuid, folder_id] : unmaterialized) {
+    std::string &path = paths[uuid];
+    path = JoinNodePath(StripRootPrefix(file_db_->GetFolderPath(folder_id)), path);
+  }
+
+  std::vector<std::string> results;
+  results.reserve(node_ids.size());
+  for (const auto &id : node_ids) {
+    auto it = paths.find(id);
+    results.push_back(it != paths.end() ? it->second : "");
+  }
+  return results;
+}
+
+std::vector<std::optional<StoreFileRecord>> SqliteStoreReader::GetFilesByPaths(
+    const std::vector<std::string> &paths) {
+  std::vector<std::optional<StoreFileRecord>> results(paths.size());
+  if (paths.empty()) {
+    return results;
+  }
+
+  // Map each path onto the materialized folder path the way GetFileByPath
+  // resolves it: under the "." root folder when there is one, otherwise from
+  // the top-level folders, with root-level files in the first of those.
+  auto top_level = file_db_->ListFolders(-1);
+  const auto dot_root = std::find_if(top_level.begin(), top_level.end(),
+                                     [](const DbFolderRecord &f) { return f.name == "."; });
+  std::string root_path;
+  if (dot_root != top_level.end()) {
+    root_path = ".";
+  } else if (!top_level.empty()) {
+    root_path = file_db_->GetFolderPath(top_level.front().id);
+  }
+
+  std::map<std::pair<std::string, std::string>, std::vector<size_t>> slots;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    auto [folder_path, file_name] = SplitPath(CleanPath(paths[i]));
+    std::string stored_folder;
+    if (folder_path.empty() || folder_path == ".") {
+      stored_folder = root_path;
+    } else if (dot_root != top_level.end()) {
+      stored_folder = "./" + folder_path;
+    } else {
+      stored_folder = folder_path;
+    }
+    if (!stored_folder.empty() && !file_name.empty()) {
+      slots[{stored_folder, file_name}].push_back(i);
+    }
+  }
+
+  std::vector<std::pair<std::string, std::string>> locations;
+  locations.reserve(slots.size());
+  for (const auto &[location, indices] : slots) {
+    locations.push_back(location);
+  }
+
+  file_db_->ForEachFileAt(locations, [&](const DbFileRecord &file, const std::string &folder_uuid,
+                                         const std::string &folder_path) {
+    auto it = slots.find({folder_path, file.name});
+    if (it != slots.end()) {
+      StoreFileRecord record = ToStoreFileRecord(file, folder_uuid);
+      for (size_t index : it->second) {
+        results[index] = record;
+      }
+    }
+    return true;
+  });
+  return results;
+}
+
+}  // namespace db
+}  // namespace vxcore
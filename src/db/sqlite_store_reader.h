@@ -0,0 +1,103 @@
+#ifndef VXCORE_SQLITE_STORE_READER_H
+#define VXCORE_SQLITE_STORE_READER_H
+
+#include <memory>
+#include <string>
+
+#include "core/metadata_store.h"
+#include "read_connection_pool.h"
+
+// Forward declarations
+struct sqlite3;
+
+namespace vxcore {
+namespace db {
+
+class FileDb;
+class TagBitmapIndex;
+class TagDb;
+class StatementCache;
+struct DbFolderRecord;
+struct DbFileRecord;
+struct TagQueryResult;
+
+// Strips the root folder prefix ("." or "./") from paths returned by FileDb::GetFolderPath().
+// The root folder is stored with name "." in the database, so paths for root-level items
+// start with "." or "./" which must be removed to produce clean relative paths.
+std::string StripRootPrefix(const std::string& path);
+
+// The query half of SqliteMetadataStore, bound to one connection.
+//
+// SqliteMetadataStore keeps one on its own (read-write) connection and serves
+// its read methods through it; AcquireReader() hands out readers on pooled
+// read-only connections, which own their lease and return it on destruction.
+//
+// Given the store's TagBitmapIndex, tag queries match through it and only
+// load the matched rows; a pooled reader skips it while the owner has
+// uncommitted tag changes its connection cannot see yet.
+//
+// NOT thread-safe, like the connection it wraps.
+class SqliteStoreReader : public MetadataStoreReader {
+ public:
+  SqliteStoreReader(sqlite3* db, StatementCache* cache,
+                    std::shared_ptr<const TagBitmapIndex> tag_index = nullptr);
+  explicit SqliteStoreReader(ReadConnectionLease lease,
+                             std::shared_ptr<const TagBitmapIndex> tag_index = nullptr);
+  ~SqliteStoreReader() override;
+
+  SqliteStoreReader(const SqliteStoreReader&) = delete;
+  SqliteStoreReader& operator=(const SqliteStoreReader&) = delete;
+
+  std::optional<StoreFolderRecord> GetFolder(const std::string& folder_id) override;
+  std::optional<StoreFolderRecord> GetFolderByPath(const std::string& path) override;
+  std::vector<StoreFolderRecord> ListFolders(const std::string& parent_id) override;
+  std::string GetNodePathById(const std::string& node_id) override;
+
+  std::optional<StoreFileRecord> GetFile(const std::string& file_id) override;
+  std::optional<StoreFileRecord> GetFileByPath(const std::string& path) override;
+  std::vector<StoreFileRecord> ListFiles(const std::string& folder_id) override;
+  std::vector<std::string> GetFileTags(const std::string& file_id) override;
+
+  std::vector<StoreTagQueryResult> FindFilesByTagsOr(const std::vector<std::string>& tags) override;
+  std::vector<StoreTagQueryResult> FindFilesByTagsAnd(
+      const std::vector<std::string>& tags) override;
+  std::vector<StoreTagQueryResult> FindFilesByTagFilter(const StoreTagFilter& filter) override;
+  std::vector<std::pair<std::string, int>> CountFilesByTag() override;
+  std::vector<StoreTagCount> CountFilesByTagSubtree() override;
+  std::vector<StoreMetadataMatch> FindNodesByMetadata(const StoreMetadataQuery& query) override;
+
+  std::vector<std::optional<StoreFileRecord>> GetFilesByIds(
+      const std::vector<std::string>& file_ids) override;
+  std::vector<std::string> GetNodePathsByIds(const std::vector<std::string>& node_ids) override;
+  std::vector<std::optional<StoreFileRecord>> GetFilesByPaths(
+      const std::vector<std::string>& paths) override;
+
+  // UUID <-> int64_t ID mapping; -1 / empty for the root or unknown ids.
+  int64_t GetFolderDbId(const std::string& folder_uuid);
+  int64_t GetFileDbId(const std::string& file_uuid);
+  std::string GetFolderUuid(int64_t folder_db_id);
+
+  // Convert between DB records and Store records
+  StoreFolderRecord ToStoreFolderRecord(const DbFolderRecord& db_record);
+  StoreFileRecord ToStoreFileRecord(const DbFileRecord& db_record);
+  // Same, with the folder UUID already known (saves a lookup per record)
+  StoreFileRecord ToStoreFileRecord(const DbFileRecord& db_record, const std::string& folder_uuid);
+
+ private:
+  std::vector<StoreTagQueryResult> ToTagQueryResults(
+      const std::vector<TagQueryResult>& db_results);
+
+  // Matching file UUIDs from the tag index, or nullopt if it cannot be used.
+  std::optional<std::vector<std::string>> MatchTagIndex(const StoreTagFilter& filter) const;
+
+  // Empty when bound to the store's own connection.
+  ReadConnectionLease lease_;
+  std::unique_ptr<FileDb> file_db_;
+  std::unique_ptr<TagDb> tag_db_;
+  std::shared_ptr<const TagBitmapIndex> tag_index_;
+};
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_SQLITE_STORE_READER_H
@@ -0,0 +1,172 @@
+#include "statement_cache.h"
+
+#include <sqlite3.h>
+
+#include <utility>
+
+namespace vxcore {
+namespace db {
+
+// --- ScopedStatement ---
+
+ScopedStatement::~ScopedStatement() { Release(); }
+
+ScopedStatement::ScopedStatement(ScopedStatement&& other) noexcept
+    : cache_(std::exchange(other.cache_, nullptr)),
+      slot_(std::exchange(other.slot_, nullptr)),
+      stmt_(std::exchange(other.stmt_, nullptr)),
+      generation_(other.generation_) {}
+
+ScopedStatement& ScopedStatement::operator=(ScopedStatement&& other) noexcept {
+  if (this != &other) {
+    Release();
+    cache_ = std::exchange(other.cache_, nullptr);
+    slot_ = std::exchange(other.slot_, nullptr);
+    stmt_ = std::exchange(other.stmt_, nullptr);
+    generation_ = other.generation_;
+  }
+  return *this;
+}
+
+void ScopedStatement::Release() {
+  if (!stmt_) {
+    return;
+  }
+  if (cache_) {
+    cache_->Return(slot_, stmt_, generation_);
+  } else {
+    sqlite3_finalize(stmt_);
+  }
+  cache_ = nullptr;
+  slot_ = nullptr;
+  stmt_ = nullptr;
+}
+
+// --- StatementCache ---
+
+StatementCache::StatementCache(sqlite3* db) : db_(db) {}
+
+StatementCache::~StatementCache() { Clear(); }
+
+void StatementCache::SetHandle(sqlite3* db) {
+  Clear();
+  db_ = db;
+}
+
+void StatementCache::Clear() {
+  for (auto& entry : slots_) {
+    for (sqlite3_stmt* stmt : entry.second->idle) {
+      sqlite3_finalize(stmt);
+    }
+    entry.second->idle.clear();
+  }
+  ++generation_;
+}
+
+ScopedStatement StatementCache::Acquire(std::string_view sql) {
+  if (!db_) {
+    return ScopedStatement();
+  }
+
+  ScopedStatement::Slot* slot = nullptr;
+  auto it = slots_.find(sql);
+  if (it != slots_.end()) {
+    slot = it->second.get();
+    lru_.splice(lru_.begin(), lru_, slot->lru_it);
+    if (!slot->idle.empty()) {
+      sqlite3_stmt* stmt = slot->idle.back();
+      slot->idle.pop_back();
+      ++slot->borrowed;
+      ++hits_;
+      return ScopedStatement(this, slot, stmt, generation_);
+    }
+  } else if (slots_.size() < kMaxEntries || EvictIdleSlot()) {
+    auto new_slot = std::make_unique<ScopedStatement::Slot>();
+    new_slot->sql.assign(sql.data(), sql.size());
+    slot = new_slot.get();
+    slot->lru_it = lru_.insert(lru_.begin(), slot);
+    slots_.emplace(std::string_view(slot->sql), std::move(new_slot));
+  }
+
+  ++misses_;
+  sqlite3_stmt* stmt = nullptr;
+  // SQLITE_PREPARE_PERSISTENT hints that the statement will be reused many
+  // times, letting SQLite avoid lookaside memory for it.
+  int rc = sqlite3_prepare_v3(db_, sql.data(), static_cast<int>(sql.size()),
+                              slot ? SQLITE_PREPARE_PERSISTENT : 0, &stmt, nullptr);
+  if (rc != SQLITE_OK) {
+    sqlite3_finalize(stmt);
+    return ScopedStatement();
+  }
+  if (!slot) {
+    // Every slot borrowed: the handle finalizes the statement on release.
+    return ScopedStatement(nullptr, nullptr, stmt, 0);
+  }
+  ++slot->borrowed;
+  return ScopedStatement(this, slot, stmt, generation_);
+}
+
+ScopedStatement StatementCache::PrepareUncached(std::string_view sql) {
+  if (!db_) {
+    return ScopedStatement();
+  }
+  sqlite3_stmt* stmt = nullptr;
+  int rc = sqlite3_prepare_v3(db_, sql.data(), static_cast<int>(sql.size()), 0, &stmt, nullptr);
+  if (rc != SQLITE_OK) {
+    sqlite3_finalize(stmt);
+    return ScopedStatement();
+  }
+  return ScopedStatement(nullptr, nullptr, stmt, 0);
+}
+
+bool StatementCache::EvictIdleSlot() {
+  for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+    ScopedStatement::Slot* slot = *it;
+    if (slot->borrowed > 0) {
+      continue;
+    }
+    for (sqlite3_stmt* stmt : slot->idle) {
+      sqlite3_finalize(stmt);
+    }
+    lru_.erase(slot->lru_it);
+    // Looked up first: the key views into the slot that erasing frees.
+    slots_.erase(slots_.find(std::string_view(slot->sql)));
+    ++evictions_;
+    return true;
+  }
+  return false;
+}
+
+void StatementCache::Return(ScopedStatement::Slot* slot, sqlite3_stmt* stmt,
+                            uint64_t generation) {
+  if (slot) {
+    --slot->borrowed;
+  }
+  if (!slot || generation != generation_) {
+    sqlite3_finalize(stmt);
+    return;
+  }
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  slot->idle.push_back(stmt);
+}
+
+size_t PaddedInListSize(size_t count) {
+  size_t slots = 16;
+  while (slots < count) {
+    slots *= 4;
+  }
+  return slots;
+}
+
+std::string InListPlaceholders(size_t count) {
+  std::string list;
+  list.reserve(count * 3);
+  for (size_t i = 0; i < count; ++i) {
+    list += i == 0 ? "?" : ", ?";
+  }
+  return list;
+}
+
+}  // namespace db
+}  // namespace vxcore
@@ -0,0 +1,147 @@
+#ifndef VXCORE_STATEMENT_CACHE_H
+#define VXCORE_STATEMENT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Forward declare SQLite types to avoid exposing them in the header
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace vxcore {
+namespace db {
+
+class StatementCache;
+
+// RAII handle to a prepared statement borrowed from a StatementCache.
+// On destruction the statement is reset, its bindings cleared, and it is
+// returned to the cache (or finalized if it was prepared uncached).
+// Converts implicitly to sqlite3_stmt* so it drops into sqlite3_bind_* and
+// sqlite3_step calls; it is null when preparation failed.
+class ScopedStatement {
+ public:
+  ScopedStatement() = default;
+  ~ScopedStatement();
+
+  ScopedStatement(ScopedStatement&& other) noexcept;
+  ScopedStatement& operator=(ScopedStatement&& other) noexcept;
+  ScopedStatement(const ScopedStatement&) = delete;
+  ScopedStatement& operator=(const ScopedStatement&) = delete;
+
+  sqlite3_stmt* get() const { return stmt_; }
+  operator sqlite3_stmt*() const { return stmt_; }
+
+ private:
+  friend class StatementCache;
+
+  struct Slot;
+  ScopedStatement(StatementCache* cache, Slot* slot, sqlite3_stmt* stmt, uint64_t generation)
+      : cache_(cache), slot_(slot), stmt_(stmt), generation_(generation) {}
+
+  void Release();
+
+  StatementCache* cache_ = nullptr;
+  // Null for statements prepared outside the cache (they are finalized).
+  Slot* slot_ = nullptr;
+  sqlite3_stmt* stmt_ = nullptr;
+  uint64_t generation_ = 0;
+};
+
+// Per-connection cache of prepared statements keyed by SQL text, so hot
+// queries are compiled once per connection instead of once per call.
+//
+// Each SQL text keeps a small free list: Acquire pops an idle statement (or
+// prepares a new one), and the ScopedStatement pushes it back when it goes
+// out of scope. Nested use of the same SQL (e.g. a row loop calling a helper
+// that runs the same query) therefore just prepares a second copy.
+//
+// At most kMaxEntries distinct SQL texts are cached. A new text evicts the
+// least recently used one that has no statement borrowed, so one-off SQL
+// cannot push hot statements out for good; only when every slot is borrowed
+// is a statement prepared and finalized per use. SQL that is known to be
+// one-off should go through PrepareUncached() instead of taking a slot.
+//
+// Owned by DbManager. NOT thread-safe, like the connection it wraps.
+class StatementCache {
+ public:
+  static constexpr size_t kMaxEntries = 128;
+
+  explicit StatementCache(sqlite3* db = nullptr);
+  ~StatementCache();
+
+  StatementCache(const StatementCache&) = delete;
+  StatementCache& operator=(const StatementCache&) = delete;
+
+  // Finalizes all idle statements and switches to |db| (may be nullptr).
+  // Statements still borrowed are finalized when their handles release.
+  // Handles must not outlive the cache itself.
+  void SetHandle(sqlite3* db);
+
+  sqlite3* GetHandle() const { return db_; }
+
+  // Returns a reset, unbound statement for |sql|. The handle is empty if the
+  // cache has no connection or preparation failed (see sqlite3_errmsg).
+  ScopedStatement Acquire(std::string_view sql);
+
+  // Prepares |sql| without caching it; the handle finalizes it on release.
+  ScopedStatement PrepareUncached(std::string_view sql);
+
+  // Finalizes every idle statement (e.g. before dropping tables).
+  void Clear();
+
+  // Counters for benchmarks and tests.
+  uint64_t GetHitCount() const { return hits_; }
+  uint64_t GetMissCount() const { return misses_; }
+  uint64_t GetEvictionCount() const { return evictions_; }
+  size_t GetEntryCount() const { return slots_.size(); }
+
+ private:
+  friend class ScopedStatement;
+
+  void Return(ScopedStatement::Slot* slot, sqlite3_stmt* stmt, uint64_t generation);
+
+  // Makes room for a new slot; false if every slot has a borrowed statement.
+  bool EvictIdleSlot();
+
+  sqlite3* db_ = nullptr;
+  // Bumped by Clear/SetHandle so statements borrowed before it are finalized
+  // on release instead of being cached against a stale connection.
+  uint64_t generation_ = 0;
+  // Slots with borrowed statements are never erased, so borrowed handles can
+  // keep raw Slot pointers. Keys view into Slot::sql, which is heap-stable.
+  std::unordered_map<std::string_view, std::unique_ptr<ScopedStatement::Slot>> slots_;
+  // Slots, most recently acquired first.
+  std::list<ScopedStatement::Slot*> lru_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+struct ScopedStatement::Slot {
+  std::string sql;
+  std::vector<sqlite3_stmt*> idle;
+  // Statements of this slot held by handles, whatever their generation.
+  size_t borrowed = 0;
+  std::list<Slot*>::iterator lru_it;
+};
+
+// --- IN-list helpers ---
+// Batch queries bind their keys into an IN list padded to one of a few fixed
+// sizes (16, 64, 256, ...), so each query keeps only a handful of cached
+// variants. Spare slots are bound to NULL, which IN never matches.
+
+size_t PaddedInListSize(size_t count);
+
+// "?, ?, ..., ?" with |count| placeholders
+std::string InListPlaceholders(size_t count);
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_STATEMENT_CACHE_H
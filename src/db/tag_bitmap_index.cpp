@@ -0,0 +1,273 @@
+#include "tag_bitmap_index.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include "tag_db.h"
+#include "utils/logger.h"
+
+namespace vxcore {
+namespace db {
+
+// --- State ---
+
+uint32_t TagBitmapIndex::State::Intern(const std::string& file_uuid) {
+  auto it = ordinals.find(file_uuid);
+  if (it != ordinals.end()) {
+    return it->second;
+  }
+
+  uint32_t ordinal;
+  if (!free_ordinals.empty()) {
+    ordinal = free_ordinals.back();
+    free_ordinals.pop_back();
+    uuids[ordinal] = file_uuid;
+  } else {
+    ordinal = static_cast<uint32_t>(uuids.size());
+    uuids.push_back(file_uuid);
+  }
+  ordinals.emplace(file_uuid, ordinal);
+  all_files.Add(ordinal);
+  return ordinal;
+}
+
+void TagBitmapIndex::State::ClearTagsOf(uint32_t ordinal) {
+  for (auto it = tags.begin(); it != tags.end();) {
+    if (it->second.Remove(ordinal) && it->second.IsEmpty()) {
+      it = tags.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// --- TagBitmapIndex ---
+
+bool TagBitmapIndex::Load(TagDb& tag_db) {
+  // Build outside the lock so readers keep matching against the old index.
+  State state;
+  bool ok = tag_db.ForEachFileTag([&state](const char* file_uuid, const char* tag_name) {
+    if (file_uuid == nullptr) {
+      return;
+    }
+    uint32_t ordinal = state.Intern(file_uuid);
+    if (tag_name != nullptr) {
+      state.tags[tag_name].Add(ordinal);
+    }
+  });
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!ok) {
+    VXCORE_LOG_WARN("Failed to load tag index: %s", tag_db.GetLastError().c_str());
+    loaded_ = false;
+    state_ = State();
+    return false;
+  }
+  state_ = std::move(state);
+  loaded_ = true;
+  VXCORE_LOG_DEBUG("Tag index loaded: %zu files, %zu tags", state_.ordinals.size(),
+                   state_.tags.size());
+  return true;
+}
+
+void TagBitmapIndex::Invalidate() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  loaded_ = false;
+  state_ = State();
+}
+
+bool TagBitmapIndex::IsLoaded() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return loaded_;
+}
+
+void TagBitmapIndex::SetPendingWrites(bool pending) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  pending_writes_ = pending;
+}
+
+bool TagBitmapIndex::HasPendingWrites() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return pending_writes_;
+}
+
+void TagBitmapIndex::SetFileTags(const std::string& file_uuid,
+                                 const std::vector<std::string>& tags) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!loaded_) {
+    return;
+  }
+  uint32_t ordinal = state_.Intern(file_uuid);
+  state_.ClearTagsOf(ordinal);
+  for (const auto& tag : tags) {
+    state_.tags[tag].Add(ordinal);
+  }
+}
+
+void TagBitmapIndex::AddFileTag(const std::string& file_uuid, const std::string& tag) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!loaded_) {
+    return;
+  }
+  state_.tags[tag].Add(state_.Intern(file_uuid));
+}
+
+void TagBitmapIndex::RemoveFileTag(const std::string& file_uuid, const std::string& tag) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!loaded_) {
+    return;
+  }
+  auto file_it = state_.ordinals.find(file_uuid);
+  auto tag_it = state_.tags.find(tag);
+  if (file_it == state_.ordinals.end() || tag_it == state_.tags.end()) {
+    return;
+  }
+  if (tag_it->second.Remove(file_it->second) && tag_it->second.IsEmpty()) {
+    state_.tags.erase(tag_it);
+  }
+}
+
+void TagBitmapIndex::RemoveFile(const std::string& file_uuid) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!loaded_) {
+    return;
+  }
+  auto it = state_.ordinals.find(file_uuid);
+  if (it == state_.ordinals.end()) {
+    return;
+  }
+  const uint32_t ordinal = it->second;
+  state_.ClearTagsOf(ordinal);
+  state_.all_files.Remove(ordinal);
+  state_.uuids[ordinal].clear();
+  state_.free_ordinals.push_back(ordinal);
+  state_.ordinals.erase(it);
+}
+
+std::optional<std::vector<std::string>> TagBitmapIndex::Match(
+    const std::vector<std::string>& all_of, const std::vector<std::string>& any_of,
+    const std::vector<std::string>& none_of, bool committed_only) const {
+  std::vector<std::vector<std::string>> all_of_groups;
+  all_of_groups.reserve(all_of.size());
+  for (const auto& tag : all_of) {
+    all_of_groups.push_back({tag});
+  }
+  return MatchGroups(all_of_groups, any_of, none_of, committed_only);
+}
+
+std::optional<std::vector<std::string>> TagBitmapIndex::MatchGroups(
+    const std::vector<std::vector<std::string>>& all_of_groups,
+    const std::vector<std::string>& any_of, const std::vector<std::string>& none_of,
+    bool committed_only) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (!loaded_ || (committed_only && pending_writes_)) {
+    return std::nullopt;
+  }
+  if (all_of_groups.empty() && any_of.empty() && none_of.empty()) {
+    return std::vector<std::string>();
+  }
+
+  // Union of the bitmaps of |tags|, or nullptr when none of them is in use.
+  // A single hit is returned as is rather than copied into |scratch|.
+  auto union_of = [this](const std::vector<std::string>& tags,
+                         CompressedBitmap& scratch) -> const CompressedBitmap* {
+    const CompressedBitmap* only = nullptr;
+    bool merged = false;
+    for (const auto& tag : tags) {
+      auto it = state_.tags.find(tag);
+      if (it == state_.tags.end()) {
+        continue;
+      }
+      if (only == nullptr) {
+        only = &it->second;
+        continue;
+      }
+      if (!merged) {
+        scratch = *only;
+        merged = true;
+      }
+      scratch |= it->second;
+    }
+    return merged ? &scratch : only;
+  };
+
+  // AND the required groups smallest first, so the working set shrinks fast.
+  std::vector<CompressedBitmap> unions(all_of_groups.size());
+  std::vector<const CompressedBitmap*> required;
+  for (size_t i = 0; i < all_of_groups.size(); ++i) {
+    const CompressedBitmap* group = union_of(all_of_groups[i], unions[i]);
+    if (group == nullptr) {
+      return std::vector<std::string>();
+    }
+    required.push_back(group);
+  }
+  std::sort(required.begin(), required.end(),
+            [](const CompressedBitmap* a, const CompressedBitmap* b) {
+              return a->Cardinality() < b->Cardinality();
+            });
+
+  CompressedBitmap result;
+  if (!required.empty()) {
+    result = *required.front();
+    for (size_t i = 1; i < required.size() && !result.IsEmpty(); ++i) {
+      result &= *required[i];
+    }
+  }
+
+  if (!any_of.empty()) {
+    CompressedBitmap any;
+    for (const auto& tag : any_of) {
+      auto it = state_.tags.find(tag);
+      if (it != state_.tags.end()) {
+        any |= it->second;
+      }
+    }
+    if (required.empty()) {
+      result = std::move(any);
+    } else {
+      result &= any;
+    }
+  } else if (required.empty()) {
+    result = state_.all_files;
+  }
+
+  for (const auto& tag : none_of) {
+    if (result.IsEmpty()) {
+      break;
+    }
+    auto it = state_.tags.find(tag);
+    if (it != state_.tags.end()) {
+      result -= it->second;
+    }
+  }
+
+  std::vector<std::string> file_uuids;
+  file_uuids.reserve(result.Cardinality());
+  for (uint32_t ordinal : result.ToVector()) {
+    file_uuids.push_back(state_.uuids[ordinal]);
+  }
+  return file_uuids;
+}
+
+size_t TagBitmapIndex::GetFileCount() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return state_.ordinals.size();
+}
+
+size_t TagBitmapIndex::GetTagCount() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return state_.tags.size();
+}
+
+size_t TagBitmapIndex::GetMemoryBytes() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  size_t bytes = state_.all_files.MemoryBytes();
+  for (const auto& entry : state_.tags) {
+    bytes += entry.second.MemoryBytes();
+  }
+  return bytes;
+}
+
+}  // namespace db
+}  // namespace vxcore
@@ -0,0 +1,105 @@
+#ifndef VXCORE_TAG_BITMAP_INDEX_H
+#define VXCORE_TAG_BITMAP_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compressed_bitmap.h"
+
+namespace vxcore {
+namespace db {
+
+class TagDb;
+
+// In-memory answer to tag expressions: one CompressedBitmap of file ordinals
+// per tag, plus one of every file for NOT terms, so AND/OR/NOT run as bitmap
+// operations instead of self-joins on file_tags.
+//
+// Files are keyed by UUID and given dense ordinals here rather than using
+// files.id, which changes whenever FileDb rewrites a row. Ordinals of deleted
+// files are reused.
+//
+// SqliteMetadataStore loads it from file_tags and mirrors every tag mutation
+// on its connection into it. Until loaded (or after Invalidate()), Match()
+// returns nullopt and callers fall back to SQL.
+//
+// Thread-safe: pooled readers match while the owner mutates.
+class TagBitmapIndex {
+ public:
+  TagBitmapIndex() = default;
+
+  TagBitmapIndex(const TagBitmapIndex&) = delete;
+  TagBitmapIndex& operator=(const TagBitmapIndex&) = delete;
+
+  // Rebuilds the index from |tag_db|'s connection in one query. Returns false
+  // (leaving the index unloaded) if the query fails.
+  bool Load(TagDb& tag_db);
+  void Invalidate();
+  bool IsLoaded() const;
+
+  // Set while the owner connection holds tag changes it has not committed;
+  // readers on other connections must not use the index then.
+  void SetPendingWrites(bool pending);
+  bool HasPendingWrites() const;
+
+  // --- Mutations (ignored while unloaded) ---
+
+  // Registers |file_uuid| if needed and replaces its tags.
+  void SetFileTags(const std::string& file_uuid, const std::vector<std::string>& tags);
+  void AddFileTag(const std::string& file_uuid, const std::string& tag);
+  void RemoveFileTag(const std::string& file_uuid, const std::string& tag);
+  void RemoveFile(const std::string& file_uuid);
+
+  // --- Queries ---
+
+  // UUIDs of the files with every tag in |all_of|, any tag in |any_of| (when
+  // non-empty) and no tag in |none_of|; nothing when all three are empty.
+  // Returns nullopt when the index is not loaded or, with |committed_only|
+  // (readers on other connections), while it has pending writes; both are
+  // checked under the same lock as the match.
+  std::optional<std::vector<std::string>> Match(const std::vector<std::string>& all_of,
+                                                const std::vector<std::string>& any_of,
+                                                const std::vector<std::string>& none_of,
+                                                bool committed_only = false) const;
+
+  // Match() where each required term is a group of alternatives: a file must
+  // carry at least one tag of every group in |all_of_groups|. Serves tag
+  // queries with descendants, the caller having expanded each tag to its
+  // subtree (any_of/none_of just take the flattened names).
+  std::optional<std::vector<std::string>> MatchGroups(
+      const std::vector<std::vector<std::string>>& all_of_groups,
+      const std::vector<std::string>& any_of, const std::vector<std::string>& none_of,
+      bool committed_only = false) const;
+
+  size_t GetFileCount() const;
+  size_t GetTagCount() const;
+  // Approximate bytes held by the bitmaps.
+  size_t GetMemoryBytes() const;
+
+ private:
+  struct State {
+    std::unordered_map<std::string, uint32_t> ordinals;  // File UUID -> ordinal
+    std::vector<std::string> uuids;                      // Ordinal -> UUID, "" if free
+    std::vector<uint32_t> free_ordinals;
+    std::unordered_map<std::string, CompressedBitmap> tags;
+    CompressedBitmap all_files;
+
+    uint32_t Intern(const std::string& file_uuid);
+    void ClearTagsOf(uint32_t ordinal);
+  };
+
+  mutable std::shared_mutex mutex_;
+  bool loaded_ = false;
+  bool pending_writes_ = false;
+  State state_;
+};
+
+}  // namespace db
+}  // namespace vxcore
+
+#endif  // VXCORE_TAG_BITMAP_INDEX_H
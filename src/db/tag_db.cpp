@@ -2,10 +2,83 @@
 
 #include <sqlite3.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace vxcore {
 namespace db {
 
-TagDb::TagDb(sqlite3* db) : db_(db) {}
+namespace {
+
+// UUIDs per GetFilesWithTagsByUuids query, as for FileDb's batch lookups.
+constexpr size_t kUuidBatchSize = 256;
+
+// The tag queries below take their names as IN lists padded with
+// PaddedInListSize (see AppendPadded), so each keeps a few cached shapes
+// however many tags a query names.
+
+// Matches the ids of files tagged with any of |count| bound names.
+std::string FilesTaggedAnySql(size_t count) {
+  return "SELECT ft.file_id FROM file_tags ft JOIN tags t ON t.id = ft.tag_id "
+         "WHERE t.name IN (" +
+         InListPlaceholders(count) + ")";
+}
+
+// Same, counting a tag's descendants as the tag itself.
+std::string FilesTaggedAnySubtreeSql(size_t count) {
+  return "SELECT ft.file_id FROM file_tags ft WHERE ft.tag_id IN ("
+         "WITH RECURSIVE subtree(id) AS ("
+         "SELECT id FROM tags WHERE name IN (" +
+         InListPlaceholders(count) +
+         ") "
+         "UNION SELECT t.id FROM tags t JOIN subtree s ON t.parent_id = s.id) "
+         "SELECT id FROM subtree)";
+}
+
+// Matches the ids of files tagged with every one of |count| bound names,
+// followed by one more parameter: the number of distinct names bound.
+std::string FilesTaggedAllSql(size_t count) {
+  return "SELECT ft.file_id FROM file_tags ft JOIN tags t ON t.id = ft.tag_id "
+         "WHERE t.name IN (" +
+         InListPlaceholders(count) +
+         ") GROUP BY ft.file_id HAVING COUNT(DISTINCT t.name) = CAST(? AS INTEGER)";
+}
+
+// Same, counting a tag's descendants as the tag itself.
+std::string FilesTaggedAllSubtreeSql(size_t count) {
+  return "SELECT file_id FROM ("
+         "WITH RECURSIVE subtree(root, id) AS ("
+         "SELECT name, id FROM tags WHERE name IN (" +
+         InListPlaceholders(count) +
+         ") "
+         "UNION SELECT s.root, t.id FROM tags t JOIN subtree s ON t.parent_id = s.id) "
+         "SELECT ft.file_id AS file_id, s.root AS root FROM file_tags ft "
+         "JOIN subtree s ON s.id = ft.tag_id) "
+         "GROUP BY file_id HAVING COUNT(DISTINCT root) = CAST(? AS INTEGER)";
+}
+
+// Appends |names| and NULLs up to the padded list size; returns that size.
+size_t AppendPadded(std::vector<std::optional<std::string>>& params,
+                    const std::vector<std::string>& names) {
+  const size_t padded = PaddedInListSize(names.size());
+  params.insert(params.end(), names.begin(), names.end());
+  params.resize(params.size() + padded - names.size());
+  return padded;
+}
+
+// |names| without duplicates, for the all-of count.
+std::vector<std::string> DistinctNames(std::vector<std::string> names) {
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+  return names;
+}
+
+}  // namespace
+
+TagDb::TagDb(sqlite3* db, StatementCache* cache)
+    : db_(db),
+      owned_cache_(cache ? nullptr : std::make_unique<StatementCache>(db)),
+      cache_(cache ? cache : owned_cache_.get()) {}
 
 std::string TagDb::GetLastError() const {
   if (db_ != nullptr) {
@@ -14,126 +87,199 @@ std::string TagDb::GetLastError() const {
   return "Database not initialized";
 }
 
-std::vector<TagQueryResult> TagDb::FindFilesByTagsAnd(const std::vector<std::string>& tags) {
-  if (tags.empty()) {
-    return {};
-  }
-
-  // Build query: find files that have ALL tags
-  // Strategy: Join file_tags once per tag, ensuring all match
+std::vector<TagQueryResult> TagDb::QueryFilesWithTags(
+    const std::string& match_sql, const std::vector<std::optional<std::string>>& params) {
+  // One row per (file, tag) pair, grouped by file in result order. The folder
+  // UUID and materialized path come from the same join, so callers need no
+  // per-row lookups.
   std::string sql =
-      "SELECT DISTINCT f.id, f.folder_id, f.name "
-      "FROM files f ";
-
-  for (size_t i = 0; i < tags.size(); ++i) {
-    sql += "JOIN file_tags ft" + std::to_string(i) + " ON f.id = ft" + std::to_string(i) +
-           ".file_id "
-           "JOIN tags t" +
-           std::to_string(i) + " ON ft" + std::to_string(i) + ".tag_id = t" + std::to_string(i) +
-           ".id AND t" + std::to_string(i) + ".name = ? ";
-  }
-
-  sql += "ORDER BY f.name;";
-
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+      "SELECT f.id, f.folder_id, f.name, f.uuid, d.uuid, d.path, at.name "
+      "FROM files f "
+      "LEFT JOIN folders d ON d.id = f.folder_id "
+      "LEFT JOIN file_tags aft ON aft.file_id = f.id "
+      "LEFT JOIN tags at ON at.id = aft.tag_id "
+      "WHERE f.id IN (" +
+      match_sql +
+      ") "
+      "ORDER BY f.name, f.id, at.name;";
+
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return {};
   }
 
-  // Bind tag names
-  for (size_t i = 0; i < tags.size(); ++i) {
-    sqlite3_bind_text(stmt, static_cast<int>(i + 1), tags[i].c_str(), -1, SQLITE_TRANSIENT);
+  // Unbound (and NULL) parameters never match in an IN list.
+  for (size_t i = 0; i < params.size(); ++i) {
+    if (params[i]) {
+      sqlite3_bind_text(stmt, static_cast<int>(i + 1), params[i]->c_str(), -1,
+                        SQLITE_TRANSIENT);
+    }
   }
 
+  auto column_string = [&stmt](int col) -> std::string {
+    const unsigned char* text = sqlite3_column_text(stmt, col);
+    return text ? reinterpret_cast<const char*>(text) : "";
+  };
+
   std::vector<TagQueryResult> results;
-  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-    TagQueryResult result;
-    result.file_id = sqlite3_column_int64(stmt, 0);
-    result.folder_id = sqlite3_column_int64(stmt, 1);
-    result.file_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-
-    // Get all tags for this file
-    const char* tag_sql =
-        "SELECT t.name FROM tags t "
-        "JOIN file_tags ft ON t.id = ft.tag_id "
-        "WHERE ft.file_id = ? ORDER BY t.name;";
-
-    sqlite3_stmt* tag_stmt = nullptr;
-    sqlite3_prepare_v2(db_, tag_sql, -1, &tag_stmt, nullptr);
-    sqlite3_bind_int64(tag_stmt, 1, result.file_id);
-
-    while (sqlite3_step(tag_stmt) == SQLITE_ROW) {
-      result.tags.push_back(reinterpret_cast<const char*>(sqlite3_column_text(tag_stmt, 0)));
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int64_t file_id = sqlite3_column_int64(stmt, 0);
+    if (results.empty() || results.back().file_id != file_id) {
+      TagQueryResult result;
+      result.file_id = file_id;
+      result.folder_id = sqlite3_column_int64(stmt, 1);
+      result.file_name = column_string(2);
+      result.file_uuid = column_string(3);
+      result.folder_uuid = column_string(4);
+      result.folder_path = column_string(5);
+      results.push_back(std::move(result));
+    }
+    if (sqlite3_column_type(stmt, 6) != SQLITE_NULL) {
+      results.back().tags.push_back(column_string(6));
     }
-    sqlite3_finalize(tag_stmt);
-
-    results.push_back(result);
   }
 
-  sqlite3_finalize(stmt);
   return results;
 }
 
-std::vector<TagQueryResult> TagDb::FindFilesByTagsOr(const std::vector<std::string>& tags) {
+std::vector<TagQueryResult> TagDb::FindFilesByTagsAnd(const std::vector<std::string>& tags) {
   if (tags.empty()) {
     return {};
   }
 
-  // Build query: find files that have ANY of the tags
-  std::string sql =
-      "SELECT DISTINCT f.id, f.folder_id, f.name "
-      "FROM files f "
-      "JOIN file_tags ft ON f.id = ft.file_id "
-      "JOIN tags t ON ft.tag_id = t.id "
-      "WHERE t.name IN (";
+  // Files matching as many distinct names as were asked for have them all.
+  const std::vector<std::string> distinct = DistinctNames(tags);
+  std::vector<std::optional<std::string>> params;
+  const size_t padded = AppendPadded(params, distinct);
+  params.push_back(std::to_string(distinct.size()));
+  return QueryFilesWithTags(FilesTaggedAllSql(padded), params);
+}
 
-  for (size_t i = 0; i < tags.size(); ++i) {
-    if (i > 0) sql += ", ";
-    sql += "?";
+std::vector<TagQueryResult> TagDb::FindFilesByTagsOr(const std::vector<std::string>& tags) {
+  if (tags.empty()) {
+    return {};
   }
-  sql += ") ORDER BY f.name;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  std::vector<std::optional<std::string>> params;
+  const size_t padded = AppendPadded(params, tags);
+  return QueryFilesWithTags(FilesTaggedAnySql(padded), params);
+}
+
+std::vector<TagQueryResult> TagDb::FindFilesByTagExpression(
+    const std::vector<std::string>& all_of, const std::vector<std::string>& any_of,
+    const std::vector<std::string>& none_of, bool include_descendants) {
+  if (all_of.empty() && any_of.empty() && none_of.empty()) {
     return {};
   }
 
-  // Bind tag names
+  auto tagged_any_sql = include_descendants ? FilesTaggedAnySubtreeSql : FilesTaggedAnySql;
+  auto tagged_all_sql = include_descendants ? FilesTaggedAllSubtreeSql : FilesTaggedAllSql;
+
+  // Compound selects evaluate left to right, so the EXCEPT goes last. Every
+  // list is padded, so the statement shape only depends on which lists are
+  // present and their padded sizes.
+  std::string sql;
+  std::vector<std::optional<std::string>> params;
+  if (!all_of.empty()) {
+    const std::vector<std::string> distinct = DistinctNames(all_of);
+    sql += tagged_all_sql(AppendPadded(params, distinct));
+    params.push_back(std::to_string(distinct.size()));
+  }
+  if (!any_of.empty()) {
+    if (!sql.empty()) sql += " INTERSECT ";
+    sql += tagged_any_sql(AppendPadded(params, any_of));
+  }
+  if (!none_of.empty()) {
+    if (sql.empty()) sql = "SELECT id FROM files";
+    sql += " EXCEPT " + tagged_any_sql(AppendPadded(params, none_of));
+  }
+
+  return QueryFilesWithTags(sql, params);
+}
+
+std::vector<std::vector<std::string>> TagDb::ExpandTagSubtrees(
+    const std::vector<std::string>& tags) {
+  std::vector<std::vector<std::string>> subtrees;
+  subtrees.reserve(tags.size());
+  for (const auto& tag : tags) {
+    subtrees.push_back({tag});
+  }
+  if (tags.empty()) {
+    return subtrees;
+  }
+
+  // Each row pairs a requested root with one tag strictly below it.
+  std::string sql =
+      "WITH RECURSIVE subtree(root, id) AS ("
+      "SELECT name, id FROM tags WHERE name IN (" +
+      InListPlaceholders(PaddedInListSize(tags.size())) +
+      ") "
+      "UNION SELECT s.root, t.id FROM tags t JOIN subtree s ON t.parent_id = s.id) "
+      "SELECT s.root, t.name FROM subtree s JOIN tags t ON t.id = s.id "
+      "WHERE t.name != s.root;";
+
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return subtrees;
+  }
   for (size_t i = 0; i < tags.size(); ++i) {
     sqlite3_bind_text(stmt, static_cast<int>(i + 1), tags[i].c_str(), -1, SQLITE_TRANSIENT);
   }
 
-  std::vector<TagQueryResult> results;
-  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-    TagQueryResult result;
-    result.file_id = sqlite3_column_int64(stmt, 0);
-    result.folder_id = sqlite3_column_int64(stmt, 1);
-    result.file_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-
-    // Get all tags for this file
-    const char* tag_sql =
-        "SELECT t.name FROM tags t "
-        "JOIN file_tags ft ON t.id = ft.tag_id "
-        "WHERE ft.file_id = ? ORDER BY t.name;";
-
-    sqlite3_stmt* tag_stmt = nullptr;
-    sqlite3_prepare_v2(db_, tag_sql, -1, &tag_stmt, nullptr);
-    sqlite3_bind_int64(tag_stmt, 1, result.file_id);
-
-    while (sqlite3_step(tag_stmt) == SQLITE_ROW) {
-      result.tags.push_back(reinterpret_cast<const char*>(sqlite3_column_text(tag_stmt, 0)));
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    const char* root = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    for (size_t i = 0; i < tags.size(); ++i) {
+      if (tags[i] == root) {
+        subtrees[i].push_back(name);
+      }
     }
-    sqlite3_finalize(tag_stmt);
+  }
+  return subtrees;
+}
 
-    results.push_back(result);
+std::vector<TagQueryResult> TagDb::GetFilesWithTagsByUuids(const std::vector<std::string>& uuids) {
+  std::vector<TagQueryResult> results;
+  for (size_t start = 0; start < uuids.size(); start += kUuidBatchSize) {
+    const size_t end = std::min(uuids.size(), start + kUuidBatchSize);
+    std::vector<std::string> batch(uuids.begin() + start, uuids.begin() + end);
+    std::vector<std::optional<std::string>> params;
+    const size_t padded = AppendPadded(params, batch);
+    auto batch_results = QueryFilesWithTags(
+        "SELECT id FROM files WHERE uuid IN (" + InListPlaceholders(padded) + ")", params);
+    results.insert(results.end(), std::make_move_iterator(batch_results.begin()),
+                   std::make_move_iterator(batch_results.end()));
   }
 
-  sqlite3_finalize(stmt);
+  // Each batch is sorted on its own; restore the overall order.
+  if (uuids.size() > kUuidBatchSize) {
+    std::sort(results.begin(), results.end(), [](const TagQueryResult& a, const TagQueryResult& b) {
+      return a.file_name != b.file_name ? a.file_name < b.file_name : a.file_id < b.file_id;
+    });
+  }
   return results;
 }
 
+bool TagDb::ForEachFileTag(const FileTagVisitor& callback) {
+  const char* sql =
+      "SELECT f.uuid, t.name FROM files f "
+      "LEFT JOIN file_tags ft ON ft.file_id = f.id "
+      "LEFT JOIN tags t ON t.id = ft.tag_id "
+      "ORDER BY f.id;";
+
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return false;
+  }
+
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    callback(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+             reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+  }
+  return rc == SQLITE_DONE;
+}
+
 std::vector<std::pair<std::string, int>> TagDb::CountFilesByTag() {
   const char* sql =
       "SELECT t.name, COUNT(ft.file_id) as file_count "
@@ -142,20 +288,54 @@ std::vector<std::pair<std::string, int>> TagDb::CountFilesByTag() {
       "GROUP BY t.id, t.name "
       "ORDER BY file_count DESC, t.name;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return {};
   }
 
   std::vector<std::pair<std::string, int>> results;
-  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
     std::string tag_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
     int count = sqlite3_column_int(stmt, 1);
     results.push_back({tag_name, count});
   }
 
-  sqlite3_finalize(stmt);
+  return results;
+}
+
+std::vector<TagSubtreeCount> TagDb::CountFilesByTagSubtree() {
+  // closure holds (ancestor, descendant) for every tag and itself; UNION
+  // rather than UNION ALL so a malformed parent cycle still terminates.
+  const char* sql =
+      "WITH RECURSIVE closure(ancestor, id) AS ("
+      "SELECT id, id FROM tags "
+      "UNION SELECT c.ancestor, t.id FROM tags t JOIN closure c ON t.parent_id = c.id) "
+      "SELECT a.name, p.name, "
+      "COUNT(DISTINCT CASE WHEN c.id = a.id THEN ft.file_id END), "
+      "COUNT(DISTINCT ft.file_id) "
+      "FROM tags a "
+      "LEFT JOIN tags p ON p.id = a.parent_id "
+      "JOIN closure c ON c.ancestor = a.id "
+      "LEFT JOIN file_tags ft ON ft.tag_id = c.id "
+      "GROUP BY a.id "
+      "ORDER BY a.name;";
+
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
+    return {};
+  }
+
+  std::vector<TagSubtreeCount> results;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    TagSubtreeCount count;
+    count.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    const unsigned char* parent = sqlite3_column_text(stmt, 1);
+    count.parent_name = parent ? reinterpret_cast<const char*>(parent) : "";
+    count.file_count = sqlite3_column_int(stmt, 2);
+    count.subtree_file_count = sqlite3_column_int(stmt, 3);
+    results.push_back(std::move(count));
+  }
+
   return results;
 }
 
@@ -168,9 +348,8 @@ int64_t TagDb::CreateOrUpdateTag(const std::string& tag_name, int64_t parent_id,
   if (existing) {
     // Update existing tag
     const char* update_sql = "UPDATE tags SET parent_id = ?, metadata = ? WHERE id = ?;";
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db_, update_sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    ScopedStatement stmt = cache_->Acquire(update_sql);
+    if (!stmt) {
       return -1;
     }
 
@@ -182,17 +361,15 @@ int64_t TagDb::CreateOrUpdateTag(const std::string& tag_name, int64_t parent_id,
     sqlite3_bind_text(stmt, 2, metadata.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int64(stmt, 3, existing->id);
 
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
 
     return (rc == SQLITE_DONE) ? existing->id : -1;
   }
 
   // Create new tag
   const char* insert_sql = "INSERT INTO tags (name, parent_id, metadata) VALUES (?, ?, ?);";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, insert_sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(insert_sql);
+  if (!stmt) {
     return -1;
   }
 
@@ -204,13 +381,12 @@ int64_t TagDb::CreateOrUpdateTag(const std::string& tag_name, int64_t parent_id,
   }
   sqlite3_bind_text(stmt, 3, metadata.c_str(), -1, SQLITE_TRANSIENT);
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   int64_t tag_id = -1;
   if (rc == SQLITE_DONE) {
     tag_id = sqlite3_last_insert_rowid(db_);
   }
 
-  sqlite3_finalize(stmt);
   return tag_id;
 }
 
@@ -227,17 +403,15 @@ int64_t TagDb::GetOrCreateTag(const std::string& tag_name) {
 
 std::optional<TagRecord> TagDb::GetTag(const std::string& tag_name) {
   const char* sql = "SELECT id, name, parent_id, metadata FROM tags WHERE name = ?;";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return std::nullopt;
   }
 
   sqlite3_bind_text(stmt, 1, tag_name.c_str(), -1, SQLITE_TRANSIENT);
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
 
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
@@ -249,23 +423,20 @@ std::optional<TagRecord> TagDb::GetTag(const std::string& tag_name) {
                      ? ""
                      : reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
 
-  sqlite3_finalize(stmt);
   return tag;
 }
 
 std::optional<TagRecord> TagDb::GetTagById(int64_t tag_id) {
   const char* sql = "SELECT id, name, parent_id, metadata FROM tags WHERE id = ?;";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return std::nullopt;
   }
 
   sqlite3_bind_int64(stmt, 1, tag_id);
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
 
   if (rc != SQLITE_ROW) {
-    sqlite3_finalize(stmt);
     return std::nullopt;
   }
 
@@ -277,7 +448,6 @@ std::optional<TagRecord> TagDb::GetTagById(int64_t tag_id) {
                      ? ""
                      : reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
 
-  sqlite3_finalize(stmt);
   return tag;
 }
 
@@ -285,15 +455,13 @@ bool TagDb::DeleteTag(int64_t tag_id) {
   // Foreign key cascade will handle deletion of children and file associations
   const char* sql = "DELETE FROM tags WHERE id = ?;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return false;
   }
 
   sqlite3_bind_int64(stmt, 1, tag_id);
-  rc = sqlite3_step(stmt);
-  sqlite3_finalize(stmt);
+  int rc = sqlite3_step(stmt);
 
   return rc == SQLITE_DONE;
 }
@@ -301,14 +469,13 @@ bool TagDb::DeleteTag(int64_t tag_id) {
 std::vector<TagRecord> TagDb::ListAllTags() {
   const char* sql = "SELECT id, name, parent_id, metadata FROM tags ORDER BY name;";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return {};
   }
 
   std::vector<TagRecord> tags;
-  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
     TagRecord tag;
     tag.id = sqlite3_column_int64(stmt, 0);
     tag.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
@@ -320,7 +487,6 @@ std::vector<TagRecord> TagDb::ListAllTags() {
     tags.push_back(tag);
   }
 
-  sqlite3_finalize(stmt);
   return tags;
 }
 
@@ -336,9 +502,8 @@ std::vector<TagRecord> TagDb::ListChildTags(int64_t parent_id) {
         "WHERE parent_id = ? ORDER BY name;";
   }
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK) {
+  ScopedStatement stmt = cache_->Acquire(sql);
+  if (!stmt) {
     return {};
   }
 
@@ -347,7 +512,7 @@ std::vector<TagRecord> TagDb::ListChildTags(int64_t parent_id) {
   }
 
   std::vector<TagRecord> tags;
-  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
     TagRecord tag;
     tag.id = sqlite3_column_int64(stmt, 0);
     tag.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
@@ -359,7 +524,6 @@ std::vector<TagRecord> TagDb::ListChildTags(int64_t parent_id) {
     tags.push_back(tag);
   }
 
-  sqlite3_finalize(stmt);
   return tags;
 }
 
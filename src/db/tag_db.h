@@ -2,10 +2,14 @@
 #define VXCORE_TAG_DB_H
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "statement_cache.h"
+
 // Forward declare sqlite3
 struct sqlite3;
 
@@ -26,13 +30,26 @@ struct TagQueryResult {
   int64_t folder_id;
   std::string file_name;
   std::vector<std::string> tags;
+  std::string file_uuid;
+  std::string folder_uuid;  // Empty if the folder row is missing
+  std::string folder_path;  // folders.path; empty if missing (see FileDb::GetFolderPath)
+};
+
+// File counts for one tag and its subtree
+struct TagSubtreeCount {
+  std::string name;
+  std::string parent_name;  // Empty for root tags
+  int file_count;
+  int subtree_file_count;  // Distinct files tagged with the tag or a descendant
 };
 
 // Tag database operations (CRUD + queries)
 // NOT thread-safe: caller must ensure synchronization
 class TagDb {
  public:
-  explicit TagDb(sqlite3* db);
+  // Pass the DbManager's statement cache to share compiled statements with
+  // the other *Db classes on this connection; null keeps a private cache.
+  explicit TagDb(sqlite3* db, StatementCache* cache = nullptr);
   ~TagDb() = default;
 
   // Disable copy/move
@@ -70,20 +87,57 @@ class TagDb {
   // --- Tag Query Operations ---
 
   // Finds files that have ALL of the given tags (AND logic)
+  // One query returns the files with their UUIDs, folder paths, and tags.
   std::vector<TagQueryResult> FindFilesByTagsAnd(const std::vector<std::string>& tags);
 
   // Finds files that have ANY of the given tags (OR logic)
   std::vector<TagQueryResult> FindFilesByTagsOr(const std::vector<std::string>& tags);
 
+  // Finds files that have every tag in |all_of|, at least one tag in
+  // |any_of| (when non-empty) and no tag in |none_of|, in one compound query.
+  // With |include_descendants| each tag also matches the tags below it.
+  // Returns nothing when all three lists are empty.
+  std::vector<TagQueryResult> FindFilesByTagExpression(const std::vector<std::string>& all_of,
+                                                       const std::vector<std::string>& any_of,
+                                                       const std::vector<std::string>& none_of,
+                                                       bool include_descendants = false);
+
+  // For each entry of |tags|, that tag's name followed by the names of all
+  // its descendants (in no particular order), resolved in one recursive
+  // query. An unknown tag yields just its own name.
+  std::vector<std::vector<std::string>> ExpandTagSubtrees(const std::vector<std::string>& tags);
+
+  // Loads the files whose UUID is in |uuids| (unknown UUIDs are skipped),
+  // ordered like the Find* queries. Materializes TagBitmapIndex matches.
+  std::vector<TagQueryResult> GetFilesWithTagsByUuids(const std::vector<std::string>& uuids);
+
+  // Streams every file as (uuid, tag name) rows in file id order, one row
+  // per tag; |tag_name| is null for a file without tags. Feeds
+  // TagBitmapIndex::Load. The callback must not write to the database.
+  using FileTagVisitor = std::function<void(const char* file_uuid, const char* tag_name)>;
+  bool ForEachFileTag(const FileTagVisitor& callback);
+
   // Counts files for each tag
   // Returns vector of pairs: (tag_name, file_count)
   std::vector<std::pair<std::string, int>> CountFilesByTag();
 
+  // Counts files for each tag and for the subtree rooted at it, in one pass
+  // over the tag closure. Ordered by tag name.
+  std::vector<TagSubtreeCount> CountFilesByTagSubtree();
+
   // Returns the last error message
   std::string GetLastError() const;
 
  private:
+  // Runs |match_sql| (selecting matching file ids, with one text parameter
+  // per entry of |params|; empty entries and extra placeholders stay NULL)
+  // and returns the matched files joined with their folder and full tag list.
+  std::vector<TagQueryResult> QueryFilesWithTags(
+      const std::string& match_sql, const std::vector<std::optional<std::string>>& params);
+
   sqlite3* db_;
+  std::unique_ptr<StatementCache> owned_cache_;
+  StatementCache* cache_;
 };
 
 }  // namespace db
@@ -1,8 +1,12 @@
 #include "search_manager.h"
 
 #include <algorithm>
+#include <limits>
+#include <numeric>
 
+#include "core/activity_manager.h"
 #include "core/folder_manager.h"
+#include "core/metadata_store.h"
 #include "core/notebook.h"
 #include "rg_search_backend.h"
 #include "simple_search_backend.h"
@@ -13,6 +17,21 @@ namespace vxcore {
 
 namespace {
 
+// Compiles a search's tag terms once, so each file is tested against the same
+// expression the tag index answers (see StoreTagFilter).
+StoreTagFilter MakeTagFilter(const std::vector<std::string> &tags, const std::string &tag_operator,
+                             const std::vector<std::string> &exclude_tags) {
+  StoreTagFilter filter;
+  (tag_operator == "AND" ? filter.all_of : filter.any_of) = tags;
+  filter.none_of = exclude_tags;
+  return filter;
+}
+
+// Unlike StoreTagFilter::Matches, a search without tag terms keeps every file.
+bool MatchesTagFilter(const StoreTagFilter &filter, const std::vector<std::string> &file_tags) {
+  return filter.IsEmpty() || filter.Matches(file_tags);
+}
+
 // Encodes a single matched file into the per-file content-search JSON shape shared by the
 // blob (SearchContent) and streaming (SearchContentStreaming) paths. Kept as the SINGLE
 // source of truth so the two paths can never drift; key insertion order is fixed
@@ -65,6 +84,10 @@ void SearchManager::SetWorkQueue(WorkQueue *queue) { work_queue_ = queue; }
 
 void SearchManager::SetCancelFlag(const volatile int *flag) { cancel_flag_ = flag; }
 
+void SearchManager::SetActivityManager(ActivityManager *activity_manager) {
+  activity_manager_ = activity_manager;
+}
+
 VxCoreError SearchManager::SearchFiles(const std::string &query_json,
                                        const std::string &input_files_json,
                                        std::string &out_results_json) {
@@ -87,9 +110,9 @@ VxCoreError SearchManager::SearchFiles(const std::string &query_json,
                        filtered_files[i].is_folder);
     }
 
-    auto matched_files =
-        GetMatchedFilesByPattern(std::move(filtered_files), query.pattern, query.include_files,
-                                 query.include_folders, query.max_results);
+    auto matched_files = GetMatchedFilesByPattern(
+        std::move(filtered_files), query.pattern, query.include_files, query.include_folders,
+        query.max_results, query.rank_by_frecency && activity_manager_);
     VXCORE_LOG_DEBUG("SearchManager::SearchFiles: matched_files count=%zu", matched_files.size());
 
     out_results_json = SerializeFileResults(matched_files, query.max_results);
@@ -261,7 +284,10 @@ VxCoreError SearchManager::SearchByTags(const std::string &query_json,
 
 std::vector<SearchFileInfo> SearchManager::GetMatchedFilesByPattern(
     std::vector<SearchFileInfo> filtered_files, const std::string &pattern, bool include_files,
-    bool include_folders, int max_results) {
+    bool include_folders, int max_results, bool rank_by_frecency) {
+  // Ranking needs every match, so the walk cannot stop at max_results.
+  const int collect_limit = rank_by_frecency ? std::numeric_limits<int>::max() : max_results;
+
   if (pattern.empty()) {
     std::vector<SearchFileInfo> matched_files;
     for (auto &file : filtered_files) {
@@ -269,10 +295,16 @@ std::vector<SearchFileInfo> SearchManager::GetMatchedFilesByPattern(
         continue;
       }
       matched_files.push_back(std::move(file));
-      if (static_cast<int>(matched_files.size()) >= max_results) {
+      if (static_cast<int>(matched_files.size()) >= collect_limit) {
         break;
       }
     }
+    if (rank_by_frecency) {
+      SortByFrecency(matched_files);
+      if (static_cast<int>(matched_files.size()) > max_results) {
+        matched_files.resize(std::max(max_results, 0));
+      }
+    }
     return matched_files;
   }
 
@@ -295,14 +327,20 @@ std::vector<SearchFileInfo> SearchManager::GetMatchedFilesByPattern(
       path_matches.push_back(std::move(file));
     }
 
-    if (static_cast<int>(name_matches.size() + path_matches.size()) >= max_results) {
+    if (static_cast<int>(name_matches.size() + path_matches.size()) >= collect_limit) {
       break;
     }
   }
 
+  if (rank_by_frecency) {
+    SortByFrecency(name_matches);
+    SortByFrecency(path_matches);
+  }
+
   std::vector<SearchFileInfo> matched_files;
   matched_files.reserve(
-      std::min(static_cast<size_t>(max_results), name_matches.size() + path_matches.size()));
+      std::min(static_cast<size_t>(std::max(max_results, 0)),
+               name_matches.size() + path_matches.size()));
   for (auto &file : name_matches) {
     if (static_cast<int>(matched_files.size()) >= max_results) {
       break;
@@ -319,16 +357,40 @@ std::vector<SearchFileInfo> SearchManager::GetMatchedFilesByPattern(
   return matched_files;
 }
 
+void SearchManager::SortByFrecency(std::vector<SearchFileInfo> &files) const {
+  if (!activity_manager_ || files.size() < 2) {
+    return;
+  }
+  std::vector<std::string> ids;
+  ids.reserve(files.size());
+  for (const auto &file : files) {
+    ids.push_back(file.is_folder ? std::string() : file.id);
+  }
+  const auto scores = activity_manager_->GetFrecencyScores(notebook_->GetId(), ids);
+
+  std::vector<size_t> order(files.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&scores](size_t a, size_t b) { return scores[a] > scores[b]; });
+  std::vector<SearchFileInfo> sorted;
+  sorted.reserve(files.size());
+  for (size_t index : order) {
+    sorted.push_back(std::move(files[index]));
+  }
+  files = std::move(sorted);
+}
+
 std::vector<SearchFileInfo> SearchManager::GetMatchedFilesByTags(
     std::vector<SearchFileInfo> filtered_files, const std::vector<std::string> &tags,
     const std::string &tag_operator, int max_results) {
+  const StoreTagFilter filter = MakeTagFilter(tags, tag_operator, {});
   std::vector<SearchFileInfo> matched_files;
   for (auto &file : filtered_files) {
     if (file.is_folder) {
       continue;
     }
 
-    if (MatchesTags(file.tags, tags, tag_operator)) {
+    if (MatchesTagFilter(filter, file.tags)) {
       matched_files.push_back(std::move(file));
       if (static_cast<int>(matched_files.size()) >= max_results) {
         break;
@@ -376,6 +438,9 @@ std::vector<SearchFileInfo> SearchManager::GetAllFiles(const SearchScope &scope,
       VxCoreError err = notebook_->GetFolderManager()->GetFileInfo(file_path, &record);
       if (err == VXCORE_OK) {
         assert(record);
+        if (!scope.metadata_filter.Matches(record->metadata)) {
+          continue;
+        }
         VXCORE_LOG_DEBUG("SearchManager::GetAllFiles: GetFileInfo OK for '%s' name='%s'",
                          file_path.c_str(), record->name.c_str());
         result.push_back(SearchFileInfo::FromFileRecord(file_path, *record));
@@ -387,14 +452,14 @@ std::vector<SearchFileInfo> SearchManager::GetAllFiles(const SearchScope &scope,
 
     for (const auto &folder_path : input_files->folders) {
       VXCORE_LOG_DEBUG("SearchManager::GetAllFiles: collecting folder '%s'", folder_path.c_str());
-      CollectFilesInFolder(folder_path, scope.recursive, lower_path_patterns,
+      CollectFilesInFolder(folder_path, scope, lower_path_patterns,
                            lower_exclude_path_patterns, include_folders, result);
     }
   } else {
     const std::string start_path = scope.folder_path.empty() ? "." : scope.folder_path;
     VXCORE_LOG_DEBUG("SearchManager::GetAllFiles: no input_files, scanning from '%s'",
                      start_path.c_str());
-    CollectFilesInFolder(start_path, scope.recursive, lower_path_patterns,
+    CollectFilesInFolder(start_path, scope, lower_path_patterns,
                          lower_exclude_path_patterns, include_folders, result);
   }
 
@@ -407,23 +472,10 @@ std::vector<SearchFileInfo> SearchManager::FilterFilesByTagsAndDate(
   std::vector<SearchFileInfo> result;
   const bool filter_by_created = scope.date_filter_field == "created";
   const bool filter_by_modified = scope.date_filter_field == "modified";
+  const StoreTagFilter tag_filter =
+      MakeTagFilter(scope.tags, scope.tag_operator, scope.exclude_tags);
   for (auto &file : files) {
-    bool matches = true;
-
-    if (!scope.tags.empty() && !file.is_folder) {
-      if (!MatchesTags(file.tags, scope.tags, scope.tag_operator)) {
-        matches = false;
-      }
-    }
-
-    if (matches && !scope.exclude_tags.empty() && !file.is_folder) {
-      for (const auto &exclude_tag : scope.exclude_tags) {
-        if (std::find(file.tags.begin(), file.tags.end(), exclude_tag) != file.tags.end()) {
-          matches = false;
-          break;
-        }
-      }
-    }
+    bool matches = file.is_folder || MatchesTagFilter(tag_filter, file.tags);
 
     if (matches && !scope.date_filter_field.empty()) {
       int64_t timestamp = 0;
@@ -445,7 +497,7 @@ std::vector<SearchFileInfo> SearchManager::FilterFilesByTagsAndDate(
 }
 
 void SearchManager::CollectFilesInFolder(
-    const std::string &folder_path, bool recursive,
+    const std::string &folder_path, const SearchScope &scope,
     const std::vector<std::string> &lower_path_patterns,
     const std::vector<std::string> &lower_exclude_path_patterns, bool include_folders,
     std::vector<SearchFileInfo> &out_files) {
@@ -469,6 +521,9 @@ void SearchManager::CollectFilesInFolder(
     if (!lower_path_patterns.empty() && !MatchesPatterns(lower_file_path, lower_path_patterns)) {
       continue;
     }
+    if (!scope.metadata_filter.Matches(file.metadata)) {
+      continue;
+    }
     out_files.push_back(SearchFileInfo::FromFileRecord(file_path, file));
   }
 
@@ -480,41 +535,18 @@ void SearchManager::CollectFilesInFolder(
       continue;
     }
 
-    if (include_folders) {
+    // A folder failing the metadata filter still has its contents searched.
+    if (include_folders && scope.metadata_filter.Matches(folder.metadata)) {
       out_files.push_back(SearchFileInfo::FromFolderRecord(subfolder_path, folder));
     }
 
-    if (recursive) {
-      CollectFilesInFolder(subfolder_path, recursive, lower_path_patterns,
+    if (scope.recursive) {
+      CollectFilesInFolder(subfolder_path, scope, lower_path_patterns,
                            lower_exclude_path_patterns, include_folders, out_files);
     }
   }
 }
 
-bool SearchManager::MatchesTags(const std::vector<std::string> &file_tags,
-                                const std::vector<std::string> &search_tags,
-                                const std::string &tag_operator) const {
-  if (search_tags.empty()) {
-    return true;
-  }
-
-  if (tag_operator == "AND") {
-    for (const auto &search_tag : search_tags) {
-      if (std::find(file_tags.begin(), file_tags.end(), search_tag) == file_tags.end()) {
-        return false;
-      }
-    }
-    return true;
-  } else {
-    for (const auto &search_tag : search_tags) {
-      if (std::find(file_tags.begin(), file_tags.end(), search_tag) != file_tags.end()) {
-        return true;
-      }
-    }
-    return false;
-  }
-}
-
 bool SearchManager::MatchesDateFilter(int64_t timestamp, const SearchScope &scope) const {
   if (scope.date_filter_from > 0 && timestamp < scope.date_filter_from) {
     return false;
@@ -13,6 +13,7 @@
 
 namespace vxcore {
 
+class ActivityManager;
 class Notebook;
 class WorkQueue;
 
@@ -48,6 +49,9 @@ class SearchManager {
 
   void SetWorkQueue(WorkQueue *queue);
   void SetCancelFlag(const volatile int *flag);
+  // Source of frecency scores for SearchFilesQuery::rank_by_frecency; may be
+  // null, in which case that option has no effect.
+  void SetActivityManager(ActivityManager *activity_manager);
 
  private:
   std::vector<SearchFileInfo> GetAllFiles(const SearchScope &scope,
@@ -64,7 +68,11 @@ class SearchManager {
   std::vector<SearchFileInfo> GetMatchedFilesByPattern(std::vector<SearchFileInfo> filtered_files,
                                                        const std::string &pattern,
                                                        bool include_files, bool include_folders,
-                                                       int max_results);
+                                                       int max_results, bool rank_by_frecency);
+
+  // Stable-sorts |files| by descending frecency; folders and unused files
+  // score 0 and keep their relative order.
+  void SortByFrecency(std::vector<SearchFileInfo> &files) const;
 
   std::vector<SearchFileInfo> GetMatchedFilesByTags(std::vector<SearchFileInfo> filtered_files,
                                                     const std::vector<std::string> &tags,
@@ -74,15 +82,13 @@ class SearchManager {
   std::string SerializeFileResults(const std::vector<SearchFileInfo> &matched_files,
                                    int max_results);
 
-  void CollectFilesInFolder(const std::string &folder_path, bool recursive,
+  // Applies the scope's path patterns and metadata filter; the metadata is
+  // only at hand here, on the records.
+  void CollectFilesInFolder(const std::string &folder_path, const SearchScope &scope,
                             const std::vector<std::string> &lower_path_patterns,
                             const std::vector<std::string> &lower_exclude_path_patterns,
                             bool include_folders, std::vector<SearchFileInfo> &out_files);
 
-  bool MatchesTags(const std::vector<std::string> &file_tags,
-                   const std::vector<std::string> &search_tags,
-                   const std::string &tag_operator) const;
-
   bool MatchesDateFilter(int64_t timestamp, const SearchScope &scope) const;
 
   void CalculateAbsolutePaths(std::vector<SearchFileInfo> &files) const;
@@ -91,6 +97,7 @@ class SearchManager {
   std::unique_ptr<ISearchBackend> search_backend_;
   WorkQueue *work_queue_ = nullptr;
   const volatile int *cancel_flag_ = nullptr;
+  ActivityManager *activity_manager_ = nullptr;
 };
 
 }  // namespace vxcore
@@ -1,5 +1,7 @@
 #include "search_query.h"
 
+#include <stdexcept>
+
 #include "core/notebook.h"
 
 namespace vxcore {
@@ -55,6 +57,12 @@ SearchScope SearchScope::FromJson(const Notebook *notebook, const nlohmann::json
       scope.date_filter_to = df["to"].get<int64_t>();
     }
   }
+  if (json.contains("metadata")) {
+    std::string error;
+    if (!MetadataFilter::FromJson(json["metadata"], scope.metadata_filter, error)) {
+      throw std::invalid_argument(error);
+    }
+  }
   return scope;
 }
 
@@ -114,6 +122,10 @@ SearchFilesQuery SearchFilesQuery::FromJson(const Notebook *notebook, const nloh
     query.max_results = json["maxResults"].get<int>();
   }
 
+  if (json.contains("rankByFrecency")) {
+    query.rank_by_frecency = json["rankByFrecency"].get<bool>();
+  }
+
   return query;
 }
 
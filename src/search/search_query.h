@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+#include "core/metadata_filter.h"
+
 namespace vxcore {
 
 class Notebook;
@@ -41,6 +43,9 @@ struct SearchScope {
   std::string date_filter_field;
   int64_t date_filter_from = 0;
   int64_t date_filter_to = 0;
+  // Files and folders whose metadata fails it are left out; see
+  // MetadataFilter::FromJson for the "metadata" JSON forms.
+  MetadataFilter metadata_filter;
 
   static SearchScope FromJson(const nlohmann::json &json);
   static SearchScope FromJson(const Notebook *notebook, const nlohmann::json &json);
@@ -60,6 +65,10 @@ struct SearchFilesQuery {
   bool include_folders = true;
   SearchScope scope;
   int max_results = 100;
+  // Within the name-match and path-match tiers, order files by frecency
+  // (see ActivityManager) instead of traversal order. Considers every match
+  // before truncating to max_results.
+  bool rank_by_frecency = false;
 
   static SearchFilesQuery FromJson(const nlohmann::json &json);
   static SearchFilesQuery FromJson(const Notebook *notebook, const nlohmann::json &json);
@@ -1,6 +1,8 @@
 #ifndef VXCORE_SEARCH_QUEUE_NAME_H
 #define VXCORE_SEARCH_QUEUE_NAME_H
 
+#include <cstddef>
+
 namespace vxcore {
 
 // Single source of truth for the dedicated content-search work queue name.
@@ -8,6 +10,10 @@ namespace vxcore {
 // (vxcore_search_content / vxcore_search_content_ex) the same named queue.
 constexpr char kSearchQueueName[] = "vxcore.search";
 
+// Pending-chunk bound for that queue. A huge scan then holds at most this many
+// chunk closures at once: the initiator help-drains while the queue is full.
+constexpr size_t kSearchQueueCapacity = 256;
+
 }  // namespace vxcore
 
 #endif  // VXCORE_SEARCH_QUEUE_NAME_H
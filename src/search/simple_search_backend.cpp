@@ -338,7 +338,16 @@ VxCoreError SimpleSearchBackend::SearchStreaming(
       }
     };
 
-    if (!work_queue_->Enqueue(std::move(work))) {
+    // Backpressure: when the queue is bounded and full, the initiator drains an item itself
+    // instead of blocking, so pending chunk closures never exceed the queue capacity and the
+    // sweep proceeds at consumer speed (the initiator may be the queue's only consumer, so a
+    // blocking Enqueue could deadlock).
+    WorkItem item(std::move(work));
+    EnqueueResult result;
+    while ((result = work_queue_->TryEnqueue(item)) == EnqueueResult::kFull) {
+      work_queue_->ProcessNext(kHelpDrainPollMs);
+    }
+    if (result == EnqueueResult::kShutdown) {
       // Enqueue failed (queue shut down): the item will never run, so account for it here —
       // never strand the remaining counter.
       remaining.fetch_sub(1, std::memory_order_release);
@@ -30,8 +30,9 @@ class SimpleSearchBackend : public ISearchBackend {
   // kDefaultSearchChunkSize) and fires |emit_batch| exactly once per chunk (including
   // zero-match chunks). Applies NO truncation. When a work queue is configured and there is
   // more than one chunk, chunks are enqueued to the "vxcore.search" queue and the initiating
-  // thread help-drains; otherwise chunks run inline on the calling thread. Honors the cancel
-  // flag (returns VXCORE_ERR_CANCELLED). May fire callbacks concurrently across drain threads.
+  // thread help-drains, also whenever a bounded queue is full, so pending chunks never exceed
+  // its capacity; otherwise chunks run inline on the calling thread. Honors the cancel flag
+  // (returns VXCORE_ERR_CANCELLED). May fire callbacks concurrently across drain threads.
   VxCoreError SearchStreaming(const std::vector<SearchFileInfo> &files, const std::string &pattern,
                               SearchOption options,
                               const std::vector<std::string> &content_exclude_patterns,
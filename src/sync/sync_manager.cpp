@@ -7,6 +7,7 @@
 
 #include "core/event_manager.h"
 #include "core/event_names.h"
+#include "core/folder_manager.h"
 #include "core/notebook.h"
 #include "core/notebook_manager.h"
 #include "core/work_queue.h"
@@ -37,11 +38,13 @@ void SyncManager::SetEventManager(EventManager *event_manager) {
   event_manager_ = event_manager;
   if (!event_manager_) return;
 
-  auto mark_dirty = [this](const std::string &event_name, const nlohmann::json &data) {
+  // Typed subscriptions (event_names.h payloads): the emitters never build
+  // JSON for us, and only the notebook id is needed here.
+  auto mark_dirty = [this](std::string_view event_name, std::string_view notebook_id) {
     auto mark_dirty_start = std::chrono::steady_clock::now();
     
-    if (data.contains(kJsonKeyNotebookId) && data[kJsonKeyNotebookId].is_string()) {
-      std::string nb_id = data[kJsonKeyNotebookId].get<std::string>();
+    if (!notebook_id.empty()) {
+      std::string nb_id(notebook_id);
       // Task 7.5 (F3.2): cache-presence is the correct predicate here — it
       // means "EnableSync has populated runtime state for this notebook in
       // this process". Wave 10.1 (F2.4 part 2): the read MUST take
@@ -55,8 +58,9 @@ void SyncManager::SetEventManager(EventManager *event_manager) {
         std::lock_guard<std::mutex> lock(state_mutex_);
         sync_enabled = (configs_cache_.count(nb_id) > 0);
       }
-      VXCORE_LOG_DEBUG("SyncManager::mark_dirty: event=%s notebookId=%s sync_enabled=%d",
-                       event_name.c_str(), nb_id.c_str(), sync_enabled ? 1 : 0);
+      VXCORE_LOG_DEBUG("SyncManager::mark_dirty: event=%.*s notebookId=%s sync_enabled=%d",
+                       static_cast<int>(event_name.size()), event_name.data(), nb_id.c_str(),
+                       sync_enabled ? 1 : 0);
       if (sync_enabled) {
         // Wave 9.2 (F2.4): delegate to DirtyTracker (self-locking). Empty
         // path placeholder preserves the current per-notebook-only semantics;
@@ -73,14 +77,27 @@ void SyncManager::SetEventManager(EventManager *event_manager) {
     VXCORE_LOG_DEBUG("SyncManager: [perf.mark_dirty] elapsed_us=%ld", mark_dirty_us);
   };
 
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFileCreated, mark_dirty));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFileSaved, mark_dirty));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFileDeleted, mark_dirty));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFileMoved, mark_dirty));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFolderCreated, mark_dirty));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFolderDeleted, mark_dirty));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kFolderConfigChanged, mark_dirty));
-  event_listener_ids_.push_back(event_manager_->Subscribe(events::kNotebookConfigChanged, mark_dirty));
+  TypedEventCallback<events::NodeEvent> on_node =
+      [mark_dirty](std::string_view name, const events::NodeEvent &e) {
+        mark_dirty(name, e.notebook_id);
+      };
+  TypedEventCallback<events::NodeMovedEvent> on_moved =
+      [mark_dirty](std::string_view name, const events::NodeMovedEvent &e) {
+        mark_dirty(name, e.notebook_id);
+      };
+  TypedEventCallback<events::NotebookEvent> on_notebook =
+      [mark_dirty](std::string_view name, const events::NotebookEvent &e) {
+        mark_dirty(name, e.notebook_id);
+      };
+
+  for (const char *name : {events::kFileCreated, events::kFileSaved, events::kFileDeleted,
+                           events::kFolderCreated, events::kFolderDeleted,
+                           events::kFolderConfigChanged}) {
+    event_listener_ids_.push_back(event_manager_->SubscribeTyped(name, on_node));
+  }
+  event_listener_ids_.push_back(event_manager_->SubscribeTyped(events::kFileMoved, on_moved));
+  event_listener_ids_.push_back(
+      event_manager_->SubscribeTyped(events::kNotebookConfigChanged, on_notebook));
 }
 
 void SyncManager::SetWorkQueueManager(WorkQueueManager *work_queue_manager) {
@@ -130,7 +147,7 @@ void SyncManager::MaybeEnqueueSync(const std::string &notebook_id) {
 
   // Emit sync.should_run OUTSIDE any SyncManager lock. EventManager listeners
   // may re-enter SyncManager (e.g., the Qt auto-route consumer that calls TriggerSync).
-  event_manager_->Emit(events::kSyncShouldRun, {{kJsonKeyNotebookId, notebook_id}});
+  event_manager_->EmitTyped(events::kSyncShouldRun, events::NotebookEvent{notebook_id});
   VXCORE_LOG_INFO("SyncManager: emitted sync.should_run for notebook: %s", notebook_id.c_str());
   
   auto maybe_enqueue_end = std::chrono::steady_clock::now();
@@ -215,6 +232,16 @@ VxCoreError SyncManager::ValidateNotebook(const std::string &notebook_id) {
   return VXCORE_OK;
 }
 
+void SyncManager::FlushConfigWrites(const std::string &notebook_id) {
+  auto *notebook = notebook_manager_->GetNotebook(notebook_id);
+  auto *folder_manager = notebook ? notebook->GetFolderManager() : nullptr;
+  if (folder_manager && folder_manager->FlushConfigWrites() != VXCORE_OK) {
+    VXCORE_LOG_WARN("SyncManager::FlushConfigWrites: pending folder configs not written: "
+                    "notebook_id=%s",
+                    notebook_id.c_str());
+  }
+}
+
 VxCoreError SyncManager::EnableSync(const std::string &notebook_id, const SyncConfig &config) {
   VXCORE_LOG_DEBUG("SyncManager::EnableSync: notebook_id=%s", notebook_id.c_str());
   return EnableSyncImpl(notebook_id, config, nullptr, nullptr);
@@ -652,9 +679,11 @@ VxCoreError SyncManager::TriggerSync(const std::string &notebook_id,
   // fan-out is "external" per AGENTS.md § SyncManager Locking Discipline
   // rule 3 — listeners may call back into SyncManager.
   if (event_manager_) {
-    event_manager_->Emit(events::kSyncStarted, {{kJsonKeyNotebookId, notebook_id}});
+    event_manager_->EmitTyped(events::kSyncStarted, events::NotebookEvent{notebook_id});
   }
 
+  FlushConfigWrites(notebook_id);
+
   // EXTERNAL CALLS — outside state_mutex_. SetCancellation runs first so
   // an early Cancel() between install and Sync() entry is still observed
   // by the in-flight Sync().
@@ -693,6 +722,14 @@ VxCoreError SyncManager::TriggerSync(const std::string &notebook_id,
     auto *notebook = notebook_manager_->GetNotebook(notebook_id);
     if (notebook) {
       notebook->SetLastSyncUtc(GetCurrentTimestampMillis());
+      // The pull may have rewritten vx.json files under the metadata cache.
+      // Reconcile re-reads only the changed ones. Best-effort like the above:
+      // lazy sync and RebuildCache still converge.
+      const VxCoreError reconcile_err = notebook->ReconcileCache();
+      if (reconcile_err != VXCORE_OK) {
+        VXCORE_LOG_WARN("SyncManager::TriggerSync: cache reconcile failed: notebook_id=%s err=%d",
+                        notebook_id.c_str(), reconcile_err);
+      }
     }
   }
 
@@ -755,6 +792,8 @@ VxCoreError SyncManager::StageOnly(const std::string &notebook_id,
     backend_ptr = backend_it->second.get();
   }
 
+  FlushConfigWrites(notebook_id);
+
   // EXTERNAL CALLS — outside state_mutex_. SetCancellation must run before
   // the phase so an early Cancel() between install and entry is observed.
   backend_ptr->SetCancellation(cancellation);
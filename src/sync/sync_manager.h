@@ -274,6 +274,10 @@ class SyncManager {
  private:
   VxCoreError ValidateNotebook(const std::string &notebook_id);
 
+  // Writes the notebook's pending folder configs (write-behind) so the
+  // backend stages what the notebook shows. Best-effort: failures are logged.
+  void FlushConfigWrites(const std::string &notebook_id);
+
   // Shared implementation for EnableSync overloads. Wave 6.3 F4.4 collapsed
   // the legacy SyncCredentials* parameter — callers that have a
   // SyncCredentials wrap it in an InMemoryCredentialProvider before calling
@@ -1,6 +1,7 @@
 #include "utils.h"
 
 #include <chrono>
+#include <cstdio>
 #include <random>
 #include <sstream>
 
@@ -43,4 +44,15 @@ int64_t GetCurrentTimestampMillis() {
       .count();
 }
 
+std::string HashContent(const std::string &data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  char buf[17];
+  std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+  return buf;
+}
+
 }  // namespace vxcore
@@ -11,6 +11,10 @@ std::string GenerateUUID();
 
 int64_t GetCurrentTimestampMillis();
 
+// 64-bit FNV-1a of |data| as 16 hex digits. For change detection only; not a
+// cryptographic hash.
+std::string HashContent(const std::string &data);
+
 template <typename EnumT>
 bool HasFlag(EnumT flags, EnumT flag) {
   static_assert(std::is_enum<EnumT>::value, "HasFlag requires enum type");
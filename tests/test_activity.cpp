@@ -201,6 +201,86 @@ int test_moved_updates_file_path() {
   return 0;
 }
 
+int test_frecent_files_and_search_ranking() {
+  std::cout << "  Running test_frecent_files_and_search_ranking..." << std::endl;
+  const std::string root = get_test_path("activity_frecency");
+  cleanup_test_dir(root);
+
+  VxCoreContextHandle ctx = nullptr;
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+
+  // A fresh notebook id, so rows left in activity.db by earlier runs don't
+  // show up in its ranking.
+  char *nb_id = nullptr;
+  ASSERT_EQ(vxcore_notebook_create(ctx, root.c_str(), "{\"name\":\"Fr\"}",
+                                   VXCORE_NOTEBOOK_BUNDLED, &nb_id),
+            VXCORE_OK);
+
+  char *a_id = nullptr;
+  char *b_id = nullptr;
+  char *c_id = nullptr;
+  ASSERT_EQ(vxcore_file_create(ctx, nb_id, ".", "alpha.md", &a_id), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_create(ctx, nb_id, ".", "beta.md", &b_id), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_create(ctx, nb_id, ".", "gamma.md", &c_id), VXCORE_OK);
+
+  // alpha: one read (1). beta: two edits (4). gamma: five reads (5), then
+  // deleted, so it must drop out of the results.
+  ASSERT_EQ(vxcore_activity_record_read(ctx, nb_id, "alpha.md"), VXCORE_OK);
+  ASSERT_EQ(vxcore_activity_record_edit(ctx, nb_id, "beta.md"), VXCORE_OK);
+  ASSERT_EQ(vxcore_activity_record_edit(ctx, nb_id, "beta.md"), VXCORE_OK);
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(vxcore_activity_record_read(ctx, nb_id, "gamma.md"), VXCORE_OK);
+  }
+  ASSERT_EQ(vxcore_activity_flush(ctx), VXCORE_OK);
+  ASSERT_EQ(vxcore_node_delete(ctx, nb_id, "gamma.md"), VXCORE_OK);
+
+  char *frecent_json = nullptr;
+  ASSERT_EQ(vxcore_activity_get_frecent_files(ctx, nb_id, 10, &frecent_json), VXCORE_OK);
+  auto jf = nlohmann::json::parse(frecent_json);
+  vxcore_string_free(frecent_json);
+  ASSERT_EQ(jf["files"].size(), 2u);
+  ASSERT_EQ(jf["files"][0]["fileId"].get<std::string>(), std::string(b_id));
+  ASSERT_EQ(jf["files"][0]["path"].get<std::string>(), std::string("beta.md"));
+  ASSERT_EQ(jf["files"][1]["fileId"].get<std::string>(), std::string(a_id));
+  ASSERT_TRUE(jf["files"][0]["score"].get<double>() > jf["files"][1]["score"].get<double>());
+
+  // The limit applies after deleted files are skipped.
+  ASSERT_EQ(vxcore_activity_get_frecent_files(ctx, nb_id, 1, &frecent_json), VXCORE_OK);
+  jf = nlohmann::json::parse(frecent_json);
+  vxcore_string_free(frecent_json);
+  ASSERT_EQ(jf["files"].size(), 1u);
+  ASSERT_EQ(jf["files"][0]["fileId"].get<std::string>(), std::string(b_id));
+
+  // Quick-open: with rankByFrecency, used files come first and the limit
+  // applies to the ranked list.
+  const char *query_json = R"({
+    "pattern": "*.md",
+    "includeFiles": true,
+    "includeFolders": false,
+    "maxResults": 1,
+    "rankByFrecency": true,
+    "scope": {"folderPath": ".", "recursive": true}
+  })";
+  char *results = nullptr;
+  ASSERT_EQ(vxcore_search_files(ctx, nb_id, query_json, nullptr, &results), VXCORE_OK);
+  auto js = nlohmann::json::parse(results);
+  vxcore_string_free(results);
+  ASSERT_EQ(js["matches"].size(), 1u);
+  ASSERT_EQ(js["matches"][0]["id"].get<std::string>(), std::string(b_id));
+
+  ASSERT_EQ(vxcore_activity_get_frecent_files(ctx, nullptr, 10, &frecent_json),
+            VXCORE_ERR_NULL_POINTER);
+
+  vxcore_string_free(a_id);
+  vxcore_string_free(b_id);
+  vxcore_string_free(c_id);
+  vxcore_string_free(nb_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(root);
+  std::cout << "  ✓ passed" << std::endl;
+  return 0;
+}
+
 }  // namespace
 
 int main() {
@@ -208,6 +288,7 @@ int main() {
   RUN_TEST(test_focus_and_record_queries);
   RUN_TEST(test_created_and_saved_events_counted);
   RUN_TEST(test_moved_updates_file_path);
+  RUN_TEST(test_frecent_files_and_search_ranking);
   std::cout << "All test_activity tests passed" << std::endl;
   return 0;
 }
@@ -2,16 +2,20 @@
 //
 // Direct-compiles db/activity_db.cpp + db/db_manager.cpp + needed utils; links
 // sqlite3 + nlohmann_json. Exercises schema init/migration, UPSERT increments,
-// range aggregation, hot-file ranking, retain-on-delete, and migration no-op.
+// range aggregation, hot-file ranking, retain-on-delete, and migration no-op,
+// plus the FrecencyIndex that ActivityManager seeds from these rows.
 
 #include <nlohmann/json.hpp>
 
 #include <string>
+#include <vector>
 
+#include "core/frecency_index.h"
 #include "db/activity_db.h"
 #include "db/db_manager.h"
 #include "test_utils.h"
 
+using vxcore::FrecencyIndex;
 using vxcore::db::ActivityDb;
 using vxcore::db::DbManager;
 
@@ -173,6 +177,83 @@ int test_file_history_and_retain_on_delete() {
   return 0;
 }
 
+int test_for_each_file_activity() {
+  std::cout << "  Running test_for_each_file_activity..." << std::endl;
+  FreshDir();
+  DbManager db;
+  ASSERT_TRUE(db.Open(DbPath()));
+  ActivityDb adb(db.GetHandle());
+  ASSERT_TRUE(adb.InitializeSchema());
+
+  adb.UpsertFileActivity("2026-06-01", "nb1", "A", "a.md", 5, 0);
+  adb.UpsertFileActivity("2026-07-09", "nb1", "A", "a.md", 1, 0);
+  adb.UpsertFileActivity("2026-07-10", "nb2", "B", "b.md", 0, 3);
+
+  std::vector<std::string> seen;
+  int64_t reads = 0, edits = 0;
+  ASSERT_TRUE(adb.ForEachFileActivity(
+      "2026-07-01", [&](const std::string &date, const std::string &nb, const std::string &file,
+                        int64_t r, int64_t e) {
+        seen.push_back(date + "/" + nb + "/" + file);
+        reads += r;
+        edits += e;
+      }));
+  // The June row is before from_date.
+  ASSERT_EQ(seen.size(), 2u);
+  ASSERT_EQ(reads, 1);
+  ASSERT_EQ(edits, 3);
+
+  std::cout << "  ✓ passed" << std::endl;
+  return 0;
+}
+
+int test_frecency_ranking_and_decay() {
+  std::cout << "  Running test_frecency_ranking_and_decay..." << std::endl;
+  const int64_t half_life = FrecencyIndex::kHalfLifeMs;
+  const int64_t now = 1780000000000LL;  // 2026-05-28
+
+  FrecencyIndex index;
+  // Old but heavy: 8 reads two half-lives ago score 2 now.
+  index.Add("nb1", "old", 8 * FrecencyIndex::kReadWeight, now - 2 * half_life);
+  // Recent: one edit now scores 2 as well, one read more breaks the tie.
+  index.Add("nb1", "recent", FrecencyIndex::kEditWeight, now);
+  index.Add("nb1", "recent", FrecencyIndex::kReadWeight, now - half_life);
+  index.Add("nb1", "once", FrecencyIndex::kReadWeight, now);
+  index.Add("nb2", "other", 100.0, now);
+  ASSERT_EQ(index.Size(), 4u);
+
+  auto near = [](double a, double b) { return a - b < 1e-9 && b - a < 1e-9; };
+  ASSERT_TRUE(near(index.GetScore("nb1", "old", now), 2.0));
+  ASSERT_TRUE(near(index.GetScore("nb1", "recent", now), 2.5));
+  ASSERT_TRUE(near(index.GetScore("nb1", "once", now), 1.0));
+  ASSERT_TRUE(near(index.GetScore("nb1", "once", now + half_life), 0.5));
+  ASSERT_TRUE(near(index.GetScore("nb1", "missing", now), 0.0));
+  ASSERT_TRUE(near(index.GetScore("nb3", "old", now), 0.0));
+
+  std::vector<std::string> order;
+  index.ForEachRanked("nb1", now, [&](const std::string &id, double) {
+    order.push_back(id);
+    return true;
+  });
+  ASSERT_TRUE(order == (std::vector<std::string>{"recent", "old", "once"}));
+
+  // Decay never reorders files; new usage does. Two more reads of "once"
+  // today put it on top.
+  index.Add("nb1", "once", 2 * FrecencyIndex::kReadWeight, now);
+  order.clear();
+  index.ForEachRanked("nb1", now + 10 * half_life, [&](const std::string &id, double) {
+    order.push_back(id);
+    return order.size() < 2;  // stops early
+  });
+  ASSERT_TRUE(order == (std::vector<std::string>{"once", "recent"}));
+
+  index.Clear();
+  ASSERT_EQ(index.Size(), 0u);
+
+  std::cout << "  ✓ passed" << std::endl;
+  return 0;
+}
+
 }  // namespace
 
 int main() {
@@ -182,6 +263,8 @@ int main() {
   RUN_TEST(test_range_aggregation);
   RUN_TEST(test_hot_files_ranking);
   RUN_TEST(test_file_history_and_retain_on_delete);
+  RUN_TEST(test_for_each_file_activity);
+  RUN_TEST(test_frecency_ranking_and_decay);
   std::cout << "All test_activity_db tests passed" << std::endl;
   return 0;
 }
@@ -217,6 +217,50 @@ int test_update_config_merges_all_fields() {
   return 0;
 }
 
+// The "database" section round-trips through update_config, and scheduling
+// maintenance queues one job per due database (activity.db at least) on the
+// host-drained maintenance queue.
+int test_database_config_and_maintenance() {
+  std::cout << "  Running test_database_config_and_maintenance..." << std::endl;
+  VxCoreContextHandle ctx = nullptr;
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+
+  char *json_str = nullptr;
+  ASSERT_EQ(vxcore_context_get_config(ctx, &json_str), VXCORE_OK);
+  auto j = nlohmann::json::parse(json_str);
+  vxcore_string_free(json_str);
+  ASSERT_EQ(j["database"]["profile"].get<std::string>(), std::string("balanced"));
+
+  ASSERT_EQ(vxcore_context_update_config(
+                ctx, R"({"database": {"profile": "performance", "idleCheckpointSeconds": 0}})"),
+            VXCORE_OK);
+  ASSERT_EQ(vxcore_context_get_config(ctx, &json_str), VXCORE_OK);
+  j = nlohmann::json::parse(json_str);
+  vxcore_string_free(json_str);
+  ASSERT_EQ(j["database"]["profile"].get<std::string>(), std::string("performance"));
+  ASSERT_EQ(j["database"]["idleCheckpointSeconds"].get<int>(), 0);
+  ASSERT_EQ(j["database"]["optimizeIntervalMinutes"].get<int>(), 120);
+
+  int scheduled = -1;
+  ASSERT_EQ(vxcore_db_schedule_maintenance(ctx, &scheduled), VXCORE_OK);
+  ASSERT_TRUE(scheduled >= 1);
+  ASSERT_EQ(vxcore_work_queue_size(ctx, "vxcore.maintenance"), scheduled);
+  ASSERT_EQ(vxcore_work_queue_process_all(ctx, "vxcore.maintenance"), scheduled);
+
+  // A zero checkpoint interval makes every database due again.
+  int again = -1;
+  ASSERT_EQ(vxcore_db_schedule_maintenance(ctx, &again), VXCORE_OK);
+  ASSERT_EQ(again, scheduled);
+  vxcore_work_queue_process_all(ctx, "vxcore.maintenance");
+
+  ASSERT_EQ(vxcore_db_schedule_maintenance(nullptr, &again), VXCORE_ERR_NULL_POINTER);
+
+  vxcore_context_destroy(ctx);
+  vxcore_clear_test_directory();
+  std::cout << "  ✓ test_database_config_and_maintenance passed" << std::endl;
+  return 0;
+}
+
 int main() {
   std::cout << "Running core tests..." << std::endl;
 
@@ -231,6 +275,7 @@ int main() {
   RUN_TEST(test_update_config_raw_content);
   RUN_TEST(test_config_by_name_both_locations);
   RUN_TEST(test_update_config_merges_all_fields);
+  RUN_TEST(test_database_config_and_maintenance);
 
   std::cout << "✓ All core tests passed" << std::endl;
   return 0;
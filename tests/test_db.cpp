@@ -1,10 +1,22 @@
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <set>
+#include <tuple>
 #include <nlohmann/json.hpp>
 
+#include <sqlite3.h>
+
+#include "db/db_maintenance.h"
 #include "db/db_manager.h"
+#include "db/db_tuning.h"
 #include "db/file_db.h"
+#include "db/statement_cache.h"
+#include "db/compressed_bitmap.h"
+#include "db/tag_bitmap_index.h"
 #include "db/tag_db.h"
+#include "core/metadata_filter.h"
 #include "test_utils.h"
 
 using namespace vxcore::db;
@@ -149,6 +161,168 @@ int test_db_manager_rebuild() {
   return 0;
 }
 
+// Reads a single-integer PRAGMA from |db|.
+static int64_t query_pragma(sqlite3 *db, const char *pragma) {
+  sqlite3_stmt *stmt = nullptr;
+  int64_t value = -1;
+  std::string sql = std::string("PRAGMA ") + pragma + ";";
+  if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK &&
+      sqlite3_step(stmt) == SQLITE_ROW) {
+    value = sqlite3_column_int64(stmt, 0);
+  }
+  sqlite3_finalize(stmt);
+  return value;
+}
+
+int test_db_tuning_profiles() {
+  std::cout << "  Running test_db_tuning_profiles..." << std::endl;
+
+  const auto &names = DbTuning::ProfileNames();
+  ASSERT_FALSE(names.empty());
+  ASSERT_EQ(names.front(), "balanced");
+  for (const auto &name : names) {
+    DbTuning tuning;
+    ASSERT_TRUE(DbTuning::ForProfile(name, tuning));
+  }
+
+  DbTuning tuning;
+  tuning.cache_size_kib = 123;
+  ASSERT_FALSE(DbTuning::ForProfile("no-such-profile", tuning));
+  ASSERT_EQ(tuning.cache_size_kib, 123);
+
+  // The "sqlite" profile changes nothing.
+  DbTuning defaults;
+  ASSERT_TRUE(DbTuning::ForProfile("sqlite", defaults));
+  ASSERT_TRUE(defaults.BuildPragmas(false).empty());
+
+  // Read-only connections only get the read-side settings.
+  DbTuning performance;
+  ASSERT_TRUE(DbTuning::ForProfile("performance", performance));
+  ASSERT_TRUE(performance.BuildPragmas(true).size() < performance.BuildPragmas(false).size());
+  for (const auto &pragma : performance.BuildPragmas(true)) {
+    ASSERT_EQ(pragma.find("synchronous"), std::string::npos);
+    ASSERT_EQ(pragma.find("wal_autocheckpoint"), std::string::npos);
+  }
+
+  std::cout << "  ✓ test_db_tuning_profiles passed" << std::endl;
+  return 0;
+}
+
+int test_db_manager_applies_tuning() {
+  std::cout << "  Running test_db_manager_applies_tuning..." << std::endl;
+
+  setup_test_db();
+
+  DbTuning tuning;
+  ASSERT_TRUE(DbTuning::ForProfile("performance", tuning));
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path, tuning));
+  sqlite3 *db = db_manager.GetHandle();
+  // Negative cache_size is in KiB.
+  ASSERT_EQ(query_pragma(db, "cache_size"), -tuning.cache_size_kib);
+  ASSERT_EQ(query_pragma(db, "synchronous"), tuning.synchronous);
+  ASSERT_EQ(query_pragma(db, "wal_autocheckpoint"), tuning.wal_autocheckpoint_pages);
+  ASSERT_EQ(query_pragma(db, "journal_size_limit"), tuning.journal_size_limit_bytes);
+  ASSERT_EQ(query_pragma(db, "temp_store"), 2);
+  db_manager.Close();
+
+  // Open(path) uses the process-wide default, which is "balanced" unless changed.
+  DbTuning durable;
+  ASSERT_TRUE(DbTuning::ForProfile("durable", durable));
+  DbTuning saved = DbManager::GetDefaultTuning();
+  DbManager::SetDefaultTuning(durable);
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_EQ(query_pragma(db_manager.GetHandle(), "synchronous"), 2);
+  ASSERT_EQ(db_manager.GetTuning().synchronous, 2);
+  db_manager.Close();
+  DbManager::SetDefaultTuning(saved);
+
+  cleanup_test_db();
+  std::cout << "  ✓ test_db_manager_applies_tuning passed" << std::endl;
+  return 0;
+}
+
+int test_db_maintenance_checkpoint() {
+  std::cout << "  Running test_db_maintenance_checkpoint..." << std::endl;
+
+  setup_test_db();
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+  FileDb file_db(db_manager.GetHandle());
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_NE(file_db.CreateFolder(-1, "folder_" + std::to_string(i), 1000, 2000), -1);
+  }
+
+  // Runs beside the still-open owner connection.
+  DbMaintenanceResult result;
+  ASSERT_TRUE(RunDbMaintenance(test_db_path, true, 1000, &result));
+  ASSERT_TRUE(result.wal_frames > 0);
+  ASSERT_EQ(result.checkpointed_frames, result.wal_frames);
+  ASSERT_TRUE(result.optimized);
+
+  // Data written after the checkpoint is still there.
+  ASSERT_NE(file_db.CreateFolder(-1, "after", 1000, 2000), -1);
+  ASSERT_EQ(file_db.ListFolders(-1).size(), 21u);
+  db_manager.Close();
+
+  // Never creates a missing database.
+  cleanup_test_db();
+  ASSERT_FALSE(RunDbMaintenance(test_db_path, false, 0));
+  ASSERT_FALSE(std::filesystem::exists(test_db_path));
+
+  std::cout << "  ✓ test_db_maintenance_checkpoint passed" << std::endl;
+  return 0;
+}
+
+int test_db_maintenance_scheduler() {
+  std::cout << "  Running test_db_maintenance_scheduler..." << std::endl;
+
+  using Clock = DbMaintenanceScheduler::Clock;
+  DbMaintenanceScheduler scheduler(std::chrono::seconds(60), std::chrono::minutes(10));
+  const Clock::time_point t0 = Clock::now();
+  const std::vector<std::string> paths = {"a.db", "b.db"};
+
+  // Everything gets a first checkpoint; nothing is optimized on first sight.
+  auto tasks = scheduler.CollectDue(paths, t0);
+  ASSERT_EQ(tasks.size(), 2u);
+  for (const auto &task : tasks) {
+    ASSERT_FALSE(task.optimize);
+    scheduler.MarkScheduled(task, t0);
+  }
+
+  ASSERT_TRUE(scheduler.CollectDue(paths, t0 + std::chrono::seconds(30)).empty());
+
+  // Only the checkpoint interval has passed.
+  tasks = scheduler.CollectDue(paths, t0 + std::chrono::seconds(61));
+  ASSERT_EQ(tasks.size(), 2u);
+  ASSERT_FALSE(tasks[0].optimize);
+
+  // Unmarked tasks stay due; both intervals have passed now.
+  tasks = scheduler.CollectDue({"a.db"}, t0 + std::chrono::minutes(11));
+  ASSERT_EQ(tasks.size(), 1u);
+  ASSERT_EQ(tasks[0].db_path, "a.db");
+  ASSERT_TRUE(tasks[0].optimize);
+  scheduler.MarkScheduled(tasks[0], t0 + std::chrono::minutes(11));
+
+  // b.db was forgotten when it disappeared, so it counts as new again.
+  tasks = scheduler.CollectDue(paths, t0 + std::chrono::minutes(11) + std::chrono::seconds(1));
+  ASSERT_EQ(tasks.size(), 1u);
+  ASSERT_EQ(tasks[0].db_path, "b.db");
+  ASSERT_FALSE(tasks[0].optimize);
+
+  // An optimize interval of zero disables optimize.
+  scheduler.SetIntervals(std::chrono::seconds(60), std::chrono::seconds(0));
+  tasks = scheduler.CollectDue({"a.db"}, t0 + std::chrono::hours(5));
+  ASSERT_EQ(tasks.size(), 1u);
+  ASSERT_FALSE(tasks[0].optimize);
+
+  std::cout << "  ✓ test_db_maintenance_scheduler passed" << std::endl;
+  return 0;
+}
+
 // ============================================================================
 // FileDb - Folder Tests
 // ============================================================================
@@ -935,6 +1109,101 @@ int test_filedb_get_folder_by_path_with_dot_root() {
   return 0;
 }
 
+int test_filedb_folder_path_maintained() {
+  std::cout << "  Running test_filedb_folder_path_maintained..." << std::endl;
+
+  setup_test_db();
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+
+  FileDb file_db(db_manager.GetHandle());
+
+  int64_t dot_id = file_db.CreateFolder(-1, ".", 1000, 2000);
+  int64_t a_id = file_db.CreateFolder(dot_id, "a", 1000, 2000);
+  int64_t b_id = file_db.CreateFolder(a_id, "b", 1000, 2000);
+  int64_t c_id = file_db.CreateFolder(b_id, "c", 1000, 2000);
+  int64_t ab_id = file_db.CreateFolder(dot_id, "ab", 1000, 2000);
+  int64_t x_id = file_db.CreateFolder(dot_id, "x", 1000, 2000);
+  ASSERT_NE(c_id, -1);
+  ASSERT_NE(ab_id, -1);
+  ASSERT_EQ(file_db.GetFolderPath(c_id), "./a/b/c");
+
+  // Rename re-prefixes the whole subtree but not siblings sharing the prefix
+  ASSERT_TRUE(file_db.UpdateFolder(a_id, "renamed", 3000, "{}"));
+  ASSERT_EQ(file_db.GetFolderPath(a_id), "./renamed");
+  ASSERT_EQ(file_db.GetFolderPath(c_id), "./renamed/b/c");
+  ASSERT_EQ(file_db.GetFolderPath(ab_id), "./ab");
+  ASSERT_FALSE(file_db.GetFolderByPath("a/b").has_value());
+  auto by_path = file_db.GetFolderByPath("renamed/b/c");
+  ASSERT_TRUE(by_path.has_value());
+  ASSERT_EQ(by_path->id, c_id);
+
+  // Move carries descendants along
+  ASSERT_TRUE(file_db.MoveFolder(b_id, x_id));
+  ASSERT_EQ(file_db.GetFolderPath(b_id), "./x/b");
+  ASSERT_EQ(file_db.GetFolderPath(c_id), "./x/b/c");
+  by_path = file_db.GetFolderByPath("x/b/c");
+  ASSERT_TRUE(by_path.has_value());
+  ASSERT_EQ(by_path->id, c_id);
+  ASSERT_FALSE(file_db.GetFolderByPath("renamed/b").has_value());
+
+  // Upsert with a new parent recomputes the path
+  int64_t up_id = file_db.CreateOrUpdateFolder("up-uuid", c_id, "up", 1000, 2000, "{}");
+  ASSERT_EQ(file_db.GetFolderPath(up_id), "./x/b/c/up");
+
+  db_manager.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_filedb_folder_path_maintained passed" << std::endl;
+  return 0;
+}
+
+int test_db_manager_migrates_folder_path() {
+  std::cout << "  Running test_db_manager_migrates_folder_path..." << std::endl;
+
+  setup_test_db();
+
+  // Lay down a version 4 folders table (no path column) with a small tree
+  {
+    DbManager db_manager;
+    ASSERT_TRUE(db_manager.Open(test_db_path));
+    const char* v4 =
+        "CREATE TABLE folders (id INTEGER PRIMARY KEY AUTOINCREMENT, uuid TEXT NOT NULL UNIQUE, "
+        "parent_id INTEGER, name TEXT NOT NULL, created_utc INTEGER NOT NULL, "
+        "modified_utc INTEGER NOT NULL, metadata TEXT, "
+        "FOREIGN KEY (parent_id) REFERENCES folders(id) ON DELETE CASCADE);"
+        "INSERT INTO folders VALUES (1, 'r', NULL, '.', 0, 0, '');"
+        "INSERT INTO folders VALUES (2, 'n', 1, 'notes', 0, 0, '');"
+        "INSERT INTO folders VALUES (3, 'd', 2, 'deep', 0, 0, '');";
+    ASSERT_EQ(sqlite3_exec(db_manager.GetHandle(), v4, nullptr, nullptr, nullptr), SQLITE_OK);
+    db_manager.Close();
+  }
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+
+  FileDb file_db(db_manager.GetHandle());
+  ASSERT_EQ(file_db.GetFolderPath(3), "./notes/deep");
+  auto deep = file_db.GetFolderByPath("notes/deep");
+  ASSERT_TRUE(deep.has_value());
+  ASSERT_EQ(deep->uuid, "d");
+
+  // Triggers are live after migration
+  ASSERT_TRUE(file_db.UpdateFolder(2, "docs", 1, ""));
+  ASSERT_EQ(file_db.GetFolderPath(3), "./docs/deep");
+
+  // Re-initializing an up-to-date schema is a no-op
+  ASSERT_TRUE(db_manager.InitializeSchema());
+  ASSERT_EQ(file_db.GetFolderPath(3), "./docs/deep");
+
+  db_manager.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_db_manager_migrates_folder_path passed" << std::endl;
+  return 0;
+}
+
 // ============================================================================
 // TagDb Query Tests
 // ============================================================================
@@ -978,6 +1247,10 @@ int test_tagdb_find_files_by_tags_and() {
   auto results2 = tag_db.FindFilesByTagsAnd({"tag1", "tag2", "tag3"});
   ASSERT_EQ(results2.size(), 1);
   ASSERT_EQ(results2[0].file_name, "file3.md");
+  ASSERT_EQ(results2[0].tags.size(), 3);
+  ASSERT_EQ(results2[0].file_uuid, file_db.GetFile(file3_id)->uuid);
+  ASSERT_EQ(results2[0].folder_uuid, file_db.GetFolder(folder_id)->uuid);
+  ASSERT_EQ(results2[0].folder_path, "folder");
 
   // Find files with tag that no file has (empty result)
   auto results3 = tag_db.FindFilesByTagsAnd({"nonexistent"});
@@ -1280,6 +1553,673 @@ int test_filedb_set_file_tags_behavior() {
   return 0;
 }
 
+// ============================================================================
+// StatementCache Tests
+// ============================================================================
+
+int test_statement_cache_reuse() {
+  std::cout << "  Running test_statement_cache_reuse..." << std::endl;
+
+  setup_test_db();
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+
+  StatementCache cache(db_manager.GetHandle());
+  const char *sql = "SELECT COUNT(*) FROM folders WHERE name = ?;";
+
+  sqlite3_stmt *first = nullptr;
+  {
+    ScopedStatement stmt = cache.Acquire(sql);
+    ASSERT_TRUE(stmt);
+    first = stmt;
+    sqlite3_bind_text(stmt, 1, "a", -1, SQLITE_STATIC);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+  }
+  ASSERT_EQ(cache.GetMissCount(), 1u);
+
+  // Returned statements come back reset and unbound.
+  {
+    ScopedStatement stmt = cache.Acquire(sql);
+    ASSERT_TRUE(stmt.get() == first);
+    ASSERT_EQ(sqlite3_stmt_busy(stmt), 0);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+
+    // Nested use of the same SQL gets its own statement.
+    ScopedStatement nested = cache.Acquire(sql);
+    ASSERT_TRUE(nested);
+    ASSERT_TRUE(nested.get() != first);
+  }
+  ASSERT_EQ(cache.GetHitCount(), 1u);
+  ASSERT_EQ(cache.GetMissCount(), 2u);
+  ASSERT_EQ(cache.GetEntryCount(), 1u);
+
+  // Both copies are idle now, so two acquires are hits.
+  {
+    ScopedStatement a = cache.Acquire(sql);
+    ScopedStatement b = cache.Acquire(sql);
+    ASSERT_TRUE(a && b);
+  }
+  ASSERT_EQ(cache.GetHitCount(), 3u);
+
+  // Invalid SQL yields an empty handle.
+  {
+    ScopedStatement bad = cache.Acquire("SELECT FROM nowhere");
+    ASSERT_FALSE(bad);
+  }
+
+  db_manager.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_statement_cache_reuse passed" << std::endl;
+  return 0;
+}
+
+int test_statement_cache_clear_and_overflow() {
+  std::cout << "  Running test_statement_cache_clear_and_overflow..." << std::endl;
+
+  setup_test_db();
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+
+  StatementCache cache(db_manager.GetHandle());
+
+  // A handle borrowed across Clear() is finalized, not cached, on release.
+  {
+    ScopedStatement stmt = cache.Acquire("SELECT 1;");
+    ASSERT_TRUE(stmt);
+    cache.Clear();
+  }
+  {
+    ScopedStatement stmt = cache.Acquire("SELECT 1;");
+    ASSERT_TRUE(stmt);
+  }
+  ASSERT_EQ(cache.GetHitCount(), 0u);
+  ASSERT_EQ(cache.GetMissCount(), 2u);
+
+  // Distinct one-off SQL beyond kMaxEntries evicts idle slots, least
+  // recently used first, so a hot statement used in between stays a hit.
+  const char *hot_sql = "SELECT 1;";
+  for (size_t i = 0; i < 3 * StatementCache::kMaxEntries; ++i) {
+    std::string sql = "SELECT " + std::to_string(i + 2) + ";";
+    ScopedStatement stmt = cache.Acquire(sql);
+    ASSERT_TRUE(stmt);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    ASSERT_EQ(sqlite3_column_int64(stmt, 0), static_cast<int64_t>(i + 2));
+    if (i % 16 == 0) {
+      const uint64_t hits = cache.GetHitCount();
+      ScopedStatement hot = cache.Acquire(hot_sql);
+      ASSERT_TRUE(hot);
+      ASSERT_EQ(cache.GetHitCount(), hits + 1);
+    }
+  }
+  ASSERT_EQ(cache.GetEntryCount(), StatementCache::kMaxEntries);
+  ASSERT_TRUE(cache.GetEvictionCount() > 0);
+
+  // Slots with a borrowed statement are never evicted; once every slot is
+  // borrowed, new SQL is prepared uncached.
+  {
+    std::vector<ScopedStatement> borrowed;
+    for (size_t i = 0; i < StatementCache::kMaxEntries; ++i) {
+      borrowed.push_back(cache.Acquire("SELECT " + std::to_string(1000 + i) + ";"));
+      ASSERT_TRUE(borrowed.back());
+    }
+    const uint64_t evictions = cache.GetEvictionCount();
+    ScopedStatement extra = cache.Acquire("SELECT 'extra';");
+    ASSERT_TRUE(extra);
+    ASSERT_EQ(sqlite3_step(extra), SQLITE_ROW);
+    ASSERT_EQ(cache.GetEvictionCount(), evictions);
+    ASSERT_EQ(cache.GetEntryCount(), StatementCache::kMaxEntries);
+  }
+  {
+    const uint64_t hits = cache.GetHitCount();
+    ScopedStatement again = cache.Acquire("SELECT 1000;");
+    ASSERT_TRUE(again);
+    ASSERT_EQ(cache.GetHitCount(), hits + 1);
+  }
+
+  // Uncached statements never take a slot.
+  const uint64_t evictions = cache.GetEvictionCount();
+  {
+    ScopedStatement once = cache.PrepareUncached("SELECT 'once';");
+    ASSERT_TRUE(once);
+    ASSERT_EQ(sqlite3_step(once), SQLITE_ROW);
+  }
+  ASSERT_EQ(cache.GetEvictionCount(), evictions);
+
+  // Statements prepared through the manager's cache survive a rebuild.
+  FileDb file_db(db_manager.GetHandle(), db_manager.GetStatementCache());
+  int64_t folder_id = file_db.CreateFolder(-1, "folder", 1000, 2000);
+  ASSERT_NE(folder_id, -1);
+  ASSERT_TRUE(file_db.GetFolder(folder_id).has_value());
+  ASSERT_TRUE(db_manager.RebuildDatabase());
+  ASSERT_FALSE(file_db.GetFolder(folder_id).has_value());
+  folder_id = file_db.CreateFolder(-1, "folder", 1000, 2000);
+  ASSERT_NE(folder_id, -1);
+  const uint64_t hits = db_manager.GetStatementCache()->GetHitCount();
+  ASSERT_TRUE(file_db.GetFolder(folder_id).has_value());
+  ASSERT_EQ(db_manager.GetStatementCache()->GetHitCount(), hits + 1);
+
+  db_manager.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_statement_cache_clear_and_overflow passed" << std::endl;
+  return 0;
+}
+
+// ============================================================================
+// Tag Index Tests
+// ============================================================================
+
+int test_compressed_bitmap_ops() {
+  std::cout << "  Running test_compressed_bitmap_ops..." << std::endl;
+
+  // Sparse values across several high-16-bit keys plus one dense run that
+  // forces a bitmap container.
+  CompressedBitmap a, b;
+  std::set<uint32_t> ref_a, ref_b;
+  uint32_t seed = 12345;
+  auto next = [&seed]() {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+  };
+  for (int i = 0; i < 3000; ++i) {
+    uint32_t value = next() % (4u << 16);
+    ASSERT_EQ(a.Add(value), ref_a.insert(value).second);
+  }
+  for (uint32_t value = 70000; value < 70000 + 9000; ++value) {
+    a.Add(value);
+    ref_a.insert(value);
+  }
+  for (int i = 0; i < 6000; ++i) {
+    uint32_t value = 65536 + next() % 20000;
+    b.Add(value);
+    ref_b.insert(value);
+  }
+  ASSERT_EQ(a.Cardinality(), ref_a.size());
+  ASSERT_EQ(b.Cardinality(), ref_b.size());
+  ASSERT_TRUE(a.ToVector() == std::vector<uint32_t>(ref_a.begin(), ref_a.end()));
+  ASSERT_TRUE(a.Contains(70000));
+  ASSERT_FALSE(a.Contains(70000 + 9000));
+
+  auto to_vector = [](const std::set<uint32_t> &set) {
+    return std::vector<uint32_t>(set.begin(), set.end());
+  };
+
+  std::set<uint32_t> ref;
+  CompressedBitmap result = a;
+  result &= b;
+  std::set_intersection(ref_a.begin(), ref_a.end(), ref_b.begin(), ref_b.end(),
+                        std::inserter(ref, ref.end()));
+  ASSERT_TRUE(result.ToVector() == to_vector(ref));
+
+  ref.clear();
+  result = a;
+  result |= b;
+  std::set_union(ref_a.begin(), ref_a.end(), ref_b.begin(), ref_b.end(),
+                 std::inserter(ref, ref.end()));
+  ASSERT_TRUE(result.ToVector() == to_vector(ref));
+  ASSERT_EQ(result.Cardinality(), ref.size());
+
+  ref.clear();
+  result = a;
+  result -= b;
+  std::set_difference(ref_a.begin(), ref_a.end(), ref_b.begin(), ref_b.end(),
+                      std::inserter(ref, ref.end()));
+  ASSERT_TRUE(result.ToVector() == to_vector(ref));
+
+  // Removing most of the dense run converts it back to an array container;
+  // the same set built directly compares equal.
+  for (uint32_t value = 70000; value < 70000 + 8000; ++value) {
+    ASSERT_TRUE(a.Remove(value));
+    ref_a.erase(value);
+  }
+  ASSERT_FALSE(a.Remove(70000));
+  CompressedBitmap rebuilt;
+  for (auto it = ref_a.rbegin(); it != ref_a.rend(); ++it) {
+    rebuilt.Add(*it);
+  }
+  ASSERT_TRUE(rebuilt == a);
+  ASSERT_TRUE(a.ToVector() == to_vector(ref_a));
+
+  result = a;
+  result -= a;
+  ASSERT_TRUE(result.IsEmpty());
+
+  std::cout << "  ✓ test_compressed_bitmap_ops passed" << std::endl;
+  return 0;
+}
+
+int test_tagdb_find_files_by_tag_expression() {
+  std::cout << "  Running test_tagdb_find_files_by_tag_expression..." << std::endl;
+
+  setup_test_db();
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+
+  TagDb tag_db(db_manager.GetHandle());
+  FileDb file_db(db_manager.GetHandle());
+
+  int64_t folder_id = file_db.CreateFolder(-1, "folder", 1000, 2000);
+  ASSERT_NE(folder_id, -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "a.md", 0, 0, {"work", "urgent"}), -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "b.md", 0, 0, {"work"}), -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "c.md", 0, 0, {"home", "urgent"}), -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "d.md", 0, 0, {}), -1);
+
+  auto names = [](const std::vector<TagQueryResult> &results) {
+    std::vector<std::string> out;
+    for (const auto &result : results) {
+      out.push_back(result.file_name);
+    }
+    return out;
+  };
+
+  using Names = std::vector<std::string>;
+  ASSERT_TRUE(names(tag_db.FindFilesByTagExpression({"work"}, {}, {"urgent"})) == Names{"b.md"});
+  ASSERT_TRUE(names(tag_db.FindFilesByTagExpression({"urgent"}, {"work", "home"}, {})) ==
+              (Names{"a.md", "c.md"}));
+  ASSERT_TRUE(names(tag_db.FindFilesByTagExpression({}, {}, {"work"})) == (Names{"c.md", "d.md"}));
+  ASSERT_TRUE(names(tag_db.FindFilesByTagExpression({"work", "urgent"}, {}, {})) ==
+              Names{"a.md"});
+  ASSERT_TRUE(tag_db.FindFilesByTagExpression({"missing"}, {}, {}).empty());
+  ASSERT_TRUE(tag_db.FindFilesByTagExpression({"work", "missing"}, {}, {}).empty());
+  ASSERT_TRUE(tag_db.FindFilesByTagExpression({}, {}, {}).empty());
+  // Repeated all-of names count once.
+  ASSERT_TRUE(names(tag_db.FindFilesByTagExpression({"work", "work"}, {}, {})) ==
+              (Names{"a.md", "b.md"}));
+  ASSERT_TRUE(names(tag_db.FindFilesByTagsAnd({"urgent", "work", "urgent"})) == Names{"a.md"});
+
+  // Full tag lists come back even for tags outside the expression.
+  auto results = tag_db.FindFilesByTagExpression({}, {"home"}, {});
+  ASSERT_EQ(results.size(), 1);
+  ASSERT_EQ(results[0].tags.size(), 2);
+
+  // Lists are padded, so expressions naming different numbers of tags share
+  // one cached statement.
+  StatementCache cache(db_manager.GetHandle());
+  TagDb cached_tag_db(db_manager.GetHandle(), &cache);
+  Names all_of = {"work"};
+  Names any_of = {"urgent"};
+  Names none_of = {"home"};
+  for (int i = 0; i < 12; ++i) {
+    ASSERT_TRUE(names(cached_tag_db.FindFilesByTagExpression(all_of, any_of, none_of)) ==
+                (i == 0 ? Names{"a.md"} : Names{}));
+    all_of.push_back("extra" + std::to_string(i));
+    any_of.push_back("extra" + std::to_string(i));
+    none_of.push_back("extra" + std::to_string(i));
+  }
+  ASSERT_EQ(cache.GetEntryCount(), 1u);
+
+  db_manager.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_tagdb_find_files_by_tag_expression passed" << std::endl;
+  return 0;
+}
+
+int test_tag_bitmap_index() {
+  std::cout << "  Running test_tag_bitmap_index..." << std::endl;
+
+  setup_test_db();
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+
+  TagDb tag_db(db_manager.GetHandle());
+  FileDb file_db(db_manager.GetHandle());
+
+  int64_t folder_id = file_db.CreateFolder(-1, "folder", 1000, 2000);
+  ASSERT_NE(folder_id, -1);
+  const std::vector<std::string> pool = {"t0", "t1", "t2", "t3"};
+  std::vector<std::string> uuids;
+  for (int i = 0; i < 200; ++i) {
+    std::vector<std::string> tags;
+    for (size_t k = 0; k < pool.size(); ++k) {
+      if (i % (k + 2) == 0) {
+        tags.push_back(pool[k]);
+      }
+    }
+    int64_t id = file_db.CreateFile(folder_id, "f" + std::to_string(i) + ".md", 0, 0, tags);
+    ASSERT_NE(id, -1);
+    uuids.push_back(file_db.GetFile(id)->uuid);
+  }
+
+  TagBitmapIndex index;
+  ASSERT_FALSE(index.Match({"t0"}, {}, {}).has_value());
+  ASSERT_TRUE(index.Load(tag_db));
+  ASSERT_EQ(index.GetFileCount(), 200);
+  ASSERT_EQ(index.GetTagCount(), 4);
+
+  auto sorted = [](std::vector<std::string> values) {
+    std::sort(values.begin(), values.end());
+    return values;
+  };
+  auto sql_uuids = [&](const std::vector<std::string> &all_of,
+                       const std::vector<std::string> &any_of,
+                       const std::vector<std::string> &none_of) {
+    std::vector<std::string> out;
+    for (const auto &result : tag_db.FindFilesByTagExpression(all_of, any_of, none_of)) {
+      out.push_back(result.file_uuid);
+    }
+    return sorted(out);
+  };
+  auto check = [&](const std::vector<std::string> &all_of,
+                   const std::vector<std::string> &any_of,
+                   const std::vector<std::string> &none_of) {
+    auto matched = index.Match(all_of, any_of, none_of);
+    return matched.has_value() && sorted(*matched) == sql_uuids(all_of, any_of, none_of);
+  };
+
+  ASSERT_TRUE(check({"t0", "t1"}, {}, {}));
+  ASSERT_TRUE(check({}, {"t2", "t3"}, {}));
+  ASSERT_TRUE(check({"t0"}, {}, {"t1"}));
+  ASSERT_TRUE(check({"t0"}, {"t2", "t3"}, {"t1"}));
+  ASSERT_TRUE(check({}, {}, {"t0"}));
+  ASSERT_TRUE(check({"t0", "missing"}, {}, {}));
+  ASSERT_TRUE(index.Match({}, {}, {})->empty());
+
+  // Mutations mirror the equivalent FileDb writes.
+  int64_t id0 = file_db.GetFileByUuid(uuids[0])->id;
+  ASSERT_TRUE(file_db.SetFileTags(id0, {"t3", "new"}));
+  index.SetFileTags(uuids[0], {"t3", "new"});
+  int64_t id1 = file_db.GetFileByUuid(uuids[1])->id;
+  ASSERT_TRUE(file_db.AddTagToFile(id1, "t0"));
+  index.AddFileTag(uuids[1], "t0");
+  int64_t id2 = file_db.GetFileByUuid(uuids[2])->id;
+  ASSERT_TRUE(file_db.DeleteFile(id2));
+  index.RemoveFile(uuids[2]);
+  ASSERT_EQ(index.GetFileCount(), 199);
+
+  ASSERT_TRUE(check({"t0", "t1"}, {}, {}));
+  ASSERT_TRUE(check({"new"}, {}, {}));
+  ASSERT_TRUE(check({}, {}, {"t0", "t3"}));
+  ASSERT_TRUE(check({"t3"}, {"t0", "new"}, {}));
+
+  // A freed ordinal is reused by the next file.
+  int64_t id = file_db.CreateFile(folder_id, "late.md", 0, 0, {"t1"});
+  ASSERT_NE(id, -1);
+  index.SetFileTags(file_db.GetFile(id)->uuid, {"t1"});
+  ASSERT_TRUE(check({"t1"}, {}, {"t0"}));
+  ASSERT_TRUE(check({}, {}, {"t1"}));
+
+  // Readers on other connections ask for committed data only.
+  index.SetPendingWrites(true);
+  ASSERT_FALSE(index.Match({"t1"}, {}, {}, /*committed_only=*/true).has_value());
+  ASSERT_FALSE(index.MatchGroups({{"t1"}}, {}, {}, /*committed_only=*/true).has_value());
+  ASSERT_TRUE(index.Match({"t1"}, {}, {}).has_value());
+  index.SetPendingWrites(false);
+  ASSERT_TRUE(index.Match({"t1"}, {}, {}, /*committed_only=*/true).has_value());
+
+  index.Invalidate();
+  ASSERT_FALSE(index.IsLoaded());
+  ASSERT_FALSE(index.Match({"t1"}, {}, {}).has_value());
+
+  db_manager.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_tag_bitmap_index passed" << std::endl;
+  return 0;
+}
+
+int test_tagdb_tag_subtree_queries() {
+  std::cout << "  Running test_tagdb_tag_subtree_queries..." << std::endl;
+
+  setup_test_db();
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+
+  TagDb tag_db(db_manager.GetHandle());
+  FileDb file_db(db_manager.GetHandle());
+
+  // project -> {alpha, beta -> beta1}; other is a separate root.
+  int64_t project = tag_db.CreateOrUpdateTag("project", -1, "{}");
+  ASSERT_NE(project, -1);
+  ASSERT_NE(tag_db.CreateOrUpdateTag("alpha", project, "{}"), -1);
+  int64_t beta = tag_db.CreateOrUpdateTag("beta", project, "{}");
+  ASSERT_NE(beta, -1);
+  ASSERT_NE(tag_db.CreateOrUpdateTag("beta1", beta, "{}"), -1);
+  ASSERT_NE(tag_db.CreateOrUpdateTag("other", -1, "{}"), -1);
+
+  int64_t folder_id = file_db.CreateFolder(-1, "folder", 1000, 2000);
+  ASSERT_NE(folder_id, -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "a.md", 0, 0, {"alpha"}), -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "b.md", 0, 0, {"beta1"}), -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "c.md", 0, 0, {"project", "alpha"}), -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "d.md", 0, 0, {"other"}), -1);
+  ASSERT_NE(file_db.CreateFile(folder_id, "e.md", 0, 0, {}), -1);
+
+  using Names = std::vector<std::string>;
+  auto sorted = [](Names values) {
+    std::sort(values.begin(), values.end());
+    return values;
+  };
+
+  auto subtrees = tag_db.ExpandTagSubtrees({"project", "missing", "beta"});
+  ASSERT_EQ(subtrees.size(), 3);
+  ASSERT_EQ(subtrees[0].front(), "project");
+  ASSERT_TRUE(sorted(subtrees[0]) == (Names{"alpha", "beta", "beta1", "project"}));
+  ASSERT_TRUE(subtrees[1] == Names{"missing"});
+  ASSERT_TRUE(sorted(subtrees[2]) == (Names{"beta", "beta1"}));
+
+  auto names = [&](const Names &all_of, const Names &any_of, const Names &none_of) {
+    Names out;
+    for (const auto &result : tag_db.FindFilesByTagExpression(all_of, any_of, none_of, true)) {
+      out.push_back(result.file_name);
+    }
+    return out;
+  };
+  ASSERT_TRUE(names({"project"}, {}, {}) == (Names{"a.md", "b.md", "c.md"}));
+  ASSERT_TRUE(names({"beta"}, {}, {}) == Names{"b.md"});
+  ASSERT_TRUE(names({"project"}, {}, {"alpha"}) == Names{"b.md"});
+  ASSERT_TRUE(names({}, {"beta", "other"}, {}) == (Names{"b.md", "d.md"}));
+  ASSERT_TRUE(names({}, {}, {"project"}) == (Names{"d.md", "e.md"}));
+  // Without descendants only the exact tag counts.
+  ASSERT_EQ(tag_db.FindFilesByTagExpression({"project"}, {}, {}).size(), 1);
+
+  // The index matches the same sets once the caller expands the tags.
+  TagBitmapIndex index;
+  ASSERT_TRUE(index.Load(tag_db));
+  auto index_names = [&](const Names &all_of, const Names &any_of, const Names &none_of) {
+    auto flatten = [](const std::vector<Names> &groups) {
+      Names out;
+      for (const auto &group : groups) {
+        out.insert(out.end(), group.begin(), group.end());
+      }
+      return out;
+    };
+    Names out;
+    auto matched = index.MatchGroups(tag_db.ExpandTagSubtrees(all_of),
+                                     flatten(tag_db.ExpandTagSubtrees(any_of)),
+                                     flatten(tag_db.ExpandTagSubtrees(none_of)));
+    for (const auto &result : tag_db.GetFilesWithTagsByUuids(*matched)) {
+      out.push_back(result.file_name);
+    }
+    return out;
+  };
+  for (const auto &expression : std::vector<std::vector<Names>>{{{"project"}, {}, {}},
+                                                                {{"project", "beta"}, {}, {}},
+                                                                {{"project"}, {}, {"alpha"}},
+                                                                {{}, {"beta", "other"}, {}},
+                                                                {{}, {}, {"project"}},
+                                                                {{"missing"}, {}, {}}}) {
+    ASSERT_TRUE(index_names(expression[0], expression[1], expression[2]) ==
+                names(expression[0], expression[1], expression[2]));
+  }
+
+  // Rolled-up counts: c.md carries project and alpha but counts once.
+  auto counts = tag_db.CountFilesByTagSubtree();
+  ASSERT_EQ(counts.size(), 5);
+  const std::vector<std::tuple<std::string, std::string, int, int>> expected = {
+      {"alpha", "project", 2, 2}, {"beta", "project", 0, 1}, {"beta1", "beta", 1, 1},
+      {"other", "", 1, 1},        {"project", "", 1, 3}};
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(counts[i].name, std::get<0>(expected[i]));
+    ASSERT_EQ(counts[i].parent_name, std::get<1>(expected[i]));
+    ASSERT_EQ(counts[i].file_count, std::get<2>(expected[i]));
+    ASSERT_EQ(counts[i].subtree_file_count, std::get<3>(expected[i]));
+  }
+
+  db_manager.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_tagdb_tag_subtree_queries passed" << std::endl;
+  return 0;
+}
+
+int test_filedb_metadata_queries() {
+  std::cout << "  Running test_filedb_metadata_queries..." << std::endl;
+
+  setup_test_db();
+
+  DbManager db_manager;
+  ASSERT_TRUE(db_manager.Open(test_db_path));
+  ASSERT_TRUE(db_manager.InitializeSchema());
+  sqlite3 *db = db_manager.GetHandle();
+  FileDb file_db(db, db_manager.GetStatementCache());
+
+  int64_t folder_id = file_db.CreateOrUpdateFolder("folder-uuid", -1, "folder", 0, 0,
+                                                   R"({"status": "draft"})");
+  ASSERT_NE(folder_id, -1);
+  const std::vector<std::pair<std::string, std::string>> files = {
+      {"a.md", R"({"status": "draft", "priority": 2, "pinned": true,
+                  "review": {"state": "open", "round": 1}})"},
+      {"b.md", R"({"status": "done", "priority": 5, "pinned": false})"},
+      {"c.md", R"({"status": "draft", "priority": 2.5, "due": null})"},
+      {"d.md", R"({"status": 1, "priority": "high", "review": "none"})"},
+      {"e.md", "not json"},
+      {"f.md", "{}"},
+  };
+  for (const auto &[name, metadata] : files) {
+    ASSERT_NE(file_db.CreateOrUpdateFile(name + "-uuid", folder_id, name, 0, 0, metadata), -1);
+  }
+
+  using Names = std::vector<std::string>;
+  auto parse_filter = [](const char *json) {
+    vxcore::MetadataFilter filter;
+    std::string error;
+    if (!vxcore::MetadataFilter::FromJson(nlohmann::json::parse(json), filter, error)) {
+      std::cerr << "bad filter " << json << ": " << error << std::endl;
+    }
+    return filter;
+  };
+  auto sql_names = [&](const vxcore::MetadataFilter &filter) {
+    Names out;
+    for (const auto &match : file_db.FindFilesByMetadata(filter)) {
+      out.push_back(match.path.substr(match.path.rfind('/') + 1));
+    }
+    return out;
+  };
+  auto memory_names = [&](const vxcore::MetadataFilter &filter) {
+    Names out;
+    for (const auto &[name, metadata] : files) {
+      auto json = nlohmann::json::parse(metadata, nullptr, false);
+      if (filter.Matches(json.is_discarded() ? nlohmann::json::object() : json)) {
+        out.push_back(name);
+      }
+    }
+    return out;
+  };
+
+  // SQL and in-memory evaluation agree, with and without the indexes.
+  const char *filters[] = {
+      R"({"status": "draft"})",
+      R"({"status": 1})",
+      R"({"pinned": true})",
+      R"({"pinned": false})",
+      R"({"due": null})",
+      R"([{"key": "status", "op": "ne", "value": "draft"}])",
+      R"([{"key": "priority", "op": "ge", "value": 2.5}])",
+      R"([{"key": "priority", "op": "lt", "value": 5}])",
+      R"([{"key": "priority", "op": "gt", "value": "a"}])",
+      R"([{"key": "review.state", "op": "eq", "value": "open"}])",
+      R"([{"key": "review.round", "op": "le", "value": 1}])",
+      R"([{"key": "review", "op": "exists"}])",
+      R"([{"key": "due", "op": "exists"}, {"key": "status", "op": "eq", "value": "draft"}])",
+      R"([{"key": "status", "op": "missing"}])",
+      R"({})",
+  };
+  for (int round = 0; round < 2; ++round) {
+    for (const char *json : filters) {
+      auto filter = parse_filter(json);
+      ASSERT_TRUE(sql_names(filter) == memory_names(filter));
+    }
+    ASSERT_TRUE(file_db.CreateMetadataKeyIndex("status"));
+    ASSERT_TRUE(file_db.CreateMetadataKeyIndex("priority"));
+    ASSERT_TRUE(file_db.CreateMetadataKeyIndex("review.state"));
+  }
+  ASSERT_TRUE(sql_names(parse_filter(R"({"status": "draft"})")) == (Names{"a.md", "c.md"}));
+  ASSERT_TRUE(sql_names(parse_filter(R"([{"key": "priority", "op": "lt", "value": 5}])")) ==
+              (Names{"a.md", "c.md"}));
+
+  auto a_match = file_db.FindFilesByMetadata(parse_filter(R"({"pinned": true})"));
+  ASSERT_EQ(a_match.size(), 1);
+  ASSERT_EQ(a_match[0].uuid, "a.md-uuid");
+  ASSERT_EQ(a_match[0].path, file_db.GetFolderPath(folder_id) + "/a.md");
+  ASSERT_EQ(file_db.FindFilesByMetadata(vxcore::MetadataFilter(), 2).size(), 2);
+
+  auto folders = file_db.FindFoldersByMetadata(parse_filter(R"({"status": "draft"})"));
+  ASSERT_EQ(folders.size(), 1);
+  ASSERT_EQ(folders[0].uuid, "folder-uuid");
+  ASSERT_EQ(folders[0].path, file_db.GetFolderPath(folder_id));
+
+  // The cached statement of an equality query is planned onto the index.
+  std::string plan;
+  for (sqlite3_stmt *stmt = sqlite3_next_stmt(db, nullptr); stmt;
+       stmt = sqlite3_next_stmt(db, stmt)) {
+    const std::string sql = sqlite3_sql(stmt);
+    if (sql.find("FROM files f") == std::string::npos ||
+        sql.find("'$.\"status\"') = ?") == std::string::npos ||
+        sql.find("priority") != std::string::npos) {
+      continue;
+    }
+    sqlite3_stmt *explain = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(db, ("EXPLAIN QUERY PLAN " + sql).c_str(), -1, &explain, nullptr),
+              SQLITE_OK);
+    while (sqlite3_step(explain) == SQLITE_ROW) {
+      plan += reinterpret_cast<const char *>(sqlite3_column_text(explain, 3));
+      plan += "\n";
+    }
+    sqlite3_finalize(explain);
+    break;
+  }
+  ASSERT_TRUE(plan.find("USING INDEX idx_files_meta_") != std::string::npos);
+
+  // Unindexed keys bind their path: one statement text serves them all.
+  StatementCache *cache = db_manager.GetStatementCache();
+  ASSERT_EQ(file_db.FindFilesByMetadata(parse_filter(R"({"key-0": "x"})")).size(), 0);
+  const size_t entries = cache->GetEntryCount();
+  for (int i = 1; i < 20; ++i) {
+    const std::string key = "key-" + std::to_string(i);
+    ASSERT_EQ(file_db.FindFilesByMetadata(parse_filter(("{\"" + key + "\": \"x\"}").c_str()))
+                  .size(),
+              0);
+  }
+  ASSERT_EQ(cache->GetEntryCount(), entries);
+  // So does every limit.
+  ASSERT_EQ(file_db.FindFilesByMetadata(vxcore::MetadataFilter(), 3).size(), 3);
+  ASSERT_EQ(file_db.FindFilesByMetadata(vxcore::MetadataFilter(), 4).size(), 4);
+  ASSERT_EQ(cache->GetEntryCount(), entries);
+
+  // Malformed metadata still writes with the indexes in place.
+  ASSERT_NE(file_db.CreateOrUpdateFile("g.md-uuid", folder_id, "g.md", 0, 0, "{oops"), -1);
+
+  ASSERT_TRUE(file_db.ListMetadataKeyIndexes() == (Names{"priority", "review.state", "status"}));
+  ASSERT_FALSE(file_db.CreateMetadataKeyIndex("bad\"key"));
+  ASSERT_FALSE(file_db.CreateMetadataKeyIndex("a..b"));
+  ASSERT_TRUE(file_db.DropMetadataKeyIndex("priority"));
+  ASSERT_TRUE(file_db.DropMetadataKeyIndex("never-indexed"));
+  ASSERT_TRUE(file_db.ListMetadataKeyIndexes() == (Names{"review.state", "status"}));
+
+  db_manager.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_filedb_metadata_queries passed" << std::endl;
+  return 0;
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -1294,6 +2234,12 @@ int main() {
   RUN_TEST(test_db_manager_transactions);
   RUN_TEST(test_db_manager_rebuild);
 
+  // Tuning and maintenance tests
+  RUN_TEST(test_db_tuning_profiles);
+  RUN_TEST(test_db_manager_applies_tuning);
+  RUN_TEST(test_db_maintenance_checkpoint);
+  RUN_TEST(test_db_maintenance_scheduler);
+
   // FileDb - Folder tests
   RUN_TEST(test_filedb_create_folder);
   RUN_TEST(test_filedb_create_or_update_folder);
@@ -1321,12 +2267,21 @@ int main() {
   RUN_TEST(test_filedb_get_folder_by_path_not_found);
   RUN_TEST(test_filedb_get_folder_by_path_edge_cases);
   RUN_TEST(test_filedb_get_folder_by_path_with_dot_root);
+  RUN_TEST(test_filedb_folder_path_maintained);
+  RUN_TEST(test_db_manager_migrates_folder_path);
 
   // TagDb - Query tests
   RUN_TEST(test_tagdb_find_files_by_tags_and);
   RUN_TEST(test_tagdb_find_files_by_tags_or);
   RUN_TEST(test_tagdb_count_files_by_tag);
 
+  // Tag index tests
+  RUN_TEST(test_compressed_bitmap_ops);
+  RUN_TEST(test_tagdb_find_files_by_tag_expression);
+  RUN_TEST(test_tag_bitmap_index);
+  RUN_TEST(test_tagdb_tag_subtree_queries);
+  RUN_TEST(test_filedb_metadata_queries);
+
   // TagDb - CRUD tests
   RUN_TEST(test_tagdb_get_tag_by_id);
   RUN_TEST(test_tagdb_delete_tag);
@@ -1335,6 +2290,10 @@ int main() {
   RUN_TEST(test_filedb_move_folder_deep_cycle_detection);
   RUN_TEST(test_filedb_set_file_tags_behavior);
 
+  // StatementCache tests
+  RUN_TEST(test_statement_cache_reuse);
+  RUN_TEST(test_statement_cache_clear_and_overflow);
+
   std::cout << "✓ All DB layer tests passed" << std::endl;
   return 0;
 }
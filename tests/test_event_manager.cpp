@@ -156,6 +156,233 @@ int test_emit_async_cross_thread() {
   return 0;
 }
 
+int test_has_listeners() {
+  std::cout << "  Running test_has_listeners..." << std::endl;
+  vxcore::EventManager em;
+  ASSERT_FALSE(em.HasListeners("ev"));
+  auto id = em.Subscribe("ev", [](const std::string &, const nlohmann::json &) {});
+  ASSERT_TRUE(em.HasListeners("ev"));
+  ASSERT_FALSE(em.HasListeners("other"));
+  em.Unsubscribe(id);
+  ASSERT_FALSE(em.HasListeners("ev"));
+  std::cout << "  ✓ test_has_listeners passed" << std::endl;
+  return 0;
+}
+
+int test_subscribe_unsubscribe_during_emit() {
+  std::cout << "  Running test_subscribe_unsubscribe_during_emit..." << std::endl;
+  vxcore::EventManager em;
+  int first_count = 0;
+  int second_count = 0;
+  int late_count = 0;
+  vxcore::EventManager::ListenerId first_id = 0;
+  vxcore::EventManager::ListenerId second_id = 0;
+  first_id = em.Subscribe("ev", [&](const std::string &, const nlohmann::json &) {
+    first_count++;
+    // Mutations during dispatch publish a new snapshot; the in-flight Emit
+    // keeps iterating the old one.
+    em.Unsubscribe(first_id);
+    em.Unsubscribe(second_id);
+    em.Subscribe("ev", [&](const std::string &, const nlohmann::json &) { late_count++; });
+  });
+  second_id = em.Subscribe("ev", [&](const std::string &, const nlohmann::json &) {
+    second_count++;
+  });
+
+  em.Emit("ev", {});
+  ASSERT_EQ(first_count, 1);
+  ASSERT_EQ(second_count, 1);
+  ASSERT_EQ(late_count, 0);
+
+  em.Emit("ev", {});
+  ASSERT_EQ(first_count, 1);
+  ASSERT_EQ(second_count, 1);
+  ASSERT_EQ(late_count, 1);
+  std::cout << "  ✓ test_subscribe_unsubscribe_during_emit passed" << std::endl;
+  return 0;
+}
+
+int test_concurrent_emit_and_subscribe() {
+  std::cout << "  Running test_concurrent_emit_and_subscribe..." << std::endl;
+  vxcore::EventManager em;
+  std::atomic<int> count{0};
+  em.Subscribe("ev", [&](const std::string &, const nlohmann::json &) { count.fetch_add(1); });
+
+  std::atomic<bool> stop{false};
+  std::thread churn([&] {
+    while (!stop.load()) {
+      auto id = em.Subscribe("ev", [](const std::string &, const nlohmann::json &) {});
+      em.Unsubscribe(id);
+    }
+  });
+
+  const nlohmann::json payload = {{"path", "a.md"}};
+  std::vector<std::thread> emitters;
+  for (int t = 0; t < 4; ++t) {
+    emitters.emplace_back([&] {
+      for (int i = 0; i < 1000; ++i) em.Emit("ev", payload);
+    });
+  }
+  for (auto &t : emitters) t.join();
+  stop.store(true);
+  churn.join();
+
+  ASSERT_EQ(count.load(), 4000);
+  std::cout << "  ✓ test_concurrent_emit_and_subscribe passed" << std::endl;
+  return 0;
+}
+
+int test_batch_coalesces_for_opted_in_listeners() {
+  std::cout << "  Running test_batch_coalesces_for_opted_in_listeners..." << std::endl;
+  vxcore::EventManager em;
+  int plain_count = 0;
+  std::vector<std::pair<std::string, nlohmann::json>> coalesced;
+  em.Subscribe("folder.config_changed",
+               [&](const std::string &, const nlohmann::json &) { plain_count++; });
+  em.SubscribeCoalesced({"folder.config_changed", "file.created"},
+                        [&](const std::string &name, const nlohmann::json &data) {
+                          coalesced.emplace_back(name, data);
+                        });
+
+  em.BeginBatch();
+  em.BeginBatch();  // nested scopes deliver only on the outermost EndBatch
+  em.Emit("folder.config_changed", {{"notebookId", "nb"}, {"path", "a"}});
+  em.Emit("folder.config_changed", {{"notebookId", "nb"}, {"path", "a"}});
+  em.Emit("folder.config_changed", {{"notebookId", "nb"}, {"path", "b"}});
+  em.Emit("file.created", {{"notebookId", "nb"}, {"path", "a/x.md"}});
+  em.EndBatch();
+  ASSERT_EQ(plain_count, 3);
+  ASSERT_TRUE(coalesced.empty());
+  em.EndBatch();
+
+  ASSERT_EQ(coalesced.size(), 1u);
+  ASSERT_EQ(coalesced[0].first, "events.batched");
+  const auto &payload = coalesced[0].second;
+  ASSERT_EQ(payload["events"].size(), 3u);
+  ASSERT_EQ(payload["events"][0]["event"], "folder.config_changed");
+  ASSERT_EQ(payload["events"][0]["count"], 2);
+  ASSERT_EQ(payload["events"][2]["event"], "file.created");
+  ASSERT_EQ(payload["paths"], nlohmann::json::array({"a", "b", "a/x.md"}));
+
+  // Outside a batch a coalescing listener behaves like a plain one.
+  coalesced.clear();
+  em.Emit("file.created", {{"notebookId", "nb"}, {"path", "y.md"}});
+  ASSERT_EQ(coalesced.size(), 1u);
+  ASSERT_EQ(coalesced[0].first, "file.created");
+  std::cout << "  ✓ test_batch_coalesces_for_opted_in_listeners passed" << std::endl;
+  return 0;
+}
+
+int test_batch_is_per_thread() {
+  std::cout << "  Running test_batch_is_per_thread..." << std::endl;
+  vxcore::EventManager em;
+  std::atomic<int> direct{0};
+  std::atomic<int> batched{0};
+  em.SubscribeCoalesced({"ev"}, [&](const std::string &name, const nlohmann::json &) {
+    if (name == "events.batched") {
+      batched.fetch_add(1);
+    } else {
+      direct.fetch_add(1);
+    }
+  });
+
+  vxcore::EventBatchScope scope(&em);
+  // Another thread without its own scope is not captured by ours.
+  std::thread other([&] { em.Emit("ev", {{"path", "p"}}); });
+  other.join();
+  ASSERT_EQ(direct.load(), 1);
+  ASSERT_EQ(batched.load(), 0);
+  std::cout << "  ✓ test_batch_is_per_thread passed" << std::endl;
+  return 0;
+}
+
+int test_unsubscribe_coalesced_listener() {
+  std::cout << "  Running test_unsubscribe_coalesced_listener..." << std::endl;
+  vxcore::EventManager em;
+  int count = 0;
+  auto id = em.SubscribeCoalesced({"a", "b"},
+                                  [&](const std::string &, const nlohmann::json &) { count++; });
+  ASSERT_TRUE(em.HasListeners("a"));
+  ASSERT_TRUE(em.HasListeners("b"));
+  em.Unsubscribe(id);
+  ASSERT_FALSE(em.HasListeners("a"));
+  ASSERT_FALSE(em.HasListeners("b"));
+  em.Emit("a", {});
+  ASSERT_EQ(count, 0);
+  std::cout << "  ✓ test_unsubscribe_coalesced_listener passed" << std::endl;
+  return 0;
+}
+
+namespace {
+// NodeEvent look-alike that counts JSON materializations.
+struct CountingNodeEvent : vxcore::events::NodeEvent {
+  static int to_json_calls;
+  nlohmann::json ToJson() const {
+    ++to_json_calls;
+    return NodeEvent::ToJson();
+  }
+};
+int CountingNodeEvent::to_json_calls = 0;
+}  // namespace
+
+int test_typed_emit_reaches_typed_and_json_listeners() {
+  std::cout << "  Running test_typed_emit_reaches_typed_and_json_listeners..." << std::endl;
+  vxcore::EventManager em;
+  std::string typed_path;
+  std::string typed_name;
+  em.SubscribeTyped<vxcore::events::NodeEvent>(
+      "file.saved", [&](std::string_view name, const vxcore::events::NodeEvent &e) {
+        typed_name = std::string(name);
+        typed_path = std::string(e.path);
+      });
+
+  // Only typed listeners: no JSON is built.
+  CountingNodeEvent::to_json_calls = 0;
+  CountingNodeEvent event;
+  event.notebook_id = "nb";
+  event.path = "a.md";
+  em.EmitTyped("file.saved", event);
+  ASSERT_EQ(typed_name, "file.saved");
+  ASSERT_EQ(typed_path, "a.md");
+  ASSERT_EQ(CountingNodeEvent::to_json_calls, 0);
+
+  // A JSON listener forces exactly one materialization per emit.
+  nlohmann::json received;
+  int json_calls = 0;
+  em.Subscribe("file.saved", [&](const std::string &, const nlohmann::json &data) {
+    received = data;
+    json_calls++;
+  });
+  em.Subscribe("file.saved", [&](const std::string &, const nlohmann::json &) { json_calls++; });
+  em.EmitTyped("file.saved", event);
+  ASSERT_EQ(CountingNodeEvent::to_json_calls, 1);
+  ASSERT_EQ(json_calls, 2);
+  ASSERT_EQ(received["notebookId"], "nb");
+  ASSERT_EQ(received["path"], "a.md");
+
+  // A plain JSON emit still reaches the typed listener through FromJson.
+  em.Emit("file.saved", {{"notebookId", "nb"}, {"path", "b.md"}});
+  ASSERT_EQ(typed_path, "b.md");
+  std::cout << "  ✓ test_typed_emit_reaches_typed_and_json_listeners passed" << std::endl;
+  return 0;
+}
+
+int test_typed_listener_mismatched_payload_falls_back_to_json() {
+  std::cout << "  Running test_typed_listener_mismatched_payload_falls_back_to_json..."
+            << std::endl;
+  vxcore::EventManager em;
+  std::string notebook_id;
+  em.SubscribeTyped<vxcore::events::NotebookEvent>(
+      "file.moved", [&](std::string_view, const vxcore::events::NotebookEvent &e) {
+        notebook_id = std::string(e.notebook_id);
+      });
+  em.EmitTyped("file.moved", vxcore::events::NodeMovedEvent{"nb-1", "old.md", "new.md"});
+  ASSERT_EQ(notebook_id, "nb-1");
+  std::cout << "  ✓ test_typed_listener_mismatched_payload_falls_back_to_json passed"
+            << std::endl;
+  return 0;
+}
+
 // ============ C API tests ============
 
 namespace {
@@ -430,6 +657,77 @@ int test_integration_file_moved_event() {
 
 // ============ SyncManager dirty-tracking integration tests ============
 
+int test_integration_copy_folder_single_batched_event() {
+  std::cout << "  Running test_integration_copy_folder_single_batched_event..." << std::endl;
+  vxcore_set_test_mode(1);
+  vxcore_clear_test_directory();
+
+  VxCoreContextHandle ctx = nullptr;
+  VxCoreError err = vxcore_context_create(nullptr, &ctx);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  std::string nb_path = get_test_path("event_batch_nb");
+  cleanup_test_dir(nb_path);
+  err = vxcore_notebook_create(ctx, nb_path.c_str(), "{\"name\":\"BatchEventTest\"}",
+                               VXCORE_NOTEBOOK_BUNDLED, &notebook_id);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *folder_id = nullptr;
+  err = vxcore_folder_create(ctx, notebook_id, ".", "src", &folder_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(folder_id);
+  err = vxcore_folder_create(ctx, notebook_id, "src", "child", &folder_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(folder_id);
+  char *file_id = nullptr;
+  err = vxcore_file_create(ctx, notebook_id, "src/child", "note.md", &file_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(file_id);
+
+  CApiTestState state;
+  err = vxcore_on_events_coalesced(ctx, "[\"folder.config_changed\"]", test_event_callback,
+                                   &state);
+  ASSERT_EQ(err, VXCORE_OK);
+  err = vxcore_on_events_coalesced(ctx, "{}", test_event_callback_2, &state);
+  ASSERT_EQ(err, VXCORE_ERR_JSON_PARSE);
+
+  err = vxcore_node_copy(ctx, notebook_id, "src", ".", "dst", &folder_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(folder_id);
+
+  // dst, dst/child and the root parent were all rewritten, but the
+  // coalescing listener sees exactly one notification.
+  ASSERT_EQ(state.call_count, 1);
+  ASSERT_EQ(state.last_event, "events.batched");
+  auto j = nlohmann::json::parse(state.last_json);
+  ASSERT_EQ(j["events"].size(), 3u);
+  ASSERT_TRUE(j["paths"].is_array());
+
+  // Host-driven scope via the C API.
+  ASSERT_EQ(vxcore_event_batch_begin(ctx), VXCORE_OK);
+  err = vxcore_file_create(ctx, notebook_id, "dst", "a.md", &file_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(file_id);
+  err = vxcore_file_create(ctx, notebook_id, "dst", "b.md", &file_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(file_id);
+  ASSERT_EQ(state.call_count, 1);
+  ASSERT_EQ(vxcore_event_batch_end(ctx), VXCORE_OK);
+  ASSERT_EQ(state.call_count, 2);
+  j = nlohmann::json::parse(state.last_json);
+  ASSERT_EQ(j["events"].size(), 1u);
+  ASSERT_EQ(j["events"][0]["count"], 2);
+
+  ASSERT_EQ(vxcore_off_event(ctx, "events.batched", test_event_callback), VXCORE_OK);
+
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(nb_path);
+  std::cout << "  ✓ test_integration_copy_folder_single_batched_event passed" << std::endl;
+  return 0;
+}
+
 int test_sync_dirty_on_file_created() {
   std::cout << "  Running test_sync_dirty_on_file_created..." << std::endl;
   vxcore_set_test_mode(1);
@@ -810,6 +1108,14 @@ int main() {
   RUN_TEST(test_listener_receives_valid_json);
   RUN_TEST(test_emit_async_via_work_queue);
   RUN_TEST(test_emit_async_cross_thread);
+  RUN_TEST(test_has_listeners);
+  RUN_TEST(test_subscribe_unsubscribe_during_emit);
+  RUN_TEST(test_concurrent_emit_and_subscribe);
+  RUN_TEST(test_batch_coalesces_for_opted_in_listeners);
+  RUN_TEST(test_batch_is_per_thread);
+  RUN_TEST(test_unsubscribe_coalesced_listener);
+  RUN_TEST(test_typed_emit_reaches_typed_and_json_listeners);
+  RUN_TEST(test_typed_listener_mismatched_payload_falls_back_to_json);
 
   // C API tests
   RUN_TEST(test_c_api_on_off_event);
@@ -820,6 +1126,7 @@ int main() {
   RUN_TEST(test_integration_folder_created_event);
   RUN_TEST(test_integration_notebook_open_close_events);
   RUN_TEST(test_integration_file_moved_event);
+  RUN_TEST(test_integration_copy_folder_single_batched_event);
 
   // SyncManager dirty-tracking tests
   RUN_TEST(test_sync_dirty_on_file_created);
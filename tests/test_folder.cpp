@@ -3913,6 +3913,90 @@ int test_node_resolve_by_id() {
   return 0;
 }
 
+int test_node_batch_lookups() {
+  std::cout << "  Running test_node_batch_lookups..." << std::endl;
+  cleanup_test_dir(get_test_path("test_node_batch_nb"));
+
+  VxCoreContextHandle ctx = nullptr;
+  VxCoreError err = vxcore_context_create(nullptr, &ctx);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  err = vxcore_notebook_create(ctx, get_test_path("test_node_batch_nb").c_str(),
+                               "{\"name\":\"Batch Test\"}", VXCORE_NOTEBOOK_BUNDLED, &notebook_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  std::string nb_id(notebook_id);
+  vxcore_string_free(notebook_id);
+
+  char *folder_id = nullptr;
+  err = vxcore_folder_create(ctx, nb_id.c_str(), ".", "docs", &folder_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  std::string docs_id(folder_id);
+  vxcore_string_free(folder_id);
+
+  char *file_id = nullptr;
+  err = vxcore_file_create(ctx, nb_id.c_str(), "docs", "readme.md", &file_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  std::string readme_id(file_id);
+  vxcore_string_free(file_id);
+
+  nlohmann::json ids = {readme_id, "nonexistent-uuid", docs_id};
+  const std::string ids_json = ids.dump();
+
+  // Paths by ids, aligned with the input
+  char *out_json = nullptr;
+  err = vxcore_node_get_paths_by_ids(ctx, nb_id.c_str(), ids_json.c_str(), &out_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  nlohmann::json paths = nlohmann::json::parse(out_json);
+  vxcore_string_free(out_json);
+  ASSERT_EQ(paths.size(), 3);
+  ASSERT_EQ(paths[0].get<std::string>(), std::string("docs/readme.md"));
+  ASSERT_TRUE(paths[1].is_null());
+  ASSERT_EQ(paths[2].get<std::string>(), std::string("docs"));
+
+  // Resolution across open notebooks
+  out_json = nullptr;
+  err = vxcore_node_resolve_by_ids(ctx, ids_json.c_str(), &out_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  nlohmann::json nodes = nlohmann::json::parse(out_json);
+  vxcore_string_free(out_json);
+  ASSERT_EQ(nodes.size(), 3);
+  ASSERT_EQ(nodes[0]["notebookId"].get<std::string>(), nb_id);
+  ASSERT_EQ(nodes[0]["relativePath"].get<std::string>(), std::string("docs/readme.md"));
+  ASSERT_TRUE(nodes[1].is_null());
+  ASSERT_EQ(nodes[2]["relativePath"].get<std::string>(), std::string("docs"));
+
+  // Configs by path
+  out_json = nullptr;
+  err = vxcore_node_get_configs(ctx, nb_id.c_str(),
+                                "[\"docs/readme.md\", \"docs/nope.md\", \"docs\"]", &out_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  nlohmann::json configs = nlohmann::json::parse(out_json);
+  vxcore_string_free(out_json);
+  ASSERT_EQ(configs.size(), 3);
+  ASSERT_EQ(configs[0]["type"].get<std::string>(), std::string("file"));
+  ASSERT_EQ(configs[0]["id"].get<std::string>(), readme_id);
+  ASSERT_TRUE(configs[1].is_null());
+  ASSERT_EQ(configs[2]["type"].get<std::string>(), std::string("folder"));
+
+  // Malformed input
+  out_json = nullptr;
+  err = vxcore_node_resolve_by_ids(ctx, "not json", &out_json);
+  ASSERT_EQ(err, VXCORE_ERR_JSON_PARSE);
+  ASSERT_NULL(out_json);
+  err = vxcore_node_get_paths_by_ids(ctx, nb_id.c_str(), "[1, 2]", &out_json);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+  err = vxcore_node_get_configs(ctx, nb_id.c_str(), "{}", &out_json);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+  err = vxcore_node_get_paths_by_ids(ctx, "no-such-notebook", "[]", &out_json);
+  ASSERT_EQ(err, VXCORE_ERR_NOT_FOUND);
+
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(get_test_path("test_node_batch_nb"));
+  std::cout << "  ✓ test_node_batch_lookups passed" << std::endl;
+  return 0;
+}
+
 // ============================================================================
 // External nodes (list unindexed files/folders) tests
 // ============================================================================
@@ -10021,6 +10105,7 @@ int main() {
   // Node path lookup tests
   RUN_TEST(test_node_get_path_by_id);
   RUN_TEST(test_node_resolve_by_id);
+  RUN_TEST(test_node_batch_lookups);
   // File import tests
   RUN_TEST(test_file_import_basic);
   RUN_TEST(test_file_import_name_conflict);
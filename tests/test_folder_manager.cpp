@@ -1,6 +1,9 @@
 // Tests for FolderManager attachment interfaces.
 // This test links directly against folder manager sources instead of vxcore library.
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <nlohmann/json.hpp>
@@ -8,7 +11,10 @@
 
 #include "core/bundled_folder_manager.h"
 #include "core/bundled_notebook.h"
+#include "core/folder_config_cache.h"
+#include "core/folder_config_snapshot.h"
 #include "core/folder_manager.h"
+#include "core/metadata_store.h"
 #include "core/notebook.h"
 #include "test_utils.h"
 
@@ -352,6 +358,368 @@ int test_folder_manager_update_attachments_invalid_json() {
   return 0;
 }
 
+static std::unique_ptr<FolderConfig> make_config(const std::string &name, int files) {
+  auto config = std::make_unique<FolderConfig>(name);
+  for (int i = 0; i < files; ++i) {
+    config->files.emplace_back("note" + std::to_string(i) + ".md");
+  }
+  return config;
+}
+
+int test_folder_config_cache_lru_and_pins() {
+  std::cout << "  Running test_folder_config_cache_lru_and_pins..." << std::endl;
+
+  const size_t one = FolderConfigCache::EstimateBytes(*make_config("a", 10));
+  FolderConfigCache cache(one * 2);
+
+  // Unscoped puts never evict: callers may still hold the pointers.
+  cache.Put("a", make_config("a", 10));
+  cache.Put("b", make_config("b", 10));
+  cache.Put("c", make_config("c", 10));
+  ASSERT_EQ(cache.GetStats().entries, 3u);
+  ASSERT_EQ(cache.GetStats().evictions, 0u);
+
+  // Trimming drops the least recently used ("b", since "a" was just used).
+  ASSERT_NOT_NULL(cache.Get("a"));
+  cache.Trim();
+  ASSERT_TRUE(cache.Contains("a"));
+  ASSERT_FALSE(cache.Contains("b"));
+  ASSERT_TRUE(cache.Contains("c"));
+  ASSERT_EQ(cache.GetStats().evictions, 1u);
+  ASSERT_TRUE(cache.Get("b") == nullptr);
+  ASSERT_EQ(cache.GetStats().misses, 1u);
+
+  {
+    // Everything a scope touches stays, even far over budget.
+    FolderConfigCache::Scope outer(cache);
+    FolderConfig *a = cache.Get("a");
+    {
+      FolderConfigCache::Scope inner(cache);
+      cache.Put("d", make_config("d", 10));
+      cache.Put("e", make_config("e", 10));
+      ASSERT_EQ(cache.GetStats().pinned, 3u);
+    }
+    // The inner scope released "d" and trimmed; "a" is pinned by the outer
+    // scope and "e" is the most recently used.
+    ASSERT_TRUE(cache.Contains("a"));
+    ASSERT_EQ(a->name, std::string("a"));
+    ASSERT_TRUE(cache.Contains("e"));
+    ASSERT_FALSE(cache.Contains("c"));
+    ASSERT_FALSE(cache.Contains("d"));
+    ASSERT_EQ(cache.GetStats().pinned, 1u);
+  }
+  ASSERT_EQ(cache.GetStats().pinned, 0u);
+  ASSERT_TRUE(cache.GetStats().bytes <= one * 2);
+
+  // In-place growth is accounted for on Refresh.
+  const size_t before = cache.GetStats().bytes;
+  cache.Get("e")->files.emplace_back("more.md");
+  cache.Refresh("e");
+  ASSERT_TRUE(cache.GetStats().bytes > before);
+
+  // The most recently used config survives even a tiny budget.
+  cache.SetBudget(1);
+  ASSERT_EQ(cache.GetStats().entries, 1u);
+  ASSERT_TRUE(cache.Contains("e"));
+
+  cache.Clear();
+  ASSERT_EQ(cache.GetStats().entries, 0u);
+  ASSERT_EQ(cache.GetStats().bytes, 0u);
+
+  // Configs large enough for the file index count its name and id maps: the
+  // file that crosses the threshold costs far more than the one before it.
+  const int indexed_files = static_cast<int>(FolderConfig::kFileIndexMinFiles);
+  const size_t two_below = FolderConfigCache::EstimateBytes(*make_config("i", indexed_files - 2));
+  const size_t below = FolderConfigCache::EstimateBytes(*make_config("i", indexed_files - 1));
+  auto indexed = make_config("i", indexed_files);
+  const size_t at = FolderConfigCache::EstimateBytes(*indexed);
+  ASSERT_TRUE(at - below > static_cast<size_t>(indexed_files) * (below - two_below) / 2);
+
+  // Building the maps does not change the estimate, so the entry stays in step.
+  cache.Put("i", std::move(indexed));
+  ASSERT_EQ(cache.GetStats().bytes, at);
+  ASSERT_EQ(cache.Get("i")->FindFileIndex("note1.md"), 1);
+  cache.Refresh("i");
+  ASSERT_EQ(cache.GetStats().bytes, at);
+
+  std::cout << "  test_folder_config_cache_lru_and_pins passed" << std::endl;
+  return 0;
+}
+
+int test_folder_config_snapshot_round_trip() {
+  std::cout << "  Running test_folder_config_snapshot_round_trip..." << std::endl;
+
+  auto config = make_config("docs", 3);
+  config->folders = {"sub", "\xE4\xB8\xAD\xE6\x96\x87"};
+  config->metadata = {{"color", "red"}, {"pinned", true}};
+  config->files[0].metadata = {{"stars", 3}, {"owner", {{"name", "kim"}}}};
+  config->files[1].tags = {"draft", "todo"};
+  config->files[2].attachments = {"a.png"};
+
+  FolderConfig decoded;
+  ASSERT_TRUE(FolderConfigSnapshot::Decode(FolderConfigSnapshot::Encode(*config), decoded));
+  ASSERT_TRUE(decoded.ToJson() == config->ToJson());
+
+  // A null metadata decodes as the empty object FromJson() would give.
+  config->files[1].metadata = nullptr;
+  ASSERT_TRUE(FolderConfigSnapshot::Decode(FolderConfigSnapshot::Encode(*config), decoded));
+  ASSERT_TRUE(decoded.files[1].metadata == nlohmann::json::object());
+
+  // Truncated or padded records are rejected.
+  const std::string bytes = FolderConfigSnapshot::Encode(*config);
+  ASSERT_FALSE(FolderConfigSnapshot::Decode(bytes.substr(0, bytes.size() - 1), decoded));
+  ASSERT_FALSE(FolderConfigSnapshot::Decode(bytes + "x", decoded));
+  ASSERT_FALSE(FolderConfigSnapshot::Decode(std::string(), decoded));
+
+  // Written snapshots are looked up by path and stat values.
+  const std::string test_path = get_test_path("test_folder_config_snapshot");
+  cleanup_test_dir(test_path);
+  create_directory(test_path);
+  const std::string snapshot_path = test_path + "/configs.snapshot";
+  std::vector<FolderConfigSnapshot::Record> records(2);
+  records[0].folder_path = ".";
+  records[0].stamp = {100, 200, "hash"};
+  records[0].bytes = FolderConfigSnapshot::Encode(*make_config("root", 1));
+  records[1].folder_path = "docs";
+  records[1].stamp = {300, 400, ""};
+  records[1].bytes = bytes;
+  ASSERT_TRUE(FolderConfigSnapshot::Write(snapshot_path, records));
+
+  FolderConfigSnapshot snapshot;
+  ASSERT_TRUE(snapshot.Open(snapshot_path));
+  ASSERT_EQ(snapshot.Size(), 2u);
+  std::unique_ptr<FolderConfig> loaded;
+  std::string hash;
+  ASSERT_TRUE(snapshot.Load("docs", 300, 400, loaded, &hash));
+  ASSERT_EQ(loaded->name, std::string("docs"));
+  ASSERT_TRUE(hash.empty());
+  ASSERT_TRUE(snapshot.Load(".", 100, 200, loaded, &hash));
+  ASSERT_EQ(hash, std::string("hash"));
+  ASSERT_FALSE(snapshot.Load(".", 101, 200, loaded));
+  ASSERT_FALSE(snapshot.Load("other", 100, 200, loaded));
+  snapshot.Close();
+
+  // Other versions are ignored.
+  {
+    // The version follows the 8-byte magic.
+    std::fstream file(snapshot_path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(8);
+    file.put(static_cast<char>(FolderConfigSnapshot::kVersion + 1));
+  }
+  ASSERT_FALSE(snapshot.Open(snapshot_path));
+  ASSERT_EQ(snapshot.Size(), 0u);
+
+  cleanup_test_dir(test_path);
+  std::cout << "  test_folder_config_snapshot_round_trip passed" << std::endl;
+  return 0;
+}
+
+int test_folder_config_file_index() {
+  std::cout << "  Running test_folder_config_file_index..." << std::endl;
+
+  // Small folders are scanned; large ones go through the index.
+  for (int count : {3, 200}) {
+    auto config = make_config("docs", count);
+    const int last = count - 1;
+    const std::string last_name = "note" + std::to_string(last) + ".md";
+    ASSERT_EQ(config->FindFileIndex(last_name), last);
+    ASSERT_EQ(config->FindFileIndexById(config->files[last].id), last);
+    ASSERT_EQ(config->FindFileIndex("missing.md"), -1);
+    ASSERT_EQ(config->FindFileIndexById("missing-id"), -1);
+
+    const std::string added_id = config->AddFile(FileRecord("added.md")).id;
+    ASSERT_EQ(config->FindFileIndex("added.md"), count);
+    ASSERT_EQ(config->FindFileIndexById(added_id), count);
+
+    config->RenameFile(0, "renamed.md");
+    ASSERT_EQ(config->FindFileIndex("note0.md"), -1);
+    ASSERT_EQ(config->FindFileIndex("renamed.md"), 0);
+
+    // Later positions shift down.
+    config->RemoveFile(0);
+    ASSERT_EQ(config->FindFileIndex("renamed.md"), -1);
+    ASSERT_EQ(config->FindFileIndex("added.md"), count - 1);
+    ASSERT_EQ(config->FindFileIndex(last_name), last - 1);
+    ASSERT_EQ(config->FindFileIndexById(added_id), count - 1);
+
+    // Direct appends are caught by the size check.
+    config->files.emplace_back("direct.md");
+    ASSERT_EQ(config->FindFileIndex("direct.md"), count);
+
+    // Direct reorders need an explicit invalidation.
+    std::swap(config->files.front(), config->files.back());
+    config->InvalidateFileIndex();
+    ASSERT_EQ(config->FindFileIndex("direct.md"), 0);
+    ASSERT_EQ(config->FindFileIndex("note1.md"), count);
+
+    // A stale hit is detected and answered from a rebuilt index.
+    config->files[1].name = "sneaky.md";
+    ASSERT_EQ(config->FindFileIndex("note2.md"), -1);
+    ASSERT_NOT_NULL(config->FindFile("sneaky.md"));
+  }
+
+  std::cout << "  test_folder_config_file_index passed" << std::endl;
+  return 0;
+}
+
+int test_folder_manager_reconcile_rename_and_reuse() {
+  std::cout << "  Running test_folder_manager_reconcile_rename_and_reuse..." << std::endl;
+  std::string test_path = get_test_path("test_fm_reconcile_reuse");
+  cleanup_test_dir(test_path);
+
+  auto notebook = create_test_notebook(test_path);
+  ASSERT_NOT_NULL(notebook.get());
+  auto *fm = dynamic_cast<BundledFolderManager *>(notebook->GetFolderManager());
+  ASSERT_NOT_NULL(fm);
+  MetadataStore *store = notebook->GetMetadataStore();
+  ASSERT_NOT_NULL(store);
+
+  std::string folder_id;
+  std::string file_id;
+  std::string sub_id;
+  ASSERT_EQ(fm->CreateFolder(".", "a", folder_id), VXCORE_OK);
+  ASSERT_EQ(fm->CreateFile("a", "x.md", file_id), VXCORE_OK);
+  ASSERT_EQ(fm->CreateFolder("a", "sub", sub_id), VXCORE_OK);
+  ASSERT_EQ(fm->SyncMetadataStoreFromConfigs(), VXCORE_OK);
+
+  // Outside vxcore: rename a -> b, then create a new folder named "a".
+  const std::string contents = test_path + "/vx_notebook/contents";
+  std::filesystem::rename(test_path + "/a", test_path + "/b");
+  std::filesystem::rename(contents + "/a", contents + "/b");
+  auto read_json = [](const std::string &path) {
+    std::ifstream in(path);
+    return nlohmann::json::parse(in);
+  };
+  nlohmann::json renamed = read_json(contents + "/b/vx.json");
+  renamed["name"] = "b";
+  write_file(contents + "/b/vx.json", renamed.dump(2));
+  nlohmann::json reused = read_json(contents + "/b/vx.json");
+  const std::string reused_id = "reused-folder-id";
+  reused["id"] = reused_id;
+  reused["name"] = "a";
+  reused["files"] = nlohmann::json::array();
+  reused["folders"] = nlohmann::json::array();
+  std::filesystem::create_directories(test_path + "/a");
+  std::filesystem::create_directories(contents + "/a");
+  write_file(contents + "/a/vx.json", reused.dump(2));
+  nlohmann::json root = read_json(contents + "/vx.json");
+  root["folders"] = nlohmann::json::array({"b", "a"});
+  write_file(contents + "/vx.json", root.dump(2));
+
+  // The renamed folder keeps its row, files and subtree; nothing is removed.
+  int changed = -1;
+  int removed = -1;
+  ASSERT_EQ(fm->ReconcileMetadataStore(false, &changed, &removed), VXCORE_OK);
+  ASSERT_EQ(removed, 0);
+  auto folder = store->GetFolderByPath("b");
+  ASSERT_TRUE(folder.has_value());
+  ASSERT_EQ(folder->id, folder_id);
+  auto file = store->GetFileByPath("b/x.md");
+  ASSERT_TRUE(file.has_value());
+  ASSERT_EQ(file->id, file_id);
+  auto sub = store->GetFolderByPath("b/sub");
+  ASSERT_TRUE(sub.has_value());
+  ASSERT_EQ(sub->id, sub_id);
+  folder = store->GetFolderByPath("a");
+  ASSERT_TRUE(folder.has_value());
+  ASSERT_EQ(folder->id, reused_id);
+  ASSERT_TRUE(store->ListFiles(reused_id).empty());
+
+  // Nothing changed since: a second pass is a no-op.
+  ASSERT_EQ(fm->ReconcileMetadataStore(false, &changed, &removed), VXCORE_OK);
+  ASSERT_EQ(changed, 0);
+  ASSERT_EQ(removed, 0);
+
+  notebook.reset();
+  cleanup_test_dir(test_path);
+  std::cout << "  test_folder_manager_reconcile_rename_and_reuse passed" << std::endl;
+  return 0;
+}
+
+int test_folder_manager_config_write_behind() {
+  std::cout << "  Running test_folder_manager_config_write_behind..." << std::endl;
+  std::string test_path = get_test_path("test_fm_write_behind");
+  cleanup_test_dir(test_path);
+
+  auto notebook = create_test_notebook(test_path);
+  ASSERT_NOT_NULL(notebook.get());
+  auto *fm = dynamic_cast<BundledFolderManager *>(notebook->GetFolderManager());
+  ASSERT_NOT_NULL(fm);
+
+  std::string id;
+  ASSERT_EQ(fm->CreateFolder(".", "docs", id), VXCORE_OK);
+  ASSERT_EQ(fm->CreateFile("docs", "a.md", id), VXCORE_OK);
+  ASSERT_EQ(fm->CreateFile("docs", "b.md", id), VXCORE_OK);
+
+  auto stars_on_disk = [&](const std::string &folder, int file) {
+    std::ifstream in(test_path + "/vx_notebook/contents/" + folder + "/vx.json");
+    const auto metadata = nlohmann::json::parse(in)["files"][file]["metadata"];
+    return metadata.contains("stars") ? metadata["stars"].get<int>() : 0;
+  };
+  auto set_stars = [&](const std::string &file, int stars) {
+    return fm->UpdateFileMetadata("docs/" + file, "{\"stars\": " + std::to_string(stars) + "}");
+  };
+
+  // Inside a scope, a folder saved several times is written once, at the end.
+  {
+    BundledFolderManager::ConfigWriteScope scope(*fm);
+    ASSERT_EQ(set_stars("a.md", 1), VXCORE_OK);
+    ASSERT_EQ(set_stars("b.md", 2), VXCORE_OK);
+    ASSERT_TRUE(fm->HasPendingConfigWrites());
+    ASSERT_EQ(stars_on_disk("docs", 0), 0);
+
+    // Reads see the pending changes.
+    std::string metadata_json;
+    ASSERT_EQ(fm->GetFileMetadata("docs/b.md", metadata_json), VXCORE_OK);
+    ASSERT_EQ(nlohmann::json::parse(metadata_json)["stars"].get<int>(), 2);
+  }
+  ASSERT_FALSE(fm->HasPendingConfigWrites());
+  ASSERT_EQ(stars_on_disk("docs", 0), 1);
+  ASSERT_EQ(stars_on_disk("docs", 1), 2);
+
+  // With write-behind, saves wait until enough of them are pending.
+  WriteBehindOptions options;
+  options.enabled = true;
+  options.max_pending_writes = 3;
+  options.max_delay = std::chrono::hours(1);
+  fm->SetConfigWriteBehind(options);
+  ASSERT_EQ(set_stars("a.md", 3), VXCORE_OK);
+  ASSERT_EQ(set_stars("a.md", 4), VXCORE_OK);
+  ASSERT_TRUE(fm->HasPendingConfigWrites());
+  ASSERT_EQ(stars_on_disk("docs", 0), 1);
+  ASSERT_EQ(fm->FlushConfigWrites(/*only_if_due=*/true), VXCORE_OK);
+  ASSERT_TRUE(fm->HasPendingConfigWrites());
+  ASSERT_EQ(set_stars("a.md", 5), VXCORE_OK);
+  ASSERT_FALSE(fm->HasPendingConfigWrites());
+  ASSERT_EQ(stars_on_disk("docs", 0), 5);
+
+  // Operations that copy or move config files on disk write pending ones first.
+  ASSERT_EQ(set_stars("b.md", 6), VXCORE_OK);
+  ASSERT_TRUE(fm->HasPendingConfigWrites());
+  ASSERT_EQ(fm->CopyFolder("docs", ".", "copy", id), VXCORE_OK);
+  ASSERT_EQ(stars_on_disk("docs", 1), 6);
+  ASSERT_EQ(stars_on_disk("copy", 1), 6);
+
+  // Evicting cached configs never drops a pending one.
+  ASSERT_EQ(set_stars("b.md", 7), VXCORE_OK);
+  ASSERT_EQ(fm->SetConfigCacheBudget(1), VXCORE_OK);
+  std::string metadata_json;
+  ASSERT_EQ(fm->GetFolderMetadata("copy", metadata_json), VXCORE_OK);
+  ASSERT_EQ(fm->FlushConfigWrites(), VXCORE_OK);
+  ASSERT_EQ(stars_on_disk("docs", 1), 7);
+
+  // Closing the notebook writes what is still pending.
+  ASSERT_EQ(set_stars("a.md", 8), VXCORE_OK);
+  ASSERT_TRUE(fm->HasPendingConfigWrites());
+  notebook->Close();
+  ASSERT_EQ(stars_on_disk("docs", 0), 8);
+
+  notebook.reset();
+  cleanup_test_dir(test_path);
+  std::cout << "  test_folder_manager_config_write_behind passed" << std::endl;
+  return 0;
+}
+
 int main() {
   std::cout << "Running folder manager attachment tests..." << std::endl;
 
@@ -363,6 +731,11 @@ int main() {
   RUN_TEST(test_folder_manager_attachment_nested_file);
   RUN_TEST(test_folder_manager_update_attachments);
   RUN_TEST(test_folder_manager_update_attachments_invalid_json);
+  RUN_TEST(test_folder_config_cache_lru_and_pins);
+  RUN_TEST(test_folder_config_snapshot_round_trip);
+  RUN_TEST(test_folder_config_file_index);
+  RUN_TEST(test_folder_manager_config_write_behind);
+  RUN_TEST(test_folder_manager_reconcile_rename_and_reuse);
 
   std::cout << "All folder manager attachment tests passed!" << std::endl;
   return 0;
@@ -111,6 +111,7 @@ int test_history_dedup() {
   ASSERT_EQ(err, VXCORE_OK);
   auto arr1 = nlohmann::json::parse(history_json);
   int64_t first_ts = arr1[0]["openedUtc"].get<int64_t>();
+  ASSERT_EQ(arr1[0]["openCount"].get<int64_t>(), 1);
   vxcore_string_free(history_json);
 
   // Close buffer, sleep, re-open
@@ -123,12 +124,13 @@ int test_history_dedup() {
   err = vxcore_buffer_open(ctx, notebook_id, "note.md", &buffer_id2);
   ASSERT_EQ(err, VXCORE_OK);
 
-  // Check: still 1 entry, timestamp updated
+  // Check: still 1 entry, timestamp updated, open counted
   err = vxcore_notebook_history_get(ctx, notebook_id, &history_json);
   ASSERT_EQ(err, VXCORE_OK);
   auto arr2 = nlohmann::json::parse(history_json);
   ASSERT_EQ(arr2.size(), static_cast<size_t>(1));
   ASSERT_TRUE(arr2[0]["openedUtc"].get<int64_t>() >= first_ts);
+  ASSERT_EQ(arr2[0]["openCount"].get<int64_t>(), 2);
 
   vxcore_string_free(history_json);
   vxcore_string_free(buffer_id2);
@@ -1,6 +1,11 @@
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #include "core/metadata_store.h"
 #include "db/sqlite_metadata_store.h"
@@ -851,6 +856,281 @@ int test_metadata_store_find_files_by_tags() {
 // Tag Definition Tests
 // ============================================================================
 
+// File ids matching |filter| per the store's own file records, sorted.
+static std::vector<std::string> expected_tag_filter_ids(SqliteMetadataStore &store,
+                                                        const StoreTagFilter &filter) {
+  std::vector<std::string> ids;
+  store.IterateAllFiles([&](const std::string &, const StoreFileRecord &file) {
+    if (filter.Matches(file.tags)) {
+      ids.push_back(file.id);
+    }
+    return true;
+  });
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+static std::vector<std::string> sorted_result_ids(const std::vector<StoreTagQueryResult> &results) {
+  std::vector<std::string> ids;
+  for (const auto &result : results) {
+    ids.push_back(result.file_id);
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+int test_metadata_store_tag_filter() {
+  std::cout << "  Running test_metadata_store_tag_filter..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+
+  StoreFolderRecord root;
+  root.id = "tf-root";
+  root.parent_id = "";
+  root.name = ".";
+  root.created_utc = 0;
+  root.modified_utc = 0;
+  root.metadata = "{}";
+  ASSERT_TRUE(store.CreateFolder(root));
+  StoreFolderRecord sub = root;
+  sub.id = "tf-sub";
+  sub.parent_id = "tf-root";
+  sub.name = "sub";
+  ASSERT_TRUE(store.CreateFolder(sub));
+
+  // More matches than one row-loading batch
+  for (int i = 0; i < 600; ++i) {
+    StoreFileRecord file;
+    file.id = "tf-file-" + std::to_string(i);
+    file.folder_id = i < 20 ? "tf-sub" : "tf-root";
+    file.name = "n" + std::to_string(i % 50) + ".md";
+    file.created_utc = 0;
+    file.modified_utc = 0;
+    file.metadata = "{}";
+    if (i % 2 == 0) file.tags.push_back("even");
+    if (i % 3 == 0) file.tags.push_back("three");
+    if (i % 7 == 0) file.tags.push_back("seven");
+    if (i < 20) file.tags.push_back("sub");
+    ASSERT_TRUE(store.CreateFile(file));
+  }
+
+  const std::vector<StoreTagFilter> filters = {
+      {{"even", "three"}, {}, {}},
+      {{}, {"seven", "sub"}, {}},
+      {{"even"}, {}, {"three"}},
+      {{"three"}, {"even", "seven"}, {"sub"}},
+      {{}, {}, {"even", "three"}},
+      {{"even", "missing"}, {}, {}},
+  };
+  auto check_all = [&](MetadataStoreReader &reader) {
+    for (const auto &filter : filters) {
+      auto results = reader.FindFilesByTagFilter(filter);
+      if (sorted_result_ids(results) != expected_tag_filter_ids(store, filter)) {
+        return false;
+      }
+      for (size_t i = 1; i < results.size(); ++i) {
+        if (results[i - 1].file_name > results[i].file_name) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+  ASSERT_TRUE(check_all(store));
+  ASSERT_TRUE(store.FindFilesByTagFilter(StoreTagFilter()).empty());
+
+  // Results carry paths and complete tag lists
+  StoreTagFilter sub_only;
+  sub_only.all_of = {"sub", "seven"};
+  auto results = store.FindFilesByTagFilter(sub_only);
+  ASSERT_EQ(results.size(), 3);
+  ASSERT_EQ(results[0].file_path, std::string("sub/") + results[0].file_name);
+  ASSERT_EQ(results[0].folder_id, std::string("tf-sub"));
+  ASSERT_TRUE(results[0].tags.size() >= 2);
+
+  // The index follows every kind of mutation
+  ASSERT_TRUE(store.UpdateFile("tf-file-6", "renamed.md", 5, "{}"));
+  ASSERT_TRUE(store.SetFileTags("tf-file-9", {"seven"}));
+  ASSERT_TRUE(store.AddTagToFile("tf-file-1", "three"));
+  ASSERT_TRUE(store.RemoveTagFromFile("tf-file-12", "even"));
+  ASSERT_TRUE(store.DeleteFile("tf-file-0"));
+  ASSERT_TRUE(check_all(store));
+
+  ASSERT_TRUE(store.DeleteFolder("tf-sub"));
+  StoreTagFilter sub_any;
+  sub_any.any_of = {"sub"};
+  ASSERT_TRUE(store.FindFilesByTagFilter(sub_any).empty());
+  ASSERT_TRUE(check_all(store));
+
+  ASSERT_TRUE(store.DeleteTag("seven"));
+  ASSERT_TRUE(check_all(store));
+
+  // Rolled-back changes leave the index
+  StoreTagFilter temp;
+  temp.all_of = {"temp"};
+  ASSERT_TRUE(store.BeginTransaction());
+  ASSERT_TRUE(store.AddTagToFile("tf-file-30", "temp"));
+  ASSERT_EQ(store.FindFilesByTagFilter(temp).size(), 1);
+  ASSERT_TRUE(store.RollbackTransaction());
+  ASSERT_TRUE(store.FindFilesByTagFilter(temp).empty());
+  ASSERT_TRUE(check_all(store));
+
+  // Pooled readers agree, and skip changes not yet committed
+  auto reader = store.AcquireReader();
+  ASSERT_NOT_NULL(reader);
+  ASSERT_TRUE(check_all(*reader));
+  ASSERT_TRUE(store.BeginTransaction());
+  ASSERT_TRUE(store.AddTagToFile("tf-file-30", "temp"));
+  ASSERT_EQ(store.FindFilesByTagFilter(temp).size(), 1);
+  ASSERT_TRUE(reader->FindFilesByTagFilter(temp).empty());
+  ASSERT_TRUE(store.CommitTransaction());
+  ASSERT_EQ(reader->FindFilesByTagFilter(temp).size(), 1);
+  reader.reset();
+
+  // Bulk reloads rebuild it
+  ASSERT_TRUE(store.BeginBulkLoad());
+  ASSERT_TRUE(store.BulkAddFolder(root));
+  StoreFileRecord bulk;
+  bulk.id = "tf-bulk";
+  bulk.folder_id = "tf-root";
+  bulk.name = "bulk.md";
+  bulk.created_utc = 0;
+  bulk.modified_utc = 0;
+  bulk.metadata = "{}";
+  bulk.tags = {"even", "bulk"};
+  ASSERT_TRUE(store.BulkAddFile(bulk));
+  ASSERT_TRUE(store.EndBulkLoad());
+  StoreTagFilter even;
+  even.all_of = {"even"};
+  results = store.FindFilesByTagFilter(even);
+  ASSERT_EQ(results.size(), 1);
+  ASSERT_EQ(results[0].file_id, std::string("tf-bulk"));
+  ASSERT_TRUE(check_all(store));
+
+  store.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_tag_filter passed" << std::endl;
+  return 0;
+}
+
+int test_metadata_store_tag_hierarchy_queries() {
+  std::cout << "  Running test_metadata_store_tag_hierarchy_queries..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+
+  // project -> {alpha, beta -> beta1}; other is a separate root.
+  for (const auto &[name, parent] : std::vector<std::pair<std::string, std::string>>{
+           {"project", ""}, {"alpha", "project"}, {"beta", "project"}, {"beta1", "beta"},
+           {"other", ""}}) {
+    StoreTagRecord tag;
+    tag.name = name;
+    tag.parent_name = parent;
+    tag.metadata = "{}";
+    ASSERT_TRUE(store.CreateOrUpdateTag(tag));
+  }
+
+  StoreFolderRecord root;
+  root.id = "th-root";
+  root.parent_id = "";
+  root.name = ".";
+  root.created_utc = 0;
+  root.modified_utc = 0;
+  root.metadata = "{}";
+  ASSERT_TRUE(store.CreateFolder(root));
+
+  const std::vector<std::pair<std::string, std::vector<std::string>>> files = {
+      {"a", {"alpha"}}, {"b", {"beta1"}}, {"c", {"project", "alpha"}}, {"d", {"other"}}, {"e", {}}};
+  for (const auto &[id, tags] : files) {
+    StoreFileRecord file;
+    file.id = "th-" + id;
+    file.folder_id = "th-root";
+    file.name = id + ".md";
+    file.created_utc = 0;
+    file.modified_utc = 0;
+    file.metadata = "{}";
+    file.tags = tags;
+    ASSERT_TRUE(store.CreateFile(file));
+  }
+
+  using Ids = std::vector<std::string>;
+  auto subtree_filter = [](Ids all_of, Ids any_of, Ids none_of) {
+    StoreTagFilter filter{std::move(all_of), std::move(any_of), std::move(none_of)};
+    filter.include_descendants = true;
+    return filter;
+  };
+  const std::vector<std::pair<StoreTagFilter, Ids>> cases = {
+      {subtree_filter({"project"}, {}, {}), {"th-a", "th-b", "th-c"}},
+      {subtree_filter({"beta"}, {}, {}), {"th-b"}},
+      {subtree_filter({"project"}, {}, {"alpha"}), {"th-b"}},
+      {subtree_filter({"project", "beta"}, {}, {}), {"th-b"}},
+      {subtree_filter({}, {"beta", "other"}, {}), {"th-b", "th-d"}},
+      {subtree_filter({}, {}, {"project"}), {"th-d", "th-e"}},
+      {subtree_filter({"missing"}, {}, {}), {}},
+  };
+  auto check_all = [&](MetadataStoreReader &reader) {
+    for (const auto &[filter, expected] : cases) {
+      if (sorted_result_ids(reader.FindFilesByTagFilter(filter)) != expected) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Index on the store, then SQL on a pooled reader while the index is ahead
+  ASSERT_TRUE(check_all(store));
+  auto reader = store.AcquireReader();
+  ASSERT_NOT_NULL(reader);
+  ASSERT_TRUE(check_all(*reader));
+  ASSERT_TRUE(store.BeginTransaction());
+  ASSERT_TRUE(store.AddTagToFile("th-e", "temp"));
+  ASSERT_TRUE(check_all(*reader));
+  ASSERT_TRUE(store.RollbackTransaction());
+  reader.reset();
+
+  // Exact matching is unchanged without the flag
+  StoreTagFilter exact;
+  exact.all_of = {"project"};
+  ASSERT_TRUE(sorted_result_ids(store.FindFilesByTagFilter(exact)) == Ids{"th-c"});
+
+  // Moving a tag moves its files between subtrees
+  StoreTagRecord moved;
+  moved.name = "beta";
+  moved.parent_name = "other";
+  moved.metadata = "{}";
+  ASSERT_TRUE(store.CreateOrUpdateTag(moved));
+  ASSERT_TRUE(sorted_result_ids(store.FindFilesByTagFilter(subtree_filter({"project"}, {}, {}))) ==
+              (Ids{"th-a", "th-c"}));
+  ASSERT_TRUE(sorted_result_ids(store.FindFilesByTagFilter(subtree_filter({"other"}, {}, {}))) ==
+              (Ids{"th-b", "th-d"}));
+
+  // Rolled-up counts, ordered by name
+  auto counts = store.CountFilesByTagSubtree();
+  ASSERT_EQ(counts.size(), 5);
+  ASSERT_EQ(counts[0].name, std::string("alpha"));
+  ASSERT_EQ(counts[0].file_count, 2);
+  ASSERT_EQ(counts[1].name, std::string("beta"));
+  ASSERT_EQ(counts[1].parent_name, std::string("other"));
+  ASSERT_EQ(counts[1].file_count, 0);
+  ASSERT_EQ(counts[1].subtree_file_count, 1);
+  ASSERT_EQ(counts[3].name, std::string("other"));
+  ASSERT_EQ(counts[3].subtree_file_count, 2);
+  ASSERT_EQ(counts[4].name, std::string("project"));
+  ASSERT_EQ(counts[4].parent_name, std::string(""));
+  ASSERT_EQ(counts[4].file_count, 1);
+  ASSERT_EQ(counts[4].subtree_file_count, 2);
+
+  store.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_tag_hierarchy_queries passed" << std::endl;
+  return 0;
+}
+
 int test_metadata_store_tag_definitions() {
   std::cout << "  Running test_metadata_store_tag_definitions..." << std::endl;
 
@@ -895,6 +1175,123 @@ int test_metadata_store_tag_definitions() {
   return 0;
 }
 
+int test_metadata_store_metadata_queries() {
+  std::cout << "  Running test_metadata_store_metadata_queries..." << std::endl;
+
+  setup_test_db();
+
+  auto add_tree = [](auto add_folder, auto add_file) {
+    StoreFolderRecord root;
+    root.id = "mq-root";
+    root.name = ".";
+    root.created_utc = 0;
+    root.modified_utc = 0;
+    root.metadata = "{}";
+    bool ok = add_folder(root);
+    StoreFolderRecord docs = root;
+    docs.id = "mq-docs";
+    docs.parent_id = "mq-root";
+    docs.name = "docs";
+    docs.metadata = R"({"status": "draft"})";
+    ok = add_folder(docs) && ok;
+    const std::vector<std::tuple<std::string, std::string, std::string>> files = {
+        {"a", "mq-docs", R"({"status": "draft", "priority": 1})"},
+        {"b", "mq-docs", R"({"status": "done", "priority": 3})"},
+        {"c", "mq-root", "{}"}};
+    for (const auto &[id, folder, metadata] : files) {
+      StoreFileRecord file;
+      file.id = "mq-" + id;
+      file.folder_id = folder;
+      file.name = id + ".md";
+      file.created_utc = 0;
+      file.modified_utc = 0;
+      file.metadata = metadata;
+      ok = add_file(file) && ok;
+    }
+    return ok;
+  };
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+  ASSERT_TRUE(add_tree([&](const StoreFolderRecord &f) { return store.CreateFolder(f); },
+                       [&](const StoreFileRecord &f) { return store.CreateFile(f); }));
+
+  auto query_for = [](const std::string &key, MetadataOp op, nlohmann::json value) {
+    StoreMetadataQuery query;
+    query.filter.conditions.push_back({key, op, std::move(value)});
+    return query;
+  };
+  using Keys = std::vector<std::string>;
+
+  StoreMetadataQuery drafts = query_for("status", MetadataOp::kEq, "draft");
+  drafts.include_folders = true;
+  auto matches = store.FindNodesByMetadata(drafts);
+  ASSERT_EQ(matches.size(), 2);
+  ASSERT_EQ(matches[0].node_id, "mq-a");
+  ASSERT_EQ(matches[0].path, "docs/a.md");
+  ASSERT_FALSE(matches[0].is_folder);
+  ASSERT_EQ(matches[0].metadata, R"({"status": "draft", "priority": 1})");
+  ASSERT_EQ(matches[1].node_id, "mq-docs");
+  ASSERT_EQ(matches[1].path, "docs");
+  ASSERT_TRUE(matches[1].is_folder);
+
+  auto reader = store.AcquireReader();
+  ASSERT_NOT_NULL(reader);
+  ASSERT_EQ(reader->FindNodesByMetadata(drafts).size(), 2);
+  reader.reset();
+
+  // The third query comparing on a key indexes it; presence tests don't count.
+  ASSERT_TRUE(store.ListMetadataIndexes().empty());
+  for (int i = 0; i < 3; ++i) {
+    store.FindNodesByMetadata(query_for("status", MetadataOp::kExists, nullptr));
+  }
+  ASSERT_TRUE(store.ListMetadataIndexes().empty());
+  store.FindNodesByMetadata(drafts);
+  ASSERT_TRUE(store.ListMetadataIndexes().empty());
+  store.FindNodesByMetadata(drafts);
+  ASSERT_TRUE(store.ListMetadataIndexes() == Keys{"status"});
+
+  // Not inside a transaction; the next query after it does.
+  const StoreMetadataQuery urgent = query_for("priority", MetadataOp::kLt, 2);
+  ASSERT_TRUE(store.BeginTransaction());
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(store.FindNodesByMetadata(urgent).size(), 1);
+  }
+  ASSERT_FALSE(store.CreateMetadataIndex("review.state"));
+  ASSERT_TRUE(store.CommitTransaction());
+  ASSERT_TRUE(store.ListMetadataIndexes() == Keys{"status"});
+  ASSERT_EQ(store.FindNodesByMetadata(urgent).size(), 1);
+  ASSERT_TRUE(store.ListMetadataIndexes() == (Keys{"priority", "status"}));
+
+  ASSERT_TRUE(store.CreateMetadataIndex("review.state"));
+  ASSERT_FALSE(store.CreateMetadataIndex("bad'key"));
+  const Keys all_keys = {"priority", "review.state", "status"};
+  ASSERT_TRUE(store.ListMetadataIndexes() == all_keys);
+
+  // Indexes outlive rebuilds, bulk loads and reopening.
+  ASSERT_TRUE(store.RebuildAll());
+  ASSERT_TRUE(store.ListMetadataIndexes() == all_keys);
+  ASSERT_TRUE(store.BeginBulkLoad());
+  ASSERT_TRUE(add_tree([&](const StoreFolderRecord &f) { return store.BulkAddFolder(f); },
+                       [&](const StoreFileRecord &f) { return store.BulkAddFile(f); }));
+  ASSERT_TRUE(store.EndBulkLoad());
+  ASSERT_TRUE(store.ListMetadataIndexes() == all_keys);
+  ASSERT_EQ(store.FindNodesByMetadata(drafts).size(), 2);
+
+  store.Close();
+  ASSERT_TRUE(store.Open(test_db_path));
+  ASSERT_TRUE(store.ListMetadataIndexes() == all_keys);
+  ASSERT_EQ(store.FindNodesByMetadata(urgent).size(), 1);
+
+  ASSERT_TRUE(store.DropMetadataIndex("priority"));
+  ASSERT_TRUE(store.ListMetadataIndexes() == (Keys{"review.state", "status"}));
+
+  store.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_metadata_queries passed" << std::endl;
+  return 0;
+}
+
 // ============================================================================
 // RebuildAll Test
 // ============================================================================
@@ -956,6 +1353,174 @@ int test_metadata_store_rebuild_all() {
   return 0;
 }
 
+int test_metadata_store_bulk_load() {
+  std::cout << "  Running test_metadata_store_bulk_load..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+
+  // Stale data is replaced by the load
+  StoreFolderRecord stale;
+  stale.id = "bulk-stale-uuid";
+  stale.parent_id = "";
+  stale.name = "stale";
+  stale.created_utc = 1;
+  stale.modified_utc = 1;
+  stale.metadata = "{}";
+  ASSERT_TRUE(store.CreateFolder(stale));
+  ASSERT_TRUE(store.CreateOrUpdateTag({"keep", "", "{}"}));
+
+  ASSERT_TRUE(store.BeginBulkLoad());
+  ASSERT_FALSE(store.BeginBulkLoad());
+
+  StoreFolderRecord root;
+  root.id = "bulk-root-uuid";
+  root.parent_id = "";
+  root.name = "root";
+  root.created_utc = 1000;
+  root.modified_utc = 2000;
+  root.metadata = "{}";
+  ASSERT_TRUE(store.BulkAddFolder(root));
+  ASSERT_FALSE(store.BulkAddFolder(root));  // Duplicate
+
+  StoreFolderRecord orphan = root;
+  orphan.id = "bulk-orphan-uuid";
+  orphan.parent_id = "no-such-parent";
+  ASSERT_FALSE(store.BulkAddFolder(orphan));
+
+  // Enough folders and files to cross several insert batches
+  const int kFolders = 300;
+  const int kFilesPerFolder = 3;
+  for (int i = 0; i < kFolders; ++i) {
+    StoreFolderRecord sub;
+    sub.id = "bulk-sub-" + std::to_string(i);
+    sub.parent_id = i % 2 == 0 ? "bulk-root-uuid" : "bulk-sub-" + std::to_string(i - 1);
+    sub.name = "sub" + std::to_string(i);
+    sub.created_utc = 1000 + i;
+    sub.modified_utc = 2000 + i;
+    sub.metadata = "{}";
+    ASSERT_TRUE(store.BulkAddFolder(sub));
+
+    for (int j = 0; j < kFilesPerFolder; ++j) {
+      StoreFileRecord file;
+      file.id = sub.id + "-file-" + std::to_string(j);
+      file.folder_id = sub.id;
+      file.name = "note" + std::to_string(j) + ".md";
+      file.created_utc = 3000;
+      file.modified_utc = 4000;
+      file.metadata = "{\"n\":" + std::to_string(j) + "}";
+      file.tags = {j == 0 ? "keep" : "new", "all"};
+      if (j == 1) {
+        file.attachments = {"a.png"};
+      }
+      ASSERT_TRUE(store.BulkAddFile(file));
+    }
+  }
+
+  StoreFileRecord stray;
+  stray.id = "bulk-stray-file";
+  stray.folder_id = "bulk-orphan-uuid";
+  stray.name = "stray.md";
+  stray.created_utc = 0;
+  stray.modified_utc = 0;
+  stray.metadata = "{}";
+  ASSERT_FALSE(store.BulkAddFile(stray));
+
+  ASSERT_TRUE(store.EndBulkLoad());
+  ASSERT_FALSE(store.EndBulkLoad());
+
+  ASSERT_FALSE(store.GetFolder("bulk-stale-uuid").has_value());
+  ASSERT_FALSE(store.GetFolder("bulk-orphan-uuid").has_value());
+
+  // Paths are materialized for nested folders
+  auto nested = store.GetFolderByPath("root/sub0/sub1");
+  ASSERT_TRUE(nested.has_value());
+  ASSERT_EQ(nested->id, std::string("bulk-sub-1"));
+  ASSERT_EQ(store.GetFolderPath("bulk-sub-1"), std::string("root/sub0/sub1"));
+
+  auto file = store.GetFile("bulk-sub-1-file-1");
+  ASSERT_TRUE(file.has_value());
+  ASSERT_EQ(file->folder_id, std::string("bulk-sub-1"));
+  ASSERT_EQ(file->metadata, std::string("{\"n\":1}"));
+  ASSERT_EQ(file->attachments.size(), 1u);
+  ASSERT_EQ(file->tags.size(), 2u);
+
+  ASSERT_EQ(store.ListFiles("bulk-sub-7").size(), static_cast<size_t>(kFilesPerFolder));
+  ASSERT_EQ(store.FindFilesByTagsAnd({"keep", "all"}).size(), static_cast<size_t>(kFolders));
+  ASSERT_EQ(store.FindFilesByTagsOr({"new"}).size(),
+            static_cast<size_t>(kFolders * (kFilesPerFolder - 1)));
+
+  // Indexes were rebuilt and the store keeps working normally
+  ASSERT_TRUE(store.GetFolderByPath("root").has_value());
+  StoreFolderRecord after = root;
+  after.id = "bulk-after-uuid";
+  after.parent_id = "bulk-root-uuid";
+  after.name = "after";
+  ASSERT_TRUE(store.CreateFolder(after));
+  ASSERT_TRUE(store.GetFolderByPath("root/after").has_value());
+
+  store.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_bulk_load passed" << std::endl;
+  return 0;
+}
+
+int test_metadata_store_folder_config_stamps() {
+  std::cout << "  Running test_metadata_store_folder_config_stamps..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+
+  StoreFolderRecord root;
+  root.id = "stamp-root-uuid";
+  root.parent_id = "";
+  root.name = ".";
+  root.created_utc = 1000;
+  root.modified_utc = 2000;
+  root.metadata = "{}";
+  ASSERT_TRUE(store.CreateFolder(root));
+
+  StoreFolderRecord sub = root;
+  sub.id = "stamp-sub-uuid";
+  sub.parent_id = "stamp-root-uuid";
+  sub.name = "notes";
+  ASSERT_TRUE(store.CreateFolder(sub));
+
+  // Unstamped folders are still listed
+  auto stamps = store.ListFolderConfigStamps();
+  ASSERT_EQ(stamps.size(), 2u);
+  ASSERT_EQ(stamps[0].folder_path, std::string(""));
+  ASSERT_EQ(stamps[1].folder_path, std::string("notes"));
+  ASSERT_EQ(stamps[1].mtime_utc, -1);
+  ASSERT_TRUE(stamps[1].hash.empty());
+
+  ASSERT_TRUE(store.SetFolderConfigStamp("stamp-sub-uuid", 111, 222, "abc"));
+  ASSERT_TRUE(store.SetFolderConfigStamp("stamp-sub-uuid", 333, 444, "def"));
+  ASSERT_FALSE(store.SetFolderConfigStamp("no-such-folder", 1, 1, "x"));
+
+  stamps = store.ListFolderConfigStamps();
+  ASSERT_EQ(stamps[1].folder_id, std::string("stamp-sub-uuid"));
+  ASSERT_EQ(stamps[1].mtime_utc, 333);
+  ASSERT_EQ(stamps[1].size, 444);
+  ASSERT_EQ(stamps[1].hash, std::string("def"));
+
+  // Stamps go away with their folder
+  ASSERT_TRUE(store.DeleteFolder("stamp-sub-uuid"));
+  ASSERT_TRUE(store.CreateFolder(sub));
+  stamps = store.ListFolderConfigStamps();
+  ASSERT_EQ(stamps.size(), 2u);
+  ASSERT_TRUE(stamps[1].hash.empty());
+
+  store.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_folder_config_stamps passed" << std::endl;
+  return 0;
+}
+
 // ============================================================================
 // IterateAllFiles Test
 // ============================================================================
@@ -1037,6 +1602,407 @@ int test_metadata_store_iterate_all_files() {
   return 0;
 }
 
+int test_metadata_store_batch_lookups() {
+  std::cout << "  Running test_metadata_store_batch_lookups..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+
+  // Production layout: a "." root folder holding everything else
+  StoreFolderRecord root;
+  root.id = "batch-root";
+  root.parent_id = "";
+  root.name = ".";
+  root.created_utc = 0;
+  root.modified_utc = 0;
+  root.metadata = "{}";
+  ASSERT_TRUE(store.CreateFolder(root));
+
+  StoreFolderRecord notes = root;
+  notes.id = "batch-notes";
+  notes.parent_id = "batch-root";
+  notes.name = "notes";
+  ASSERT_TRUE(store.CreateFolder(notes));
+
+  StoreFileRecord top;
+  top.id = "batch-top";
+  top.folder_id = "batch-root";
+  top.name = "top.md";
+  top.created_utc = 1;
+  top.modified_utc = 2;
+  top.metadata = "{}";
+  top.tags = {"b", "a"};
+  ASSERT_TRUE(store.CreateFile(top));
+
+  // More files than one batch query takes
+  const int kFiles = 300;
+  for (int i = 0; i < kFiles; ++i) {
+    StoreFileRecord file = top;
+    file.id = "batch-file-" + std::to_string(i);
+    file.folder_id = "batch-notes";
+    file.name = "n" + std::to_string(i) + ".md";
+    file.tags = {};
+    ASSERT_TRUE(store.CreateFile(file));
+  }
+
+  // Files by id: aligned with the input, duplicates and unknown ids included
+  std::vector<std::string> ids = {"batch-top", "missing", "batch-file-7", "batch-top"};
+  for (int i = 0; i < kFiles; ++i) {
+    ids.push_back("batch-file-" + std::to_string(i));
+  }
+  auto files = store.GetFilesByIds(ids);
+  ASSERT_EQ(files.size(), ids.size());
+  ASSERT_TRUE(files[0].has_value());
+  ASSERT_EQ(files[0]->name, std::string("top.md"));
+  ASSERT_EQ(files[0]->folder_id, std::string("batch-root"));
+  ASSERT_EQ(files[0]->tags.size(), 2);
+  ASSERT_EQ(files[0]->tags[0], std::string("a"));
+  ASSERT_FALSE(files[1].has_value());
+  ASSERT_EQ(files[2]->name, std::string("n7.md"));
+  ASSERT_EQ(files[3]->id, std::string("batch-top"));
+  for (size_t i = 4; i < files.size(); ++i) {
+    ASSERT_TRUE(files[i].has_value());
+    ASSERT_EQ(files[i]->id, ids[i]);
+    ASSERT_EQ(files[i]->folder_id, std::string("batch-notes"));
+  }
+
+  // Node paths: same answers as GetNodePathById, folders included
+  ids = {"batch-notes", "batch-top", "missing", "batch-root"};
+  for (int i = 0; i < kFiles; ++i) {
+    ids.push_back("batch-file-" + std::to_string(i));
+  }
+  auto paths = store.GetNodePathsByIds(ids);
+  ASSERT_EQ(paths.size(), ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(paths[i], store.GetNodePathById(ids[i]));
+  }
+  ASSERT_EQ(paths[0], std::string("notes"));
+  ASSERT_EQ(paths[1], std::string("top.md"));
+  ASSERT_EQ(paths[2], std::string(""));
+  ASSERT_EQ(paths[4], std::string("notes/n0.md"));
+
+  // Files by path, including unclean and unknown paths
+  std::vector<std::string> lookup = {"top.md", "notes/n5.md", "notes//n6.md", "notes/nope.md",
+                                     "nowhere/n1.md", "notes"};
+  for (int i = 0; i < kFiles; ++i) {
+    lookup.push_back("notes/n" + std::to_string(i) + ".md");
+  }
+  files = store.GetFilesByPaths(lookup);
+  ASSERT_EQ(files.size(), lookup.size());
+  ASSERT_EQ(files[0]->id, std::string("batch-top"));
+  ASSERT_EQ(files[1]->id, std::string("batch-file-5"));
+  ASSERT_EQ(files[2]->id, std::string("batch-file-6"));
+  ASSERT_FALSE(files[3].has_value());
+  ASSERT_FALSE(files[4].has_value());
+  ASSERT_FALSE(files[5].has_value());
+  for (int i = 0; i < kFiles; ++i) {
+    ASSERT_EQ(files[6 + i]->id, "batch-file-" + std::to_string(i));
+  }
+
+  // Pooled readers answer the same way
+  auto reader = store.AcquireReader();
+  ASSERT_NOT_NULL(reader.get());
+  ASSERT_EQ(reader->GetNodePathsByIds({"batch-file-9"})[0], std::string("notes/n9.md"));
+
+  // Empty batches are fine
+  ASSERT_TRUE(store.GetFilesByIds({}).empty());
+  ASSERT_TRUE(store.GetFilesByPaths({}).empty());
+
+  reader.reset();
+  store.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_batch_lookups passed" << std::endl;
+  return 0;
+}
+
+int test_metadata_store_iterate_all_files_order() {
+  std::cout << "  Running test_metadata_store_iterate_all_files_order..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+
+  auto make_folder = [&](const std::string& id, const std::string& parent,
+                         const std::string& name) {
+    StoreFolderRecord folder;
+    folder.id = id;
+    folder.parent_id = parent;
+    folder.name = name;
+    folder.created_utc = 1000;
+    folder.modified_utc = 2000;
+    folder.metadata = "{}";
+    return store.CreateFolder(folder);
+  };
+  auto make_file = [&](const std::string& id, const std::string& folder, const std::string& name,
+                       const std::vector<std::string>& tags) {
+    StoreFileRecord file;
+    file.id = id;
+    file.folder_id = folder;
+    file.name = name;
+    file.created_utc = 1000;
+    file.modified_utc = 2000;
+    file.metadata = "{}";
+    file.tags = tags;
+    return store.CreateFile(file);
+  };
+
+  // "a-c" sorts before "a/b" as a string, but a depth-first walk visits a/b first
+  ASSERT_TRUE(make_folder("f-a", "", "a"));
+  ASSERT_TRUE(make_folder("f-ac", "", "a-c"));
+  ASSERT_TRUE(make_folder("f-ab", "f-a", "b"));
+  ASSERT_TRUE(make_file("n3", "f-ac", "z.md", {}));
+  ASSERT_TRUE(make_file("n2", "f-ab", "y.md", {"beta", "alpha"}));
+  ASSERT_TRUE(make_file("n1", "f-a", "x.md", {"gamma"}));
+  ASSERT_TRUE(make_file("n0", "f-a", "w.md", {}));
+
+  std::vector<std::string> paths;
+  std::vector<std::string> folder_ids;
+  std::vector<std::vector<std::string>> tags;
+  store.IterateAllFiles([&](const std::string& path, const StoreFileRecord& record) {
+    paths.push_back(path);
+    folder_ids.push_back(record.folder_id);
+    tags.push_back(record.tags);
+    return true;
+  });
+
+  ASSERT_EQ(paths.size(), 4);
+  ASSERT_EQ(paths[0], "a/w.md");
+  ASSERT_EQ(paths[1], "a/x.md");
+  ASSERT_EQ(paths[2], "a/b/y.md");
+  ASSERT_EQ(paths[3], "a-c/z.md");
+  ASSERT_EQ(folder_ids[2], "f-ab");
+  ASSERT_EQ(tags[0].size(), 0);
+  ASSERT_EQ(tags[1].size(), 1);
+  ASSERT_EQ(tags[2].size(), 2);
+  ASSERT_EQ(tags[2][0], "alpha");
+  ASSERT_EQ(tags[2][1], "beta");
+
+  // Returning false stops the whole iteration, not just the current folder
+  int visited = 0;
+  store.IterateAllFiles([&](const std::string&, const StoreFileRecord&) {
+    ++visited;
+    return visited < 2;
+  });
+  ASSERT_EQ(visited, 2);
+
+  store.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_iterate_all_files_order passed" << std::endl;
+  return 0;
+}
+
+// ============================================================================
+// Concurrent Reader Tests
+// ============================================================================
+
+int test_metadata_store_concurrent_readers() {
+  std::cout << "  Running test_metadata_store_concurrent_readers..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+
+  StoreFolderRecord folder;
+  folder.id = "reader-folder-uuid";
+  folder.parent_id = "";
+  folder.name = "folder";
+  folder.created_utc = 1000;
+  folder.modified_utc = 2000;
+  folder.metadata = "{}";
+  ASSERT_TRUE(store.CreateFolder(folder));
+
+  for (int i = 0; i < 40; ++i) {
+    StoreFileRecord file;
+    file.id = "reader-file-" + std::to_string(i);
+    file.folder_id = folder.id;
+    file.name = "file" + std::to_string(i) + ".md";
+    file.created_utc = 1000 + i;
+    file.modified_utc = 2000 + i;
+    file.metadata = "{}";
+    file.tags = {i % 2 == 0 ? "even" : "odd"};
+    ASSERT_TRUE(store.CreateFile(file));
+  }
+
+  // Readers query on worker threads while the owner keeps writing.
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&store, &failures] {
+      for (int round = 0; round < 50; ++round) {
+        auto reader = store.AcquireReader();
+        if (!reader) {
+          ++failures;
+          return;
+        }
+        if (reader->FindFilesByTagsOr({"even"}).size() != 20) ++failures;
+        if (reader->ListFiles("reader-folder-uuid").size() < 40) ++failures;
+        auto file = reader->GetFileByPath("folder/file7.md");
+        if (!file || file->tags != std::vector<std::string>{"odd"}) ++failures;
+      }
+    });
+  }
+  for (int i = 0; i < 20; ++i) {
+    StoreFileRecord file;
+    file.id = "reader-late-" + std::to_string(i);
+    file.folder_id = folder.id;
+    file.name = "late" + std::to_string(i) + ".md";
+    file.created_utc = 3000;
+    file.modified_utc = 3000;
+    file.metadata = "{}";
+    file.tags = {"late"};
+    ASSERT_TRUE(store.CreateFile(file));
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(failures.load(), 0);
+
+  // Readers see committed data only.
+  auto reader = store.AcquireReader();
+  ASSERT_NOT_NULL(reader.get());
+  ASSERT_EQ(reader->FindFilesByTagsOr({"late"}).size(), 20);
+
+  ASSERT_TRUE(store.BeginTransaction());
+  StoreFileRecord pending;
+  pending.id = "reader-pending";
+  pending.folder_id = folder.id;
+  pending.name = "pending.md";
+  pending.created_utc = 4000;
+  pending.modified_utc = 4000;
+  pending.metadata = "{}";
+  pending.tags = {"pending"};
+  ASSERT_TRUE(store.CreateFile(pending));
+  ASSERT_EQ(store.FindFilesByTagsOr({"pending"}).size(), 1);
+  ASSERT_EQ(reader->FindFilesByTagsOr({"pending"}).size(), 0);
+  ASSERT_TRUE(store.CommitTransaction());
+  ASSERT_EQ(reader->FindFilesByTagsOr({"pending"}).size(), 1);
+
+  // A reader may outlive the store's Close(); new ones are refused.
+  store.Close();
+  ASSERT_NULL(store.AcquireReader().get());
+  ASSERT_EQ(reader->CountFilesByTag().size(), 4);
+  reader.reset();
+
+  // In-memory stores have no pool; callers fall back to the store.
+  SqliteMetadataStore memory_store;
+  ASSERT_TRUE(memory_store.Open(":memory:"));
+  ASSERT_NULL(memory_store.AcquireReader().get());
+  memory_store.Close();
+
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_concurrent_readers passed" << std::endl;
+  return 0;
+}
+
+// ============================================================================
+// Write-Behind Tests
+// ============================================================================
+
+static StoreFileRecord make_write_behind_file(const std::string &folder_id, int i) {
+  StoreFileRecord file;
+  file.id = "wb-file-" + std::to_string(i);
+  file.folder_id = folder_id;
+  file.name = "wb" + std::to_string(i) + ".md";
+  file.created_utc = 1000;
+  file.modified_utc = 1000;
+  file.metadata = "{}";
+  file.tags = {"wb"};
+  return file;
+}
+
+int test_metadata_store_write_behind() {
+  std::cout << "  Running test_metadata_store_write_behind..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+
+  WriteBehindOptions options;
+  options.enabled = true;
+  options.max_pending_writes = 3;
+  options.max_delay = std::chrono::hours(1);
+  store.SetWriteBehind(options);
+  ASSERT_FALSE(store.HasPendingWrites());
+
+  StoreFolderRecord folder;
+  folder.id = "wb-folder-uuid";
+  folder.parent_id = "";
+  folder.name = "wb";
+  folder.created_utc = 1000;
+  folder.modified_utc = 1000;
+  folder.metadata = "{}";
+  ASSERT_TRUE(store.CreateFolder(folder));
+  ASSERT_TRUE(store.CreateFile(make_write_behind_file(folder.id, 0)));
+  ASSERT_TRUE(store.CreateFile(make_write_behind_file(folder.id, 1)));
+  ASSERT_TRUE(store.HasPendingWrites());
+
+  // The store sees its pending writes; pooled readers see committed data only.
+  ASSERT_EQ(store.ListFiles(folder.id).size(), 2);
+  ASSERT_TRUE(store.GetFileByPath("wb/wb1.md").has_value());
+  auto reader = store.AcquireReader();
+  ASSERT_NOT_NULL(reader.get());
+  ASSERT_EQ(reader->ListFiles(folder.id).size(), 0);
+
+  // The batch is full, so the next write commits it before opening another.
+  ASSERT_TRUE(store.CreateFile(make_write_behind_file(folder.id, 2)));
+  ASSERT_TRUE(store.HasPendingWrites());
+  ASSERT_EQ(reader->ListFiles(folder.id).size(), 2);
+  ASSERT_TRUE(store.FlushPendingWritesIfDue());
+  ASSERT_TRUE(store.HasPendingWrites());
+  ASSERT_TRUE(store.FlushPendingWrites());
+  ASSERT_FALSE(store.HasPendingWrites());
+  ASSERT_EQ(reader->ListFiles(folder.id).size(), 3);
+
+  // An explicit transaction commits the batch first and is not batched itself.
+  ASSERT_TRUE(store.AddTagToFile("wb-file-0", "extra"));
+  ASSERT_TRUE(store.HasPendingWrites());
+  ASSERT_TRUE(store.BeginTransaction());
+  ASSERT_FALSE(store.HasPendingWrites());
+  ASSERT_EQ(reader->FindFilesByTagsOr({"extra"}).size(), 1);
+  ASSERT_TRUE(store.DeleteFile("wb-file-2"));
+  ASSERT_FALSE(store.HasPendingWrites());
+  ASSERT_TRUE(store.RollbackTransaction());
+  ASSERT_TRUE(store.GetFile("wb-file-2").has_value());
+
+  // A batch past its delay is due.
+  options.max_delay = std::chrono::milliseconds(0);
+  store.SetWriteBehind(options);
+  ASSERT_TRUE(store.UpdateFile("wb-file-1", "renamed.md", 2000, "{}"));
+  ASSERT_TRUE(store.HasPendingWrites());
+  ASSERT_TRUE(store.FlushPendingWritesIfDue());
+  ASSERT_FALSE(store.HasPendingWrites());
+
+  // Close commits whatever is pending.
+  options.max_delay = std::chrono::hours(1);
+  store.SetWriteBehind(options);
+  ASSERT_TRUE(store.CreateFile(make_write_behind_file(folder.id, 3)));
+  ASSERT_TRUE(store.HasPendingWrites());
+  reader.reset();
+  store.Close();
+  ASSERT_TRUE(store.Open(test_db_path));
+  ASSERT_EQ(store.ListFiles(folder.id).size(), 4);
+  ASSERT_TRUE(store.GetFileByPath("wb/renamed.md").has_value());
+
+  // Bulk loads run with the batch closed.
+  store.SetWriteBehind(options);
+  ASSERT_TRUE(store.CreateFile(make_write_behind_file(folder.id, 4)));
+  ASSERT_TRUE(store.BeginBulkLoad());
+  ASSERT_FALSE(store.HasPendingWrites());
+  ASSERT_TRUE(store.BulkAddFolder(folder));
+  ASSERT_TRUE(store.EndBulkLoad());
+  ASSERT_EQ(store.ListFiles(folder.id).size(), 0);
+
+  store.Close();
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_write_behind passed" << std::endl;
+  return 0;
+}
+
 // ============================================================================
 // Error Handling Tests
 // ============================================================================
@@ -1101,6 +2067,74 @@ int test_metadata_store_not_open_errors() {
   return 0;
 }
 
+// ============================================================================
+// File History Tests
+// ============================================================================
+
+int test_metadata_store_file_history() {
+  std::cout << "  Running test_metadata_store_file_history..." << std::endl;
+
+  setup_test_db();
+
+  SqliteMetadataStore store;
+  ASSERT_TRUE(store.Open(test_db_path));
+  ASSERT_TRUE(store.GetFileHistory(0).empty());
+
+  auto ids = [](const std::vector<StoreHistoryEntry> &entries) {
+    std::vector<std::string> result;
+    for (const auto &entry : entries) {
+      result.push_back(entry.file_id);
+    }
+    return result;
+  };
+
+  // Opens within the same millisecond keep their order.
+  ASSERT_TRUE(store.RecordFileOpen("a", 1000, 3));
+  ASSERT_TRUE(store.RecordFileOpen("b", 1000, 3));
+  ASSERT_TRUE(store.RecordFileOpen("c", 2000, 3));
+  ASSERT_TRUE(store.RecordFileOpen("a", 2000, 3));
+  auto history = store.GetFileHistory(0);
+  ASSERT_TRUE(ids(history) == std::vector<std::string>({"a", "c", "b"}));
+  ASSERT_EQ(history[0].opened_utc, 2000);
+  ASSERT_EQ(history[0].open_count, 2);
+  ASSERT_EQ(history[2].open_count, 1);
+  ASSERT_TRUE(ids(store.GetFileHistory(2)) == std::vector<std::string>({"a", "c"}));
+
+  // A new entry beyond the cap evicts the least recent one.
+  ASSERT_TRUE(store.RecordFileOpen("d", 3000, 3));
+  ASSERT_TRUE(ids(store.GetFileHistory(0)) == std::vector<std::string>({"d", "a", "c"}));
+
+  // History is not derived from the configs: rebuilds keep it.
+  ASSERT_TRUE(store.RebuildAll());
+  ASSERT_TRUE(store.BeginBulkLoad());
+  ASSERT_TRUE(store.EndBulkLoad());
+  ASSERT_EQ(store.GetFileHistory(0).size(), static_cast<size_t>(3));
+
+  ASSERT_TRUE(store.ClearFileHistory());
+  ASSERT_TRUE(store.GetFileHistory(0).empty());
+
+  // The JSON array that used to hold the history is imported on open.
+  ASSERT_TRUE(store.SetNotebookMetadata(
+      "history",
+      R"([{"fileId": "y", "openedUtc": 500}, {"fileId": "x", "openedUtc": 500}, 7,)"
+      R"( {"fileId": "w", "openedUtc": 100}, {"fileId": ""}])"));
+  store.Close();
+  ASSERT_TRUE(store.Open(test_db_path));
+  history = store.GetFileHistory(0);
+  ASSERT_TRUE(ids(history) == std::vector<std::string>({"y", "x", "w"}));
+  ASSERT_EQ(history[2].opened_utc, 100);
+  ASSERT_EQ(history[2].open_count, 1);
+  ASSERT_FALSE(store.GetNotebookMetadata("history").has_value());
+
+  store.Close();
+  ASSERT_FALSE(store.RecordFileOpen("a", 1000, 0));
+  ASSERT_FALSE(store.ClearFileHistory());
+
+  cleanup_test_db();
+  std::cout << "  ✓ test_metadata_store_file_history passed" << std::endl;
+  return 0;
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -1134,13 +2168,29 @@ int main() {
   // Tag tests
   RUN_TEST(test_metadata_store_file_tags);
   RUN_TEST(test_metadata_store_find_files_by_tags);
+  RUN_TEST(test_metadata_store_tag_filter);
   RUN_TEST(test_metadata_store_tag_definitions);
+  RUN_TEST(test_metadata_store_tag_hierarchy_queries);
+  RUN_TEST(test_metadata_store_metadata_queries);
 
   // RebuildAll test
   RUN_TEST(test_metadata_store_rebuild_all);
+  RUN_TEST(test_metadata_store_bulk_load);
+  RUN_TEST(test_metadata_store_folder_config_stamps);
+
+  // File history test
+  RUN_TEST(test_metadata_store_file_history);
 
   // IterateAllFiles test
   RUN_TEST(test_metadata_store_iterate_all_files);
+  RUN_TEST(test_metadata_store_iterate_all_files_order);
+  RUN_TEST(test_metadata_store_batch_lookups);
+
+  // Concurrent reader test
+  RUN_TEST(test_metadata_store_concurrent_readers);
+
+  // Write-behind test
+  RUN_TEST(test_metadata_store_write_behind);
 
   // Error handling tests
   RUN_TEST(test_metadata_store_not_found_errors);
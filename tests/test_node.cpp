@@ -302,6 +302,7 @@ int test_node_move_file() {
   char *file_id = nullptr;
   err = vxcore_file_create(ctx, notebook_id, ".", "move_me.md", &file_id);
   ASSERT_EQ(err, VXCORE_OK);
+  const std::string moved_id = file_id;
   vxcore_string_free(file_id);
 
   // Move using node API
@@ -321,8 +322,18 @@ int test_node_move_file() {
   nlohmann::json config = nlohmann::json::parse(config_json);
   ASSERT(config["type"] == "file");
   ASSERT(config["name"] == "move_me.md");
-
+  ASSERT(config["id"] == moved_id);
   vxcore_string_free(config_json);
+
+  // The metadata store sees the file under its new folder too.
+  char *paths_json = nullptr;
+  err = vxcore_node_get_paths_by_ids(ctx, notebook_id, ("[\"" + moved_id + "\"]").c_str(),
+                                     &paths_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  ASSERT(nlohmann::json::parse(paths_json) ==
+         nlohmann::json::array({"target_folder/move_me.md"}));
+  vxcore_string_free(paths_json);
+
   vxcore_string_free(notebook_id);
   vxcore_context_destroy(ctx);
   cleanup_test_dir(get_test_path("test_node_move_file_nb"));
@@ -574,6 +585,115 @@ int test_node_metadata_folder() {
   return 0;
 }
 
+int test_node_batch() {
+  std::cout << "  Running test_node_batch..." << std::endl;
+  cleanup_test_dir(get_test_path("test_node_batch_nb"));
+
+  VxCoreContextHandle ctx = nullptr;
+  VxCoreError err = vxcore_context_create(nullptr, &ctx);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  err =
+      vxcore_notebook_create(ctx, get_test_path("test_node_batch_nb").c_str(),
+                             "{\"name\":\"Test Notebook\"}", VXCORE_NOTEBOOK_BUNDLED, &notebook_id);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *folder_id = nullptr;
+  err = vxcore_folder_create(ctx, notebook_id, ".", "target", &folder_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(folder_id);
+  err = vxcore_folder_create(ctx, notebook_id, ".", "old", &folder_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(folder_id);
+
+  nlohmann::json ops = nlohmann::json::array();
+  for (int i = 0; i < 5; ++i) {
+    const std::string name = "note" + std::to_string(i) + ".md";
+    char *file_id = nullptr;
+    err = vxcore_file_create(ctx, notebook_id, ".", name.c_str(), &file_id);
+    ASSERT_EQ(err, VXCORE_OK);
+    vxcore_string_free(file_id);
+    ops.push_back({{"op", "move"}, {"path", name}, {"dest", "target"}});
+  }
+  err = vxcore_tag_create(ctx, notebook_id, "work");
+  ASSERT_EQ(err, VXCORE_OK);
+
+  // Ops apply in order: the tag follows the moved note; failures do not
+  // stop the rest.
+  ops.push_back({{"op", "tag"}, {"path", "target/note0.md"}, {"tag", "work"}});
+  ops.push_back({{"op", "tag"}, {"path", "target/note1.md"}, {"tag", "work"}});
+  ops.push_back({{"op", "untag"}, {"path", "target/note1.md"}, {"tag", "work"}});
+  ops.push_back({{"op", "delete"}, {"path", "missing.md"}});
+  ops.push_back({{"op", "delete"}, {"path", "target/note4.md"}});
+  ops.push_back({{"op", "delete"}, {"path", "old"}});
+
+  char *results_json = nullptr;
+  err = vxcore_node_batch(ctx, notebook_id, ops.dump().c_str(), &results_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  ASSERT_NOT_NULL(results_json);
+  nlohmann::json results = nlohmann::json::parse(results_json);
+  vxcore_string_free(results_json);
+  ASSERT_EQ(results.size(), ops.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    ASSERT_EQ(results[i].get<int>(), i == 8 ? VXCORE_ERR_NOT_FOUND : VXCORE_OK);
+  }
+
+  char *config_json = nullptr;
+  err = vxcore_node_get_config(ctx, notebook_id, "note0.md", &config_json);
+  ASSERT_EQ(err, VXCORE_ERR_NOT_FOUND);
+  err = vxcore_node_get_config(ctx, notebook_id, "target/note4.md", &config_json);
+  ASSERT_EQ(err, VXCORE_ERR_NOT_FOUND);
+  err = vxcore_node_get_config(ctx, notebook_id, "old", &config_json);
+  ASSERT_EQ(err, VXCORE_ERR_NOT_FOUND);
+
+  err = vxcore_node_get_config(ctx, notebook_id, "target/note0.md", &config_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  nlohmann::json config = nlohmann::json::parse(config_json);
+  vxcore_string_free(config_json);
+  ASSERT_EQ(config["tags"].size(), 1u);
+  ASSERT(config["tags"][0] == "work");
+
+  err = vxcore_node_get_config(ctx, notebook_id, "target/note1.md", &config_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  config = nlohmann::json::parse(config_json);
+  vxcore_string_free(config_json);
+  ASSERT_EQ(config["tags"].size(), 0u);
+
+  // The batch reached vx.json on disk.
+  err = vxcore_notebook_close(ctx, notebook_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(notebook_id);
+  notebook_id = nullptr;
+  err = vxcore_notebook_open(ctx, get_test_path("test_node_batch_nb").c_str(), &notebook_id);
+  ASSERT_EQ(err, VXCORE_OK);
+  err = vxcore_node_get_config(ctx, notebook_id, "target/note3.md", &config_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(config_json);
+  err = vxcore_node_get_config(ctx, notebook_id, "note3.md", &config_json);
+  ASSERT_EQ(err, VXCORE_ERR_NOT_FOUND);
+
+  // Malformed batches are rejected before anything is applied.
+  err = vxcore_node_batch(ctx, notebook_id, "{}", &results_json);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+  err = vxcore_node_batch(ctx, notebook_id, "[{\"op\":\"move\",\"path\":\"target/note3.md\"}]",
+                          &results_json);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+  err = vxcore_node_batch(ctx, notebook_id, "[{\"op\":\"copy\",\"path\":\"x\"}]", &results_json);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+  err = vxcore_node_batch(ctx, notebook_id, "not json", &results_json);
+  ASSERT_EQ(err, VXCORE_ERR_JSON_PARSE);
+  err = vxcore_node_get_config(ctx, notebook_id, "target/note3.md", &config_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  vxcore_string_free(config_json);
+
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(get_test_path("test_node_batch_nb"));
+  std::cout << "  ✓ test_node_batch passed" << std::endl;
+  return 0;
+}
+
 int test_node_invalid_params() {
   std::cout << "  Running test_node_invalid_params..." << std::endl;
   cleanup_test_dir(get_test_path("test_node_invalid_nb"));
@@ -631,6 +751,7 @@ int main() {
   RUN_TEST(test_node_copy_folder);
   RUN_TEST(test_node_metadata_file);
   RUN_TEST(test_node_metadata_folder);
+  RUN_TEST(test_node_batch);
   RUN_TEST(test_node_invalid_params);
 
   std::cout << "✓ All unified node API tests passed!" << std::endl;
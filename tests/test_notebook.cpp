@@ -1,5 +1,11 @@
+#include <atomic>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <nlohmann/json.hpp>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "test_utils.h"
 #include "vxcore/vxcore.h"
@@ -276,6 +282,439 @@ int test_notebook_rebuild_cache() {
   return 0;
 }
 
+int test_notebook_rebuild_cache_parallel() {
+  std::cout << "  Running test_notebook_rebuild_cache_parallel..." << std::endl;
+  const std::string nb_path = get_test_path("test_nb_rebuild_parallel");
+  cleanup_test_dir(nb_path);
+
+  VxCoreContextHandle ctx = nullptr;
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  ASSERT_EQ(vxcore_notebook_create(ctx, nb_path.c_str(), "{\"name\":\"Parallel Rebuild\"}",
+                                   VXCORE_NOTEBOOK_BUNDLED, &notebook_id),
+            VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_create(ctx, notebook_id, "leaf"), VXCORE_OK);
+
+  // 4 top-level folders x 3 subfolders x 2 files; one file per subfolder tagged.
+  for (int i = 0; i < 4; ++i) {
+    const std::string top = "top" + std::to_string(i);
+    char *id = nullptr;
+    ASSERT_EQ(vxcore_folder_create(ctx, notebook_id, ".", top.c_str(), &id), VXCORE_OK);
+    vxcore_string_free(id);
+    for (int j = 0; j < 3; ++j) {
+      const std::string sub = "sub" + std::to_string(j);
+      ASSERT_EQ(vxcore_folder_create(ctx, notebook_id, top.c_str(), sub.c_str(), &id),
+                VXCORE_OK);
+      vxcore_string_free(id);
+      const std::string sub_path = top + "/" + sub;
+      for (int k = 0; k < 2; ++k) {
+        const std::string name = "note" + std::to_string(k) + ".md";
+        ASSERT_EQ(vxcore_file_create(ctx, notebook_id, sub_path.c_str(), name.c_str(), &id),
+                  VXCORE_OK);
+        vxcore_string_free(id);
+      }
+      ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, (sub_path + "/note0.md").c_str(), "leaf"),
+                VXCORE_OK);
+    }
+  }
+
+  std::string saved_id(notebook_id);
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+
+  // Fresh context: nothing is cached, so every vx.json goes through the queue.
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+  char *reopened_id = nullptr;
+  ASSERT_EQ(vxcore_notebook_open(ctx, nb_path.c_str(), &reopened_id), VXCORE_OK);
+  ASSERT_EQ(std::string(reopened_id), saved_id);
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> drainers;
+  for (int t = 0; t < 3; ++t) {
+    drainers.emplace_back([&] {
+      while (!stop.load()) {
+        vxcore_work_queue_process_next(ctx, "vxcore.rebuild", 5);
+      }
+    });
+  }
+  const VxCoreError rebuild_err = vxcore_notebook_rebuild_cache(ctx, reopened_id);
+  stop.store(true);
+  for (auto &t : drainers) {
+    t.join();
+  }
+  ASSERT_EQ(rebuild_err, VXCORE_OK);
+
+  char *stats_json = nullptr;
+  ASSERT_EQ(vxcore_work_queue_stats(ctx, "vxcore.rebuild", &stats_json), VXCORE_OK);
+  // The 4 + 12 folders below the root were all parsed on the queue.
+  const auto stats = nlohmann::json::parse(stats_json);
+  ASSERT(stats["processed"].get<int>() >= 16);
+  ASSERT_EQ(stats["rejected"].get<int>(), 0);
+  vxcore_string_free(stats_json);
+
+  char *results_json = nullptr;
+  ASSERT_EQ(vxcore_tag_find_files(ctx, reopened_id, "[\"leaf\"]", "OR", &results_json),
+            VXCORE_OK);
+  const std::string results(results_json);
+  ASSERT_NE(results.find("\"matchCount\":12"), std::string::npos);
+  ASSERT_NE(results.find("top3/sub2/note0.md"), std::string::npos);
+  vxcore_string_free(results_json);
+
+  vxcore_string_free(reopened_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(nb_path);
+  std::cout << "  ✓ test_notebook_rebuild_cache_parallel passed" << std::endl;
+  return 0;
+}
+
+int test_notebook_reconcile_cache() {
+  std::cout << "  Running test_notebook_reconcile_cache..." << std::endl;
+  const std::string nb_path = get_test_path("test_nb_reconcile");
+  cleanup_test_dir(nb_path);
+
+  VxCoreContextHandle ctx = nullptr;
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  ASSERT_EQ(vxcore_notebook_create(ctx, nb_path.c_str(), "{\"name\":\"Reconcile\"}",
+                                   VXCORE_NOTEBOOK_BUNDLED, &notebook_id),
+            VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_create(ctx, notebook_id, "pulled"), VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_create(ctx, notebook_id, "gone"), VXCORE_OK);
+
+  char *id = nullptr;
+  ASSERT_EQ(vxcore_folder_create(ctx, notebook_id, ".", "docs", &id), VXCORE_OK);
+  vxcore_string_free(id);
+  ASSERT_EQ(vxcore_folder_create(ctx, notebook_id, ".", "old", &id), VXCORE_OK);
+  vxcore_string_free(id);
+  for (const char *name : {"a.md", "b.md"}) {
+    ASSERT_EQ(vxcore_file_create(ctx, notebook_id, "docs", name, &id), VXCORE_OK);
+    vxcore_string_free(id);
+  }
+  ASSERT_EQ(vxcore_file_create(ctx, notebook_id, "old", "x.md", &id), VXCORE_OK);
+  vxcore_string_free(id);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "old/x.md", "gone"), VXCORE_OK);
+
+  // Rebuild records a stamp for every folder config
+  ASSERT_EQ(vxcore_notebook_rebuild_cache(ctx, notebook_id), VXCORE_OK);
+
+  // Simulate a pull: docs/vx.json gains a tag, "old" disappears entirely.
+  const std::string contents = nb_path + "/vx_notebook/contents";
+  {
+    std::ifstream in(contents + "/docs/vx.json");
+    nlohmann::json docs;
+    in >> docs;
+    for (auto &file : docs["files"]) {
+      if (file["name"] == "a.md") {
+        file["tags"].push_back("pulled");
+      }
+    }
+    in.close();
+    write_file(contents + "/docs/vx.json", docs.dump(2));
+  }
+  {
+    std::ifstream in(contents + "/vx.json");
+    nlohmann::json root;
+    in >> root;
+    in.close();
+    root["folders"] = nlohmann::json::array({"docs"});
+    write_file(contents + "/vx.json", root.dump(2));
+    remove_directory_recursive(contents + "/old");
+    remove_directory_recursive(nb_path + "/old");
+  }
+
+  ASSERT_EQ(vxcore_notebook_reconcile_cache(ctx, notebook_id), VXCORE_OK);
+
+  char *results_json = nullptr;
+  ASSERT_EQ(vxcore_tag_find_files(ctx, notebook_id, "[\"pulled\"]", "OR", &results_json),
+            VXCORE_OK);
+  auto results = nlohmann::json::parse(results_json);
+  vxcore_string_free(results_json);
+  ASSERT_EQ(results["matchCount"].get<int>(), 1);
+  ASSERT_EQ(results["matches"][0]["filePath"].get<std::string>(), std::string("docs/a.md"));
+
+  ASSERT_EQ(vxcore_tag_find_files(ctx, notebook_id, "[\"gone\"]", "OR", &results_json),
+            VXCORE_OK);
+  results = nlohmann::json::parse(results_json);
+  vxcore_string_free(results_json);
+  ASSERT_EQ(results["matchCount"].get<int>(), 0);
+
+  // The cached config was refreshed too
+  char *config_json = nullptr;
+  ASSERT_EQ(vxcore_node_get_config(ctx, notebook_id, "docs/a.md", &config_json), VXCORE_OK);
+  ASSERT_NE(std::string(config_json).find("pulled"), std::string::npos);
+  vxcore_string_free(config_json);
+
+  // Nothing changed since: a second pass is a no-op (its counts are checked in
+  // test_folder_manager_reconcile_rename_and_reuse).
+  ASSERT_EQ(vxcore_notebook_reconcile_cache(ctx, notebook_id), VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_find_files(ctx, notebook_id, "[\"pulled\"]", "OR", &results_json),
+            VXCORE_OK);
+  results = nlohmann::json::parse(results_json);
+  vxcore_string_free(results_json);
+  ASSERT_EQ(results["matchCount"].get<int>(), 1);
+
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(nb_path);
+  std::cout << "  ✓ test_notebook_reconcile_cache passed" << std::endl;
+  return 0;
+}
+
+int test_notebook_config_cache_budget() {
+  std::cout << "  Running test_notebook_config_cache_budget..." << std::endl;
+  const std::string nb_path = get_test_path("test_nb_config_cache");
+  cleanup_test_dir(nb_path);
+
+  VxCoreContextHandle ctx = nullptr;
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  ASSERT_EQ(vxcore_notebook_create(ctx, nb_path.c_str(), "{\"name\":\"Cache\"}",
+                                   VXCORE_NOTEBOOK_BUNDLED, &notebook_id),
+            VXCORE_OK);
+
+  auto get_stats = [&]() {
+    char *stats_json = nullptr;
+    nlohmann::json stats;
+    if (vxcore_notebook_get_config_cache_stats(ctx, notebook_id, &stats_json) == VXCORE_OK) {
+      stats = nlohmann::json::parse(stats_json);
+      vxcore_string_free(stats_json);
+    }
+    return stats;
+  };
+
+  auto stats = get_stats();
+  ASSERT_EQ(stats["budgetBytes"].get<int64_t>(), 32 * 1024 * 1024);
+
+  // 8 folders x 10 files, every config cached while unbounded.
+  ASSERT_EQ(vxcore_notebook_set_config_cache_budget(ctx, notebook_id, 0), VXCORE_OK);
+  for (int i = 0; i < 8; ++i) {
+    const std::string folder = "dir" + std::to_string(i);
+    char *id = nullptr;
+    ASSERT_EQ(vxcore_folder_create(ctx, notebook_id, ".", folder.c_str(), &id), VXCORE_OK);
+    vxcore_string_free(id);
+    for (int k = 0; k < 10; ++k) {
+      const std::string name = "note" + std::to_string(k) + ".md";
+      ASSERT_EQ(vxcore_file_create(ctx, notebook_id, folder.c_str(), name.c_str(), &id),
+                VXCORE_OK);
+      vxcore_string_free(id);
+    }
+  }
+  stats = get_stats();
+  ASSERT_EQ(stats["entries"].get<int>(), 9);
+  const int64_t all_bytes = stats["bytes"].get<int64_t>();
+  ASSERT(all_bytes > 0);
+  ASSERT_EQ(stats["pinned"].get<int>(), 0);
+
+  // A third of that budget evicts right away, least recently used first.
+  const int64_t budget = all_bytes / 3;
+  ASSERT_EQ(vxcore_notebook_set_config_cache_budget(ctx, notebook_id, budget), VXCORE_OK);
+  stats = get_stats();
+  ASSERT(stats["bytes"].get<int64_t>() <= budget);
+  ASSERT(stats["entries"].get<int>() < 9);
+  ASSERT(stats["evictions"].get<int>() > 0);
+
+  // Evicted folders are re-read on access, and changes to them stick.
+  ASSERT_EQ(vxcore_node_rename(ctx, notebook_id, "dir0/note0.md", "renamed.md"), VXCORE_OK);
+  for (int i = 0; i < 8; ++i) {
+    const std::string folder = "dir" + std::to_string(i);
+    char *config_json = nullptr;
+    ASSERT_EQ(vxcore_node_get_config(ctx, notebook_id, folder.c_str(), &config_json), VXCORE_OK);
+    auto config = nlohmann::json::parse(config_json);
+    vxcore_string_free(config_json);
+    ASSERT_EQ(config["files"].size(), 10u);
+    ASSERT(get_stats()["bytes"].get<int64_t>() <= budget);
+  }
+  char *config_json = nullptr;
+  ASSERT_EQ(vxcore_node_get_config(ctx, notebook_id, "dir0", &config_json), VXCORE_OK);
+  ASSERT_NE(std::string(config_json).find("renamed.md"), std::string::npos);
+  vxcore_string_free(config_json);
+
+  stats = get_stats();
+  ASSERT(stats["misses"].get<int>() > 0);
+  ASSERT(stats["peakBytes"].get<int64_t>() >= all_bytes);
+  ASSERT_EQ(stats["pinned"].get<int>(), 0);
+
+  ASSERT_EQ(vxcore_notebook_set_config_cache_budget(ctx, notebook_id, -1),
+            VXCORE_ERR_INVALID_PARAM);
+  char *stats_json = nullptr;
+  ASSERT_EQ(vxcore_notebook_get_config_cache_stats(ctx, "no-such-notebook", &stats_json),
+            VXCORE_ERR_NOT_FOUND);
+
+  vxcore_string_free(notebook_id);
+
+  // Raw notebooks keep no config cache.
+  const std::string raw_path = get_test_path("test_nb_config_cache_raw");
+  cleanup_test_dir(raw_path);
+  ASSERT_EQ(vxcore_notebook_create(ctx, raw_path.c_str(), "{\"name\":\"Raw\"}",
+                                   VXCORE_NOTEBOOK_RAW, &notebook_id),
+            VXCORE_OK);
+  ASSERT_EQ(vxcore_notebook_get_config_cache_stats(ctx, notebook_id, &stats_json),
+            VXCORE_ERR_UNSUPPORTED);
+  vxcore_string_free(notebook_id);
+
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(nb_path);
+  cleanup_test_dir(raw_path);
+  std::cout << "  ✓ test_notebook_config_cache_budget passed" << std::endl;
+  return 0;
+}
+
+int test_notebook_config_snapshot() {
+  std::cout << "  Running test_notebook_config_snapshot..." << std::endl;
+  const std::string nb_path = get_test_path("test_nb_config_snapshot");
+  cleanup_test_dir(nb_path);
+
+  VxCoreContextHandle ctx = nullptr;
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  ASSERT_EQ(vxcore_notebook_create(ctx, nb_path.c_str(), "{\"name\":\"Snapshot\"}",
+                                   VXCORE_NOTEBOOK_BUNDLED, &notebook_id),
+            VXCORE_OK);
+  const std::string saved_id(notebook_id);
+  vxcore_string_free(notebook_id);
+
+  char *id = nullptr;
+  ASSERT_EQ(vxcore_folder_create(ctx, saved_id.c_str(), ".", "docs", &id), VXCORE_OK);
+  vxcore_string_free(id);
+  ASSERT_EQ(vxcore_file_create(ctx, saved_id.c_str(), "docs", "alpha.md", &id), VXCORE_OK);
+  vxcore_string_free(id);
+  ASSERT_EQ(vxcore_file_create(ctx, saved_id.c_str(), "docs", "beta.md", &id), VXCORE_OK);
+  vxcore_string_free(id);
+  ASSERT_EQ(vxcore_node_update_metadata(ctx, saved_id.c_str(), "docs/alpha.md",
+                                        R"({"stars": 3, "owner": {"name": "kim"}})"),
+            VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_create(ctx, saved_id.c_str(), "draft"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, saved_id.c_str(), "docs/beta.md", "draft"), VXCORE_OK);
+
+  char *local_data = nullptr;
+  ASSERT_EQ(vxcore_context_get_data_path(ctx, VXCORE_DATA_LOCAL, &local_data), VXCORE_OK);
+  const std::string snapshot_path =
+      std::string(local_data) + "/notebooks/" + saved_id + "/folder_configs.snapshot";
+  vxcore_string_free(local_data);
+
+  // Shutting down leaves the snapshot behind.
+  vxcore_context_destroy(ctx);
+  ASSERT(path_exists(snapshot_path));
+
+  auto get_docs_config = [&](VxCoreContextHandle handle) {
+    nlohmann::json config;
+    char *config_json = nullptr;
+    if (vxcore_node_get_config(handle, saved_id.c_str(), "docs", &config_json) == VXCORE_OK) {
+      config = nlohmann::json::parse(config_json);
+      vxcore_string_free(config_json);
+    }
+    return config;
+  };
+  auto file_names = [](const nlohmann::json &config) {
+    std::vector<std::string> names;
+    for (const auto &file : config["files"]) {
+      names.push_back(file["name"].get<std::string>());
+    }
+    return names;
+  };
+
+  // Rename alpha.md behind the notebook's back, keeping the size and mtime.
+  const std::string docs_config = nb_path + "/vx_notebook/contents/docs/vx.json";
+  const auto docs_mtime = std::filesystem::last_write_time(docs_config);
+  std::string content;
+  {
+    std::ifstream in(docs_config, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  const auto pos = content.find("alpha.md");
+  ASSERT_NE(pos, std::string::npos);
+  content.replace(pos, 8, "gamma.md");
+  write_file(docs_config, content);
+  std::filesystem::last_write_time(docs_config, docs_mtime);
+
+  // Same stat values: served from the snapshot, so the JSON was not parsed.
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+  auto config = get_docs_config(ctx);
+  ASSERT_TRUE(file_names(config) == (std::vector<std::string>{"alpha.md", "beta.md"}));
+  ASSERT_EQ(config["files"][0]["metadata"]["owner"]["name"].get<std::string>(), "kim");
+  ASSERT_EQ(config["files"][0]["metadata"]["stars"].get<int>(), 3);
+  ASSERT_EQ(config["files"][1]["tags"][0].get<std::string>(), "draft");
+  vxcore_context_destroy(ctx);
+
+  // A changed mtime invalidates the record.
+  std::filesystem::last_write_time(docs_config, docs_mtime + std::chrono::seconds(5));
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+  config = get_docs_config(ctx);
+  ASSERT_TRUE(file_names(config) == (std::vector<std::string>{"gamma.md", "beta.md"}));
+  vxcore_context_destroy(ctx);
+
+  // A corrupt snapshot is ignored.
+  write_file(snapshot_path, "VXFCSNAP garbage");
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+  config = get_docs_config(ctx);
+  ASSERT_TRUE(file_names(config) == (std::vector<std::string>{"gamma.md", "beta.md"}));
+  ASSERT_EQ(config["files"][0]["metadata"]["stars"].get<int>(), 3);
+  vxcore_context_destroy(ctx);
+
+  cleanup_test_dir(nb_path);
+  std::cout << "  ✓ test_notebook_config_snapshot passed" << std::endl;
+  return 0;
+}
+
+int test_notebook_write_behind() {
+  std::cout << "  Running test_notebook_write_behind..." << std::endl;
+  const std::string nb_path = get_test_path("test_nb_write_behind");
+  cleanup_test_dir(nb_path);
+
+  VxCoreContextHandle ctx = nullptr;
+  ASSERT_EQ(vxcore_context_create(nullptr, &ctx), VXCORE_OK);
+  ASSERT_EQ(vxcore_context_update_config(
+                ctx, R"({"database": {"writeBehind": true, "writeBehindMaxPending": 1000,
+                                      "writeBehindDelayMs": 3600000}})"),
+            VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  ASSERT_EQ(vxcore_notebook_create(ctx, nb_path.c_str(), "{\"name\":\"WriteBehind\"}",
+                                   VXCORE_NOTEBOOK_BUNDLED, &notebook_id),
+            VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_create(ctx, notebook_id, "batched"), VXCORE_OK);
+
+  char *id = nullptr;
+  for (const char *name : {"a.md", "b.md", "c.md"}) {
+    ASSERT_EQ(vxcore_file_create(ctx, notebook_id, ".", name, &id), VXCORE_OK);
+    vxcore_string_free(id);
+  }
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "a.md", "batched"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "c.md", "batched"), VXCORE_OK);
+
+  // Queries see the uncommitted batch.
+  char *results_json = nullptr;
+  ASSERT_EQ(vxcore_tag_find_files(ctx, notebook_id, "[\"batched\"]", "OR", &results_json),
+            VXCORE_OK);
+  auto results = nlohmann::json::parse(results_json);
+  vxcore_string_free(results_json);
+  ASSERT_EQ(results["matchCount"].get<int>(), 2);
+
+  // Committed batches and a fresh one read the same way.
+  ASSERT_EQ(vxcore_db_flush_pending_writes(ctx), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "b.md", "batched"), VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_find_files(ctx, notebook_id, "[\"batched\"]", "OR", &results_json),
+            VXCORE_OK);
+  results = nlohmann::json::parse(results_json);
+  vxcore_string_free(results_json);
+  ASSERT_EQ(results["matchCount"].get<int>(), 3);
+  ASSERT_EQ(vxcore_db_flush_pending_writes(ctx), VXCORE_OK);
+
+  // Later tests share vxcore.json.
+  ASSERT_EQ(vxcore_context_update_config(ctx, R"({"database": {"writeBehind": false}})"),
+            VXCORE_OK);
+
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(nb_path);
+  std::cout << "  ✓ test_notebook_write_behind passed" << std::endl;
+  return 0;
+}
+
 int test_tag_create_list() {
   std::cout << "  Running test_tag_create_list..." << std::endl;
   cleanup_test_dir(get_test_path("test_nb_tags"));
@@ -1819,6 +2258,11 @@ int main() {
   RUN_TEST(test_notebook_persistence);
   RUN_TEST(test_open_bundled_notebook_with_non_ascii_root);
   RUN_TEST(test_notebook_rebuild_cache);
+  RUN_TEST(test_notebook_rebuild_cache_parallel);
+  RUN_TEST(test_notebook_reconcile_cache);
+  RUN_TEST(test_notebook_config_cache_budget);
+  RUN_TEST(test_notebook_config_snapshot);
+  RUN_TEST(test_notebook_write_behind);
   RUN_TEST(test_notebook_ignored_config);
   RUN_TEST(test_notebook_ignored_empty_default);
   RUN_TEST(test_notebook_ignored_persistence);
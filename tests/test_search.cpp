@@ -3130,6 +3130,289 @@ int test_tag_find_files_invalid_params() {
   return 0;
 }
 
+int test_tag_query_files() {
+  std::cout << "  Running test_tag_query_files..." << std::endl;
+  cleanup_test_dir(get_test_path("test_tag_query"));
+
+  VxCoreContextHandle ctx = nullptr;
+  VxCoreError err = vxcore_context_create(nullptr, &ctx);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  err = vxcore_notebook_create(ctx, get_test_path("test_tag_query").c_str(),
+                               "{\"name\":\"Test Tag Query\"}", VXCORE_NOTEBOOK_BUNDLED,
+                               &notebook_id);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  // a: work + urgent, b: work, c: home + urgent, d: no tags
+  for (const char *name : {"a.md", "b.md", "c.md", "d.md"}) {
+    char *file_id = nullptr;
+    err = vxcore_file_create(ctx, notebook_id, ".", name, &file_id);
+    ASSERT_EQ(err, VXCORE_OK);
+    vxcore_string_free(file_id);
+  }
+  for (const char *tag : {"work", "home", "urgent"}) {
+    ASSERT_EQ(vxcore_tag_create(ctx, notebook_id, tag), VXCORE_OK);
+  }
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "a.md", "work"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "a.md", "urgent"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "b.md", "work"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "c.md", "home"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "c.md", "urgent"), VXCORE_OK);
+
+  auto query_names = [&](const char *query_json) {
+    std::vector<std::string> names;
+    char *results = nullptr;
+    if (vxcore_tag_query_files(ctx, notebook_id, query_json, &results) != VXCORE_OK) {
+      return std::vector<std::string>{"<error>"};
+    }
+    auto json = nlohmann::json::parse(results);
+    vxcore_string_free(results);
+    for (const auto &match : json["matches"]) {
+      names.push_back(match["fileName"].get<std::string>());
+    }
+    return names;
+  };
+
+  using Names = std::vector<std::string>;
+  ASSERT(query_names(R"({"allOf": ["work"], "noneOf": ["urgent"]})") == Names{"b.md"});
+  ASSERT(query_names(R"({"allOf": ["urgent"], "anyOf": ["work", "home"]})") ==
+         (Names{"a.md", "c.md"}));
+  ASSERT(query_names(R"({"noneOf": ["work"]})") == (Names{"c.md", "d.md"}));
+  ASSERT(query_names(R"({"anyOf": ["missing"]})").empty());
+  ASSERT(query_names("{}").empty());
+
+  char *results = nullptr;
+  err = vxcore_tag_query_files(ctx, notebook_id, "[\"work\"]", &results);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+  err = vxcore_tag_query_files(ctx, notebook_id, R"({"allOf": "work"})", &results);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+  err = vxcore_tag_query_files(ctx, notebook_id, R"({"allOf": [1]})", &results);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+  err = vxcore_tag_query_files(ctx, notebook_id, "{bad", &results);
+  ASSERT_EQ(err, VXCORE_ERR_JSON_PARSE);
+  ASSERT_NULL(results);
+
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(get_test_path("test_tag_query"));
+  std::cout << "  \xE2\x9C\x93 test_tag_query_files passed" << std::endl;
+  return 0;
+}
+
+int test_tag_hierarchy_queries() {
+  std::cout << "  Running test_tag_hierarchy_queries..." << std::endl;
+  cleanup_test_dir(get_test_path("test_tag_hierarchy"));
+
+  VxCoreContextHandle ctx = nullptr;
+  VxCoreError err = vxcore_context_create(nullptr, &ctx);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  err = vxcore_notebook_create(ctx, get_test_path("test_tag_hierarchy").c_str(),
+                               "{\"name\":\"Test Tag Hierarchy\"}", VXCORE_NOTEBOOK_BUNDLED,
+                               &notebook_id);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  // project -> {alpha, beta -> beta1}
+  ASSERT_EQ(vxcore_tag_create_path(ctx, notebook_id, "project/alpha"), VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_create_path(ctx, notebook_id, "project/beta/beta1"), VXCORE_OK);
+  ASSERT_EQ(vxcore_tag_create(ctx, notebook_id, "other"), VXCORE_OK);
+
+  // a: alpha, b: beta1, c: project + alpha, d: other
+  for (const char *name : {"a.md", "b.md", "c.md", "d.md"}) {
+    char *file_id = nullptr;
+    err = vxcore_file_create(ctx, notebook_id, ".", name, &file_id);
+    ASSERT_EQ(err, VXCORE_OK);
+    vxcore_string_free(file_id);
+  }
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "a.md", "alpha"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "b.md", "beta1"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "c.md", "project"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "c.md", "alpha"), VXCORE_OK);
+  ASSERT_EQ(vxcore_file_tag(ctx, notebook_id, "d.md", "other"), VXCORE_OK);
+
+  auto query_names = [&](const char *query_json) {
+    std::vector<std::string> names;
+    char *results = nullptr;
+    if (vxcore_tag_query_files(ctx, notebook_id, query_json, &results) != VXCORE_OK) {
+      return std::vector<std::string>{"<error>"};
+    }
+    auto json = nlohmann::json::parse(results);
+    vxcore_string_free(results);
+    for (const auto &match : json["matches"]) {
+      names.push_back(match["fileName"].get<std::string>());
+    }
+    return names;
+  };
+
+  using Names = std::vector<std::string>;
+  ASSERT(query_names(R"({"allOf": ["project"]})") == Names{"c.md"});
+  ASSERT(query_names(R"({"allOf": ["project"], "includeDescendants": true})") ==
+         (Names{"a.md", "b.md", "c.md"}));
+  ASSERT(query_names(R"({"anyOf": ["beta"], "includeDescendants": true})") == Names{"b.md"});
+  ASSERT(query_names(R"({"noneOf": ["project"], "includeDescendants": true})") ==
+         Names{"d.md"});
+
+  char *results = nullptr;
+  err = vxcore_tag_query_files(ctx, notebook_id, R"({"includeDescendants": 1})", &results);
+  ASSERT_EQ(err, VXCORE_ERR_INVALID_PARAM);
+
+  // Rolled-up counts
+  err = vxcore_tag_count_files_by_tag_subtree(ctx, notebook_id, &results);
+  ASSERT_EQ(err, VXCORE_OK);
+  auto counts = nlohmann::json::parse(results);
+  vxcore_string_free(results);
+  ASSERT(counts.is_array());
+  ASSERT_EQ(counts.size(), 5);
+  std::map<std::string, nlohmann::json> by_tag;
+  for (const auto &entry : counts) {
+    by_tag[entry["tag"].get<std::string>()] = entry;
+  }
+  ASSERT_EQ(by_tag["project"]["count"].get<int>(), 1);
+  ASSERT_EQ(by_tag["project"]["subtreeCount"].get<int>(), 3);
+  ASSERT_EQ(by_tag["project"]["parent"].get<std::string>(), "");
+  ASSERT_EQ(by_tag["beta"]["count"].get<int>(), 0);
+  ASSERT_EQ(by_tag["beta"]["subtreeCount"].get<int>(), 1);
+  ASSERT_EQ(by_tag["beta1"]["parent"].get<std::string>(), "beta");
+  ASSERT_EQ(by_tag["alpha"]["subtreeCount"].get<int>(), 2);
+
+  // Tag edits reach the store's hierarchy immediately
+  ASSERT_EQ(vxcore_tag_move(ctx, notebook_id, "beta", "other"), VXCORE_OK);
+  ASSERT(query_names(R"({"allOf": ["project"], "includeDescendants": true})") ==
+         (Names{"a.md", "c.md"}));
+  ASSERT(query_names(R"({"allOf": ["other"], "includeDescendants": true})") ==
+         (Names{"b.md", "d.md"}));
+  ASSERT_EQ(vxcore_tag_delete(ctx, notebook_id, "beta"), VXCORE_OK);
+  ASSERT(query_names(R"({"allOf": ["other"], "includeDescendants": true})") == Names{"d.md"});
+
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(get_test_path("test_tag_hierarchy"));
+  std::cout << "  \xE2\x9C\x93 test_tag_hierarchy_queries passed" << std::endl;
+  return 0;
+}
+
+int test_node_query_by_metadata() {
+  std::cout << "  Running test_node_query_by_metadata..." << std::endl;
+  cleanup_test_dir(get_test_path("test_metadata_query"));
+
+  VxCoreContextHandle ctx = nullptr;
+  VxCoreError err = vxcore_context_create(nullptr, &ctx);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *notebook_id = nullptr;
+  err = vxcore_notebook_create(ctx, get_test_path("test_metadata_query").c_str(),
+                               "{\"name\":\"Test Metadata Query\"}", VXCORE_NOTEBOOK_BUNDLED,
+                               &notebook_id);
+  ASSERT_EQ(err, VXCORE_OK);
+
+  char *folder_id = nullptr;
+  ASSERT_EQ(vxcore_folder_create(ctx, notebook_id, ".", "docs", &folder_id), VXCORE_OK);
+  vxcore_string_free(folder_id);
+  for (const auto &[folder, name] : std::vector<std::pair<const char *, const char *>>{
+           {"docs", "a.md"}, {"docs", "b.md"}, {".", "c.md"}}) {
+    char *file_id = nullptr;
+    ASSERT_EQ(vxcore_file_create(ctx, notebook_id, folder, name, &file_id), VXCORE_OK);
+    vxcore_string_free(file_id);
+  }
+  ASSERT_EQ(vxcore_node_update_metadata(ctx, notebook_id, "docs/a.md",
+                                        R"({"status": "draft", "priority": 1})"),
+            VXCORE_OK);
+  ASSERT_EQ(vxcore_node_update_metadata(ctx, notebook_id, "docs/b.md",
+                                        R"({"status": "done", "priority": 3})"),
+            VXCORE_OK);
+  ASSERT_EQ(vxcore_node_update_metadata(ctx, notebook_id, "docs", R"({"status": "draft"})"),
+            VXCORE_OK);
+
+  auto query_paths = [&](const char *query_json) {
+    std::vector<std::string> paths;
+    char *results = nullptr;
+    if (vxcore_node_query_by_metadata(ctx, notebook_id, query_json, &results) != VXCORE_OK) {
+      return std::vector<std::string>{"<error>"};
+    }
+    auto json = nlohmann::json::parse(results);
+    vxcore_string_free(results);
+    for (const auto &match : json["matches"]) {
+      paths.push_back(match["path"].get<std::string>() +
+                      (match["isFolder"].get<bool>() ? "/" : ""));
+    }
+    return paths;
+  };
+
+  using Paths = std::vector<std::string>;
+  ASSERT(query_paths(R"({"filter": {"status": "draft"}})") == Paths{"docs/a.md"});
+  ASSERT(query_paths(R"({"filter": {"status": "draft"}, "includeFolders": true})") ==
+         (Paths{"docs/a.md", "docs/"}));
+  ASSERT(query_paths(R"({"filter": [{"key": "priority", "op": "gt", "value": 1}]})") ==
+         Paths{"docs/b.md"});
+  ASSERT(query_paths(R"({"filter": [{"key": "status", "op": "missing"}]})") == Paths{"c.md"});
+
+  char *results = nullptr;
+  err = vxcore_node_query_by_metadata(ctx, notebook_id, R"({"filter": {"priority": 3}})",
+                                      &results);
+  ASSERT_EQ(err, VXCORE_OK);
+  auto json = nlohmann::json::parse(results);
+  vxcore_string_free(results);
+  ASSERT_EQ(json["matchCount"].get<int>(), 1);
+  ASSERT_EQ(json["matches"][0]["metadata"]["status"].get<std::string>(), "done");
+  ASSERT_FALSE(json["matches"][0]["id"].get<std::string>().empty());
+
+  ASSERT_EQ(vxcore_node_query_by_metadata(ctx, notebook_id, R"({"status": "draft"})", &results),
+            VXCORE_ERR_INVALID_PARAM);
+  ASSERT_EQ(vxcore_node_query_by_metadata(
+                ctx, notebook_id, R"({"filter": [{"key": "status", "op": "like"}]})", &results),
+            VXCORE_ERR_INVALID_PARAM);
+  ASSERT_EQ(vxcore_node_query_by_metadata(ctx, notebook_id, "{", &results),
+            VXCORE_ERR_JSON_PARSE);
+
+  // Explicit indexes
+  ASSERT_EQ(vxcore_node_metadata_index_create(ctx, notebook_id, "status"), VXCORE_OK);
+  ASSERT_EQ(vxcore_node_metadata_index_create(ctx, notebook_id, "bad\"key"),
+            VXCORE_ERR_INVALID_PARAM);
+  ASSERT_EQ(vxcore_node_metadata_index_list(ctx, notebook_id, &results), VXCORE_OK);
+  ASSERT_EQ(nlohmann::json::parse(results), nlohmann::json::array({"status"}));
+  vxcore_string_free(results);
+  ASSERT(query_paths(R"({"filter": {"status": "draft"}})") == Paths{"docs/a.md"});
+  ASSERT_EQ(vxcore_node_metadata_index_drop(ctx, notebook_id, "status"), VXCORE_OK);
+  ASSERT_EQ(vxcore_node_metadata_index_list(ctx, notebook_id, &results), VXCORE_OK);
+  ASSERT_EQ(nlohmann::json::parse(results), nlohmann::json::array());
+  vxcore_string_free(results);
+
+  // The same filter as a search scope
+  err = vxcore_search_files(ctx, notebook_id, R"({
+    "pattern": "*.md",
+    "scope": {"folderPath": ".", "recursive": true, "metadata": {"status": "draft"}}
+  })",
+                            nullptr, &results);
+  ASSERT_EQ(err, VXCORE_OK);
+  json = nlohmann::json::parse(results);
+  vxcore_string_free(results);
+  ASSERT_EQ(json["matchCount"].get<int>(), 1);
+  ASSERT_EQ(json["matches"][0]["path"].get<std::string>(), "docs/a.md");
+
+  err = vxcore_search_files(ctx, notebook_id, R"({
+    "pattern": "*.md",
+    "scope": {"metadata": [{"key": "priority", "op": "ge", "value": 1}]}
+  })",
+                            nullptr, &results);
+  ASSERT_EQ(err, VXCORE_OK);
+  json = nlohmann::json::parse(results);
+  vxcore_string_free(results);
+  ASSERT_EQ(json["matchCount"].get<int>(), 2);
+
+  err = vxcore_search_files(ctx, notebook_id,
+                            R"({"pattern": "*.md", "scope": {"metadata": "draft"}})", nullptr,
+                            &results);
+  ASSERT_NE(err, VXCORE_OK);
+
+  vxcore_string_free(notebook_id);
+  vxcore_context_destroy(ctx);
+  cleanup_test_dir(get_test_path("test_metadata_query"));
+  std::cout << "  \xE2\x9C\x93 test_node_query_by_metadata passed" << std::endl;
+  return 0;
+}
+
 int test_tag_count_files_by_tag() {
   std::cout << "  Running test_tag_count_files_by_tag..." << std::endl;
   cleanup_test_dir(get_test_path("test_tag_count"));
@@ -4427,7 +4710,10 @@ int main() {
   RUN_TEST(test_tag_find_files_empty_results);
   RUN_TEST(test_tag_find_files_in_subfolder);
   RUN_TEST(test_tag_find_files_invalid_params);
+  RUN_TEST(test_tag_query_files);
   RUN_TEST(test_tag_count_files_by_tag);
+  RUN_TEST(test_tag_hierarchy_queries);
+  RUN_TEST(test_node_query_by_metadata);
 
   RUN_TEST(test_content_search_basic);
   RUN_TEST(test_content_search_case_insensitive);
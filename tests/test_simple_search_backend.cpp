@@ -696,6 +696,46 @@ int test_streaming_multichunk_workqueue_out_of_order() {
   return 0;
 }
 
+int test_streaming_bounded_queue_throttles() {
+  std::cout << "  Running test_streaming_bounded_queue_throttles..." << std::endl;
+
+  std::string test_dir =
+      std::filesystem::temp_directory_path().string() + "/vxcore_test_simple_stream";
+  cleanup_test_dir(test_dir);
+  create_directory(test_dir);
+
+  const int kFileCount = 40;
+  std::vector<SearchFileInfo> files;
+  for (int i = 0; i < kFileCount; ++i) {
+    std::string name = "bq" + std::to_string(i) + ".txt";
+    std::string abs = CleanPath(test_dir + "/" + name);
+    write_file(abs, "target token");
+    files.push_back(make_file(name, abs));
+  }
+
+  // Capacity 2 with a blocking policy and NO external drainer: the initiator must help-drain
+  // on a full queue rather than block, and never hold more than 2 pending chunks.
+  SimpleSearchBackend backend;
+  WorkQueue queue;
+  queue.SetCapacity(2, QueueFullPolicy::kBlock);
+  backend.SetWorkQueue(&queue);
+  StreamCollector c;
+
+  auto err = backend.SearchStreaming(files, "target", SearchOption::kCaseSensitive, {}, 1, c.fn());
+  ASSERT_EQ(err, VXCORE_OK);
+  ASSERT_EQ(c.callback_count, kFileCount);
+  ASSERT_EQ(c.reassemble().size(), static_cast<size_t>(kFileCount));
+
+  auto stats = queue.GetStats();
+  ASSERT_EQ(stats.enqueued, static_cast<uint64_t>(kFileCount));
+  ASSERT_TRUE(stats.peak_size <= 2u);
+  ASSERT_EQ(stats.full_waits, 0u);
+
+  cleanup_test_dir(test_dir);
+  std::cout << "  ✓ test_streaming_bounded_queue_throttles passed" << std::endl;
+  return 0;
+}
+
 int test_streaming_no_truncation() {
   std::cout << "  Running test_streaming_no_truncation..." << std::endl;
 
@@ -862,6 +902,7 @@ int main() {
   RUN_TEST(test_streaming_batch_size_default_single_chunk);
   RUN_TEST(test_streaming_multichunk_inline_ordering);
   RUN_TEST(test_streaming_multichunk_workqueue_out_of_order);
+  RUN_TEST(test_streaming_bounded_queue_throttles);
   RUN_TEST(test_streaming_no_truncation);
   RUN_TEST(test_streaming_blob_parity);
   RUN_TEST(test_streaming_cancel_preset);
@@ -6,6 +6,8 @@
 #include <thread>
 #include <vector>
 
+#include <nlohmann/json.hpp>
+
 #include "core/context.h"
 #include "core/work_queue.h"
 
@@ -184,6 +186,180 @@ int test_double_shutdown_safe() {
   return 0;
 }
 
+int test_histogram_buckets() {
+  std::cout << "  Running test_histogram_buckets..." << std::endl;
+  vxcore::LatencyHistogram h;
+  h.Record(std::chrono::nanoseconds(500));    // < 1us
+  h.Record(std::chrono::microseconds(1));     // [1, 2)
+  h.Record(std::chrono::microseconds(3));     // [2, 4)
+  h.Record(std::chrono::microseconds(1000));  // [512, 1024)
+  h.Record(std::chrono::hours(1));            // overflow bucket
+  auto snap = h.GetSnapshot();
+  ASSERT_EQ(snap.count, 5u);
+  ASSERT_EQ(snap.buckets[0], 1u);
+  ASSERT_EQ(snap.buckets[1], 1u);
+  ASSERT_EQ(snap.buckets[2], 1u);
+  ASSERT_EQ(snap.buckets[10], 1u);
+  ASSERT_EQ(snap.buckets[vxcore::LatencyHistogram::kBucketCount - 1], 1u);
+  ASSERT_EQ(snap.max_us, 3600000000ull);
+  ASSERT_EQ(vxcore::LatencyHistogram::BucketUpperBoundUs(0), 1u);
+  ASSERT_EQ(vxcore::LatencyHistogram::BucketUpperBoundUs(10), 1024u);
+  ASSERT_EQ(
+      vxcore::LatencyHistogram::BucketUpperBoundUs(vxcore::LatencyHistogram::kBucketCount - 1), 0u);
+  h.Reset();
+  ASSERT_EQ(h.GetSnapshot().count, 0u);
+  std::cout << "  ✓ test_histogram_buckets passed" << std::endl;
+  return 0;
+}
+
+int test_stats_counts_and_latency() {
+  std::cout << "  Running test_stats_counts_and_latency..." << std::endl;
+  vxcore::WorkQueue q;
+  for (int i = 0; i < 3; ++i) {
+    q.Enqueue([] { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  auto stats = q.GetStats();
+  ASSERT_EQ(stats.enqueued, 3u);
+  ASSERT_EQ(stats.processed, 0u);
+  ASSERT_EQ(stats.size, 3u);
+  ASSERT_EQ(stats.peak_size, 3u);
+
+  std::thread worker([&] {
+    while (q.ProcessNext(50)) {
+    }
+  });
+  worker.join();
+  q.Shutdown();
+  ASSERT_FALSE(q.Enqueue([] {}));
+
+  stats = q.GetStats();
+  ASSERT_EQ(stats.processed, 3u);
+  ASSERT_EQ(stats.rejected, 1u);
+  ASSERT_EQ(stats.size, 0u);
+  ASSERT_EQ(stats.run_time.count, 3u);
+  ASSERT_TRUE(stats.run_time.total_us >= 6000u);
+  ASSERT_EQ(stats.queue_latency.count, 3u);
+  ASSERT_TRUE(stats.queue_latency.max_us >= 5000u);
+  ASSERT_TRUE(stats.lock_wait.count >= 4u);
+  ASSERT_EQ(stats.processed_per_thread.size(), 1u);
+  ASSERT_EQ(stats.processed_per_thread[0].second, 3u);
+  ASSERT_NE(stats.processed_per_thread[0].first, std::this_thread::get_id());
+
+  q.ResetStats();
+  stats = q.GetStats();
+  ASSERT_EQ(stats.processed, 0u);
+  ASSERT_EQ(stats.run_time.count, 0u);
+  ASSERT_TRUE(stats.processed_per_thread.empty());
+  std::cout << "  ✓ test_stats_counts_and_latency passed" << std::endl;
+  return 0;
+}
+
+int test_capacity_reject_policy() {
+  std::cout << "  Running test_capacity_reject_policy..." << std::endl;
+  vxcore::WorkQueue q;
+  q.SetCapacity(2, vxcore::QueueFullPolicy::kReject);
+  ASSERT_EQ(q.Capacity(), 2u);
+  ASSERT_TRUE(q.Enqueue([] {}));
+  ASSERT_TRUE(q.Enqueue([] {}));
+  ASSERT_FALSE(q.Enqueue([] {}));
+  ASSERT_EQ(q.Size(), 2u);
+  ASSERT_TRUE(q.ProcessNext(10));
+  ASSERT_TRUE(q.Enqueue([] {}));
+
+  // Removing the bound accepts again.
+  q.SetCapacity(0);
+  ASSERT_TRUE(q.Enqueue([] {}));
+  ASSERT_EQ(q.Size(), 3u);
+  ASSERT_EQ(q.GetStats().rejected, 1u);
+  std::cout << "  ✓ test_capacity_reject_policy passed" << std::endl;
+  return 0;
+}
+
+int test_capacity_caller_runs_policy() {
+  std::cout << "  Running test_capacity_caller_runs_policy..." << std::endl;
+  vxcore::WorkQueue q;
+  q.SetCapacity(1, vxcore::QueueFullPolicy::kCallerRuns);
+  std::thread::id ran_on;
+  ASSERT_TRUE(q.Enqueue([] {}));
+  ASSERT_TRUE(q.Enqueue([&] { ran_on = std::this_thread::get_id(); }));
+  // Ran synchronously on the producer instead of being queued.
+  ASSERT_EQ(ran_on, std::this_thread::get_id());
+  ASSERT_EQ(q.Size(), 1u);
+  auto stats = q.GetStats();
+  ASSERT_EQ(stats.caller_runs, 1u);
+  ASSERT_EQ(stats.enqueued, 1u);
+  std::cout << "  ✓ test_capacity_caller_runs_policy passed" << std::endl;
+  return 0;
+}
+
+int test_capacity_block_policy() {
+  std::cout << "  Running test_capacity_block_policy..." << std::endl;
+  vxcore::WorkQueue q;
+  q.SetCapacity(4, vxcore::QueueFullPolicy::kBlock);
+  const int kItems = 2000;
+  std::atomic<int> done{0};
+  std::atomic<int> refused{0};
+
+  std::thread producer([&] {
+    for (int i = 0; i < kItems; ++i) {
+      if (!q.Enqueue([&] { done.fetch_add(1); })) refused.fetch_add(1);
+    }
+  });
+  while (done.load() + refused.load() < kItems) {
+    q.ProcessNext(10);
+  }
+  producer.join();
+  ASSERT_EQ(refused.load(), 0);
+
+  auto stats = q.GetStats();
+  ASSERT_EQ(stats.processed, static_cast<uint64_t>(kItems));
+  ASSERT_TRUE(stats.peak_size <= 4u);
+  ASSERT_EQ(stats.capacity, 4u);
+  std::cout << "  ✓ test_capacity_block_policy passed" << std::endl;
+  return 0;
+}
+
+int test_capacity_block_unblocked_by_shutdown() {
+  std::cout << "  Running test_capacity_block_unblocked_by_shutdown..." << std::endl;
+  vxcore::WorkQueue q;
+  q.SetCapacity(1, vxcore::QueueFullPolicy::kBlock);
+  ASSERT_TRUE(q.Enqueue([] {}));
+  std::atomic<int> result{-1};
+  std::thread producer([&] { result = q.Enqueue([] {}) ? 1 : 0; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_EQ(result.load(), -1);
+  q.Shutdown();
+  producer.join();
+  ASSERT_EQ(result.load(), 0);
+  ASSERT_EQ(q.GetStats().full_waits, 1u);
+  std::cout << "  ✓ test_capacity_block_unblocked_by_shutdown passed" << std::endl;
+  return 0;
+}
+
+int test_try_enqueue_keeps_item_when_full() {
+  std::cout << "  Running test_try_enqueue_keeps_item_when_full..." << std::endl;
+  vxcore::WorkQueue q;
+  q.SetCapacity(1);
+  int value = 0;
+  vxcore::WorkItem first = [&] { value = 1; };
+  vxcore::WorkItem second = [&] { value = 2; };
+  ASSERT_TRUE(q.TryEnqueue(first) == vxcore::EnqueueResult::kQueued);
+  ASSERT_TRUE(q.TryEnqueue(second) == vxcore::EnqueueResult::kFull);
+  // Not consumed on failure: the producer can drain and retry the same item.
+  ASSERT_TRUE(static_cast<bool>(second));
+  ASSERT_TRUE(q.ProcessNext(10));
+  ASSERT_TRUE(q.TryEnqueue(second) == vxcore::EnqueueResult::kQueued);
+  ASSERT_TRUE(q.ProcessNext(10));
+  ASSERT_EQ(value, 2);
+  q.Shutdown();
+  vxcore::WorkItem third = [] {};
+  ASSERT_TRUE(q.TryEnqueue(third) == vxcore::EnqueueResult::kShutdown);
+  std::cout << "  ✓ test_try_enqueue_keeps_item_when_full passed" << std::endl;
+  return 0;
+}
+
 // ============ WorkQueueManager tests ============
 
 int test_manager_get_or_create() {
@@ -324,6 +500,35 @@ int test_c_api_named_queues() {
   vctx->work_queue_manager->GetOrCreate("events");
   vxcore_work_queue_shutdown_all(ctx);
 
+  // Stats JSON for an existing queue; NOT_FOUND for an unknown one.
+  char *stats_json = nullptr;
+  err = vxcore_work_queue_stats(ctx, "sync", &stats_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  ASSERT_NOT_NULL(stats_json);
+  auto stats = nlohmann::json::parse(stats_json);
+  vxcore_string_free(stats_json);
+  ASSERT_EQ(stats["processed"], 3);
+  ASSERT_EQ(stats["runTimeUs"]["count"], 3);
+  ASSERT_EQ(stats["runTimeUs"]["buckets"].size(), stats["bucketUpperBoundsUs"].size());
+  ASSERT_EQ(stats["threads"].size(), 1u);
+  vxcore_work_queue_reset_stats(ctx, "sync");
+  err = vxcore_work_queue_stats(ctx, "sync", &stats_json);
+  ASSERT_EQ(err, VXCORE_OK);
+  ASSERT_EQ(nlohmann::json::parse(stats_json)["processed"], 0);
+  vxcore_string_free(stats_json);
+  ASSERT_EQ(vxcore_work_queue_stats(ctx, "nonexistent", &stats_json), VXCORE_ERR_NOT_FOUND);
+  ASSERT_EQ(vxcore_work_queue_stats(ctx, "sync", nullptr), VXCORE_ERR_NULL_POINTER);
+
+  // Capacity can be configured before first use; the queue is created.
+  ASSERT_EQ(vxcore_work_queue_set_capacity(ctx, "bounded", 8, VXCORE_QUEUE_FULL_REJECT), VXCORE_OK);
+  ASSERT_NOT_NULL(vctx->work_queue_manager->Get("bounded"));
+  ASSERT_EQ(vctx->work_queue_manager->Get("bounded")->Capacity(), 8u);
+  ASSERT_EQ(vxcore_work_queue_set_capacity(ctx, "bounded", -1, VXCORE_QUEUE_FULL_BLOCK),
+            VXCORE_ERR_INVALID_PARAM);
+  ASSERT_EQ(
+      vxcore_work_queue_set_capacity(ctx, "bounded", 8, static_cast<VxCoreQueueFullPolicy>(7)),
+      VXCORE_ERR_INVALID_PARAM);
+
   // Null safety
   ASSERT_EQ(vxcore_work_queue_size(nullptr, "sync"), 0);
   ASSERT_EQ(vxcore_work_queue_size(ctx, nullptr), 0);
@@ -345,6 +550,13 @@ int main() {
   RUN_TEST(test_producer_consumer_concurrent);
   RUN_TEST(test_stress_10000_items);
   RUN_TEST(test_double_shutdown_safe);
+  RUN_TEST(test_histogram_buckets);
+  RUN_TEST(test_stats_counts_and_latency);
+  RUN_TEST(test_capacity_reject_policy);
+  RUN_TEST(test_capacity_caller_runs_policy);
+  RUN_TEST(test_capacity_block_policy);
+  RUN_TEST(test_capacity_block_unblocked_by_shutdown);
+  RUN_TEST(test_try_enqueue_keeps_item_when_full);
 
   // WorkQueueManager tests
   RUN_TEST(test_manager_get_or_create);